@@ -115,6 +115,20 @@ void flecs_bitset_remove(
     ecs_bitset_t *bs,
     int32_t elem);
 
+/** Remove a range from a bitset.
+ * Unlike flecs_bitset_remove(), this preserves the order of the remaining
+ * elements.
+ *
+ * @param bs The bitset to remove from.
+ * @param elem Index of the first bit to remove.
+ * @param count Number of bits to remove.
+ */
+FLECS_DBG_API
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count);
+
 /** Swap values in a bitset.
  *
  * @param bs The bitset.
@@ -804,6 +818,24 @@ void flecs_table_clear_edges_for_id(
 #define ecs_vec_from_column_t(arg_column, table, T)\
     ecs_vec_from_column(arg_column, table, ECS_SIZEOF(T))
 
+/* Number of rows that share a version stamp for row change tracking */
+#define FLECS_TABLE_DIRTY_CHUNK_BITS (6)
+#define FLECS_TABLE_DIRTY_CHUNK (1 << FLECS_TABLE_DIRTY_CHUNK_BITS)
+
+/* Version stamps are written by the workers of multithreaded systems that
+ * iterate the same table, so access them with relaxed atomics. */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_table_stamp_store(ptr, value)\
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#define flecs_table_stamp_load(ptr)\
+    __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#else
+#define flecs_table_stamp_store(ptr, value)\
+    (*(volatile int32_t*)(ptr) = (value))
+#define flecs_table_stamp_load(ptr)\
+    (*(const volatile int32_t*)(ptr))
+#endif
+
 /* Table event type for notifying tables of world events */
 typedef enum ecs_table_eventkind_t {
     EcsTableTriggersForId,
@@ -847,6 +879,14 @@ typedef struct ecs_table_overrides_t {
     ecs_ref_t *refs;                 /* Refs to base components (one for each column) */
 } ecs_table_overrides_t;
 
+/* Order of the rows of a table with StableOrder while a command flush removes
+ * rows by moving the last row of the table into the removed row. Sorting the
+ * rows by key restores the order of the table. */
+typedef struct ecs_table_row_order_t {
+    ecs_vec_t keys;                  /* vector<int32_t>, sort key of each row */
+    int32_t next;                    /* Key of the next appended row */
+} ecs_table_row_order_t;
+
 /** Infrequently accessed data not stored inline in ecs_table_t */
 typedef struct ecs_table__t {
     uint64_t hash;                   /* Type hash */
@@ -860,6 +900,12 @@ typedef struct ecs_table__t {
     int16_t bs_offset;
     ecs_bitset_t *bs_columns;        /* Bitset columns */
 
+    bool stable_order;               /* Removing rows preserves row order */
+    ecs_table_row_order_t *row_order; /* Set while rows are out of order */
+
+    ecs_vec_t *dirty_chunks;         /* Per column version of each chunk of
+                                      * FLECS_TABLE_DIRTY_CHUNK rows */
+
     struct ecs_table_record_t *records; /* Array with table records */
 
 #ifdef FLECS_DEBUG_INFO
@@ -874,10 +920,41 @@ typedef struct ecs_table__t {
 #endif
 } ecs_table__t;
 
+/* Column data is stored in a reserved address range (see column_page_size) */
+#define EcsColumnPaged (1u << 0)
+
+/* Column data is stored in a heap allocation with custom alignment */
+#define EcsColumnAligned (1u << 1)
+
+/* Column stores each member of the component in a separate array */
+#define EcsColumnSoA (1u << 2)
+
+/* Column stores a rarely accessed (cold) component. Column data is stored in
+ * the cold storage region of the world, unless EcsColumnAligned is set. */
+#define EcsColumnCold (1u << 3)
+
+/* Flags that describe how column storage is allocated */
+#define EcsColumnStorageMask (EcsColumnPaged|EcsColumnAligned)
+
+/** Member of a component with struct-of-arrays storage */
+typedef struct ecs_soa_member_t {
+    ecs_size_t offset;               /* Offset of member in component */
+    ecs_size_t size;                 /* Size of member */
+} ecs_soa_member_t;
+
+/** Struct-of-arrays layout. Member i of the element at row r is stored at
+ * data + offset_i * capacity + size_i * r. Because member offsets are aligned
+ * for the member type, so are the member arrays. */
+struct ecs_soa_layout_t {
+    ecs_soa_member_t *members;       /* Members, in order of increasing offset */
+    int32_t count;                   /* Number of members */
+};
+
 /** Table column */
 typedef struct ecs_column_t {
     void *data;                      /* Array with component data */
     ecs_type_info_t *ti;             /* Component type info */
+    ecs_flags32_t flags;             /* Column storage flags */
 } ecs_column_t;
 
 /** Table data */
@@ -964,6 +1041,16 @@ void flecs_table_move(
     int32_t old_index,
     ecs_id_t emplace_id);
 
+/* Move a range of rows from one table to another. Rows are appended to the
+ * destination table and the records of moved entities are updated. Returns
+ * the index of the first row in the destination table. */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count);
+
 /* Grow table with specified number of records. Populate table with the
  * specified entity ids. */
 int32_t flecs_table_appendn(
@@ -977,11 +1064,46 @@ bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Restore order of rows of tables with StableOrder after a command flush */
+void flecs_table_restore_row_order(
+    ecs_world_t *world);
+
+/* Move cold columns of table to lower addresses in the cold storage region */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Copy value into column with struct-of-arrays storage */
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value);
+
+/* Copy value out of column with struct-of-arrays storage */
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value);
+
 /* Get dirty state for table columns */
 int32_t* flecs_table_get_dirty_state(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Enable tracking of which chunks of rows changed for table columns */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Mark range of rows in table column dirty */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count);
+
 /* Initialize root table */
 void flecs_init_root_table(
     ecs_world_t *world);
@@ -1010,7 +1132,8 @@ void flecs_table_merge(
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component);
+    ecs_entity_t component,
+    int32_t row);
 
 void flecs_table_notify(
     ecs_world_t *world,
@@ -1066,6 +1189,65 @@ ecs_hashmap_t* flecs_table_get_name_index(
 
 #endif
 
+#ifndef FLECS_COLD_STORAGE_H
+#define FLECS_COLD_STORAGE_H
+
+/* Minimum size of a page in the cold region */
+#define FLECS_COLD_PAGE_SIZE (64 * 1024)
+
+/* Alignment of blocks in the cold region */
+#define FLECS_COLD_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+typedef struct ecs_cold_page_t ecs_cold_page_t;
+typedef struct ecs_cold_block_t ecs_cold_block_t;
+
+typedef struct ecs_cold_storage_t {
+    ecs_cold_page_t *first;          /* Pages in the order they were created */
+    ecs_cold_page_t *last;
+    ecs_cold_block_t *free_list;     /* Blocks that are not in use */
+    int32_t page_index;              /* Index assigned to the next page */
+    ecs_size_t bytes_reserved;       /* Bytes allocated for pages */
+    ecs_size_t bytes_used;           /* Bytes of blocks that are in use */
+} ecs_cold_storage_t;
+
+/* Initialize cold storage region. */
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage);
+
+/* Free all pages of the cold storage region. */
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage);
+
+/* Allocate block. Returns memory aligned to FLECS_COLD_ALIGNMENT. */
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size);
+
+/* Allocate block at a lower address in the region than ptr. Returns NULL if
+ * there is no space for the block before ptr. */
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr);
+
+/* Free block. Pages that become empty are returned to the OS. */
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr);
+
+/* Resize block without moving it. Returns false if the block can't grow in
+ * place, in which case the block is not modified. */
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size);
+
+/* Returns whether compacting the region could release at least one page. */
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage);
+
+#endif
+
 #ifndef FLECS_SPARSE_STORAGE_H
 #define FLECS_SPARSE_STORAGE_H
 
@@ -1927,6 +2109,9 @@ bool flecs_query_cache_is_trivial(
 ecs_size_t flecs_query_cache_elem_size(
     const ecs_query_cache_t *cache);
 
+int32_t flecs_query_cache_entity_count(
+    const ecs_query_cache_t *cache);
+
 #ifndef FLECS_QUERY_CACHE_ITER_H
 #define FLECS_QUERY_CACHE_ITER_H
 
@@ -2656,6 +2841,10 @@ int flecs_query_trivial_has_range(
     int32_t offset,
     int32_t count);
 
+/* Estimate number of matched entities without evaluating the query */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q);
+
 /* Internal function for initializing an iterator after vars are constrained */
 void flecs_query_iter_constrain(
     ecs_iter_t *it);
@@ -2829,40 +3018,97 @@ typedef enum ecs_cmd_kind_t {
     EcsCmdSkip
 } ecs_cmd_kind_t;
 
-/* Entity specific metadata for command in queue */
+/* Entity specific metadata for command in queue. Offsets point into the
+ * command stream. */
 typedef struct ecs_cmd_entry_t {
     int32_t first;
-    int32_t last;                    /* If -1, a delete command was inserted */
+    int32_t last;
+    uint32_t epoch;                  /* Entry is invalid if it doesn't match 
+                                      * the epoch of the queue */
 } ecs_cmd_entry_t;
 
-typedef struct ecs_cmd_1_t {
-    void *value;                     /* Component value (used by set / ensure) */
-    ecs_size_t size;                 /* Size of value */
-    bool clone_value;                /* Clone entity with value (used for clone) */ 
-    bool force_delete;               /* Delete prefab tables (used for delete_with) */
-} ecs_cmd_1_t;
-
-typedef struct ecs_cmd_n_t {
-    ecs_entity_t *entities;  
-    int32_t count;
-} ecs_cmd_n_t;
-
+/* Command flags */
+#define EcsCmdValuePtr               (1u << 0) /* Command has pointer payload */
+#define EcsCmdValueInline            (1u << 1) /* Value is stored in stream */
+#define EcsCmdCloneValue             (1u << 2) /* Clone entity with value */
+#define EcsCmdForceDelete            (1u << 3) /* Delete prefab tables */
+#define EcsCmdBatched                (1u << 4) /* Applied as part of a batch */
+#define EcsCmdValueMoved             (1u << 5) /* Value moved out, storage not freed */
+
+/* Largest component value that is stored inline in the command stream */
+#define FLECS_CMD_INLINE_SIZE        (64)
+
+/* Commands are stored as a stream of variable length records. Each record 
+ * starts with a command header, optionally followed by a payload:
+ *  - no payload for commands that only need an entity and id
+ *  - a pointer for values that must have a stable address (ensure, emplace),
+ *    for the entity array of bulk_new, the name of path and the descriptor
+ *    of event commands (EcsCmdValuePtr)
+ *  - the component value itself for small trivially copyable values passed to
+ *    set (EcsCmdValueInline).
+ * Records are aligned to 8 bytes, and are decoded sequentially on flush. */
 typedef struct ecs_cmd_t {
     ecs_cmd_kind_t kind;             /* Command kind */
-    int32_t next_for_entity;         /* Next operation for entity */    
+    int32_t next_for_entity;         /* Offset of next command for entity */
     ecs_id_t id;                     /* (Component) id */
-    ecs_cmd_entry_t *entry;
     ecs_entity_t entity;             /* Entity id */
-
-    union {
-        ecs_cmd_1_t _1;              /* Data for single entity operation */
-        ecs_cmd_n_t _n;              /* Data for multi entity operation */
-    } is;
-
     ecs_entity_t system;             /* System that enqueued the command */
+    int32_t size;                    /* Value size, or entity count (bulk_new) */
+    int16_t length;                  /* Length of record, including payload */
+    ecs_flags16_t flags;             /* Command flags */
 } ecs_cmd_t;
 
-/** Callback used to capture commands of a frame */
+/* Get command at offset in command stream */
+#define flecs_cmd_at(queue, offset)\
+    ECS_CAST(ecs_cmd_t*, ECS_OFFSET(ecs_vec_first(queue), offset))
+
+/* Number of commands in a segment of the async command queue */
+#define FLECS_ASYNC_CMD_SEGMENT_SIZE (256)
+
+/* Largest component value that is stored inline in an async command */
+#define FLECS_ASYNC_CMD_INLINE_SIZE  (32)
+
+/* Command enqueued by a thread that doesn't own a stage */
+typedef struct ecs_async_cmd_t {
+    ecs_cmd_kind_t kind;             /* Command kind */
+    int32_t ready;                   /* Set by producer after writing command */
+    ecs_id_t id;                     /* (Component) id */
+    ecs_entity_t entity;             /* Entity id */
+    void *value;                     /* Component value or event descriptor */
+    ecs_size_t size;                 /* Size of component value */
+    uint64_t inline_value[FLECS_ASYNC_CMD_INLINE_SIZE / 8];
+} ecs_async_cmd_t;
+
+/* Fixed size segment of the async command queue. Producers claim slots with an
+ * atomic increment, so a slot is only written by a single thread. */
+typedef struct ecs_async_segment_t {
+    ecs_async_cmd_t cmds[FLECS_ASYNC_CMD_SEGMENT_SIZE];
+    int32_t reserved;                /* Number of slots claimed by producers */
+    int32_t read;                    /* Number of slots merged */
+    struct ecs_async_segment_t *next;
+} ecs_async_segment_t;
+
+/* Multi producer, single consumer queue for commands enqueued by threads that
+ * don't own a stage. Enqueueing a command doesn't take a lock unless the last 
+ * segment is full. Commands are merged by the main thread when stages are 
+ * merged, or at the start of a frame.
+ *
+ * The OS API has no compare-and-swap, so slots are claimed with an atomic 
+ * increment, and new segments are linked under a lock. Segment pointers that
+ * are read without the lock are published with the atomic pointer load/store
+ * functions (aloadp_, astorep_) that were added to the OS API for the queue.
+ * The queue can't be used if the OS API has no mutex support. */
+typedef struct ecs_async_queue_t {
+    ecs_async_segment_t *head;       /* Segment that is merged next */
+    ecs_async_segment_t *tail;       /* Segment that commands are appended to */
+    ecs_async_segment_t *retired;    /* Merged segments that are not reused yet */
+    ecs_async_segment_t *free;       /* Segments that can be reused */
+    int32_t producers;               /* Number of threads enqueueing commands */
+    ecs_os_mutex_t lock;             /* Protects linking of new segments */
+} ecs_async_queue_t;
+
+/** Callback used to capture commands of a frame. The commands vector is the
+ * command stream, which is iterated by advancing with the command length. */
 typedef void (*ecs_on_commands_action_t)(
     const ecs_stage_t *stage,
     const ecs_vec_t *commands,
@@ -2878,6 +3124,24 @@ void flecs_commands_fini(
     ecs_stage_t *stage,
     ecs_commands_t *cmd);
 
+/* Test whether the command queues of all stages can be merged in place by
+ * multiple threads. This is not the case if an entity is used by commands in
+ * more than one stage, or if the queues contain commands that delete entities,
+ * as the cascading deletes can affect entities owned by other threads. */
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world);
+
+/* Apply set/ensure commands that don't change the table of an entity directly
+ * to component storage. Can be called from multiple threads at the same time
+ * with different worker indices, as each worker only processes the commands 
+ * for the entities it owns. Value storage of applied commands is freed by the
+ * regular merge, which runs on the main thread. */
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count);
+
 /* Begin deferring, or return whether already deferred. */
 bool flecs_defer_cmd(
     ecs_stage_t *stage);
@@ -3001,6 +3265,18 @@ void flecs_enqueue(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_event_desc_t *desc);
+
+/* Initialize async command queue. */
+void flecs_async_init(
+    ecs_world_t *world);
+
+/* Free async command queue, discards commands that weren't merged. */
+void flecs_async_fini(
+    ecs_world_t *world);
+
+/* Merge commands that were enqueued by threads that don't own a stage. */
+void flecs_async_merge(
+    ecs_world_t *world);
  
 #endif
 
@@ -3118,6 +3394,16 @@ void flecs_commit(
     ecs_id_t emplace_id,
     ecs_flags32_t evt_flags);
 
+/* Commit a range of entities in the same table to a new table. */
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags);
+
 /* Like regular modified, but doesn't assert if entity doesn't have component. */
 void flecs_modified_id_if(
     ecs_world_t *world,
@@ -3416,6 +3702,14 @@ void* flecs_field_shared(
     size_t size,
     int8_t index);
 
+/* Find table, column and row at which the value(s) of a field are stored. 
+ * Returns -1 if the field is not stored in a table column. */
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out);
+
 /* Free iterator memory block. */
 void flecs_iter_free(
     void *ptr,
@@ -3614,6 +3908,14 @@ struct ecs_stage_t {
     ecs_vec_t variables;
     ecs_vec_t operations;
 
+#ifdef FLECS_PIPELINE
+    /* Statistics for work stealing scheduler */
+    ecs_worker_stats_t worker_stats;
+
+    /* Set when the worker is signaled to start/resume work */
+    int32_t worker_signaled;
+#endif
+
 #ifdef FLECS_SCRIPT
     /* Thread-specific runtime for script execution */
     ecs_script_runtime_t *runtime;
@@ -3638,6 +3940,10 @@ ecs_allocator_t* flecs_stage_get_allocator(
 ecs_stack_t* flecs_stage_get_stack_allocator(
     ecs_world_t *world);
 
+/* Allocate first pages of stage allocators from the calling thread. */
+void flecs_stage_first_touch(
+    ecs_stage_t *stage);
+
 /* Shrink memory for stage data structures. */
 void ecs_stage_shrink(
     ecs_stage_t *stage);
@@ -3700,6 +4006,14 @@ typedef struct ecs_store_t {
      * type info so it's guaranteed that this data is available while the
      * storage is cleaning up tables. */
     ecs_vec_t deleted_components;    /* vector<ecs_entity_t> */
+
+    /* Tables with StableOrder of which rows are out of order until the 
+     * current command flush is done. */
+    ecs_vec_t unordered_tables;      /* vector<uint64_t> */
+    int32_t defer_row_order;         /* Nesting level of flushes */
+
+    /* Storage region for columns of cold components */
+    ecs_cold_storage_t cold;
 } ecs_store_t;
 
 /* fini actions */
@@ -3765,6 +4079,14 @@ struct ecs_world_t {
 
     /* --  Data storage -- */
     ecs_store_t store;
+    ecs_size_t column_page_size;     /* Columns larger than this use paged storage */
+    ecs_size_t column_alignment;     /* Minimum alignment of column storage */
+
+    /* -- Table compaction -- */
+    ecs_delete_empty_tables_desc_t compaction; /* Per-frame compaction settings */
+    bool compaction_enabled;         /* Run compaction in ecs_frame_end() */
+    int32_t compaction_count;        /* Tables deleted or trimmed by cleanup */
+    int64_t compaction_bytes;        /* Bytes reclaimed by cleanup */
 
     /* -- Systems -- */
     ecs_entity_t pipeline;           /* Current pipeline */
@@ -3797,11 +4119,19 @@ struct ecs_world_t {
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
     ecs_os_cond_t sync_cond;         /* Signal that worker thread job is done */
+    ecs_os_cond_t system_cond;       /* Signal that a system finished running */
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t workers_signaled;        /* Number of workers signaled for job */
+    int32_t worker_spin_count;       /* Iterations to spin before blocking */
+    ecs_ftime_t worker_min_cost;     /* Minimum estimated op time per thread */
+    ecs_ftime_t worker_cost_weight;  /* Weight of last measurement in system cost */
+    ecs_vec_t worker_affinity;       /* Core per worker, -1 if not pinned */
+    ecs_map_t double_buffered;       /* Components copied for pipelined systems */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
+    ecs_async_queue_t async_queue;   /* Commands enqueued by non-stage threads */
 
     /* -- Exclusive access -- */
     ecs_os_thread_id_t exclusive_access; /* If set, world can only be mutated by thread */
@@ -3869,6 +4199,16 @@ void flecs_type_info_claim(
 void flecs_type_info_release(
     const ecs_type_info_t *ti);
 
+/* Test if type hooks can be used with struct-of-arrays storage. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h);
+
+/* Set struct-of-arrays layout for type. Members must be ordered by offset. */
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count);
+
 /* Notify tables with component of event (or all tables if id is 0). */
 void flecs_notify_tables(
     ecs_world_t *world,
@@ -3885,6 +4225,10 @@ uint32_t flecs_get_table_version_fast(
     const ecs_world_t *world,
     const uint64_t table_id);
 
+/* Run a table compaction step if enabled with ecs_set_table_compaction(). */
+void flecs_table_compaction_run(
+    ecs_world_t *world);
+
 /* Throws error when (OnDelete*, Panic) constraint is violated. */
 void flecs_throw_invalid_delete(
     ecs_world_t *world,
@@ -4057,31 +4401,149 @@ void flecs_journal_end(void);
 #ifndef FLECS_PIPELINE_PRIVATE_H
 #define FLECS_PIPELINE_PRIVATE_H
 
+/* Number of rows in a chunk claimed by a worker when work stealing is enabled.
+ * Each claim costs an atomic increment on a shared cache line, so chunks should
+ * be large enough to amortize it over the rows, but small enough to leave
+ * chunks for idle workers to steal. For components of 8 to 64 bytes a chunk
+ * of 256 rows spans 2 to 16KB per column, which keeps the columns of a chunk in
+ * L1/L2. Systems can override this with ecs_system_desc_t::chunking. */
+#ifndef FLECS_WORKER_CHUNK_SIZE
+#define FLECS_WORKER_CHUNK_SIZE (256)
+#endif
+
+/* Size of a cache line, used to prevent false sharing between workers */
+#ifndef FLECS_CACHE_LINE_SIZE
+#define FLECS_CACHE_LINE_SIZE (64)
+#endif
+
+/* Default weight of the last measurement in the estimated cost per entity of a
+ * system. With 0.25 a change in cost is mostly picked up after 4 to 8 frames,
+ * while a single slow frame doesn't change the number of threads. Can be 
+ * changed at runtime with ecs_set_worker_cost_weight(). */
+#ifndef FLECS_WORKER_COST_WEIGHT
+#define FLECS_WORKER_COST_WEIGHT (0.25f)
+#endif
+
 /** Instruction data for pipeline.
  * This type is the element type in the "ops" vector of a pipeline. */
 typedef struct ecs_pipeline_op_t {
     int32_t offset;             /* Offset in systems vector */
+    int32_t match_offset;       /* Offset of first system in matched vector */
     int32_t count;              /* Number of systems to run before next op */
     double time_spent;          /* Time spent merging commands for sync point */
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
+    double wait_time;           /* Time spent waiting for workers to sync */
+    int64_t wait_histogram[FLECS_SYNC_WAIT_BUCKETS]; /* Wait time histogram */
+    int32_t worker_count;       /* Number of threads that ran op last frame */
     bool multi_threaded;        /* Whether systems can be run multi-threaded */
     bool immediate;           /* Whether systems run in immediate mode */
+    bool pipelined;             /* Whether systems can overlap with next frame */
 } ecs_pipeline_op_t;
 
+/** System matched by the pipeline query. The matched systems of the previous
+ * pipeline build are used to find which part of the schedule changed. */
+typedef struct ecs_pipeline_match_t {
+    ecs_system_t *system;       /* Matched system */
+    ecs_query_t *query;         /* Query of system when it was matched */
+    bool active;                /* Whether system is active */
+    bool multi_threaded;        /* Whether system is multithreaded */
+    bool immediate;             /* Whether system is immediate */
+    bool pipelined;             /* Whether system is pipelined */
+} ecs_pipeline_match_t;
+
+/** Node in the dependency graph of a pipeline. A system depends on the earlier
+ * systems in the same op that it has conflicting component access with. */
+typedef struct ecs_pipeline_node_t {
+    int32_t dep_offset;         /* Offset in deps vector */
+    int32_t dep_count;          /* Number of systems that must finish first */
+    int32_t finished;           /* Number of times system finished in op run */
+    bool notify;                /* Whether other systems depend on system */
+} ecs_pipeline_node_t;
+
+/** Range of chunks assigned to a worker when work stealing is enabled. Chunks
+ * are created before workers start and are never added while they run, so
+ * instead of a deque each range is a shared counter: the owner and workers that
+ * steal from it both claim the next chunk with an atomic increment. */
+typedef struct ecs_worker_range_t {
+    int32_t claimed;            /* Number of claimed chunks (atomic) */
+    int32_t first;              /* First chunk in range */
+    int32_t count;              /* Number of chunks in range */
+
+    /* Prevent false sharing between workers claiming from adjacent ranges */
+    char padding[FLECS_CACHE_LINE_SIZE - 3 * sizeof(int32_t)];
+} ecs_worker_range_t;
+
+/** Query result of a multithreaded system, split up into chunks. */
+typedef struct ecs_worker_result_t {
+    int32_t first_chunk;        /* First chunk of result */
+    int32_t count;              /* Number of entities in result */
+} ecs_worker_result_t;
+
+/** Tasks for a multithreaded system, shared between workers. Created by the
+ * main thread before workers are signaled to run the op of the system. */
+typedef struct ecs_worker_tasks_t {
+    ecs_system_t *system;       /* System for which tasks are created */
+    int32_t run;                /* Pipeline run for which tasks are valid */
+    int32_t chunk_count;        /* Total number of chunks */
+    int32_t chunk_size;         /* Number of entities per chunk */
+    int32_t range_count;        /* Number of workers */
+    ecs_vec_t results;          /* vector<ecs_worker_result_t> */
+    ecs_worker_range_t *ranges; /* One range per worker */
+} ecs_worker_tasks_t;
+
+/** Copy of a query result of a pipelined system. Created at the end of a frame
+ * when pipelined frame execution is enabled, and iterated by the workers while
+ * the first op of the next frame runs. Copied arrays are stored in the snapshot
+ * data of the pipeline, which is reused across frames. Arrays are stored as 
+ * offsets, as the snapshot data can be reallocated while it is populated. */
+typedef struct ecs_pipeline_snapshot_t {
+    ecs_system_t *system;       /* System that matched the result */
+    ecs_ftime_t delta_time;     /* Delta time of frame that created snapshot */
+    ecs_ftime_t delta_system_time; /* Delta system time of snapshot frame */
+    int32_t count;              /* Number of entities in result */
+    ecs_termset_t set_fields;   /* Fields that are set */
+    ecs_termset_t ref_fields;   /* Fields that point to a single value */
+    ecs_termset_t up_fields;    /* Fields matched through up traversal */
+    int32_t entities;           /* Offset of entity ids, -1 if none */
+    int32_t ids;                /* Offset of field ids */
+    int32_t sources;            /* Offset of field sources */
+    int32_t fields[FLECS_TERM_COUNT_MAX]; /* Offset of field data, -1 if none */
+} ecs_pipeline_snapshot_t;
+
 struct ecs_pipeline_state_t {
     ecs_query_t *query;         /* Pipeline query */
     ecs_vec_t ops;              /* Pipeline schedule */
     ecs_vec_t systems;          /* Vector with system ids */
+    ecs_vec_t matched;          /* vector<ecs_pipeline_match_t> */
 
     ecs_entity_t last_system;   /* Last system run by pipeline */
     int32_t match_count;        /* Used to track if rebuild is necessary */
     int32_t rebuild_count;      /* Number of pipeline rebuilds */
+    int32_t patch_count;        /* Number of partial pipeline rebuilds */
+    int32_t run_count;          /* Number of pipeline runs */
+
+    /* Dependency graph, one node per system in systems vector */
+    ecs_vec_t nodes;            /* vector<ecs_pipeline_node_t> */
+    ecs_vec_t deps;             /* vector<int32_t> */
+    int32_t first_system;       /* First system of current op run */
+    int32_t next_system;        /* Next system to claim (atomic) */
+    int32_t worker_count;       /* Number of threads that run current op */
+
+    /* Work stealing tasks, one element per system in systems vector */
+    ecs_vec_t tasks;            /* vector<ecs_worker_tasks_t> */
+
+    /* Pipelined frame execution */
+    int32_t tail_offset;        /* First system of ops that overlap next frame */
+    ecs_vec_t snapshots;        /* vector<ecs_pipeline_snapshot_t> */
+    ecs_vec_t snapshot_data;    /* vector<char>, arrays copied by snapshots */
+    bool run_snapshots;         /* Whether workers run snapshots in current op */
 
     /* Members for continuing pipeline iteration after pipeline rebuild */
     ecs_pipeline_op_t *cur_op;  /* Current pipeline op */
     int32_t cur_i;              /* Index in current result */
     int32_t ran_since_merge;    /* Index in current op */
     bool immediate;           /* Is pipeline in immediate mode */
+    bool merging;               /* Are workers merging command queues */
 };
 
 typedef struct EcsPipeline {
@@ -4121,11 +4583,67 @@ void flecs_join_worker_threads(
     ecs_world_t *world);
 
 void flecs_signal_workers(
-    ecs_world_t *world);
+    ecs_world_t *world,
+    int32_t count);
 
 void flecs_wait_for_sync(
     ecs_world_t *world);
 
+void flecs_wait_for_system_deps(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system,
+    int32_t required);
+
+void flecs_signal_system_done(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system);
+
+void flecs_worker_tasks_update(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+void flecs_worker_tasks_fini(
+    ecs_pipeline_state_t *pq);
+
+void flecs_worker_tasks_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+ecs_iter_t flecs_worker_steal_iter(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
+////////////////////////////////////////////////////////////////////////////////
+//// Pipelined frame API
+////////////////////////////////////////////////////////////////////////////////
+
+void flecs_pipeline_snapshot_create(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_ftime_t delta_time);
+
+void flecs_pipeline_snapshot_run(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count);
+
+void flecs_pipeline_snapshot_clear(
+    ecs_pipeline_state_t *pq);
+
+void flecs_pipeline_snapshot_filter(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+void flecs_pipeline_snapshot_flush(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
 #endif
 
 #endif
@@ -5013,6 +5531,8 @@ void flecs_bootstrap(
     flecs_bootstrap_make_alive(world, EcsCanToggle);
     flecs_bootstrap_make_alive(world, EcsSparse);
     flecs_bootstrap_make_alive(world, EcsDontFragment);
+    flecs_bootstrap_make_alive(world, EcsCold);
+    flecs_bootstrap_make_alive(world, EcsStableOrder);
     flecs_bootstrap_make_alive(world, EcsObserver);
     flecs_bootstrap_make_alive(world, EcsPairIsTag);
 
@@ -5125,6 +5645,8 @@ void flecs_bootstrap(
     flecs_bootstrap_trait(world, EcsOnDeleteTarget);
     flecs_bootstrap_trait(world, EcsSparse);
     flecs_bootstrap_trait(world, EcsDontFragment);
+    flecs_bootstrap_trait(world, EcsCold);
+    flecs_bootstrap_trait(world, EcsStableOrder);
 
     flecs_bootstrap_tag(world, EcsRemove);
     flecs_bootstrap_tag(world, EcsDelete);
@@ -5248,6 +5770,26 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t cold_trait = { EcsIdCold, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsCold }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &cold_trait,
+        .global_observer = true
+    });
+
+    static ecs_on_trait_ctx_t stable_order_trait = { EcsIdStableOrder, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsStableOrder }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &stable_order_trait,
+        .global_observer = true
+    });
+
     ecs_observer(world, {
         .query.terms = {{ .id = EcsOrderedChildren }},
         .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
@@ -5325,6 +5867,41 @@ void flecs_bootstrap(
     ecs_log_pop();
 }
 
+#ifndef FLECS_SYSTEM_PRIVATE_H
+#define FLECS_SYSTEM_PRIVATE_H
+
+#ifdef FLECS_SYSTEM
+
+#define ecs_system_t_magic     (0x65637383)
+#define ecs_system_t_tag       EcsSystem
+
+extern ecs_mixins_t ecs_system_t_mixins;
+
+/* Creates the iterator that divides the results of a multithreaded system
+ * across workers. When not provided, ecs_worker_iter() is used. */
+typedef ecs_iter_t (*flecs_worker_iter_init_t)(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
+/* Internal function to run a system */
+ecs_entity_t flecs_run_system(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t system,
+    ecs_system_t *system_data,
+    int32_t stage_current,
+    int32_t stage_count,
+    ecs_ftime_t delta_time,
+    void *param,
+    flecs_worker_iter_init_t worker_iter,
+    void *worker_iter_ctx);
+
+#endif
+
+#endif
+
 static ecs_table_t* flecs_find_table_remove(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -5340,40 +5917,111 @@ error:
     return NULL;
 }
 
+/* Payload size of command that stores a pointer */
+#define FLECS_CMD_PTR_SIZE ECS_SIZEOF(void*)
+
+/* Returns whether value can be stored inline in the command stream. Inline
+ * values move when the stream grows, so this is only allowed for values that
+ * are trivially copyable and don't need an address that is stable. */
+static bool flecs_cmd_can_inline(
+    const ecs_type_info_t *ti)
+{
+    return ti->size <= FLECS_CMD_INLINE_SIZE && 
+        ti->alignment <= ECS_SIZEOF(ecs_id_t) &&
+        !(ti->hooks.flags & (ECS_TYPE_HOOK_DTOR|ECS_TYPE_HOOK_COPY|
+            ECS_TYPE_HOOK_MOVE|ECS_TYPE_HOOK_COPY_CTOR|
+            ECS_TYPE_HOOK_MOVE_CTOR));
+}
+
+/* Return command value, or NULL if command has no (remaining) value */
+static void* flecs_cmd_value(
+    const ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValueInline) {
+        return ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else if (cmd->flags & EcsCmdValuePtr) {
+        return *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    }
+    return NULL;
+}
+
+static void flecs_cmd_set_ptr(
+    ecs_cmd_t *cmd,
+    void *ptr)
+{
+    ecs_assert(cmd->length >= ECS_SIZEOF(ecs_cmd_t) + FLECS_CMD_PTR_SIZE,
+        ECS_INTERNAL_ERROR, NULL);
+    *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t)) = ptr;
+    cmd->flags |= EcsCmdValuePtr;
+}
+
+/* Free value storage of command after value was moved out or destructed */
+static void flecs_cmd_free_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & (EcsCmdValuePtr|EcsCmdValueMoved)) {
+        void *ptr = *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+        if (ptr) {
+            flecs_stack_free(ptr, cmd->size);
+        }
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline|EcsCmdValueMoved));
+}
+
+/* Mark value of command as moved out without freeing its storage, so that the
+ * storage can be freed later by the thread that owns the stage stack. */
+static void flecs_cmd_move_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValuePtr) {
+        cmd->flags |= EcsCmdValueMoved;
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline));
+}
+
 static ecs_cmd_t* flecs_cmd_new(
-    ecs_stage_t *stage)
+    ecs_stage_t *stage,
+    ecs_size_t payload)
 {
-    ecs_cmd_t *cmd = ecs_vec_append_t(&stage->allocator, &stage->cmd->queue, 
-        ecs_cmd_t);
-    cmd->is._1.value = NULL;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_size_t length = ECS_SIZEOF(ecs_cmd_t) + 
+        ECS_ALIGN(payload, ECS_SIZEOF(ecs_id_t));
+    ecs_cmd_t *cmd = ecs_vec_grow_t(&stage->allocator, &commands->queue, 
+        uint8_t, length);
     cmd->id = 0;
     cmd->next_for_entity = 0;
-    cmd->entry = NULL;
     cmd->system = stage->system;
+    cmd->size = 0;
+    cmd->length = flecs_ito(int16_t, length);
+    cmd->flags = 0;
+    commands->count ++;
     return cmd;
 }
 
 static ecs_cmd_t* flecs_cmd_new_batched(
     ecs_stage_t *stage, 
-    ecs_entity_t e)
+    ecs_entity_t e,
+    ecs_size_t payload)
 {
-    ecs_vec_t *cmds = &stage->cmd->queue;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_vec_t *cmds = &commands->queue;
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
-        &stage->cmd->entries, ecs_cmd_entry_t, e);
+        &commands->entries, ecs_cmd_entry_t, e);
 
     int32_t cur = ecs_vec_count(cmds);
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, payload);
     bool is_new = false;
     if (entry) {
-        if (entry->first == -1) {
-            /* Existing but invalidated entry */
+        if (entry->epoch != commands->epoch) {
+            /* Existing entry from a queue that was already flushed */
             entry->first = cur;
-            cmd->entry = entry;
+            entry->epoch = commands->epoch;
         } else {
             int32_t last = entry->last;
-            ecs_cmd_t *arr = ecs_vec_first_t(cmds, ecs_cmd_t);
-            if (arr[last].entity == e) {
-                ecs_cmd_t *last_op = &arr[last];
+            ecs_cmd_t *last_op = flecs_cmd_at(cmds, last);
+            if (last_op->entity == e) {
                 last_op->next_for_entity = cur;
                 if (last == entry->first) {
                     /* Flip sign bit so flush logic can tell which command
@@ -5391,9 +6039,10 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     }
 
     if (is_new) {
-        cmd->entry = entry = flecs_sparse_ensure_fast_t(
-            &stage->cmd->entries, ecs_cmd_entry_t, e);
+        entry = flecs_sparse_ensure_fast_t(
+            &commands->entries, ecs_cmd_entry_t, e);
         entry->first = cur;
+        entry->epoch = commands->epoch;
     }
 
     entry->last = cur;
@@ -5401,6 +6050,32 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     return cmd;
 }
 
+/* Create command with storage for a component value. If the value can be 
+ * stored inline, it is appended to the command record. Otherwise it is
+ * allocated from the stack allocator of the command queue. */
+static ecs_cmd_t* flecs_cmd_new_w_value(
+    ecs_stage_t *stage,
+    ecs_entity_t e,
+    const ecs_type_info_t *ti,
+    bool is_inline,
+    void **value_out)
+{
+    ecs_cmd_t *cmd;
+    if (is_inline) {
+        cmd = flecs_cmd_new_batched(stage, e, ti->size);
+        cmd->flags = EcsCmdValueInline;
+        *value_out = ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else {
+        cmd = flecs_cmd_new_batched(stage, e, FLECS_CMD_PTR_SIZE);
+        *value_out = flecs_stack_alloc(
+            &stage->cmd->stack, ti->size, ti->alignment);
+        flecs_cmd_set_ptr(cmd, *value_out);
+    }
+
+    cmd->size = ti->size;
+    return cmd;
+}
+
 bool flecs_defer_begin(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -5430,7 +6105,7 @@ bool flecs_defer_modified(
     ecs_id_t id)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         if (cmd) {
             cmd->kind = EcsCmdModified;
             cmd->id = id;
@@ -5448,11 +6123,13 @@ bool flecs_defer_clone(
     bool clone_value)
 {   
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdClone;
         cmd->id = src;
         cmd->entity = entity;
-        cmd->is._1.clone_value = clone_value;
+        if (clone_value) {
+            cmd->flags |= EcsCmdCloneValue;
+        }
         return true;
     }
     return false;   
@@ -5465,11 +6142,11 @@ bool flecs_defer_path(
     const char *name)
 {
     if (stage->defer > 0) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdPath;
         cmd->entity = entity;
         cmd->id = parent;
-        cmd->is._1.value = ecs_os_strdup(name);
+        flecs_cmd_set_ptr(cmd, ecs_os_strdup(name));
         return true;
     }
     return false;
@@ -5480,7 +6157,7 @@ bool flecs_defer_delete(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdDelete;
         cmd->entity = entity;
         return true;
@@ -5493,7 +6170,7 @@ bool flecs_defer_clear(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdClear;
         cmd->entity = entity;
         return true;
@@ -5508,11 +6185,13 @@ bool flecs_defer_on_delete_action(
     bool force_delete)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdOnDeleteAction;
         cmd->id = id;
         cmd->entity = action;
-        cmd->is._1.force_delete = force_delete;
+        if (force_delete) {
+            cmd->flags |= EcsCmdForceDelete;
+        }
         return true;
     }
     return false;
@@ -5525,7 +6204,7 @@ bool flecs_defer_enable(
     bool enable)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = enable ? EcsCmdEnable : EcsCmdDisable;
         cmd->entity = entity;
         cmd->id = id;
@@ -5553,12 +6232,12 @@ bool flecs_defer_bulk_new(
         *ids_out = ids;
 
         /* Store data in cmd */
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdBulkNew;
         cmd->id = id;
-        cmd->is._n.entities = ids;
-        cmd->is._n.count = count;
+        cmd->size = count;
         cmd->entity = 0;
+        flecs_cmd_set_ptr(cmd, ids);
         return true;
     }
     return false;
@@ -5571,7 +6250,7 @@ bool flecs_defer_add(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         cmd->id = id;
         cmd->entity = entity;
@@ -5587,7 +6266,7 @@ bool flecs_defer_remove(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity); 
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0); 
         cmd->kind = EcsCmdRemove;
         cmd->id = id;
         cmd->entity = entity;
@@ -5636,7 +6315,23 @@ bool flecs_defer_remove(
                             ecs_assert(tr->column != -1,
                                 ECS_INTERNAL_ERROR, NULL);
                             ecs_ref_t *ref = &o->refs[tr->column];
-                            if (ref->entity) {
+                            if (ref->entity && ti->soa) {
+                                /* Struct-of-arrays components can't be 
+                                 * accessed with a ref, copy member-wise. */
+                                ecs_record_t *base_r = flecs_entities_get(
+                                    world, ref->entity);
+                                const ecs_table_record_t *base_tr = 
+                                    flecs_component_get_table(
+                                        cr, base_r->table);
+                                ecs_assert(base_tr != NULL, 
+                                    ECS_INTERNAL_ERROR, NULL);
+                                void *value = ecs_os_alloca(ti->size);
+                                flecs_table_soa_get(base_r->table, 
+                                    base_tr->column, 
+                                    ECS_RECORD_TO_ROW(base_r->row), value);
+                                flecs_table_soa_set(table, tr->column,
+                                    ECS_RECORD_TO_ROW(r->row), value);
+                            } else if (ref->entity) {
                                 void *dst = ECS_OFFSET(
                                     table->data.columns[tr->column].data,
                                     ti->size * ECS_RECORD_TO_ROW(r->row));
@@ -5700,10 +6395,6 @@ void* flecs_defer_emplace(
     ecs_size_t size,
     bool *is_new)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -5713,22 +6404,23 @@ void* flecs_defer_emplace(
         "provided component is not a type");
     ecs_assert(!size || size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
-    size = ti->size;
 
+    ecs_cmd_t *cmd;
     void *cmd_value = ptr.ptr;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
-        cmd_value = flecs_stack_alloc(stack, size, ti->alignment);
-
+        /* Value is returned to the application, so it can't be inlined */
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, false, &cmd_value);
         cmd->kind = EcsCmdEmplace;
-        cmd->is._1.size = size;
-        cmd->is._1.value = cmd_value;
         if (is_new) *is_new = true;
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         if (is_new) *is_new = false;
     }
 
+    cmd->entity = entity;
+    cmd->id = id;
+
     return cmd_value;
 error:
     return NULL;
@@ -5742,19 +6434,19 @@ void* flecs_defer_find_cmd_value(
 {
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
         &stage->cmd->entries, ecs_cmd_entry_t, entity);
-    if (!entry || entry->first == -1) {
+    if (!entry || entry->epoch != stage->cmd->epoch) {
         return NULL;
     }
 
-    ecs_cmd_t *cmds = ecs_vec_first_t(&stage->cmd->queue, ecs_cmd_t);
-    if (cmds[entry->last].entity != entity) {
+    ecs_vec_t *cmds = &stage->cmd->queue;
+    if (flecs_cmd_at(cmds, entry->last)->entity != entity) {
         return NULL;
     }
 
-    void *result = NULL;
+    ecs_cmd_t *result = NULL;
     int32_t cur = entry->first;
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         switch(cmd->kind) {
         case EcsCmdSet:
         case EcsCmdSetDontFragment:
@@ -5762,7 +6454,7 @@ void* flecs_defer_find_cmd_value(
         case EcsCmdEnsure:
         case EcsCmdEnsureDontFragment:
             if (cmd->id == id) {
-                result = cmd->is._1.value;
+                result = cmd;
             }
             break;
         case EcsCmdRemove:
@@ -5793,7 +6485,22 @@ void* flecs_defer_find_cmd_value(
         cur = next < 0 ? -next : next;
     } while (cur);
 
-    return result;
+    if (!result) {
+        return NULL;
+    }
+
+    if (result->flags & EcsCmdValueInline) {
+        /* Value is returned to the application, which requires a stable 
+         * address. Move it out of the command stream. The record is large 
+         * enough to store the pointer in place of the value. */
+        void *value = flecs_stack_alloc(&stage->cmd->stack, result->size, 
+            ECS_SIZEOF(ecs_id_t));
+        ecs_os_memcpy(value, flecs_cmd_value(result), result->size);
+        result->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdValueInline);
+        flecs_cmd_set_ptr(result, value);
+    }
+
+    return flecs_cmd_value(result);
 }
 
 void* flecs_defer_ensure(
@@ -5822,17 +6529,14 @@ void* flecs_defer_ensure(
         }
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_table_t *table = r->table;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
+        /* Value is returned to the application, so it can't be inlined */
+        ecs_cmd_t *cmd = flecs_cmd_new_w_value(
+            stage, entity, ti, false, &ptr.ptr);
         cmd->kind = EcsCmdEnsure;
-        cmd->is._1.size = size;
-        cmd->is._1.value = ptr.ptr = 
-            flecs_stack_alloc(stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Check if entity inherits component */
         void *base = NULL;
@@ -5849,7 +6553,10 @@ void* flecs_defer_ensure(
             flecs_type_info_copy_ctor(ptr.ptr, base, 1, ti);
         }
     } else {
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
+        cmd->entity = entity;
+        cmd->id = id;
     }
 
     return ptr.ptr;
@@ -5868,11 +6575,6 @@ void* flecs_defer_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -5891,24 +6593,30 @@ void* flecs_defer_set(
         "mismatching size specified for component in ensure/emplace/set (%u vs %u)",
             size, ti->size);
 
+    /* The returned pointer is not used after the next command is inserted, 
+     * which allows for storing small values in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                 * that a preceding remove command doesn't cause the entity to
                 * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -5917,13 +6625,16 @@ void* flecs_defer_set(
     if (!ptr.ptr) {
         bool is_dont_fragment = 
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
         flecs_type_info_copy_ctor(ptr.ptr, value, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -5951,11 +6662,6 @@ void* flecs_defer_cpp_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -5966,24 +6672,30 @@ void* flecs_defer_cpp_set(
     ecs_assert(size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
 
+    /* The C++ API assigns the value before inserting other commands, so 
+     * small trivially copyable values can be stored in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                  * that a preceding remove command doesn't cause the entity to
                  * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -5992,14 +6704,17 @@ void* flecs_defer_cpp_set(
     if (!ptr.ptr) {
         bool is_dont_fragment =
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         flecs_type_info_ctor(ptr.ptr, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -6041,7 +6756,7 @@ void* flecs_defer_cpp_assign(
             world, r->table, entity, id, ptr.ptr, value, ptr.ti);
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
     cmd->kind = EcsCmdModified;
     cmd->entity = entity;
     cmd->id = id;
@@ -6054,7 +6769,7 @@ void flecs_enqueue(
     ecs_stage_t *stage,
     ecs_event_desc_t *desc)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
     cmd->kind = EcsCmdEvent;
     cmd->entity = desc->entity;
 
@@ -6073,8 +6788,8 @@ void flecs_enqueue(
         desc_cmd->ids = NULL;
     }
 
-    cmd->is._1.value = desc_cmd;
-    cmd->is._1.size = ECS_SIZEOF(ecs_event_desc_t);
+    cmd->size = ECS_SIZEOF(ecs_event_desc_t);
+    flecs_cmd_set_ptr(cmd, desc_cmd);
 
     if (desc->param || desc->const_param) {
         ecs_assert(!(desc->const_param && desc->param), ECS_INVALID_PARAMETER, 
@@ -6101,10 +6816,10 @@ static void flecs_flush_bulk_new(
     ecs_world_t *world,
     ecs_cmd_t *cmd)
 {
-    ecs_entity_t *entities = cmd->is._n.entities;
+    ecs_entity_t *entities = flecs_cmd_value(cmd);
 
     if (cmd->id) {
-        int i, count = cmd->is._n.count;
+        int i, count = cmd->size;
         for (i = 0; i < count; i ++) {
             ecs_record_t *r = flecs_entities_ensure(world, entities[i]);
             if (!r->table) {
@@ -6151,16 +6866,16 @@ static void flecs_discard_cmd(
     ecs_cmd_t *cmd)
 {
     if (cmd->kind == EcsCmdBulkNew) {
-        ecs_os_free(cmd->is._n.entities);
+        ecs_os_free(flecs_cmd_value(cmd));
     } else if (cmd->kind == EcsCmdEvent) {
-        flecs_free_cmd_event(world, cmd->is._1.value);
+        flecs_free_cmd_event(world, flecs_cmd_value(cmd));
     } else {
         ecs_assert(cmd->kind != EcsCmdEvent, ECS_INTERNAL_ERROR, NULL);
-        void *value = cmd->is._1.value;
+        void *value = flecs_cmd_value(cmd);
         if (value) {
             flecs_dtor_value(world, cmd->id, value);
-            flecs_stack_free(value, cmd->is._1.size);
         }
+        flecs_cmd_free_value(cmd);
     }
 }
 
@@ -6215,11 +6930,191 @@ static bool flecs_remove_invalid(
     return true;
 }
 
+/* Batch add/remove commands for consecutive entities in the same table. This
+ * is the common result of adding or removing a component for all entities
+ * returned by a query, and moves all entities to the new table in a single
+ * operation. Returns the offset of the first command after the batch, or 0 if
+ * no commands were batched. */
+static int32_t flecs_cmd_batch_range(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t start)
+{
+    ecs_cmd_t *cmd = flecs_cmd_at(cmds, start);
+    ecs_cmd_kind_t kind = cmd->kind;
+    ecs_id_t id = cmd->id;
+
+    if (kind != EcsCmdAdd && kind != EcsCmdRemove) {
+        return 0;
+    }
+
+    int32_t end = ecs_vec_count(cmds);
+    int32_t cur = start + cmd->length;
+    if (cur == end) {
+        return 0;
+    }
+
+    ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+    if (!r || !r->table) {
+        return 0;
+    }
+
+    ecs_table_t *table = r->table;
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    int32_t table_count = ecs_table_count(table);
+    int32_t batch_count = 1;
+
+    /* Find number of commands that can be batched */
+    for (; cur < end; cur += cmd->length) {
+        cmd = flecs_cmd_at(cmds, cur);
+        if (cmd->kind != kind || cmd->id != id || cmd->next_for_entity) {
+            break;
+        }
+
+        int32_t next_row = row + batch_count;
+        if (next_row >= table_count) {
+            break;
+        }
+
+        if (ecs_table_entities(table)[next_row] != cmd->entity) {
+            break;
+        }
+
+        batch_count ++;
+    }
+
+    if (batch_count < 2) {
+        return 0;
+    }
+
+    if (kind == EcsCmdAdd) {
+        ecs_id_t valid_id = id;
+        if (!flecs_remove_invalid(world, id, &valid_id) || !valid_id) {
+            /* Let regular command processing handle invalid ids */
+            return 0;
+        }
+    }
+
+    ecs_table_diff_t diff = ECS_TABLE_DIFF_INIT;
+    ecs_table_t *dst_table;
+    if (kind == EcsCmdAdd) {
+        dst_table = flecs_table_traverse_add(world, table, &id, &diff);
+    } else {
+        dst_table = flecs_table_traverse_remove(world, table, &id, &diff);
+    }
+
+    if (dst_table == table) {
+        /* Nothing to move, or non-fragmenting component */
+        return 0;
+    }
+
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, table, row, batch_count, dst_table, &diff, 0);
+    flecs_defer_end(world, world->stages[0]);
+
+    if (kind == EcsCmdAdd) {
+        world->info.cmd.add_count += batch_count;
+    } else {
+        world->info.cmd.remove_count += batch_count;
+    }
+
+    world->info.cmd.batched_entity_count += batch_count;
+    world->info.cmd.batched_command_count += batch_count;
+
+    return cur;
+}
+
+/* Returns whether the value of a set or ensure command can be moved into the
+ * storage of the destination table without first constructing it.
+ * This is possible for components that are added by the batch and that are
+ * stored in a regular table column. Components with an on_replace hook are
+ * excluded, as the hook is invoked with the existing value. Components with an
+ * on_add hook or OnAdd observers are excluded, as the hook is invoked by the
+ * commit before the value is moved into the storage. A component that
+ * the entity had before the batch is moved from the source table, even if it
+ * was removed and added again by the batch. The other components added by the
+ * batch are checked by flecs_cmd_batch_has_on_add(). */
+static bool flecs_cmd_can_emplace(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    ecs_table_t *table,
+    ecs_id_t id)
+{
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    if (!cr || (cr->flags & (EcsIdSparse|EcsIdDontFragment|EcsIdHasOnAdd))) {
+        return false;
+    }
+
+    const ecs_type_info_t *ti = cr->type_info;
+    if (!ti || ti->soa || ti->hooks.on_replace || ti->hooks.on_add ||
+        (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL)) 
+    {
+        return false;
+    }
+
+    return !flecs_component_get_table(cr, src_table) &&
+        !flecs_component_get_table(cr, table);
+}
+
+/* Returns whether a component added by the batch, other than the emplaced
+ * component, has an on_add hook or OnAdd observers. These can access the 
+ * emplaced component during the commit, before its value is moved into the
+ * storage, so the component must be constructed by the commit. */
+static bool flecs_cmd_batch_has_on_add(
+    ecs_world_t *world,
+    const ecs_type_t *added,
+    ecs_id_t emplace_id)
+{
+    int32_t i;
+    for (i = 0; i < added->count; i ++) {
+        ecs_id_t id = added->array[i];
+        if (id == emplace_id) {
+            continue;
+        }
+
+        if (flecs_id_flags_get(world, id) & EcsIdHasOnAdd) {
+            return true;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr && cr->type_info && cr->type_info->hooks.on_add) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Move value of command into the component storage that was not constructed
+ * when the entity was committed to its destination table. */
+static void flecs_cmd_batch_emplace(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *r,
+    ecs_cmd_t *cmd)
+{
+    flecs_component_ptr_t dst = flecs_get_mut(
+        world, entity, cmd->id, r, cmd->size);
+    if (!dst.ptr) {
+        /* Entity was deleted or moved by a hook, value will be discarded */
+        cmd->kind = EcsCmdSkip;
+        cmd->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdBatched);
+        return;
+    }
+
+    flecs_type_info_ctor_move_dtor(dst.ptr, flecs_cmd_value(cmd), 1, dst.ti);
+    flecs_cmd_free_value(cmd);
+
+    /* Same as for other batched set commands, only OnSet observers are left
+     * to be invoked. */
+    cmd->kind = (cmd->kind == EcsCmdSet) ? EcsCmdModified : EcsCmdSkip;
+}
+
 static void flecs_cmd_batch_for_entity(
     ecs_world_t *world,
     ecs_table_diff_builder_t *diff,
     ecs_entity_t entity,
-    ecs_cmd_t *cmds,
+    ecs_vec_t *cmds,
     int32_t start)
 {
     ecs_record_t *r = flecs_entities_get(world, entity);
@@ -6235,8 +7130,14 @@ static void flecs_cmd_batch_for_entity(
     int32_t cur = start;
     int32_t next_for_entity;
 
+    /* The value of one set or ensure command in the batch can be moved into
+     * the storage of the destination table without first constructing it. */
+    ecs_id_t emplace_id = 0;
+    int32_t emplace_cmd = -1;
+    bool can_emplace = true;
+
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         ecs_id_t id = cmd->id;
         next_for_entity = cmd->next_for_entity;
         if (next_for_entity < 0) {
@@ -6287,6 +7188,7 @@ static void flecs_cmd_batch_for_entity(
         case EcsCmdAddModified:
             /* Add is batched, but keep Modified */
             cmd->kind = EcsCmdModified;
+            cmd->flags |= EcsCmdBatched;
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             break;
@@ -6294,11 +7196,19 @@ static void flecs_cmd_batch_for_entity(
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         case EcsCmdSet:
         case EcsCmdEnsure: {
+            if (can_emplace && !emplace_id && 
+                flecs_cmd_can_emplace(world, start_table, table, id)) 
+            {
+                emplace_id = id;
+                emplace_cmd = cur;
+            }
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
+            cmd->flags |= EcsCmdBatched;
             has_set = true;
             break;
         }
@@ -6307,9 +7217,17 @@ static void flecs_cmd_batch_for_entity(
              * the constructor is not invoked for the component */
             break;
         case EcsCmdRemove: {
+            if (emplace_id && ecs_id_match(emplace_id, id)) {
+                /* Component is removed again. Values must be assigned in the
+                 * order of the commands, so construct it as usual. */
+                emplace_id = 0;
+                emplace_cmd = -1;
+                can_emplace = false;
+            }
             table = flecs_find_table_remove(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         }
         case EcsCmdClear:
@@ -6324,6 +7242,10 @@ static void flecs_cmd_batch_for_entity(
             table = &world->store.root;
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
+            emplace_id = 0;
+            emplace_cmd = -1;
+            can_emplace = false;
             break;
         case EcsCmdDelete:
             /* Entity is deleted, don't batch commands after the delete */
@@ -6355,12 +7277,34 @@ static void flecs_cmd_batch_for_entity(
     diff->added.array = NULL;
     diff->added.count = 0;
 
+    /* Set and ensure values of inherited components are initialized with the
+     * value of the base by the constructor, which invokes the on_set hook. */
+    if ((emplace_cmd != -1) && (table->flags & EcsTableHasIsA)) {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
+    /* Hooks of other added components must see a constructed value */
+    if ((emplace_cmd != -1) && 
+        flecs_cmd_batch_has_on_add(world, &added, emplace_id)) 
+    {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
     /* Move entity to destination table in single operation */
     flecs_table_diff_build_noalloc(diff, &table_diff);
     flecs_defer_begin(world, world->stages[0]);
-    flecs_commit(world, entity, r, table, &table_diff, 0, 0);
+    flecs_commit(world, entity, r, table, &table_diff, emplace_id, 0);
     flecs_defer_end(world, world->stages[0]);
 
+    /* Move value into component storage that wasn't constructed by the commit
+     * before any hooks or observers can access it. */
+    if (emplace_cmd != -1) {
+        flecs_cmd_batch_emplace(
+            world, entity, r, flecs_cmd_at(cmds, emplace_cmd));
+    }
+
     /* If destination table has new sparse components, make sure they're created
      * for the entity. */
     if ((table_diff.added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) && added.count) {
@@ -6382,7 +7326,7 @@ static void flecs_cmd_batch_for_entity(
     if (has_set) {
         cur = start;
         do {
-            ecs_cmd_t *cmd = &cmds[cur];
+            ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
             next_for_entity = cmd->next_for_entity;
             if (next_for_entity < 0) {
                 next_for_entity *= -1;
@@ -6392,13 +7336,13 @@ static void flecs_cmd_batch_for_entity(
             case EcsCmdSet:
             case EcsCmdEnsure: {
                 flecs_component_ptr_t dst = flecs_get_mut(
-                    world, entity, cmd->id, r, cmd->is._1.size);
+                    world, entity, cmd->id, r, cmd->size);
 
                 /* It's possible that even though the component was set, the
                  * command queue also contained a remove command, so before we
                  * do anything ensure the entity actually has the component. */
                 if (dst.ptr) {
-                    void *ptr = cmd->is._1.value;
+                    void *ptr = flecs_cmd_value(cmd);
                     const ecs_type_info_t *ti = dst.ti;
                     if (ti->hooks.on_replace) {
                         ecs_table_t *prev_table = r->table;
@@ -6412,7 +7356,7 @@ static void flecs_cmd_batch_for_entity(
                         /* Refetch pointer as the hook could have grown the
                          * table or moved the entity to a different table. */
                         dst = flecs_get_mut(
-                            world, entity, cmd->id, r, cmd->is._1.size);
+                            world, entity, cmd->id, r, cmd->size);
                         if (!dst.ptr) {
                             cmd->kind = EcsCmdSkip;
                             break;
@@ -6425,8 +7369,7 @@ static void flecs_cmd_batch_for_entity(
                         flecs_type_info_dtor(ptr, 1, ti);
                     }
 
-                    flecs_stack_free(ptr, cmd->is._1.size);
-                    cmd->is._1.value = NULL;
+                    flecs_cmd_free_value(cmd);
 
                     if (cmd->kind == EcsCmdSet) {
                         /* A set operation is add + copy + modified. We just did
@@ -6495,344 +7438,1390 @@ done:
     flecs_table_diff_builder_clear(diff);
 }
 
-/* Leave safe section. Run all deferred commands. */
-bool flecs_defer_end(
-    ecs_world_t *world,
-    ecs_stage_t *stage)
+/* Entity with commands that can be applied as part of a coalesced group */
+typedef struct ecs_cmd_coalesce_elem_t {
+    ecs_table_t *src;                /* Table of entity before flush */
+    ecs_table_t *dst;                /* Table of entity after flush */
+    int32_t first;                   /* Offset of first command for entity */
+    int32_t row;                     /* Row of entity in source table */
+} ecs_cmd_coalesce_elem_t;
+
+static int flecs_cmd_coalesce_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
 {
-    flecs_poly_assert(world, ecs_world_t);
-    flecs_poly_assert(stage, ecs_stage_t);
+    const ecs_cmd_coalesce_elem_t *e1 = ptr_1;
+    const ecs_cmd_coalesce_elem_t *e2 = ptr_2;
+    if (e1->src != e2->src) {
+        return (e1->src->id > e2->src->id) - (e1->src->id < e2->src->id);
+    }
+    if (e1->dst != e2->dst) {
+        return (e1->dst->id > e2->dst->id) - (e1->dst->id < e2->dst->id);
+    }
+    return (e1->first > e2->first) - (e1->first < e2->first);
+}
 
-    flecs_check_exclusive_world_access_write(world);
+static int flecs_cmd_coalesce_row_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    int32_t r1 = *(const int32_t*)ptr_1;
+    int32_t r2 = *(const int32_t*)ptr_2;
+    return (r1 > r2) - (r1 < r2);
+}
 
-    if (stage->defer < 0) {
-        /* Suspending defer makes it possible to do operations on the storage
-         * without flushing the commands in the queue */
-        return false;
-    }
+/* Commands that only change the table of an entity, and can be coalesced */
+static bool flecs_cmd_coalesce_kind(
+    ecs_cmd_kind_t kind)
+{
+    return kind == EcsCmdAdd || kind == EcsCmdRemove || 
+        kind == EcsCmdSet || kind == EcsCmdEnsure || 
+        kind == EcsCmdAddModified;
+}
 
-    ecs_assert(stage->defer > 0, ECS_INTERNAL_ERROR, NULL);
+/* Compute destination table of entity for the commands in its chain. Returns
+ * NULL if the commands for the entity can't be applied as part of a group. */
+static ecs_table_t* flecs_cmd_coalesce_dst(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t first,
+    int32_t segment_end,
+    ecs_table_t *src,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_table_t *table = src;
+    int32_t cur = first, next;
 
-    if (!--stage->defer && !stage->cmd_flushing) {
-        ecs_os_perf_trace_push("flecs.commands.merge");
+    flecs_table_diff_builder_clear(diff);
+    diff->added_flags = 0;
+    diff->removed_flags = 0;
 
-        /* Test whether we're flushing to another queue or whether we're 
-         * flushing to the storage */
-        bool merge_to_world = false;
-        if (flecs_poly_is(world, ecs_world_t)) {
-            merge_to_world = world->stages[0]->defer == 0;
+    do {
+        if (cur >= segment_end) {
+            /* Entity has commands outside of segment */
+            return NULL;
         }
 
-        do {
-            ecs_stage_t *dst_stage = flecs_stage_from_world(&world);
-            ecs_commands_t *commands = stage->cmd;
-            ecs_vec_t *queue = &commands->queue;
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_cmd_kind_t kind = cmd->kind;
+        ecs_id_t id = cmd->id, valid_id = id;
+        if (!flecs_cmd_coalesce_kind(kind)) {
+            return NULL;
+        }
 
-            if (stage->cmd == &stage->cmd_stack[0]) {
-                stage->cmd = &stage->cmd_stack[1];
-            } else {
-                stage->cmd = &stage->cmd_stack[0];
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr) {
+            if (cr->flags & (EcsIdSparse|EcsIdDontFragment)) {
+                return NULL;
             }
+        }
 
-            if (!ecs_vec_count(queue)) {
-                break;
+        if (kind == EcsCmdSet || kind == EcsCmdEnsure) {
+            if (!cr || !cr->type_info || !flecs_cmd_value(cmd)) {
+                return NULL;
             }
-
-            stage->cmd_flushing = true;
-
-            /* Internal callback for capturing commands */
-            if (world->on_commands_active) {
-                world->on_commands_active(stage, queue, 
-                    world->on_commands_ctx_active);
+            if (cr->type_info->hooks.on_replace) {
+                return NULL;
             }
+        }
 
-            ecs_cmd_t *cmds = ecs_vec_first(queue);
-            int32_t i, count = ecs_vec_count(queue);
-
-            ecs_table_diff_builder_t diff = {0};
-            bool diff_builder_used = false;
-
-            for (i = 0; i < count; i ++) {
-                ecs_cmd_t *cmd = &cmds[i];
-                ecs_entity_t e = cmd->entity;
-                bool is_alive = flecs_entities_is_alive(world, e);
-
-                /* A negative index indicates the first command for an entity */
-                if (merge_to_world && (cmd->next_for_entity < 0)) {
-                    diff.added_flags = 0;
-                    diff.removed_flags = 0;
-
-                    /* Batch commands for entity to limit archetype moves */
-                    if (is_alive) {
-                        if (!diff_builder_used) {
-                            flecs_table_diff_builder_init(world, &diff);
-                            diff_builder_used = true;
-                        }
-
-                        flecs_cmd_batch_for_entity(world, &diff, e, cmds, i);
-
-                        is_alive = flecs_entities_is_alive(world, e);
-                    } else {
-                        world->info.cmd.discard_count ++;
-                    }
-                }
-
-                /* Invalidate entry */
-                if (cmd->entry) {
-                    cmd->entry->first = -1;
-                }
+        if (!flecs_remove_invalid(world, id, &valid_id) || valid_id != id) {
+            /* Let regular command processing run cleanup actions */
+            return NULL;
+        }
 
-                /* If entity is no longer alive, this could be because the queue
-                 * contained both a delete and a subsequent add/remove/set which
-                 * should be ignored. */
-                ecs_cmd_kind_t kind = cmd->kind;
-                if ((kind != EcsCmdPath) && ((kind == EcsCmdSkip) || (e && !is_alive))) {
-                    world->info.cmd.discard_count ++;
-                    flecs_discard_cmd(world, cmd);
-                    continue;
-                }
+        if (kind == EcsCmdRemove) {
+            table = flecs_find_table_remove(world, table, id, diff);
+        } else {
+            table = flecs_find_table_add(world, table, id, diff);
+        }
 
-                ecs_id_t id = cmd->id;
+        if (!table) {
+            return NULL;
+        }
 
-                switch(kind) {
-                case EcsCmdAdd:
-                    ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-                    if (flecs_remove_invalid(world, id, &id)) {
-                        if (id) {
-                            world->info.cmd.add_count ++;
-                            flecs_add_id(world, e, id);
-                        } else {
-                            world->info.cmd.discard_count ++;
-                        }
-                    } else {
-                        world->info.cmd.discard_count ++;
-                        ecs_delete(world, e);
-                    }
-                    break;
-                case EcsCmdRemove:
-                    flecs_remove_id(world, e, id);
-                    world->info.cmd.remove_count ++;
-                    break;
-                case EcsCmdClone:
-                    if (flecs_entities_is_alive(world, id)) {
-                        ecs_clone(world, e, id, cmd->is._1.clone_value);
-                        world->info.cmd.other_count ++;
-                    } else {
-                        world->info.cmd.discard_count ++;
-                    }
-                    break;
-                case EcsCmdSet:
-                case EcsCmdSetDontFragment:
-                    flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
-                    world->info.cmd.set_count ++;
-                    break;
-                case EcsCmdEmplace:
-                    if (merge_to_world) {
-                        bool is_new;
-                        ecs_emplace_id(world, e, id, 
-                            flecs_itosize(cmd->is._1.size), &is_new);
-                        if (!is_new) {
-                            kind = EcsCmdEnsure;
-                        }
-                    }
-                    flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
-                    world->info.cmd.ensure_count ++;
-                    break;
-                case EcsCmdEnsure:
-                case EcsCmdEnsureDontFragment:
-                    flecs_set_id_move(world, dst_stage, e,
-                        cmd->id, flecs_itosize(cmd->is._1.size),
-                        cmd->is._1.value, kind);
-                    world->info.cmd.ensure_count ++;
-                    break;
-                case EcsCmdModified:
-                    flecs_modified_id_if(world, e, id, true);
-                    world->info.cmd.modified_count ++;
-                    break;
-                case EcsCmdModifiedNoHook:
-                    flecs_modified_id_if(world, e, id, false);
-                    world->info.cmd.modified_count ++;
-                    break;
-                case EcsCmdAddModified:
-                    flecs_add_id(world, e, id);
-                    flecs_modified_id_if(world, e, id, true);
-                    world->info.cmd.set_count ++;
-                    break;
-                case EcsCmdDelete: {
-                    ecs_delete(world, e);
-                    world->info.cmd.delete_count ++;
-                    break;
-                }
-                case EcsCmdClear:
-                    ecs_clear(world, e);
-                    world->info.cmd.clear_count ++;
-                    break;
-                case EcsCmdOnDeleteAction:
-                    ecs_defer_begin(world);
-                    flecs_on_delete(world, id, e, false,
-                        cmd->is._1.force_delete);
-                    ecs_defer_end(world);
-                    world->info.cmd.other_count ++;
-                    break;
-                case EcsCmdEnable:
-                    ecs_enable_id(world, e, id, true);
-                    world->info.cmd.other_count ++;
-                    break;
-                case EcsCmdDisable:
-                    ecs_enable_id(world, e, id, false);
-                    world->info.cmd.other_count ++;
-                    break;
-                case EcsCmdBulkNew:
-                    flecs_flush_bulk_new(world, cmd);
-                    world->info.cmd.other_count ++;
-                    continue;
-                case EcsCmdPath: {
-                    bool keep_alive = true;
-                    ecs_make_alive(world, e);
-                    if (cmd->id) {
-                        if (ecs_is_alive(world, cmd->id)) {
-                            ecs_add_pair(world, e, EcsChildOf, cmd->id);
-                        } else {
-                            ecs_delete(world, e);
-                            keep_alive = false;
-                        }
-                    }
-                    if (keep_alive) {
-                        ecs_set_name(world, e, cmd->is._1.value);
-                    }
-                    ecs_os_free(cmd->is._1.value);
-                    cmd->is._1.value = NULL;
-                    world->info.cmd.other_count ++;
-                    break;
-                }
-                case EcsCmdEvent: {
-                    ecs_event_desc_t *desc = cmd->is._1.value;
-                    ecs_assert(desc != NULL, ECS_INTERNAL_ERROR, NULL);
-                    ecs_emit((ecs_world_t*)stage, desc);
-                    flecs_free_cmd_event(world, desc);
-                    world->info.cmd.event_count ++;
-                    break;
-                }
-                case EcsCmdSkip:
-                    break;
-                }
+        next = cmd->next_for_entity;
+        if (next < 0) {
+            next *= -1;
+        }
+    } while ((cur = next));
 
-                if (cmd->is._1.value) {
-                    flecs_stack_free(cmd->is._1.value, cmd->is._1.size);
-                }
-            }
+    if (table == src) {
+        return NULL;
+    }
 
-            stage->cmd_flushing = false;
+    if (diff->added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) {
+        return NULL;
+    }
 
-            flecs_stack_reset(&commands->stack);
-            ecs_vec_clear(queue);
+    return table;
+}
 
-            if (diff_builder_used) {
-                flecs_table_diff_builder_fini(world, &diff);
-            }
+static bool flecs_cmd_coalesce_diff_eq(
+    const ecs_table_diff_builder_t *d1,
+    const ecs_table_diff_builder_t *d2)
+{
+    if (d1->added_flags != d2->added_flags || 
+        d1->removed_flags != d2->removed_flags) 
+    {
+        return false;
+    }
 
-            /* Internal callback for capturing commands, signal queue is done */
-            if (world->on_commands_active) {
-                world->on_commands_active(stage, NULL, 
-                    world->on_commands_ctx_active);
-            }
-        } while (true);
+    int32_t added = ecs_vec_count(&d1->added);
+    int32_t removed = ecs_vec_count(&d1->removed);
+    if (added != ecs_vec_count(&d2->added) || 
+        removed != ecs_vec_count(&d2->removed)) 
+    {
+        return false;
+    }
 
-        ecs_os_perf_trace_pop("flecs.commands.merge");
+    if (added && ecs_os_memcmp(ecs_vec_first(&d1->added), 
+        ecs_vec_first(&d2->added), ECS_SIZEOF(ecs_id_t) * added)) 
+    {
+        return false;
+    }
 
-        return true;
+    if (removed && ecs_os_memcmp(ecs_vec_first(&d1->removed), 
+        ecs_vec_first(&d2->removed), ECS_SIZEOF(ecs_id_t) * removed)) 
+    {
+        return false;
     }
 
-    return false;
+    return true;
 }
 
-/* Discard commands from queue without executing them. */
-bool flecs_defer_purge(
+/* Apply commands for a group of entities that move from the same source table
+ * to the same destination table. The entities are moved to the end of the
+ * source table, so that they can be moved to the destination table with a
+ * single range operation. */
+static void flecs_cmd_coalesce_group(
     ecs_world_t *world,
-    ecs_stage_t *stage)
+    ecs_vec_t *cmds,
+    ecs_cmd_coalesce_elem_t *elems,
+    int32_t elem_count,
+    int32_t segment_end,
+    ecs_table_diff_builder_t *diff,
+    ecs_table_diff_builder_t *tmp,
+    ecs_vec_t *rows)
 {
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_check(stage != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_t *src = elems[0].src, *dst = elems[0].dst;
+    int32_t i, count = 0;
+
+    ecs_vec_clear(rows);
+
+    /* Observers and hooks of previous groups can't change the tables of 
+     * entities since they're deferred, but can have moved rows. Also make
+     * sure the diff of each entity matches, since the same destination can
+     * be reached with different sequences of commands. */
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, elem->first);
+        ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+        if (r->table != src) {
+            elem->src = NULL;
+            continue;
+        }
 
-    if (!--stage->defer) {
-        ecs_vec_t commands = stage->cmd->queue;
+        ecs_table_diff_builder_t *elem_diff = count ? tmp : diff;
+        if (flecs_cmd_coalesce_dst(world, cmds, elem->first, segment_end, 
+            src, elem_diff) != dst) 
+        {
+            elem->src = NULL;
+            continue;
+        }
 
-        if (ecs_vec_count(&commands)) {
-            ecs_cmd_t *cmds = ecs_vec_first(&commands);
-            int32_t i, count = ecs_vec_count(&commands);
-            for (i = 0; i < count; i ++) {
-                flecs_discard_cmd(world, &cmds[i]);
-            }
+        if (count && !flecs_cmd_coalesce_diff_eq(diff, tmp)) {
+            elem->src = NULL;
+            continue;
+        }
 
-            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, ecs_cmd_t);
+        elem->row = ECS_RECORD_TO_ROW(r->row);
+        ecs_vec_append_t(a, rows, int32_t)[0] = elem->row;
+        count ++;
+    }
 
-            ecs_vec_clear(&commands);
-            flecs_stack_reset(&stage->cmd->stack);
-            flecs_sparse_clear(&stage->cmd->entries);
-        }
+    if (count < 2) {
+        /* Let regular command processing handle remaining entities */
+        flecs_table_diff_builder_clear(diff);
+        return;
+    }
 
-        return true;
+    /* Swap entities that aren't in the last count rows of the table with rows
+     * that don't belong to the group. */
+    int32_t *row_array = ecs_vec_first_t(rows, int32_t);
+    qsort(row_array, flecs_itosize(count), sizeof(int32_t), 
+        flecs_cmd_coalesce_row_cmp);
+
+    int32_t tail = ecs_table_count(src) - count;
+    int32_t outside = 0;
+    while (outside < count && row_array[outside] < tail) {
+        outside ++;
     }
 
-error:
-    return false;
-}
+    int32_t swap_row = tail, tail_member = outside;
+    for (i = 0; i < outside; i ++) {
+        while (tail_member < count && row_array[tail_member] == swap_row) {
+            tail_member ++;
+            swap_row ++;
+        }
+        ecs_table_swap_rows(world, src, row_array[i], swap_row);
+        swap_row ++;
+    }
 
-void flecs_commands_init(
-    ecs_stage_t *stage,
-    ecs_commands_t *cmd)
-{
-    flecs_stack_init(&cmd->stack);
-    ecs_vec_init_t(&stage->allocator, &cmd->queue, ecs_cmd_t, 0);
-    flecs_sparse_init_t(&cmd->entries, &stage->allocator,
-        &stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t);
-}
+    /* Save added ids and clear from diff so that they won't be emitted as
+     * part of the commit, same as for a single entity. */
+    ecs_table_diff_t table_diff;
+    ecs_type_t added = { diff->added.array, diff->added.count };
+    diff->added.array = NULL;
+    diff->added.count = 0;
+    flecs_table_diff_build_noalloc(diff, &table_diff);
 
-void flecs_commands_fini(
-    ecs_stage_t *stage,
-    ecs_commands_t *cmd)
-{
-    /* Make sure stage has no unmerged data */
-    ecs_assert(ecs_vec_count(&cmd->queue) == 0, ECS_INTERNAL_ERROR, NULL);
+    int32_t dst_row = ecs_table_count(dst);
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, src, tail, count, dst, &table_diff, 0);
+    flecs_defer_end(world, world->stages[0]);
 
-    flecs_stack_fini(&cmd->stack);
-    ecs_vec_fini_t(&stage->allocator, &cmd->queue, ecs_cmd_t);
-    flecs_sparse_fini(&cmd->entries);
-}
+    /* Assign values of set commands before OnAdd observers are invoked */
+    int32_t cmd_count = 0;
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        if (!elem->src) {
+            continue;
+        }
 
-bool ecs_defer_begin(
-    ecs_world_t *world)
-{
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_stage_t *stage = flecs_stage_from_world(&world);
-    return flecs_defer_begin(world, stage);
-error:
-    return false;
-}
+        int32_t cur = elem->first, next;
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_entity_t e = cmd->entity;
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r->table == dst, ECS_INTERNAL_ERROR, NULL);
 
-bool ecs_defer_end(
-    ecs_world_t *world)
-{
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_stage_t *stage = flecs_stage_from_world(&world);
-    return flecs_defer_end(world, stage);
-error:
-    return false;
-}
+        /* Prevent entity from being batched again */
+        if (cmd->next_for_entity < 0) {
+            cmd->next_for_entity *= -1;
+        }
 
-void ecs_defer_suspend(
-    ecs_world_t *world)
-{
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_check(ecs_is_deferred(world), ECS_INVALID_OPERATION, 
-        "world/stage must be deferred before it can be suspended");
-    ecs_stage_t *stage = flecs_stage_from_world(&world);
-    ecs_check(stage->defer > 0, ECS_INVALID_OPERATION, 
-        "world/stage is already suspended");
+        do {
+            cmd = flecs_cmd_at(cmds, cur);
+            next = cmd->next_for_entity;
+            cmd_count ++;
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure: {
+                flecs_component_ptr_t ptr = flecs_get_mut(
+                    world, e, cmd->id, r, cmd->size);
+                if (ptr.ptr) {
+                    void *value = flecs_cmd_value(cmd);
+                    const ecs_type_info_t *ti = ptr.ti;
+                    bool move_hook = ti->hooks.move != NULL;
+                    flecs_type_info_move(ptr.ptr, value, 1, ti);
+                    if (move_hook) {
+                        flecs_type_info_dtor(value, 1, ti);
+                    }
+                    flecs_cmd_free_value(cmd);
+                    cmd->kind = (cmd->kind == EcsCmdSet) ? 
+                        EcsCmdModified : EcsCmdSkip;
+                    cmd->flags |= EcsCmdBatched;
+                } else {
+                    /* Component was removed by a later command */
+                    cmd->kind = EcsCmdSkip;
+                }
+                break;
+            }
+            case EcsCmdAddModified:
+                cmd->kind = EcsCmdModified;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+                cmd->kind = EcsCmdSkip;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            case EcsCmdSkip:
+                ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+                break;
+            }
+        } while ((cur = next));
+    }
+
+    /* Emit OnAdd events for all entities in the group in a single batch */
+    if (added.count) {
+        ecs_table_diff_t add_diff = ECS_TABLE_DIFF_INIT;
+        add_diff.added = added;
+        add_diff.added_flags = table_diff.added_flags;
+
+        bool update_parent_records = !table_diff.removed.count ||
+            !(src->flags & EcsTableHasParent);
+
+        flecs_defer_begin(world, world->stages[0]);
+        flecs_actions_move_add(world, dst, src, dst_row, count, &add_diff, 
+            0, false, 0, update_parent_records);
+        flecs_defer_end(world, world->stages[0]);
+    }
+
+    diff->added.array = added.array;
+    diff->added.count = added.count;
+    flecs_table_diff_builder_clear(diff);
+
+    world->info.cmd.batched_entity_count += count;
+    world->info.cmd.batched_command_count += cmd_count;
+}
+
+/* Coalesce table changes for the segment of add/remove/set commands that 
+ * starts at the specified offset. The destination table of each entity in the
+ * segment is computed first, after which entities are sorted by (source, 
+ * destination) table. Each group of entities with the same table transition 
+ * is then moved in a single operation, with a single OnAdd/OnRemove batch.
+ * Returns the offset of the first command after the segment. */
+static int32_t flecs_cmd_coalesce(
+    ecs_world_t *world,
+    ecs_commands_t *commands,
+    int32_t start,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_vec_t *cmds = &commands->queue;
+    int32_t cur, end = ecs_vec_count(cmds);
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t elems;
+    ecs_vec_init_t(a, &elems, ecs_cmd_coalesce_elem_t, 0);
+
+    for (cur = start; cur < end; cur += flecs_cmd_at(cmds, cur)->length) {
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        if (!flecs_cmd_coalesce_kind(cmd->kind)) {
+            break;
+        }
+
+        if (cmd->next_for_entity > 0) {
+            /* Not the first command for the entity */
+            continue;
+        }
+
+        if (!cmd->next_for_entity) {
+            /* Either the only command for the entity, or the last command of
+             * a chain. */
+            ecs_cmd_entry_t *entry = flecs_sparse_get_t(
+                &commands->entries, ecs_cmd_entry_t, cmd->entity);
+            if (!entry || entry->epoch != commands->epoch || 
+                entry->first != cur) 
+            {
+                continue;
+            }
+        }
+
+        ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+        if (!r || !r->table) {
+            continue;
+        }
+
+        if (r->table->_->stable_order) {
+            /* Moving rows around would change the order of the table */
+            continue;
+        }
+
+        ecs_cmd_coalesce_elem_t *elem = ecs_vec_append_t(
+            a, &elems, ecs_cmd_coalesce_elem_t);
+        elem->src = r->table;
+        elem->dst = NULL;
+        elem->first = cur;
+        elem->row = 0;
+    }
+
+    int32_t segment_end = cur;
+    int32_t i, count = ecs_vec_count(&elems);
+    if (count < 2) {
+        goto done;
+    }
+
+    ecs_cmd_coalesce_elem_t *elem_array = ecs_vec_first(&elems);
+
+    /* Find destination table of each entity */
+    int32_t valid_count = 0;
+    for (i = 0; i < count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        elem->dst = flecs_cmd_coalesce_dst(world, cmds, elem->first, 
+            segment_end, elem->src, diff);
+        if (elem->dst) {
+            elem_array[valid_count ++] = *elem;
+        }
+    }
+
+    flecs_table_diff_builder_clear(diff);
+
+    if (valid_count < 2) {
+        goto done;
+    }
+
+    qsort(elem_array, flecs_itosize(valid_count), 
+        sizeof(ecs_cmd_coalesce_elem_t), flecs_cmd_coalesce_cmp);
+
+    ecs_table_diff_builder_t tmp;
+    flecs_table_diff_builder_init(world, &tmp);
+    ecs_vec_t rows;
+    ecs_vec_init_t(a, &rows, int32_t, 0);
+
+    for (i = 0; i < valid_count; ) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        int32_t j = i + 1;
+        while (j < valid_count && elem_array[j].src == elem->src && 
+            elem_array[j].dst == elem->dst) 
+        {
+            j ++;
+        }
+
+        if ((j - i) > 1) {
+            flecs_cmd_coalesce_group(world, cmds, elem, j - i, segment_end,
+                diff, &tmp, &rows);
+        }
+
+        i = j;
+    }
+
+    ecs_vec_fini_t(a, &rows, int32_t);
+    flecs_table_diff_builder_fini(world, &tmp);
+done:
+    ecs_vec_fini_t(a, &elems, ecs_cmd_coalesce_elem_t);
+    return segment_end;
+}
+
+/* Marks entity that can't be merged in place */
+#define FLECS_CMD_NOT_INPLACE (UINT64_MAX)
+
+/* Return pointer to storage of a component that a set/ensure command can be
+ * applied to without changing the table of the entity. */
+static flecs_component_ptr_t flecs_cmd_inplace_ptr(
+    ecs_world_t *world,
+    const ecs_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+    if (!id || !flecs_cmd_value(cmd) || !flecs_entities_is_alive(world, e)) {
+        return (flecs_component_ptr_t){0};
+    }
+
+    if (id >= FLECS_HI_COMPONENT_ID || world->non_trivial_lookup[id]) {
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (!cr || (cr->flags & (EcsIdDontFragment|EcsIdSparse))) {
+            return (flecs_component_ptr_t){0};
+        }
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    flecs_component_ptr_t ptr = flecs_get_mut(world, e, id, r, cmd->size);
+    if (ptr.ptr && ptr.ti->hooks.on_replace) {
+        /* Hook must be invoked in merge order */
+        return (flecs_component_ptr_t){0};
+    }
+
+    return ptr;
+}
+
+/* Find entities owned by worker for which all commands can be merged in 
+ * place. This is the case if all commands for the entity are in the same 
+ * stage, and only assign components the entity already has. */
+static void flecs_cmd_find_inplace(
+    ecs_world_t *world,
+    ecs_map_t *entities,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+
+            if (cmd->kind == EcsCmdClone && 
+                ((uint32_t)cmd->id % (uint32_t)worker_count) == 
+                    (uint32_t)worker_index) 
+            {
+                /* Clone must copy the value of the source entity as it was at
+                 * this point in the merge. */
+                ecs_map_ensure(entities, cmd->id)[0] = FLECS_CMD_NOT_INPLACE;
+            }
+
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(entities, e);
+            if (*v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Commands for entity in multiple stages */
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure:
+                if (!flecs_cmd_inplace_ptr(world, cmd).ptr) {
+                    *v = FLECS_CMD_NOT_INPLACE;
+                    continue;
+                }
+                break;
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdSkip:
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdAddModified:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            default:
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+}
+
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world)
+{
+    bool result = true;
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count && result; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+
+            /* Deleting an entity can cascade to other entities, or remove a
+             * component from entities that are assigned in place, which would
+             * change the order in which commands are applied. */
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind == EcsCmdDelete || kind == EcsCmdClear || 
+                kind == EcsCmdOnDeleteAction) 
+            {
+                result = false;
+                break;
+            }
+
+            ecs_entity_t e = cmd->entity;
+            if (!e) {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(&entities, e);
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Entity is used by commands in multiple stages */
+                result = false;
+                break;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+
+    ecs_map_fini(&entities);
+    return result;
+}
+
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    ecs_assert(worker_count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(worker_index < worker_count, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_map_t entities;
+    ecs_map_init(&entities, &stage->allocator);
+    flecs_cmd_find_inplace(world, &entities, worker_index, worker_count);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_get(&entities, e);
+            if (!v || *v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            /* Commands no longer change the table, so entity doesn't need to
+             * be batched by the regular merge. */
+            if (cmd->next_for_entity < 0) {
+                cmd->next_for_entity *= -1;
+            }
+
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind != EcsCmdSet && kind != EcsCmdEnsure) {
+                continue;
+            }
+
+            flecs_component_ptr_t dst = flecs_cmd_inplace_ptr(world, cmd);
+            ecs_assert(dst.ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            void *ptr = flecs_cmd_value(cmd);
+            const ecs_type_info_t *ti = dst.ti;
+            bool move_hook = ti->hooks.move != NULL;
+            flecs_type_info_move(dst.ptr, ptr, 1, ti);
+            if (move_hook) {
+                flecs_type_info_dtor(ptr, 1, ti);
+            }
+
+            /* Stage stacks are not thread safe, so value storage is freed by
+             * the main thread in the regular merge. */
+            flecs_cmd_move_value(cmd);
+
+            /* Same as for batched set commands, the only thing left to do for
+             * a set is to invoke OnSet observers in the regular merge. */
+            if (kind == EcsCmdSet) {
+                cmd->kind = EcsCmdModified;
+            } else {
+                cmd->kind = EcsCmdSkip;
+            }
+
+            cmd->flags |= EcsCmdBatched;
+        }
+    }
+
+    ecs_map_fini(&entities);
+}
+
+/* Command statistics for a sequence of commands enqueued by the same system */
+typedef struct ecs_cmd_system_stats_t {
+    ecs_entity_t system;             /* System that enqueued the commands */
+    int32_t enqueued;                /* Number of commands in sequence */
+    int32_t discarded;               /* Commands that were not applied */
+    int32_t coalesced;               /* Commands applied as part of a batch */
+    ecs_time_t start;                /* Time at start of sequence */
+} ecs_cmd_system_stats_t;
+
+/* Add statistics for a sequence of commands to the system that enqueued them,
+ * and start a new sequence for the next system. */
+static void flecs_cmd_system_stats_flush(
+    ecs_world_t *world,
+    ecs_cmd_system_stats_t *stats,
+    ecs_entity_t next_system)
+{
+    double time_spent = ecs_time_measure(&stats->start);
+
+#ifdef FLECS_SYSTEM
+    ecs_entity_t system = stats->system;
+    if (system && flecs_entities_is_alive(world, system)) {
+        /* Commands can also be enqueued by observers, which are ignored */
+        ecs_system_t *ptr = flecs_poly_get(world, system, ecs_system_t);
+        if (ptr) {
+            ptr->commands_enqueued += stats->enqueued;
+            ptr->commands_discarded += stats->discarded;
+            ptr->commands_coalesced += stats->coalesced;
+            ptr->command_time += (ecs_ftime_t)time_spent;
+        }
+    }
+#else
+    (void)world;
+    (void)time_spent;
+#endif
+
+    stats->system = next_system;
+    stats->enqueued = 0;
+    stats->discarded = 0;
+    stats->coalesced = 0;
+}
+
+/* Leave safe section. Run all deferred commands. */
+bool flecs_defer_end(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    flecs_poly_assert(stage, ecs_stage_t);
+
+    flecs_check_exclusive_world_access_write(world);
+
+    if (stage->defer < 0) {
+        /* Suspending defer makes it possible to do operations on the storage
+         * without flushing the commands in the queue */
+        return false;
+    }
+
+    ecs_assert(stage->defer > 0, ECS_INTERNAL_ERROR, NULL);
+
+    if (!--stage->defer && !stage->cmd_flushing) {
+        ecs_os_perf_trace_push("flecs.commands.merge");
+
+        /* Test whether we're flushing to another queue or whether we're 
+         * flushing to the storage */
+        bool merge_to_world = false;
+        if (flecs_poly_is(world, ecs_world_t)) {
+            merge_to_world = world->stages[0]->defer == 0;
+        }
+
+        if (merge_to_world) {
+            /* Rows removed from tables with StableOrder are put back in order
+             * once, after all commands are flushed. */
+            world->store.defer_row_order ++;
+        }
+
+        do {
+            ecs_stage_t *dst_stage = flecs_stage_from_world(&world);
+            ecs_commands_t *commands = stage->cmd;
+            ecs_vec_t *queue = &commands->queue;
+
+            if (stage->cmd == &stage->cmd_stack[0]) {
+                stage->cmd = &stage->cmd_stack[1];
+            } else {
+                stage->cmd = &stage->cmd_stack[0];
+            }
+
+            if (!ecs_vec_count(queue)) {
+                break;
+            }
+
+            stage->cmd_flushing = true;
+
+            /* Internal callback for capturing commands */
+            if (world->on_commands_active) {
+                world->on_commands_active(stage, queue, 
+                    world->on_commands_ctx_active);
+            }
+
+            int32_t cur, next, end = ecs_vec_count(queue);
+
+            ecs_table_diff_builder_t diff = {0};
+            bool diff_builder_used = false;
+            bool coalesce = merge_to_world && 
+                (world->flags & EcsWorldCoalesceCommands);
+            int32_t coalesced_end = 0;
+
+            /* Attribute merged commands to the systems that enqueued them */
+            ecs_cmd_system_stats_t sys_stats = {0};
+            bool measure_time = merge_to_world && 
+                (world->flags & EcsWorldMeasureSystemTime);
+            if (measure_time) {
+                ecs_os_get_time(&sys_stats.start);
+            }
+
+            /* Decode commands sequentially from the command stream. The queue
+             * doesn't grow while it's flushed, so command pointers are stable
+             * for the duration of the loop. */
+            for (cur = 0; cur < end; cur = next) {
+                ecs_cmd_t *cmd = flecs_cmd_at(queue, cur);
+                ecs_entity_t e = cmd->entity;
+                next = cur + cmd->length;
+
+                if (measure_time && (cmd->system != sys_stats.system)) {
+                    flecs_cmd_system_stats_flush(
+                        world, &sys_stats, cmd->system);
+                }
+
+                sys_stats.enqueued ++;
+
+                /* Move entities with the same table transition in a segment of
+                 * add/remove/set commands to the new table in bulk. */
+                if (coalesce && cur >= coalesced_end && 
+                    flecs_cmd_coalesce_kind(cmd->kind)) 
+                {
+                    if (!diff_builder_used) {
+                        flecs_table_diff_builder_init(world, &diff);
+                        diff_builder_used = true;
+                    }
+
+                    coalesced_end = flecs_cmd_coalesce(
+                        world, commands, cur, &diff);
+                }
+
+                /* Move entities that get the same component added or removed
+                 * to the new table in a single operation. */
+                if (merge_to_world && !cmd->next_for_entity) {
+                    int32_t batch_end = flecs_cmd_batch_range(
+                        world, queue, cur);
+                    if (batch_end) {
+                        int32_t batch_count = (batch_end - cur) / cmd->length;
+                        sys_stats.enqueued += batch_count - 1;
+                        sys_stats.coalesced += batch_count;
+                        next = batch_end;
+                        continue;
+                    }
+                }
+
+                bool is_alive = flecs_entities_is_alive(world, e);
+
+                /* A negative index indicates the first command for an entity */
+                if (merge_to_world && (cmd->next_for_entity < 0)) {
+                    diff.added_flags = 0;
+                    diff.removed_flags = 0;
+
+                    /* Batch commands for entity to limit archetype moves */
+                    if (is_alive) {
+                        if (!diff_builder_used) {
+                            flecs_table_diff_builder_init(world, &diff);
+                            diff_builder_used = true;
+                        }
+
+                        flecs_cmd_batch_for_entity(world, &diff, e, queue, cur);
+
+                        is_alive = flecs_entities_is_alive(world, e);
+                    } else {
+                        world->info.cmd.discard_count ++;
+                    }
+                }
+
+                /* If entity is no longer alive, this could be because the queue
+                 * contained both a delete and a subsequent add/remove/set which
+                 * should be ignored. */
+                ecs_cmd_kind_t kind = cmd->kind;
+                bool batched = cmd->flags & EcsCmdBatched;
+                if (batched) {
+                    sys_stats.coalesced ++;
+                }
+
+                if ((kind != EcsCmdPath) && ((kind == EcsCmdSkip) || (e && !is_alive))) {
+                    world->info.cmd.discard_count ++;
+                    if (!batched) {
+                        sys_stats.discarded ++;
+                    }
+                    flecs_discard_cmd(world, cmd);
+                    continue;
+                }
+
+                ecs_id_t id = cmd->id;
+
+                switch(kind) {
+                case EcsCmdAdd:
+                    ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
+                    if (flecs_remove_invalid(world, id, &id)) {
+                        if (id) {
+                            world->info.cmd.add_count ++;
+                            flecs_add_id(world, e, id);
+                        } else {
+                            world->info.cmd.discard_count ++;
+                            sys_stats.discarded ++;
+                        }
+                    } else {
+                        world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
+                        ecs_delete(world, e);
+                    }
+                    break;
+                case EcsCmdRemove:
+                    flecs_remove_id(world, e, id);
+                    world->info.cmd.remove_count ++;
+                    break;
+                case EcsCmdClone:
+                    if (flecs_entities_is_alive(world, id)) {
+                        ecs_clone(world, e, id, 
+                            cmd->flags & EcsCmdCloneValue);
+                        world->info.cmd.other_count ++;
+                    } else {
+                        world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
+                    }
+                    break;
+                case EcsCmdSet:
+                case EcsCmdSetDontFragment:
+                    flecs_set_id_move(world, dst_stage, e, 
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
+                    world->info.cmd.set_count ++;
+                    break;
+                case EcsCmdEmplace:
+                    if (merge_to_world) {
+                        bool is_new;
+                        ecs_emplace_id(world, e, id, 
+                            flecs_itosize(cmd->size), &is_new);
+                        if (!is_new) {
+                            kind = EcsCmdEnsure;
+                        }
+                    }
+                    flecs_set_id_move(world, dst_stage, e, 
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
+                    world->info.cmd.ensure_count ++;
+                    break;
+                case EcsCmdEnsure:
+                case EcsCmdEnsureDontFragment:
+                    flecs_set_id_move(world, dst_stage, e,
+                        cmd->id, flecs_itosize(cmd->size),
+                        flecs_cmd_value(cmd), kind);
+                    world->info.cmd.ensure_count ++;
+                    break;
+                case EcsCmdModified:
+                    flecs_modified_id_if(world, e, id, true);
+                    world->info.cmd.modified_count ++;
+                    break;
+                case EcsCmdModifiedNoHook:
+                    flecs_modified_id_if(world, e, id, false);
+                    world->info.cmd.modified_count ++;
+                    break;
+                case EcsCmdAddModified:
+                    flecs_add_id(world, e, id);
+                    flecs_modified_id_if(world, e, id, true);
+                    world->info.cmd.set_count ++;
+                    break;
+                case EcsCmdDelete: {
+                    ecs_delete(world, e);
+                    world->info.cmd.delete_count ++;
+                    break;
+                }
+                case EcsCmdClear:
+                    ecs_clear(world, e);
+                    world->info.cmd.clear_count ++;
+                    break;
+                case EcsCmdOnDeleteAction:
+                    ecs_defer_begin(world);
+                    flecs_on_delete(world, id, e, false,
+                        cmd->flags & EcsCmdForceDelete);
+                    ecs_defer_end(world);
+                    world->info.cmd.other_count ++;
+                    break;
+                case EcsCmdEnable:
+                    ecs_enable_id(world, e, id, true);
+                    world->info.cmd.other_count ++;
+                    break;
+                case EcsCmdDisable:
+                    ecs_enable_id(world, e, id, false);
+                    world->info.cmd.other_count ++;
+                    break;
+                case EcsCmdBulkNew:
+                    flecs_flush_bulk_new(world, cmd);
+                    world->info.cmd.other_count ++;
+                    continue;
+                case EcsCmdPath: {
+                    bool keep_alive = true;
+                    ecs_make_alive(world, e);
+                    if (cmd->id) {
+                        if (ecs_is_alive(world, cmd->id)) {
+                            ecs_add_pair(world, e, EcsChildOf, cmd->id);
+                        } else {
+                            ecs_delete(world, e);
+                            keep_alive = false;
+                        }
+                    }
+                    if (keep_alive) {
+                        ecs_set_name(world, e, flecs_cmd_value(cmd));
+                    }
+                    ecs_os_free(flecs_cmd_value(cmd));
+                    cmd->flags = 0;
+                    world->info.cmd.other_count ++;
+                    break;
+                }
+                case EcsCmdEvent: {
+                    ecs_event_desc_t *desc = flecs_cmd_value(cmd);
+                    ecs_assert(desc != NULL, ECS_INTERNAL_ERROR, NULL);
+                    ecs_emit((ecs_world_t*)stage, desc);
+                    flecs_free_cmd_event(world, desc);
+                    world->info.cmd.event_count ++;
+                    break;
+                }
+                case EcsCmdSkip:
+                    break;
+                }
+
+                flecs_cmd_free_value(cmd);
+            }
+
+            if (measure_time) {
+                flecs_cmd_system_stats_flush(world, &sys_stats, 0);
+            }
+
+            stage->cmd_flushing = false;
+
+            /* Invalidate entries, as their offsets point into the queue */
+            commands->epoch ++;
+
+            flecs_stack_reset(&commands->stack);
+            ecs_vec_clear(queue);
+            commands->count = 0;
+
+            if (diff_builder_used) {
+                flecs_table_diff_builder_fini(world, &diff);
+            }
+
+            /* Internal callback for capturing commands, signal queue is done */
+            if (world->on_commands_active) {
+                world->on_commands_active(stage, NULL, 
+                    world->on_commands_ctx_active);
+            }
+        } while (true);
+
+        if (merge_to_world && !--world->store.defer_row_order) {
+            flecs_table_restore_row_order(world);
+        }
+
+        ecs_os_perf_trace_pop("flecs.commands.merge");
+
+        return true;
+    }
+
+    return false;
+}
+
+/* Discard commands from queue without executing them. */
+bool flecs_defer_purge(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(stage != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!--stage->defer) {
+        ecs_vec_t commands = stage->cmd->queue;
+
+        if (ecs_vec_count(&commands)) {
+            int32_t cur, end = ecs_vec_count(&commands);
+            ecs_cmd_t *cmd;
+            for (cur = 0; cur < end; cur += cmd->length) {
+                cmd = flecs_cmd_at(&commands, cur);
+                flecs_discard_cmd(world, cmd);
+            }
+
+            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, uint8_t);
+            stage->cmd->count = 0;
+
+            ecs_vec_clear(&commands);
+            flecs_stack_reset(&stage->cmd->stack);
+            flecs_sparse_clear(&stage->cmd->entries);
+        }
+
+        return true;
+    }
+
+error:
+    return false;
+}
+
+void flecs_commands_init(
+    ecs_stage_t *stage,
+    ecs_commands_t *cmd)
+{
+    flecs_stack_init(&cmd->stack);
+    ecs_vec_init_t(&stage->allocator, &cmd->queue, uint8_t, 0);
+    cmd->count = 0;
+    cmd->epoch = 0;
+    flecs_sparse_init_t(&cmd->entries, &stage->allocator,
+        &stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t);
+}
+
+void flecs_commands_fini(
+    ecs_stage_t *stage,
+    ecs_commands_t *cmd)
+{
+    /* Make sure stage has no unmerged data */
+    ecs_assert(ecs_vec_count(&cmd->queue) == 0, ECS_INTERNAL_ERROR, NULL);
+
+    flecs_stack_fini(&cmd->stack);
+    ecs_vec_fini_t(&stage->allocator, &cmd->queue, uint8_t);
+    flecs_sparse_fini(&cmd->entries);
+}
+
+void flecs_async_init(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_os_zeromem(q);
+    if (ecs_os_has_threading()) {
+        q->lock = ecs_os_mutex_new();
+    }
+}
+
+static void flecs_async_cmd_free(
+    ecs_async_cmd_t *cmd)
+{
+    if (cmd->value && (cmd->value != cmd->inline_value)) {
+        ecs_os_free(cmd->value);
+    }
+    cmd->value = NULL;
+}
+
+static void flecs_async_segments_free(
+    ecs_async_segment_t *seg)
+{
+    while (seg) {
+        ecs_async_segment_t *next = seg->next;
+        ecs_os_free(seg);
+        seg = next;
+    }
+}
+
+void flecs_async_fini(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = q->head;
+
+    /* Free values of commands that weren't merged */
+    while (seg) {
+        int32_t i, count = ecs_os_aload(&seg->reserved);
+        if (count > FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            count = FLECS_ASYNC_CMD_SEGMENT_SIZE;
+        }
+        for (i = seg->read; i < count; i ++) {
+            flecs_async_cmd_free(&seg->cmds[i]);
+        }
+        seg = seg->next;
+    }
+
+    flecs_async_segments_free(q->head);
+    flecs_async_segments_free(q->retired);
+    flecs_async_segments_free(q->free);
+
+    if (q->lock) {
+        ecs_os_mutex_free(q->lock);
+    }
+
+    ecs_os_zeromem(q);
+}
+
+/* Claim a slot in the async queue. This only takes a lock if the last segment
+ * of the queue is full. */
+static ecs_async_cmd_t* flecs_async_cmd_new(
+    ecs_async_queue_t *q)
+{
+    ecs_assert(q != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(q->lock != 0, ECS_INTERNAL_ERROR, NULL);
+
+    /* Segments are only reused by the consumer while no producer is active */
+    ecs_os_ainc(&q->producers);
+
+    do {
+        ecs_async_segment_t *seg = ecs_os_aloadp(&q->tail);
+        if (seg) {
+            int32_t index = ecs_os_ainc(&seg->reserved) - 1;
+            if (index < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+                return &seg->cmds[index];
+            }
+        }
+
+        ecs_os_mutex_lock(q->lock);
+        if (q->tail == seg) {
+            /* No other thread linked a new segment yet */
+            ecs_async_segment_t *new_seg = q->free;
+            if (new_seg) {
+                q->free = new_seg->next;
+                new_seg->next = NULL;
+            } else {
+                new_seg = ecs_os_calloc_t(ecs_async_segment_t);
+            }
+
+            /* Publish the segment after it is initialized */
+            if (seg) {
+                seg->next = new_seg;
+            } else {
+                ecs_os_astorep(&q->head, new_seg);
+            }
+            ecs_os_astorep(&q->tail, new_seg);
+        }
+        ecs_os_mutex_unlock(q->lock);
+    } while (true);
+}
+
+/* Make command visible to the consumer */
+static void flecs_async_cmd_publish(
+    ecs_async_queue_t *q,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_os_ainc(&cmd->ready);
+    ecs_os_adec(&q->producers);
+}
+
+static void flecs_async_cmd_apply(
+    ecs_world_t *world,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+
+    if (cmd->kind == EcsCmdEvent) {
+        if (!e || ecs_is_alive(world, e)) {
+            ecs_enqueue(world, cmd->value);
+            world->info.cmd.event_count ++;
+        } else {
+            world->info.cmd.discard_count ++;
+        }
+    } else if (!ecs_is_alive(world, e) || (id && !ecs_id_is_valid(world, id))) {
+        world->info.cmd.discard_count ++;
+    } else {
+        switch(cmd->kind) {
+        case EcsCmdAdd:
+            ecs_add_id(world, e, id);
+            break;
+        case EcsCmdRemove:
+            ecs_remove_id(world, e, id);
+            break;
+        case EcsCmdSet:
+            ecs_set_id(world, e, id, flecs_itosize(cmd->size), cmd->value);
+            break;
+        case EcsCmdDelete:
+            ecs_delete(world, e);
+            break;
+        case EcsCmdClone:
+        case EcsCmdBulkNew:
+        case EcsCmdSetDontFragment:
+        case EcsCmdEmplace:
+        case EcsCmdEnsure:
+        case EcsCmdEnsureDontFragment:
+        case EcsCmdModified:
+        case EcsCmdModifiedNoHook:
+        case EcsCmdAddModified:
+        case EcsCmdPath:
+        case EcsCmdClear:
+        case EcsCmdOnDeleteAction:
+        case EcsCmdEnable:
+        case EcsCmdDisable:
+        case EcsCmdEvent:
+        case EcsCmdSkip:
+            ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+            break;
+        }
+    }
+
+    flecs_async_cmd_free(cmd);
+}
+
+void flecs_async_merge(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = ecs_os_aloadp(&q->head);
+    if (!seg) {
+        return;
+    }
+
+    if (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE && 
+        seg->read >= ecs_os_aload(&seg->reserved) && !q->retired) 
+    {
+        /* Nothing to merge */
+        return;
+    }
+
+    /* Merged commands are enqueued to the regular command queue, so that
+     * they're batched with other commands. */
+    ecs_defer_begin(world);
+
+    do {
+        while (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            ecs_async_cmd_t *cmd = &seg->cmds[seg->read];
+            if (ecs_os_adec(&cmd->ready)) {
+                /* Command is claimed but not yet written. Restore the flag and
+                 * stop, so that commands of a thread stay in order. */
+                ecs_os_ainc(&cmd->ready);
+                goto done;
+            }
+
+            flecs_async_cmd_apply(world, cmd);
+            seg->read ++;
+        }
+
+        /* Segment is merged, continue with the next segment */
+        ecs_os_mutex_lock(q->lock);
+        ecs_async_segment_t *next = seg->next;
+        if (next) {
+            q->head = next;
+            seg->next = q->retired;
+            q->retired = seg;
+        }
+        ecs_os_mutex_unlock(q->lock);
+
+        seg = next;
+    } while (seg);
+done:
+    ecs_defer_end(world);
+
+    /* Retired segments can be reused once no producer holds a pointer to them.
+     * Producers that start after this point can only see the tail segment. */
+    if (q->retired) {
+        int32_t producers = ecs_os_ainc(&q->producers) - 1;
+        ecs_os_adec(&q->producers);
+        if (!producers) {
+            ecs_os_mutex_lock(q->lock);
+            while ((seg = q->retired)) {
+                q->retired = seg->next;
+                seg->reserved = 0;
+                seg->read = 0;
+                seg->next = q->free;
+                q->free = seg;
+            }
+            ecs_os_mutex_unlock(q->lock);
+        }
+    }
+}
+
+bool ecs_defer_begin(
+    ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    return flecs_defer_begin(world, stage);
+error:
+    return false;
+}
+
+bool ecs_defer_end(
+    ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    return flecs_defer_end(world, stage);
+error:
+    return false;
+}
+
+void ecs_defer_suspend(
+    ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_is_deferred(world), ECS_INVALID_OPERATION, 
+        "world/stage must be deferred before it can be suspended");
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    ecs_check(stage->defer > 0, ECS_INVALID_OPERATION, 
+        "world/stage is already suspended");
     stage->defer = -stage->defer;
 error:
     return;
@@ -6850,6 +8839,178 @@ error:
     return;
 }
 
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change coalesced merge while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldCoalesceCommands, enable);
+error:
+    return;
+}
+
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldCoalesceCommands);
+error:
+    return false;
+}
+
+/* Returns NULL if the queue has no lock because threading isn't set up */
+static ecs_async_queue_t* flecs_async_queue(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_check(q->lock != 0, ECS_MISSING_OS_API, 
+        "async commands require the threading OS API");
+    if (!q->lock) {
+        /* Checks are compiled out in release builds */
+        return NULL;
+    }
+    return q;
+error:
+    return NULL;
+}
+
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdAdd;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdRemove;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ptr != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    ecs_size_t value_size = flecs_uto(ecs_size_t, size);
+    cmd->kind = EcsCmdSet;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->size = value_size;
+    if (value_size <= FLECS_ASYNC_CMD_INLINE_SIZE) {
+        cmd->value = cmd->inline_value;
+    } else {
+        cmd->value = ecs_os_malloc(value_size);
+    }
+    ecs_os_memcpy(cmd->value, ptr, value_size);
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdDelete;
+    cmd->entity = entity;
+    cmd->id = 0;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc)
+{
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->event != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->table == NULL, ECS_INVALID_PARAMETER, 
+        "async events can only be emitted for entities");
+    ecs_check(!desc->param && !desc->const_param, ECS_INVALID_PARAMETER,
+        "async events can't have a param");
+    ecs_check(desc->ids != NULL && desc->ids->count != 0, 
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+
+    /* Store descriptor, type and ids in a single allocation */
+    int32_t id_count = desc->ids->count;
+    ecs_size_t size = ECS_SIZEOF(ecs_event_desc_t) + ECS_SIZEOF(ecs_type_t) +
+        id_count * ECS_SIZEOF(ecs_id_t);
+    ecs_event_desc_t *desc_cmd = ecs_os_malloc(size);
+    ecs_type_t *type_cmd = ECS_OFFSET(desc_cmd, ECS_SIZEOF(ecs_event_desc_t));
+    ecs_os_memcpy_t(desc_cmd, desc, ecs_event_desc_t);
+    type_cmd->array = ECS_OFFSET(type_cmd, ECS_SIZEOF(ecs_type_t));
+    type_cmd->count = id_count;
+    ecs_os_memcpy_n(type_cmd->array, desc->ids->array, ecs_id_t, id_count);
+    desc_cmd->ids = type_cmd;
+
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdEvent;
+    cmd->entity = desc->entity;
+    cmd->id = 0;
+    cmd->value = desc_cmd;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
 void flecs_invoke_hook(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -7775,6 +9936,12 @@ flecs_component_ptr_t flecs_table_get_component(
 {
     ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
     ecs_column_t *column = &table->data.columns[column_index];
+    if (column->flags & EcsColumnSoA) {
+        /* Members of struct-of-arrays components are not stored contiguously,
+         * so there is no pointer to the component value. */
+        return (flecs_component_ptr_t){ .ti = column->ti };
+    }
+
     return (flecs_component_ptr_t){
         .ti = column->ti,
         .ptr = ECS_ELEM(column->data, column->ti->size, row)
@@ -7970,6 +10137,57 @@ void flecs_commit(
     return;
 }
 
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags)
+{
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != dst_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ecs_table_count(src_table) >= (src_row + count), 
+        ECS_INTERNAL_ERROR, NULL);
+
+    ecs_os_perf_trace_push("flecs.commit_range");
+
+    /* Count traversable entities so that the traversable counters of the
+     * tables can be updated in one step. */
+    const ecs_entity_t *entities = ecs_table_entities(src_table);
+    int32_t i, trav_count = 0;
+    if (src_table->_->traversable_count) {
+        for (i = 0; i < count; i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[src_row + i]);
+            trav_count += (r->row & EcsEntityIsTraversable) != 0;
+        }
+    }
+
+    if (trav_count) {
+        flecs_table_traversable_add(dst_table, trav_count);
+    }
+
+    /* Invoke remove actions for removed components */
+    flecs_actions_move_remove(world, src_table, dst_table, src_row, count, diff);
+
+    /* Move entities & components from src_table to dst_table */
+    int32_t dst_row = flecs_table_move_range(
+        world, dst_table, src_table, src_row, count);
+
+    flecs_actions_move_add(world, dst_table, src_table, dst_row, count, diff,
+        evt_flags, true, 0, true);
+
+    if (trav_count) {
+        flecs_table_traversable_add(src_table, -trav_count);
+    }
+
+    ecs_os_perf_trace_pop("flecs.commit_range");
+}
+
 const ecs_entity_t* flecs_bulk_new(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -8065,6 +10283,19 @@ const ecs_entity_t* flecs_bulk_new(
                 int32_t index = tr->column;
                 ecs_column_t *column = &table->data.columns[index];
                 ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+
+                if (column->flags & EcsColumnSoA) {
+                    /* Struct-of-arrays components have trivial lifecycle, so
+                     * values can be scattered to member arrays for both copy
+                     * and move. */
+                    int32_t e;
+                    for (e = 0; e < count; e ++) {
+                        flecs_table_soa_set(table, index, row + e,
+                            ECS_ELEM(src_ptr, size, e));
+                    }
+                    continue;
+                }
+
                 ptr = ECS_ELEM(column->data, size, row);
 
                 if (is_move) {
@@ -8208,10 +10439,9 @@ flecs_component_ptr_t flecs_ensure(
     if (component < FLECS_HI_COMPONENT_ID) {
         int16_t column_index = table->component_map[component];
         if (column_index > 0) {
-            ecs_column_t *column = &table->data.columns[column_index - 1];
-            ecs_assert(column->ti->size == size, ECS_INTERNAL_ERROR, NULL);
-            dst.ptr = ECS_ELEM(column->data, size, ECS_RECORD_TO_ROW(r->row));
-            dst.ti = column->ti;
+            dst = flecs_table_get_component(
+                table, column_index - 1, ECS_RECORD_TO_ROW(r->row));
+            ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         } else if (column_index < 0) {
             column_index = flecs_ito(int16_t, -column_index - 1);
@@ -8229,7 +10459,7 @@ flecs_component_ptr_t flecs_ensure(
         cr = flecs_components_get(world, component);
         dst = flecs_get_component_ptr(
             world, table, ECS_RECORD_TO_ROW(r->row), cr);
-        if (dst.ptr) {
+        if (dst.ptr || (dst.ti && dst.ti->soa)) {
             ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         }
@@ -8500,7 +10730,8 @@ static void flecs_copy_id(
 
     flecs_type_info_copy(dst_ptr, src_ptr, 1, ti);
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     ecs_table_t *table = r->table;
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -8509,6 +10740,30 @@ static void flecs_copy_id(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, dst_ptr);
 }
 
+/* Scatter value into the member arrays of a struct-of-arrays component. */
+static void flecs_set_soa_id(
+    ecs_world_t *world,
+    ecs_record_t *r,
+    ecs_id_t component,
+    const void *src_ptr,
+    bool on_set)
+{
+    ecs_table_t *table = r->table;
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_component_record_t *cr = flecs_components_get(world, component);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    flecs_table_soa_set(table, tr->column, row, src_ptr);
+    flecs_table_mark_dirty(world, table, component, row);
+
+    if (on_set) {
+        flecs_notify_on_set(world, table, row, component, true, NULL);
+    }
+}
+
 /* If operation is not deferred, add components by finding the target
  * table and moving the entity towards it. */
 static int flecs_traverse_add(
@@ -9244,6 +11499,17 @@ ecs_entity_t ecs_clone(
             int32_t index = ecs_table_column_to_type_index(dst_table, i);
             ecs_id_t component = dst_table->type.array[index];
 
+            if (dst_table->data.columns[i].flags & EcsColumnSoA) {
+                void *value = ecs_os_alloca(dst_table->data.columns[i].ti->size);
+                flecs_table_soa_get(src_table, 
+                    ecs_table_get_column_index(world, src_table, component),
+                    ECS_RECORD_TO_ROW(src_r->row), value);
+                flecs_table_soa_set(dst_table, i, row, value);
+                flecs_notify_on_set(world, dst_table, row, component, true,
+                    NULL);
+                continue;
+            }
+
             void *dst_ptr = ecs_get_mut_id(world, dst, component);
             if (!dst_ptr) {
                 continue;
@@ -9632,7 +11898,7 @@ void flecs_modified_id_if(
 
     flecs_notify_on_set(world, table, row, component, invoke_hook, ptr);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(world, table, component, row);
     flecs_defer_end(world, stage);
 error:
     return;
@@ -9673,7 +11939,8 @@ void ecs_modified_id(
     flecs_notify_on_set(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, NULL);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(
+        world, table, component, ECS_RECORD_TO_ROW(r->row));
     flecs_defer_end(world, stage);
 error:
     return;
@@ -9698,10 +11965,16 @@ void flecs_set_id_move(
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t dst = flecs_ensure(
         world, entity, component, r, flecs_uto(int32_t, size));
-    ecs_check(dst.ptr != NULL, ECS_INVALID_PARAMETER, NULL);
 
     const ecs_type_info_t *ti = dst.ti;
-    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_check(ti != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!dst.ptr) {
+        ecs_check(ti->soa != NULL, ECS_INVALID_PARAMETER, NULL);
+        flecs_set_soa_id(world, r, component, ptr, cmd_kind == EcsCmdSet);
+        flecs_defer_end(world, stage);
+        return;
+    }
 
     if (ti->hooks.on_replace) {
         flecs_invoke_replace_hook(
@@ -9715,7 +11988,8 @@ void flecs_set_id_move(
         flecs_type_info_ctor_move_dtor(dst.ptr, ptr, 1, ti);
     }
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     if (cmd_kind == EcsCmdSet) {
         ecs_table_t *table = r->table;
@@ -9770,6 +12044,12 @@ void ecs_set_id(
     flecs_component_ptr_t dst = flecs_ensure(world, entity, component, r, 
         flecs_uto(int32_t, size));
 
+    if (!dst.ptr) {
+        ecs_assert(dst.ti->soa != NULL, ECS_INTERNAL_ERROR, NULL);
+        flecs_set_soa_id(world, r, component, ptr, true);
+        goto done;
+    }
+
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[component]) {
             ecs_os_memcpy(dst.ptr, ptr, size);
@@ -12371,8 +14651,11 @@ void* ecs_field_w_size(
 
     int16_t column = it->columns[index];
     if (column >= 0) {
-        return ECS_ELEM(it->table->data.columns[column].data,
-            (ecs_size_t)size, it->offset);
+        ecs_column_t *c = &it->table->data.columns[column];
+        ecs_assert(!(c->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+            "field %d has struct-of-arrays storage, use ecs_field_member()",
+                index);
+        return ECS_ELEM(c->data, (ecs_size_t)size, it->offset);
     }
 
     return flecs_field_shared(it, size, index);
@@ -12397,6 +14680,10 @@ void* flecs_field_shared(
         it->real_world, it->ids[index]);
     const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
     int16_t column = tr->column;
+    ecs_assert(!(table->data.columns[column].flags & EcsColumnSoA), 
+        ECS_INVALID_OPERATION,
+        "field %d has struct-of-arrays storage, use ecs_field_member()",
+            index);
 
     return ECS_ELEM(table->data.columns[column].data,
         (ecs_size_t)size, ECS_RECORD_TO_ROW(r->row));
@@ -12481,6 +14768,78 @@ error:
     return NULL;
 }
 
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out)
+{
+    ecs_table_t *table = it->table;
+    int32_t column = it->columns[index], row = it->offset;
+    if (column < 0 || it->sources[index]) {
+        ecs_entity_t src = it->sources[index];
+        if (!src || !ecs_field_is_set(it, index)) {
+            return -1;
+        }
+
+        ecs_record_t *r = flecs_entities_get(it->real_world, src);
+        ecs_component_record_t *cr = flecs_components_get(
+            it->real_world, it->ids[index]);
+        ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (cr->flags & EcsIdSparse) {
+            return -1;
+        }
+
+        table = r->table;
+        const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+        ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+        column = tr->column;
+        row = ECS_RECORD_TO_ROW(r->row);
+    }
+
+    *table_out = table;
+    *row_out = row;
+    return column;
+}
+
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member)
+{
+    ecs_check(it->flags & EcsIterIsValid, ECS_INVALID_PARAMETER,
+        "operation invalid before calling next()");
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER,
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER,
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table;
+    int32_t row, column = flecs_field_column(it, index, &table, &row);
+    if (column < 0) {
+        return NULL;
+    }
+
+    ecs_column_t *c = &table->data.columns[column];
+    ecs_check(c->flags & EcsColumnSoA, ECS_INVALID_OPERATION,
+        "field %d does not have struct-of-arrays storage, use ecs_field()",
+            index);
+
+    const ecs_soa_layout_t *soa = c->ti->soa;
+    ecs_check(member >= 0 && member < soa->count, ECS_INVALID_PARAMETER,
+        "member index %d out of bounds for field %d", member, index);
+
+    const ecs_soa_member_t *m = &soa->members[member];
+    ecs_check(!size || flecs_uto(ecs_size_t, size) == m->size, 
+        ECS_INVALID_PARAMETER, "mismatching size for member %d of field %d",
+            member, index);
+
+    return ECS_OFFSET(c->data, m->offset * table->data.size + m->size * row);
+error:
+    return NULL;
+}
+
 bool ecs_field_is_readonly(
     const ecs_iter_t *it,
     int8_t index)
@@ -12633,6 +14992,34 @@ error:
     return 0;
 }
 
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table = it->table;
+    if (!table || !table->_->bs_count) {
+        return NULL;
+    }
+
+    if (!ecs_field_is_set(it, index) || !ecs_field_is_self(it, index)) {
+        return NULL;
+    }
+
+    ecs_bitset_t *bs = flecs_table_get_toggle(table, it->ids[index]);
+    if (!bs) {
+        return NULL;
+    }
+
+    return bs->data;
+error:
+    return NULL;
+}
+
 size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index)
@@ -12647,6 +15034,52 @@ error:
     return 0;
 }
 
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_size_t size = it->sizes[index];
+    if (!size || (it->row_fields & (1llu << index))) {
+        return 0;
+    }
+
+    int16_t column = it->columns[index];
+    if (!it->ptrs && column >= 0 && 
+        (it->table->data.columns[column].flags & EcsColumnSoA)) 
+    {
+        /* Member arrays don't start at the field pointer */
+        return 0;
+    }
+
+    void *ptr = ecs_field_w_size(it, (size_t)size, index);
+    if (!ptr) {
+        return 0;
+    }
+
+    const ecs_world_t *world = it->real_world;
+    ecs_size_t alignment = world->column_alignment;
+    const ecs_type_info_t *ti = ecs_get_type_info(world, it->ids[index]);
+    if (ti && ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+
+    /* Largest power of two that the address is a multiple of */
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t result = addr & (~addr + 1);
+    if (alignment && result > (uintptr_t)alignment) {
+        result = (uintptr_t)alignment;
+    }
+
+    return (ecs_size_t)result;
+error:
+    return 0;
+}
+
 bool ecs_iter_next(
     ecs_iter_t *iter)
 {
@@ -13213,6 +15646,203 @@ error:
     return (ecs_iter_t){ 0 };
 }
 
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking)
+{
+    ecs_check(chunking != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->min_count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_iter_t result = ecs_worker_iter(it, index, count);
+    if (chunking->disable) {
+        return result;
+    }
+
+    result.priv_.iter.worker.min_count = chunking->min_count;
+    result.priv_.iter.worker.chunk_size = chunking->chunk_size;
+    result.priv_.iter.worker.chunk = -1;
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+/* Get number of rows that worker slices must be a multiple of, so that the
+ * fields of each slice start at an address that has the column alignment. */
+static int32_t flecs_worker_row_granularity(
+    const ecs_iter_t *it)
+{
+    ecs_size_t alignment = it->real_world->column_alignment;
+    if (!alignment || !it->table) {
+        return 1;
+    }
+
+    int32_t result = 1;
+    int8_t i;
+    for (i = 0; i < it->field_count; i ++) {
+        ecs_size_t size = it->sizes[i];
+        if (!size) {
+            continue;
+        }
+
+        /* Largest power of two that the component size is a multiple of */
+        ecs_size_t size_align = size & -size;
+        if (size_align < alignment) {
+            int32_t rows = alignment / size_align;
+            if (rows > result) {
+                result = rows;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Number of bytes of the fields of a chunk when a chunking policy doesn't 
+ * specify a chunk size. 32KB fits in the L1 data cache of most CPUs, and in the
+ * L2 cache of all of them. */
+#ifndef FLECS_WORKER_CHUNK_BYTES
+#define FLECS_WORKER_CHUNK_BYTES (32 * 1024)
+#endif
+
+/* Get number of entities per chunk for a result */
+static int32_t flecs_worker_chunk_size(
+    const ecs_iter_t *it,
+    const ecs_worker_iter_t *iter,
+    int32_t count)
+{
+    int32_t result = iter->chunk_size;
+    if (!result) {
+        /* Don't make chunks larger than needed to give each worker a chunk */
+        result = (count + iter->count - 1) / iter->count;
+
+        ecs_size_t row_size = 0;
+        int8_t i;
+        for (i = 0; i < it->field_count; i ++) {
+            if (!it->sources[i]) {
+                row_size += it->sizes[i];
+            }
+        }
+
+        if (row_size) {
+            int32_t cache_rows = FLECS_WORKER_CHUNK_BYTES / row_size;
+            if (!cache_rows) {
+                cache_rows = 1;
+            }
+            if (cache_rows < result) {
+                result = cache_rows;
+            }
+        }
+    }
+
+    if (result < iter->min_count) {
+        result = iter->min_count;
+    }
+
+    int32_t granularity = flecs_worker_row_granularity(it);
+    if (granularity > 1) {
+        result = ((result + granularity - 1) / granularity) * granularity;
+    }
+
+    return result;
+}
+
+/* Get first row of a worker slice, rounded down to the row granularity. The
+ * row is relative to the start of the table. */
+static int32_t flecs_worker_slice_start(
+    int32_t offset,
+    int32_t count,
+    int32_t index,
+    int32_t worker_count,
+    int32_t granularity)
+{
+    if (index >= worker_count) {
+        return offset + count;
+    }
+
+    int32_t row = offset + (int32_t)(((int64_t)count * index) / worker_count);
+    row -= row % granularity;
+    if (row < offset) {
+        row = offset;
+    }
+
+    return row;
+}
+
+/* Progress worker iterator with chunking policy. Results are split up in
+ * chunks, which are assigned round robin to workers. The first chunk of a
+ * result is assigned to a worker derived from the table id, so that tables
+ * that are processed as a whole are spread out across workers. */
+static bool flecs_worker_chunk_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t res_count = iter->count, res_index = iter->index;
+
+    do {
+        if (iter->chunk == -1) {
+            if (!ecs_iter_next(chain_it)) {
+                return false;
+            }
+
+            if (!chain_it->count) {
+                if (chain_it->table) {
+                    continue;
+                }
+
+                ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+                if (res_index == 0) {
+                    return true;
+                } else {
+                    /* Chained iterator returned true, so clean it up */
+                    ecs_iter_fini(chain_it);
+                    return false;
+                }
+            }
+
+            int32_t start = 0;
+            if (chain_it->table) {
+                start = (int32_t)(chain_it->table->id % (uint64_t)res_count);
+            }
+
+            iter->chunk = (res_index - start + res_count) % res_count;
+        }
+
+        int32_t chunk_size = flecs_worker_chunk_size(
+            chain_it, iter, chain_it->count);
+        int32_t first = iter->chunk * chunk_size;
+        if (first >= chain_it->count) {
+            iter->chunk = -1;
+            continue;
+        }
+
+        int32_t count = chain_it->count - first;
+        if (count > chunk_size) {
+            count = chunk_size;
+        }
+
+        iter->chunk += res_count;
+
+        /* Copy everything up to the private iterator data */
+        ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+        it->frame_offset += first;
+        it->count = count;
+        it->offset += first;
+
+        if (it->table) {
+            it->entities = &(ecs_table_entities(it->table)[it->offset]);
+        } else {
+            it->entities = &it->entities[first];
+        }
+
+        return true;
+    } while (true);
+}
+
 bool ecs_worker_next(
     ecs_iter_t *it)
 {
@@ -13225,6 +15855,10 @@ bool ecs_worker_next(
     int32_t res_count = iter->count, res_index = iter->index;
     int32_t per_worker, first;
 
+    if (iter->min_count || iter->chunk_size) {
+        return flecs_worker_chunk_next(it);
+    }
+
     do {
         if (!ecs_iter_next(chain_it)) {
             return false;
@@ -13234,6 +15868,38 @@ bool ecs_worker_next(
         ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
 
         int32_t count = it->count;
+
+        /* When workers are pinned, keep small tables on a single worker so 
+         * the same core processes the table each frame. */
+        if (it->table && count && count < res_count && 
+            (it->real_world->flags & EcsWorldWorkerAffinity)) 
+        {
+            if ((int32_t)(it->table->id % (uint64_t)res_count) == res_index) {
+                per_worker = count;
+                first = 0;
+                break;
+            }
+
+            per_worker = 0;
+            continue;
+        }
+
+        /* When a column alignment is set, split the table at rows that keep
+         * the arrays of each worker aligned. */
+        int32_t granularity = flecs_worker_row_granularity(it);
+        if (granularity > 1) {
+            int32_t start = flecs_worker_slice_start(
+                it->offset, count, res_index, res_count, granularity);
+            int32_t end = flecs_worker_slice_start(
+                it->offset, count, res_index + 1, res_count, granularity);
+            first = start - it->offset;
+            per_worker = end - start;
+            if (!per_worker && it->table) {
+                continue;
+            }
+            break;
+        }
+
         per_worker = count / res_count;
         first = per_worker * res_index;
         count -= per_worker * res_count;
@@ -16564,6 +19230,24 @@ ecs_observer_t* flecs_observer_init(
         "observer must have at least one term");
 
     int i;
+    /* Components with struct-of-arrays storage can't be accessed with 
+     * ecs_field, which is what observer callbacks (and the C++ API) use. */
+    for (i = 0; i < query->term_count; i ++) {
+        ecs_term_t *term = &query->terms[i];
+        if (!term->id || term->inout == EcsInOutNone || 
+            ecs_id_is_wildcard(term->id)) 
+        {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, term->id);
+        ecs_check(!ti || !ti->soa, ECS_UNSUPPORTED,
+            "observer term for '%s' must have inout None: component has "
+            "struct-of-arrays storage", 
+                flecs_errstr(ecs_id_str(world, term->id)));
+        (void)ti;
+    }
+
 #ifdef FLECS_QUERY_PLANS
     int var_count = 0;
     for (i = 0; i < query->term_count; i ++) {
@@ -18223,6 +20907,31 @@ static char* ecs_os_api_module_to_etc(const char *module) {
     return ecs_strbuf_get(&lib);
 }
 
+/* Fallbacks for OS API implementations that don't provide atomic loads and
+ * stores. Volatile accesses are not ordered with other memory operations, so
+ * threaded implementations should override these. */
+static
+int32_t ecs_os_api_aload(
+    const int32_t *value)
+{
+    return *(const volatile int32_t*)value;
+}
+
+static
+void* ecs_os_api_aloadp(
+    void *const *value)
+{
+    return *(void *const volatile*)value;
+}
+
+static
+void ecs_os_api_astorep(
+    void **ptr,
+    void *value)
+{
+    *(void *volatile*)ptr = value;
+}
+
 void ecs_os_set_api_defaults(void)
 {
     /* Don't overwrite if already initialized */
@@ -18250,6 +20959,11 @@ void ecs_os_set_api_defaults(void)
     ecs_os_api.fclose_ = ecs_os_api_fclose;
     ecs_os_api.fread_ = ecs_os_api_fread;
 
+    /* Atomics */
+    ecs_os_api.aload_ = ecs_os_api_aload;
+    ecs_os_api.aloadp_ = ecs_os_api_aloadp;
+    ecs_os_api.astorep_ = ecs_os_api_astorep;
+
     /* Time */
     ecs_os_api.get_time_ = ecs_os_gettime;
 
@@ -18285,6 +20999,14 @@ bool ecs_os_has_heap(void) {
         (ecs_os_api.free_ != NULL);
 }
 
+bool ecs_os_has_virtual_memory(void) {
+    return
+        (ecs_os_api.reserve_ != NULL) &&
+        (ecs_os_api.commit_ != NULL) &&
+        (ecs_os_api.decommit_ != NULL) &&
+        (ecs_os_api.release_ != NULL);
+}
+
 bool ecs_os_has_threading(void) {
     return
         (ecs_os_api.mutex_new_ != NULL) &&
@@ -19150,6 +21872,9 @@ static void flecs_stage_merge(
             flecs_poly_assert(s, ecs_stage_t);
             flecs_defer_end(world, s);
         }
+
+        /* Merge commands enqueued by threads that don't own a stage */
+        flecs_async_merge(world);
     }
 
     if (measure_frame_time) {
@@ -19274,6 +21999,27 @@ ecs_stack_t* flecs_stage_get_stack_allocator(
     return &stage->allocators.iter_stack;
 }
 
+static void flecs_stack_first_touch(
+    ecs_stack_t *stack)
+{
+    /* Getting a cursor allocates the first page if the stack doesn't have one
+     * yet. Restoring the cursor keeps the page. */
+    flecs_stack_restore_cursor(stack, flecs_stack_get_cursor(stack));
+}
+
+void flecs_stage_first_touch(
+    ecs_stage_t *stage)
+{
+    flecs_poly_assert(stage, ecs_stage_t);
+
+    /* Stage allocators allocate lazily, so memory is placed on the NUMA node
+     * of the thread that first uses it. Make sure the pages that are used 
+     * every frame are owned by the thread calling this function. */
+    flecs_stack_first_touch(&stage->allocators.iter_stack);
+    flecs_stack_first_touch(&stage->cmd_stack[0].stack);
+    flecs_stack_first_touch(&stage->cmd_stack[1].stack);
+}
+
 ecs_world_t* ecs_stage_new(
     ecs_world_t *world)
 {
@@ -19561,8 +22307,8 @@ void ecs_stage_shrink(
 {
     flecs_sparse_shrink(&stage->cmd_stack[0].entries);
     flecs_sparse_shrink(&stage->cmd_stack[1].entries);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, ecs_cmd_t);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, ecs_cmd_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, uint8_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, uint8_t);
 }
 
 bool ecs_is_deferred(
@@ -20042,6 +22788,10 @@ void ecs_set_hooks_id(
     ecs_check(!ti->component || ti->component == component,
         ECS_INCONSISTENT_COMPONENT_ACTION, NULL);
 
+    ecs_check(!ti->soa || flecs_type_hooks_allow_soa(h), ECS_UNSUPPORTED,
+        "illegal call to set_hooks() for component '%s': component has "
+        "struct-of-arrays storage", flecs_errstr(ecs_get_path(world, component)));
+
     ecs_type_hooks_t prev_hooks = ti->hooks;
 
     if (!ti->size) {
@@ -20252,6 +23002,11 @@ static void flecs_type_info_fini(
         ecs_os_free(ECS_CONST_CAST(char*, ti->name));
         ti->name = NULL;
     }
+    if (ti->soa) {
+        ecs_os_free(ti->soa->members);
+        ecs_os_free(ti->soa);
+        ti->soa = NULL;
+    }
 
     ti->size = 0;
     ti->alignment = 0;
@@ -20425,6 +23180,33 @@ void flecs_type_info_release(
     }
 }
 
+/* Struct-of-arrays storage has no contiguous component values to pass to 
+ * lifecycle hooks or to the hooks that access values with ecs_field. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h)
+{
+    return (!h->ctor || h->ctor == flecs_default_ctor) && !h->dtor && 
+        !h->copy && !h->move && !h->copy_ctor && !h->move_ctor && 
+        !h->ctor_move_dtor && !h->move_dtor && !h->on_add && !h->on_set &&
+        !h->on_remove && !h->on_replace && !h->on_validate;
+}
+
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count)
+{
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ti->soa == NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(members != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_soa_layout_t *soa = ecs_os_calloc_t(ecs_soa_layout_t);
+    soa->members = ecs_os_memdup_n(members, ecs_soa_member_t, count);
+    soa->count = count;
+    ti->soa = soa;
+}
+
 ecs_size_t flecs_type_size(
     ecs_world_t *world, 
     ecs_entity_t type) 
@@ -20597,6 +23379,8 @@ const ecs_entity_t EcsPanic =                       FLECS_HI_COMPONENT_ID + 56;
 /* Storage */
 const ecs_entity_t EcsSparse =                      FLECS_HI_COMPONENT_ID + 57;
 const ecs_entity_t EcsDontFragment =                FLECS_HI_COMPONENT_ID + 58;
+const ecs_entity_t EcsCold =                        FLECS_HI_COMPONENT_ID + 125;
+const ecs_entity_t EcsStableOrder =                 FLECS_HI_COMPONENT_ID + 126;
 
 /* Misc */
 const ecs_entity_t EcsOrderedChildren =               FLECS_HI_COMPONENT_ID + 60;
@@ -20668,6 +23452,7 @@ const ecs_entity_t ecs_id(EcsUnitPrefix) =          FLECS_HI_COMPONENT_ID + 112;
 const ecs_entity_t EcsQuantity =                    FLECS_HI_COMPONENT_ID + 113;
 const ecs_entity_t ecs_id(EcsMap) =                 FLECS_HI_COMPONENT_ID + 122;
 const ecs_entity_t ecs_id(ecs_value_t) =          FLECS_HI_COMPONENT_ID + 123;
+const ecs_entity_t EcsSoA =                         FLECS_HI_COMPONENT_ID + 124;
 #endif
 
 const ecs_entity_t EcsConstant =                    FLECS_HI_COMPONENT_ID + 114;
@@ -20888,6 +23673,7 @@ static void flecs_init_store(
     ecs_vec_init_t(a, &world->store.records, ecs_table_record_t, 0);
     ecs_vec_init_t(a, &world->store.marked_ids, ecs_marked_id_t, 0);
     ecs_vec_init_t(a, &world->store.deleted_components, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &world->store.unordered_tables, uint64_t, 0);
 
     /* Initialize entity index */
     flecs_entities_init(world);
@@ -20898,6 +23684,9 @@ static void flecs_init_store(
 
     /* Initialize table map */
     flecs_table_hashmap_init(world, &world->store.table_map);
+
+    /* Initialize storage region for cold columns */
+    flecs_cold_storage_init(&world->store.cold);
 }
 
 static void flecs_clean_tables(
@@ -21063,6 +23852,9 @@ static void flecs_fini_store(ecs_world_t *world) {
     ecs_vec_fini_t(a, &world->store.records, ecs_table_record_t);
     ecs_vec_fini_t(a, &world->store.marked_ids, ecs_marked_id_t);
     ecs_vec_fini_t(a, &world->store.deleted_components, ecs_entity_t);
+    ecs_vec_fini_t(a, &world->store.unordered_tables, uint64_t);
+
+    flecs_cold_storage_fini(&world->store.cold);
 }
 
 static void flecs_world_allocators_init(
@@ -21428,6 +24220,8 @@ ecs_world_t *ecs_mini(void) {
     }
 
     ecs_map_init(&world->prefab_child_indices, a);
+    ecs_map_init(&world->double_buffered, a);
+    flecs_async_init(world);
 
     ecs_set_stage_count(world, 1);
     ecs_default_lookup_path[0] = EcsFlecsCore;
@@ -21657,6 +24451,7 @@ int ecs_fini(
     /* Purge deferred operations from the queue. This discards operations but
      * makes sure that any resources in the queue are freed */
     flecs_defer_purge(world, world->stages[0]);
+    flecs_async_fini(world);
     ecs_log_pop_1();
 
     /* Cleanup world ctx and binding_ctx */
@@ -21682,7 +24477,9 @@ int ecs_fini(
     flecs_name_index_fini(&world->aliases);
     flecs_name_index_fini(&world->symbols);
     ecs_set_stage_count(world, 0);
+    ecs_vec_fini_t(NULL, &world->worker_affinity, int32_t);
     ecs_map_fini(&world->prefab_child_indices);
+    ecs_map_fini(&world->double_buffered);
     flecs_multi_world_fini(world);
     ecs_log_pop_1();
 
@@ -21881,6 +24678,48 @@ void ecs_run_aperiodic(
     }
 }
 
+/* Estimate of the memory of a table that is returned to the OS allocator when 
+ * the table is shrunk or deleted. Used to report how many bytes were reclaimed
+ * by ecs_delete_empty_tables(). Graph edges, table records and the table 
+ * itself are freed to the allocators of the world, which keep the memory for
+ * new tables, so they are not counted. */
+static ecs_size_t flecs_table_reclaimable_bytes(
+    const ecs_table_t *table,
+    bool with_table)
+{
+    int32_t i, column_count = table->column_count;
+    ecs_size_t row_size = ECS_SIZEOF(ecs_entity_t);
+    for (i = 0; i < column_count; i ++) {
+        const ecs_column_t *column = &table->data.columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) == 
+            EcsColumnCold) 
+        {
+            /* Counted when the cold storage region releases pages */
+            continue;
+        }
+        row_size += column->ti->size;
+    }
+
+    ecs_size_t result = row_size * table->data.size;
+
+    if (with_table) {
+        int32_t type_count = table->type.count;
+        result += (type_count + column_count) * ECS_SIZEOF(int16_t);
+        if (table->component_map != flecs_table_empty_component_map) {
+            result += FLECS_HI_COMPONENT_ID * ECS_SIZEOF(int16_t);
+        }
+    }
+
+    return result;
+}
+
+static bool flecs_table_has_edges(
+    const ecs_table_t *table)
+{
+    const ecs_graph_node_t *node = &table->node;
+    return node->add.lo || node->remove.lo || node->add.hi || node->remove.hi;
+}
+
 int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc)
@@ -21897,7 +24736,9 @@ int32_t ecs_delete_empty_tables(
     uint16_t clear_generation = desc->clear_generation;
     uint16_t delete_generation = desc->delete_generation;
     double time_budget_seconds = desc->time_budget_seconds;
+    float shrink_ratio = desc->shrink_ratio;
     int32_t offset = desc->offset;
+    ecs_size_t cold_reserved = world->store.cold.bytes_reserved;
 
     if (ECS_NEQZERO(time_budget_seconds) || (ecs_should_log_1() && ecs_os_has_time())) {
         ecs_time_measure(&start);
@@ -21954,7 +24795,27 @@ int32_t ecs_delete_empty_tables(
             measure_budget_after = 100;
         }
 
-        if (!table->id || ecs_table_count(table) != 0) {
+        if (!table->id) {
+            i ++;
+            remaining --;
+            continue;
+        }
+
+        int32_t table_count = ecs_table_count(table);
+        if (table_count) {
+            /* Trim storage of tables that are mostly empty, for example after
+             * a large number of entities got deleted. */
+            if (ECS_NEQZERO(shrink_ratio) && 
+                ((float)table_count < shrink_ratio * (float)table->data.size))
+            {
+                ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+                flecs_table_shrink(world, table);
+                bytes -= flecs_table_reclaimable_bytes(table, false);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+                measure_budget_after = 1;
+            }
+
             i ++;
             remaining --;
             continue;
@@ -21962,12 +24823,22 @@ int32_t ecs_delete_empty_tables(
 
         uint16_t gen = ++ table->_->generation;
         if (delete_generation && (gen > delete_generation)) {
+            world->compaction_bytes += 
+                flecs_table_reclaimable_bytes(table, true);
+            world->compaction_count ++;
             flecs_table_fini(world, table);
             measure_budget_after = 1;
             remaining --;
             continue;
         } else if (clear_generation && (gen > clear_generation)) {
-            flecs_table_shrink(world, table);
+            ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+            if (bytes || flecs_table_has_edges(table)) {
+                /* Edges are recreated when the table is used again */
+                flecs_table_shrink(world, table);
+                flecs_table_clear_edges(world, table);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+            }
             measure_budget_after = 1;
         }
 
@@ -21975,12 +24846,65 @@ int32_t ecs_delete_empty_tables(
         remaining --;
     }
 
+    /* Pack cold columns at the start of the cold storage region, so that the
+     * pages at the end of the region are released. */
+    if (flecs_cold_storage_fragmented(&world->store.cold)) {
+        count = flecs_sparse_count(&world->store.tables);
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = flecs_sparse_get_dense_t(
+                &world->store.tables, ecs_table_t, i);
+            if (table->keep || !table->id) {
+                continue;
+            }
+            if (flecs_table_compact_cold(world, table)) {
+                world->compaction_count ++;
+            }
+        }
+    }
+
 done:
+    if (world->store.cold.bytes_reserved < cold_reserved) {
+        world->compaction_bytes += 
+            cold_reserved - world->store.cold.bytes_reserved;
+    }
+
     ecs_os_perf_trace_pop("flecs.delete_empty_tables");
 
     return result;
 }
 
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change table compaction while world is in readonly mode");
+
+    if (desc) {
+        ecs_check(desc->shrink_ratio >= 0 && desc->shrink_ratio <= 1, 
+            ECS_INVALID_PARAMETER, "shrink_ratio must be between 0 and 1");
+        world->compaction = *desc;
+        world->compaction_enabled = true;
+    } else {
+        ecs_os_zeromem(&world->compaction);
+        world->compaction_enabled = false;
+    }
+error:
+    return;
+}
+
+void flecs_table_compaction_run(
+    ecs_world_t *world)
+{
+    if (!world->compaction_enabled) {
+        return;
+    }
+
+    world->compaction.offset = 
+        ecs_delete_empty_tables(world, &world->compaction);
+}
+
 ecs_entities_t ecs_get_entities(
     const ecs_world_t *world)
 {
@@ -22081,6 +25005,54 @@ void ecs_shrink(
     }
 }
 
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(page_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column page size while world is in readonly mode");
+    world->column_page_size = page_size;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_page_size;
+error:
+    return 0;
+}
+
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(alignment >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER,
+        "column alignment must be a power of two");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column alignment while world is in readonly mode");
+    world->column_alignment = alignment;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_alignment;
+error:
+    return 0;
+}
+
 void ecs_exclusive_access_begin(
     ecs_world_t *world,
     const char *thread_name)
@@ -24228,6 +27200,14 @@ ecs_cpp_get_mut_t ecs_cpp_set(
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t dst = flecs_ensure(world, entity, id, r, 
         flecs_uto(int32_t, size));
+
+    if (!dst.ptr) {
+        /* Struct-of-arrays components can't be assigned in place, scatter the
+         * value to the member arrays instead. */
+        flecs_defer_end(world, stage);
+        ecs_set_id(world, entity, id, size, new_ptr);
+        return (ecs_cpp_get_mut_t){0};
+    }
     
     result.ptr = dst.ptr;
     result.world = world;
@@ -24280,6 +27260,14 @@ ecs_cpp_get_mut_t ecs_cpp_assign(
     flecs_component_ptr_t dst = flecs_get_mut(world, entity, id, r, 
         flecs_uto(int32_t, size));
 
+    if (!dst.ptr && dst.ti && dst.ti->soa) {
+        /* Struct-of-arrays components can't be assigned in place, scatter the
+         * value to the member arrays instead. */
+        flecs_defer_end(world, stage);
+        ecs_set_id(world, entity, id, size, new_ptr);
+        return (ecs_cpp_get_mut_t){0};
+    }
+
     ecs_assert(dst.ptr != NULL, ECS_INVALID_OPERATION, 
         "entity does not have component, use set() instead");
         
@@ -24469,6 +27457,9 @@ ecs_ftime_t ecs_frame_begin(
     world->on_commands_ctx_active = world->on_commands_ctx;
     world->on_commands_ctx = NULL;
 
+    /* Merge commands enqueued by threads that don't own a stage */
+    flecs_async_merge(world);
+
     ecs_run_aperiodic(world, 0);
 
     world->flags |= EcsWorldFrameInProgress;
@@ -24494,6 +27485,8 @@ void ecs_frame_end(
         flecs_stage_merge_post_frame(world, world->stages[i]);
     }
 
+    flecs_table_compaction_run(world);
+
     flecs_stop_measure_frame(world);
 
     /* Reset command handler each frame */
@@ -28279,6 +31272,10 @@ static void flecs_system_stats_to_json(
     }
 
     ECS_COUNTER_APPEND_T(reply, stats, time_spent, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_enqueued, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_discarded, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_coalesced, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, command_time, stats->query.t, "");
     ecs_strbuf_list_pop(reply, "}");
 }
 
@@ -28295,8 +31292,21 @@ static void flecs_sync_stats_to_json(
     ecs_strbuf_list_appendlit(&reply->body, "\"immediate\":");
     ecs_strbuf_appendbool(&reply->body, stats->immediate);
 
+    ecs_strbuf_list_appendlit(&reply->body, "\"worker_count\":");
+    ecs_strbuf_appendint(&reply->body, stats->worker_count);
+
     ECS_GAUGE_APPEND_T(&reply->body, stats, time_spent, pstats->t, "");
     ECS_GAUGE_APPEND_T(&reply->body, stats, commands_enqueued, pstats->t, "");
+    ECS_GAUGE_APPEND_T(&reply->body, stats, wait_time, pstats->t, "");
+
+    ecs_strbuf_list_appendlit(&reply->body, "\"wait_histogram\":");
+    ecs_strbuf_list_push(&reply->body, "[", ",");
+    int32_t i;
+    for (i = 0; i < FLECS_SYNC_WAIT_BUCKETS; i ++) {
+        ecs_strbuf_list_next(&reply->body);
+        ecs_strbuf_appendint(&reply->body, stats->wait_histogram[i]);
+    }
+    ecs_strbuf_list_pop(&reply->body, "]");
 
     ecs_strbuf_list_pop(&reply->body, "}");
 }
@@ -29156,15 +32166,16 @@ static void flecs_rest_on_commands(
         ecs_rest_cmd_sync_capture_t *sync = ecs_vec_append_t(
             NULL, &capture->syncs, ecs_rest_cmd_sync_capture_t);
 
-        int32_t i, count = ecs_vec_count(commands);
-        ecs_cmd_t *cmds = ecs_vec_first(commands);
+        int32_t cur, end = ecs_vec_count(commands);
+        ecs_cmd_t *cmd;
         sync->buf = ECS_STRBUF_INIT;
         ecs_strbuf_list_push(&sync->buf, "{", ",");
         ecs_strbuf_list_appendlit(&sync->buf, "\"commands\":");
             ecs_strbuf_list_push(&sync->buf, "[", ",");
-            for (i = 0; i < count; i ++) {
+            for (cur = 0; cur < end; cur += cmd->length) {
+                cmd = flecs_cmd_at(commands, cur);
                 ecs_strbuf_list_next(&sync->buf);
-                flecs_rest_cmd_to_json(world, &sync->buf, &cmds[i]);
+                flecs_rest_cmd_to_json(world, &sync->buf, cmd);
             }
             ecs_strbuf_list_pop(&sync->buf, "]");
 
@@ -29538,31 +32549,6 @@ void FlecsRestImport(
 
 #endif
 
-#ifndef FLECS_SYSTEM_PRIVATE_H
-#define FLECS_SYSTEM_PRIVATE_H
-
-#ifdef FLECS_SYSTEM
-
-#define ecs_system_t_magic     (0x65637383)
-#define ecs_system_t_tag       EcsSystem
-
-extern ecs_mixins_t ecs_system_t_mixins;
-
-/* Internal function to run a system */
-ecs_entity_t flecs_run_system(
-    ecs_world_t *world,
-    ecs_stage_t *stage,
-    ecs_entity_t system,
-    ecs_system_t *system_data,
-    int32_t stage_current,
-    int32_t stage_count,
-    ecs_ftime_t delta_time,
-    void *param);
-
-#endif
-
-#endif
-
 #ifdef FLECS_TIMER
 
 static void ProgressTimers(ecs_iter_t *it) {
@@ -31135,6 +34121,64 @@ error:
     return;
 }
 
+/* Read 64 bits starting at an arbitrary bit offset. Bits past the allocated
+ * words are read as zero. */
+static uint64_t flecs_bitset_read_word(
+    const ecs_bitset_t *bs,
+    int32_t word_count,
+    int32_t elem)
+{
+    int32_t hi = elem >> 6, lo = elem & 0x3F;
+    if (hi >= word_count) {
+        return 0;
+    }
+
+    uint64_t result = bs->data[hi] >> lo;
+    if (lo && ((hi + 1) < word_count)) {
+        result |= bs->data[hi + 1] << (64 - lo);
+    }
+
+    return result;
+}
+
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count)
+{
+    ecs_check(elem >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check((elem + count) <= bs->count, ECS_INVALID_PARAMETER, NULL);
+    if (!count) {
+        return;
+    }
+
+    int32_t word_count = bs->size / 64;
+    int32_t last = bs->count - count;
+    int32_t first_word = elem >> 6, last_word = (bs->count - 1) >> 6;
+
+    /* Shift words down. Source bits are always at or after the destination,
+     * so words can be written in increasing order. */
+    uint64_t keep = ((uint64_t)1 << (elem & 0x3F)) - 1;
+    int32_t w;
+    for (w = first_word; w <= last_word; w ++) {
+        uint64_t v = flecs_bitset_read_word(bs, word_count, w * 64 + count);
+        bs->data[w] = (bs->data[w] & keep) | (v & ~keep);
+        keep = 0;
+    }
+
+    /* Clear bits that were shifted out of the range */
+    w = last >> 6;
+    bs->data[w] &= ((uint64_t)1 << (last & 0x3F)) - 1;
+    for (w ++; w <= last_word; w ++) {
+        bs->data[w] = 0;
+    }
+
+    bs->count = last;
+error:
+    return;
+}
+
 void flecs_bitset_swap(
     ecs_bitset_t *bs,
     int32_t elem_a,
@@ -34492,7 +37536,7 @@ static int flecs_query_set_caching_policy(
 #endif
     bool require_caching = desc->group_by || desc->group_by_callback || 
             desc->order_by || desc->order_by_callback || 
-            (desc->flags & EcsQueryDetectChanges);
+            (desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges));
 
     /* If the query has a Cascade term it'll use group_by */
     int32_t i, term_count = impl->pub.term_count;
@@ -34514,13 +37558,16 @@ static int flecs_query_set_caching_policy(
     /* If caching policy is default, try to pick a policy that does the right
      * thing in most cases. */
     if (kind == EcsQueryCacheDefault) {
-        if (desc->entity || require_caching) {
+        if (desc->entity || require_caching || 
+            (desc->flags & EcsQueryPrefetch)) 
+        {
             /* If the query is created with an entity handle (typically 
              * indicating that the query is named or belongs to a system) the
              * chance is very high that the query will be reused, so enable
              * caching. 
              * Additionally, if the query uses features that require a cache
-             * such as group_by/order_by, also enable caching. */
+             * such as group_by/order_by, or that only apply to cached queries
+             * such as prefetching, also enable caching. */
             kind = EcsQueryCacheAuto;
         } else {
             /* Be conservative in other scenarios, as caching adds significant
@@ -35013,6 +38060,68 @@ ecs_query_count_t ecs_query_count(
     return result;
 }
 
+/* Estimate the number of entities matched by a query without evaluating it. 
+ * For cached queries this is the number of entities in the cached tables. For
+ * uncached queries it is the number of entities in the tables with the first
+ * component that the query matches on $this, which is an upper bound. */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q)
+{
+    flecs_poly_assert(q, ecs_query_t);
+
+#ifdef FLECS_CACHED_QUERIES
+    ecs_query_impl_t *impl = flecs_query_impl(q);
+    if (impl->cache) {
+        return flecs_query_cache_entity_count(impl->cache);
+    }
+#endif
+
+    ecs_flags32_t skip = EcsTableIsPrefab|EcsTableIsDisabled;
+    if (q->flags & EcsQueryMatchPrefab) {
+        skip &= ~(ecs_flags32_t)EcsTableIsPrefab;
+    }
+    if (q->flags & EcsQueryMatchDisabled) {
+        skip &= ~(ecs_flags32_t)EcsTableIsDisabled;
+    }
+
+    int32_t i;
+    for (i = 0; i < q->term_count; i ++) {
+        const ecs_term_t *term = &q->terms[i];
+        if (term->oper != EcsAnd || !ecs_term_match_this(term)) {
+            continue;
+        }
+        if (term->src.id & EcsUp) {
+            continue;
+        }
+        if (term->flags_ & (EcsTermIsSparse|EcsTermDontFragment|
+            EcsTermIsMember|EcsTermNonFragmentingChildOf)) 
+        {
+            continue;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(q->world, term->id);
+        if (!cr) {
+            return 0;
+        }
+
+        int32_t result = 0;
+        ecs_table_cache_iter_t it;
+        if (flecs_table_cache_queryable_iter(&cr->cache, &it, EcsTableNotEmpty)) {
+            const ecs_table_cache_elem_t *elem;
+            while ((elem = flecs_table_cache_next(&it))) {
+                const ecs_table_t *table = elem->table;
+                if (!(table->flags & skip)) {
+                    result += ecs_table_count(table);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    return ecs_query_count(q).entities;
+}
+
 bool ecs_query_is_true(
     const ecs_query_t *q)
 {
@@ -37979,7 +41088,7 @@ int flecs_query_finalize_query(
         "ecs_query_desc_t was not initialized to zero");
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
-    if ((desc->flags & EcsQueryDetectChanges) &&
+    if ((desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges)) &&
         (desc->order_by || desc->order_by_callback))
     {
         ecs_query_validator_ctx_t ctx = {0};
@@ -38099,6 +41208,368 @@ error:
     return -1;
 }
 
+struct ecs_cold_page_t {
+    ecs_cold_page_t *next;
+    ecs_cold_page_t *prev;
+    int32_t index;                   /* Order of page in region */
+    ecs_size_t size;                 /* Size of block area of page */
+};
+
+struct ecs_cold_block_t {
+    ecs_cold_page_t *page;
+    ecs_cold_block_t *next_free;     /* Free list (free blocks only) */
+    ecs_cold_block_t *prev_free;
+    ecs_size_t size;                 /* Size of block including header */
+    ecs_size_t prev_size;            /* Size of previous block, 0 if first */
+    bool used;
+};
+
+#define FLECS_COLD_PAGE_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_page_t), FLECS_COLD_ALIGNMENT)
+#define FLECS_COLD_BLOCK_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_block_t), FLECS_COLD_ALIGNMENT)
+
+/* Blocks aren't split if the remainder would be smaller than this */
+#define FLECS_COLD_BLOCK_MIN \
+    (FLECS_COLD_BLOCK_HEADER + FLECS_COLD_ALIGNMENT)
+
+static
+ecs_cold_block_t* flecs_cold_block_of(
+    const void *ptr)
+{
+    return ECS_CAST(ecs_cold_block_t*,
+        ECS_CAST(char*, ECS_CONST_CAST(void*, ptr)) - FLECS_COLD_BLOCK_HEADER);
+}
+
+static
+ecs_size_t flecs_cold_block_size(
+    ecs_size_t size)
+{
+    ecs_assert(size > 0, ECS_INTERNAL_ERROR, NULL);
+    return FLECS_COLD_BLOCK_HEADER + ECS_ALIGN(size, FLECS_COLD_ALIGNMENT);
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_next(
+    const ecs_cold_block_t *block)
+{
+    const ecs_cold_page_t *page = block->page;
+    const char *end = ECS_CAST(const char*, page) +
+        FLECS_COLD_PAGE_HEADER + page->size;
+    const char *next = ECS_CAST(const char*, block) + block->size;
+    if (next >= end) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*, next));
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_prev(
+    const ecs_cold_block_t *block)
+{
+    if (!block->prev_size) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*,
+        ECS_CAST(const char*, block) - block->prev_size));
+}
+
+/* Update back reference of the block that follows block */
+static
+void flecs_cold_block_link_next(
+    ecs_cold_block_t *block)
+{
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next) {
+        next->prev_size = block->size;
+    }
+}
+
+/* Returns whether block a is stored at a lower address in the region than b */
+static
+bool flecs_cold_block_before(
+    const ecs_cold_block_t *a,
+    const ecs_cold_block_t *b)
+{
+    if (a->page != b->page) {
+        return a->page->index < b->page->index;
+    }
+    return a < b;
+}
+
+static
+void flecs_cold_free_list_insert(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    block->prev_free = NULL;
+    block->next_free = storage->free_list;
+    if (storage->free_list) {
+        storage->free_list->prev_free = block;
+    }
+    storage->free_list = block;
+}
+
+static
+void flecs_cold_free_list_remove(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        ecs_assert(storage->free_list == block, ECS_INTERNAL_ERROR, NULL);
+        storage->free_list = block->next_free;
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+}
+
+static
+ecs_cold_block_t* flecs_cold_page_new(
+    ecs_cold_storage_t *storage,
+    ecs_size_t block_size)
+{
+    ecs_size_t size = FLECS_COLD_PAGE_SIZE - FLECS_COLD_PAGE_HEADER;
+    if (block_size > size) {
+        size = block_size;
+    }
+
+    ecs_cold_page_t *page = ecs_os_malloc(FLECS_COLD_PAGE_HEADER + size);
+    if (!page) {
+        return NULL;
+    }
+
+    page->index = storage->page_index ++;
+    page->size = size;
+    page->next = NULL;
+    page->prev = storage->last;
+    if (storage->last) {
+        storage->last->next = page;
+    } else {
+        storage->first = page;
+    }
+    storage->last = page;
+    storage->bytes_reserved += FLECS_COLD_PAGE_HEADER + size;
+
+    ecs_cold_block_t *block = ECS_OFFSET(page, FLECS_COLD_PAGE_HEADER);
+    block->page = page;
+    block->size = size;
+    block->prev_size = 0;
+    block->used = false;
+    flecs_cold_free_list_insert(storage, block);
+    return block;
+}
+
+static
+void flecs_cold_page_free(
+    ecs_cold_storage_t *storage,
+    ecs_cold_page_t *page)
+{
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        storage->first = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    } else {
+        storage->last = page->prev;
+    }
+
+    storage->bytes_reserved -= FLECS_COLD_PAGE_HEADER + page->size;
+    ecs_os_free(page);
+}
+
+/* Return unused block to the region. The block is merged with adjacent free
+ * blocks, and the page is freed if the block covers the entire page. */
+static
+void flecs_cold_block_release(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    ecs_assert(!block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next && !next->used) {
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_block_t *prev = flecs_cold_block_prev(block);
+    if (prev && !prev->used) {
+        flecs_cold_free_list_remove(storage, prev);
+        prev->size += block->size;
+        block = prev;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_page_t *page = block->page;
+    if (block->size == page->size) {
+        flecs_cold_page_free(storage, page);
+    } else {
+        flecs_cold_free_list_insert(storage, block);
+    }
+}
+
+/* Split off the part of a used block that is not needed to store size bytes */
+static
+void flecs_cold_block_trim(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block,
+    ecs_size_t block_size)
+{
+    ecs_size_t remainder = block->size - block_size;
+    if (remainder < FLECS_COLD_BLOCK_MIN) {
+        return;
+    }
+
+    block->size = block_size;
+    storage->bytes_used -= remainder;
+
+    ecs_cold_block_t *rest = ECS_OFFSET(block, block_size);
+    rest->page = block->page;
+    rest->size = remainder;
+    rest->prev_size = block_size;
+    rest->used = false;
+    flecs_cold_block_link_next(rest);
+    flecs_cold_block_release(storage, rest);
+}
+
+static
+void* flecs_cold_alloc_intern(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const ecs_cold_block_t *limit)
+{
+    ecs_size_t block_size = flecs_cold_block_size(size);
+
+    /* Find the free block with the lowest address that fits */
+    ecs_cold_block_t *cur, *block = NULL;
+    for (cur = storage->free_list; cur; cur = cur->next_free) {
+        if (cur->size < block_size) {
+            continue;
+        }
+        if (limit && !flecs_cold_block_before(cur, limit)) {
+            continue;
+        }
+        if (!block || flecs_cold_block_before(cur, block)) {
+            block = cur;
+        }
+    }
+
+    if (!block) {
+        if (limit) {
+            return NULL;
+        }
+
+        block = flecs_cold_page_new(storage, block_size);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    flecs_cold_free_list_remove(storage, block);
+    block->used = true;
+    storage->bytes_used += block->size;
+    flecs_cold_block_trim(storage, block, block_size);
+
+    return ECS_OFFSET(block, FLECS_COLD_BLOCK_HEADER);
+}
+
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage)
+{
+    ecs_os_zeromem(storage);
+}
+
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage)
+{
+    ecs_assert(storage->bytes_used == 0, ECS_INTERNAL_ERROR,
+        "cold storage region still has blocks in use");
+
+    ecs_cold_page_t *page = storage->first;
+    while (page) {
+        ecs_cold_page_t *next = page->next;
+        ecs_os_free(page);
+        page = next;
+    }
+
+    ecs_os_zeromem(storage);
+}
+
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size)
+{
+    return flecs_cold_alloc_intern(storage, size, NULL);
+}
+
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+    return flecs_cold_alloc_intern(storage, size, flecs_cold_block_of(ptr));
+}
+
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+    block->used = false;
+    storage->bytes_used -= block->size;
+    flecs_cold_block_release(storage, block);
+}
+
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_size_t block_size = flecs_cold_block_size(size);
+    if (block_size > block->size) {
+        ecs_cold_block_t *next = flecs_cold_block_next(block);
+        if (!next || next->used ||
+            ((block->size + next->size) < block_size))
+        {
+            return false;
+        }
+
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        storage->bytes_used += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    flecs_cold_block_trim(storage, block, block_size);
+    return true;
+}
+
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage)
+{
+    return (storage->bytes_reserved - storage->bytes_used) >=
+        FLECS_COLD_PAGE_SIZE;
+}
+
 static ecs_id_record_elem_t* flecs_component_elem(
     ecs_component_record_t *head,
     ecs_id_record_elem_t *list,
@@ -38406,6 +41877,7 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             /* Target determines the type, so unset storage flags */
             result &= ~EcsIdSparse;
             result &= ~EcsIdDontFragment;
+            result &= ~EcsIdCold;
 
             if (ecs_owns_id(world, tgt, EcsSparse)) {
                 result |= EcsIdSparse;
@@ -38414,6 +41886,10 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             if (ecs_owns_id(world, tgt, EcsDontFragment)) {
                 result |= EcsIdDontFragment;
             }
+
+            if (ecs_owns_id(world, tgt, EcsCold)) {
+                result |= EcsIdCold;
+            }
         }
     } else {
         /* Disable flags that only apply to pairs */
@@ -41058,6 +44534,9 @@ static void flecs_table_init_columns(
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, -(i + 1));
         }
+        if (table->_->records[i].hdr.cr->flags & EcsIdStableOrder) {
+            table->_->stable_order = true;
+        }
     }
 
     if (!column_count) {
@@ -41089,6 +44568,12 @@ static void flecs_table_init_columns(
         flecs_table_cache_set_column(&cr->cache, table, tr->column);
 
         columns[cur].ti = ECS_CONST_CAST(ecs_type_info_t*, ti);
+        if (ti->soa) {
+            columns[cur].flags = EcsColumnSoA;
+        }
+        if (cr->flags & EcsIdCold) {
+            columns[cur].flags |= EcsColumnCold;
+        }
         
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, cur + 1);
@@ -41240,6 +44725,10 @@ static void flecs_table_init_flags(
             table->trait_flags |= EcsIdSparse;
         } else if (id == EcsDontFragment) {
             table->trait_flags |= EcsIdDontFragment;
+        } else if (id == EcsCold) {
+            table->trait_flags |= EcsIdCold;
+        } else if (id == EcsStableOrder) {
+            table->trait_flags |= EcsIdStableOrder;
         } else if (id ==  EcsExclusive) {
             table->trait_flags |= EcsIdExclusive;   
         } else if (id == EcsTraversable) {
@@ -41372,6 +44861,60 @@ static void flecs_table_init_overrides(
     table->data.overrides = o;
 }
 
+/* Make sure there is a version stamp for each chunk of rows in the storage of
+ * the table. Stamps are only resized here, on the thread that owns the table
+ * storage, so that workers can mark rows dirty without allocating. */
+static void flecs_table_dirty_chunks_set_size(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t chunk_count = (table->data.size + FLECS_TABLE_DIRTY_CHUNK - 1) 
+        >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_set_min_count_zeromem_t(
+            &world->allocator, &chunks[i], int32_t, chunk_count);
+    }
+}
+
+/* Free row change tracking data */
+static void flecs_table_fini_dirty_chunks(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_fini_t(&world->allocator, &chunks[i], int32_t);
+    }
+
+    flecs_free_n(&world->allocator, ecs_vec_t, count, chunks);
+    table->_->dirty_chunks = NULL;
+}
+
+static void flecs_table_fini_row_order(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
+
+    ecs_vec_fini_t(&world->allocator, &row_order->keys, int32_t);
+    flecs_free_t(&world->allocator, ecs_table_row_order_t, row_order);
+    table->_->row_order = NULL;
+}
+
 static void flecs_table_fini_overrides(
     ecs_world_t *world, 
     ecs_table_t *table)
@@ -41871,6 +45414,67 @@ static void flecs_table_invoke_hook(
         table->type.array[type_index], column->ti, event, callback, NULL);
 }
 
+/* Zero initialize rows of a column with struct-of-arrays storage. The only 
+ * constructor that struct-of-arrays components can have is the default ctor. */
+static void flecs_table_column_soa_zero(
+    void *data,
+    int32_t capacity,
+    int32_t row,
+    int32_t count,
+    const ecs_soa_layout_t *soa)
+{
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &soa->members[i];
+        ecs_os_memset(ECS_OFFSET(data, m->offset * capacity + m->size * row),
+            0, m->size * count);
+    }
+}
+
+/* Copy value of inherited struct-of-arrays component into overriding rows. 
+ * Members of the base are gathered into a temporary value, which is then 
+ * scattered into the member arrays of the instances. */
+static void flecs_table_soa_override(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_entity_t base,
+    ecs_id_t id,
+    int32_t row,
+    int32_t count,
+    const ecs_type_info_t *ti)
+{
+    ecs_record_t *r = flecs_entities_get(world, base);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_table_t *base_table = r->table;
+    ecs_assert(base_table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, base_table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tr->column != -1, ECS_INTERNAL_ERROR, NULL);
+
+    void *value = ecs_os_alloca(ti->size);
+    flecs_table_soa_get(
+        base_table, tr->column, ECS_RECORD_TO_ROW(r->row), value);
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        flecs_table_soa_set(table, column_index, row + i, value);
+    }
+
+    ecs_iter_action_t on_set = ti->hooks.on_set;
+    if (on_set) {
+        int32_t record_index = table->column_map[table->type.count + column_index];
+        const ecs_table_record_t *dst_tr = &table->_->records[record_index];
+        const ecs_entity_t *entities = &ecs_table_entities(table)[row];
+        flecs_invoke_hook(world, table, dst_tr->hdr.cr, dst_tr->column,
+            count, row, entities, ti->component, ti, EcsOnSet,
+            on_set, NULL);
+    }
+}
+
 static void flecs_table_invoke_ctor_for_array(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -41888,6 +45492,12 @@ static void flecs_table_invoke_ctor_for_array(
             if (r->entity) {
                 ecs_id_t id = table->type.array[
                     table->column_map[table->type.count + column_index]];
+                if (ti->soa) {
+                    flecs_table_soa_override(world, table, column_index, 
+                        r->entity, id, row, count, ti);
+                    return;
+                }
+
                 void *base_ptr = ecs_ref_get_id(world, r, id);
                 ecs_assert(base_ptr != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -41917,6 +45527,15 @@ static void flecs_table_invoke_ctor_for_array(
         }
     }
 
+    if (ti->soa) {
+        ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (ti->hooks.ctor) {
+            flecs_table_column_soa_zero(
+                array, table->data.size, row, count, ti->soa);
+        }
+        return;
+    }
+
     flecs_type_info_ctor(ptr, count, ti);
 }
 
@@ -42078,6 +45697,431 @@ static void flecs_table_dtor_all(
 #define FLECS_LOCKED_STORAGE_MSG(operation) \
     "a " #operation " operation failed because the table is locked, fix by surrounding the operation with defer_begin()/defer_end()"
 
+/* Alignment of memory returned by the OS API malloc function */
+#define FLECS_COLUMN_HEAP_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+/* Columns that require a larger alignment than what malloc provides and paged
+ * columns store a header just before the column data. */
+typedef struct ecs_column_header_t {
+    void *base;                      /* Start of allocation or reserved range */
+    ecs_size_t reserved;             /* Reserved bytes (paged columns only) */
+    ecs_size_t committed;            /* Committed bytes (paged columns only) */
+} ecs_column_header_t;
+
+static
+ecs_column_header_t* flecs_table_column_header(
+    const ecs_column_t *column)
+{
+    ecs_assert(column->flags & (EcsColumnPaged|EcsColumnAligned), 
+        ECS_INTERNAL_ERROR, NULL);
+    return ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, column->data) - ECS_SIZEOF(ecs_column_header_t));
+}
+
+/* Get alignment for column storage of component */
+static
+ecs_size_t flecs_table_column_alignment(
+    const ecs_world_t *world,
+    const ecs_type_info_t *ti)
+{
+    ecs_size_t alignment = world->column_alignment;
+    if (ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+    return alignment;
+}
+
+/* Allocate column storage with an alignment that is larger than what malloc
+ * guarantees. */
+static
+void* flecs_table_column_alloc_aligned(
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t header = ECS_SIZEOF(ecs_column_header_t);
+    void *base = ecs_os_malloc(size + header + alignment);
+    if (!base) {
+        return NULL;
+    }
+
+    uintptr_t addr = (uintptr_t)base + (uintptr_t)header;
+    addr = (addr + (uintptr_t)alignment - 1) & ~((uintptr_t)alignment - 1);
+
+    void *result = (void*)addr;
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - header);
+    hdr->base = base;
+    hdr->reserved = 0;
+    hdr->committed = 0;
+    return result;
+}
+
+/* Paged columns reserve a range of address space up front, and commit memory
+ * to the range as the table grows. This keeps column data contiguous, while
+ * ensuring that growing a large column never has to move its elements. Column
+ * data starts at least one cache line after the start of the range. */
+static
+ecs_size_t flecs_table_column_pages_offset(
+    ecs_size_t alignment)
+{
+    return alignment > 64 ? alignment : 64;
+}
+
+/* Round number of bytes to commit up to the column page size */
+static
+ecs_size_t flecs_table_column_pages_round(
+    const ecs_world_t *world,
+    int64_t bytes,
+    ecs_size_t reserved)
+{
+    int64_t page_size = world->column_page_size;
+    if (page_size > 0) {
+        bytes = ((bytes + page_size - 1) / page_size) * page_size;
+    }
+    if (bytes > reserved) {
+        bytes = reserved;
+    }
+    return (ecs_size_t)bytes;
+}
+
+/* Reserve address range for paged column that can hold at least size bytes */
+static
+void* flecs_table_column_reserve(
+    ecs_world_t *world,
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t offset = flecs_table_column_pages_offset(alignment);
+    int64_t needed = (int64_t)size + offset;
+    int64_t reserve = FLECS_COLUMN_RESERVE_SIZE;
+    while (reserve < (needed * 2)) {
+        reserve *= 2;
+    }
+    if (reserve > INT32_MAX) {
+        reserve = INT32_MAX;
+    }
+    if (needed > reserve) {
+        return NULL;
+    }
+
+    void *base = ecs_os_reserve((ecs_size_t)reserve);
+    if (!base) {
+        return NULL;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, (ecs_size_t)reserve);
+    if (!ecs_os_commit(base, commit)) {
+        ecs_os_release(base, (ecs_size_t)reserve);
+        return NULL;
+    }
+
+    void *result = ECS_OFFSET(base, offset);
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - ECS_SIZEOF(ecs_column_header_t));
+    hdr->base = base;
+    hdr->reserved = (ecs_size_t)reserve;
+    hdr->committed = commit;
+    return result;
+}
+
+/* Commit or decommit memory so a paged column can hold size bytes. Returns 
+ * false if the reserved range is too small, or if memory could not be 
+ * committed. In that case the caller must move the column. */
+static
+bool flecs_table_column_commit(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    ecs_size_t size)
+{
+    ecs_column_header_t *hdr = flecs_table_column_header(column);
+    int64_t offset = ECS_CAST(char*, column->data) - ECS_CAST(char*, hdr->base);
+    int64_t needed = (int64_t)size + offset;
+    if (needed > hdr->reserved) {
+        return false;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, hdr->reserved);
+    if (commit > hdr->committed) {
+        if (!ecs_os_commit(ECS_OFFSET(hdr->base, hdr->committed), 
+            commit - hdr->committed)) 
+        {
+            return false;
+        }
+    } else if (commit < hdr->committed) {
+        ecs_os_decommit(ECS_OFFSET(hdr->base, commit), 
+            hdr->committed - commit);
+    }
+
+    hdr->committed = commit;
+    return true;
+}
+
+/* Free column storage */
+static
+void flecs_table_column_fini(
+    ecs_world_t *world,
+    ecs_column_t *column)
+{
+    if (column->flags & EcsColumnPaged) {
+        ecs_column_header_t *hdr = flecs_table_column_header(column);
+        ecs_os_release(hdr->base, hdr->reserved);
+    } else if (column->flags & EcsColumnAligned) {
+        if (column->data) {
+            ecs_os_free(flecs_table_column_header(column)->base);
+        }
+    } else if (column->flags & EcsColumnCold) {
+        flecs_cold_free(&world->store.cold, column->data);
+    } else if (column->data) {
+        ecs_os_free(column->data);
+    }
+
+    column->data = NULL;
+    column->flags &= ~EcsColumnStorageMask;
+}
+
+/* Move the member arrays of a column with struct-of-arrays storage to the 
+ * layout for a different capacity. Source and destination may be the same 
+ * storage, in which case members are moved in an order that ensures that no
+ * member array overwrites another member array that hasn't been moved yet. */
+static
+void flecs_table_column_soa_relayout(
+    const ecs_soa_layout_t *soa,
+    void *dst,
+    int32_t dst_capacity,
+    const void *src,
+    int32_t src_capacity,
+    int32_t count)
+{
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+
+    if (dst_capacity > src_capacity) {
+        for (i = member_count - 1; i >= 0; i --) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    } else {
+        for (i = 0; i < member_count; i ++) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    }
+}
+
+/* Copy rows between (or within) columns with struct-of-arrays storage */
+static
+void flecs_table_column_soa_copy(
+    ecs_column_t *dst,
+    int32_t dst_capacity,
+    int32_t dst_row,
+    const ecs_column_t *src,
+    int32_t src_capacity,
+    int32_t src_row,
+    int32_t count)
+{
+    const ecs_soa_layout_t *soa = dst->ti->soa;
+    ecs_assert(soa != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src->ti->soa == soa, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memmove(
+            ECS_OFFSET(dst->data, m->offset * dst_capacity + m->size * dst_row),
+            ECS_OFFSET(src->data, m->offset * src_capacity + m->size * src_row),
+            m->size * count);
+    }
+}
+
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_layout_t *soa = column->ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            ECS_OFFSET(value, m->offset), m->size);
+    }
+}
+
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+
+    /* Don't leave padding bytes uninitialized */
+    ecs_os_memset(value, 0, ti->size);
+
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(ECS_OFFSET(value, m->offset),
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            m->size);
+    }
+}
+
+/* Change size of column storage. When the column storage is moved, existing
+ * elements are moved with the ctor_move_dtor hook of the component. Columns 
+ * that are larger than the column page size of the world are stored in a 
+ * reserved address range, so that they can grow without moving. Column 
+ * storage is aligned to the largest of the component alignment and the column
+ * alignment of the world. Columns of cold components are stored in the cold 
+ * storage region of the world with the alignment of the component, and grow in
+ * place when the region has space after the column. The member arrays of columns with 
+ * struct-of-arrays storage are moved to the layout for the new size. */
+static
+void flecs_table_column_set_size(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t dst_size)
+{
+    ecs_assert(dst_size >= count, ECS_INTERNAL_ERROR, NULL);
+
+    if (dst_size == size) {
+        return;
+    }
+
+    if (!dst_size) {
+        flecs_table_column_fini(world, column);
+        return;
+    }
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = 
+        (column->flags & EcsColumnSoA) && count ? ti->soa : NULL;
+    ecs_size_t dst_bytes = ti->size * dst_size;
+    ecs_size_t alignment = flecs_table_column_alignment(world, ti);
+
+    if (column->flags & EcsColumnPaged) {
+        bool is_aligned = 
+            !((uintptr_t)column->data & ((uintptr_t)alignment - 1));
+        if (is_aligned) {
+            if (soa && dst_size < size) {
+                /* Compact members before memory is decommitted */
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+                size = dst_size;
+            }
+
+            if (flecs_table_column_commit(world, column, dst_bytes)) {
+                if (soa && dst_size > size) {
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                }
+                return;
+            }
+        }
+    }
+
+    void *dst = NULL;
+    ecs_flags32_t dst_flags = 0;
+    ecs_size_t page_size = world->column_page_size;
+    if (column->flags & EcsColumnCold) {
+        /* Cold columns are not paged and only use the alignment of the 
+         * component, which keeps them compact. */
+        if (ti->alignment > FLECS_COLD_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, ti->alignment);
+            dst_flags = EcsColumnAligned;
+        } else {
+            ecs_cold_storage_t *cold = &world->store.cold;
+            if (column->data) {
+                if (soa && dst_size < size) {
+                    /* Compact members before the block is shrunk */
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                    size = dst_size;
+                }
+
+                if (flecs_cold_resize(cold, column->data, dst_bytes)) {
+                    if (soa && dst_size > size) {
+                        flecs_table_column_soa_relayout(soa, column->data, 
+                            dst_size, column->data, size, count);
+                    }
+                    return;
+                }
+            }
+
+            dst = flecs_cold_alloc(cold, dst_bytes);
+        }
+    } else if (page_size && dst_bytes > page_size && 
+        ecs_os_has_virtual_memory()) 
+    {
+        dst = flecs_table_column_reserve(world, dst_bytes, alignment);
+        if (dst) {
+            dst_flags = EcsColumnPaged;
+        }
+    }
+
+    if (!dst && !(column->flags & EcsColumnCold)) {
+        if (alignment > FLECS_COLUMN_HEAP_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, alignment);
+            dst_flags = EcsColumnAligned;
+        } else if (!(column->flags & EcsColumnStorageMask) && 
+            (!count || !ti->hooks.ctor_move_dtor)) 
+        {
+            /* No elements need to be moved with hooks, realloc storage */
+            if (soa && dst_size < size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            column->data = ecs_os_realloc(column->data, dst_bytes);
+            if (soa && dst_size > size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            return;
+        } else {
+            dst = ecs_os_malloc(dst_bytes);
+        }
+    }
+
+    ecs_assert(dst != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    if (count) {
+        if (soa) {
+            flecs_table_column_soa_relayout(
+                soa, dst, dst_size, column->data, size, count);
+        } else if (ti->hooks.ctor_move_dtor) {
+            flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+        } else {
+            ecs_os_memcpy(dst, column->data, ti->size * count);
+        }
+    }
+
+    flecs_table_column_fini(world, column);
+    column->data = dst;
+    column->flags |= dst_flags;
+}
+
 /* Cleanup table storage */
 static void flecs_table_fini_data(
     ecs_world_t *world,
@@ -42099,10 +46143,7 @@ static void flecs_table_fini_data(
         if (columns) {
             int32_t c, column_count = table->column_count;
             for (c = 0; c < column_count; c ++) {
-                ecs_column_t *column = &columns[c];
-                ecs_vec_t v = ecs_vec_from_column(column, table, column->ti->size);
-                ecs_vec_fini(NULL, &v, column->ti->size);
-                column->data = NULL;
+                flecs_table_column_fini(world, &columns[c]);
             }
 
             flecs_wfree_n(world, ecs_column_t, table->column_count, columns);
@@ -42143,6 +46184,8 @@ static void flecs_table_fini_data(
         table->data.size = 0;
     }
 
+    flecs_table_fini_row_order(world, table);
+
     table->data.count = 0;
     table->_->traversable_count = 0;
     table->flags &= ~EcsTableHasTraversable;
@@ -42226,6 +46269,7 @@ void flecs_table_fini(
     }
 
     flecs_table_fini_overrides(world, table);
+    flecs_table_fini_dirty_chunks(world, table);
     flecs_wfree_n(world, int32_t, table->column_count + 1, table->dirty_state);
     ecs_os_free(table->column_map);
     if (table->component_map != flecs_table_empty_component_map) {
@@ -42302,11 +46346,45 @@ static void flecs_table_mark_table_dirty(
     }
 }
 
+/* Mark range of rows in table column dirty. If the table tracks row changes,
+ * stamp the chunks that contain the rows with the new column version. */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count)
+{
+    ecs_assert(table->dirty_state != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column < table->column_count, ECS_INTERNAL_ERROR, NULL);
+
+    /* Column is offset by 1, 0 is reserved for entity column. */
+    int32_t version = ++ table->dirty_state[column + 1];
+
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks || count <= 0) {
+        return;
+    }
+
+    /* Stamps are sized when the table storage grows, so this doesn't have to
+     * allocate when called from multiple workers. */
+    int32_t first = row >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t last = (row + count - 1) >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    ecs_vec_t *stamps = &chunks[column];
+    ecs_assert(last < ecs_vec_count(stamps), ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i, *array = ecs_vec_first_t(stamps, int32_t);
+    for (i = first; i <= last; i ++) {
+        flecs_table_stamp_store(&array[i], version);
+    }
+}
+
 /* Mark table component dirty */
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component)
+    ecs_entity_t component,
+    int32_t row)
 {
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -42332,8 +46410,7 @@ void flecs_table_mark_dirty(
         }
 
         /* Column is offset by 1, 0 is reserved for entity column. */
-
-        table->dirty_state[column] ++;
+        flecs_table_mark_column_dirty(table, column - 1, row, 1);
 
         ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
             FLECS_LOCKED_STORAGE_MSG("dirty marking"));
@@ -42359,6 +46436,25 @@ int32_t* flecs_table_get_dirty_state(
     return table->dirty_state;
 }
 
+/* Enable row change tracking for table. Writes that happened before tracking
+ * was enabled are not stamped, which is fine since queries that need the
+ * stamps treat tables they haven't synchronized with as fully changed. */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (table->_->dirty_chunks || !table->column_count) {
+        return;
+    }
+
+    flecs_table_get_dirty_state(world, table);
+
+    table->_->dirty_chunks = flecs_calloc_n(
+        &world->allocator, ecs_vec_t, table->column_count);
+    flecs_table_dirty_chunks_set_size(world, table);
+}
+
 /* Table move logic for bitset (toggle component) column */
 static void flecs_table_move_bitset_columns(
     ecs_table_t *dst_table, 
@@ -42448,69 +46544,276 @@ static void flecs_table_move_bitset_columns(
     }
 }
 
-/* Grow table column. When a column needs to be reallocated this function takes
- * care of correctly invoking ctor/move/dtor hooks. */
-static void flecs_table_grow_column(
+/* Defer keeping the rows of a table with StableOrder in order until the current
+ * command flush is done. While deferred, removed rows are filled with the last
+ * row of the table, and the order of the table is restored once for all 
+ * removed rows by flecs_table_restore_row_order(). This avoids shifting the 
+ * tail of the table for each removed row. Returns false if rows must be kept 
+ * in order right away. */
+static bool flecs_table_defer_row_order(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (table->_->row_order) {
+        return true;
+    }
+
+    if (!world->store.defer_row_order) {
+        return false;
+    }
+
+    /* Restoring the order moves values with ctor_move_dtor */
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        const ecs_type_info_t *ti = table->data.columns[i].ti;
+        if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+            return false;
+        }
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_row_order_t *row_order = flecs_alloc_t(a, ecs_table_row_order_t);
+    count = table->data.count;
+    ecs_vec_init_t(a, &row_order->keys, int32_t, count);
+    ecs_vec_set_count_t(a, &row_order->keys, int32_t, count);
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        keys[i] = i;
+    }
+    row_order->next = count;
+
+    table->_->row_order = row_order;
+    ecs_vec_append_t(a, &world->store.unordered_tables, uint64_t)[0] = 
+        table->id;
+
+    return true;
+}
+
+/* Add keys for rows appended to a table of which rows are out of order */
+static void flecs_table_row_order_append(
     ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t count)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    int32_t *keys = ecs_vec_grow_t(
+        &world->allocator, &row_order->keys, int32_t, count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        keys[i] = row_order->next ++;
+    }
+}
+
+/* Move values of a column so that row i gets the value of row src[i] */
+static void flecs_table_permute_column(
     ecs_table_t *table,
     int32_t column_index,
-    ecs_vec_t *column,
-    const ecs_type_info_t *ti,
-    int32_t to_add,
-    int32_t dst_size,
-    bool construct)
+    const int32_t *src,
+    bool *done,
+    void *tmp)
 {
-    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_column_t *column = &table->data.columns[column_index];
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t capacity = table->data.size;
+    bool soa = column->flags & EcsColumnSoA;
+    int32_t i, count = table->data.count;
 
-    int32_t count = ecs_vec_count(column);
-    int32_t size = ecs_vec_size(column);
-    int32_t elem_size = ti->size;
-    int32_t dst_count = count + to_add;
-    bool can_realloc = dst_size != size;
+    ecs_os_memset_n(done, 0, bool, count);
 
-    ecs_assert(dst_size >= dst_count, ECS_INTERNAL_ERROR, NULL);
+    for (i = 0; i < count; i ++) {
+        if (done[i] || src[i] == i) {
+            continue;
+        }
 
-    /* If the array could possibly realloc and the component has a move action 
-     * defined, move old elements manually */
-    if (count && can_realloc && ti->hooks.ctor_move_dtor) {
-        ecs_assert(ti->hooks.ctor != NULL, ECS_INTERNAL_ERROR, NULL);
+        /* Rotate the values of the rows in the cycle that starts at row i */
+        if (soa) {
+            flecs_table_soa_get(table, column_index, i, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                tmp, ECS_ELEM(column->data, size, i), 1, ti);
+        }
 
-        /* Create vector */
-        ecs_vec_t dst;
-        ecs_vec_init(NULL, &dst, elem_size, dst_size);
-        dst.count = dst_count;
+        int32_t cur = i;
+        while (src[cur] != i) {
+            if (soa) {
+                flecs_table_column_soa_copy(column, capacity, cur, 
+                    column, capacity, src[cur], 1);
+            } else {
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, cur), 
+                    ECS_ELEM(column->data, size, src[cur]), 1, ti);
+            }
+            done[cur] = true;
+            cur = src[cur];
+        }
+
+        if (soa) {
+            flecs_table_soa_set(table, column_index, cur, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(column->data, size, cur), tmp, 1, ti);
+        }
+        done[cur] = true;
+    }
+}
 
-        void *src_buffer = column->array;
-        void *dst_buffer = dst.array;
+/* Sort the rows of a table by their row order key */
+static void flecs_table_restore_rows(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
 
-        /* Move (and construct) existing elements to new vector */
-        flecs_type_info_ctor_move_dtor(dst_buffer, src_buffer, count, ti);
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("restore row order"));
 
-        if (construct) {
-            /* Construct new element(s) */
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, dst_buffer, count, to_add, ti);
+    int32_t i, count = table->data.count, key_count = row_order->next;
+    ecs_assert(ecs_vec_count(&row_order->keys) == count, 
+        ECS_INTERNAL_ERROR, NULL);
+    if (!count) {
+        flecs_table_fini_row_order(world, table);
+        return;
+    }
+
+    /* Keys are unique and smaller than key_count, so rows can be sorted by
+     * looking up the row of each key. */
+    ecs_allocator_t *a = &world->allocator;
+    int32_t *src = flecs_alloc_n(a, int32_t, key_count);
+    bool *done = flecs_alloc_n(a, bool, count);
+    ecs_os_memset_n(src, -1, int32_t, key_count);
+
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        src[keys[i]] = i;
+    }
+
+    int32_t dst = 0;
+    bool sorted = true;
+    for (i = 0; i < key_count; i ++) {
+        if (src[i] != -1) {
+            sorted &= src[i] == dst;
+            src[dst ++] = src[i];
         }
+    }
 
-        /* Free old vector */
-        ecs_vec_fini(NULL, column, elem_size);
+    ecs_assert(dst == count, ECS_INTERNAL_ERROR, NULL);
 
-        *column = dst;
-    } else {
-        /* If array won't realloc or has no move, simply add new elements */
-        if (can_realloc) {
-            ecs_vec_set_size(NULL, column, elem_size, dst_size);
+    if (!sorted) {
+        /* If the table is monitored, indicate that there has been a change */
+        flecs_table_mark_table_dirty(world, table, 0);
+
+        ecs_entity_t *entities = table->data.entities;
+        ecs_table__t *meta = table->_;
+        int32_t b, bs_count = meta->bs_count;
+        ecs_size_t tmp_size = ECS_MAX(ECS_SIZEOF(ecs_entity_t), bs_count);
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            tmp_size = ECS_MAX(tmp_size, table->data.columns[c].ti->size);
         }
 
-        ecs_vec_grow(NULL, column, elem_size, to_add);
+        void *tmp = flecs_alloc(a, tmp_size);
 
-        if (construct) {
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, column->array, count, to_add, ti);
+        for (c = 0; c < column_count; c ++) {
+            flecs_table_permute_column(table, c, src, done, tmp);
+        }
+
+        /* Permute entity ids and toggle bitsets */
+        ecs_os_memset_n(done, 0, bool, count);
+        for (i = 0; i < count; i ++) {
+            if (done[i] || src[i] == i) {
+                continue;
+            }
+
+            ecs_entity_t e = entities[i];
+            for (b = 0; b < bs_count; b ++) {
+                ECS_CAST(bool*, tmp)[b] = 
+                    flecs_bitset_get(&meta->bs_columns[b], i);
+            }
+
+            int32_t cur = i;
+            while (src[cur] != i) {
+                entities[cur] = entities[src[cur]];
+                for (b = 0; b < bs_count; b ++) {
+                    ecs_bitset_t *bs = &meta->bs_columns[b];
+                    flecs_bitset_set(bs, cur, flecs_bitset_get(bs, src[cur]));
+                }
+                done[cur] = true;
+                cur = src[cur];
+            }
+
+            entities[cur] = e;
+            for (b = 0; b < bs_count; b ++) {
+                flecs_bitset_set(&meta->bs_columns[b], cur, 
+                    ECS_CAST(bool*, tmp)[b]);
+            }
+            done[cur] = true;
+        }
+
+        flecs_free(a, tmp_size, tmp);
+
+        for (i = 0; i < count; i ++) {
+            if (src[i] == i) {
+                continue;
+            }
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
+        }
+    }
+
+    flecs_free_n(a, bool, count, done);
+    flecs_free_n(a, int32_t, key_count, src);
+    flecs_table_fini_row_order(world, table);
+
+    flecs_table_check_sanity(table);
+}
+
+void flecs_table_restore_row_order(
+    ecs_world_t *world)
+{
+    ecs_vec_t *tables = &world->store.unordered_tables;
+    int32_t i, count = ecs_vec_count(tables);
+    uint64_t *ids = ecs_vec_first_t(tables, uint64_t);
+    for (i = 0; i < count; i ++) {
+        /* Table could have been deleted while commands were flushed */
+        ecs_table_t *table = flecs_sparse_get_t(
+            &world->store.tables, ecs_table_t, ids[i]);
+        if (table) {
+            flecs_table_restore_rows(world, table);
         }
     }
 
-    ecs_assert(column->size == dst_size, ECS_INTERNAL_ERROR, NULL);
+    ecs_vec_clear(tables);
+}
+
+/* Grow table column. When a column needs to be reallocated this function takes
+ * care of correctly invoking ctor/move/dtor hooks. */
+static void flecs_table_grow_column(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t to_add,
+    int32_t dst_size,
+    bool construct)
+{
+    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_size >= (count + to_add), ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_column_set_size(world, column, count, size, dst_size);
+
+    if (construct) {
+        /* Construct new element(s) */
+        flecs_table_invoke_ctor_for_array(
+            world, table, column_index, column->data, count, to_add, column->ti);
+    }
 }
 
 /* Grow all data structures in a table */
@@ -42519,7 +46822,8 @@ static int32_t flecs_table_grow_data(
     ecs_table_t *table,
     int32_t to_add,
     int32_t size,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     flecs_poly_assert(world, ecs_world_t);
 
@@ -42554,6 +46858,11 @@ static int32_t flecs_table_grow_data(
     table->data.entities = v_entities.array;
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
+
+    if (to_add && table->_->row_order) {
+        flecs_table_row_order_append(world, table, to_add);
+    }
 
     /* Initialize entity ids and record ptrs */
     int32_t i;
@@ -42571,15 +46880,10 @@ static int32_t flecs_table_grow_data(
     ecs_column_t *columns = table->data.columns;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, to_add, size, true);
-        ecs_assert(v_column.size == size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, ECS_INTERNAL_ERROR, NULL);
-        column->data = v_column.array;
-
-        if (to_add) {
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            to_add, size, construct);
+
+        if (to_add && construct) {
             flecs_table_invoke_add_hooks(
                 world, table, i, e, count, to_add, false);
         }
@@ -42638,17 +46942,21 @@ static void flecs_table_copy_elem(
 
 /* Append operation for tables that don't have any complex logic */
 static void flecs_table_fast_append(
-    ecs_table_t *table)
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size,
+    int32_t dst_size)
 {
-    /* Add elements to each column array */
+    if (size == dst_size) {
+        return;
+    }
+
+    /* Grow each column array */
     ecs_column_t *columns = table->data.columns;
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
-        ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v = ecs_vec_from_column(column, table, ti->size);
-        ecs_vec_append(NULL, &v, ti->size);
-        column->data = v.array;
+        flecs_table_column_set_size(
+            world, &columns[i], table->data.count, size, dst_size);
     }
 }
 
@@ -42679,6 +46987,10 @@ void flecs_table_append(
     ecs_assert(e != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_entity_t *entities = table->data.entities = v_entities.array;
     *e = entity;
+
+    if (table->_->row_order) {
+        flecs_table_row_order_append(world, table, 1);
+    }
  
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);
@@ -42691,9 +47003,10 @@ void flecs_table_append(
 
     /* Fast path: no toggle columns, no lifecycle actions */
     if (!(table->flags & (EcsTableIsComplex|EcsTableHasIsA))) {
-        flecs_table_fast_append(table);
+        flecs_table_fast_append(world, table, table->data.size, v_entities.size);
         table->data.count = v_entities.count;
         table->data.size = v_entities.size;
+        flecs_table_dirty_chunks_set_size(world, table);
         return;
     }
 
@@ -42706,6 +47019,7 @@ void flecs_table_append(
         ECS_INTERNAL_ERROR, NULL);
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
 
     /* Reobtain size to ensure that the columns have the same size as the
      * entities vector. This keeps reasoning about when allocations occur
@@ -42716,20 +47030,14 @@ void flecs_table_append(
     int32_t i;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, 1, size, construct);
-        column->data = v_column.array;
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            1, size, construct);
 
         ecs_iter_action_t on_add_hook;
         if (on_add && (on_add_hook = column->ti->hooks.on_add)) {
             flecs_table_invoke_hook(world, table, on_add_hook, EcsOnAdd, column,
                 &entities[count], count, 1);
         }
-
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, 
-            ECS_INTERNAL_ERROR, NULL);
     }
 
     ecs_table__t *meta = table->_;
@@ -42756,6 +47064,13 @@ static void flecs_table_fast_delete(
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
         ecs_column_t *column = &columns[i];
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_column_soa_copy(
+                column, capacity, row, column, capacity, last, 1);
+            continue;
+        }
+
         ecs_size_t size = column->ti->size;
         flecs_table_copy_elem(
             ECS_ELEM(column->data, size, row),
@@ -42763,6 +47078,167 @@ static void flecs_table_fast_delete(
     }
 }
 
+/* Shift values of a column that can't be moved with ctor_move_dtor. Values 
+ * are moved with move assignments, and the values that end up past the end of
+ * the table are destructed, like flecs_table_delete does with move_dtor. The
+ * values of the removed rows must still be constructed. */
+static void flecs_table_shift_column_w_move(
+    ecs_column_t *column,
+    int32_t row,
+    int32_t count,
+    int32_t move_count)
+{
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t i, src_row = row + count, end = row + move_count;
+
+    for (i = 0; i < move_count; i ++) {
+        void *dst = ECS_ELEM(column->data, size, row + i);
+        void *src = ECS_ELEM(column->data, size, src_row + i);
+        if ((src_row + i) < end) {
+            /* Source is the destination of a later move */
+            flecs_type_info_move(dst, src, 1, ti);
+        } else {
+            flecs_type_info_move_dtor(dst, src, 1, ti);
+        }
+    }
+
+    if (end < src_row) {
+        /* Removed rows that weren't overwritten */
+        flecs_table_invoke_dtor(column, end, src_row - end);
+    }
+}
+
+/* Shift rows after a range of removed rows down, so that the remaining rows
+ * keep their order. Column values of the removed rows must be destructed, 
+ * except for columns that can't be moved with ctor_move_dtor. */
+static void flecs_table_shift_rows(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count)
+{
+    int32_t i, src_row = row + count;
+    int32_t move_count = table->data.count - src_row;
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* Rows are out of order, shift keys along with the rows */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        if (move_count > 0) {
+            ecs_os_memmove_n(&keys[row], &keys[src_row], int32_t, move_count);
+        }
+        ecs_vec_set_count_t(&world->allocator, &row_order->keys, int32_t, 
+            table->data.count - count);
+    }
+
+    if (move_count > 0) {
+        ecs_entity_t *entities = table->data.entities;
+        ecs_os_memmove_n(&entities[row], &entities[src_row], 
+            ecs_entity_t, move_count);
+
+        for (i = row; i < (row + move_count); i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
+        }
+
+        bool has_move = table->flags & (EcsTableHasDtors | EcsTableHasMove);
+        ecs_column_t *columns = table->data.columns;
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            ecs_column_t *column = &columns[c];
+            if (column->flags & EcsColumnSoA) {
+                int32_t capacity = table->data.size;
+                flecs_table_column_soa_copy(column, capacity, row, 
+                    column, capacity, src_row, move_count);
+                continue;
+            }
+
+            ecs_type_info_t *ti = column->ti;
+            ecs_size_t size = ti->size;
+            if (!has_move) {
+                ecs_os_memmove(ECS_ELEM(column->data, size, row), 
+                    ECS_ELEM(column->data, size, src_row), size * move_count);
+                continue;
+            }
+
+            if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+                flecs_table_shift_column_w_move(column, row, count, move_count);
+                continue;
+            }
+
+            /* Move in blocks that don't overlap. The source rows of a block
+             * are destructed by the move and become the next destination. */
+            for (i = 0; i < move_count; i += count) {
+                int32_t n = ECS_MIN(count, move_count - i);
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, row + i), 
+                    ECS_ELEM(column->data, size, src_row + i), n, ti);
+            }
+        }
+    }
+
+    ecs_table__t *meta = table->_;
+    ecs_bitset_t *bs_columns = meta->bs_columns;
+    int32_t bs_count = meta->bs_count;
+    for (i = 0; i < bs_count; i ++) {
+        flecs_bitset_remove_range(&bs_columns[i], row, count);
+    }
+}
+
+/* Delete entity from table with the StableOrder trait */
+static void flecs_table_delete_ordered(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    bool destruct)
+{
+    ecs_entity_t entity_to_delete = table->data.entities[row];
+
+    /* If the table is monitored, indicate that there has been a change */
+    flecs_table_mark_table_dirty(world, table, 0);
+
+    if (table->flags & (EcsTableHasDtors | EcsTableHasMove)) {
+        ecs_column_t *columns = table->data.columns;
+        int32_t i, column_count = table->column_count;
+        for (i = 0; i < column_count; i ++) {
+            ecs_column_t *column = &columns[i];
+            ecs_type_info_t *ti = column->ti;
+
+            /* Values that can't be moved with ctor_move_dtor are shifted with
+             * move assignments, which overwrite the removed value. */
+            bool shift_w_move = 
+                ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL;
+
+            if (destruct) {
+                flecs_table_invoke_remove_hooks(world, table, column, 
+                    &entity_to_delete, row, 1, !shift_w_move);
+                continue;
+            }
+
+            /* Value was moved to another table. If the type does not support
+             * non-destructive moves, the value was already destructed. */
+            if (!shift_w_move && 
+                (ti->hooks.move_ctor || !ti->hooks.ctor_move_dtor)) 
+            {
+                flecs_table_invoke_dtor(column, row, 1);
+            }
+        }
+    }
+
+    flecs_table_shift_rows(world, table, row, 1);
+
+    table->data.count --;
+    if (!table->data.count) {
+        table->flags |= EcsTableEmpty;
+        table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_check_sanity(table);
+}
+
 /* Delete entity from table */
 void flecs_table_delete(
     ecs_world_t *world,
@@ -42782,6 +47258,21 @@ void flecs_table_delete(
     count --;
     ecs_assert(row <= count, ECS_INTERNAL_ERROR, NULL);
 
+    if (table->_->stable_order && (row != count)) {
+        if (!flecs_table_defer_row_order(world, table)) {
+            flecs_table_delete_ordered(world, table, row, destruct);
+            return;
+        }
+    }
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* The last row is moved to the deleted row */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        keys[row] = keys[count];
+        ecs_vec_remove_last(&row_order->keys);
+    }
+
     /* Move last entity id to row */
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t entity_to_move = entities[count];
@@ -42851,6 +47342,13 @@ void flecs_table_delete(
                         EcsOnRemove, column, &entity_to_delete, row, 1);
                 }
 
+                if (column->flags & EcsColumnSoA) {
+                    int32_t capacity = table->data.size;
+                    flecs_table_column_soa_copy(
+                        column, capacity, row, column, capacity, count, 1);
+                    continue;
+                }
+
                 /* If neither move nor move_ctor are set, this indicates that 
                  * non-destructive move semantics are not supported for this 
                  * type. In such cases, use ctor_move_dtor for destructive move
@@ -42903,10 +47401,16 @@ static void flecs_table_fast_move(
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
         if (dst_id == src_id) {
-            int32_t size = dst_column->ti->size;
-            void *dst = ECS_ELEM(dst_column->data, size, dst_index);
-            void *src = ECS_ELEM(src_column->data, size, src_index);
-            flecs_table_copy_elem(dst, src, size);
+            if (dst_column->flags & EcsColumnSoA) {
+                flecs_table_column_soa_copy(
+                    dst_column, dst_table->data.size, dst_index, 
+                    src_column, src_table->data.size, src_index, 1);
+            } else {
+                int32_t size = dst_column->ti->size;
+                void *dst = ECS_ELEM(dst_column->data, size, dst_index);
+                void *src = ECS_ELEM(src_column->data, size, src_index);
+                flecs_table_copy_elem(dst, src, size);
+            }
         }
 
         i_new += dst_id <= src_id;
@@ -42966,7 +47470,11 @@ void flecs_table_move(
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
-        if (dst_id == src_id) {
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(
+                dst_column, dst_table->data.size, dst_index, 
+                src_column, src_table->data.size, src_index, 1);
+        } else if (dst_id == src_id) {
             ecs_type_info_t *ti = dst_column->ti;
             int32_t size = ti->size;
 
@@ -43012,6 +47520,166 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 }
 
+/* Move a range of rows from src to dst table */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count)
+{
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!dst_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(!src_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t src_count = ecs_table_count(src_table);
+    ecs_assert(src_row >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert((src_row + count) <= src_count, ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    /* Append rows to destination table without constructing them. Column 
+     * values are either moved from the source table or constructed by the add
+     * hooks below. */
+    ecs_entity_t *src_entities = src_table->data.entities;
+    int32_t dst_row = ecs_table_count(dst_table);
+    flecs_table_grow_data(world, dst_table, count, dst_row + count, 
+        &src_entities[src_row], false);
+    ecs_entity_t *dst_entities = dst_table->data.entities;
+
+    flecs_table_move_bitset_columns(
+        dst_table, dst_row, src_table, src_row, count, false);
+
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    int32_t dst_size = dst_table->data.size, src_size = src_table->data.size;
+
+    /* Move shared columns as a single block per column. Values are moved with
+     * destructive move semantics, which leaves the source rows uninitialized
+     * so they can be overwritten by the tail of the source table. */
+    for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
+        ecs_column_t *dst_column = &dst_columns[i_new];
+        ecs_column_t *src_column = &src_columns[i_old];
+        ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
+        ecs_id_t src_id = flecs_column_id(src_table, i_old);
+
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(dst_column, dst_size, dst_row, 
+                src_column, src_size, src_row, count);
+        } else if (dst_id == src_id) {
+            ecs_type_info_t *ti = dst_column->ti;
+            int32_t size = ti->size;
+            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(dst_column->data, size, dst_row), 
+                ECS_ELEM(src_column->data, size, src_row), count, ti);
+        } else if (dst_id < src_id) {
+            flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+                &dst_entities[dst_row], dst_row, count, true);
+        } else {
+            flecs_table_invoke_remove_hooks(world, src_table, src_column, 
+                &src_entities[src_row], src_row, count, true);
+        }
+
+        i_new += dst_id <= src_id;
+        i_old += dst_id >= src_id;
+    }
+
+    for (; (i_new < dst_column_count); i_new ++) {
+        flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+            &dst_entities[dst_row], dst_row, count, true);
+    }
+
+    for (; (i_old < src_column_count); i_old ++) {
+        flecs_table_invoke_remove_hooks(world, src_table, &src_columns[i_old],
+            &src_entities[src_row], src_row, count, true);
+    }
+
+    /* Update records of moved entities in a single pass */
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_record_t *r = flecs_entities_get(world, dst_entities[dst_row + i]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+        r->table = dst_table;
+        r->row = ECS_ROW_TO_RECORD(dst_row + i, r->row & ECS_ROW_FLAGS_MASK);
+    }
+
+    if (src_table->_->stable_order) {
+        /* Shift the tail of the table down to keep rows in order */
+        flecs_table_shift_rows(world, src_table, src_row, count);
+    } else {
+        /* Fill the gap in the source table with rows from the end of the 
+         * table. Rows are filled in the same order as deleting the entities 
+         * one by one would, so that the resulting table is the same. */
+        int32_t fill = src_count - (src_row + count);
+        if (fill > count) {
+            fill = count;
+        }
+
+        for (i = 0; i < fill; i ++) {
+            int32_t dst = src_row + i, src = src_count - 1 - i;
+            ecs_entity_t e = src_entities[dst] = src_entities[src];
+            ecs_record_t *r = flecs_entities_get(world, e);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(dst, r->row & ECS_ROW_FLAGS_MASK);
+
+            int32_t c;
+            for (c = 0; c < src_column_count; c ++) {
+                ecs_column_t *column = &src_columns[c];
+                if (column->flags & EcsColumnSoA) {
+                    flecs_table_column_soa_copy(
+                        column, src_size, dst, column, src_size, src, 1);
+                    continue;
+                }
+
+                ecs_type_info_t *ti = column->ti;
+                int32_t size = ti->size;
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, dst), 
+                    ECS_ELEM(column->data, size, src), 1, ti);
+            }
+        }
+
+        ecs_table__t *meta = src_table->_;
+        ecs_bitset_t *bs_columns = meta->bs_columns;
+        int32_t bs_count = meta->bs_count;
+        for (i = 0; i < bs_count; i ++) {
+            ecs_bitset_t *bs = &bs_columns[i];
+            int32_t j;
+            for (j = 0; j < fill; j ++) {
+                flecs_bitset_set(bs, src_row + j, 
+                    flecs_bitset_get(bs, src_count - 1 - j));
+            }
+            for (j = 0; j < count; j ++) {
+                flecs_bitset_remove(bs, src_count - 1 - j);
+            }
+        }
+    }
+
+    src_table->data.count -= count;
+    if (!src_table->data.count) {
+        src_table->flags |= EcsTableEmpty;
+        src_table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_mark_table_dirty(world, src_table, 0);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    return dst_row;
+}
+
 /* Append n entities to table */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
@@ -43033,7 +47701,7 @@ int32_t flecs_table_appendn(
     flecs_table_check_sanity(table);
     int32_t cur_count = ecs_table_count(table);
     int32_t result = flecs_table_grow_data(
-        world, table, to_add, cur_count + to_add, ids);
+        world, table, to_add, cur_count + to_add, ids, true);
     flecs_table_check_sanity(table);
 
     return result;
@@ -43047,7 +47715,6 @@ bool flecs_table_shrink(
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table shrink"));
-    (void)world;
 
     flecs_table_check_sanity(table);
 
@@ -43073,18 +47740,8 @@ bool flecs_table_shrink(
 
     int32_t i, column_count = table->column_count;
     for (i = 0; i < column_count; i ++) {
-        const ecs_type_info_t *ti = columns[i].ti;
-        ecs_size_t component_size = ti->size;
-        void *data = columns[i].data;
-
-        if (count) {
-            columns[i].data = ecs_os_malloc(component_size * count);
-            flecs_type_info_ctor_move_dtor(columns[i].data, data, count, ti);
-        } else {
-            columns[i].data = NULL;
-        }
-
-        ecs_os_free(data);
+        flecs_table_column_set_size(
+            world, &columns[i], count, table->data.size, count);
     }
 
     table->data.size = count;
@@ -43096,6 +47753,66 @@ bool flecs_table_shrink(
     return has_payload;
 }
 
+/* Move cold columns of table to free space at lower addresses of the cold 
+ * storage region, so that pages at the end of the region can be released. 
+ * Returns whether a column was moved. */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("table compaction"));
+
+    ecs_cold_storage_t *cold = &world->store.cold;
+    ecs_column_t *columns = table->data.columns;
+    int32_t count = table->data.count, size = table->data.size;
+    int32_t i, column_count = table->column_count;
+    bool moved = false;
+
+    for (i = 0; i < column_count; i ++) {
+        ecs_column_t *column = &columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) != 
+            EcsColumnCold) 
+        {
+            continue;
+        }
+
+        if (!column->data) {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = column->ti;
+        void *dst = flecs_cold_alloc_before(
+            cold, ti->size * size, column->data);
+        if (!dst) {
+            continue;
+        }
+
+        if (count) {
+            if (column->flags & EcsColumnSoA) {
+                /* Capacity doesn't change, so member arrays keep offsets */
+                ecs_os_memcpy(dst, column->data, ti->size * size);
+            } else if (ti->hooks.ctor_move_dtor) {
+                flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+            } else {
+                ecs_os_memcpy(dst, column->data, ti->size * count);
+            }
+        }
+
+        flecs_cold_free(cold, column->data);
+        column->data = dst;
+        moved = true;
+    }
+
+    if (moved) {
+        /* Invalidate refs to components in the moved columns */
+        flecs_increment_table_version(world, table);
+    }
+
+    return moved;
+}
+
 /* Swap operation for bitset (toggle component) columns */
 static void flecs_table_swap_bitset_columns(
     ecs_table_t *table,
@@ -43135,6 +47852,9 @@ static void flecs_table_swap(
         return;
     }
 
+    /* Rows are sorted relative to the stable order of the table */
+    flecs_table_restore_rows(world, table);
+
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);    
 
@@ -43183,6 +47903,15 @@ static void flecs_table_swap(
         const ecs_type_info_t *ti = column->ti;
         ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
 
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_soa_get(table, i, row_1, tmp);
+            flecs_table_column_soa_copy(
+                column, capacity, row_1, column, capacity, row_2, 1);
+            flecs_table_soa_set(table, i, row_2, tmp);
+            continue;
+        }
+
         void *el_1 = ECS_ELEM(ptr, size, row_1);
         void *el_2 = ECS_ELEM(ptr, size, row_2);
 
@@ -43236,39 +47965,44 @@ static void flecs_table_merge_vec(
 /* Merge data from one table column into other table column */
 static void flecs_table_merge_column(
     ecs_world_t *world,
-    ecs_vec_t *dst_vec,
-    ecs_vec_t *src_vec,
     ecs_column_t *dst,
     ecs_column_t *src,
+    int32_t dst_count,
+    int32_t dst_size,
+    int32_t src_count,
+    int32_t src_size,
     int32_t column_size)
 {
     const ecs_type_info_t *ti = dst->ti;
     ecs_assert(ti == src->ti, ECS_INTERNAL_ERROR, NULL);
-    ecs_size_t elem_size = ti->size;
-    int32_t dst_count = ecs_vec_count(dst_vec);
 
     if (!dst_count) {
-        ecs_vec_fini(NULL, dst_vec, elem_size);
-        *dst_vec = *src_vec;
+        flecs_table_column_fini(world, dst);
+        dst->data = src->data;
+        dst->flags = src->flags;
 
     /* If the new table is not empty, move the contents from the
      * src into the dst. */
     } else {
-        int32_t src_count = src_vec->count;
+        flecs_table_grow_column(world, NULL, -1, dst, dst_count, dst_size,
+            src_count, column_size, false);
 
-        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, src_count, column_size, false);
-        void *dst_ptr = ECS_ELEM(dst_vec->array, elem_size, dst_count);
-        void *src_ptr = src_vec->array;
+        if (dst->flags & EcsColumnSoA) {
+            flecs_table_column_soa_copy(
+                dst, column_size, dst_count, src, src_size, 0, src_count);
+        } else {
+            void *dst_ptr = ECS_ELEM(dst->data, ti->size, dst_count);
+            void *src_ptr = src->data;
 
-        /* Move values into column */
-        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+            /* Move values into column */
+            flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+        }
 
-        ecs_vec_fini(NULL, src_vec, elem_size);
+        flecs_table_column_fini(world, src);
     }
 
-    dst->data = dst_vec->array;
     src->data = NULL;
+    src->flags &= ~EcsColumnStorageMask;
 }
 
 /* Merge storage of two tables. */
@@ -43290,6 +48024,9 @@ static void flecs_table_merge_data(
         return;
     }
 
+    int32_t dst_size = dst_table->data.size;
+    int32_t src_size = src_table->data.size;
+
     /* Merge entities */
     ecs_vec_t dst_entities = ecs_vec_from_entities(dst_table);
     ecs_vec_t src_entities = ecs_vec_from_entities(src_table);
@@ -43299,36 +48036,35 @@ static void flecs_table_merge_data(
         ECS_INTERNAL_ERROR, NULL);
     int32_t column_size = dst_entities.size;
 
+    /* Update destination storage before columns are merged, so that hooks 
+     * that are invoked for new columns see the merged entities. */
+    dst_table->data.entities = dst_entities.array;
+    dst_table->data.count = dst_entities.count;
+    dst_table->data.size = dst_entities.size;
+    flecs_table_dirty_chunks_set_size(world, dst_table);
+
     for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
         ecs_column_t *dst_column = &dst_columns[i_new];
         ecs_column_t *src_column = &src_columns[i_old];
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
-        ecs_size_t dst_elem_size = dst_column->ti->size;
-        ecs_size_t src_elem_size = src_column->ti->size;
-    
-        ecs_vec_t dst_vec = ecs_vec_from_column(
-            dst_column, dst_table, dst_elem_size);
-        ecs_vec_t src_vec = ecs_vec_from_column(
-            src_column, src_table, src_elem_size);
 
         if (dst_id == src_id) {
-            flecs_table_merge_column(world, &dst_vec, &src_vec, dst_column, 
-                src_column, column_size);
+            flecs_table_merge_column(world, dst_column, src_column, dst_count,
+                dst_size, src_count, src_size, column_size);
             flecs_table_mark_table_dirty(world, dst_table, i_new + 1);
             i_new ++;
             i_old ++;
         } else if (dst_id < src_id) {
-            /* New column, make sure vector is large enough. */
-            ecs_vec_set_size(NULL, &dst_vec, dst_elem_size, column_size);
-            dst_column->data = dst_vec.array;
+            /* New column, make sure storage is large enough. */
+            flecs_table_column_set_size(
+                world, dst_column, dst_count, dst_size, column_size);
             flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
             i_new ++;
         } else if (dst_id > src_id) {
             /* Old column does not occur in new table, destruct */
             flecs_table_invoke_dtor(src_column, 0, src_count);
-            ecs_vec_fini(NULL, &src_vec, src_elem_size);
-            src_column->data = NULL;
+            flecs_table_column_fini(world, src_column);
             i_old ++;
         }
     }
@@ -43339,32 +48075,23 @@ static void flecs_table_merge_data(
     /* Initialize remaining columns */
     for (; i_new < dst_column_count; i_new ++) {
         ecs_column_t *column = &dst_columns[i_new];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_vec_t vec = ecs_vec_from_column(column, dst_table, elem_size);
-        ecs_vec_set_size(NULL, &vec, elem_size, column_size);
-        column->data = vec.array;
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
+        flecs_table_column_set_size(
+            world, column, dst_count, dst_size, column_size);
         flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
     }
 
     /* Destruct remaining columns */
     for (; i_old < src_column_count; i_old ++) {
         ecs_column_t *column = &src_columns[i_old];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
         flecs_table_invoke_dtor(column, 0, src_count);
-        ecs_vec_t vec = ecs_vec_from_column(column, src_table, elem_size);
-        ecs_vec_fini(NULL, &vec, elem_size);
-        column->data = vec.array;
+        flecs_table_column_fini(world, column);
     }    
 
     /* Mark entity column as dirty */
     flecs_table_mark_table_dirty(world, dst_table, 0);
 
-    dst_table->data.entities = dst_entities.array;
-    dst_table->data.count = dst_entities.count;
-    dst_table->data.size = dst_entities.size;
-
     src_table->data.entities = src_entities.array;
     src_table->data.count = src_entities.count;
     src_table->data.size = src_entities.size;
@@ -43388,6 +48115,10 @@ void flecs_table_merge(
     flecs_table_check_sanity(src_table);
     flecs_table_check_sanity(dst_table);
 
+    /* Rows of the source table are appended in their stable order */
+    flecs_table_restore_rows(world, src_table);
+    flecs_table_restore_rows(world, dst_table);
+
     const ecs_entity_t *src_entities = ecs_table_entities(src_table);
     int32_t src_count = ecs_table_count(src_table);
     int32_t dst_count = ecs_table_count(dst_table);
@@ -43783,6 +48514,8 @@ void* ecs_table_get_column(
         "column index %d out of range for table", index);
 
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     void *result = column->data;
     if (offset) {
         result = ECS_ELEM(result, column->ti->size, offset);
@@ -43932,6 +48665,8 @@ void* ecs_record_get_by_column(
 
     ecs_check(index < table->column_count, ECS_INVALID_PARAMETER, NULL);
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     ecs_size_t size = column->ti->size;
 
     ecs_check(!flecs_utosize(c_size) || flecs_utosize(c_size) == size, 
@@ -52333,9 +57068,21 @@ static int flecs_json_serialize_iter_result_field_values(
             continue;
         }
 
-        void *ptr;
+        void *ptr, *soa_value = NULL;
+        ecs_table_t *table;
+        int32_t row, column;
         if (row_fields & field_bit) {
             ptr = ecs_field_at_w_size(it, flecs_itosize(it->sizes[f]), f, i);
+        } else if (!it->ptrs && 
+            (column = flecs_field_column(it, f, &table, &row)) >= 0 &&
+            (table->data.columns[column].flags & EcsColumnSoA))
+        {
+            /* Gather members of struct-of-arrays component into a value */
+            if (!it->sources[f]) {
+                row += i;
+            }
+            ptr = soa_value = ecs_os_malloc(it->sizes[f]);
+            flecs_table_soa_get(table, column, row, ptr);
         } else {
             ecs_size_t size = it->sizes[f];
             ptr = ecs_field_w_size(it, flecs_itosize(size), f);
@@ -52351,7 +57098,11 @@ static int flecs_json_serialize_iter_result_field_values(
         }
 
         flecs_json_next(buf);
-        if (flecs_json_ser_type(world, &value_ctx->ser->ops, ptr, buf) != 0) {
+        int ret = flecs_json_ser_type(world, &value_ctx->ser->ops, ptr, buf);
+        if (soa_value) {
+            ecs_os_free(soa_value);
+        }
+        if (ret != 0) {
             return -1;
         }
     }
@@ -52816,11 +57567,18 @@ static int flecs_json_serialize_table_components(
         }
 
         const ecs_type_info_t *ti;
+        void *soa_value = NULL;
         int32_t column_index = table->column_map ? table->column_map[i] : -1;
         if (column_index != -1) {
             ecs_column_t *column = &table->data.columns[column_index];
             ti = column->ti;
-            ptr = ECS_ELEM(column->data, ti->size, row);
+            if (column->flags & EcsColumnSoA) {
+                /* Gather members of struct-of-arrays component into a value */
+                ptr = soa_value = ecs_os_malloc(ti->size);
+                flecs_table_soa_get(table, column_index, row, ptr);
+            } else {
+                ptr = ECS_ELEM(column->data, ti->size, row);
+            }
         } else {
             if (!(cr->flags & EcsIdSparse) || !cr->type_info) {
                 continue;
@@ -52834,9 +57592,12 @@ static int flecs_json_serialize_table_components(
             continue;
         }
 
-        if (flecs_json_serialize_component_value(world, id, ptr, ti, buf,
-            ser_ctx, values_ctx, desc, component_count))
-        {
+        int ret = flecs_json_serialize_component_value(world, id, ptr, ti, buf,
+            ser_ctx, values_ctx, desc, component_count);
+        if (soa_value) {
+            ecs_os_free(soa_value);
+        }
+        if (ret) {
             goto error;
         }
     }
@@ -62077,6 +66838,10 @@ void flecs_meta_value_init(
 
 #endif
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* For pthread_setaffinity_np */
+#endif
+
 #ifdef FLECS_OS_API_IMPL
 #ifdef ECS_TARGET_WINDOWS
 
@@ -62116,11 +66881,73 @@ static void* win_thread_join(
     return NULL;
 }
 
+static DWORD flecs_win_detached_thread(void *ptr) {
+    ecs_win_thread_t *thread = ptr;
+    thread->callback(thread->arg);
+    ecs_os_free(thread);
+    return 0;
+}
+
+/* Tasks are not pooled on Windows, a submitted task runs on its own thread.
+ * The functions to configure and inspect the pool are provided so that 
+ * applications can use the same code on all platforms. */
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    ecs_win_thread_t *thread = ecs_os_malloc_t(ecs_win_thread_t);
+    thread->arg = param;
+    thread->callback = callback;
+    HANDLE handle = CreateThread(NULL, 0, 
+        (LPTHREAD_START_ROUTINE)flecs_win_detached_thread, thread, 0, NULL);
+    if (!handle) {
+        ecs_os_abort();
+    }
+    CloseHandle(handle);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    (void)count;
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    return 0;
+}
+
 static ecs_os_thread_id_t win_thread_self(void)
 {
     return (ecs_os_thread_id_t)GetCurrentThreadId();
 }
 
+static bool win_thread_set_affinity(
+    ecs_os_thread_t thr,
+    int32_t cpu)
+{
+    if (cpu < -1 || cpu >= (int32_t)(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+
+    HANDLE handle = GetCurrentThread();
+    if (thr) {
+        handle = ((ecs_win_thread_t*)(uintptr_t)thr)->thread;
+    }
+
+    DWORD_PTR mask;
+    if (cpu == -1) {
+        /* Allow all cores the process can run on */
+        DWORD_PTR system_mask;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &mask, &system_mask)) {
+            return false;
+        }
+    } else {
+        mask = (DWORD_PTR)1 << cpu;
+    }
+
+    return SetThreadAffinityMask(handle, mask) != 0;
+}
+
 static int32_t win_ainc(
     int32_t *count) 
 {
@@ -62145,6 +66972,27 @@ static int64_t win_ladec(
     return InterlockedDecrement64(count);
 }
 
+static int32_t win_aload(
+    const int32_t *count) 
+{
+    return InterlockedCompareExchange(
+        (volatile long*)ECS_CONST_CAST(int32_t*, count), 0, 0);
+}
+
+static void* win_aloadp(
+    void *const *ptr) 
+{
+    return InterlockedCompareExchangePointer(
+        ECS_CONST_CAST(void *volatile*, ptr), NULL, NULL);
+}
+
+static void win_astorep(
+    void **ptr,
+    void *value) 
+{
+    InterlockedExchangePointer((void *volatile*)ptr, value);
+}
+
 static ecs_os_mutex_t win_mutex_new(void) {
     CRITICAL_SECTION *mutex = ecs_os_malloc_t(CRITICAL_SECTION);
     InitializeCriticalSection(mutex);
@@ -62313,6 +67161,43 @@ static void win_dlclose(ecs_os_dl_t lib) {
     FreeLibrary((HMODULE)(uintptr_t)lib);
 }
 
+static void* win_reserve(
+    ecs_size_t size)
+{
+    return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static bool win_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    return VirtualAlloc(ptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void win_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uintptr_t page_size = (uintptr_t)info.dwPageSize;
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        VirtualFree((void*)start, (SIZE_T)(end - start), MEM_DECOMMIT);
+    }
+}
+
+static void win_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
 static void win_fini(void) {
     if (ecs_os_api.flags_ & EcsOsApiHighResolutionTimer) {
         win_enable_high_timer_resolution(false);
@@ -62327,12 +67212,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = win_thread_new;
     api.thread_join_ = win_thread_join;
     api.thread_self_ = win_thread_self;
+    api.thread_set_affinity_ = win_thread_set_affinity;
     api.task_new_ = win_thread_new;
     api.task_join_ = win_thread_join;
     api.ainc_ = win_ainc;
     api.adec_ = win_adec;
     api.lainc_ = win_lainc;
     api.ladec_ = win_ladec;
+    api.aload_ = win_aload;
+    api.aloadp_ = win_aloadp;
+    api.astorep_ = win_astorep;
     api.mutex_new_ = win_mutex_new;
     api.mutex_free_ = win_mutex_free;
     api.mutex_lock_ = win_mutex_lock;
@@ -62348,6 +67237,10 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = win_dlopen;
     api.dlproc_ = win_dlproc;
     api.dlclose_ = win_dlclose;
+    api.reserve_ = win_reserve;
+    api.commit_ = win_commit;
+    api.decommit_ = win_decommit;
+    api.release_ = win_release;
 
     win_time_setup();
 
@@ -62363,6 +67256,15 @@ void ecs_set_os_api_impl(void) {
 #include "pthread.h"
 #include <dlfcn.h>
 
+#ifndef __EMSCRIPTEN__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach/mach_time.h>
 #elif defined(__EMSCRIPTEN__)
@@ -62401,11 +67303,235 @@ static void* posix_thread_join(
     return arg;
 }
 
+/* Tasks run on a pool of threads, so that creating and joining a task doesn't
+ * have to create and join a thread. A thread is added to the pool when a task 
+ * is created while all threads are busy, as tasks (like pipeline workers) can
+ * block until other tasks are running. When a thread finishes a task and the
+ * pool already has the maximum number of idle threads, the thread exits. The
+ * maximum is 0 by default, in which case each task runs on its own thread. */
+typedef struct posix_task_t {
+    ecs_os_thread_callback_t callback;
+    void *arg;
+    void *result;
+    bool done;
+    bool detached;
+    struct posix_task_t *next;
+} posix_task_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t task_cond;      /* Signaled when a task is queued */
+    pthread_cond_t done_cond;      /* Signaled when a task or thread is done */
+    posix_task_t *first;           /* Queue with tasks that haven't started */
+    posix_task_t *last;
+    int32_t queued_count;
+    int32_t idle_count;
+    int32_t max_idle_count;        /* Idle threads above this count exit */
+    int32_t thread_count;
+    bool quit;
+    ecs_os_api_fini_t prev_fini;   /* Fini callback of previous OS API */
+} posix_task_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .task_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER
+};
+
+static void* posix_task_pool_thread(
+    void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    for (;;) {
+        while (!posix_task_pool.first && !posix_task_pool.quit) {
+            if (posix_task_pool.idle_count >= posix_task_pool.max_idle_count) {
+                /* Don't keep more idle threads than allowed */
+                goto done;
+            }
+            posix_task_pool.idle_count ++;
+            pthread_cond_wait(&posix_task_pool.task_cond, &posix_task_pool.lock);
+            posix_task_pool.idle_count --;
+        }
+
+        /* Finish queued tasks before quitting */
+        posix_task_t *task = posix_task_pool.first;
+        if (!task) {
+            break;
+        }
+
+        posix_task_pool.first = task->next;
+        if (!posix_task_pool.first) {
+            posix_task_pool.last = NULL;
+        }
+        posix_task_pool.queued_count --;
+        pthread_mutex_unlock(&posix_task_pool.lock);
+
+        void *result = task->callback(task->arg);
+
+        pthread_mutex_lock(&posix_task_pool.lock);
+        if (task->detached) {
+            ecs_os_free(task);
+        } else {
+            task->result = result;
+            task->done = true;
+            pthread_cond_broadcast(&posix_task_pool.done_cond);
+        }
+    }
+
+done:
+    posix_task_pool.thread_count --;
+    pthread_cond_broadcast(&posix_task_pool.done_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return NULL;
+}
+
+static posix_task_t* posix_task_push(
+    ecs_os_thread_callback_t callback, 
+    void *arg,
+    bool detached)
+{
+    posix_task_t *task = ecs_os_calloc_t(posix_task_t);
+    task->callback = callback;
+    task->arg = arg;
+    task->detached = detached;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    if (posix_task_pool.last) {
+        posix_task_pool.last->next = task;
+    } else {
+        posix_task_pool.first = task;
+    }
+    posix_task_pool.last = task;
+    posix_task_pool.queued_count ++;
+
+    if (posix_task_pool.idle_count >= posix_task_pool.queued_count) {
+        pthread_cond_signal(&posix_task_pool.task_cond);
+    } else {
+        /* Pool threads are detached, the pool waits for them to exit by 
+         * tracking the number of running threads. */
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, posix_task_pool_thread, NULL) != 0) {
+            ecs_os_abort();
+        }
+        pthread_attr_destroy(&attr);
+        posix_task_pool.thread_count ++;
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return task;
+}
+
+static ecs_os_thread_t posix_task_new(
+    ecs_os_thread_callback_t callback, 
+    void *arg)
+{
+    return (ecs_os_thread_t)(uintptr_t)posix_task_push(callback, arg, false);
+}
+
+static void* posix_task_join(
+    ecs_os_thread_t thread)
+{
+    posix_task_t *task = (posix_task_t*)(uintptr_t)thread;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    while (!task->done) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    void *result = task->result;
+    ecs_os_free(task);
+    return result;
+}
+
+/* Stop pool threads after all queued tasks are done */
+static void posix_task_pool_fini(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.quit = true;
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    while (posix_task_pool.thread_count) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    posix_task_pool.quit = false;
+    ecs_os_api_fini_t prev_fini = posix_task_pool.prev_fini;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    if (prev_fini) {
+        prev_fini();
+    }
+}
+
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    posix_task_push(callback, param, true);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    ecs_assert(count >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.max_idle_count = count;
+
+    /* Wake up idle threads so that threads above the new maximum exit */
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    int32_t result = posix_task_pool.thread_count;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+    return result;
+}
+
 static ecs_os_thread_id_t posix_thread_self(void)
 {
     return (ecs_os_thread_id_t)pthread_self();
 }
 
+static bool posix_thread_set_affinity(
+    ecs_os_thread_t thread,
+    int32_t cpu)
+{
+#if defined(__linux__) && defined(CPU_SET)
+    if (cpu < -1 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    pthread_t thr = pthread_self();
+    if (thread) {
+        thr = *(pthread_t*)(uintptr_t)thread;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu == -1) {
+        /* Allow all cores. Cores that don't exist are ignored. */
+        int32_t i;
+        for (i = 0; i < CPU_SETSIZE; i ++) {
+            CPU_SET((size_t)i, &set);
+        }
+    } else {
+        CPU_SET((size_t)cpu, &set);
+    }
+
+    return pthread_setaffinity_np(thr, sizeof(set), &set) == 0;
+#else
+    /* Thread affinity is not supported on this platform */
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
 static int32_t posix_ainc(
     int32_t *count)
 {
@@ -62482,6 +67608,61 @@ static int64_t posix_ladec(
 #endif
 }
 
+static int32_t posix_aload(
+    const int32_t *count)
+{
+    int32_t value;
+#ifdef __GNUC__
+    value = __atomic_load_n(count, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *count;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void* posix_aloadp(
+    void *const *ptr)
+{
+    void *value;
+#ifdef __GNUC__
+    value = __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *ptr;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void posix_astorep(
+    void **ptr,
+    void *value)
+{
+#ifdef __GNUC__
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    *ptr = value;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+#endif
+}
+
 static ecs_os_mutex_t posix_mutex_new(void) {
     pthread_mutex_t *mutex = ecs_os_malloc(sizeof(pthread_mutex_t));
     if (pthread_mutex_init(mutex, NULL)) {
@@ -62653,6 +67834,66 @@ static void posix_dlclose(ecs_os_dl_t lib) {
     dlclose((void*)(uintptr_t)lib);
 }
 
+#ifndef __EMSCRIPTEN__
+static uintptr_t posix_vm_page_size(void) {
+    static uintptr_t page_size = 0;
+    if (!page_size) {
+        long result = sysconf(_SC_PAGESIZE);
+        page_size = result > 0 ? (uintptr_t)result : 4096;
+    }
+    return page_size;
+}
+
+static void* posix_reserve(
+    ecs_size_t size)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void *result = mmap(NULL, (size_t)size, PROT_NONE, flags, -1, 0);
+    if (result == MAP_FAILED) {
+        return NULL;
+    }
+    return result;
+}
+
+/* Commit rounds the range outwards to page boundaries, so that all bytes in the
+ * requested range are accessible. */
+static bool posix_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = (uintptr_t)ptr & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size + page_size - 1) & 
+        ~(page_size - 1);
+    return mprotect((void*)start, end - start, PROT_READ | PROT_WRITE) == 0;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void posix_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        madvise((void*)start, end - start, MADV_DONTNEED);
+        mprotect((void*)start, end - start, PROT_NONE);
+    }
+}
+
+static void posix_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    munmap(ptr, (size_t)size);
+}
+#endif
+
 void ecs_set_os_api_impl(void) {
     ecs_os_set_api_defaults();
 
@@ -62661,12 +67902,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = posix_thread_new;
     api.thread_join_ = posix_thread_join;
     api.thread_self_ = posix_thread_self;
-    api.task_new_ = posix_thread_new;
-    api.task_join_ = posix_thread_join;
+    api.thread_set_affinity_ = posix_thread_set_affinity;
+    api.task_new_ = posix_task_new;
+    api.task_join_ = posix_task_join;
     api.ainc_ = posix_ainc;
     api.adec_ = posix_adec;
     api.lainc_ = posix_lainc;
     api.ladec_ = posix_ladec;
+    api.aload_ = posix_aload;
+    api.aloadp_ = posix_aloadp;
+    api.astorep_ = posix_astorep;
     api.mutex_new_ = posix_mutex_new;
     api.mutex_free_ = posix_mutex_free;
     api.mutex_lock_ = posix_mutex_lock;
@@ -62681,6 +67926,19 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = posix_dlopen;
     api.dlproc_ = posix_dlproc;
     api.dlclose_ = posix_dlclose;
+#ifndef __EMSCRIPTEN__
+    api.reserve_ = posix_reserve;
+    api.commit_ = posix_commit;
+    api.decommit_ = posix_decommit;
+    api.release_ = posix_release;
+#endif
+
+    /* Chain the fini callback of a previously set OS API, unless this is the
+     * callback of the task pool itself. */
+    if (api.fini_ != posix_task_pool_fini) {
+        posix_task_pool.prev_fini = api.fini_;
+        api.fini_ = posix_task_pool_fini;
+    }
 
     posix_time_setup();
 
@@ -64136,6 +69394,13 @@ static void flecs_pipeline_state_free(
         ecs_allocator_t *a = &world->allocator;
         ecs_vec_fini_t(a, &p->ops, ecs_pipeline_op_t);
         ecs_vec_fini_t(a, &p->systems, ecs_system_t*);
+        ecs_vec_fini_t(a, &p->matched, ecs_pipeline_match_t);
+        ecs_vec_fini_t(a, &p->nodes, ecs_pipeline_node_t);
+        ecs_vec_fini_t(a, &p->deps, int32_t);
+        flecs_worker_tasks_fini(p);
+        flecs_pipeline_snapshot_clear(p);
+        ecs_vec_fini_t(NULL, &p->snapshots, ecs_pipeline_snapshot_t);
+        ecs_vec_fini_t(NULL, &p->snapshot_data, char);
         ecs_os_free(p);
     }
 }
@@ -64329,163 +69594,436 @@ static bool flecs_pipeline_check_term(
         }
     }
 
-    return false;
+    return false;
+}
+
+static bool flecs_pipeline_check_terms(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    bool is_active,
+    ecs_write_state_t *ws)
+{
+    bool needs_merge = false;
+    ecs_term_t *terms = query->terms;
+    int32_t t, term_count = query->term_count;
+
+    /* Check This terms first. This way if a term indicating writing to a stage
+     * was added before a This term, it won't cause merging. */
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &terms[t];
+        if (ecs_term_match_this(term)) {
+            needs_merge |= flecs_pipeline_check_term(world, term, is_active, ws);
+        }
+    }
+
+    /* Now check non-$this terms */
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &terms[t];
+        if (!ecs_term_match_this(term)) {
+            needs_merge |= flecs_pipeline_check_term(world, term, is_active, ws);
+        }
+    }
+
+    return needs_merge;
+}
+
+static EcsPoly* flecs_pipeline_term_system(
+    ecs_iter_t *it)
+{
+    int32_t index = ecs_table_get_column_index(
+        it->real_world, it->table, flecs_poly_id(EcsSystem));
+    ecs_assert(index != -1, ECS_INTERNAL_ERROR, NULL);
+    EcsPoly *poly = ecs_table_get_column(it->table, index, it->offset);
+    ecs_assert(poly != NULL, ECS_INTERNAL_ERROR, NULL);
+    return poly;
+}
+
+/* Component access of a system, used to build the dependency graph */
+typedef struct ecs_pipeline_access_t {
+    ecs_id_t id;
+    bool write;
+} ecs_pipeline_access_t;
+
+static void flecs_pipeline_get_access(
+    ecs_allocator_t *a,
+    const ecs_query_t *query,
+    ecs_vec_t *access)
+{
+    ecs_term_t *terms = query->terms;
+    int32_t t, term_count = query->term_count;
+
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &terms[t];
+        int16_t inout = term->inout;
+        if (inout == EcsInOutFilter || inout == EcsInOutNone) {
+            continue;
+        }
+
+        bool from_any = ecs_term_match_0(term);
+        bool from_this = ecs_term_match_this(term);
+        bool is_shared = !from_any && 
+            (!from_this || !(term->src.id & EcsSelf));
+
+        /* Same defaults as flecs_pipeline_check_term */
+        if (inout == EcsInOutDefault) {
+            if (from_any) {
+                continue;
+            } else if (is_shared) {
+                inout = EcsIn;
+            } else {
+                inout = EcsInOut;
+            }
+        }
+
+        ecs_pipeline_access_t *elem = ecs_vec_append_t(
+            a, access, ecs_pipeline_access_t);
+        elem->id = term->id;
+        elem->write = inout != EcsIn;
+    }
+}
+
+static bool flecs_pipeline_id_overlaps(
+    ecs_id_t a,
+    ecs_id_t b)
+{
+    if (a == b || a == EcsWildcard || b == EcsWildcard) {
+        return true;
+    }
+    return ecs_id_match(a, b) || ecs_id_match(b, a);
+}
+
+/* Two systems conflict if one of them writes a component that the other one
+ * reads or writes. Systems without terms could access anything. */
+static bool flecs_pipeline_access_conflicts(
+    const ecs_pipeline_access_t *a,
+    int32_t a_count,
+    const ecs_pipeline_access_t *b,
+    int32_t b_count)
+{
+    if (!a_count || !b_count) {
+        return true;
+    }
+
+    int32_t i, j;
+    for (i = 0; i < a_count; i ++) {
+        for (j = 0; j < b_count; j ++) {
+            if (!a[i].write && !b[j].write) {
+                continue;
+            }
+            if (flecs_pipeline_id_overlaps(a[i].id, b[j].id)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/* Add dependencies for the systems in a multithreaded op. Systems in the same
+ * op that don't conflict can run at the same time. */
+static void flecs_pipeline_build_op_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_op_t *op,
+    ecs_vec_t *access)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t i, first = op->offset, count = op->count;
+
+    ecs_vec_clear(access);
+    int32_t *access_offsets = flecs_alloc_n(a, int32_t, count + 1);
+    for (i = 0; i < count; i ++) {
+        access_offsets[i] = ecs_vec_count(access);
+        flecs_pipeline_get_access(a, systems[first + i]->query, access);
+    }
+    access_offsets[count] = ecs_vec_count(access);
+
+    ecs_pipeline_access_t *acc = ecs_vec_first_t(
+        access, ecs_pipeline_access_t);
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_node_t *node = &nodes[first + i];
+        node->dep_offset = ecs_vec_count(&pq->deps);
+
+        int32_t j;
+        for (j = 0; j < i; j ++) {
+            if (flecs_pipeline_access_conflicts(
+                &acc[access_offsets[i]], 
+                access_offsets[i + 1] - access_offsets[i],
+                &acc[access_offsets[j]], 
+                access_offsets[j + 1] - access_offsets[j]))
+            {
+                ecs_vec_append_t(a, &pq->deps, int32_t)[0] = first + j;
+                nodes[first + j].notify = true;
+                node->dep_count ++;
+            }
+        }
+    }
+
+    flecs_free_n(a, int32_t, count + 1, access_offsets);
+}
+
+/* Copy the dependencies of an op that didn't change from the graph of the 
+ * previous schedule. The systems of the op moved by shift. */
+static void flecs_pipeline_copy_op_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_op_t *op,
+    const ecs_vec_t *prev_nodes,
+    const ecs_vec_t *prev_deps,
+    int32_t shift)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    const ecs_pipeline_node_t *src_nodes = ecs_vec_first_t(
+        prev_nodes, ecs_pipeline_node_t);
+    const int32_t *src_deps = ecs_vec_first_t(prev_deps, int32_t);
+    int32_t i, last = op->offset + op->count;
+
+    for (i = op->offset; i < last; i ++) {
+        const ecs_pipeline_node_t *src = &src_nodes[i - shift];
+        ecs_pipeline_node_t *node = &nodes[i];
+        node->dep_offset = ecs_vec_count(&pq->deps);
+        node->dep_count = src->dep_count;
+        node->notify = src->notify;
+
+        int32_t d;
+        for (d = 0; d < src->dep_count; d ++) {
+            ecs_vec_append_t(a, &pq->deps, int32_t)[0] = 
+                src_deps[src->dep_offset + d] + shift;
+        }
+    }
+}
+
+/* Build the dependency graph for the systems in multithreaded ops. When the
+ * schedule was patched, only the graph of the ops in the patched range is
+ * built, and the graph of the other ops is copied from the previous graph. */
+static void flecs_pipeline_build_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t patch_first,
+    int32_t patch_last,
+    int32_t shift)
+{
+    ecs_allocator_t *a = &world->allocator;
+    int32_t count = ecs_vec_count(&pq->systems);
+
+    ecs_vec_t prev_nodes = pq->nodes, prev_deps = pq->deps;
+    ecs_vec_init_t(a, &pq->nodes, ecs_pipeline_node_t, count);
+    ecs_vec_init_t(a, &pq->deps, int32_t, ecs_vec_count(&prev_deps));
+    ecs_vec_set_min_count_zeromem_t(a, &pq->nodes, ecs_pipeline_node_t, count);
+
+    ecs_vec_t access;
+    ecs_vec_init_t(a, &access, ecs_pipeline_access_t, 0);
+
+    ecs_pipeline_op_t *ops = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
+    int32_t o, op_count = ecs_vec_count(&pq->ops);
+    for (o = 0; o < op_count; o ++) {
+        ecs_pipeline_op_t *op = &ops[o];
+        if (!op->multi_threaded) {
+            continue;
+        }
+
+        if (o < patch_first) {
+            flecs_pipeline_copy_op_graph(
+                world, pq, op, &prev_nodes, &prev_deps, 0);
+        } else if (o >= patch_last) {
+            flecs_pipeline_copy_op_graph(
+                world, pq, op, &prev_nodes, &prev_deps, shift);
+        } else {
+            flecs_pipeline_build_op_graph(world, pq, op, &access);
+        }
+    }
+
+    ecs_vec_fini_t(a, &access, ecs_pipeline_access_t);
+    ecs_vec_fini_t(a, &prev_nodes, ecs_pipeline_node_t);
+    ecs_vec_fini_t(a, &prev_deps, int32_t);
 }
 
-static bool flecs_pipeline_check_terms(
+/* Get systems matched by the pipeline query, in the order they are run */
+static void flecs_pipeline_get_matched(
     ecs_world_t *world,
-    ecs_query_t *query,
-    bool is_active,
-    ecs_write_state_t *ws)
+    ecs_iter_t *it,
+    ecs_vec_t *matched)
 {
-    bool needs_merge = false;
-    ecs_term_t *terms = query->terms;
-    int32_t t, term_count = query->term_count;
-
-    /* Check This terms first. This way if a term indicating writing to a stage
-     * was added before a This term, it won't cause merging. */
-    for (t = 0; t < term_count; t ++) {
-        ecs_term_t *term = &terms[t];
-        if (ecs_term_match_this(term)) {
-            needs_merge |= flecs_pipeline_check_term(world, term, is_active, ws);
-        }
-    }
+    ecs_allocator_t *a = &world->allocator;
+    while (ecs_query_next(it)) {
+        EcsPoly *poly = flecs_pipeline_term_system(it);
+        bool is_active = ecs_table_get_type_index(
+            world, it->table, EcsEmpty) == -1;
 
-    /* Now check non-$this terms */
-    for (t = 0; t < term_count; t ++) {
-        ecs_term_t *term = &terms[t];
-        if (!ecs_term_match_this(term)) {
-            needs_merge |= flecs_pipeline_check_term(world, term, is_active, ws);
+        int32_t i;
+        for (i = 0; i < it->count; i ++) {
+            flecs_poly_assert(poly[i].poly, ecs_system_t);
+            ecs_system_t *sys = (ecs_system_t*)poly[i].poly;
+            ecs_pipeline_match_t *m = ecs_vec_append_t(
+                a, matched, ecs_pipeline_match_t);
+            m->system = sys;
+            m->query = sys->query;
+            m->active = is_active;
+            m->multi_threaded = sys->multi_threaded;
+            m->immediate = sys->immediate;
+            m->pipelined = sys->pipelined;
         }
     }
-
-    return needs_merge;
 }
 
-static EcsPoly* flecs_pipeline_term_system(
-    ecs_iter_t *it)
+static bool flecs_pipeline_match_equals(
+    const ecs_pipeline_match_t *a,
+    const ecs_pipeline_match_t *b)
 {
-    int32_t index = ecs_table_get_column_index(
-        it->real_world, it->table, flecs_poly_id(EcsSystem));
-    ecs_assert(index != -1, ECS_INTERNAL_ERROR, NULL);
-    EcsPoly *poly = ecs_table_get_column(it->table, index, it->offset);
-    ecs_assert(poly != NULL, ECS_INTERNAL_ERROR, NULL);
-    return poly;
+    return a->system == b->system && a->query == b->query &&
+        a->active == b->active && a->multi_threaded == b->multi_threaded &&
+        a->immediate == b->immediate && a->pipelined == b->pipelined;
 }
 
-static bool flecs_pipeline_build(
+/* Add ops for the matched systems, starting at the specified system. 
+ *
+ * The state of the schedule right after the first system of an op is added 
+ * only depends on that system, as merging resets the write state. This means
+ * that if an op starts at the same system as an op of the previous schedule,
+ * the remaining ops are the same as the ops of the previous schedule. When 
+ * that happens the scan stops, and the index of the op of the previous 
+ * schedule is returned. If the scan reaches the end, -1 is returned. */
+static int32_t flecs_pipeline_schedule(
     ecs_world_t *world,
-    ecs_pipeline_state_t *pq)
+    ecs_pipeline_state_t *pq,
+    int32_t first_match,
+    const ecs_pipeline_op_t *prev_ops,
+    int32_t prev_op_count,
+    int32_t sync_match,
+    int32_t match_shift)
 {
-    ecs_iter_t it = ecs_query_iter(world, pq->query);
-
-    int32_t new_match_count = ecs_query_match_count(pq->query);
-    if (pq->match_count == new_match_count) {
-        /* No need to rebuild the pipeline */
-        ecs_iter_fini(&it);
-        return false;
-    }
-
-    world->info.pipeline_build_count_total ++;
-    pq->rebuild_count ++;
-
     ecs_allocator_t *a = &world->allocator;
     ecs_pipeline_op_t *op = NULL;
     ecs_write_state_t ws = {0};
     ecs_map_init(&ws.ids, a);
     ecs_map_init(&ws.wildcard_ids, a);
 
-    ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
-    ecs_vec_reset_t(a, &pq->systems, ecs_system_t*);
-
     bool multi_threaded = false;
     bool immediate = false;
+    bool pipelined = false;
     bool first = true;
+    int32_t result = -1, prev_op = 0;
 
-    /* Iterate systems in pipeline, add ops for running / merging */
-    while (ecs_query_next(&it)) {
-        EcsPoly *poly = flecs_pipeline_term_system(&it);
-        bool is_active = ecs_table_get_type_index(
-            world, it.table, EcsEmpty) == -1;
-
-        int32_t i;
-        for (i = 0; i < it.count; i ++) {
-            flecs_poly_assert(poly[i].poly, ecs_system_t);
-            ecs_system_t *sys = (ecs_system_t*)poly[i].poly;
-            ecs_query_t *q = sys->query;
+    ecs_pipeline_match_t *matched = ecs_vec_first_t(
+        &pq->matched, ecs_pipeline_match_t);
+    int32_t i, count = ecs_vec_count(&pq->matched);
 
-            bool needs_merge = false;
-            needs_merge = flecs_pipeline_check_terms(
-                world, q, is_active, &ws);
+    /* Iterate systems in pipeline, add ops for running / merging */
+    for (i = first_match; i < count; i ++) {
+        ecs_system_t *sys = matched[i].system;
+        ecs_query_t *q = sys->query;
+        bool is_active = matched[i].active;
 
-            if (is_active) {
-                if (first) {
-                    multi_threaded = sys->multi_threaded;
-                    immediate = sys->immediate;
-                    first = false;
-                }
+        bool needs_merge = false;
+        needs_merge = flecs_pipeline_check_terms(
+            world, q, is_active, &ws);
 
-                if (sys->multi_threaded != multi_threaded) {
-                    needs_merge = true;
-                    multi_threaded = sys->multi_threaded;
-                }
-                if (sys->immediate != immediate) {
-                    needs_merge = true;
-                    immediate = sys->immediate;
-                }
+        if (is_active) {
+            if (first) {
+                multi_threaded = sys->multi_threaded;
+                immediate = sys->immediate;
+                pipelined = sys->pipelined;
+                first = false;
             }
 
-            if (immediate) {
+            if (sys->multi_threaded != multi_threaded) {
+                needs_merge = true;
+                multi_threaded = sys->multi_threaded;
+            }
+            if (sys->immediate != immediate) {
                 needs_merge = true;
+                immediate = sys->immediate;
             }
+            if (sys->pipelined != pipelined) {
+                needs_merge = true;
+                pipelined = sys->pipelined;
+            }
+        }
 
-            if (needs_merge) {
-                /* After merge all components will be merged, so reset state */
-                flecs_pipeline_reset_write_state(&ws);
+        if (immediate) {
+            needs_merge = true;
+        }
 
-                /* An inactive system can insert a merge if one of its 
-                 * components got written, which could make the system 
-                 * active. If this is the only system in the pipeline operation,
-                 * it results in an empty operation when we get here. If that's
-                 * the case, reuse the empty operation for the next op. */
-                if (op && op->count) {
-                    op = NULL;
-                }
+        if (needs_merge) {
+            /* After merge all components will be merged, so reset state */
+            flecs_pipeline_reset_write_state(&ws);
 
-                /* Re-evaluate columns to set write flags if system is active.
-                 * If system is inactive, it can't write anything and so it
-                 * should not insert unnecessary merges.  */
-                needs_merge = false;
-                if (is_active) {
-                    needs_merge = flecs_pipeline_check_terms(
-                        world, q, true, &ws);
-                }
+            /* An inactive system can insert a merge if one of its 
+             * components got written, which could make the system 
+             * active. If this is the only system in the pipeline operation,
+             * it results in an empty operation when we get here. If that's
+             * the case, reuse the empty operation for the next op. */
+            if (op && op->count) {
+                op = NULL;
+            }
 
-                /* The component states were just reset, so if we conclude that
-                 * another merge is needed something is wrong. */
-                ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+            /* Re-evaluate columns to set write flags if system is active.
+             * If system is inactive, it can't write anything and so it
+             * should not insert unnecessary merges.  */
+            needs_merge = false;
+            if (is_active) {
+                needs_merge = flecs_pipeline_check_terms(
+                    world, q, true, &ws);
             }
 
-            if (!op) {
-                op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
-                op->offset = ecs_vec_count(&pq->systems);
-                op->count = 0;
-                op->multi_threaded = false;
-                op->immediate = false;
-                op->time_spent = 0;
-                op->commands_enqueued = 0;
+            /* The component states were just reset, so if we conclude that
+             * another merge is needed something is wrong. */
+            ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+        }
+
+        /* If the system starts an op in both the new and the previous 
+         * schedule, the rest of the schedule is the same. */
+        if (is_active && (!op || !op->count) && i >= sync_match) {
+            while (prev_op < prev_op_count && 
+                prev_ops[prev_op].match_offset < (i - match_shift)) 
+            {
+                prev_op ++;
             }
 
-            /* Don't increase count for inactive systems, as they are ignored by
-             * the query used to run the pipeline. */
-            if (is_active) {
-                ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = sys;
-                if (!op->count) {
-                    op->multi_threaded = multi_threaded;
-                    op->immediate = immediate;
+            if (prev_op < prev_op_count && 
+                prev_ops[prev_op].match_offset == (i - match_shift)) 
+            {
+                if (op) {
+                    ecs_vec_remove_last(&pq->ops);
                 }
-                op->count ++;
+                result = prev_op;
+                op = NULL;
+                break;
+            }
+        }
+
+        if (!op) {
+            op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
+            op->offset = ecs_vec_count(&pq->systems);
+            op->match_offset = i;
+            op->count = 0;
+            op->multi_threaded = false;
+            op->immediate = false;
+            op->pipelined = false;
+            op->time_spent = 0;
+            op->commands_enqueued = 0;
+            op->wait_time = 0;
+            op->worker_count = 0;
+            ecs_os_memset_n(op->wait_histogram, 0, int64_t, 
+                FLECS_SYNC_WAIT_BUCKETS);
+        }
+
+        /* Don't increase count for inactive systems, as they are ignored by
+         * the query used to run the pipeline. */
+        if (is_active) {
+            ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = sys;
+            if (!op->count) {
+                op->multi_threaded = multi_threaded;
+                op->immediate = immediate;
+                op->pipelined = pipelined;
+                op->match_offset = i;
             }
+            op->count ++;
         }
     }
 
@@ -64496,6 +70034,141 @@ static bool flecs_pipeline_build(
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
 
+    return result;
+}
+
+static bool flecs_pipeline_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_iter_t it = ecs_query_iter(world, pq->query);
+
+    int32_t new_match_count = ecs_query_match_count(pq->query);
+    if (pq->match_count == new_match_count) {
+        /* No need to rebuild the pipeline */
+        ecs_iter_fini(&it);
+        return false;
+    }
+
+    world->info.pipeline_build_count_total ++;
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t prev_matched = pq->matched;
+    ecs_vec_init_t(a, &pq->matched, ecs_pipeline_match_t, 
+        ecs_vec_count(&prev_matched));
+    flecs_pipeline_get_matched(world, &it, &pq->matched);
+
+    /* Find the range of systems that changed since the previous build */
+    ecs_pipeline_match_t *prev = ecs_vec_first_t(
+        &prev_matched, ecs_pipeline_match_t);
+    ecs_pipeline_match_t *cur = ecs_vec_first_t(
+        &pq->matched, ecs_pipeline_match_t);
+    int32_t prev_count = ecs_vec_count(&prev_matched);
+    int32_t cur_count = ecs_vec_count(&pq->matched);
+    int32_t min_count = prev_count < cur_count ? prev_count : cur_count;
+    int32_t changed = 0, unchanged_tail = 0;
+    while (changed < min_count && 
+        flecs_pipeline_match_equals(&prev[changed], &cur[changed])) 
+    {
+        changed ++;
+    }
+    while (unchanged_tail < (min_count - changed) && 
+        flecs_pipeline_match_equals(&prev[prev_count - unchanged_tail - 1],
+            &cur[cur_count - unchanged_tail - 1]))
+    {
+        unchanged_tail ++;
+    }
+
+    ecs_vec_fini_t(a, &prev_matched, ecs_pipeline_match_t);
+
+    /* Keep the ops that end before the first changed system. The last of 
+     * these ops could absorb systems that were added after it, so the schedule
+     * is rebuilt starting from that op. */
+    ecs_pipeline_op_t *ops = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
+    int32_t op_count = ecs_vec_count(&pq->ops);
+    int32_t patch_first = op_count, first_match = 0, first_system = 0;
+    while (patch_first > 0 && ops[patch_first - 1].match_offset >= changed) {
+        patch_first --;
+    }
+    if (patch_first > 0) {
+        patch_first --;
+        first_match = ops[patch_first].match_offset;
+        first_system = ops[patch_first].offset;
+    }
+
+    /* Move ops and systems that come after the kept ops out of the schedule,
+     * so they can be reused if the rest of the schedule didn't change. */
+    ecs_vec_t prev_ops, prev_systems;
+    ecs_vec_init_t(a, &prev_ops, ecs_pipeline_op_t, op_count - patch_first);
+    ecs_vec_init_t(a, &prev_systems, ecs_system_t*, 
+        ecs_vec_count(&pq->systems) - first_system);
+    int32_t i;
+    for (i = patch_first; i < op_count; i ++) {
+        ecs_vec_append_t(a, &prev_ops, ecs_pipeline_op_t)[0] = ops[i];
+    }
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    for (i = first_system; i < ecs_vec_count(&pq->systems); i ++) {
+        ecs_vec_append_t(a, &prev_systems, ecs_system_t*)[0] = systems[i];
+    }
+    ecs_vec_set_count_t(a, &pq->ops, ecs_pipeline_op_t, patch_first);
+    ecs_vec_set_count_t(a, &pq->systems, ecs_system_t*, first_system);
+
+    int32_t match_shift = cur_count - prev_count;
+    int32_t sync_op = flecs_pipeline_schedule(world, pq, first_match, 
+        ecs_vec_first_t(&prev_ops, ecs_pipeline_op_t), 
+        ecs_vec_count(&prev_ops), cur_count - unchanged_tail, match_shift);
+
+    int32_t patch_last = ecs_vec_count(&pq->ops), shift = 0;
+    if (sync_op != -1) {
+        /* Reuse the remaining ops of the previous schedule */
+        ecs_pipeline_op_t *prev_op = ecs_vec_get_t(
+            &prev_ops, ecs_pipeline_op_t, sync_op);
+        ecs_system_t **prev_sys = ecs_vec_first_t(
+            &prev_systems, ecs_system_t*);
+        int32_t prev_first_system = prev_op->offset;
+        shift = ecs_vec_count(&pq->systems) - prev_first_system;
+
+        for (i = sync_op; i < ecs_vec_count(&prev_ops); i ++, prev_op ++) {
+            ecs_pipeline_op_t *op = ecs_vec_append_t(
+                a, &pq->ops, ecs_pipeline_op_t);
+            *op = *prev_op;
+            op->offset += shift;
+            op->match_offset += match_shift;
+        }
+
+        int32_t prev_system_count = ecs_vec_count(&prev_systems);
+        for (i = prev_first_system - first_system; 
+            i < prev_system_count; i ++) 
+        {
+            ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = prev_sys[i];
+        }
+    }
+
+    ecs_vec_fini_t(a, &prev_ops, ecs_pipeline_op_t);
+    ecs_vec_fini_t(a, &prev_systems, ecs_system_t*);
+
+    if (patch_first || sync_op != -1) {
+        pq->patch_count ++;
+    } else {
+        pq->rebuild_count ++;
+        patch_last = ecs_vec_count(&pq->ops);
+    }
+
+    flecs_pipeline_build_graph(world, pq, patch_first, patch_last, shift);
+
+    /* Ops at the end of the pipeline with only pipelined systems can overlap
+     * with the next frame when pipelined frame execution is enabled. */
+    pq->tail_offset = ecs_vec_count(&pq->systems);
+    ecs_pipeline_op_t *op;
+    int32_t op_i;
+    for (op_i = ecs_vec_count(&pq->ops) - 1; op_i >= 0; op_i --) {
+        op = ecs_vec_get_t(&pq->ops, ecs_pipeline_op_t, op_i);
+        if (!op->pipelined) {
+            break;
+        }
+        pq->tail_offset = op->offset;
+    }
+
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
     if (!op) {
@@ -64510,9 +70183,9 @@ static bool flecs_pipeline_build(
             op->multi_threaded, !op->immediate);
         ecs_log_push_1();
 
-        int32_t i, count = ecs_vec_count(&pq->systems);
+        int32_t count = ecs_vec_count(&pq->systems);
         int32_t op_index = 0, ran_since_merge = 0;
-        ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+        systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
         for (i = 0; i < count; i ++) {
             ecs_system_t *sys = systems[i];
             ecs_entity_t system = sys->query->entity;
@@ -64617,6 +70290,8 @@ static bool flecs_pipeline_update(
     ecs_assert(pq->query != NULL, ECS_INTERNAL_ERROR, NULL);
 
     bool rebuilt = flecs_pipeline_build(world, pq);
+    flecs_worker_tasks_update(world, pq);
+
     if (start_of_frame) {
         pq->cur_op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
         pq->cur_i = 0;
@@ -64651,6 +70326,114 @@ void ecs_run_pipeline(
     }
 }
 
+/* Update the estimated time per entity of a system. The time is measured on a 
+ * single thread that processed its share of the entities of the system. */
+static void flecs_pipeline_system_cost(
+    ecs_system_t *sys,
+    double time_spent,
+    int32_t worker_count,
+    ecs_ftime_t weight)
+{
+    if (!sys->matched_count) {
+        return;
+    }
+
+    ecs_ftime_t cost = (ecs_ftime_t)(time_spent * worker_count / 
+        sys->matched_count);
+    if (sys->cost_per_entity == 0) {
+        sys->cost_per_entity = cost;
+    } else {
+        /* Moving average, so a single slow frame doesn't change the number of
+         * threads for the next frames. */
+        sys->cost_per_entity += (cost - sys->cost_per_entity) * weight;
+    }
+}
+
+/* Select the number of threads for a multithreaded op from the estimated cost
+ * of its systems, so that each thread gets at least the minimum cost. The 
+ * number of matched entities is estimated from the tables in the query cache,
+ * so this doesn't evaluate the queries of the systems. Because the cost per 
+ * entity is measured against the same estimate, an estimate that is too high 
+ * for uncached queries doesn't change the predicted time. */
+static int32_t flecs_pipeline_op_worker_count(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t stage_count)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, last = op->offset + op->count;
+    double cost = 0;
+    bool estimated = true;
+
+    for (i = pq->cur_i; i < last; i ++) {
+        ecs_system_t *sys = systems[i];
+        sys->matched_count = flecs_query_entity_count_estimate(sys->query);
+        if (sys->matched_count && sys->cost_per_entity == 0) {
+            /* System hasn't run yet, use all threads to measure cost */
+            estimated = false;
+        }
+        cost += (double)sys->cost_per_entity * sys->matched_count;
+    }
+
+    if (!estimated) {
+        return stage_count;
+    }
+
+    double worker_count = cost / (double)world->worker_min_cost;
+    if (worker_count < 1) {
+        return 1;
+    }
+    if (worker_count >= stage_count) {
+        return stage_count;
+    }
+    return (int32_t)worker_count;
+}
+
+/* Run the systems of a multithreaded op as a dependency graph. Workers claim
+ * systems in schedule order, wait until the systems they depend on have 
+ * finished, and run each system on all of its matched entities. */
+static int32_t flecs_run_pipeline_graph(
+    ecs_world_t* world,
+    ecs_stage_t* stage,
+    int32_t stage_index,
+    ecs_ftime_t delta_time)
+{
+    ecs_pipeline_state_t* pq = world->pq;
+    ecs_pipeline_op_t* op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, last = op->offset + op->count - 1;
+    bool measure_cost = world->worker_min_cost > 0;
+
+    while ((i = ecs_os_ainc(&pq->next_system) - 1) <= last) {
+        ecs_system_t* sys = systems[i];
+        sys->last_frame = world->info.frame_count_total + 1;
+
+        flecs_wait_for_system_deps(world, pq, i, 1);
+
+        ecs_time_t t = { 0 };
+        if (measure_cost) {
+            ecs_time_measure(&t);
+        }
+
+        flecs_run_system(world, stage, sys->query->entity, sys, stage_index,
+            1, delta_time, NULL, NULL, NULL);
+
+        if (measure_cost) {
+            /* System is claimed by a single thread, so only this thread 
+             * writes to the cost of the system. */
+            flecs_pipeline_system_cost(sys, ecs_time_measure(&t), 1,
+                world->worker_cost_weight);
+        }
+
+        flecs_signal_system_done(world, pq, i);
+
+        ecs_os_linc(&world->info.systems_ran_total);
+    }
+
+    return last;
+}
+
 int32_t flecs_run_pipeline_ops(
     ecs_world_t* world,
     ecs_stage_t* stage,
@@ -64664,9 +70447,43 @@ int32_t flecs_run_pipeline_ops(
 
     ecs_assert(!stage_index || op->multi_threaded, ECS_INTERNAL_ERROR, NULL);
 
+    /* Threads that aren't selected for the op don't run anything */
+    if (op->multi_threaded) {
+        if (stage_index >= pq->worker_count) {
+            return i;
+        }
+        stage_count = pq->worker_count;
+    }
+
+    /* Run pipelined systems of the previous frame */
+    if (pq->run_snapshots) {
+        bool workers = op->multi_threaded && world->worker_cond;
+        flecs_pipeline_snapshot_run(world, pq, stage, stage_index, 
+            workers ? stage_count : 1);
+    }
+
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
     int32_t ran_since_merge = i - op->offset;
+    bool measure_cost = !stage_index && op->multi_threaded && 
+        world->worker_min_cost > 0;
+
+    /* If work stealing is enabled, divide the work of multithreaded systems
+     * with tasks that can be claimed by any worker. */
+    ecs_worker_tasks_t *tasks = NULL;
+    if (stage_count > 1 && op->multi_threaded && world->worker_cond) {
+        if ((world->flags & EcsWorldDagScheduling) && !op->immediate &&
+            op->count > 1)
+        {
+            return flecs_run_pipeline_graph(
+                world, stage, stage_index, delta_time);
+        }
+
+        if (world->flags & EcsWorldWorkStealing) {
+            tasks = ecs_vec_first_t(&pq->tasks, ecs_worker_tasks_t);
+            ecs_assert(tasks != NULL, ECS_INTERNAL_ERROR, NULL);
+        }
+    }
 
     for (; i < count; i++) {
         ecs_system_t* sys = systems[i];
@@ -64685,8 +70502,28 @@ int32_t flecs_run_pipeline_ops(
             s = stage;
         }
 
-        flecs_run_system(world, s, sys->query->entity, sys, stage_index,
-            stage_count, delta_time, NULL);
+        ecs_time_t t = { 0 };
+        if (measure_cost) {
+            ecs_time_measure(&t);
+        }
+
+        if (tasks) {
+            /* Chunks of a system don't line up with the chunks of the systems
+             * that ran before it, so wait for systems that it depends on. */
+            flecs_wait_for_system_deps(world, pq, i, stage_count);
+            flecs_run_system(world, s, sys->query->entity, sys, stage_index,
+                stage_count, delta_time, NULL, 
+                flecs_worker_steal_iter, &tasks[i]);
+            flecs_signal_system_done(world, pq, i);
+        } else {
+            flecs_run_system(world, s, sys->query->entity, sys, stage_index,
+                stage_count, delta_time, NULL, NULL, NULL);
+        }
+
+        if (measure_cost) {
+            flecs_pipeline_system_cost(sys, ecs_time_measure(&t), stage_count,
+                world->worker_cost_weight);
+        }
 
         ecs_os_linc(&world->info.systems_ran_total);
         ran_since_merge++;
@@ -64700,6 +70537,69 @@ int32_t flecs_run_pipeline_ops(
     return i;
 }
 
+/* Add time spent waiting for workers to the wait time histogram of an op */
+static void flecs_pipeline_op_record_wait(
+    ecs_pipeline_op_t *op,
+    double wait_time)
+{
+    int64_t us = (int64_t)(wait_time * 1000000.0);
+    int32_t bucket = 0;
+    while (us && bucket < (FLECS_SYNC_WAIT_BUCKETS - 1)) {
+        us >>= 1;
+        bucket ++;
+    }
+
+    op->wait_time += wait_time;
+    op->wait_histogram[bucket] ++;
+}
+
+/* Reset graph state before workers start running the current op */
+static void flecs_pipeline_reset_graph(
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t i, last = op->offset + op->count;
+    for (i = pq->cur_i; i < last; i ++) {
+        nodes[i].finished = 0;
+    }
+
+    pq->first_system = pq->cur_i;
+    pq->next_system = pq->cur_i;
+}
+
+/* Let workers apply commands that don't change tables before the command 
+ * queues are merged on the main thread. */
+static void flecs_run_pipeline_merge(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_count)
+{
+    if (!(world->flags & EcsWorldParallelMerge)) {
+        return;
+    }
+
+    /* Command capturing and exclusive world access both depend on commands
+     * being merged by a single thread. */
+    if (world->on_commands_active || world->exclusive_access) {
+        return;
+    }
+
+    /* Fall back to the serial merge if commands of one stage can affect the 
+     * entities of another stage. */
+    if (!flecs_commands_can_merge_inplace(world)) {
+        return;
+    }
+
+    pq->merging = true;
+    flecs_signal_workers(world, stage_count);
+    flecs_commands_merge_inplace(world, stage, 0, stage_count);
+    flecs_wait_for_sync(world);
+    pq->merging = false;
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -64720,10 +70620,22 @@ void flecs_run_pipeline(
 
     // Update the pipeline the workers will execute
     world->pq = pq;
+    pq->run_count ++;
 
     // Update the pipeline before waking the workers.
     flecs_pipeline_update(world, pq, true);
 
+    // Pipelined systems of the previous frame run during the first op.
+    bool pipelined = world->flags & EcsWorldPipelinedFrames;
+    if (ecs_vec_count(&pq->snapshots)) {
+        if (pipelined) {
+            flecs_pipeline_snapshot_filter(world, pq);
+            pq->run_snapshots = true;
+        } else {
+            flecs_pipeline_snapshot_flush(world, pq);
+        }
+    }
+
     // If there are no operations to execute in the pipeline bail early,
     // no need to wake the workers since they have nothing to do.
     while (pq->cur_op != NULL) {
@@ -64732,10 +70644,30 @@ void flecs_run_pipeline(
             continue;
         }
 
+        if (pipelined && pq->cur_i >= pq->tail_offset) {
+            // Copy data for the remaining systems, which will run during the
+            // first op of the next frame.
+            flecs_pipeline_snapshot_flush(world, pq);
+            flecs_pipeline_snapshot_create(world, pq, delta_time);
+            break;
+        }
+
         bool immediate = pq->cur_op->immediate;
         bool op_multi_threaded = multi_threaded && pq->cur_op->multi_threaded;
 
         pq->immediate = immediate;
+        pq->worker_count = stage_count;
+
+        if (op_multi_threaded && world->worker_min_cost > 0) {
+            pq->worker_count = flecs_pipeline_op_worker_count(
+                world, pq, stage_count);
+            if (pq->worker_count == 1) {
+                /* Not worth waking up the workers for */
+                op_multi_threaded = false;
+            }
+        }
+
+        pq->cur_op->worker_count = op_multi_threaded ? pq->worker_count : 1;
 
         if (!immediate) {
             ecs_readonly_begin(world, multi_threaded);
@@ -64747,7 +70679,9 @@ void flecs_run_pipeline(
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
-            flecs_signal_workers(world);
+            flecs_pipeline_reset_graph(pq);
+            flecs_worker_tasks_build(world, pq);
+            flecs_signal_workers(world, pq->worker_count);
         }
 
         ecs_time_t st = { 0 };
@@ -64765,7 +70699,17 @@ void flecs_run_pipeline(
         }
 
         if (op_multi_threaded) {
+            ecs_time_t wt = { 0 };
+            if (measure_time) {
+                ecs_time_measure(&wt);
+            }
+
             flecs_wait_for_sync(world);
+
+            if (measure_time) {
+                flecs_pipeline_op_record_wait(
+                    pq->cur_op, ecs_time_measure(&wt));
+            }
         }
 
         if (!immediate) {
@@ -64774,10 +70718,16 @@ void flecs_run_pipeline(
                 ecs_time_measure(&mt);
             }
 
-            int32_t si;
+            int32_t si, cmd_count = 0;
             for (si = 0; si < stage_count; si ++) {
                 ecs_stage_t *s = world->stages[si];
-                pq->cur_op->commands_enqueued += ecs_vec_count(&s->cmd->queue);
+                cmd_count += s->cmd->count;
+            }
+
+            pq->cur_op->commands_enqueued += cmd_count;
+
+            if (op_multi_threaded && cmd_count) {
+                flecs_run_pipeline_merge(world, pq, stage, stage_count);
             }
 
             ecs_readonly_end(world);
@@ -64788,12 +70738,21 @@ void flecs_run_pipeline(
             flecs_defer_end(world, stage);
         }
 
+        if (pq->run_snapshots) {
+            flecs_pipeline_snapshot_clear(pq);
+        }
+
         /* Store the current state of the schedule after we synchronized the
          * threads, to avoid race conditions. */
         pq->cur_i = i;
 
         flecs_pipeline_update(world, pq, false);
     }
+
+    // Pipeline had no ops to run pipelined systems of the previous frame
+    if (pq->run_snapshots) {
+        flecs_pipeline_snapshot_flush(world, pq);
+    }
 }
 
 static void flecs_run_startup_systems(
@@ -65016,127 +70975,634 @@ error:
     return 0;
 }
 
-/* -- Module implementation -- */
-
-static void FlecsPipelineFini(
+/* -- Module implementation -- */
+
+static void FlecsPipelineFini(
+    ecs_world_t *world,
+    void *ctx)
+{
+    (void)ctx;
+    if (ecs_get_stage_count(world)) {
+        ecs_set_threads(world, 0);
+    }
+
+    ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
+}
+
+#define flecs_bootstrap_phase(world, phase, depends_on)\
+    flecs_bootstrap_tag(world, phase);\
+    flecs_bootstrap_phase_(world, phase, depends_on)
+static void flecs_bootstrap_phase_(
+    ecs_world_t *world,
+    ecs_entity_t phase,
+    ecs_entity_t depends_on)
+{
+    ecs_add_id(world, phase, EcsPhase);
+    if (depends_on) {
+        ecs_add_pair(world, phase, EcsDependsOn, depends_on);
+    }
+}
+
+void FlecsPipelineImport(
+    ecs_world_t *world)
+{
+    ECS_MODULE(world, FlecsPipeline);
+    ECS_IMPORT(world, FlecsSystem);
+
+    ecs_set_name_prefix(world, "Ecs");
+
+    flecs_bootstrap_component(world, EcsPipeline);
+    flecs_bootstrap_tag(world, EcsPhase);
+
+    /* Create anonymous phases to which the builtin phases will have DependsOn 
+     * relationships. This ensures that, for example, EcsOnUpdate doesn't have a
+     * direct DependsOn relationship on EcsPreUpdate, which ensures that when
+     * the EcsPreUpdate phase is disabled, EcsOnUpdate still runs. */
+    ecs_entity_t phase_0 = ecs_entity(world, {0});
+    ecs_entity_t phase_1 = ecs_entity(world, {0});
+    ecs_entity_t phase_2 = ecs_entity(world, {0});
+    ecs_entity_t phase_3 = ecs_entity(world, {0});
+    ecs_entity_t phase_4 = ecs_entity(world, {0});
+    ecs_entity_t phase_5 = ecs_entity(world, {0});
+    ecs_entity_t phase_6 = ecs_entity(world, {0});
+    ecs_entity_t phase_7 = ecs_entity(world, {0});
+    ecs_entity_t phase_8 = ecs_entity(world, {0});
+
+    ecs_add_pair(world, phase_1, EcsDependsOn, phase_0);
+    ecs_add_pair(world, phase_2, EcsDependsOn, phase_1);
+    ecs_add_pair(world, phase_3, EcsDependsOn, phase_2);
+    ecs_add_pair(world, phase_4, EcsDependsOn, phase_3);
+    ecs_add_pair(world, phase_5, EcsDependsOn, phase_4);
+    ecs_add_pair(world, phase_6, EcsDependsOn, phase_5);
+    ecs_add_pair(world, phase_7, EcsDependsOn, phase_6);
+    ecs_add_pair(world, phase_8, EcsDependsOn, phase_7);
+
+    flecs_bootstrap_phase(world, EcsOnStart,    0);
+    flecs_bootstrap_phase(world, EcsPreFrame,   0);
+    flecs_bootstrap_phase(world, EcsOnLoad,     phase_0);
+    flecs_bootstrap_phase(world, EcsPostLoad,   phase_1);
+    flecs_bootstrap_phase(world, EcsPreUpdate,  phase_2);
+    flecs_bootstrap_phase(world, EcsOnUpdate,   phase_3);
+    flecs_bootstrap_phase(world, EcsOnValidate, phase_4);
+    flecs_bootstrap_phase(world, EcsPostUpdate, phase_5);
+    flecs_bootstrap_phase(world, EcsPreStore,   phase_6);
+    flecs_bootstrap_phase(world, EcsOnStore,    phase_7);
+    flecs_bootstrap_phase(world, EcsPostFrame,  phase_8);
+
+    ecs_set_hooks(world, EcsPipeline, {
+        .ctor = flecs_default_ctor,
+        .dtor = ecs_dtor(EcsPipeline),
+        .move = ecs_move(EcsPipeline)
+    });
+
+    world->pipeline = ecs_pipeline(world, {
+        .entity = ecs_entity(world, { .name = "BuiltinPipeline" }),
+        .query = {
+            .terms = {
+                { .id = EcsSystem },
+                { .id = EcsPhase, .src.id = EcsCascade, .trav = EcsDependsOn },
+                { .id = ecs_dependson(EcsOnStart), .src.id = EcsSelf|EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
+                { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
+                { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsChildOf, .oper = EcsNot }
+            },
+            .order_by_callback = flecs_entity_compare
+        }
+    });
+
+    world->worker_cost_weight = FLECS_WORKER_COST_WEIGHT;
+
+    /* Cleanup thread administration when world is destroyed */
+    ecs_atfini(world, FlecsPipelineFini, NULL);
+}
+
+#endif
+
+#ifdef FLECS_PIPELINE
+
+/* Only used by checks, which are compiled out in release builds */
+#if !defined(FLECS_NDEBUG) || defined(FLECS_KEEP_ASSERT)
+static bool flecs_pipeline_trivially_copyable(
+    const ecs_type_info_t *ti)
+{
+    return !(ti->hooks.flags & (ECS_TYPE_HOOK_COPY_CTOR |
+        ECS_TYPE_HOOK_COPY | ECS_TYPE_HOOK_DTOR));
+}
+#endif
+
+/* Allocate storage for a copied array in the snapshot data of the pipeline. 
+ * Returns the offset of the storage, as the snapshot data can be reallocated
+ * by the next allocation. */
+static int32_t flecs_pipeline_snapshot_alloc(
+    ecs_pipeline_state_t *pq,
+    ecs_size_t size)
+{
+    ecs_vec_t *data = &pq->snapshot_data;
+    int32_t offset = ECS_ALIGN(ecs_vec_count(data), ECS_SIZEOF(ecs_id_t) * 2);
+    ecs_vec_set_count_t(NULL, data, char, offset + size);
+    return offset;
+}
+
+static void* flecs_pipeline_snapshot_ptr(
+    const ecs_pipeline_state_t *pq,
+    int32_t offset)
+{
+    if (offset == -1) {
+        return NULL;
+    }
+    return ECS_OFFSET(ecs_vec_first(&pq->snapshot_data), offset);
+}
+
+static int32_t flecs_pipeline_snapshot_copy(
+    ecs_pipeline_state_t *pq,
+    const void *src,
+    ecs_size_t size)
+{
+    int32_t offset = flecs_pipeline_snapshot_alloc(pq, size);
+    ecs_os_memcpy(flecs_pipeline_snapshot_ptr(pq, offset), src, size);
+    return offset;
+}
+
+/* Copy field data of a result, so that the copy can be read while the next
+ * frame modifies the component. */
+static int32_t flecs_pipeline_snapshot_field(
+    ecs_pipeline_state_t *pq,
+    ecs_iter_t *it,
+    ecs_system_t *sys,
+    int8_t field)
+{
+    ecs_world_t *world = it->real_world;
+    ecs_size_t size = it->sizes[field];
+    if (!size || !ecs_field_is_set(it, field)) {
+        return -1;
+    }
+
+    ecs_entity_t component = ecs_get_typeid(world, it->ids[field]);
+    const ecs_type_info_t *ti = ecs_get_type_info(world, component);
+    ecs_check(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_check(ecs_field_is_readonly(it, field), ECS_INVALID_OPERATION,
+        "pipelined system '%s' can only read components", sys->name);
+    ecs_check(ecs_is_double_buffered(world, component), ECS_INVALID_OPERATION,
+        "pipelined system '%s' reads component '%s' that is not double "
+        "buffered", sys->name, ti->name);
+    ecs_check(flecs_pipeline_trivially_copyable(ti), ECS_INVALID_OPERATION,
+        "double buffered component '%s' has copy or dtor hooks", ti->name);
+    (void)ti;
+
+    int32_t i, count = ecs_field_is_self(it, field) ? it->count : 1;
+    int32_t result = flecs_pipeline_snapshot_alloc(pq, size * count);
+    void *dst = flecs_pipeline_snapshot_ptr(pq, result);
+
+    if (it->row_fields & (1llu << field)) {
+        for (i = 0; i < count; i ++) {
+            ecs_os_memcpy(ECS_ELEM(dst, size, i),
+                ecs_field_at_w_size(it, flecs_uto(size_t, size), field, i),
+                size);
+        }
+    } else {
+        ecs_os_memcpy(dst, ecs_field_w_size(
+            it, flecs_uto(size_t, size), field), size * count);
+    }
+
+    return result;
+error:
+    return -1;
+}
+
+static void flecs_pipeline_snapshot_result(
+    ecs_pipeline_state_t *pq,
+    ecs_iter_t *it,
+    ecs_system_t *sys,
+    ecs_ftime_t delta_time,
+    ecs_ftime_t delta_system_time)
+{
+    ecs_pipeline_snapshot_t *s = ecs_vec_append_t(
+        NULL, &pq->snapshots, ecs_pipeline_snapshot_t);
+    ecs_os_zeromem(s);
+
+    s->system = sys;
+    s->delta_time = delta_time;
+    s->delta_system_time = delta_system_time;
+    s->count = it->count;
+    s->set_fields = it->set_fields;
+    s->ref_fields = it->ref_fields;
+    s->up_fields = it->up_fields;
+    s->entities = -1;
+
+    if (it->count) {
+        s->entities = flecs_pipeline_snapshot_copy(pq, it->entities, 
+            ECS_SIZEOF(ecs_entity_t) * it->count);
+    }
+
+    int8_t i, field_count = it->field_count;
+    if (!field_count) {
+        return;
+    }
+
+    s->ids = flecs_pipeline_snapshot_copy(pq, it->ids, 
+        ECS_SIZEOF(ecs_id_t) * field_count);
+    s->sources = flecs_pipeline_snapshot_copy(pq, it->sources, 
+        ECS_SIZEOF(ecs_entity_t) * field_count);
+
+    for (i = 0; i < field_count; i ++) {
+        s->fields[i] = flecs_pipeline_snapshot_field(pq, it, sys, i);
+        if (!ecs_field_is_self(it, i)) {
+            s->ref_fields |= (1llu << i);
+        }
+    }
+}
+
+static void flecs_pipeline_snapshot_system(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_system_t *sys,
+    ecs_ftime_t delta_time)
+{
+    ecs_ftime_t time_elapsed = delta_time;
+
+    /* Same as flecs_run_system, only snapshot systems that would run */
+    if (sys->tick_source) {
+        const EcsTickSource *tick = ecs_get(
+            world, sys->tick_source, EcsTickSource);
+        if (!tick || !tick->tick) {
+            return;
+        }
+        time_elapsed = tick->time_elapsed;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, sys->query);
+#ifdef FLECS_CACHED_QUERIES
+    if (sys->group_id_set) {
+        ecs_iter_set_group(&it, sys->group_id);
+    }
+#endif
+
+    if (!sys->query->term_count) {
+        flecs_pipeline_snapshot_result(pq, &it, sys, delta_time, time_elapsed);
+        ecs_iter_fini(&it);
+        return;
+    }
+
+    while (ecs_query_next(&it)) {
+        flecs_pipeline_snapshot_result(pq, &it, sys, delta_time, time_elapsed);
+    }
+}
+
+void flecs_pipeline_snapshot_create(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_ftime_t delta_time)
+{
+    ecs_assert(!ecs_vec_count(&pq->snapshots), ECS_INTERNAL_ERROR, NULL);
+
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, count = ecs_vec_count(&pq->systems);
+    for (i = pq->tail_offset; i < count; i ++) {
+        ecs_system_t *sys = systems[i];
+        sys->last_frame = world->info.frame_count_total + 1;
+        flecs_pipeline_snapshot_system(world, pq, sys, delta_time);
+    }
+}
+
+void flecs_pipeline_snapshot_run(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count)
+{
+    ecs_pipeline_snapshot_t *snapshots = ecs_vec_first_t(
+        &pq->snapshots, ecs_pipeline_snapshot_t);
+    int32_t i, count = ecs_vec_count(&pq->snapshots);
+    bool measure_time = ECS_BIT_IS_SET(world->flags, EcsWorldMeasureSystemTime);
+
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_snapshot_t *s = &snapshots[i];
+        ecs_system_t *sys = s->system;
+
+        /* Systems that aren't multithreaded only run on the main thread */
+        if (!sys->multi_threaded && stage_index) {
+            continue;
+        }
+
+        /* Divide entities across workers, same as ecs_worker_iter() */
+        int32_t first = 0, per_worker = s->count;
+        if (sys->multi_threaded && stage_count > 1) {
+            per_worker = s->count / stage_count;
+            first = per_worker * stage_index;
+            int32_t remaining = s->count - per_worker * stage_count;
+            if (remaining) {
+                if (stage_index < remaining) {
+                    per_worker ++;
+                    first += stage_index;
+                } else {
+                    first += remaining;
+                }
+            }
+        }
+
+        if (!per_worker && (s->count || stage_index)) {
+            continue;
+        }
+
+        ecs_time_t time_start;
+        if (measure_time) {
+            ecs_os_get_time(&time_start);
+        }
+
+        const ecs_query_t *q = sys->query;
+        void *ptrs[FLECS_TERM_COUNT_MAX];
+        int8_t f;
+        for (f = 0; f < q->field_count; f ++) {
+            ptrs[f] = flecs_pipeline_snapshot_ptr(pq, s->fields[f]);
+            if (ptrs[f] && !(s->ref_fields & (1llu << f))) {
+                ptrs[f] = ECS_ELEM(ptrs[f], q->sizes[f], first);
+            }
+        }
+
+        ecs_entity_t *entities = flecs_pipeline_snapshot_ptr(pq, s->entities);
+
+        ecs_iter_t it = {
+            .world = stage->thread_ctx,
+            .real_world = world,
+            .count = per_worker,
+            .entities = entities ? &entities[first] : NULL,
+            .ptrs = ptrs,
+            .sizes = q->sizes,
+            .ids = flecs_pipeline_snapshot_ptr(pq, s->ids),
+            .sources = flecs_pipeline_snapshot_ptr(pq, s->sources),
+            .set_fields = s->set_fields,
+            .ref_fields = s->ref_fields,
+            .up_fields = s->up_fields,
+            .system = sys->query->entity,
+            .field_count = q->field_count,
+            .query = q,
+            .param = sys->ctx,
+            .ctx = sys->ctx,
+            .callback_ctx = sys->callback_ctx,
+            .run_ctx = sys->run_ctx,
+            .delta_time = s->delta_time,
+            .delta_system_time = s->delta_system_time,
+            .frame_offset = first,
+            .flags = EcsIterIsValid,
+            .callback = sys->action
+        };
+
+        ecs_entity_t old_system = flecs_stage_set_system(
+            stage, sys->query->entity);
+        if (sys->run) {
+            /* Run callbacks iterate a single result per snapshot */
+            it.next = flecs_default_next_callback;
+            sys->run(&it);
+        } else {
+            sys->action(&it);
+        }
+        flecs_stage_set_system(stage, old_system);
+
+        if (measure_time) {
+            sys->time_spent += (ecs_ftime_t)ecs_time_measure(&time_start);
+        }
+    }
+}
+
+/* Remove entities from snapshots that were deleted after the snapshots were
+ * created, for example by the application in between two frames. */
+void flecs_pipeline_snapshot_filter(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_snapshot_t *snapshots = ecs_vec_first_t(
+        &pq->snapshots, ecs_pipeline_snapshot_t);
+    int32_t i, count = ecs_vec_count(&pq->snapshots);
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_snapshot_t *s = &snapshots[i];
+        ecs_entity_t *entities = flecs_pipeline_snapshot_ptr(pq, s->entities);
+        if (!entities) {
+            continue;
+        }
+
+        const ecs_query_t *q = s->system->query;
+        int32_t e, alive = 0;
+        for (e = 0; e < s->count; e ++) {
+            if (!ecs_is_alive(world, entities[e])) {
+                continue;
+            }
+
+            if (alive != e) {
+                entities[alive] = entities[e];
+
+                int8_t f;
+                for (f = 0; f < q->field_count; f ++) {
+                    void *ptr = flecs_pipeline_snapshot_ptr(pq, s->fields[f]);
+                    if (ptr && !(s->ref_fields & (1llu << f))) {
+                        ecs_size_t size = q->sizes[f];
+                        ecs_os_memcpy(ECS_ELEM(ptr, size, alive), 
+                            ECS_ELEM(ptr, size, e), size);
+                    }
+                }
+            }
+
+            alive ++;
+        }
+
+        s->count = alive;
+    }
+}
+
+void flecs_pipeline_snapshot_clear(
+    ecs_pipeline_state_t *pq)
+{
+    /* Keep storage, so the next frame can reuse it */
+    ecs_vec_clear(&pq->snapshots);
+    ecs_vec_clear(&pq->snapshot_data);
+    pq->run_snapshots = false;
+}
+
+void flecs_pipeline_snapshot_flush(
     ecs_world_t *world,
-    void *ctx)
+    ecs_pipeline_state_t *pq)
 {
-    (void)ctx;
-    if (ecs_get_stage_count(world)) {
-        ecs_set_threads(world, 0);
+    if (!ecs_vec_count(&pq->snapshots)) {
+        return;
     }
 
-    ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
+    flecs_pipeline_snapshot_filter(world, pq);
+
+    ecs_readonly_begin(world, false);
+    flecs_pipeline_snapshot_run(world, pq, world->stages[0], 0, 1);
+    ecs_readonly_end(world);
+    flecs_pipeline_snapshot_clear(pq);
 }
 
-#define flecs_bootstrap_phase(world, phase, depends_on)\
-    flecs_bootstrap_tag(world, phase);\
-    flecs_bootstrap_phase_(world, phase, depends_on)
-static void flecs_bootstrap_phase_(
+void ecs_set_pipelined_frames(
     ecs_world_t *world,
-    ecs_entity_t phase,
-    ecs_entity_t depends_on)
+    bool enable)
 {
-    ecs_add_id(world, phase, EcsPhase);
-    if (depends_on) {
-        ecs_add_pair(world, phase, EcsDependsOn, depends_on);
-    }
-}
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change pipelined frames while world is in readonly mode");
 
-void FlecsPipelineImport(
-    ecs_world_t *world)
-{
-    ECS_MODULE(world, FlecsPipeline);
-    ECS_IMPORT(world, FlecsSystem);
+    if (!enable) {
+        /* Run pending snapshots of all pipelines. Collect pipelines first, as
+         * the systems run by a flush can modify the pipeline table. */
+        ecs_allocator_t *a = &world->allocator;
+        ecs_vec_t pipelines;
+        ecs_vec_init_t(a, &pipelines, ecs_pipeline_state_t*, 0);
 
-    ecs_set_name_prefix(world, "Ecs");
+        ecs_iter_t it = ecs_each(world, EcsPipeline);
+        while (ecs_each_next(&it)) {
+            EcsPipeline *p = ecs_field(&it, EcsPipeline, 0);
+            int32_t i;
+            for (i = 0; i < it.count; i ++) {
+                if (p[i].state && ecs_vec_count(&p[i].state->snapshots)) {
+                    ecs_vec_append_t(a, &pipelines, 
+                        ecs_pipeline_state_t*)[0] = p[i].state;
+                }
+            }
+        }
 
-    flecs_bootstrap_component(world, EcsPipeline);
-    flecs_bootstrap_tag(world, EcsPhase);
+        ecs_pipeline_state_t **states = ecs_vec_first(&pipelines);
+        int32_t i, count = ecs_vec_count(&pipelines);
+        for (i = 0; i < count; i ++) {
+            flecs_pipeline_snapshot_flush(world, states[i]);
+        }
 
-    /* Create anonymous phases to which the builtin phases will have DependsOn 
-     * relationships. This ensures that, for example, EcsOnUpdate doesn't have a
-     * direct DependsOn relationship on EcsPreUpdate, which ensures that when
-     * the EcsPreUpdate phase is disabled, EcsOnUpdate still runs. */
-    ecs_entity_t phase_0 = ecs_entity(world, {0});
-    ecs_entity_t phase_1 = ecs_entity(world, {0});
-    ecs_entity_t phase_2 = ecs_entity(world, {0});
-    ecs_entity_t phase_3 = ecs_entity(world, {0});
-    ecs_entity_t phase_4 = ecs_entity(world, {0});
-    ecs_entity_t phase_5 = ecs_entity(world, {0});
-    ecs_entity_t phase_6 = ecs_entity(world, {0});
-    ecs_entity_t phase_7 = ecs_entity(world, {0});
-    ecs_entity_t phase_8 = ecs_entity(world, {0});
+        ecs_vec_fini_t(a, &pipelines, ecs_pipeline_state_t*);
+    }
 
-    ecs_add_pair(world, phase_1, EcsDependsOn, phase_0);
-    ecs_add_pair(world, phase_2, EcsDependsOn, phase_1);
-    ecs_add_pair(world, phase_3, EcsDependsOn, phase_2);
-    ecs_add_pair(world, phase_4, EcsDependsOn, phase_3);
-    ecs_add_pair(world, phase_5, EcsDependsOn, phase_4);
-    ecs_add_pair(world, phase_6, EcsDependsOn, phase_5);
-    ecs_add_pair(world, phase_7, EcsDependsOn, phase_6);
-    ecs_add_pair(world, phase_8, EcsDependsOn, phase_7);
+    ECS_BIT_COND(world->flags, EcsWorldPipelinedFrames, enable);
+error:
+    return;
+}
 
-    flecs_bootstrap_phase(world, EcsOnStart,    0);
-    flecs_bootstrap_phase(world, EcsPreFrame,   0);
-    flecs_bootstrap_phase(world, EcsOnLoad,     phase_0);
-    flecs_bootstrap_phase(world, EcsPostLoad,   phase_1);
-    flecs_bootstrap_phase(world, EcsPreUpdate,  phase_2);
-    flecs_bootstrap_phase(world, EcsOnUpdate,   phase_3);
-    flecs_bootstrap_phase(world, EcsOnValidate, phase_4);
-    flecs_bootstrap_phase(world, EcsPostUpdate, phase_5);
-    flecs_bootstrap_phase(world, EcsPreStore,   phase_6);
-    flecs_bootstrap_phase(world, EcsOnStore,    phase_7);
-    flecs_bootstrap_phase(world, EcsPostFrame,  phase_8);
+bool ecs_using_pipelined_frames(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldPipelinedFrames);
+error:
+    return false;
+}
 
-    ecs_set_hooks(world, EcsPipeline, {
-        .ctor = flecs_default_ctor,
-        .dtor = ecs_dtor(EcsPipeline),
-        .move = ecs_move(EcsPipeline)
-    });
+void ecs_set_double_buffered(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(component != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change double buffering while world is in readonly mode");
 
-    world->pipeline = ecs_pipeline(world, {
-        .entity = ecs_entity(world, { .name = "BuiltinPipeline" }),
-        .query = {
-            .terms = {
-                { .id = EcsSystem },
-                { .id = EcsPhase, .src.id = EcsCascade, .trav = EcsDependsOn },
-                { .id = ecs_dependson(EcsOnStart), .src.id = EcsSelf|EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
-                { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsDependsOn, .oper = EcsNot },
-                { .id = EcsDisabled, .src.id = EcsUp, .trav = EcsChildOf, .oper = EcsNot }
-            },
-            .order_by_callback = flecs_entity_compare
-        }
-    });
+    if (enable) {
+        const ecs_type_info_t *ti = ecs_get_type_info(world, component);
+        ecs_check(ti != NULL, ECS_INVALID_PARAMETER,
+            "double buffered entity must be a component");
+        ecs_check(flecs_pipeline_trivially_copyable(ti),
+            ECS_INVALID_PARAMETER,
+            "double buffered component '%s' has copy or dtor hooks", ti->name);
+        (void)ti;
+        ecs_map_ensure(&world->double_buffered, component)[0] = 1;
+    } else {
+        ecs_map_remove(&world->double_buffered, component);
+    }
+error:
+    return;
+}
 
-    /* Cleanup thread administration when world is destroyed */
-    ecs_atfini(world, FlecsPipelineFini, NULL);
+bool ecs_is_double_buffered(
+    const ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ecs_map_get(&world->double_buffered, component) != NULL;
+error:
+    return false;
 }
 
 #endif
 
 #ifdef FLECS_PIPELINE
 
+/* Wait until main thread signals that worker can continue. Spin for the 
+ * configured number of iterations before blocking on the condition variable.
+ * Workers that aren't selected for a job keep waiting when the condition
+ * variable is broadcast. */
+static void flecs_wait_for_signal(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    int32_t i, spin_count = world->worker_spin_count;
+    for (i = 0; i < spin_count; i ++) {
+        if (ecs_os_aload(&stage->worker_signaled)) {
+            ecs_os_linc(&stage->worker_stats.spins);
+            ecs_os_adec(&stage->worker_signaled);
+            return;
+        }
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    if (!stage->worker_signaled) {
+        stage->worker_stats.parks ++;
+        do {
+            ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        } while (!stage->worker_signaled);
+    }
+    ecs_os_adec(&stage->worker_signaled);
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 /* Synchronize workers */
 static void flecs_sync_worker(
-    ecs_world_t* world)
+    ecs_world_t* world,
+    ecs_stage_t *stage)
 {
     int32_t stage_count = ecs_get_stage_count(world);
     if (stage_count <= 1) {
         return;
     }
 
+    /* The main thread doesn't signal workers again before all signaled workers
+     * are waiting, so the number of signaled workers can't change here. */
+    int32_t signaled = world->workers_signaled;
+
     /* Signal that thread is waiting */
-    ecs_os_mutex_lock(world->sync_mutex);
-    if (++world->workers_waiting == (stage_count - 1)) {
+    if (ecs_os_ainc(&world->workers_waiting) == signaled) {
         /* Only signal main thread when all threads are waiting */
+        ecs_os_mutex_lock(world->sync_mutex);
         ecs_os_cond_signal(world->sync_cond);
+        ecs_os_mutex_unlock(world->sync_mutex);
     }
 
-    /* Wait until main thread signals that thread can continue */
-    ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
-    ecs_os_mutex_unlock(world->sync_mutex);
+    flecs_wait_for_signal(world, stage);
+}
+
+/* Pin worker thread to core. If thread is 0, the calling thread is pinned. */
+static void flecs_worker_set_affinity(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_os_thread_t thread)
+{
+    if (world->workers_use_task_api || !ecs_os_api.thread_set_affinity_) {
+        return;
+    }
+
+    int32_t cpu = ecs_get_worker_affinity(world, stage->id);
+    if (cpu == -1 && !stage->worker_stats.pinned) {
+        return;
+    }
+
+    if (!ecs_os_thread_set_affinity(thread, cpu)) {
+        ecs_warn("worker %d: failed to set affinity to core %d", 
+            stage->id, cpu);
+        return;
+    }
+
+    stage->worker_stats.pinned = cpu != -1;
+    if (!thread && cpu != -1) {
+        flecs_stage_first_touch(stage);
+    }
 }
 
 /* Worker thread */
@@ -65149,27 +71615,36 @@ static void* flecs_worker(void *arg) {
 
     ecs_dbg_2("worker %d: start", stage->id);
 
+    /* Pin thread before the stage allocates memory, so that memory used by 
+     * the stage is first touched on the NUMA node of the core. */
+    flecs_worker_set_affinity(world, stage, 0);
+
     /* Start worker, increase counter so main thread knows how many
      * workers are ready */
     ecs_os_mutex_lock(world->sync_mutex);
     world->workers_running ++;
+    ecs_os_mutex_unlock(world->sync_mutex);
 
     if (!(world->flags & EcsWorldQuitWorkers)) {
-        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        flecs_wait_for_signal(world, stage);
     }
 
-    ecs_os_mutex_unlock(world->sync_mutex);
-
     while (!(world->flags & EcsWorldQuitWorkers)) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
-        ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        if (world->pq->merging) {
+            ecs_dbg_3("worker %d: merge", stage->id);
+            flecs_commands_merge_inplace(
+                world, stage, stage->id, world->stage_count);
+        } else {
+            ecs_dbg_3("worker %d: run", stage->id);
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
-        flecs_sync_worker(world);
+        flecs_sync_worker(world, stage);
     }
 
     ecs_dbg_2("worker %d: finalizing", stage->id);
@@ -65196,6 +71671,10 @@ void flecs_create_worker_threads(
         flecs_poly_assert(stage, ecs_stage_t);
 
         ecs_assert(stage->thread == 0, ECS_INTERNAL_ERROR, NULL);
+
+        /* Clear signal that a previous thread for the stage didn't consume */
+        stage->worker_signaled = 0;
+
         if (ecs_using_task_threads(world)) {
             /* workers are using tasks in an external task manager provided via
              * the OS API */
@@ -65243,47 +71722,123 @@ static void flecs_wait_for_workers(
     } while (wait);
 }
 
-/* Wait until all threads are waiting on sync point */
+/* Wait until all signaled threads are waiting on sync point */
 void flecs_wait_for_sync(
     ecs_world_t *world)
 {
-    int32_t stage_count = ecs_get_stage_count(world);
-    if (stage_count <= 1) {
+    int32_t signaled = world->workers_signaled;
+    if (!signaled) {
         return;
     }
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
-    ecs_os_mutex_lock(world->sync_mutex);
-    if (world->workers_waiting != (stage_count - 1)) {
-        ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
+    ecs_stage_t *stage = world->stages[0];
+    int32_t i, spin_count = world->worker_spin_count;
+    for (i = 0; i < spin_count; i ++) {
+        if (ecs_os_aload(&world->workers_waiting) == signaled) {
+            stage->worker_stats.spins ++;
+            break;
+        }
     }
 
-    /* We shouldn't have been signalled unless all workers are waiting on sync */
-    ecs_assert(world->workers_waiting == (stage_count - 1), 
-        ECS_INTERNAL_ERROR, NULL);
+    ecs_os_mutex_lock(world->sync_mutex);
+    if (world->workers_waiting != signaled) {
+        stage->worker_stats.parks ++;
+        do {
+            ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
+        } while (world->workers_waiting != signaled);
+    }
 
     world->workers_waiting = 0;
+    world->workers_signaled = 0;
     ecs_os_mutex_unlock(world->sync_mutex);
 
     ecs_dbg_3("#[bold]pipeline: workers synced");
 }
 
-/* Signal workers that they can start/resume work */
+/* Signal workers of the first count stages that they can start/resume work */
 void flecs_signal_workers(
-    ecs_world_t *world)
+    ecs_world_t *world,
+    int32_t count)
 {
-    int32_t stage_count = ecs_get_stage_count(world);
-    if (stage_count <= 1) {
+    ecs_assert(count <= ecs_get_stage_count(world), ECS_INTERNAL_ERROR, NULL);
+    if (count <= 1) {
         return;
     }
 
-    ecs_dbg_3("#[bold]pipeline: signal workers");
+    ecs_dbg_3("#[bold]pipeline: signal %d workers", count - 1);
     ecs_os_mutex_lock(world->sync_mutex);
+    world->workers_signaled = count - 1;
+    int32_t i;
+    for (i = 1; i < count; i ++) {
+        ecs_os_ainc(&world->stages[i]->worker_signaled);
+    }
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
+static bool flecs_system_deps_finished(
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_node_t *node,
+    int32_t required)
+{
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t *deps = ecs_vec_get_t(&pq->deps, int32_t, node->dep_offset);
+    int32_t i;
+    for (i = 0; i < node->dep_count; i ++) {
+        int32_t dep = deps[i];
+        if (dep < pq->first_system) {
+            /* System ran before the current op run started */
+            continue;
+        }
+        if (nodes[dep].finished < required) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Wait until the systems that a system depends on have finished running on 
+ * the required number of workers. */
+void flecs_wait_for_system_deps(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system,
+    int32_t required)
+{
+    ecs_pipeline_node_t *node = ecs_vec_get_t(
+        &pq->nodes, ecs_pipeline_node_t, system);
+    if (!node->dep_count) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    while (!flecs_system_deps_finished(pq, node, required)) {
+        ecs_os_cond_wait(world->system_cond, world->sync_mutex);
+    }
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
+/* Signal workers waiting for a system that it has finished running */
+void flecs_signal_system_done(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system)
+{
+    ecs_pipeline_node_t *node = ecs_vec_get_t(
+        &pq->nodes, ecs_pipeline_node_t, system);
+    if (!node->notify) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    node->finished ++;
+    ecs_os_cond_broadcast(world->system_cond);
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 void flecs_join_worker_threads(
     ecs_world_t *world)
 {
@@ -65311,7 +71866,7 @@ void flecs_join_worker_threads(
 
     /* Signal threads should quit */
     world->flags |= EcsWorldQuitWorkers;
-    flecs_signal_workers(world);
+    flecs_signal_workers(world, count);
 
     /* Join all threads with main */
     for (i = 1; i < count; i ++) {
@@ -65325,9 +71880,327 @@ void flecs_join_worker_threads(
     }
 
     world->flags &= ~EcsWorldQuitWorkers;
+    world->workers_signaled = 0;
     ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Make sure there is a tasks element for each system in the pipeline. Called
+ * from the main thread while workers are not running. */
+void flecs_worker_tasks_update(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    if (!(world->flags & EcsWorldWorkStealing)) {
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&pq->systems);
+    if (ecs_vec_count(&pq->tasks) != count) {
+        flecs_worker_tasks_fini(pq);
+        ecs_vec_init_t(NULL, &pq->tasks, ecs_worker_tasks_t, count);
+        ecs_vec_set_min_count_zeromem_t(
+            NULL, &pq->tasks, ecs_worker_tasks_t, count);
+    }
+
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    for (i = 0; i < count; i ++) {
+        if (tasks[i].system != systems[i]) {
+            /* Schedule changed, invalidate tasks */
+            tasks[i].system = systems[i];
+            tasks[i].run = 0;
+        }
+    }
+}
+
+void flecs_worker_tasks_fini(
+    ecs_pipeline_state_t *pq)
+{
+    int32_t i, count = ecs_vec_count(&pq->tasks);
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    for (i = 0; i < count; i ++) {
+        ecs_vec_fini_t(NULL, &tasks[i].results, ecs_worker_result_t);
+        ecs_os_free(tasks[i].ranges);
+    }
+    ecs_vec_fini_t(NULL, &pq->tasks, ecs_worker_tasks_t);
+}
+
+/* Split up the results of a system into chunks, and divide the chunks evenly
+ * across the worker ranges. */
+static void flecs_worker_tasks_init(
+    ecs_world_t *world,
+    ecs_worker_tasks_t *tasks,
+    int32_t stage_count,
+    int32_t run)
+{
+    ecs_system_t *sys = tasks->system;
+    int32_t chunk_size = FLECS_WORKER_CHUNK_SIZE;
+    if (sys->chunking.chunk_size) {
+        chunk_size = sys->chunking.chunk_size;
+    }
+    if (chunk_size < sys->chunking.min_count) {
+        chunk_size = sys->chunking.min_count;
+    }
+    int32_t chunk_count = 0;
+
+    ecs_vec_clear(&tasks->results);
+
+    ecs_iter_t qit = ecs_query_iter(world, sys->query);
+#ifdef FLECS_CACHED_QUERIES
+    if (sys->group_id_set) {
+        ecs_iter_set_group(&qit, sys->group_id);
+    }
+#endif
+
+    while (ecs_query_next(&qit)) {
+        ecs_worker_result_t *r = ecs_vec_append_t(
+            NULL, &tasks->results, ecs_worker_result_t);
+        r->first_chunk = chunk_count;
+        r->count = qit.count;
+        if (qit.table && qit.count) {
+            chunk_count += (qit.count + chunk_size - 1) / chunk_size;
+        } else {
+            /* Results that don't iterate a table are processed as a whole */
+            chunk_count ++;
+        }
+    }
+
+    if (tasks->range_count != stage_count) {
+        tasks->ranges = ecs_os_realloc_n(
+            tasks->ranges, ecs_worker_range_t, stage_count);
+        tasks->range_count = stage_count;
+    }
+
+    int32_t i;
+    for (i = 0; i < stage_count; i ++) {
+        ecs_worker_range_t *r = &tasks->ranges[i];
+        int32_t first = (chunk_count * i) / stage_count;
+        int32_t last = (chunk_count * (i + 1)) / stage_count;
+        r->claimed = 0;
+        r->first = first;
+        r->count = last - first;
+    }
+
+    tasks->chunk_count = chunk_count;
+    tasks->chunk_size = chunk_size;
+    tasks->run = run;
+}
+
+/* Create the tasks for the multithreaded systems of the current op. This runs
+ * on the main thread before the workers are signaled, so that workers don't
+ * have to synchronize with each other to find out who creates the tasks. */
+void flecs_worker_tasks_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    int32_t stage_count = pq->worker_count;
+
+    if (!(world->flags & EcsWorldWorkStealing) || stage_count < 2) {
+        return;
+    }
+
+    /* Systems scheduled by the dependency graph don't use tasks */
+    if ((world->flags & EcsWorldDagScheduling) && !op->immediate &&
+        op->count > 1)
+    {
+        return;
+    }
+
+    /* World is readonly, so iterate the system queries with the main stage */
+    ecs_world_t *stage = ecs_get_stage(world, 0);
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    int32_t i, last = op->offset + op->count;
+    for (i = pq->cur_i; i < last; i ++) {
+        flecs_worker_tasks_init(stage, &tasks[i], stage_count, pq->run_count);
+    }
+}
+
+/* Claim a chunk from the current range. If the range is empty, select the
+ * range with the most remaining chunks to steal from. */
+static int32_t flecs_worker_claim(
+    ecs_stage_t *stage,
+    ecs_worker_iter_t *iter)
+{
+    ecs_worker_tasks_t *tasks = iter->tasks;
+
+    do {
+        ecs_worker_range_t *r = &tasks->ranges[iter->victim];
+        if (ecs_os_aload(&r->claimed) < r->count) {
+            int32_t claimed = ecs_os_ainc(&r->claimed) - 1;
+            if (claimed < r->count) {
+                if (iter->victim != iter->index) {
+                    stage->worker_stats.steals ++;
+                }
+                stage->worker_stats.chunks ++;
+                return r->first + claimed;
+            }
+        }
+
+        int32_t i, victim = -1, max_remaining = 0;
+        for (i = 0; i < tasks->range_count; i ++) {
+            r = &tasks->ranges[i];
+            int32_t remaining = r->count - ecs_os_aload(&r->claimed);
+            if (remaining > max_remaining) {
+                max_remaining = remaining;
+                victim = i;
+            }
+        }
+
+        iter->victim = victim;
+    } while (iter->victim != -1);
+
+    stage->worker_stats.idle ++;
+    return -1;
+}
+
+/* Find index of result that contains chunk */
+static int32_t flecs_worker_result_for_chunk(
+    ecs_worker_tasks_t *tasks,
+    int32_t chunk)
+{
+    ecs_worker_result_t *results = ecs_vec_first_t(
+        &tasks->results, ecs_worker_result_t);
+    int32_t lo = 0, hi = ecs_vec_count(&tasks->results) - 1;
+    while (lo < hi) {
+        int32_t mid = (lo + hi + 1) / 2;
+        if (results[mid].first_chunk <= chunk) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/* Restart the chained query iterator. This happens when a worker steals a chunk
+ * for a result that the iterator has already passed. */
+static void flecs_worker_steal_restart(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_tasks_t *tasks = it->priv_.iter.worker.tasks;
+    ecs_iter_t prev = *chain_it;
+
+    ecs_iter_fini(chain_it);
+    *chain_it = ecs_query_iter(prev.world, prev.query);
+
+    /* Restore members that were set by the system runner */
+    chain_it->system = prev.system;
+    chain_it->delta_time = prev.delta_time;
+    chain_it->delta_system_time = prev.delta_system_time;
+    chain_it->param = prev.param;
+    chain_it->ctx = prev.ctx;
+    chain_it->callback_ctx = prev.callback_ctx;
+    chain_it->run_ctx = prev.run_ctx;
+
+#ifdef FLECS_CACHED_QUERIES
+    if (tasks->system->group_id_set) {
+        ecs_iter_set_group(chain_it, tasks->system->group_id);
+    }
+#else
+    (void)tasks;
+#endif
+
+    it->priv_.iter.worker.result = -1;
+}
+
+static bool flecs_worker_steal_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    ecs_worker_tasks_t *tasks = iter->tasks;
+    ecs_stage_t *stage = it->real_world->stages[iter->index];
+
+    int32_t chunk = flecs_worker_claim(stage, iter);
+    if (chunk == -1) {
+        /* Chained iterator was not depleted, clean it up */
+        ecs_iter_fini(chain_it);
+        iter->result = -2;
+        return false;
+    }
+
+    int32_t result = flecs_worker_result_for_chunk(tasks, chunk);
+    if (result < iter->result) {
+        flecs_worker_steal_restart(it);
+    }
+
+    while (iter->result < result) {
+        if (!ecs_iter_next(chain_it)) {
+            /* Query returned fewer results than when tasks were created, which
+             * can only happen if the world was modified while readonly. */
+            ecs_abort(ECS_INTERNAL_ERROR, NULL);
+        }
+        iter->result ++;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    ecs_worker_result_t *r = ecs_vec_get_t(
+        &tasks->results, ecs_worker_result_t, result);
+    if (!it->table || !r->count) {
+        return true;
+    }
+
+    int32_t first = (chunk - r->first_chunk) * tasks->chunk_size;
+    int32_t count = r->count - first;
+    if (count > tasks->chunk_size) {
+        count = tasks->chunk_size;
+    }
+
+    it->frame_offset += first;
+    it->offset += first;
+    it->count = count;
+    it->entities = &(ecs_table_entities(it->table)[it->offset]);
+
+    return true;
+}
+
+static void flecs_worker_steal_fini(
+    ecs_iter_t *it)
+{
+    ecs_assert(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    if (it->priv_.iter.worker.result != -2) {
+        ecs_iter_fini(it->chain_it);
+        it->priv_.iter.worker.result = -2;
+    }
+    it->chain_it = NULL;
+}
+
+ecs_iter_t flecs_worker_steal_iter(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    ecs_worker_tasks_t *tasks = ctx;
+    ecs_assert(tasks != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tasks->run == it->real_world->pq->run_count,
+        ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tasks->range_count == stage_count, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_iter_t result = *it;
+    result.priv_.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv_.iter.worker = (ecs_worker_iter_t){
+        .index = stage_index,
+        .count = stage_count,
+        .tasks = tasks,
+        .result = -1,
+        .victim = stage_index
+    };
+    result.next = flecs_worker_steal_next;
+    result.fini = flecs_worker_steal_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+
+    return result;
+}
+
 /* -- Private functions -- */
 void flecs_workers_progress(
     ecs_world_t *world,
@@ -65373,6 +72246,9 @@ static void flecs_set_threads_internal(
             if (world->sync_cond) {
                 ecs_os_cond_free(world->sync_cond);
             }
+            if (world->system_cond) {
+                ecs_os_cond_free(world->system_cond);
+            }
             if (world->sync_mutex) {
                 ecs_os_mutex_free(world->sync_mutex);
             }
@@ -65384,6 +72260,7 @@ static void flecs_set_threads_internal(
         if (threads > 1) {
             world->worker_cond = ecs_os_cond_new();
             world->sync_cond = ecs_os_cond_new();
+            world->system_cond = ecs_os_cond_new();
             world->sync_mutex = ecs_os_mutex_new();
             flecs_start_workers(world, threads);
         }
@@ -65412,6 +72289,210 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_work_stealing(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change work stealing while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldWorkStealing, enable);
+error:
+    return;
+}
+
+bool ecs_using_work_stealing(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldWorkStealing);
+error:
+    return false;
+}
+
+void ecs_set_dag_scheduling(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change scheduling while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldDagScheduling, enable);
+error:
+    return;
+}
+
+bool ecs_using_dag_scheduling(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldDagScheduling);
+error:
+    return false;
+}
+
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change parallel merge while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldParallelMerge, enable);
+error:
+    return;
+}
+
+bool ecs_using_parallel_merge(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldParallelMerge);
+error:
+    return false;
+}
+
+void ecs_set_worker_spin_count(
+    ecs_world_t *world,
+    int32_t spin_count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(spin_count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change spin count while world is in readonly mode");
+    world->worker_spin_count = spin_count;
+error:
+    return;
+}
+
+int32_t ecs_get_worker_spin_count(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_spin_count;
+error:
+    return 0;
+}
+
+void ecs_set_worker_min_cost(
+    ecs_world_t *world,
+    ecs_ftime_t min_cost)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(min_cost >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker cost while world is in readonly mode");
+    world->worker_min_cost = min_cost;
+error:
+    return;
+}
+
+ecs_ftime_t ecs_get_worker_min_cost(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_min_cost;
+error:
+    return 0;
+}
+
+void ecs_set_worker_cost_weight(
+    ecs_world_t *world,
+    ecs_ftime_t weight)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(weight > 0 && weight <= 1, ECS_INVALID_PARAMETER, 
+        "weight must be larger than 0 and not larger than 1");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker cost while world is in readonly mode");
+    world->worker_cost_weight = weight;
+error:
+    return;
+}
+
+ecs_ftime_t ecs_get_worker_cost_weight(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_cost_weight;
+error:
+    return 0;
+}
+
+void ecs_set_worker_affinity(
+    ecs_world_t *world,
+    const int32_t *cpus,
+    int32_t count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || cpus != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker affinity while world is in readonly mode");
+
+    ecs_vec_set_count_t(NULL, &world->worker_affinity, int32_t, count);
+    if (count) {
+        ecs_os_memcpy_n(ecs_vec_first(&world->worker_affinity), cpus, 
+            int32_t, count);
+    }
+
+    ECS_BIT_COND(world->flags, EcsWorldWorkerAffinity, count != 0);
+
+    /* Pin threads that are already running. Workers are idle while the world
+     * is not readonly, so this doesn't interrupt running systems. */
+    int32_t i, stage_count = ecs_get_stage_count(world);
+    for (i = 1; i < stage_count; i ++) {
+        ecs_stage_t *stage = world->stages[i];
+        if (stage->thread) {
+            flecs_worker_set_affinity(world, stage, stage->thread);
+        }
+    }
+error:
+    return;
+}
+
+int32_t ecs_get_worker_affinity(
+    const ecs_world_t *world,
+    int32_t worker)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(worker >= 0, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+
+    if (worker == 0 || worker >= ecs_vec_count(&world->worker_affinity)) {
+        return -1;
+    }
+
+    return ecs_vec_get_t(&world->worker_affinity, int32_t, worker)[0];
+error:
+    return -1;
+}
+
+bool ecs_worker_stats_get(
+    const ecs_world_t *world,
+    int32_t worker,
+    ecs_worker_stats_t *stats)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(stats != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+
+    if (worker < 0 || worker >= world->stage_count) {
+        return false;
+    }
+
+    *stats = world->stages[worker]->worker_stats;
+    return true;
+error:
+    return false;
+}
+
 #endif
 
 #ifdef FLECS_PREFAB
@@ -65570,6 +72651,9 @@ static void flecs_instantiate_children(
     ecs_table_diff_t diff = { .added = {0}};
     diff.added.array = ecs_os_alloca_n(ecs_entity_t, type_count + 1);
     void **component_data = ecs_os_alloca_n(void*, type_count + 1);
+    void **gathered = ecs_os_alloca_n(void*, type_count);
+    ecs_size_t *gathered_sizes = ecs_os_alloca_n(ecs_size_t, type_count);
+    int32_t gathered_count = 0;
 
     /* Copy in component identifiers. Find the base index in the component
      * array, since we'll need this to replace the base with the instance id */
@@ -65617,8 +72701,24 @@ static void flecs_instantiate_children(
 
         int32_t column = ecs_table_type_to_column_index(child_table, i);
         if (column != -1) {
-            component_data[diff.added.count] = ecs_table_get_column(
-                child_table, column, child_range.offset);
+            ecs_column_t *c = &child_table->data.columns[column];
+            if (c->flags & EcsColumnSoA) {
+                /* Members of struct-of-arrays components are stored in 
+                 * separate arrays, gather them into regular values. */
+                ecs_size_t size = c->ti->size;
+                void *values = flecs_walloc(world, size * child_range.count);
+                for (j = 0; j < child_range.count; j ++) {
+                    flecs_table_soa_get(child_table, column, 
+                        child_range.offset + j, ECS_ELEM(values, size, j));
+                }
+                component_data[diff.added.count] = values;
+                gathered[gathered_count] = values;
+                gathered_sizes[gathered_count] = size * child_range.count;
+                gathered_count ++;
+            } else {
+                component_data[diff.added.count] = ecs_table_get_column(
+                    child_table, column, child_range.offset);
+            }
         } else {
             component_data[diff.added.count] = NULL;
         }
@@ -65692,6 +72792,10 @@ static void flecs_instantiate_children(
     const ecs_entity_t *i_children = flecs_bulk_new(world, i_table, child_ids,
         &diff.added, child_range.count, component_data, false, &child_row, &diff);
 
+    for (j = 0; j < gathered_count; j ++) {
+        flecs_wfree(world, gathered_sizes[j], gathered[j]);
+    }
+
     flecs_instantiate_sparse(
         world, &child_range, children, i_table, i_children, child_row, false);
 
@@ -77956,6 +85060,10 @@ void ecs_table_component_memory_get(
         
         result->bytes_table_components += used;
         result->bytes_table_components_unused += allocated - used;
+
+        if (column->flags & EcsColumnCold) {
+            result->bytes_cold_components += allocated;
+        }
     }
 
     result->instances += count * table->column_count;
@@ -78080,6 +85188,15 @@ void ecs_table_memory_get(
         result->bytes_dirty_state += 
             (column_count + 1) * ECS_SIZEOF(int32_t);
     }
+
+    if (table->_ && table->_->dirty_chunks) {
+        result->bytes_dirty_state += column_count * ECS_SIZEOF(ecs_vec_t);
+        int32_t i;
+        for (i = 0; i < column_count; i ++) {
+            result->bytes_dirty_state += ecs_vec_size(
+                &table->_->dirty_chunks[i]) * ECS_SIZEOF(int32_t);
+        }
+    }
     
     flecs_table_graph_edges_memory_get(&table->node.add, result);
     flecs_table_graph_edges_memory_get(&table->node.remove, result);
@@ -78095,6 +85212,8 @@ ecs_table_memory_t ecs_tables_memory_get(
     int32_t i, count = flecs_sparse_count(tables);
 
     result.count = count;
+    result.reclaimed_count = world->compaction_count;
+    result.reclaimed_bytes = world->compaction_bytes;
 
     result.bytes_table += 
         flecs_sparse_memory_get(tables, ECS_SIZEOF(ecs_table_t));
@@ -78544,8 +85663,7 @@ ecs_misc_memory_t ecs_misc_memory_get(
             ecs_commands_t *cmd = &stage->cmd_stack[j];
             
             /* Calculate queue memory (ecs_vec_t) */
-            result.bytes_commands += 
-                ecs_vec_size(&cmd->queue) * ECS_SIZEOF(ecs_cmd_t);
+            result.bytes_commands += ecs_vec_size(&cmd->queue);
             
             /* Calculate entries memory (ecs_sparse_t) */
             ecs_sparse_t *entries = &cmd->entries;
@@ -78706,7 +85824,8 @@ void flecs_stats_memory_register_reflection(
             { .name = "bytes_table_components", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_table_components_unused", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_toggle_bitset", .type = ecs_id(ecs_i32_t), .unit = unit },
-            { .name = "bytes_sparse_components", .type = ecs_id(ecs_i32_t), .unit = unit }
+            { .name = "bytes_sparse_components", .type = ecs_id(ecs_i32_t), .unit = unit },
+            { .name = "bytes_cold_components", .type = ecs_id(ecs_i32_t), .unit = unit }
         }
     });
 
@@ -78751,7 +85870,9 @@ void flecs_stats_memory_register_reflection(
             { .name = "bytes_column_map", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_component_map", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_dirty_state", .type = ecs_id(ecs_i32_t), .unit = unit },
-            { .name = "bytes_edges", .type = ecs_id(ecs_i32_t), .unit = unit }
+            { .name = "bytes_edges", .type = ecs_id(ecs_i32_t), .unit = unit },
+            { .name = "reclaimed_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "reclaimed_bytes", .type = ecs_id(ecs_i64_t), .unit = unit }
         }
     });
 
@@ -79852,6 +86973,10 @@ bool ecs_system_stats_get(
     int32_t t = s->query.t;
 
     ECS_COUNTER_RECORD(&s->time_spent, t, ptr->time_spent);
+    ECS_COUNTER_RECORD(&s->commands_enqueued, t, ptr->commands_enqueued);
+    ECS_COUNTER_RECORD(&s->commands_discarded, t, ptr->commands_discarded);
+    ECS_COUNTER_RECORD(&s->commands_coalesced, t, ptr->commands_coalesced);
+    ECS_COUNTER_RECORD(&s->command_time, t, ptr->command_time);
 
     s->task = !(ptr->query->flags & EcsQueryMatchThis);
 
@@ -79950,6 +87075,11 @@ bool ecs_pipeline_stats_get(
         return false;
     }
 
+    s->system_count = sys_count;
+    s->active_system_count = active_sys_count;
+    s->rebuild_count = pq->rebuild_count;
+    s->patch_count = pq->patch_count;
+
     if (op) {
         ecs_entity_t *systems = NULL;
         if (pip_count) {
@@ -80000,8 +87130,12 @@ bool ecs_pipeline_stats_get(
                 ECS_COUNTER_RECORD(&el->time_spent, s->t, cur->time_spent);
                 ECS_COUNTER_RECORD(&el->commands_enqueued, s->t, 
                     cur->commands_enqueued);
+                ECS_COUNTER_RECORD(&el->wait_time, s->t, cur->wait_time);
+                ecs_os_memcpy_n(el->wait_histogram, cur->wait_histogram, 
+                    int64_t, FLECS_SYNC_WAIT_BUCKETS);
 
                 el->system_count = cur->count;
+                el->worker_count = cur->worker_count;
                 el->multi_threaded = cur->multi_threaded;
                 el->immediate = cur->immediate;
             }
@@ -80032,6 +87166,10 @@ void ecs_pipeline_stats_reduce(
     ecs_entity_t *dst_systems = ecs_vec_first_t(&dst->systems, ecs_entity_t);
     ecs_entity_t *src_systems = ecs_vec_first_t(&src->systems, ecs_entity_t);
     ecs_os_memcpy_n(dst_systems, src_systems, ecs_entity_t, system_count);
+    dst->system_count = src->system_count;
+    dst->active_system_count = src->active_system_count;
+    dst->rebuild_count = src->rebuild_count;
+    dst->patch_count = src->patch_count;
 
     int32_t i, sync_count = ecs_vec_count(&src->sync_points);
     ecs_vec_init_if_t(&dst->sync_points, ecs_sync_stats_t);
@@ -80044,8 +87182,11 @@ void ecs_pipeline_stats_reduce(
         flecs_stats_reduce(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, src->t);
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 
     dst->t = t_next(dst->t);
@@ -80066,8 +87207,11 @@ void ecs_pipeline_stats_reduce_last(
         flecs_stats_reduce_last(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, src->t, count);
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 
     dst->t = t_prev(dst->t);
@@ -80092,6 +87236,11 @@ void ecs_pipeline_stats_copy_last(
     ecs_pipeline_stats_t *dst,
     const ecs_pipeline_stats_t *src)
 {
+    dst->system_count = src->system_count;
+    dst->active_system_count = src->active_system_count;
+    dst->rebuild_count = src->rebuild_count;
+    dst->patch_count = src->patch_count;
+
     int32_t i, sync_count = ecs_vec_count(&src->sync_points);
     ecs_vec_init_if_t(&dst->sync_points, ecs_sync_stats_t);
     ecs_vec_set_min_count_zeromem_t(NULL, &dst->sync_points, ecs_sync_stats_t, sync_count);
@@ -80104,8 +87253,11 @@ void ecs_pipeline_stats_copy_last(
         flecs_stats_copy_last(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, t_next(src->t));
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 }
 
@@ -80562,7 +87714,9 @@ ecs_entity_t flecs_run_system(
     int32_t stage_index,
     int32_t stage_count,    
     ecs_ftime_t delta_time,
-    void *param) 
+    void *param,
+    flecs_worker_iter_init_t worker_iter,
+    void *worker_iter_ctx)
 {
     flecs_poly_assert(world, ecs_world_t);
     ecs_ftime_t time_elapsed = delta_time;
@@ -80635,7 +87789,16 @@ ecs_entity_t flecs_run_system(
 #endif
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (worker_iter) {
+            wit = worker_iter(it, stage_index, stage_count, worker_iter_ctx);
+        } else if (system_data->chunking.min_count || 
+            system_data->chunking.chunk_size) 
+        {
+            wit = ecs_worker_iter_w_chunking(it, stage_index, stage_count, 
+                &system_data->chunking);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -80713,7 +87876,7 @@ ecs_entity_t ecs_run_worker(
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
         world, stage, system, system_data, stage_index, stage_count, 
-        delta_time, param);
+        delta_time, param, NULL, NULL);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -80729,7 +87892,8 @@ ecs_entity_t ecs_run(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, 0, 0, delta_time, param);
+        world, stage, system, system_data, 0, 0, delta_time, param, 
+        NULL, NULL);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -80864,6 +88028,10 @@ ecs_entity_t ecs_system_init(
 
     system->multi_threaded = desc->multi_threaded;
     system->immediate = desc->immediate;
+    system->pipelined = desc->pipelined;
+    if (!desc->chunking.disable) {
+        system->chunking = desc->chunking;
+    }
 
     system->name = ecs_get_path(world, entity);
 
@@ -80977,6 +88145,16 @@ ecs_entity_t ecs_system_update(
         system->immediate = desc->immediate;
     }
 
+    if (desc->pipelined) {
+        system->pipelined = desc->pipelined;
+    }
+
+    if (desc->chunking.disable) {
+        system->chunking = (ecs_worker_chunking_t){0};
+    } else if (desc->chunking.min_count || desc->chunking.chunk_size) {
+        system->chunking = desc->chunking;
+    }
+
     if (flecs_system_init_timer(world, entity, desc)) {
         return 0;
     }
@@ -81055,6 +88233,37 @@ ecs_size_t flecs_query_cache_elem_size(
         ;
 }
 
+/* Number of entities in the tables matched by the cache. Tables that match
+ * multiple times for wildcard queries are counted for each match. */
+int32_t flecs_query_cache_entity_count(
+    const ecs_query_cache_t *cache)
+{
+    ecs_size_t elem_size = flecs_query_cache_elem_size(cache);
+    bool trivial = flecs_query_cache_is_trivial(cache);
+    int32_t result = 0;
+
+    const ecs_query_cache_group_t *cur = cache->first_group;
+    do {
+        int32_t i, count = ecs_vec_count(&cur->tables);
+        for (i = 0; i < count; i ++) {
+            const ecs_query_triv_cache_match_t *qm = 
+                ecs_vec_get(&cur->tables, elem_size, i);
+            int32_t table_count = ecs_table_count(qm->table);
+            result += table_count;
+
+            if (!trivial) {
+                const ecs_query_cache_match_t *m = 
+                    (const ecs_query_cache_match_t*)qm;
+                if (m->wildcard_matches) {
+                    result += table_count * ecs_vec_count(m->wildcard_matches);
+                }
+            }
+        }
+    } while ((cur = cur->next));
+
+    return result;
+}
+
 /* The default group_by function. When an application specifies a relationship
  * for the ecs_query_desc_t::group_by field but does not provide a 
  * group_by_callback, this function will be automatically used. It will cause
@@ -81395,6 +88604,15 @@ static int flecs_query_cache_order_by(
             ecs_os_free(id_str);
             goto error;
         }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, order_by);
+        if (ti && ti->soa) {
+            char *id_str = ecs_id_str(world, order_by);
+            ecs_err("cannot order_by component '%s' with struct-of-arrays "
+                "storage", id_str);
+            ecs_os_free(id_str);
+            goto error;
+        }
     }
 
     cache->order_by = order_by;
@@ -81663,7 +88881,8 @@ ecs_query_cache_t* flecs_query_cache_init(
             if (!const_desc->order_by && !const_desc->group_by && 
                 !const_desc->order_by_callback && 
                 !const_desc->group_by_callback &&
-                !(const_desc->flags & EcsQueryDetectChanges))
+                !(const_desc->flags & 
+                    (EcsQueryDetectChanges|EcsQueryDetectRowChanges)))
             {
                 
                 q->flags |= EcsQueryTrivialCache;
@@ -81671,7 +88890,7 @@ ecs_query_cache_t* flecs_query_cache_init(
         }
     }
 
-    if (const_desc->flags & EcsQueryDetectChanges) {
+    if (const_desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges)) {
         for (int i = 0; i < q->term_count; i ++) {
             ecs_term_t *term = &q->terms[i];
 
@@ -81812,6 +89031,46 @@ error:
 
 #ifdef FLECS_CACHED_QUERIES
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/* Portable software prefetch hint for data that will be read soon. */
+static inline void flecs_prefetch(
+    const void *addr)
+{
+#if defined(__clang__) || defined(__GNUC__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)addr, _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
+/* Prefetch the entity array and the heads of the matched columns of a table
+ * that will be iterated next, so that the loads overlap with processing the
+ * current table. Used by queries with the EcsQueryPrefetch flag. */
+static void flecs_query_cache_prefetch(
+    const ecs_query_run_ctx_t *ctx,
+    const ecs_query_triv_cache_match_t *qm)
+{
+    const ecs_table_t *table = qm->table;
+    flecs_prefetch(table->data.entities);
+
+    const ecs_column_t *columns = table->data.columns;
+    const int16_t *field_columns = qm->columns;
+    int32_t i, field_count = ctx->query->cache->query->field_count;
+    for (i = 0; i < field_count; i ++) {
+        int16_t column = field_columns[i];
+        if (column < 0) {
+            continue;
+        }
+
+        flecs_prefetch(columns[column].data);
+    }
+}
+
 /* Initialize cached query iterator. */
 void flecs_query_cache_iter_init(
     ecs_iter_t *it,
@@ -81921,6 +89180,13 @@ static ecs_query_cache_match_t* flecs_query_cache_next(
             qit->cur ++;
         }
 
+        if (ctx->query->pub.flags & EcsQueryPrefetch) {
+            if (qit->cur < ecs_vec_count(qit->tables)) {
+                flecs_query_cache_prefetch(ctx, &ecs_vec_get_t(qit->tables, 
+                    ecs_query_cache_match_t, qit->cur)->base);
+            }
+        }
+
 #ifdef FLECS_QUERY_PLANS
         ctx->vars[0].range.table = table;
 #else
@@ -81951,6 +89217,13 @@ static ecs_query_cache_match_t* flecs_query_trivial_cache_next(
 
         qit->cur ++;
 
+        if (ctx->query->pub.flags & EcsQueryPrefetch) {
+            if (qit->cur < ecs_vec_count(qit->tables)) {
+                flecs_query_cache_prefetch(ctx, ecs_vec_get_t(qit->tables, 
+                    ecs_query_triv_cache_match_t, qit->cur));
+            }
+        }
+
         if (!count) {
             if (!(it->flags & EcsIterMatchEmptyTables)) {
                 goto repeat;
@@ -82335,6 +89608,10 @@ static bool flecs_query_get_match_monitor(
 
     impl->pub.flags |= EcsQueryHasChangeDetection;
 
+    if ((impl->pub.flags & EcsQueryDetectRowChanges) && match->base.table) {
+        flecs_table_track_row_changes(q->real_world, match->base.table);
+    }
+
     return true;
 }
 
@@ -82627,6 +89904,139 @@ static bool flecs_query_check_match_monitor(
     return false;
 }
 
+/* Check if a chunk of rows changed for any of the provided columns. */
+static bool flecs_query_check_chunk_monitor(
+    const ecs_vec_t *chunks,
+    const int32_t *columns,
+    const int32_t *monitor,
+    int32_t column_count,
+    int32_t chunk)
+{
+    int32_t i;
+    for (i = 0; i < column_count; i ++) {
+        const ecs_vec_t *stamps = &chunks[columns[i]];
+        if (chunk >= ecs_vec_count(stamps)) {
+            continue; /* Chunk wasn't written to since tracking started */
+        }
+
+        if (flecs_table_stamp_load(
+            ecs_vec_get_t(stamps, int32_t, chunk)) > monitor[i]) 
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Find the next range of rows in the iterated result that changed. Rows are
+ * tracked in chunks, so a range can include rows that were not modified if they
+ * share a chunk with rows that were. */
+static bool flecs_query_check_match_monitor_rows(
+    ecs_query_impl_t *impl,
+    ecs_query_cache_match_t *match,
+    const ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count)
+{
+    ecs_query_cache_t *cache = impl->cache;
+    const ecs_query_t *query = cache->query;
+    int32_t columns[FLECS_TERM_COUNT_MAX];
+    int32_t versions[FLECS_TERM_COUNT_MAX];
+    int32_t i, changed_count = 0, field_count = query->field_count;
+    int32_t offset = it->offset, cur, last, first = -1;
+    ecs_table_t *table = match->base.table;
+    ecs_entity_t *sources = match->_sources;
+    ecs_vec_t *chunks;
+    int32_t *monitor, *dirty_state;
+
+    if (flecs_query_get_match_monitor(impl, match)) {
+        goto all; /* Result was never synchronized with the query */
+    }
+
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    monitor = match->_monitor;
+    dirty_state = flecs_table_get_dirty_state(query->world, table);
+    if (monitor[0] != dirty_state[0]) {
+        goto all; /* Table gained or lost entities, rows may have moved */
+    }
+
+    chunks = table->_->dirty_chunks;
+
+    for (i = 0; i < field_count; i ++) {
+        int32_t mon = monitor[i + 1];
+        if (mon == -1) {
+            continue;
+        }
+
+        int32_t set_field_index = i;
+        if (cache->field_map) {
+            set_field_index = cache->field_map[i];
+        }
+
+        if (!(it->set_fields & (1llu << set_field_index))) {
+            continue;
+        }
+
+        int32_t column = match->base.columns[i];
+        ecs_entity_t src = sources ? sources[i] : 0;
+        if (src) {
+            /* Component from non-this source applies to all rows */
+            flecs_table_column_t tc;
+            flecs_query_get_column_for_field(query, match, i, &tc);
+            if (!tc.table || tc.column < 0) {
+                continue;
+            }
+
+            if (mon != flecs_table_get_dirty_state(
+                query->world, tc.table)[tc.column + 1])
+            {
+                goto all;
+            }
+        } else if (column >= 0 && mon != dirty_state[column + 1]) {
+            if (!chunks) {
+                goto all;
+            }
+
+            columns[changed_count] = column;
+            versions[changed_count] = mon;
+            changed_count ++;
+        }
+    }
+
+    if (!changed_count) {
+        return false;
+    }
+
+    cur = offset + *row;
+    last = offset + it->count;
+    while (cur < last) {
+        int32_t chunk = cur >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+        if (flecs_query_check_chunk_monitor(
+            chunks, columns, versions, changed_count, chunk))
+        {
+            if (first == -1) {
+                first = cur;
+            }
+        } else if (first != -1) {
+            break;
+        }
+
+        cur = (chunk + 1) << FLECS_TABLE_DIRTY_CHUNK_BITS;
+    }
+
+    if (first == -1) {
+        return false;
+    }
+
+    *row = first - offset;
+    *count = ECS_MIN(cur, last) - first;
+    return true;
+all:
+    *count = it->count - *row;
+    return true;
+}
+
 /* Check if one or more fields of a specific match have changed. */
 static bool flecs_query_check_table_monitor_match(
     ecs_query_impl_t *impl,
@@ -82694,14 +90104,20 @@ void flecs_query_mark_fields_dirty(
 
         ecs_entity_t src = it->sources[i];
         ecs_table_t *table;
+        int32_t row, count;
         if (!src) {
             table = it->table;
+            row = it->offset;
+            count = it->count;
         } else {
             ecs_record_t *r = flecs_entities_get(world, src);
             if (!r || !(table = r->table)) {
                 continue;
             }
 
+            row = ECS_RECORD_TO_ROW(r->row);
+            count = 1;
+
             if (q->shared_readonly_fields & flecs_ito(uint32_t, 1 << i)) {
                 /* Shared fields that aren't marked explicitly as out/inout
                  * default to readonly */
@@ -82721,14 +90137,17 @@ void flecs_query_mark_fields_dirty(
         ecs_assert(type_index >= 0, ECS_INTERNAL_ERROR, NULL);
 
         ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
-        int32_t *dirty_state = table->dirty_state;
-        if (!dirty_state) {
+        if (!table->dirty_state) {
             continue;
         }
 
         ecs_assert(type_index < table->type.count, ECS_INTERNAL_ERROR, NULL);
         int32_t column = table->column_map[type_index];
-        dirty_state[column + 1] ++;
+        if (column == -1) {
+            continue; /* Tags don't have data that can change */
+        }
+
+        flecs_table_mark_column_dirty(table, column, row, count);
     }
 }
 
@@ -82760,8 +90179,7 @@ void flecs_query_mark_fixed_fields_dirty(
             continue;
         }
 
-        int32_t *dirty_state = table->dirty_state;
-        if (!dirty_state) {
+        if (!table->dirty_state) {
             continue;
         }
 
@@ -82774,7 +90192,8 @@ void flecs_query_mark_fixed_fields_dirty(
         }
         ecs_assert(tr->column >= 0, ECS_INTERNAL_ERROR, NULL);
         int32_t column = table->column_map[tr->index];
-        dirty_state[column + 1] ++;
+        flecs_table_mark_column_dirty(
+            table, column, ECS_RECORD_TO_ROW(r->row), 1);
     }
 }
 
@@ -82912,6 +90331,52 @@ error:
     return false;
 }
 
+/* Public API call to find the changed rows in the currently iterated result. */
+bool ecs_iter_changed_rows(
+    ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(row != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_query_next, ECS_UNSUPPORTED, NULL);
+    ecs_check(ECS_BIT_IS_SET(it->flags, EcsIterIsValid),
+        ECS_INVALID_PARAMETER, NULL);
+    ecs_check(*row >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    if (*row >= it->count) {
+        return false;
+    }
+
+    ecs_query_impl_t *impl = flecs_query_impl(it->query);
+    ecs_query_t *q = &impl->pub;
+
+    /* Changes to terms with fixed sources apply to all rows */
+    if (q->read_fields & q->fixed_fields) {
+        if (!(it->flags & EcsIterFixedInChangeComputed)) {
+            it->flags |= EcsIterFixedInChangeComputed;
+            ECS_BIT_COND(it->flags, EcsIterFixedInChanged,
+                flecs_query_check_fixed_monitor(impl));
+        }
+
+        if (it->flags & EcsIterFixedInChanged) {
+            *count = it->count - *row;
+            return true;
+        }
+    }
+
+    if (impl->cache) {
+        ecs_query_cache_match_t *qm = 
+            (ecs_query_cache_match_t*)it->priv_.iter.query.elem;
+        ecs_check(qm != NULL, ECS_INVALID_PARAMETER, NULL);
+        return flecs_query_check_match_monitor_rows(impl, qm, it, row, count);
+    }
+
+error:
+    return false;
+}
+
 /* Public API call for skipping change detection (don't mark fields dirty) */
 void ecs_iter_skip(
     ecs_iter_t *it)
@@ -83690,6 +91155,27 @@ void flecs_query_revalidate_table(
 
 ECS_SORT_TABLE_WITH_COMPARE(_, flecs_query_cache_sort_table_generic, order_by, static)
 
+/* Tables that were sorted before stay sorted when entities are deleted from
+ * tables with the StableOrder trait, so test this before sorting. */
+static bool flecs_query_cache_table_is_sorted(
+    const ecs_entity_t *entities,
+    const void *ptr,
+    int32_t size,
+    int32_t count,
+    ecs_order_by_action_t compare)
+{
+    int32_t i;
+    for (i = 1; i < count; i ++) {
+        if (compare(entities[i - 1], ECS_ELEM(ptr, size, i - 1), 
+            entities[i], ECS_ELEM(ptr, size, i)) > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static void flecs_query_cache_sort_table(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -83717,6 +91203,12 @@ static void flecs_query_cache_sort_table(
         ptr = column->data;
     }
 
+    if (table->_->stable_order && flecs_query_cache_table_is_sorted(
+        entities, ptr, size, count, compare))
+    {
+        return;
+    }
+
     if (sort) {
         sort(world, table, entities, ptr, size, 0, count - 1, compare);
     } else {
@@ -90922,6 +98414,33 @@ next_block:
     int32_t row = tz + (block_index * 64);
     cur = tz + run_len + (block_index * 64);
 
+    /* If the run ends at the end of the block, it may continue in the next
+     * blocks. Extend it a block at a time, so that a span of enabled entities
+     * is returned as a single result instead of one result per block. */
+    if ((tz + run_len) == 64) {
+        while (cur < last) {
+            flecs_query_row_mask_t row_mask = flecs_query_get_row_mask(
+                it, table, block_index + 1, and_fields, not_fields, op_ctx);
+            ecs_assert(row_mask.has_bitset, ECS_INTERNAL_ERROR, NULL);
+
+            block_index ++;
+            block = row_mask.mask;
+
+            int32_t len = 64;
+            if (~block != 0ull) {
+                len = flecs_ctz64(~block);
+            }
+
+            cur = ECS_MIN(cur + len, last);
+            if (len != 64) {
+                break;
+            }
+        }
+
+        op_ctx->block_index = block_index;
+        op_ctx->block = block;
+    }
+
     ecs_assert(cur <= last, ECS_INTERNAL_ERROR, NULL);
 
     if (!(cur - row)) {
@@ -96374,6 +103893,100 @@ ecs_member_t* ecs_struct_get_nth_member(
     return &members[i];
 }
 
+/* Enable struct-of-arrays storage for a struct type. Members are stored in 
+ * separate arrays, which requires that the type doesn't need lifecycle or
+ * component hooks, has no observers and isn't used yet by any table. */
+static void flecs_struct_init_soa(
+    ecs_world_t *world,
+    ecs_entity_t type)
+{
+    char *path = NULL;
+    ecs_soa_member_t *soa_members = NULL;
+
+    const EcsStruct *s = ecs_get(world, type, EcsStruct);
+    ecs_check(s != NULL, ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': type is not a struct",
+            path = ecs_get_path(world, type));
+
+    ecs_type_info_t *ti = ECS_CONST_CAST(ecs_type_info_t*, 
+        ecs_get_type_info(world, type));
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (ti->soa) {
+        return;
+    }
+
+    ecs_check(flecs_type_hooks_allow_soa(&ti->hooks),
+            ECS_INVALID_OPERATION, 
+            "cannot add SoA trait to '%s': type has lifecycle hooks",
+                path = ecs_get_path(world, type));
+
+    ecs_component_record_t *cr = flecs_components_get(world, type);
+    ecs_check(!cr || !(cr->flags & (EcsIdSparse|EcsIdDontFragment)),
+        ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': component is sparse",
+            path = ecs_get_path(world, type));
+
+    ecs_check(!cr || !(cr->flags & 
+        (EcsIdHasOnAdd|EcsIdHasOnSet|EcsIdHasOnRemove)),
+        ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': component has observers",
+            path = ecs_get_path(world, type));
+    (void)cr;
+
+    ecs_check(!ecs_id_in_use(world, type) && 
+        !ecs_id_in_use(world, ecs_pair(type, EcsWildcard)) &&
+        !flecs_component_is_trait_locked(world, type),
+            ECS_INVALID_OPERATION,
+            "cannot add SoA trait to '%s': component is already in use",
+                path = ecs_get_path(world, type));
+
+    const ecs_member_t *members = ecs_vec_first_t(&s->members, ecs_member_t);
+    int32_t i, count = ecs_vec_count(&s->members);
+    ecs_check(count != 0, ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': struct has no members",
+            path = ecs_get_path(world, type));
+
+    soa_members = ecs_os_malloc_n(ecs_soa_member_t, count);
+    ecs_size_t end = 0;
+    for (i = 0; i < count; i ++) {
+        const ecs_member_t *m = &members[i];
+        ecs_size_t size = m->size;
+        ecs_check(m->offset >= end && (m->offset + size) <= ti->size, 
+            ECS_INVALID_OPERATION,
+            "cannot add SoA trait to '%s': members overlap or are not "
+            "ordered by offset", path = ecs_get_path(world, type));
+        soa_members[i].offset = m->offset;
+        soa_members[i].size = size;
+        end = m->offset + size;
+    }
+    (void)end;
+
+    flecs_type_info_set_soa(ti, soa_members, count);
+    ecs_os_free(soa_members);
+
+    /* Make sure get/ensure/set don't take the fast path that assumes that 
+     * component values are stored contiguously. */
+    if (type < FLECS_HI_COMPONENT_ID) {
+        world->non_trivial_lookup[type] |= EcsNonTrivialIdSoA;
+        world->non_trivial_set[type] = true;
+    }
+
+    return;
+error:
+    ecs_os_free(soa_members);
+    ecs_os_free(path);
+}
+
+static void flecs_add_soa(
+    ecs_iter_t *it)
+{
+    ecs_world_t *world = it->world;
+    int32_t i, count = it->count;
+    for (i = 0; i < count; i ++) {
+        flecs_struct_init_soa(world, it->entities[i]);
+    }
+}
+
 void flecs_meta_struct_init(
     ecs_world_t *world)
 {
@@ -96435,6 +104048,20 @@ void flecs_meta_struct_init(
     });
 
     ecs_add_pair(world, ecs_id(EcsStruct), EcsWith, ecs_id(EcsComponent));
+
+    ecs_entity_t soa = ecs_entity(world, { .id = EcsSoA,
+        .name = "soa", .symbol = "EcsSoA" });
+#ifdef FLECS_CONSTRAINT_TRAITS
+    ecs_add_id(world, soa, EcsTrait);
+#endif
+
+    ecs_observer(world, {
+        .query.terms[0] = { .id = EcsSoA },
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_add_soa,
+        .global_observer = true
+    });
 }
 
 #endif
@@ -565,6 +565,16 @@
 #define FLECS_ENTITY_PAGE_BITS 10
 #endif
 
+/** @def FLECS_COLUMN_RESERVE_SIZE
+ * Size of the address range that is reserved for a table column when it starts
+ * using paged storage (see ecs_set_column_page_size()). Columns that outgrow
+ * the reserved range are moved to a range that is at least twice as large.
+ * Reserving address space does not allocate memory, though 32-bit targets may
+ * want to use a smaller value. */
+#ifndef FLECS_COLUMN_RESERVE_SIZE
+#define FLECS_COLUMN_RESERVE_SIZE (256 * 1024 * 1024)
+#endif
+
 /** @def FLECS_USE_OS_ALLOC
  * When enabled, Flecs will use the OS allocator provided in the OS API directly
  * instead of the built-in block allocator. This can decrease memory utilization
@@ -648,6 +658,12 @@ extern "C" {
 #define EcsWorldMeasureSystemTime     (1u << 6)
 #define EcsWorldMultiThreaded         (1u << 7)
 #define EcsWorldFrameInProgress       (1u << 8)
+#define EcsWorldWorkStealing          (1u << 9)
+#define EcsWorldDagScheduling         (1u << 10)
+#define EcsWorldParallelMerge         (1u << 11)
+#define EcsWorldWorkerAffinity        (1u << 12)
+#define EcsWorldPipelinedFrames       (1u << 13)
+#define EcsWorldCoalesceCommands      (1u << 14)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// OS API flags
@@ -715,6 +731,8 @@ extern "C" {
         EcsIdHasOnTableCreate|EcsIdHasOnTableDelete|EcsIdSparse|\
         EcsIdOrderedChildren|EcsIdHasUpNotify)
 #define EcsIdPrefabChildren            (1u << 26)
+#define EcsIdCold                      (1u << 27)
+#define EcsIdStableOrder               (1u << 28)
 
 #define EcsIdMarkedForDelete           (1u << 30)
 
@@ -742,6 +760,7 @@ extern "C" {
 #define EcsNonTrivialIdSparse          (1u << 0)
 #define EcsNonTrivialIdNonFragmenting  (1u << 1)
 #define EcsNonTrivialIdInherit         (1u << 2)
+#define EcsNonTrivialIdSoA             (1u << 3)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Iterator flags (used by ecs_iter_t::flags)
@@ -1553,6 +1572,9 @@ typedef struct ecs_type_hooks_t ecs_type_hooks_t;
  * alignment, and type hooks. */
 typedef struct ecs_type_info_t ecs_type_info_t;
 
+/** Member layout of a component with struct-of-arrays storage. */
+typedef struct ecs_soa_layout_t ecs_soa_layout_t;
+
 /** Information about an entity, like its table and row. */
 typedef struct ecs_record_t ecs_record_t;
 
@@ -3560,6 +3582,26 @@ typedef
 void* (*ecs_os_api_calloc_t)(
     ecs_size_t size);
 
+/** OS API reserve function type.
+ * Reserves a range of virtual address space without backing it with memory. */
+typedef
+void* (*ecs_os_api_reserve_t)(
+    ecs_size_t size);
+
+/** OS API commit function type.
+ * Backs (part of) a reserved range with memory. Returns false on failure. */
+typedef
+bool (*ecs_os_api_commit_t)(
+    void *ptr,
+    ecs_size_t size);
+
+/** OS API release function type.
+ * Used to decommit part of a reserved range, or to release the entire range. */
+typedef
+void (*ecs_os_api_release_t)(
+    void *ptr,
+    ecs_size_t size);
+
 /** OS API strdup function type. */
 typedef
 char* (*ecs_os_api_strdup_t)(
@@ -3585,6 +3627,14 @@ void* (*ecs_os_api_thread_join_t)(
 typedef
 ecs_os_thread_id_t (*ecs_os_api_thread_self_t)(void);
 
+/** OS API thread_set_affinity function type.
+ * Pins a thread to a core. If thread is 0 the calling thread is pinned. If cpu
+ * is -1 the thread is allowed to run on any core. */
+typedef
+bool (*ecs_os_api_thread_set_affinity_t)(
+    ecs_os_thread_t thread,
+    int32_t cpu);
+
 /** OS API task_new function type. */
 typedef
 ecs_os_thread_t (*ecs_os_api_task_new_t)(
@@ -3607,6 +3657,22 @@ typedef
 int64_t (*ecs_os_api_lainc_t)(
     int64_t *value);
 
+/** OS API aload function type. */
+typedef
+int32_t (*ecs_os_api_aload_t)(
+    const int32_t *value);
+
+/** OS API aloadp function type. */
+typedef
+void* (*ecs_os_api_aloadp_t)(
+    void *const *value);
+
+/** OS API astorep function type. */
+typedef
+void (*ecs_os_api_astorep_t)(
+    void **ptr,
+    void *value);
+
 /** Mutex. */
 /** OS API mutex_new function type. */
 typedef
@@ -3760,6 +3826,12 @@ typedef struct ecs_os_api_t {
     ecs_os_api_calloc_t calloc_;                   /**< calloc callback. */
     ecs_os_api_free_t free_;                       /**< free callback. */
 
+    /* Virtual memory */
+    ecs_os_api_reserve_t reserve_;                 /**< reserve callback. */
+    ecs_os_api_commit_t commit_;                   /**< commit callback. */
+    ecs_os_api_release_t decommit_;                /**< decommit callback. */
+    ecs_os_api_release_t release_;                 /**< release callback. */
+
     /* Strings */
     ecs_os_api_strdup_t strdup_;                   /**< strdup callback. */
 
@@ -3767,16 +3839,20 @@ typedef struct ecs_os_api_t {
     ecs_os_api_thread_new_t thread_new_;           /**< thread_new callback. */
     ecs_os_api_thread_join_t thread_join_;         /**< thread_join callback. */
     ecs_os_api_thread_self_t thread_self_;         /**< thread_self callback. */
+    ecs_os_api_thread_set_affinity_t thread_set_affinity_; /**< thread_set_affinity callback. */
 
     /* Tasks */
     ecs_os_api_thread_new_t task_new_;             /**< task_new callback. */
     ecs_os_api_thread_join_t task_join_;           /**< task_join callback. */
 
-    /* Atomic increment and decrement */
+    /* Atomic increment, decrement, load and store */
     ecs_os_api_ainc_t ainc_;                       /**< ainc callback. */
     ecs_os_api_ainc_t adec_;                       /**< adec callback. */
     ecs_os_api_lainc_t lainc_;                     /**< lainc callback. */
     ecs_os_api_lainc_t ladec_;                     /**< ladec callback. */
+    ecs_os_api_aload_t aload_;                     /**< aload callback. */
+    ecs_os_api_aloadp_t aloadp_;                   /**< aloadp callback. */
+    ecs_os_api_astorep_t astorep_;                 /**< astorep callback. */
 
     /* Mutex */
     ecs_os_api_mutex_new_t mutex_new_;             /**< mutex_new callback. */
@@ -3909,6 +3985,18 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#ifndef ecs_os_reserve
+#define ecs_os_reserve(size) ecs_os_api.reserve_(size)
+#endif
+#ifndef ecs_os_commit
+#define ecs_os_commit(ptr, size) ecs_os_api.commit_(ptr, size)
+#endif
+#ifndef ecs_os_decommit
+#define ecs_os_decommit(ptr, size) ecs_os_api.decommit_(ptr, size)
+#endif
+#ifndef ecs_os_release
+#define ecs_os_release(ptr, size) ecs_os_api.release_(ptr, size)
+#endif
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -3987,6 +4075,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_thread_new(callback, param) ecs_os_api.thread_new_(callback, param)
 #define ecs_os_thread_join(thread) ecs_os_api.thread_join_(thread)
 #define ecs_os_thread_self() ecs_os_api.thread_self_()
+#define ecs_os_thread_set_affinity(thread, cpu) ecs_os_api.thread_set_affinity_(thread, cpu)
 
 /* Tasks */
 #define ecs_os_task_new(callback, param) ecs_os_api.task_new_(callback, param)
@@ -3997,6 +4086,9 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_adec(value) ecs_os_api.adec_(value)
 #define ecs_os_lainc(value) ecs_os_api.lainc_(value)
 #define ecs_os_ladec(value) ecs_os_api.ladec_(value)
+#define ecs_os_aload(value) ecs_os_api.aload_(value)
+#define ecs_os_aloadp(value) ecs_os_api.aloadp_((void *const*)(value))
+#define ecs_os_astorep(ptr, value) ecs_os_api.astorep_((void**)(ptr), value)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new_()
@@ -4236,6 +4328,10 @@ void* ecs_os_memdup(
 FLECS_API
 bool ecs_os_has_heap(void);
 
+/** Are virtual memory functions available? */
+FLECS_API
+bool ecs_os_has_virtual_memory(void);
+
 /** Are threading functions available? */
 FLECS_API
 bool ecs_os_has_threading(void);
@@ -4770,6 +4866,7 @@ struct ecs_type_info_t {
     ecs_entity_t component;  /**< Handle to component (do not set). */
     const char *name;        /**< Type name. */
     int32_t refcount;        /**< Refcount (do not set). */
+    ecs_soa_layout_t *soa;   /**< Struct-of-arrays member layout (do not set). */
 };
 
 #ifndef FLECS_API_TYPES_H
@@ -4863,6 +4960,12 @@ typedef struct ecs_page_iter_t {
 typedef struct ecs_worker_iter_t {
     int32_t index;
     int32_t count;
+    void *tasks;        /* Tasks shared between workers (work stealing) */
+    int32_t result;     /* Current result of chained iterator (work stealing) */
+    int32_t victim;     /* Worker to claim chunks from (work stealing) */
+    int32_t min_count;  /* Minimum number of entities per chunk (chunking) */
+    int32_t chunk_size; /* Maximum number of entities per chunk (chunking) */
+    int32_t chunk;      /* Next chunk in current result, -1 if none (chunking) */
 } ecs_worker_iter_t;
 
 /* Inlined element stored in a table cache. */
@@ -4948,7 +5051,9 @@ typedef struct ecs_iter_private_t {
 
 /* Data structures that store the command queue. */
 typedef struct ecs_commands_t {
-    ecs_vec_t queue;
+    ecs_vec_t queue;            /* Stream of variable length commands. */
+    int32_t count;              /* Number of commands in queue. */
+    uint32_t epoch;             /* Incremented after each flush. */
     ecs_stack_t stack;          /* Temp memory used by deferred commands. */
     ecs_sparse_t entries;       /* <entity, op_entry_t> - command batching. */
 } ecs_commands_t;
@@ -6196,6 +6301,20 @@ struct ecs_iter_t {
     ecs_iter_t *chain_it;         /**< Optional, allows for creating iterator chains. */
 };
 
+/** Prefetch table data while iterating a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * When this flag is set, a cached query issues software prefetches for the
+ * entity array and matched component columns of the next table in the cache
+ * while the current table is processed. This can improve performance of
+ * queries that read many components of tables that don't fit in the CPU
+ * cache. The flag has no effect on uncached queries. If cache_kind is left to
+ * the default value, this flag will cause it to default to EcsQueryCacheAuto.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryPrefetch              (1u << 0u)
+
 /** Query must match prefabs.
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -6220,6 +6339,18 @@ struct ecs_iter_t {
  */
 #define EcsQueryAllowUnresolvedByName (1u << 6u)
 
+/** Enable per-row change detection for a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * This flag implies EcsQueryDetectChanges. In addition, tables matched by the
+ * query keep track of which chunks of rows changed for each column, which
+ * makes it possible to use ecs_iter_changed_rows() to only process the rows
+ * that changed instead of the entire result.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryDetectRowChanges      (1u << 5u)
+
 /** Query only returns whole tables (ignores toggle or member fields).
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -6877,6 +7008,16 @@ FLECS_API extern const ecs_entity_t EcsSparse;
 /** Mark component as non-fragmenting. */
 FLECS_API extern const ecs_entity_t EcsDontFragment;
 
+/** Mark component as cold. Table columns of cold components are stored in a
+ * separate storage region of the world, away from the columns of other 
+ * components. */
+FLECS_API extern const ecs_entity_t EcsCold;
+
+/** Keep rows of tables with the component in order when entities are deleted
+ * from or moved out of the table. By default the last row of a table is moved
+ * into the row of a removed entity. */
+FLECS_API extern const ecs_entity_t EcsStableOrder;
+
 /** Marker used to indicate `$var == ...` matching in queries. */
 FLECS_API extern const ecs_entity_t EcsPredEq;
 
@@ -7262,6 +7403,122 @@ FLECS_API
 bool ecs_is_defer_suspended(
     const ecs_world_t *world);
 
+/** Enable or disable coalesced merging of commands.
+ * When enabled, commands that add, remove or set components are not applied
+ * one entity at a time. Instead the destination table of each entity in a
+ * sequence of such commands is computed first, after which entities are 
+ * grouped by their source and destination table. Each group is moved to its
+ * destination table in a single operation, which emits a single batch of 
+ * OnAdd/OnRemove events for all entities in the group.
+ *
+ * This reduces the cost of merging command queues in which many entities go
+ * through the same table transitions, like when spawning or despawning large
+ * numbers of entities. Note that coalescing reorders entities within their
+ * source table, and that observers for the entities of a group are invoked in
+ * a single batch instead of in the order in which commands were enqueued.
+ * Entities in tables with the StableOrder trait, entities with sparse or 
+ * non-fragmenting components and entities for which commands were enqueued 
+ * that change more than their table are merged as usual.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable coalesced merging.
+ */
+FLECS_API
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if coalesced merging of commands is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using coalesced merging.
+ */
+FLECS_API
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world);
+
+/** Add an id to an entity from a thread that doesn't own a stage.
+ * The async operations can be called from any thread without synchronizing
+ * with the main thread, and without creating a stage. Commands are stored in a
+ * lock-free queue, and are merged by the main thread when stages are merged
+ * (for example at the end of a pipeline sync point) or at the start of the
+ * next frame. Commands are merged in the order in which they were enqueued by
+ * a thread. No ordering is guaranteed between commands of different threads.
+ *
+ * Async operations don't access the world storage, which means that the 
+ * provided entity and id are not validated until the command is merged. If at
+ * that point the entity is no longer alive or the id is no longer valid, the 
+ * command is discarded.
+ *
+ * The async operations require the threading functions of the OS API.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Remove an id from an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Set a component from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The value is copied with memcpy when the command is
+ * enqueued, and the component's copy hook is invoked with the copied value 
+ * when the command is merged. Because of this the operation can only be used
+ * for components that can be copied with memcpy.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The component id.
+ * @param size The size of the component value.
+ * @param ptr Pointer to the component value.
+ */
+FLECS_API
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr);
+
+/** Delete an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity to delete.
+ */
+FLECS_API
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/** Enqueue an event from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The event is enqueued with ecs_enqueue() when the
+ * command is merged. The event descriptor and its ids are copied. Events must
+ * be emitted for an entity (not a table), and can't have a param.
+ *
+ * @param world The world.
+ * @param desc The event parameters.
+ */
+FLECS_API
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc);
+
 /** Configure the world to have N stages.
  * This initializes N stages, which allows applications to defer operations to
  * multiple isolated defer queues. This is typically used for applications with
@@ -7456,6 +7713,77 @@ FLECS_API
 void ecs_shrink(
     ecs_world_t *world);
 
+/** Set page size for table column storage.
+ * By default table columns are stored in a heap allocation, which is 
+ * reallocated when a table grows. For tables with many entities this means
+ * that all components are moved when the table crosses a capacity boundary,
+ * which can cause large frame spikes and temporarily doubles memory usage.
+ *
+ * When a page size is set, columns that are larger than the page size reserve
+ * a range of address space, and commit memory to it in increments of the page
+ * size as the table grows. Column data remains contiguous, and components are
+ * no longer moved when the table grows.
+ *
+ * Paged storage requires the virtual memory functions of the OS API (see
+ * ecs_os_has_virtual_memory()). If they are not available, columns are stored
+ * in heap allocations regardless of the page size. The page size only applies
+ * to columns that are allocated or resized after the operation is called.
+ * Columns of components with the #EcsCold trait are never paged.
+ *
+ * @param world The world.
+ * @param page_size The page size in bytes, or 0 to disable paged storage.
+ */
+FLECS_API
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size);
+
+/** Get page size for table column storage.
+ *
+ * @param world The world.
+ * @return The page size in bytes, or 0 if paged storage is disabled.
+ *
+ * @see ecs_set_column_page_size()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world);
+
+/** Set minimum alignment for table column storage.
+ * Table columns are aligned to the alignment of their component. This
+ * operation sets a minimum alignment for all columns, which allows systems to
+ * use aligned (SIMD) loads and stores on component arrays, and prevents 
+ * columns from sharing cache lines with other allocations.
+ *
+ * When the alignment is set, worker iterators (see ecs_worker_iter()) split
+ * tables at rows that preserve the alignment, so that the arrays of each 
+ * worker start at an aligned address. Use ecs_field_alignment() to obtain the
+ * alignment of a field in an iterator result.
+ *
+ * The alignment only applies to columns that are allocated or resized after
+ * the operation is called. Call this operation before creating entities.
+ * Columns of components with the #EcsCold trait only use the alignment of the
+ * component.
+ *
+ * @param world The world.
+ * @param alignment The alignment in bytes. Must be 0 or a power of two.
+ */
+FLECS_API
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment);
+
+/** Get minimum alignment for table column storage.
+ *
+ * @param world The world.
+ * @return The minimum alignment in bytes, or 0 if not set.
+ *
+ * @see ecs_set_column_alignment()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world);
+
 /** Get the largest issued entity ID (not counting generation).
  *
  * @param world The world.
@@ -7497,6 +7825,10 @@ typedef struct ecs_delete_empty_tables_desc_t {
     /** Table index to start scanning at. The function loops around until it
      * reaches this offset again, or until the time budget is exceeded. */
     int32_t offset;
+
+    /** Trim storage of non-empty tables that use less than this fraction of
+     * their capacity (for example 0.25). Set to 0 to disable. */
+    float shrink_ratio;
 } ecs_delete_empty_tables_desc_t;
 
 /** Clean up empty tables.
@@ -7528,6 +7860,15 @@ typedef struct ecs_delete_empty_tables_desc_t {
  * The function loops around until it reaches this offset again, or until the
  * time budget is exceeded.
  *
+ * When a table reaches the clear generation, its graph edges are pruned in
+ * addition to freeing its storage. Edges are recreated when the table is used
+ * again. When a shrink ratio is specified, the storage of non-empty tables
+ * that use less than that fraction of their capacity is trimmed to the
+ * number of entities in the table.
+ *
+ * The number of tables cleaned up and the (estimated) number of bytes that
+ * were reclaimed are reported by ecs_tables_memory_get() in the stats addon.
+ *
  * @param world The world.
  * @param desc Configuration parameters.
  * @return The index + 1 of the table where the function stopped, or 0 if the
@@ -7539,6 +7880,26 @@ int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc);
 
+/** Enable incremental table compaction.
+ * When enabled, ecs_frame_end() calls ecs_delete_empty_tables() with the
+ * provided parameters. Each frame resumes scanning at the table where the
+ * previous frame stopped, which spreads the cost of compaction over multiple
+ * frames when a time budget is set. The offset member of the descriptor is
+ * used as the initial offset.
+ *
+ * Compaction only runs from ecs_frame_end(), which requires the frame
+ * addon (FLECS_FRAME).
+ *
+ * @param world The world.
+ * @param desc Compaction parameters, or NULL to disable compaction.
+ *
+ * @see ecs_delete_empty_tables()
+ */
+FLECS_API
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc);
+
 /** Get the world from a poly.
  *
  * @param poly A pointer to a poly object.
@@ -10437,6 +10798,44 @@ uint64_t ecs_iter_get_group(
 FLECS_API
 bool ecs_iter_changed(
     ecs_iter_t *it);
+
+/** Find the next range of changed rows in the current iterator result.
+ * This operation finds the rows in the currently iterated result for which
+ * fields read by the query changed since the last time they were iterated.
+ * Row changes are tracked in chunks of 64 rows, so a returned range can
+ * contain rows that did not change.
+ *
+ * The row parameter is used both as input and output. On input it specifies
+ * the first row (relative to the result) to check, on output it contains the
+ * first row of the changed range. To find all changed ranges, call the
+ * operation in a loop, starting at 0 and advancing row by count each time:
+ *
+ * @code
+ * int32_t row = 0, count;
+ * while (ecs_iter_changed_rows(&it, &row, &count)) {
+ *   for (int32_t i = row; i < row + count; i ++) {
+ *     // process it.entities[i]
+ *   }
+ *   row += count;
+ * }
+ * @endcode
+ *
+ * If the query was not created with EcsQueryDetectRowChanges, if the table
+ * gained or lost entities, or if a field with a source other than $this
+ * changed, all remaining rows are returned as a single range.
+ *
+ * @param it The iterator.
+ * @param row The first row to check, set to the first changed row.
+ * @param count Set to the number of changed rows.
+ * @return True if a range of changed rows was found, false if not.
+ *
+ * @see ecs_iter_changed()
+ */
+FLECS_API
+bool ecs_iter_changed_rows(
+    ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count);
 #endif
 
 /** Create a paged iterator.
@@ -10496,6 +10895,51 @@ ecs_iter_t ecs_worker_iter(
     int32_t index,
     int32_t count);
 
+/** Policy for dividing entities across resources of a worker iterator.
+ * Used with ecs_worker_iter_w_chunking(). */
+typedef struct ecs_worker_chunking_t {
+    /** Minimum number of entities in a chunk. Results with fewer entities are
+     * processed as a whole by a single resource. */
+    int32_t min_count;
+
+    /** Maximum number of entities in a chunk. When set, results with more
+     * entities are split into chunks of this size. When 0, the chunk size is
+     * derived from the size of the fields, so that the fields of a chunk fit
+     * in FLECS_WORKER_CHUNK_BYTES. Results are never split into more chunks 
+     * than needed to give each resource a chunk. */
+    int32_t chunk_size;
+
+    /** Disable the chunking policy. A zero-initialized policy doesn't change
+     * the policy of a system in ecs_system_update(), so this can be used to
+     * restore the default policy of a system. */
+    bool disable;
+} ecs_worker_chunking_t;
+
+/** Create a worker iterator with a chunking policy.
+ * Same as ecs_worker_iter(), but instead of dividing each result in equal
+ * parts, results are split up into chunks according to the chunking policy.
+ * Chunks are assigned round robin to resources, starting at a resource that is
+ * determined by the table of the result. This guarantees that the same chunks
+ * of a table are assigned to the same resource as long as the number of
+ * entities in the table does not change.
+ *
+ * If both members of the chunking policy are 0 or the policy is disabled, 
+ * this function is equivalent to ecs_worker_iter(). The iterator must be 
+ * iterated with ecs_worker_next().
+ *
+ * @param it The source iterator.
+ * @param index The index of the current resource.
+ * @param count The total number of resources to divide entities between.
+ * @param chunking The chunking policy.
+ * @return A worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking);
+
 /** Progress a worker iterator.
  * Progress an iterator created by ecs_worker_iter().
  *
@@ -10582,6 +11026,39 @@ void* ecs_field_at_w_size(
     int8_t index,
     int32_t row);
 
+/** Get data for a struct member of a field with struct-of-arrays storage.
+ * Components with the SoA trait (see the meta addon) store each member of the
+ * component in a separate array. Fields for such components cannot be accessed
+ * with ecs_field(), instead this operation returns the array for a single 
+ * member, which contains it->count values:
+ *
+ * @code
+ * while (ecs_query_next(&it)) {
+ *   float *x = ecs_field_member(&it, float, 0, 0);
+ *   float *vx = ecs_field_member(&it, float, 1, 0);
+ *   for (int32_t i = 0; i < it.count; i ++) {
+ *     x[i] += vx[i];
+ *   }
+ * }
+ * @endcode
+ *
+ * The member index is the index of the member in the struct, in the order in
+ * which members were registered. The provided size must be either 0 or must
+ * match the size of the member.
+ *
+ * @param it The iterator.
+ * @param size The size of the member type.
+ * @param index The index of the field.
+ * @param member The index of the member.
+ * @return A pointer to the member array of the field.
+ */
+FLECS_API
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member);
+
 /** Test whether the field is read-only.
  * This operation returns whether the field is read-only. Read-only fields are
  * annotated with [in], or are added as a const type in the C++ API.
@@ -10657,6 +11134,27 @@ ecs_entity_t ecs_field_src(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the enabled mask for a toggleable field.
+ * If the component matched by a field can be toggled (has the CanToggle
+ * trait), this operation returns the words of the bitset that stores which
+ * entities in the iterated table have the component enabled. This lets systems
+ * that iterate whole tables (see EcsQueryTableOnly) skip disabled rows with
+ * branch-free mask operations, instead of receiving one result per span.
+ *
+ * The mask is indexed by table row, not by iterator row. The bit for entity i
+ * of the current result is stored in word (it->offset + i) / 64 at bit
+ * (it->offset + i) % 64. Rows for which the bit is not set are disabled.
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The enabled mask, or NULL if the field has no toggle bitset, is not
+ *         set, or is not matched on the iterated table.
+ */
+FLECS_API
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Return the field type size.
  * Returns the type size of the field. Returns 0 if the field has no data.
  *
@@ -10669,6 +11167,24 @@ size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the alignment of the field data.
+ * Returns the alignment of the pointer returned by ecs_field() for the current
+ * result, up to the alignment guaranteed by table storage. For fields that are
+ * owned by the iterated table this is the largest of the component alignment
+ * and the column alignment (see ecs_set_column_alignment()), unless the 
+ * iterator starts at a row that is not aligned or the component has the 
+ * #EcsCold trait. Returns 0 if the field has no
+ * data, or if the field must be accessed with ecs_field_at().
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The alignment of the field data in bytes.
+ */
+FLECS_API
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Test whether the field is matched on self.
  * This operation returns whether the field is matched on the currently iterated
  * entity. This function will return false when the field is owned by another
@@ -11620,6 +12136,25 @@ void ecs_table_clear_entities(
 
 /** @} */
 
+/**
+ * @defgroup flecs_c_async Async commands
+ * @{
+ */
+
+/** Add a component from a thread that doesn't own a stage. */
+#define ecs_async_add(world, entity, T)\
+    ecs_async_add_id(world, entity, ecs_id(T))
+
+/** Remove a component from a thread that doesn't own a stage. */
+#define ecs_async_remove(world, entity, T)\
+    ecs_async_remove_id(world, entity, ecs_id(T))
+
+/** Set a component value from a thread that doesn't own a stage. */
+#define ecs_async_set(world, entity, component, ...)\
+    ecs_async_set_id(world, entity, ecs_id(component), sizeof(component), &(component)__VA_ARGS__)
+
+/** @} */
+
 /**
  * @defgroup flecs_c_singletons Singletons
  * @{
@@ -11877,6 +12412,10 @@ void ecs_table_clear_entities(
 #define ecs_field_at(it, T, index, row)\
     (ECS_CAST(T*, ecs_field_at_w_size(it, sizeof(T), index, row)))
 
+/** Get member array of a field with struct-of-arrays storage. */
+#define ecs_field_member(it, T, index, member)\
+    (ECS_CAST(T*, ecs_field_member_w_size(it, sizeof(T), index, member)))
+
 /** @} */
 
 /**
@@ -14188,6 +14727,328 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Number of buckets in the wait time histogram of a sync point. Bucket 0
+ * counts waits shorter than a microsecond, bucket N counts waits shorter than
+ * 2^N microseconds. The last bucket counts all longer waits. */
+#ifndef FLECS_SYNC_WAIT_BUCKETS
+#define FLECS_SYNC_WAIT_BUCKETS (16)
+#endif
+
+/** Worker statistics, obtained with ecs_worker_stats_get(). */
+typedef struct ecs_worker_stats_t {
+    int64_t chunks;                /**< Number of chunks processed by worker. */
+    int64_t steals;                /**< Number of chunks stolen from other workers. */
+    int64_t idle;                  /**< Number of times worker ran out of work. */
+    int64_t spins;                 /**< Number of waits that ended while spinning. */
+    int64_t parks;                 /**< Number of waits that blocked on a condition variable. */
+    bool pinned;                   /**< Whether worker thread is pinned to a core. */
+} ecs_worker_stats_t;
+
+/** Enable or disable work stealing.
+ * By default the entities matched by a multithreaded system are divided evenly
+ * across workers, by giving each worker an equal slice of each table. When
+ * tables are small or when the cost of processing entities is uneven, this can
+ * cause workers to sit idle at the next sync point while one worker finishes.
+ *
+ * When work stealing is enabled, the results of a multithreaded system are
+ * split up into chunks. Each worker starts with an equal range of chunks, and
+ * workers that finish their range steal chunks from workers that haven't.
+ * Which entities are processed by which worker is not deterministic when work
+ * stealing is enabled.
+ *
+ * The operation may be called multiple times, but never while running a system
+ * or pipeline.
+ *
+ * @param world The world.
+ * @param enable Whether to enable work stealing.
+ */
+FLECS_API
+void ecs_set_work_stealing(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if work stealing is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using work stealing.
+ */
+FLECS_API
+bool ecs_using_work_stealing(
+    const ecs_world_t *world);
+
+/** Enable or disable dependency graph scheduling.
+ * By default each multithreaded system is divided across all workers, and
+ * workers run the systems in a pipeline op one after another. For pipelines
+ * with many small systems, the cost of dividing a system across workers can
+ * exceed the cost of running the system.
+ *
+ * When dependency graph scheduling is enabled, the multithreaded systems in a
+ * pipeline op are each run on a single worker. Systems that don't have
+ * conflicting component access, as declared by the inout kind of their terms,
+ * can run at the same time on different workers. A system that writes a
+ * component only runs after the earlier systems that read or write the same
+ * component have finished, and vice versa. Pipeline ops that contain a single
+ * system are still divided across workers.
+ *
+ * Systems without terms are assumed to access all components. The operation
+ * may be called multiple times, but never while running a system or pipeline.
+ *
+ * @param world The world.
+ * @param enable Whether to enable dependency graph scheduling.
+ */
+FLECS_API
+void ecs_set_dag_scheduling(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if dependency graph scheduling is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using dependency graph scheduling.
+ */
+FLECS_API
+bool ecs_using_dag_scheduling(
+    const ecs_world_t *world);
+
+/** Enable or disable parallel merging of command queues.
+ * When enabled, commands enqueued by multithreaded systems that assign a 
+ * component the entity already has are applied by the worker threads before
+ * the remaining commands are merged on the main thread. Entities are 
+ * distributed across workers, and an entity is only merged in parallel if all
+ * of its commands are in the same queue and don't add or remove components.
+ * If any entity has commands in more than one queue, or if any of the queues
+ * deletes or clears an entity, all queues are merged on the main thread.
+ *
+ * All other commands, as well as the OnSet observers for parallel merged 
+ * commands, are still executed on the main thread in the order in which they
+ * were enqueued. Note that this means that component values of parallel 
+ * merged entities are already assigned when the first observer of the merge 
+ * is invoked.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable parallel merging.
+ */
+FLECS_API
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if parallel merging of command queues is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using parallel merging.
+ */
+FLECS_API
+bool ecs_using_parallel_merge(
+    const ecs_world_t *world);
+
+/** Enable or disable pipelined frame execution.
+ * When enabled, the ops at the end of the pipeline that only contain systems 
+ * created with ecs_system_desc_t::pipelined don't run at the end of the frame.
+ * Instead, the data for these systems is copied at the end of the frame, and
+ * the systems are run on the copied data by the worker threads while the first 
+ * op of the next frame runs. This lets read-only systems at the end of a frame,
+ * like render extraction or network snapshotting, overlap with the systems at
+ * the start of the next frame, and removes a sync point from the frame.
+ *
+ * Pipelined systems can only read components that are double buffered with
+ * ecs_set_double_buffered(), or use fields that have no data. Commands 
+ * enqueued by pipelined systems are merged at the end of the first op of the
+ * next frame. Entities that are deleted after the data was copied are skipped
+ * when the systems run. Disabling pipelined frame execution runs the pending 
+ * systems of all pipelines.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable pipelined frame execution.
+ */
+FLECS_API
+void ecs_set_pipelined_frames(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if pipelined frame execution is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using pipelined frame execution.
+ */
+FLECS_API
+bool ecs_using_pipelined_frames(
+    const ecs_world_t *world);
+
+/** Enable or disable double buffering for a component.
+ * The values of a double buffered component are copied at the end of a frame
+ * for the pipelined systems that read the component, so that these systems can
+ * run while the next frame modifies the component. 
+ * See ecs_set_pipelined_frames().
+ *
+ * @param world The world.
+ * @param component The component.
+ * @param enable Whether to enable or disable double buffering.
+ */
+FLECS_API
+void ecs_set_double_buffered(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    bool enable);
+
+/** Return true if a component is double buffered.
+ *
+ * @param world The world.
+ * @param component The component.
+ * @return Whether the component is double buffered.
+ */
+FLECS_API
+bool ecs_is_double_buffered(
+    const ecs_world_t *world,
+    ecs_entity_t component);
+
+/** Set number of spin iterations for worker synchronization.
+ * At each sync point the main thread waits for the workers to finish, after
+ * which workers wait for the main thread to signal that they can continue.
+ * By default threads immediately block on a condition variable, which can add
+ * significant wakeup latency when a frame has many sync points.
+ *
+ * When the spin count is larger than 0, threads first poll the sync state for
+ * up to the specified number of iterations before blocking. This reduces the
+ * latency of sync points at the cost of CPU time spent spinning.
+ *
+ * The operation may be called multiple times, but never while running a 
+ * system or pipeline.
+ *
+ * @param world The world.
+ * @param spin_count The number of iterations to spin before blocking.
+ */
+FLECS_API
+void ecs_set_worker_spin_count(
+    ecs_world_t *world,
+    int32_t spin_count);
+
+/** Get number of spin iterations for worker synchronization.
+ *
+ * @param world The world.
+ * @return The number of iterations threads spin before blocking.
+ */
+FLECS_API
+int32_t ecs_get_worker_spin_count(
+    const ecs_world_t *world);
+
+/** Set minimum estimated time per thread for multithreaded sync points.
+ * By default a multithreaded sync point runs on all threads. Waking up threads
+ * costs more than it saves for sync points with little work, such as systems
+ * that match a few entities.
+ *
+ * When the minimum cost is larger than 0, the pipeline measures the time per
+ * matched entity of each multithreaded system, and uses it to estimate the time
+ * of a sync point from the number of entities its systems match. The sync 
+ * point then runs on as many threads as the estimated time allows, so that
+ * each thread gets at least the minimum cost. If a sync point would run on a
+ * single thread, it runs on the main thread without waking up the workers.
+ *
+ * The number of threads that ran a sync point is available in the 
+ * worker_count member of ecs_sync_stats_t.
+ *
+ * @param world The world.
+ * @param min_cost The minimum estimated time per thread in seconds, or 0 to 
+ *                 always use all threads.
+ */
+FLECS_API
+void ecs_set_worker_min_cost(
+    ecs_world_t *world,
+    ecs_ftime_t min_cost);
+
+/** Get minimum estimated time per thread for multithreaded sync points.
+ *
+ * @param world The world.
+ * @return The minimum estimated time per thread in seconds.
+ */
+FLECS_API
+ecs_ftime_t ecs_get_worker_min_cost(
+    const ecs_world_t *world);
+
+/** Set weight of the last measurement in the estimated cost of a system.
+ * The estimated time per entity of a system is a moving average of the 
+ * measured time per entity, where each new measurement is weighted with the
+ * provided value. A higher weight adapts faster to changes in the cost of a 
+ * system, a lower weight is less sensitive to frames that were slow for 
+ * unrelated reasons. The default is FLECS_WORKER_COST_WEIGHT (0.25), which
+ * can be overridden at compile time.
+ *
+ * The weight is only used when a minimum cost is set with 
+ * ecs_set_worker_min_cost().
+ *
+ * @param world The world.
+ * @param weight The weight of the last measurement, larger than 0 and not 
+ *               larger than 1. A weight of 1 only uses the last measurement.
+ */
+FLECS_API
+void ecs_set_worker_cost_weight(
+    ecs_world_t *world,
+    ecs_ftime_t weight);
+
+/** Get weight of the last measurement in the estimated cost of a system.
+ *
+ * @param world The world.
+ * @return The weight of the last measurement.
+ */
+FLECS_API
+ecs_ftime_t ecs_get_worker_cost_weight(
+    const ecs_world_t *world);
+
+/** Pin worker threads to cores.
+ * By default the OS is free to move worker threads between cores. On machines
+ * with multiple NUMA nodes this can cause workers to access memory that is 
+ * owned by a different node. When worker affinity is set, each worker thread
+ * pins itself to the specified core before it first uses its stage, so that
+ * the memory allocated by the stage is placed on the node of that core.
+ *
+ * Element i of the cpus array contains the core for worker i. Element 0 
+ * corresponds with the main thread, which is not pinned. Workers for which 
+ * the array contains -1, or that are not in the array, are not pinned. If
+ * threads are running, they are pinned (or unpinned) in place. Memory that 
+ * their stages already allocated is not moved to the node of the new core.
+ * Affinity is not applied to task threads, and requires an OS API with a 
+ * thread_set_affinity_ callback.
+ *
+ * When affinity is set, ecs_worker_iter() assigns tables with fewer entities 
+ * than workers to a single worker based on the table id, so that tables are
+ * processed by the same core in each frame.
+ *
+ * @param world The world.
+ * @param cpus Array with core per worker.
+ * @param count Number of elements in the cpus array, or 0 to reset affinity.
+ */
+FLECS_API
+void ecs_set_worker_affinity(
+    ecs_world_t *world,
+    const int32_t *cpus,
+    int32_t count);
+
+/** Get the core a worker thread is pinned to.
+ *
+ * @param world The world.
+ * @param worker The worker index.
+ * @return The core, or -1 if the worker is not pinned.
+ */
+FLECS_API
+int32_t ecs_get_worker_affinity(
+    const ecs_world_t *world,
+    int32_t worker);
+
+/** Get statistics for a worker.
+ * Chunk statistics are collected while work stealing is enabled. Statistics
+ * are reset when the number of threads changes. The main thread is worker 0.
+ *
+ * @param world The world.
+ * @param worker The worker index.
+ * @param stats Out parameter for statistics.
+ * @return true if success, false if the worker does not exist.
+ */
+FLECS_API
+bool ecs_worker_stats_get(
+    const ecs_world_t *world,
+    int32_t worker,
+    ecs_worker_stats_t *stats);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -14313,6 +15174,16 @@ typedef struct ecs_system_desc_t {
     /** If true, the system will have access to the actual world. Cannot be true at the
      * same time as multi_threaded. */
     bool immediate;
+
+    /** If true, the system can run while the first op of the next frame runs
+     * when pipelined frame execution is enabled. See 
+     * ecs_set_pipelined_frames(). */
+    bool pipelined;
+
+    /** Policy for dividing entities across threads when the system is 
+     * multithreaded. When left to 0, the entities of each result are divided
+     * equally across threads. See ecs_worker_iter_w_chunking(). */
+    ecs_worker_chunking_t chunking;
 } ecs_system_desc_t;
 
 /** Create a system.
@@ -14377,6 +15248,12 @@ typedef struct ecs_system_t {
     /** Whether the system is run in immediate mode. */
     bool immediate;
 
+    /** Whether the system can overlap with the next frame. */
+    bool pipelined;
+
+    /** Policy for dividing entities across threads. */
+    ecs_worker_chunking_t chunking;
+
     /** Cached system name (for perf tracing). */
     const char *name;
 
@@ -14401,6 +15278,30 @@ typedef struct ecs_system_t {
     /** Time spent on running the system. */
     ecs_ftime_t time_spent;
 
+    /** Estimated time spent per matched entity. Used to select the number of
+     * threads for a sync point. See ecs_set_worker_min_cost(). */
+    ecs_ftime_t cost_per_entity;
+
+    /** Estimated number of entities matched by the system when it last ran.
+     * For systems with a cached query this is the number of entities in the
+     * matched tables, which doesn't require evaluating the query. */
+    int32_t matched_count;
+
+    /** Number of commands enqueued by the system that were merged. Only 
+     * updated when system time is measured. */
+    int64_t commands_enqueued;
+
+    /** Number of commands enqueued by the system that were discarded, for
+     * example because the entity or component no longer existed. */
+    int64_t commands_discarded;
+
+    /** Number of commands enqueued by the system that were merged as part of
+     * a batch of commands. */
+    int64_t commands_coalesced;
+
+    /** Time spent on merging commands enqueued by the system. */
+    ecs_ftime_t command_time;
+
     /** Time passed since the last invocation. */
     ecs_ftime_t time_passed;
 
@@ -14755,6 +15656,10 @@ typedef struct ecs_query_stats_t {
 typedef struct ecs_system_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent processing a system. */
+    ecs_metric_t commands_enqueued; /**< Number of commands merged for system. */
+    ecs_metric_t commands_discarded; /**< Number of discarded commands. */
+    ecs_metric_t commands_coalesced; /**< Number of commands merged in a batch. */
+    ecs_metric_t command_time;     /**< Time spent merging commands of system. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     bool task;                     /**< Whether the system is a task. */
@@ -14767,11 +15672,17 @@ typedef struct ecs_sync_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent in sync point. */
     ecs_metric_t commands_enqueued; /**< Number of commands enqueued. */
+    ecs_metric_t wait_time;        /**< Time spent waiting for workers. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     int32_t system_count;          /**< Number of systems before sync point. */
+    int32_t worker_count;          /**< Number of threads that ran the sync point. */
     bool multi_threaded;           /**< Whether the sync point is multi-threaded. */
     bool immediate;                /**< Whether the sync point is immediate. */
+
+    /** Cumulative histogram of time spent waiting for workers since the last
+     * pipeline rebuild. See FLECS_SYNC_WAIT_BUCKETS. */
+    int64_t wait_histogram[FLECS_SYNC_WAIT_BUCKETS];
 } ecs_sync_stats_t;
 
 /** Statistics for all systems in a pipeline. */
@@ -14791,6 +15702,7 @@ typedef struct ecs_pipeline_stats_t {
     int32_t system_count;        /**< Number of systems in pipeline. */
     int32_t active_system_count; /**< Number of active systems in pipeline. */
     int32_t rebuild_count;       /**< Number of times pipeline has rebuilt. */
+    int32_t patch_count;         /**< Number of times pipeline schedule was patched. */
 } ecs_pipeline_stats_t;
 
 /** Get world statistics.
@@ -15093,6 +16005,7 @@ typedef struct {
     ecs_size_t bytes_table_components_unused; /**< Unused bytes in table columns. */
     ecs_size_t bytes_toggle_bitsets;    /**< Bytes used in bitsets (toggled components). */
     ecs_size_t bytes_sparse_components; /**< Bytes used in component sparse sets. */
+    ecs_size_t bytes_cold_components;   /**< Bytes used by table columns of cold components (included in bytes_table_components). */
 } ecs_component_memory_t;
 
 /** Component index memory. */
@@ -15136,6 +16049,8 @@ typedef struct {
     ecs_size_t bytes_component_map;     /**< Bytes used by component map. */
     ecs_size_t bytes_dirty_state;       /**< Bytes used by dirty state. */
     ecs_size_t bytes_edges;             /**< Bytes used by table graph edges. */
+    int32_t reclaimed_count;            /**< Tables deleted or trimmed by ecs_delete_empty_tables(). */
+    int64_t reclaimed_bytes;            /**< Estimated bytes returned to the OS allocator by ecs_delete_empty_tables(). */
 } ecs_table_memory_t;
 
 /** Table size histogram. */
@@ -18035,6 +18950,7 @@ FLECS_API extern const ecs_entity_t ecs_id(EcsOpaque);          /**< ID for comp
 FLECS_API extern const ecs_entity_t ecs_id(EcsUnit);            /**< ID for component that stores unit data. */
 FLECS_API extern const ecs_entity_t ecs_id(EcsUnitPrefix);      /**< ID for component that stores unit prefix data. */
 FLECS_API extern const ecs_entity_t EcsQuantity;                /**< Tag added to unit quantities. */
+FLECS_API extern const ecs_entity_t EcsSoA;                     /**< Trait that stores struct members in separate arrays. */
 
 /* Primitive type component IDs */
 
@@ -19896,6 +20812,52 @@ extern "C" {
 FLECS_API
 void ecs_set_os_api_impl(void);
 
+/** Set the maximum number of idle threads in the task pool.
+ * The POSIX OS API implementation runs tasks created with ecs_os_task_new(),
+ * which includes the tasks created by ecs_set_task_threads(), on a pool of 
+ * threads. When a thread finishes a task while the pool already has the 
+ * maximum number of idle threads, the thread exits. Threads that are kept can
+ * run the tasks of the next frame without creating a new thread.
+ *
+ * The default is 0, which means that every task runs on a new thread. Busy 
+ * threads are not limited, as tasks (like pipeline workers) can block until 
+ * other tasks are running.
+ *
+ * The task pool is not available on Windows, where this operation has no 
+ * effect.
+ *
+ * @param count The maximum number of idle threads.
+ */
+FLECS_API
+void ecs_os_set_task_pool_max_idle(
+    int32_t count);
+
+/** Submit a task to the task pool.
+ * This operation submits an application task to the pool that runs the tasks
+ * created with ecs_os_task_new(). Unlike tasks created with ecs_os_task_new(),
+ * the task does not need to be joined. Tasks that are still queued or running
+ * when the OS API is deinitialized are finished before the pool stops.
+ *
+ * On Windows the task runs on a new thread.
+ *
+ * @param callback The function to run.
+ * @param param The parameter passed to the function.
+ */
+FLECS_API
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param);
+
+/** Get the number of threads in the task pool.
+ * The pool adds a thread when a task is created while all threads are busy.
+ * Idle threads up to the count set with ecs_os_set_task_pool_max_idle() are 
+ * kept until the OS API is deinitialized. Always returns 0 on Windows.
+ *
+ * @return The number of threads in the task pool.
+ */
+FLECS_API
+int32_t ecs_os_task_pool_count(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20560,6 +21522,10 @@ static const flecs::entity_t Symbol = EcsSymbol;
 static const flecs::entity_t Sparse = EcsSparse;
 /** DontFragment storage tag. */
 static const flecs::entity_t DontFragment = EcsDontFragment;
+/** Cold storage tag. */
+static const flecs::entity_t Cold = EcsCold;
+/** StableOrder storage tag. */
+static const flecs::entity_t StableOrder = EcsStableOrder;
 
 /** PredEq query predicate. */
 static const flecs::entity_t PredEq = EcsPredEq;
@@ -22746,6 +23712,7 @@ static const flecs::entity_t F64 = ecs_id(ecs_f64_t);
 static const flecs::entity_t String = ecs_id(ecs_string_t);
 static const flecs::entity_t Entity = ecs_id(ecs_entity_t);
 static const flecs::entity_t Quantity = EcsQuantity;
+static const flecs::entity_t SoA = EcsSoA;
 
 namespace meta {
 
@@ -24813,6 +25780,10 @@ inline void set(world_t *world, flecs::entity_t entity, T&& value, flecs::id_t i
             "operation invalid for empty type");
 
     ecs_cpp_get_mut_t res = ecs_cpp_set(world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     if constexpr (std::is_copy_assignable_v<T>) {
@@ -24844,6 +25815,10 @@ inline void set(world_t *world, flecs::entity_t entity, const T& value, flecs::i
             "operation invalid for empty type");
 
     ecs_cpp_get_mut_t res = ecs_cpp_set(world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     dst = value;
@@ -24901,6 +25876,10 @@ inline void assign(world_t *world, flecs::entity_t entity, T&& value, flecs::id_
 
     ecs_cpp_get_mut_t res = ecs_cpp_assign(
         world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     if constexpr (std::is_copy_assignable_v<T>) {
@@ -24934,6 +25913,10 @@ inline void assign(world_t *world, flecs::entity_t entity, const T& value, flecs
 
     ecs_cpp_get_mut_t res = ecs_cpp_assign(
         world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     dst = value;
@@ -25240,6 +26223,96 @@ struct world {
         return ecs_is_defer_suspended(world_);
     }
 
+    /** Enable or disable coalesced merging of commands.
+     *
+     * @see ecs_set_coalesced_merge()
+     */
+    void set_coalesced_merge(bool enable = true) const {
+        ecs_set_coalesced_merge(world_, enable);
+    }
+
+    /** Test whether coalesced merging of commands is enabled.
+     *
+     * @see ecs_using_coalesced_merge()
+     */
+    bool using_coalesced_merge() const {
+        return ecs_using_coalesced_merge(world_);
+    }
+
+private:
+    /* Async operations can be called from threads that don't own a stage, 
+     * which must not register components. Get the component id without 
+     * registering it, and assert that it was registered beforehand. */
+    template <typename T>
+    flecs::entity_t async_id() const {
+        ecs_assert(_::type<T>::registered(world_), ECS_INVALID_OPERATION,
+            "component '%s' must be registered before it is used with async "
+            "operations", _::type_name<T>());
+#ifdef FLECS_MULTI_WORLD
+        return flecs_component_ids_get(world_, _::type<T>::index());
+#else
+        return _::type<T>::s_id;
+#endif
+    }
+
+public:
+    /** Add an id to an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_add_id()
+     */
+    void async_add(flecs::entity_t e, flecs::id_t id) const {
+        ecs_async_add_id(world_, e, id);
+    }
+
+    /** Add a component to an entity from a thread that doesn't own a stage.
+     * The component must be registered before this function is called, as
+     * components can't be registered from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_add_id()
+     */
+    template <typename T>
+    void async_add(flecs::entity_t e) const {
+        ecs_async_add_id(world_, e, async_id<T>());
+    }
+
+    /** Remove an id from an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_remove_id()
+     */
+    void async_remove(flecs::entity_t e, flecs::id_t id) const {
+        ecs_async_remove_id(world_, e, id);
+    }
+
+    /** Remove a component from an entity from a thread that doesn't own a 
+     * stage. The component must be registered before this function is called.
+     *
+     * @see ecs_async_remove_id()
+     */
+    template <typename T>
+    void async_remove(flecs::entity_t e) const {
+        ecs_async_remove_id(world_, e, async_id<T>());
+    }
+
+    /** Set a component from a thread that doesn't own a stage.
+     * The component must be registered before this function is called.
+     *
+     * @see ecs_async_set_id()
+     */
+    template <typename T>
+    void async_set(flecs::entity_t e, const T& value) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "async_set requires a trivially copyable component");
+        ecs_async_set_id(world_, e, async_id<T>(), sizeof(T), &value);
+    }
+
+    /** Delete an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_delete()
+     */
+    void async_delete(flecs::entity_t e) const {
+        ecs_async_delete(world_, e);
+    }
+
     /** Configure world to have N stages.
      * This initializes N stages, which allows applications to defer operations to
      * multiple isolated defer queues. This is typically used for applications with
@@ -26088,6 +27161,56 @@ struct world {
         ecs_shrink(world_);
     }
 
+    /** Enable incremental table compaction.
+     * 
+     * @see ecs_set_table_compaction()
+     */
+    void set_table_compaction(
+        const ecs_delete_empty_tables_desc_t& desc) const 
+    {
+        ecs_set_table_compaction(world_, &desc);
+    }
+
+    /** Disable incremental table compaction.
+     * 
+     * @see ecs_set_table_compaction()
+     */
+    void reset_table_compaction() const {
+        ecs_set_table_compaction(world_, nullptr);
+    }
+
+    /** Set page size for table column storage.
+     * 
+     * @see ecs_set_column_page_size()
+     */
+    void set_column_page_size(ecs_size_t page_size) const {
+        ecs_set_column_page_size(world_, page_size);
+    }
+
+    /** Get page size for table column storage.
+     * 
+     * @see ecs_get_column_page_size()
+     */
+    ecs_size_t get_column_page_size() const {
+        return ecs_get_column_page_size(world_);
+    }
+
+    /** Set minimum alignment for table column storage.
+     * 
+     * @see ecs_set_column_alignment()
+     */
+    void set_column_alignment(ecs_size_t alignment) const {
+        ecs_set_column_alignment(world_, alignment);
+    }
+
+    /** Get minimum alignment for table column storage.
+     * 
+     * @see ecs_get_column_alignment()
+     */
+    ecs_size_t get_column_alignment() const {
+        return ecs_get_column_alignment(world_);
+    }
+
     /** Begin exclusive access.
      *
      * @param thread_name Optional thread name for improved debug messages.
@@ -26626,6 +27749,98 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Enable or disable work stealing.
+ * @see ecs_set_work_stealing()
+ */
+void set_work_stealing(bool enable = true) const;
+
+/** Return true if work stealing is enabled.
+ * @see ecs_using_work_stealing()
+ */
+bool using_work_stealing() const;
+
+/** Enable or disable dependency graph scheduling.
+ * @see ecs_set_dag_scheduling()
+ */
+void set_dag_scheduling(bool enable = true) const;
+
+/** Return true if dependency graph scheduling is enabled.
+ * @see ecs_using_dag_scheduling()
+ */
+bool using_dag_scheduling() const;
+
+/** Enable or disable parallel merging of command queues.
+ * @see ecs_set_parallel_merge()
+ */
+void set_parallel_merge(bool enable = true) const;
+
+/** Return true if parallel merging of command queues is enabled.
+ * @see ecs_using_parallel_merge()
+ */
+bool using_parallel_merge() const;
+
+/** Enable or disable pipelined frame execution.
+ * @see ecs_set_pipelined_frames()
+ */
+void set_pipelined_frames(bool enable = true) const;
+
+/** Return true if pipelined frame execution is enabled.
+ * @see ecs_using_pipelined_frames()
+ */
+bool using_pipelined_frames() const;
+
+/** Enable or disable double buffering for a component.
+ * @see ecs_set_double_buffered()
+ */
+template <typename T>
+void set_double_buffered(bool enable = true) const;
+
+/** Return true if a component is double buffered.
+ * @see ecs_is_double_buffered()
+ */
+template <typename T>
+bool is_double_buffered() const;
+
+/** Set number of spin iterations for worker synchronization.
+ * @see ecs_set_worker_spin_count()
+ */
+void set_worker_spin_count(int32_t spin_count) const;
+
+/** Get number of spin iterations for worker synchronization.
+ * @see ecs_get_worker_spin_count()
+ */
+int32_t get_worker_spin_count() const;
+
+/** Set minimum estimated time per thread for multithreaded sync points.
+ * @see ecs_set_worker_min_cost()
+ */
+void set_worker_min_cost(ecs_ftime_t min_cost) const;
+
+/** Get minimum estimated time per thread for multithreaded sync points.
+ * @see ecs_get_worker_min_cost()
+ */
+ecs_ftime_t get_worker_min_cost() const;
+
+/** Set weight of the last measurement in the estimated cost of a system.
+ * @see ecs_set_worker_cost_weight()
+ */
+void set_worker_cost_weight(ecs_ftime_t weight) const;
+
+/** Get weight of the last measurement in the estimated cost of a system.
+ * @see ecs_get_worker_cost_weight()
+ */
+ecs_ftime_t get_worker_cost_weight() const;
+
+/** Pin worker threads to cores.
+ * @see ecs_set_worker_affinity()
+ */
+void set_worker_affinity(const int32_t *cpus, int32_t count) const;
+
+/** Get the core a worker thread is pinned to.
+ * @see ecs_get_worker_affinity()
+ */
+int32_t get_worker_affinity(int32_t worker) const;
+
 /** @} */
 
 #   endif
@@ -27244,6 +28459,16 @@ public:
         return ecs_field_is_set(iter_, index);
     }
 
+    /** Return the enabled mask for a toggleable field.
+     *
+     * @param index The field index.
+     * @return The enabled mask (indexed by table row), or nullptr.
+     * @see ecs_field_enabled_mask()
+     */
+    const uint64_t* enabled_mask(int8_t index) const {
+        return ecs_field_enabled_mask(iter_, index);
+    }
+
     /** Return whether the field is readonly.
      *
      * @param index The field index.
@@ -27270,6 +28495,17 @@ public:
         return ecs_field_size(iter_, index);
     }
 
+    /** Alignment of the field data.
+     *
+     * @param index The field index.
+     * @return The alignment of the field data.
+     *
+     * @see ecs_field_alignment()
+     */
+    ecs_size_t alignment(int8_t index) const {
+        return ecs_field_alignment(iter_, index);
+    }
+
     /** Obtain the field source (0 if This).
      *
      * @param index The field index.
@@ -27356,6 +28592,23 @@ public:
         return get_unchecked_field(index);
     }
 
+    /** Get access to the array of a single struct member.
+     * This function must be used to access fields for components with the SoA
+     * (struct-of-arrays) trait, which store each member in a separate array.
+     *
+     * @tparam T Type of the member.
+     * @param index The field index.
+     * @param member The index of the member in the struct.
+     * @return The member data.
+     */
+    template <typename T>
+    flecs::field<T> field_member(int8_t index, int32_t member) const {
+        bool is_shared = !ecs_field_is_self(iter_, index);
+        size_t count = is_shared ? 1 : static_cast<size_t>(iter_->count);
+        return flecs::field<T>(static_cast<T*>(ecs_field_member_w_size(
+            iter_, sizeof(T), index, member)), count, is_shared);
+    }
+
     /** Get pointer to field at row.
      * This function may be used to access shared fields when row is set to 0.
      *
@@ -27426,6 +28679,18 @@ public:
         return ecs_iter_changed(iter_);
     }
 
+    /** Find the next range of changed rows in the current result.
+     * Can only be used when iterating queries and/or systems.
+     *
+     * @param row The first row to check, set to the first changed row.
+     * @param count Set to the number of changed rows.
+     * @return True if a range of changed rows was found.
+     * @see ecs_iter_changed_rows()
+     */
+    bool changed_rows(int32_t& row, int32_t& count) {
+        return ecs_iter_changed_rows(iter_, &row, &count);
+    }
+
     /** Skip current table.
      * This indicates to the query that the data in the current table is not
      * modified. By default, iterating a table with a query will mark the
@@ -35603,6 +36868,18 @@ struct query_builder_i : term_builder_i<Base> {
         return *this;
     }
 
+    /** Prefetch table data while iterating the query. */
+    Base& prefetch() {
+        desc_->flags |= EcsQueryPrefetch;
+        return *this;
+    }
+
+    /** Enable per-row change detection for the query. */
+    Base& detect_row_changes() {
+        desc_->flags |= EcsQueryDetectRowChanges;
+        return *this;
+    }
+
     /** Set the query expression string. */
     Base& expr(const char *expr) {
         ecs_check(expr_count_ == 0, ECS_INVALID_OPERATION,
@@ -37092,6 +38369,29 @@ public:
         return *this;
     }
 
+    /** Specify whether the system can overlap with the next frame.
+     *
+     * @param value If true, the system can run while the next frame runs.
+     * @see ecs_set_pipelined_frames()
+     */
+    Base& pipelined(bool value = true) {
+        desc_->pipelined = value;
+        return *this;
+    }
+
+    /** Specify how entities are divided across threads for a multithreaded
+     * system.
+     *
+     * @param min_count Minimum number of entities processed by a thread.
+     * @param chunk_size Maximum number of entities in a chunk (0 = cache-sized chunks).
+     * @see ecs_worker_iter_w_chunking()
+     */
+    Base& chunking(int32_t min_count, int32_t chunk_size = 0) {
+        desc_->chunking.min_count = min_count;
+        desc_->chunking.chunk_size = chunk_size;
+        return *this;
+    }
+
     /** Set the system interval.
      * This operation will cause the system to be run at the specified interval.
      *
@@ -37673,6 +38973,80 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(world_);
 }
 
+inline void world::set_work_stealing(bool enable) const {
+    ecs_set_work_stealing(world_, enable);
+}
+
+inline bool world::using_work_stealing() const {
+    return ecs_using_work_stealing(world_);
+}
+
+inline void world::set_dag_scheduling(bool enable) const {
+    ecs_set_dag_scheduling(world_, enable);
+}
+
+inline bool world::using_dag_scheduling() const {
+    return ecs_using_dag_scheduling(world_);
+}
+
+inline void world::set_parallel_merge(bool enable) const {
+    ecs_set_parallel_merge(world_, enable);
+}
+
+inline bool world::using_parallel_merge() const {
+    return ecs_using_parallel_merge(world_);
+}
+
+inline void world::set_pipelined_frames(bool enable) const {
+    ecs_set_pipelined_frames(world_, enable);
+}
+
+inline bool world::using_pipelined_frames() const {
+    return ecs_using_pipelined_frames(world_);
+}
+
+template <typename T>
+inline void world::set_double_buffered(bool enable) const {
+    ecs_set_double_buffered(world_, _::type<T>::id(world_), enable);
+}
+
+template <typename T>
+inline bool world::is_double_buffered() const {
+    return ecs_is_double_buffered(world_, _::type<T>::id(world_));
+}
+
+inline void world::set_worker_spin_count(int32_t spin_count) const {
+    ecs_set_worker_spin_count(world_, spin_count);
+}
+
+inline int32_t world::get_worker_spin_count() const {
+    return ecs_get_worker_spin_count(world_);
+}
+
+inline void world::set_worker_min_cost(ecs_ftime_t min_cost) const {
+    ecs_set_worker_min_cost(world_, min_cost);
+}
+
+inline ecs_ftime_t world::get_worker_min_cost() const {
+    return ecs_get_worker_min_cost(world_);
+}
+
+inline void world::set_worker_cost_weight(ecs_ftime_t weight) const {
+    ecs_set_worker_cost_weight(world_, weight);
+}
+
+inline ecs_ftime_t world::get_worker_cost_weight() const {
+    return ecs_get_worker_cost_weight(world_);
+}
+
+inline void world::set_worker_affinity(const int32_t *cpus, int32_t count) const {
+    ecs_set_worker_affinity(world_, cpus, count);
+}
+
+inline int32_t world::get_worker_affinity(int32_t worker) const {
+    return ecs_get_worker_affinity(world_, worker);
+}
+
 }
 
 #endif
@@ -115,6 +115,20 @@ void flecs_bitset_remove(
     ecs_bitset_t *bs,
     int32_t elem);
 
+/** Remove a range from a bitset.
+ * Unlike flecs_bitset_remove(), this preserves the order of the remaining
+ * elements.
+ *
+ * @param bs The bitset to remove from.
+ * @param elem Index of the first bit to remove.
+ * @param count Number of bits to remove.
+ */
+FLECS_DBG_API
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count);
+
 /** Swap values in a bitset.
  *
  * @param bs The bitset.
@@ -754,6 +768,24 @@ void flecs_table_clear_edges_for_id(
 #define ecs_vec_from_column_t(arg_column, table, T)\
     ecs_vec_from_column(arg_column, table, ECS_SIZEOF(T))
 
+/* Number of rows that share a version stamp for row change tracking */
+#define FLECS_TABLE_DIRTY_CHUNK_BITS (6)
+#define FLECS_TABLE_DIRTY_CHUNK (1 << FLECS_TABLE_DIRTY_CHUNK_BITS)
+
+/* Version stamps are written by the workers of multithreaded systems that
+ * iterate the same table, so access them with relaxed atomics. */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_table_stamp_store(ptr, value)\
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#define flecs_table_stamp_load(ptr)\
+    __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#else
+#define flecs_table_stamp_store(ptr, value)\
+    (*(volatile int32_t*)(ptr) = (value))
+#define flecs_table_stamp_load(ptr)\
+    (*(const volatile int32_t*)(ptr))
+#endif
+
 /* Table event type for notifying tables of world events */
 typedef enum ecs_table_eventkind_t {
     EcsTableTriggersForId,
@@ -797,6 +829,14 @@ typedef struct ecs_table_overrides_t {
     ecs_ref_t *refs;                 /* Refs to base components (one for each column) */
 } ecs_table_overrides_t;
 
+/* Order of the rows of a table with StableOrder while a command flush removes
+ * rows by moving the last row of the table into the removed row. Sorting the
+ * rows by key restores the order of the table. */
+typedef struct ecs_table_row_order_t {
+    ecs_vec_t keys;                  /* vector<int32_t>, sort key of each row */
+    int32_t next;                    /* Key of the next appended row */
+} ecs_table_row_order_t;
+
 /** Infrequently accessed data not stored inline in ecs_table_t */
 typedef struct ecs_table__t {
     uint64_t hash;                   /* Type hash */
@@ -810,6 +850,12 @@ typedef struct ecs_table__t {
     int16_t bs_offset;
     ecs_bitset_t *bs_columns;        /* Bitset columns */
 
+    bool stable_order;               /* Removing rows preserves row order */
+    ecs_table_row_order_t *row_order; /* Set while rows are out of order */
+
+    ecs_vec_t *dirty_chunks;         /* Per column version of each chunk of
+                                      * FLECS_TABLE_DIRTY_CHUNK rows */
+
     struct ecs_table_record_t *records; /* Array with table records */
 
 #ifdef FLECS_DEBUG_INFO
@@ -824,10 +870,41 @@ typedef struct ecs_table__t {
 #endif
 } ecs_table__t;
 
+/* Column data is stored in a reserved address range (see column_page_size) */
+#define EcsColumnPaged (1u << 0)
+
+/* Column data is stored in a heap allocation with custom alignment */
+#define EcsColumnAligned (1u << 1)
+
+/* Column stores each member of the component in a separate array */
+#define EcsColumnSoA (1u << 2)
+
+/* Column stores a rarely accessed (cold) component. Column data is stored in
+ * the cold storage region of the world, unless EcsColumnAligned is set. */
+#define EcsColumnCold (1u << 3)
+
+/* Flags that describe how column storage is allocated */
+#define EcsColumnStorageMask (EcsColumnPaged|EcsColumnAligned)
+
+/** Member of a component with struct-of-arrays storage */
+typedef struct ecs_soa_member_t {
+    ecs_size_t offset;               /* Offset of member in component */
+    ecs_size_t size;                 /* Size of member */
+} ecs_soa_member_t;
+
+/** Struct-of-arrays layout. Member i of the element at row r is stored at
+ * data + offset_i * capacity + size_i * r. Because member offsets are aligned
+ * for the member type, so are the member arrays. */
+struct ecs_soa_layout_t {
+    ecs_soa_member_t *members;       /* Members, in order of increasing offset */
+    int32_t count;                   /* Number of members */
+};
+
 /** Table column */
 typedef struct ecs_column_t {
     void *data;                      /* Array with component data */
     ecs_type_info_t *ti;             /* Component type info */
+    ecs_flags32_t flags;             /* Column storage flags */
 } ecs_column_t;
 
 /** Table data */
@@ -914,6 +991,16 @@ void flecs_table_move(
     int32_t old_index,
     ecs_id_t emplace_id);
 
+/* Move a range of rows from one table to another. Rows are appended to the
+ * destination table and the records of moved entities are updated. Returns
+ * the index of the first row in the destination table. */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count);
+
 /* Grow table with specified number of records. Populate table with the
  * specified entity ids. */
 int32_t flecs_table_appendn(
@@ -927,11 +1014,46 @@ bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Restore order of rows of tables with StableOrder after a command flush */
+void flecs_table_restore_row_order(
+    ecs_world_t *world);
+
+/* Move cold columns of table to lower addresses in the cold storage region */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Copy value into column with struct-of-arrays storage */
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value);
+
+/* Copy value out of column with struct-of-arrays storage */
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value);
+
 /* Get dirty state for table columns */
 int32_t* flecs_table_get_dirty_state(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Enable tracking of which chunks of rows changed for table columns */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Mark range of rows in table column dirty */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count);
+
 /* Initialize root table */
 void flecs_init_root_table(
     ecs_world_t *world);
@@ -960,7 +1082,8 @@ void flecs_table_merge(
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component);
+    ecs_entity_t component,
+    int32_t row);
 
 void flecs_table_notify(
     ecs_world_t *world,
@@ -1016,6 +1139,65 @@ ecs_hashmap_t* flecs_table_get_name_index(
 
 #endif
 
+#ifndef FLECS_COLD_STORAGE_H
+#define FLECS_COLD_STORAGE_H
+
+/* Minimum size of a page in the cold region */
+#define FLECS_COLD_PAGE_SIZE (64 * 1024)
+
+/* Alignment of blocks in the cold region */
+#define FLECS_COLD_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+typedef struct ecs_cold_page_t ecs_cold_page_t;
+typedef struct ecs_cold_block_t ecs_cold_block_t;
+
+typedef struct ecs_cold_storage_t {
+    ecs_cold_page_t *first;          /* Pages in the order they were created */
+    ecs_cold_page_t *last;
+    ecs_cold_block_t *free_list;     /* Blocks that are not in use */
+    int32_t page_index;              /* Index assigned to the next page */
+    ecs_size_t bytes_reserved;       /* Bytes allocated for pages */
+    ecs_size_t bytes_used;           /* Bytes of blocks that are in use */
+} ecs_cold_storage_t;
+
+/* Initialize cold storage region. */
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage);
+
+/* Free all pages of the cold storage region. */
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage);
+
+/* Allocate block. Returns memory aligned to FLECS_COLD_ALIGNMENT. */
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size);
+
+/* Allocate block at a lower address in the region than ptr. Returns NULL if
+ * there is no space for the block before ptr. */
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr);
+
+/* Free block. Pages that become empty are returned to the OS. */
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr);
+
+/* Resize block without moving it. Returns false if the block can't grow in
+ * place, in which case the block is not modified. */
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size);
+
+/* Returns whether compacting the region could release at least one page. */
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage);
+
+#endif
+
 #ifndef FLECS_SPARSE_STORAGE_H
 #define FLECS_SPARSE_STORAGE_H
 
@@ -1322,6 +1504,10 @@ int flecs_query_trivial_has_range(
     int32_t offset,
     int32_t count);
 
+/* Estimate number of matched entities without evaluating the query */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q);
+
 /* Internal function for initializing an iterator after vars are constrained */
 void flecs_query_iter_constrain(
     ecs_iter_t *it);
@@ -1489,40 +1675,97 @@ typedef enum ecs_cmd_kind_t {
     EcsCmdSkip
 } ecs_cmd_kind_t;
 
-/* Entity specific metadata for command in queue */
+/* Entity specific metadata for command in queue. Offsets point into the
+ * command stream. */
 typedef struct ecs_cmd_entry_t {
     int32_t first;
-    int32_t last;                    /* If -1, a delete command was inserted */
+    int32_t last;
+    uint32_t epoch;                  /* Entry is invalid if it doesn't match 
+                                      * the epoch of the queue */
 } ecs_cmd_entry_t;
 
-typedef struct ecs_cmd_1_t {
-    void *value;                     /* Component value (used by set / ensure) */
-    ecs_size_t size;                 /* Size of value */
-    bool clone_value;                /* Clone entity with value (used for clone) */ 
-    bool force_delete;               /* Delete prefab tables (used for delete_with) */
-} ecs_cmd_1_t;
-
-typedef struct ecs_cmd_n_t {
-    ecs_entity_t *entities;  
-    int32_t count;
-} ecs_cmd_n_t;
-
+/* Command flags */
+#define EcsCmdValuePtr               (1u << 0) /* Command has pointer payload */
+#define EcsCmdValueInline            (1u << 1) /* Value is stored in stream */
+#define EcsCmdCloneValue             (1u << 2) /* Clone entity with value */
+#define EcsCmdForceDelete            (1u << 3) /* Delete prefab tables */
+#define EcsCmdBatched                (1u << 4) /* Applied as part of a batch */
+#define EcsCmdValueMoved             (1u << 5) /* Value moved out, storage not freed */
+
+/* Largest component value that is stored inline in the command stream */
+#define FLECS_CMD_INLINE_SIZE        (64)
+
+/* Commands are stored as a stream of variable length records. Each record 
+ * starts with a command header, optionally followed by a payload:
+ *  - no payload for commands that only need an entity and id
+ *  - a pointer for values that must have a stable address (ensure, emplace),
+ *    for the entity array of bulk_new, the name of path and the descriptor
+ *    of event commands (EcsCmdValuePtr)
+ *  - the component value itself for small trivially copyable values passed to
+ *    set (EcsCmdValueInline).
+ * Records are aligned to 8 bytes, and are decoded sequentially on flush. */
 typedef struct ecs_cmd_t {
     ecs_cmd_kind_t kind;             /* Command kind */
-    int32_t next_for_entity;         /* Next operation for entity */    
+    int32_t next_for_entity;         /* Offset of next command for entity */
     ecs_id_t id;                     /* (Component) id */
-    ecs_cmd_entry_t *entry;
     ecs_entity_t entity;             /* Entity id */
-
-    union {
-        ecs_cmd_1_t _1;              /* Data for single entity operation */
-        ecs_cmd_n_t _n;              /* Data for multi entity operation */
-    } is;
-
     ecs_entity_t system;             /* System that enqueued the command */
+    int32_t size;                    /* Value size, or entity count (bulk_new) */
+    int16_t length;                  /* Length of record, including payload */
+    ecs_flags16_t flags;             /* Command flags */
 } ecs_cmd_t;
 
-/** Callback used to capture commands of a frame */
+/* Get command at offset in command stream */
+#define flecs_cmd_at(queue, offset)\
+    ECS_CAST(ecs_cmd_t*, ECS_OFFSET(ecs_vec_first(queue), offset))
+
+/* Number of commands in a segment of the async command queue */
+#define FLECS_ASYNC_CMD_SEGMENT_SIZE (256)
+
+/* Largest component value that is stored inline in an async command */
+#define FLECS_ASYNC_CMD_INLINE_SIZE  (32)
+
+/* Command enqueued by a thread that doesn't own a stage */
+typedef struct ecs_async_cmd_t {
+    ecs_cmd_kind_t kind;             /* Command kind */
+    int32_t ready;                   /* Set by producer after writing command */
+    ecs_id_t id;                     /* (Component) id */
+    ecs_entity_t entity;             /* Entity id */
+    void *value;                     /* Component value or event descriptor */
+    ecs_size_t size;                 /* Size of component value */
+    uint64_t inline_value[FLECS_ASYNC_CMD_INLINE_SIZE / 8];
+} ecs_async_cmd_t;
+
+/* Fixed size segment of the async command queue. Producers claim slots with an
+ * atomic increment, so a slot is only written by a single thread. */
+typedef struct ecs_async_segment_t {
+    ecs_async_cmd_t cmds[FLECS_ASYNC_CMD_SEGMENT_SIZE];
+    int32_t reserved;                /* Number of slots claimed by producers */
+    int32_t read;                    /* Number of slots merged */
+    struct ecs_async_segment_t *next;
+} ecs_async_segment_t;
+
+/* Multi producer, single consumer queue for commands enqueued by threads that
+ * don't own a stage. Enqueueing a command doesn't take a lock unless the last 
+ * segment is full. Commands are merged by the main thread when stages are 
+ * merged, or at the start of a frame.
+ *
+ * The OS API has no compare-and-swap, so slots are claimed with an atomic 
+ * increment, and new segments are linked under a lock. Segment pointers that
+ * are read without the lock are published with the atomic pointer load/store
+ * functions (aloadp_, astorep_) that were added to the OS API for the queue.
+ * The queue can't be used if the OS API has no mutex support. */
+typedef struct ecs_async_queue_t {
+    ecs_async_segment_t *head;       /* Segment that is merged next */
+    ecs_async_segment_t *tail;       /* Segment that commands are appended to */
+    ecs_async_segment_t *retired;    /* Merged segments that are not reused yet */
+    ecs_async_segment_t *free;       /* Segments that can be reused */
+    int32_t producers;               /* Number of threads enqueueing commands */
+    ecs_os_mutex_t lock;             /* Protects linking of new segments */
+} ecs_async_queue_t;
+
+/** Callback used to capture commands of a frame. The commands vector is the
+ * command stream, which is iterated by advancing with the command length. */
 typedef void (*ecs_on_commands_action_t)(
     const ecs_stage_t *stage,
     const ecs_vec_t *commands,
@@ -1538,6 +1781,24 @@ void flecs_commands_fini(
     ecs_stage_t *stage,
     ecs_commands_t *cmd);
 
+/* Test whether the command queues of all stages can be merged in place by
+ * multiple threads. This is not the case if an entity is used by commands in
+ * more than one stage, or if the queues contain commands that delete entities,
+ * as the cascading deletes can affect entities owned by other threads. */
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world);
+
+/* Apply set/ensure commands that don't change the table of an entity directly
+ * to component storage. Can be called from multiple threads at the same time
+ * with different worker indices, as each worker only processes the commands 
+ * for the entities it owns. Value storage of applied commands is freed by the
+ * regular merge, which runs on the main thread. */
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count);
+
 /* Begin deferring, or return whether already deferred. */
 bool flecs_defer_cmd(
     ecs_stage_t *stage);
@@ -1661,6 +1922,18 @@ void flecs_enqueue(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_event_desc_t *desc);
+
+/* Initialize async command queue. */
+void flecs_async_init(
+    ecs_world_t *world);
+
+/* Free async command queue, discards commands that weren't merged. */
+void flecs_async_fini(
+    ecs_world_t *world);
+
+/* Merge commands that were enqueued by threads that don't own a stage. */
+void flecs_async_merge(
+    ecs_world_t *world);
  
 #endif
 
@@ -1778,6 +2051,16 @@ void flecs_commit(
     ecs_id_t emplace_id,
     ecs_flags32_t evt_flags);
 
+/* Commit a range of entities in the same table to a new table. */
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags);
+
 /* Like regular modified, but doesn't assert if entity doesn't have component. */
 void flecs_modified_id_if(
     ecs_world_t *world,
@@ -2038,6 +2321,14 @@ void* flecs_field_shared(
     size_t size,
     int8_t index);
 
+/* Find table, column and row at which the value(s) of a field are stored. 
+ * Returns -1 if the field is not stored in a table column. */
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out);
+
 /* Free iterator memory block. */
 void flecs_iter_free(
     void *ptr,
@@ -2253,6 +2544,10 @@ ecs_allocator_t* flecs_stage_get_allocator(
 ecs_stack_t* flecs_stage_get_stack_allocator(
     ecs_world_t *world);
 
+/* Allocate first pages of stage allocators from the calling thread. */
+void flecs_stage_first_touch(
+    ecs_stage_t *stage);
+
 /* Shrink memory for stage data structures. */
 void ecs_stage_shrink(
     ecs_stage_t *stage);
@@ -2315,6 +2610,14 @@ typedef struct ecs_store_t {
      * type info so it's guaranteed that this data is available while the
      * storage is cleaning up tables. */
     ecs_vec_t deleted_components;    /* vector<ecs_entity_t> */
+
+    /* Tables with StableOrder of which rows are out of order until the 
+     * current command flush is done. */
+    ecs_vec_t unordered_tables;      /* vector<uint64_t> */
+    int32_t defer_row_order;         /* Nesting level of flushes */
+
+    /* Storage region for columns of cold components */
+    ecs_cold_storage_t cold;
 } ecs_store_t;
 
 /* fini actions */
@@ -2380,6 +2683,14 @@ struct ecs_world_t {
 
     /* --  Data storage -- */
     ecs_store_t store;
+    ecs_size_t column_page_size;     /* Columns larger than this use paged storage */
+    ecs_size_t column_alignment;     /* Minimum alignment of column storage */
+
+    /* -- Table compaction -- */
+    ecs_delete_empty_tables_desc_t compaction; /* Per-frame compaction settings */
+    bool compaction_enabled;         /* Run compaction in ecs_frame_end() */
+    int32_t compaction_count;        /* Tables deleted or trimmed by cleanup */
+    int64_t compaction_bytes;        /* Bytes reclaimed by cleanup */
 
     /* -- Systems -- */
     ecs_entity_t pipeline;           /* Current pipeline */
@@ -2409,11 +2720,19 @@ struct ecs_world_t {
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
     ecs_os_cond_t sync_cond;         /* Signal that worker thread job is done */
+    ecs_os_cond_t system_cond;       /* Signal that a system finished running */
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t workers_signaled;        /* Number of workers signaled for job */
+    int32_t worker_spin_count;       /* Iterations to spin before blocking */
+    ecs_ftime_t worker_min_cost;     /* Minimum estimated op time per thread */
+    ecs_ftime_t worker_cost_weight;  /* Weight of last measurement in system cost */
+    ecs_vec_t worker_affinity;       /* Core per worker, -1 if not pinned */
+    ecs_map_t double_buffered;       /* Components copied for pipelined systems */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
+    ecs_async_queue_t async_queue;   /* Commands enqueued by non-stage threads */
 
     /* -- Exclusive access -- */
     ecs_os_thread_id_t exclusive_access; /* If set, world can only be mutated by thread */
@@ -2481,6 +2800,16 @@ void flecs_type_info_claim(
 void flecs_type_info_release(
     const ecs_type_info_t *ti);
 
+/* Test if type hooks can be used with struct-of-arrays storage. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h);
+
+/* Set struct-of-arrays layout for type. Members must be ordered by offset. */
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count);
+
 /* Notify tables with component of event (or all tables if id is 0). */
 void flecs_notify_tables(
     ecs_world_t *world,
@@ -2497,6 +2826,10 @@ uint32_t flecs_get_table_version_fast(
     const ecs_world_t *world,
     const uint64_t table_id);
 
+/* Run a table compaction step if enabled with ecs_set_table_compaction(). */
+void flecs_table_compaction_run(
+    ecs_world_t *world);
+
 /* Throws error when (OnDelete*, Panic) constraint is violated. */
 void flecs_throw_invalid_delete(
     ecs_world_t *world,
@@ -3448,6 +3781,8 @@ void flecs_bootstrap(
     flecs_bootstrap_make_alive(world, EcsCanToggle);
     flecs_bootstrap_make_alive(world, EcsSparse);
     flecs_bootstrap_make_alive(world, EcsDontFragment);
+    flecs_bootstrap_make_alive(world, EcsCold);
+    flecs_bootstrap_make_alive(world, EcsStableOrder);
     flecs_bootstrap_make_alive(world, EcsObserver);
     flecs_bootstrap_make_alive(world, EcsPairIsTag);
 
@@ -3560,6 +3895,8 @@ void flecs_bootstrap(
     flecs_bootstrap_trait(world, EcsOnDeleteTarget);
     flecs_bootstrap_trait(world, EcsSparse);
     flecs_bootstrap_trait(world, EcsDontFragment);
+    flecs_bootstrap_trait(world, EcsCold);
+    flecs_bootstrap_trait(world, EcsStableOrder);
 
     flecs_bootstrap_tag(world, EcsRemove);
     flecs_bootstrap_tag(world, EcsDelete);
@@ -3683,6 +4020,26 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t cold_trait = { EcsIdCold, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsCold }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &cold_trait,
+        .global_observer = true
+    });
+
+    static ecs_on_trait_ctx_t stable_order_trait = { EcsIdStableOrder, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsStableOrder }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &stable_order_trait,
+        .global_observer = true
+    });
+
     ecs_observer(world, {
         .query.terms = {{ .id = EcsOrderedChildren }},
         .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
@@ -3757,6 +4114,11 @@ void flecs_bootstrap(
     ecs_log_pop();
 }
 
+#ifndef FLECS_SYSTEM_PRIVATE_H
+#define FLECS_SYSTEM_PRIVATE_H
+
+#endif
+
 static ecs_table_t* flecs_find_table_remove(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -3772,40 +4134,111 @@ error:
     return NULL;
 }
 
+/* Payload size of command that stores a pointer */
+#define FLECS_CMD_PTR_SIZE ECS_SIZEOF(void*)
+
+/* Returns whether value can be stored inline in the command stream. Inline
+ * values move when the stream grows, so this is only allowed for values that
+ * are trivially copyable and don't need an address that is stable. */
+static bool flecs_cmd_can_inline(
+    const ecs_type_info_t *ti)
+{
+    return ti->size <= FLECS_CMD_INLINE_SIZE && 
+        ti->alignment <= ECS_SIZEOF(ecs_id_t) &&
+        !(ti->hooks.flags & (ECS_TYPE_HOOK_DTOR|ECS_TYPE_HOOK_COPY|
+            ECS_TYPE_HOOK_MOVE|ECS_TYPE_HOOK_COPY_CTOR|
+            ECS_TYPE_HOOK_MOVE_CTOR));
+}
+
+/* Return command value, or NULL if command has no (remaining) value */
+static void* flecs_cmd_value(
+    const ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValueInline) {
+        return ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else if (cmd->flags & EcsCmdValuePtr) {
+        return *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    }
+    return NULL;
+}
+
+static void flecs_cmd_set_ptr(
+    ecs_cmd_t *cmd,
+    void *ptr)
+{
+    ecs_assert(cmd->length >= ECS_SIZEOF(ecs_cmd_t) + FLECS_CMD_PTR_SIZE,
+        ECS_INTERNAL_ERROR, NULL);
+    *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t)) = ptr;
+    cmd->flags |= EcsCmdValuePtr;
+}
+
+/* Free value storage of command after value was moved out or destructed */
+static void flecs_cmd_free_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & (EcsCmdValuePtr|EcsCmdValueMoved)) {
+        void *ptr = *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+        if (ptr) {
+            flecs_stack_free(ptr, cmd->size);
+        }
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline|EcsCmdValueMoved));
+}
+
+/* Mark value of command as moved out without freeing its storage, so that the
+ * storage can be freed later by the thread that owns the stage stack. */
+static void flecs_cmd_move_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValuePtr) {
+        cmd->flags |= EcsCmdValueMoved;
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline));
+}
+
 static ecs_cmd_t* flecs_cmd_new(
-    ecs_stage_t *stage)
+    ecs_stage_t *stage,
+    ecs_size_t payload)
 {
-    ecs_cmd_t *cmd = ecs_vec_append_t(&stage->allocator, &stage->cmd->queue, 
-        ecs_cmd_t);
-    cmd->is._1.value = NULL;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_size_t length = ECS_SIZEOF(ecs_cmd_t) + 
+        ECS_ALIGN(payload, ECS_SIZEOF(ecs_id_t));
+    ecs_cmd_t *cmd = ecs_vec_grow_t(&stage->allocator, &commands->queue, 
+        uint8_t, length);
     cmd->id = 0;
     cmd->next_for_entity = 0;
-    cmd->entry = NULL;
     cmd->system = stage->system;
+    cmd->size = 0;
+    cmd->length = flecs_ito(int16_t, length);
+    cmd->flags = 0;
+    commands->count ++;
     return cmd;
 }
 
 static ecs_cmd_t* flecs_cmd_new_batched(
     ecs_stage_t *stage, 
-    ecs_entity_t e)
+    ecs_entity_t e,
+    ecs_size_t payload)
 {
-    ecs_vec_t *cmds = &stage->cmd->queue;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_vec_t *cmds = &commands->queue;
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
-        &stage->cmd->entries, ecs_cmd_entry_t, e);
+        &commands->entries, ecs_cmd_entry_t, e);
 
     int32_t cur = ecs_vec_count(cmds);
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, payload);
     bool is_new = false;
     if (entry) {
-        if (entry->first == -1) {
-            /* Existing but invalidated entry */
+        if (entry->epoch != commands->epoch) {
+            /* Existing entry from a queue that was already flushed */
             entry->first = cur;
-            cmd->entry = entry;
+            entry->epoch = commands->epoch;
         } else {
             int32_t last = entry->last;
-            ecs_cmd_t *arr = ecs_vec_first_t(cmds, ecs_cmd_t);
-            if (arr[last].entity == e) {
-                ecs_cmd_t *last_op = &arr[last];
+            ecs_cmd_t *last_op = flecs_cmd_at(cmds, last);
+            if (last_op->entity == e) {
                 last_op->next_for_entity = cur;
                 if (last == entry->first) {
                     /* Flip sign bit so flush logic can tell which command
@@ -3823,9 +4256,10 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     }
 
     if (is_new) {
-        cmd->entry = entry = flecs_sparse_ensure_fast_t(
-            &stage->cmd->entries, ecs_cmd_entry_t, e);
+        entry = flecs_sparse_ensure_fast_t(
+            &commands->entries, ecs_cmd_entry_t, e);
         entry->first = cur;
+        entry->epoch = commands->epoch;
     }
 
     entry->last = cur;
@@ -3833,6 +4267,32 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     return cmd;
 }
 
+/* Create command with storage for a component value. If the value can be 
+ * stored inline, it is appended to the command record. Otherwise it is
+ * allocated from the stack allocator of the command queue. */
+static ecs_cmd_t* flecs_cmd_new_w_value(
+    ecs_stage_t *stage,
+    ecs_entity_t e,
+    const ecs_type_info_t *ti,
+    bool is_inline,
+    void **value_out)
+{
+    ecs_cmd_t *cmd;
+    if (is_inline) {
+        cmd = flecs_cmd_new_batched(stage, e, ti->size);
+        cmd->flags = EcsCmdValueInline;
+        *value_out = ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else {
+        cmd = flecs_cmd_new_batched(stage, e, FLECS_CMD_PTR_SIZE);
+        *value_out = flecs_stack_alloc(
+            &stage->cmd->stack, ti->size, ti->alignment);
+        flecs_cmd_set_ptr(cmd, *value_out);
+    }
+
+    cmd->size = ti->size;
+    return cmd;
+}
+
 bool flecs_defer_begin(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -3862,7 +4322,7 @@ bool flecs_defer_modified(
     ecs_id_t id)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         if (cmd) {
             cmd->kind = EcsCmdModified;
             cmd->id = id;
@@ -3880,11 +4340,13 @@ bool flecs_defer_clone(
     bool clone_value)
 {   
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdClone;
         cmd->id = src;
         cmd->entity = entity;
-        cmd->is._1.clone_value = clone_value;
+        if (clone_value) {
+            cmd->flags |= EcsCmdCloneValue;
+        }
         return true;
     }
     return false;   
@@ -3897,11 +4359,11 @@ bool flecs_defer_path(
     const char *name)
 {
     if (stage->defer > 0) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdPath;
         cmd->entity = entity;
         cmd->id = parent;
-        cmd->is._1.value = ecs_os_strdup(name);
+        flecs_cmd_set_ptr(cmd, ecs_os_strdup(name));
         return true;
     }
     return false;
@@ -3912,7 +4374,7 @@ bool flecs_defer_delete(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdDelete;
         cmd->entity = entity;
         return true;
@@ -3925,7 +4387,7 @@ bool flecs_defer_clear(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdClear;
         cmd->entity = entity;
         return true;
@@ -3940,11 +4402,13 @@ bool flecs_defer_on_delete_action(
     bool force_delete)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdOnDeleteAction;
         cmd->id = id;
         cmd->entity = action;
-        cmd->is._1.force_delete = force_delete;
+        if (force_delete) {
+            cmd->flags |= EcsCmdForceDelete;
+        }
         return true;
     }
     return false;
@@ -3957,7 +4421,7 @@ bool flecs_defer_enable(
     bool enable)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = enable ? EcsCmdEnable : EcsCmdDisable;
         cmd->entity = entity;
         cmd->id = id;
@@ -3985,12 +4449,12 @@ bool flecs_defer_bulk_new(
         *ids_out = ids;
 
         /* Store data in cmd */
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdBulkNew;
         cmd->id = id;
-        cmd->is._n.entities = ids;
-        cmd->is._n.count = count;
+        cmd->size = count;
         cmd->entity = 0;
+        flecs_cmd_set_ptr(cmd, ids);
         return true;
     }
     return false;
@@ -4003,7 +4467,7 @@ bool flecs_defer_add(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         cmd->id = id;
         cmd->entity = entity;
@@ -4019,7 +4483,7 @@ bool flecs_defer_remove(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity); 
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0); 
         cmd->kind = EcsCmdRemove;
         cmd->id = id;
         cmd->entity = entity;
@@ -4074,10 +4538,6 @@ void* flecs_defer_emplace(
     ecs_size_t size,
     bool *is_new)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -4087,22 +4547,23 @@ void* flecs_defer_emplace(
         "provided component is not a type");
     ecs_assert(!size || size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
-    size = ti->size;
 
+    ecs_cmd_t *cmd;
     void *cmd_value = ptr.ptr;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
-        cmd_value = flecs_stack_alloc(stack, size, ti->alignment);
-
+        /* Value is returned to the application, so it can't be inlined */
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, false, &cmd_value);
         cmd->kind = EcsCmdEmplace;
-        cmd->is._1.size = size;
-        cmd->is._1.value = cmd_value;
         if (is_new) *is_new = true;
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         if (is_new) *is_new = false;
     }
 
+    cmd->entity = entity;
+    cmd->id = id;
+
     return cmd_value;
 error:
     return NULL;
@@ -4116,19 +4577,19 @@ void* flecs_defer_find_cmd_value(
 {
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
         &stage->cmd->entries, ecs_cmd_entry_t, entity);
-    if (!entry || entry->first == -1) {
+    if (!entry || entry->epoch != stage->cmd->epoch) {
         return NULL;
     }
 
-    ecs_cmd_t *cmds = ecs_vec_first_t(&stage->cmd->queue, ecs_cmd_t);
-    if (cmds[entry->last].entity != entity) {
+    ecs_vec_t *cmds = &stage->cmd->queue;
+    if (flecs_cmd_at(cmds, entry->last)->entity != entity) {
         return NULL;
     }
 
-    void *result = NULL;
+    ecs_cmd_t *result = NULL;
     int32_t cur = entry->first;
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         switch(cmd->kind) {
         case EcsCmdSet:
         case EcsCmdSetDontFragment:
@@ -4136,7 +4597,7 @@ void* flecs_defer_find_cmd_value(
         case EcsCmdEnsure:
         case EcsCmdEnsureDontFragment:
             if (cmd->id == id) {
-                result = cmd->is._1.value;
+                result = cmd;
             }
             break;
         case EcsCmdRemove:
@@ -4167,7 +4628,22 @@ void* flecs_defer_find_cmd_value(
         cur = next < 0 ? -next : next;
     } while (cur);
 
-    return result;
+    if (!result) {
+        return NULL;
+    }
+
+    if (result->flags & EcsCmdValueInline) {
+        /* Value is returned to the application, which requires a stable 
+         * address. Move it out of the command stream. The record is large 
+         * enough to store the pointer in place of the value. */
+        void *value = flecs_stack_alloc(&stage->cmd->stack, result->size, 
+            ECS_SIZEOF(ecs_id_t));
+        ecs_os_memcpy(value, flecs_cmd_value(result), result->size);
+        result->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdValueInline);
+        flecs_cmd_set_ptr(result, value);
+    }
+
+    return flecs_cmd_value(result);
 }
 
 void* flecs_defer_ensure(
@@ -4196,17 +4672,14 @@ void* flecs_defer_ensure(
         }
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_table_t *table = r->table;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
+        /* Value is returned to the application, so it can't be inlined */
+        ecs_cmd_t *cmd = flecs_cmd_new_w_value(
+            stage, entity, ti, false, &ptr.ptr);
         cmd->kind = EcsCmdEnsure;
-        cmd->is._1.size = size;
-        cmd->is._1.value = ptr.ptr = 
-            flecs_stack_alloc(stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Check if entity inherits component */
         void *base = NULL;
@@ -4223,7 +4696,10 @@ void* flecs_defer_ensure(
             flecs_type_info_copy_ctor(ptr.ptr, base, 1, ti);
         }
     } else {
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
+        cmd->entity = entity;
+        cmd->id = id;
     }
 
     return ptr.ptr;
@@ -4242,11 +4718,6 @@ void* flecs_defer_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -4265,24 +4736,30 @@ void* flecs_defer_set(
         "mismatching size specified for component in ensure/emplace/set (%u vs %u)",
             size, ti->size);
 
+    /* The returned pointer is not used after the next command is inserted, 
+     * which allows for storing small values in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                 * that a preceding remove command doesn't cause the entity to
                 * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -4291,13 +4768,16 @@ void* flecs_defer_set(
     if (!ptr.ptr) {
         bool is_dont_fragment = 
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
         flecs_type_info_copy_ctor(ptr.ptr, value, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -4325,11 +4805,6 @@ void* flecs_defer_cpp_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -4340,24 +4815,30 @@ void* flecs_defer_cpp_set(
     ecs_assert(size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
 
+    /* The C++ API assigns the value before inserting other commands, so 
+     * small trivially copyable values can be stored in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                  * that a preceding remove command doesn't cause the entity to
                  * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -4366,14 +4847,17 @@ void* flecs_defer_cpp_set(
     if (!ptr.ptr) {
         bool is_dont_fragment =
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         flecs_type_info_ctor(ptr.ptr, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -4415,7 +4899,7 @@ void* flecs_defer_cpp_assign(
             world, r->table, entity, id, ptr.ptr, value, ptr.ti);
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
     cmd->kind = EcsCmdModified;
     cmd->entity = entity;
     cmd->id = id;
@@ -4428,7 +4912,7 @@ void flecs_enqueue(
     ecs_stage_t *stage,
     ecs_event_desc_t *desc)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
     cmd->kind = EcsCmdEvent;
     cmd->entity = desc->entity;
 
@@ -4447,8 +4931,8 @@ void flecs_enqueue(
         desc_cmd->ids = NULL;
     }
 
-    cmd->is._1.value = desc_cmd;
-    cmd->is._1.size = ECS_SIZEOF(ecs_event_desc_t);
+    cmd->size = ECS_SIZEOF(ecs_event_desc_t);
+    flecs_cmd_set_ptr(cmd, desc_cmd);
 
     if (desc->param || desc->const_param) {
         ecs_assert(!(desc->const_param && desc->param), ECS_INVALID_PARAMETER, 
@@ -4475,10 +4959,10 @@ static void flecs_flush_bulk_new(
     ecs_world_t *world,
     ecs_cmd_t *cmd)
 {
-    ecs_entity_t *entities = cmd->is._n.entities;
+    ecs_entity_t *entities = flecs_cmd_value(cmd);
 
     if (cmd->id) {
-        int i, count = cmd->is._n.count;
+        int i, count = cmd->size;
         for (i = 0; i < count; i ++) {
             ecs_record_t *r = flecs_entities_ensure(world, entities[i]);
             if (!r->table) {
@@ -4525,16 +5009,16 @@ static void flecs_discard_cmd(
     ecs_cmd_t *cmd)
 {
     if (cmd->kind == EcsCmdBulkNew) {
-        ecs_os_free(cmd->is._n.entities);
+        ecs_os_free(flecs_cmd_value(cmd));
     } else if (cmd->kind == EcsCmdEvent) {
-        flecs_free_cmd_event(world, cmd->is._1.value);
+        flecs_free_cmd_event(world, flecs_cmd_value(cmd));
     } else {
         ecs_assert(cmd->kind != EcsCmdEvent, ECS_INTERNAL_ERROR, NULL);
-        void *value = cmd->is._1.value;
+        void *value = flecs_cmd_value(cmd);
         if (value) {
             flecs_dtor_value(world, cmd->id, value);
-            flecs_stack_free(value, cmd->is._1.size);
         }
+        flecs_cmd_free_value(cmd);
     }
 }
 
@@ -4589,11 +5073,191 @@ static bool flecs_remove_invalid(
     return true;
 }
 
+/* Batch add/remove commands for consecutive entities in the same table. This
+ * is the common result of adding or removing a component for all entities
+ * returned by a query, and moves all entities to the new table in a single
+ * operation. Returns the offset of the first command after the batch, or 0 if
+ * no commands were batched. */
+static int32_t flecs_cmd_batch_range(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t start)
+{
+    ecs_cmd_t *cmd = flecs_cmd_at(cmds, start);
+    ecs_cmd_kind_t kind = cmd->kind;
+    ecs_id_t id = cmd->id;
+
+    if (kind != EcsCmdAdd && kind != EcsCmdRemove) {
+        return 0;
+    }
+
+    int32_t end = ecs_vec_count(cmds);
+    int32_t cur = start + cmd->length;
+    if (cur == end) {
+        return 0;
+    }
+
+    ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+    if (!r || !r->table) {
+        return 0;
+    }
+
+    ecs_table_t *table = r->table;
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    int32_t table_count = ecs_table_count(table);
+    int32_t batch_count = 1;
+
+    /* Find number of commands that can be batched */
+    for (; cur < end; cur += cmd->length) {
+        cmd = flecs_cmd_at(cmds, cur);
+        if (cmd->kind != kind || cmd->id != id || cmd->next_for_entity) {
+            break;
+        }
+
+        int32_t next_row = row + batch_count;
+        if (next_row >= table_count) {
+            break;
+        }
+
+        if (ecs_table_entities(table)[next_row] != cmd->entity) {
+            break;
+        }
+
+        batch_count ++;
+    }
+
+    if (batch_count < 2) {
+        return 0;
+    }
+
+    if (kind == EcsCmdAdd) {
+        ecs_id_t valid_id = id;
+        if (!flecs_remove_invalid(world, id, &valid_id) || !valid_id) {
+            /* Let regular command processing handle invalid ids */
+            return 0;
+        }
+    }
+
+    ecs_table_diff_t diff = ECS_TABLE_DIFF_INIT;
+    ecs_table_t *dst_table;
+    if (kind == EcsCmdAdd) {
+        dst_table = flecs_table_traverse_add(world, table, &id, &diff);
+    } else {
+        dst_table = flecs_table_traverse_remove(world, table, &id, &diff);
+    }
+
+    if (dst_table == table) {
+        /* Nothing to move, or non-fragmenting component */
+        return 0;
+    }
+
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, table, row, batch_count, dst_table, &diff, 0);
+    flecs_defer_end(world, world->stages[0]);
+
+    if (kind == EcsCmdAdd) {
+        world->info.cmd.add_count += batch_count;
+    } else {
+        world->info.cmd.remove_count += batch_count;
+    }
+
+    world->info.cmd.batched_entity_count += batch_count;
+    world->info.cmd.batched_command_count += batch_count;
+
+    return cur;
+}
+
+/* Returns whether the value of a set or ensure command can be moved into the
+ * storage of the destination table without first constructing it.
+ * This is possible for components that are added by the batch and that are
+ * stored in a regular table column. Components with an on_replace hook are
+ * excluded, as the hook is invoked with the existing value. Components with an
+ * on_add hook or OnAdd observers are excluded, as the hook is invoked by the
+ * commit before the value is moved into the storage. A component that
+ * the entity had before the batch is moved from the source table, even if it
+ * was removed and added again by the batch. The other components added by the
+ * batch are checked by flecs_cmd_batch_has_on_add(). */
+static bool flecs_cmd_can_emplace(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    ecs_table_t *table,
+    ecs_id_t id)
+{
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    if (!cr || (cr->flags & (EcsIdSparse|EcsIdDontFragment|EcsIdHasOnAdd))) {
+        return false;
+    }
+
+    const ecs_type_info_t *ti = cr->type_info;
+    if (!ti || ti->soa || ti->hooks.on_replace || ti->hooks.on_add ||
+        (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL)) 
+    {
+        return false;
+    }
+
+    return !flecs_component_get_table(cr, src_table) &&
+        !flecs_component_get_table(cr, table);
+}
+
+/* Returns whether a component added by the batch, other than the emplaced
+ * component, has an on_add hook or OnAdd observers. These can access the 
+ * emplaced component during the commit, before its value is moved into the
+ * storage, so the component must be constructed by the commit. */
+static bool flecs_cmd_batch_has_on_add(
+    ecs_world_t *world,
+    const ecs_type_t *added,
+    ecs_id_t emplace_id)
+{
+    int32_t i;
+    for (i = 0; i < added->count; i ++) {
+        ecs_id_t id = added->array[i];
+        if (id == emplace_id) {
+            continue;
+        }
+
+        if (flecs_id_flags_get(world, id) & EcsIdHasOnAdd) {
+            return true;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr && cr->type_info && cr->type_info->hooks.on_add) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Move value of command into the component storage that was not constructed
+ * when the entity was committed to its destination table. */
+static void flecs_cmd_batch_emplace(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *r,
+    ecs_cmd_t *cmd)
+{
+    flecs_component_ptr_t dst = flecs_get_mut(
+        world, entity, cmd->id, r, cmd->size);
+    if (!dst.ptr) {
+        /* Entity was deleted or moved by a hook, value will be discarded */
+        cmd->kind = EcsCmdSkip;
+        cmd->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdBatched);
+        return;
+    }
+
+    flecs_type_info_ctor_move_dtor(dst.ptr, flecs_cmd_value(cmd), 1, dst.ti);
+    flecs_cmd_free_value(cmd);
+
+    /* Same as for other batched set commands, only OnSet observers are left
+     * to be invoked. */
+    cmd->kind = (cmd->kind == EcsCmdSet) ? EcsCmdModified : EcsCmdSkip;
+}
+
 static void flecs_cmd_batch_for_entity(
     ecs_world_t *world,
     ecs_table_diff_builder_t *diff,
     ecs_entity_t entity,
-    ecs_cmd_t *cmds,
+    ecs_vec_t *cmds,
     int32_t start)
 {
     ecs_record_t *r = flecs_entities_get(world, entity);
@@ -4609,8 +5273,14 @@ static void flecs_cmd_batch_for_entity(
     int32_t cur = start;
     int32_t next_for_entity;
 
+    /* The value of one set or ensure command in the batch can be moved into
+     * the storage of the destination table without first constructing it. */
+    ecs_id_t emplace_id = 0;
+    int32_t emplace_cmd = -1;
+    bool can_emplace = true;
+
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         ecs_id_t id = cmd->id;
         next_for_entity = cmd->next_for_entity;
         if (next_for_entity < 0) {
@@ -4661,6 +5331,7 @@ static void flecs_cmd_batch_for_entity(
         case EcsCmdAddModified:
             /* Add is batched, but keep Modified */
             cmd->kind = EcsCmdModified;
+            cmd->flags |= EcsCmdBatched;
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             break;
@@ -4668,11 +5339,19 @@ static void flecs_cmd_batch_for_entity(
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         case EcsCmdSet:
         case EcsCmdEnsure: {
+            if (can_emplace && !emplace_id && 
+                flecs_cmd_can_emplace(world, start_table, table, id)) 
+            {
+                emplace_id = id;
+                emplace_cmd = cur;
+            }
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
+            cmd->flags |= EcsCmdBatched;
             has_set = true;
             break;
         }
@@ -4681,9 +5360,17 @@ static void flecs_cmd_batch_for_entity(
              * the constructor is not invoked for the component */
             break;
         case EcsCmdRemove: {
+            if (emplace_id && ecs_id_match(emplace_id, id)) {
+                /* Component is removed again. Values must be assigned in the
+                 * order of the commands, so construct it as usual. */
+                emplace_id = 0;
+                emplace_cmd = -1;
+                can_emplace = false;
+            }
             table = flecs_find_table_remove(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         }
         case EcsCmdClear:
@@ -4698,6 +5385,10 @@ static void flecs_cmd_batch_for_entity(
             table = &world->store.root;
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
+            emplace_id = 0;
+            emplace_cmd = -1;
+            can_emplace = false;
             break;
         case EcsCmdDelete:
             /* Entity is deleted, don't batch commands after the delete */
@@ -4729,12 +5420,34 @@ static void flecs_cmd_batch_for_entity(
     diff->added.array = NULL;
     diff->added.count = 0;
 
+    /* Set and ensure values of inherited components are initialized with the
+     * value of the base by the constructor, which invokes the on_set hook. */
+    if ((emplace_cmd != -1) && (table->flags & EcsTableHasIsA)) {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
+    /* Hooks of other added components must see a constructed value */
+    if ((emplace_cmd != -1) && 
+        flecs_cmd_batch_has_on_add(world, &added, emplace_id)) 
+    {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
     /* Move entity to destination table in single operation */
     flecs_table_diff_build_noalloc(diff, &table_diff);
     flecs_defer_begin(world, world->stages[0]);
-    flecs_commit(world, entity, r, table, &table_diff, 0, 0);
+    flecs_commit(world, entity, r, table, &table_diff, emplace_id, 0);
     flecs_defer_end(world, world->stages[0]);
 
+    /* Move value into component storage that wasn't constructed by the commit
+     * before any hooks or observers can access it. */
+    if (emplace_cmd != -1) {
+        flecs_cmd_batch_emplace(
+            world, entity, r, flecs_cmd_at(cmds, emplace_cmd));
+    }
+
     /* If destination table has new sparse components, make sure they're created
      * for the entity. */
     if ((table_diff.added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) && added.count) {
@@ -4756,7 +5469,7 @@ static void flecs_cmd_batch_for_entity(
     if (has_set) {
         cur = start;
         do {
-            ecs_cmd_t *cmd = &cmds[cur];
+            ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
             next_for_entity = cmd->next_for_entity;
             if (next_for_entity < 0) {
                 next_for_entity *= -1;
@@ -4766,13 +5479,13 @@ static void flecs_cmd_batch_for_entity(
             case EcsCmdSet:
             case EcsCmdEnsure: {
                 flecs_component_ptr_t dst = flecs_get_mut(
-                    world, entity, cmd->id, r, cmd->is._1.size);
+                    world, entity, cmd->id, r, cmd->size);
 
                 /* It's possible that even though the component was set, the
                  * command queue also contained a remove command, so before we
                  * do anything ensure the entity actually has the component. */
                 if (dst.ptr) {
-                    void *ptr = cmd->is._1.value;
+                    void *ptr = flecs_cmd_value(cmd);
                     const ecs_type_info_t *ti = dst.ti;
                     if (ti->hooks.on_replace) {
                         ecs_table_t *prev_table = r->table;
@@ -4786,7 +5499,7 @@ static void flecs_cmd_batch_for_entity(
                         /* Refetch pointer as the hook could have grown the
                          * table or moved the entity to a different table. */
                         dst = flecs_get_mut(
-                            world, entity, cmd->id, r, cmd->is._1.size);
+                            world, entity, cmd->id, r, cmd->size);
                         if (!dst.ptr) {
                             cmd->kind = EcsCmdSkip;
                             break;
@@ -4799,8 +5512,7 @@ static void flecs_cmd_batch_for_entity(
                         flecs_type_info_dtor(ptr, 1, ti);
                     }
 
-                    flecs_stack_free(ptr, cmd->is._1.size);
-                    cmd->is._1.value = NULL;
+                    flecs_cmd_free_value(cmd);
 
                     if (cmd->kind == EcsCmdSet) {
                         /* A set operation is add + copy + modified. We just did
@@ -4869,6 +5581,729 @@ done:
     flecs_table_diff_builder_clear(diff);
 }
 
+/* Entity with commands that can be applied as part of a coalesced group */
+typedef struct ecs_cmd_coalesce_elem_t {
+    ecs_table_t *src;                /* Table of entity before flush */
+    ecs_table_t *dst;                /* Table of entity after flush */
+    int32_t first;                   /* Offset of first command for entity */
+    int32_t row;                     /* Row of entity in source table */
+} ecs_cmd_coalesce_elem_t;
+
+static int flecs_cmd_coalesce_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_cmd_coalesce_elem_t *e1 = ptr_1;
+    const ecs_cmd_coalesce_elem_t *e2 = ptr_2;
+    if (e1->src != e2->src) {
+        return (e1->src->id > e2->src->id) - (e1->src->id < e2->src->id);
+    }
+    if (e1->dst != e2->dst) {
+        return (e1->dst->id > e2->dst->id) - (e1->dst->id < e2->dst->id);
+    }
+    return (e1->first > e2->first) - (e1->first < e2->first);
+}
+
+static int flecs_cmd_coalesce_row_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    int32_t r1 = *(const int32_t*)ptr_1;
+    int32_t r2 = *(const int32_t*)ptr_2;
+    return (r1 > r2) - (r1 < r2);
+}
+
+/* Commands that only change the table of an entity, and can be coalesced */
+static bool flecs_cmd_coalesce_kind(
+    ecs_cmd_kind_t kind)
+{
+    return kind == EcsCmdAdd || kind == EcsCmdRemove || 
+        kind == EcsCmdSet || kind == EcsCmdEnsure || 
+        kind == EcsCmdAddModified;
+}
+
+/* Compute destination table of entity for the commands in its chain. Returns
+ * NULL if the commands for the entity can't be applied as part of a group. */
+static ecs_table_t* flecs_cmd_coalesce_dst(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t first,
+    int32_t segment_end,
+    ecs_table_t *src,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_table_t *table = src;
+    int32_t cur = first, next;
+
+    flecs_table_diff_builder_clear(diff);
+    diff->added_flags = 0;
+    diff->removed_flags = 0;
+
+    do {
+        if (cur >= segment_end) {
+            /* Entity has commands outside of segment */
+            return NULL;
+        }
+
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_cmd_kind_t kind = cmd->kind;
+        ecs_id_t id = cmd->id, valid_id = id;
+        if (!flecs_cmd_coalesce_kind(kind)) {
+            return NULL;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr) {
+            if (cr->flags & (EcsIdSparse|EcsIdDontFragment)) {
+                return NULL;
+            }
+        }
+
+        if (kind == EcsCmdSet || kind == EcsCmdEnsure) {
+            if (!cr || !cr->type_info || !flecs_cmd_value(cmd)) {
+                return NULL;
+            }
+            if (cr->type_info->hooks.on_replace) {
+                return NULL;
+            }
+        }
+
+        if (!flecs_remove_invalid(world, id, &valid_id) || valid_id != id) {
+            /* Let regular command processing run cleanup actions */
+            return NULL;
+        }
+
+        if (kind == EcsCmdRemove) {
+            table = flecs_find_table_remove(world, table, id, diff);
+        } else {
+            table = flecs_find_table_add(world, table, id, diff);
+        }
+
+        if (!table) {
+            return NULL;
+        }
+
+        next = cmd->next_for_entity;
+        if (next < 0) {
+            next *= -1;
+        }
+    } while ((cur = next));
+
+    if (table == src) {
+        return NULL;
+    }
+
+    if (diff->added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) {
+        return NULL;
+    }
+
+    return table;
+}
+
+static bool flecs_cmd_coalesce_diff_eq(
+    const ecs_table_diff_builder_t *d1,
+    const ecs_table_diff_builder_t *d2)
+{
+    if (d1->added_flags != d2->added_flags || 
+        d1->removed_flags != d2->removed_flags) 
+    {
+        return false;
+    }
+
+    int32_t added = ecs_vec_count(&d1->added);
+    int32_t removed = ecs_vec_count(&d1->removed);
+    if (added != ecs_vec_count(&d2->added) || 
+        removed != ecs_vec_count(&d2->removed)) 
+    {
+        return false;
+    }
+
+    if (added && ecs_os_memcmp(ecs_vec_first(&d1->added), 
+        ecs_vec_first(&d2->added), ECS_SIZEOF(ecs_id_t) * added)) 
+    {
+        return false;
+    }
+
+    if (removed && ecs_os_memcmp(ecs_vec_first(&d1->removed), 
+        ecs_vec_first(&d2->removed), ECS_SIZEOF(ecs_id_t) * removed)) 
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* Apply commands for a group of entities that move from the same source table
+ * to the same destination table. The entities are moved to the end of the
+ * source table, so that they can be moved to the destination table with a
+ * single range operation. */
+static void flecs_cmd_coalesce_group(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    ecs_cmd_coalesce_elem_t *elems,
+    int32_t elem_count,
+    int32_t segment_end,
+    ecs_table_diff_builder_t *diff,
+    ecs_table_diff_builder_t *tmp,
+    ecs_vec_t *rows)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_t *src = elems[0].src, *dst = elems[0].dst;
+    int32_t i, count = 0;
+
+    ecs_vec_clear(rows);
+
+    /* Observers and hooks of previous groups can't change the tables of 
+     * entities since they're deferred, but can have moved rows. Also make
+     * sure the diff of each entity matches, since the same destination can
+     * be reached with different sequences of commands. */
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, elem->first);
+        ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+        if (r->table != src) {
+            elem->src = NULL;
+            continue;
+        }
+
+        ecs_table_diff_builder_t *elem_diff = count ? tmp : diff;
+        if (flecs_cmd_coalesce_dst(world, cmds, elem->first, segment_end, 
+            src, elem_diff) != dst) 
+        {
+            elem->src = NULL;
+            continue;
+        }
+
+        if (count && !flecs_cmd_coalesce_diff_eq(diff, tmp)) {
+            elem->src = NULL;
+            continue;
+        }
+
+        elem->row = ECS_RECORD_TO_ROW(r->row);
+        ecs_vec_append_t(a, rows, int32_t)[0] = elem->row;
+        count ++;
+    }
+
+    if (count < 2) {
+        /* Let regular command processing handle remaining entities */
+        flecs_table_diff_builder_clear(diff);
+        return;
+    }
+
+    /* Swap entities that aren't in the last count rows of the table with rows
+     * that don't belong to the group. */
+    int32_t *row_array = ecs_vec_first_t(rows, int32_t);
+    qsort(row_array, flecs_itosize(count), sizeof(int32_t), 
+        flecs_cmd_coalesce_row_cmp);
+
+    int32_t tail = ecs_table_count(src) - count;
+    int32_t outside = 0;
+    while (outside < count && row_array[outside] < tail) {
+        outside ++;
+    }
+
+    int32_t swap_row = tail, tail_member = outside;
+    for (i = 0; i < outside; i ++) {
+        while (tail_member < count && row_array[tail_member] == swap_row) {
+            tail_member ++;
+            swap_row ++;
+        }
+        ecs_table_swap_rows(world, src, row_array[i], swap_row);
+        swap_row ++;
+    }
+
+    /* Save added ids and clear from diff so that they won't be emitted as
+     * part of the commit, same as for a single entity. */
+    ecs_table_diff_t table_diff;
+    ecs_type_t added = { diff->added.array, diff->added.count };
+    diff->added.array = NULL;
+    diff->added.count = 0;
+    flecs_table_diff_build_noalloc(diff, &table_diff);
+
+    int32_t dst_row = ecs_table_count(dst);
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, src, tail, count, dst, &table_diff, 0);
+    flecs_defer_end(world, world->stages[0]);
+
+    /* Assign values of set commands before OnAdd observers are invoked */
+    int32_t cmd_count = 0;
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        if (!elem->src) {
+            continue;
+        }
+
+        int32_t cur = elem->first, next;
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_entity_t e = cmd->entity;
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r->table == dst, ECS_INTERNAL_ERROR, NULL);
+
+        /* Prevent entity from being batched again */
+        if (cmd->next_for_entity < 0) {
+            cmd->next_for_entity *= -1;
+        }
+
+        do {
+            cmd = flecs_cmd_at(cmds, cur);
+            next = cmd->next_for_entity;
+            cmd_count ++;
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure: {
+                flecs_component_ptr_t ptr = flecs_get_mut(
+                    world, e, cmd->id, r, cmd->size);
+                if (ptr.ptr) {
+                    void *value = flecs_cmd_value(cmd);
+                    const ecs_type_info_t *ti = ptr.ti;
+                    bool move_hook = ti->hooks.move != NULL;
+                    flecs_type_info_move(ptr.ptr, value, 1, ti);
+                    if (move_hook) {
+                        flecs_type_info_dtor(value, 1, ti);
+                    }
+                    flecs_cmd_free_value(cmd);
+                    cmd->kind = (cmd->kind == EcsCmdSet) ? 
+                        EcsCmdModified : EcsCmdSkip;
+                    cmd->flags |= EcsCmdBatched;
+                } else {
+                    /* Component was removed by a later command */
+                    cmd->kind = EcsCmdSkip;
+                }
+                break;
+            }
+            case EcsCmdAddModified:
+                cmd->kind = EcsCmdModified;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+                cmd->kind = EcsCmdSkip;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            case EcsCmdSkip:
+                ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+                break;
+            }
+        } while ((cur = next));
+    }
+
+    /* Emit OnAdd events for all entities in the group in a single batch */
+    if (added.count) {
+        ecs_table_diff_t add_diff = ECS_TABLE_DIFF_INIT;
+        add_diff.added = added;
+        add_diff.added_flags = table_diff.added_flags;
+
+        bool update_parent_records = !table_diff.removed.count ||
+            !(src->flags & EcsTableHasParent);
+
+        flecs_defer_begin(world, world->stages[0]);
+        flecs_actions_move_add(world, dst, src, dst_row, count, &add_diff, 
+            0, false, 0, update_parent_records);
+        flecs_defer_end(world, world->stages[0]);
+    }
+
+    diff->added.array = added.array;
+    diff->added.count = added.count;
+    flecs_table_diff_builder_clear(diff);
+
+    world->info.cmd.batched_entity_count += count;
+    world->info.cmd.batched_command_count += cmd_count;
+}
+
+/* Coalesce table changes for the segment of add/remove/set commands that 
+ * starts at the specified offset. The destination table of each entity in the
+ * segment is computed first, after which entities are sorted by (source, 
+ * destination) table. Each group of entities with the same table transition 
+ * is then moved in a single operation, with a single OnAdd/OnRemove batch.
+ * Returns the offset of the first command after the segment. */
+static int32_t flecs_cmd_coalesce(
+    ecs_world_t *world,
+    ecs_commands_t *commands,
+    int32_t start,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_vec_t *cmds = &commands->queue;
+    int32_t cur, end = ecs_vec_count(cmds);
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t elems;
+    ecs_vec_init_t(a, &elems, ecs_cmd_coalesce_elem_t, 0);
+
+    for (cur = start; cur < end; cur += flecs_cmd_at(cmds, cur)->length) {
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        if (!flecs_cmd_coalesce_kind(cmd->kind)) {
+            break;
+        }
+
+        if (cmd->next_for_entity > 0) {
+            /* Not the first command for the entity */
+            continue;
+        }
+
+        if (!cmd->next_for_entity) {
+            /* Either the only command for the entity, or the last command of
+             * a chain. */
+            ecs_cmd_entry_t *entry = flecs_sparse_get_t(
+                &commands->entries, ecs_cmd_entry_t, cmd->entity);
+            if (!entry || entry->epoch != commands->epoch || 
+                entry->first != cur) 
+            {
+                continue;
+            }
+        }
+
+        ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+        if (!r || !r->table) {
+            continue;
+        }
+
+        if (r->table->_->stable_order) {
+            /* Moving rows around would change the order of the table */
+            continue;
+        }
+
+        ecs_cmd_coalesce_elem_t *elem = ecs_vec_append_t(
+            a, &elems, ecs_cmd_coalesce_elem_t);
+        elem->src = r->table;
+        elem->dst = NULL;
+        elem->first = cur;
+        elem->row = 0;
+    }
+
+    int32_t segment_end = cur;
+    int32_t i, count = ecs_vec_count(&elems);
+    if (count < 2) {
+        goto done;
+    }
+
+    ecs_cmd_coalesce_elem_t *elem_array = ecs_vec_first(&elems);
+
+    /* Find destination table of each entity */
+    int32_t valid_count = 0;
+    for (i = 0; i < count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        elem->dst = flecs_cmd_coalesce_dst(world, cmds, elem->first, 
+            segment_end, elem->src, diff);
+        if (elem->dst) {
+            elem_array[valid_count ++] = *elem;
+        }
+    }
+
+    flecs_table_diff_builder_clear(diff);
+
+    if (valid_count < 2) {
+        goto done;
+    }
+
+    qsort(elem_array, flecs_itosize(valid_count), 
+        sizeof(ecs_cmd_coalesce_elem_t), flecs_cmd_coalesce_cmp);
+
+    ecs_table_diff_builder_t tmp;
+    flecs_table_diff_builder_init(world, &tmp);
+    ecs_vec_t rows;
+    ecs_vec_init_t(a, &rows, int32_t, 0);
+
+    for (i = 0; i < valid_count; ) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        int32_t j = i + 1;
+        while (j < valid_count && elem_array[j].src == elem->src && 
+            elem_array[j].dst == elem->dst) 
+        {
+            j ++;
+        }
+
+        if ((j - i) > 1) {
+            flecs_cmd_coalesce_group(world, cmds, elem, j - i, segment_end,
+                diff, &tmp, &rows);
+        }
+
+        i = j;
+    }
+
+    ecs_vec_fini_t(a, &rows, int32_t);
+    flecs_table_diff_builder_fini(world, &tmp);
+done:
+    ecs_vec_fini_t(a, &elems, ecs_cmd_coalesce_elem_t);
+    return segment_end;
+}
+
+/* Marks entity that can't be merged in place */
+#define FLECS_CMD_NOT_INPLACE (UINT64_MAX)
+
+/* Return pointer to storage of a component that a set/ensure command can be
+ * applied to without changing the table of the entity. */
+static flecs_component_ptr_t flecs_cmd_inplace_ptr(
+    ecs_world_t *world,
+    const ecs_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+    if (!id || !flecs_cmd_value(cmd) || !flecs_entities_is_alive(world, e)) {
+        return (flecs_component_ptr_t){0};
+    }
+
+    if (id >= FLECS_HI_COMPONENT_ID || world->non_trivial_lookup[id]) {
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (!cr || (cr->flags & (EcsIdDontFragment|EcsIdSparse))) {
+            return (flecs_component_ptr_t){0};
+        }
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    flecs_component_ptr_t ptr = flecs_get_mut(world, e, id, r, cmd->size);
+    if (ptr.ptr && ptr.ti->hooks.on_replace) {
+        /* Hook must be invoked in merge order */
+        return (flecs_component_ptr_t){0};
+    }
+
+    return ptr;
+}
+
+/* Find entities owned by worker for which all commands can be merged in 
+ * place. This is the case if all commands for the entity are in the same 
+ * stage, and only assign components the entity already has. */
+static void flecs_cmd_find_inplace(
+    ecs_world_t *world,
+    ecs_map_t *entities,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+
+            if (cmd->kind == EcsCmdClone && 
+                ((uint32_t)cmd->id % (uint32_t)worker_count) == 
+                    (uint32_t)worker_index) 
+            {
+                /* Clone must copy the value of the source entity as it was at
+                 * this point in the merge. */
+                ecs_map_ensure(entities, cmd->id)[0] = FLECS_CMD_NOT_INPLACE;
+            }
+
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(entities, e);
+            if (*v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Commands for entity in multiple stages */
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure:
+                if (!flecs_cmd_inplace_ptr(world, cmd).ptr) {
+                    *v = FLECS_CMD_NOT_INPLACE;
+                    continue;
+                }
+                break;
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdSkip:
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdAddModified:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            default:
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+}
+
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world)
+{
+    bool result = true;
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count && result; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+
+            /* Deleting an entity can cascade to other entities, or remove a
+             * component from entities that are assigned in place, which would
+             * change the order in which commands are applied. */
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind == EcsCmdDelete || kind == EcsCmdClear || 
+                kind == EcsCmdOnDeleteAction) 
+            {
+                result = false;
+                break;
+            }
+
+            ecs_entity_t e = cmd->entity;
+            if (!e) {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(&entities, e);
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Entity is used by commands in multiple stages */
+                result = false;
+                break;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+
+    ecs_map_fini(&entities);
+    return result;
+}
+
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    ecs_assert(worker_count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(worker_index < worker_count, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_map_t entities;
+    ecs_map_init(&entities, &stage->allocator);
+    flecs_cmd_find_inplace(world, &entities, worker_index, worker_count);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_get(&entities, e);
+            if (!v || *v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            /* Commands no longer change the table, so entity doesn't need to
+             * be batched by the regular merge. */
+            if (cmd->next_for_entity < 0) {
+                cmd->next_for_entity *= -1;
+            }
+
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind != EcsCmdSet && kind != EcsCmdEnsure) {
+                continue;
+            }
+
+            flecs_component_ptr_t dst = flecs_cmd_inplace_ptr(world, cmd);
+            ecs_assert(dst.ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            void *ptr = flecs_cmd_value(cmd);
+            const ecs_type_info_t *ti = dst.ti;
+            bool move_hook = ti->hooks.move != NULL;
+            flecs_type_info_move(dst.ptr, ptr, 1, ti);
+            if (move_hook) {
+                flecs_type_info_dtor(ptr, 1, ti);
+            }
+
+            /* Stage stacks are not thread safe, so value storage is freed by
+             * the main thread in the regular merge. */
+            flecs_cmd_move_value(cmd);
+
+            /* Same as for batched set commands, the only thing left to do for
+             * a set is to invoke OnSet observers in the regular merge. */
+            if (kind == EcsCmdSet) {
+                cmd->kind = EcsCmdModified;
+            } else {
+                cmd->kind = EcsCmdSkip;
+            }
+
+            cmd->flags |= EcsCmdBatched;
+        }
+    }
+
+    ecs_map_fini(&entities);
+}
+
+/* Command statistics for a sequence of commands enqueued by the same system */
+typedef struct ecs_cmd_system_stats_t {
+    ecs_entity_t system;             /* System that enqueued the commands */
+    int32_t enqueued;                /* Number of commands in sequence */
+    int32_t discarded;               /* Commands that were not applied */
+    int32_t coalesced;               /* Commands applied as part of a batch */
+    ecs_time_t start;                /* Time at start of sequence */
+} ecs_cmd_system_stats_t;
+
+/* Add statistics for a sequence of commands to the system that enqueued them,
+ * and start a new sequence for the next system. */
+static void flecs_cmd_system_stats_flush(
+    ecs_world_t *world,
+    ecs_cmd_system_stats_t *stats,
+    ecs_entity_t next_system)
+{
+    double time_spent = ecs_time_measure(&stats->start);
+
+    (void)world;
+    (void)time_spent;
+
+    stats->system = next_system;
+    stats->enqueued = 0;
+    stats->discarded = 0;
+    stats->coalesced = 0;
+}
+
 /* Leave safe section. Run all deferred commands. */
 bool flecs_defer_end(
     ecs_world_t *world,
@@ -4897,6 +6332,12 @@ bool flecs_defer_end(
             merge_to_world = world->stages[0]->defer == 0;
         }
 
+        if (merge_to_world) {
+            /* Rows removed from tables with StableOrder are put back in order
+             * once, after all commands are flushed. */
+            world->store.defer_row_order ++;
+        }
+
         do {
             ecs_stage_t *dst_stage = flecs_stage_from_world(&world);
             ecs_commands_t *commands = stage->cmd;
@@ -4920,15 +6361,65 @@ bool flecs_defer_end(
                     world->on_commands_ctx_active);
             }
 
-            ecs_cmd_t *cmds = ecs_vec_first(queue);
-            int32_t i, count = ecs_vec_count(queue);
+            int32_t cur, next, end = ecs_vec_count(queue);
 
             ecs_table_diff_builder_t diff = {0};
             bool diff_builder_used = false;
-
-            for (i = 0; i < count; i ++) {
-                ecs_cmd_t *cmd = &cmds[i];
+            bool coalesce = merge_to_world && 
+                (world->flags & EcsWorldCoalesceCommands);
+            int32_t coalesced_end = 0;
+
+            /* Attribute merged commands to the systems that enqueued them */
+            ecs_cmd_system_stats_t sys_stats = {0};
+            bool measure_time = merge_to_world && 
+                (world->flags & EcsWorldMeasureSystemTime);
+            if (measure_time) {
+                ecs_os_get_time(&sys_stats.start);
+            }
+
+            /* Decode commands sequentially from the command stream. The queue
+             * doesn't grow while it's flushed, so command pointers are stable
+             * for the duration of the loop. */
+            for (cur = 0; cur < end; cur = next) {
+                ecs_cmd_t *cmd = flecs_cmd_at(queue, cur);
                 ecs_entity_t e = cmd->entity;
+                next = cur + cmd->length;
+
+                if (measure_time && (cmd->system != sys_stats.system)) {
+                    flecs_cmd_system_stats_flush(
+                        world, &sys_stats, cmd->system);
+                }
+
+                sys_stats.enqueued ++;
+
+                /* Move entities with the same table transition in a segment of
+                 * add/remove/set commands to the new table in bulk. */
+                if (coalesce && cur >= coalesced_end && 
+                    flecs_cmd_coalesce_kind(cmd->kind)) 
+                {
+                    if (!diff_builder_used) {
+                        flecs_table_diff_builder_init(world, &diff);
+                        diff_builder_used = true;
+                    }
+
+                    coalesced_end = flecs_cmd_coalesce(
+                        world, commands, cur, &diff);
+                }
+
+                /* Move entities that get the same component added or removed
+                 * to the new table in a single operation. */
+                if (merge_to_world && !cmd->next_for_entity) {
+                    int32_t batch_end = flecs_cmd_batch_range(
+                        world, queue, cur);
+                    if (batch_end) {
+                        int32_t batch_count = (batch_end - cur) / cmd->length;
+                        sys_stats.enqueued += batch_count - 1;
+                        sys_stats.coalesced += batch_count;
+                        next = batch_end;
+                        continue;
+                    }
+                }
+
                 bool is_alive = flecs_entities_is_alive(world, e);
 
                 /* A negative index indicates the first command for an entity */
@@ -4943,7 +6434,7 @@ bool flecs_defer_end(
                             diff_builder_used = true;
                         }
 
-                        flecs_cmd_batch_for_entity(world, &diff, e, cmds, i);
+                        flecs_cmd_batch_for_entity(world, &diff, e, queue, cur);
 
                         is_alive = flecs_entities_is_alive(world, e);
                     } else {
@@ -4951,17 +6442,20 @@ bool flecs_defer_end(
                     }
                 }
 
-                /* Invalidate entry */
-                if (cmd->entry) {
-                    cmd->entry->first = -1;
-                }
-
                 /* If entity is no longer alive, this could be because the queue
                  * contained both a delete and a subsequent add/remove/set which
                  * should be ignored. */
                 ecs_cmd_kind_t kind = cmd->kind;
+                bool batched = cmd->flags & EcsCmdBatched;
+                if (batched) {
+                    sys_stats.coalesced ++;
+                }
+
                 if ((kind != EcsCmdPath) && ((kind == EcsCmdSkip) || (e && !is_alive))) {
                     world->info.cmd.discard_count ++;
+                    if (!batched) {
+                        sys_stats.discarded ++;
+                    }
                     flecs_discard_cmd(world, cmd);
                     continue;
                 }
@@ -4977,9 +6471,11 @@ bool flecs_defer_end(
                             flecs_add_id(world, e, id);
                         } else {
                             world->info.cmd.discard_count ++;
+                            sys_stats.discarded ++;
                         }
                     } else {
                         world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
                         ecs_delete(world, e);
                     }
                     break;
@@ -4989,38 +6485,40 @@ bool flecs_defer_end(
                     break;
                 case EcsCmdClone:
                     if (flecs_entities_is_alive(world, id)) {
-                        ecs_clone(world, e, id, cmd->is._1.clone_value);
+                        ecs_clone(world, e, id, 
+                            cmd->flags & EcsCmdCloneValue);
                         world->info.cmd.other_count ++;
                     } else {
                         world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
                     }
                     break;
                 case EcsCmdSet:
                 case EcsCmdSetDontFragment:
                     flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.set_count ++;
                     break;
                 case EcsCmdEmplace:
                     if (merge_to_world) {
                         bool is_new;
                         ecs_emplace_id(world, e, id, 
-                            flecs_itosize(cmd->is._1.size), &is_new);
+                            flecs_itosize(cmd->size), &is_new);
                         if (!is_new) {
                             kind = EcsCmdEnsure;
                         }
                     }
                     flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.ensure_count ++;
                     break;
                 case EcsCmdEnsure:
                 case EcsCmdEnsureDontFragment:
                     flecs_set_id_move(world, dst_stage, e,
-                        cmd->id, flecs_itosize(cmd->is._1.size),
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size),
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.ensure_count ++;
                     break;
                 case EcsCmdModified:
@@ -5048,7 +6546,7 @@ bool flecs_defer_end(
                 case EcsCmdOnDeleteAction:
                     ecs_defer_begin(world);
                     flecs_on_delete(world, id, e, false,
-                        cmd->is._1.force_delete);
+                        cmd->flags & EcsCmdForceDelete);
                     ecs_defer_end(world);
                     world->info.cmd.other_count ++;
                     break;
@@ -5076,15 +6574,15 @@ bool flecs_defer_end(
                         }
                     }
                     if (keep_alive) {
-                        ecs_set_name(world, e, cmd->is._1.value);
+                        ecs_set_name(world, e, flecs_cmd_value(cmd));
                     }
-                    ecs_os_free(cmd->is._1.value);
-                    cmd->is._1.value = NULL;
+                    ecs_os_free(flecs_cmd_value(cmd));
+                    cmd->flags = 0;
                     world->info.cmd.other_count ++;
                     break;
                 }
                 case EcsCmdEvent: {
-                    ecs_event_desc_t *desc = cmd->is._1.value;
+                    ecs_event_desc_t *desc = flecs_cmd_value(cmd);
                     ecs_assert(desc != NULL, ECS_INTERNAL_ERROR, NULL);
                     ecs_emit((ecs_world_t*)stage, desc);
                     flecs_free_cmd_event(world, desc);
@@ -5095,15 +6593,21 @@ bool flecs_defer_end(
                     break;
                 }
 
-                if (cmd->is._1.value) {
-                    flecs_stack_free(cmd->is._1.value, cmd->is._1.size);
-                }
+                flecs_cmd_free_value(cmd);
+            }
+
+            if (measure_time) {
+                flecs_cmd_system_stats_flush(world, &sys_stats, 0);
             }
 
             stage->cmd_flushing = false;
 
+            /* Invalidate entries, as their offsets point into the queue */
+            commands->epoch ++;
+
             flecs_stack_reset(&commands->stack);
             ecs_vec_clear(queue);
+            commands->count = 0;
 
             if (diff_builder_used) {
                 flecs_table_diff_builder_fini(world, &diff);
@@ -5116,6 +6620,10 @@ bool flecs_defer_end(
             }
         } while (true);
 
+        if (merge_to_world && !--world->store.defer_row_order) {
+            flecs_table_restore_row_order(world);
+        }
+
         ecs_os_perf_trace_pop("flecs.commands.merge");
 
         return true;
@@ -5136,13 +6644,15 @@ bool flecs_defer_purge(
         ecs_vec_t commands = stage->cmd->queue;
 
         if (ecs_vec_count(&commands)) {
-            ecs_cmd_t *cmds = ecs_vec_first(&commands);
-            int32_t i, count = ecs_vec_count(&commands);
-            for (i = 0; i < count; i ++) {
-                flecs_discard_cmd(world, &cmds[i]);
+            int32_t cur, end = ecs_vec_count(&commands);
+            ecs_cmd_t *cmd;
+            for (cur = 0; cur < end; cur += cmd->length) {
+                cmd = flecs_cmd_at(&commands, cur);
+                flecs_discard_cmd(world, cmd);
             }
 
-            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, ecs_cmd_t);
+            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, uint8_t);
+            stage->cmd->count = 0;
 
             ecs_vec_clear(&commands);
             flecs_stack_reset(&stage->cmd->stack);
@@ -5161,7 +6671,9 @@ void flecs_commands_init(
     ecs_commands_t *cmd)
 {
     flecs_stack_init(&cmd->stack);
-    ecs_vec_init_t(&stage->allocator, &cmd->queue, ecs_cmd_t, 0);
+    ecs_vec_init_t(&stage->allocator, &cmd->queue, uint8_t, 0);
+    cmd->count = 0;
+    cmd->epoch = 0;
     flecs_sparse_init_t(&cmd->entries, &stage->allocator,
         &stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t);
 }
@@ -5174,10 +6686,242 @@ void flecs_commands_fini(
     ecs_assert(ecs_vec_count(&cmd->queue) == 0, ECS_INTERNAL_ERROR, NULL);
 
     flecs_stack_fini(&cmd->stack);
-    ecs_vec_fini_t(&stage->allocator, &cmd->queue, ecs_cmd_t);
+    ecs_vec_fini_t(&stage->allocator, &cmd->queue, uint8_t);
     flecs_sparse_fini(&cmd->entries);
 }
 
+void flecs_async_init(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_os_zeromem(q);
+    if (ecs_os_has_threading()) {
+        q->lock = ecs_os_mutex_new();
+    }
+}
+
+static void flecs_async_cmd_free(
+    ecs_async_cmd_t *cmd)
+{
+    if (cmd->value && (cmd->value != cmd->inline_value)) {
+        ecs_os_free(cmd->value);
+    }
+    cmd->value = NULL;
+}
+
+static void flecs_async_segments_free(
+    ecs_async_segment_t *seg)
+{
+    while (seg) {
+        ecs_async_segment_t *next = seg->next;
+        ecs_os_free(seg);
+        seg = next;
+    }
+}
+
+void flecs_async_fini(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = q->head;
+
+    /* Free values of commands that weren't merged */
+    while (seg) {
+        int32_t i, count = ecs_os_aload(&seg->reserved);
+        if (count > FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            count = FLECS_ASYNC_CMD_SEGMENT_SIZE;
+        }
+        for (i = seg->read; i < count; i ++) {
+            flecs_async_cmd_free(&seg->cmds[i]);
+        }
+        seg = seg->next;
+    }
+
+    flecs_async_segments_free(q->head);
+    flecs_async_segments_free(q->retired);
+    flecs_async_segments_free(q->free);
+
+    if (q->lock) {
+        ecs_os_mutex_free(q->lock);
+    }
+
+    ecs_os_zeromem(q);
+}
+
+/* Claim a slot in the async queue. This only takes a lock if the last segment
+ * of the queue is full. */
+static ecs_async_cmd_t* flecs_async_cmd_new(
+    ecs_async_queue_t *q)
+{
+    ecs_assert(q != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(q->lock != 0, ECS_INTERNAL_ERROR, NULL);
+
+    /* Segments are only reused by the consumer while no producer is active */
+    ecs_os_ainc(&q->producers);
+
+    do {
+        ecs_async_segment_t *seg = ecs_os_aloadp(&q->tail);
+        if (seg) {
+            int32_t index = ecs_os_ainc(&seg->reserved) - 1;
+            if (index < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+                return &seg->cmds[index];
+            }
+        }
+
+        ecs_os_mutex_lock(q->lock);
+        if (q->tail == seg) {
+            /* No other thread linked a new segment yet */
+            ecs_async_segment_t *new_seg = q->free;
+            if (new_seg) {
+                q->free = new_seg->next;
+                new_seg->next = NULL;
+            } else {
+                new_seg = ecs_os_calloc_t(ecs_async_segment_t);
+            }
+
+            /* Publish the segment after it is initialized */
+            if (seg) {
+                seg->next = new_seg;
+            } else {
+                ecs_os_astorep(&q->head, new_seg);
+            }
+            ecs_os_astorep(&q->tail, new_seg);
+        }
+        ecs_os_mutex_unlock(q->lock);
+    } while (true);
+}
+
+/* Make command visible to the consumer */
+static void flecs_async_cmd_publish(
+    ecs_async_queue_t *q,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_os_ainc(&cmd->ready);
+    ecs_os_adec(&q->producers);
+}
+
+static void flecs_async_cmd_apply(
+    ecs_world_t *world,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+
+    if (cmd->kind == EcsCmdEvent) {
+        if (!e || ecs_is_alive(world, e)) {
+            ecs_enqueue(world, cmd->value);
+            world->info.cmd.event_count ++;
+        } else {
+            world->info.cmd.discard_count ++;
+        }
+    } else if (!ecs_is_alive(world, e) || (id && !ecs_id_is_valid(world, id))) {
+        world->info.cmd.discard_count ++;
+    } else {
+        switch(cmd->kind) {
+        case EcsCmdAdd:
+            ecs_add_id(world, e, id);
+            break;
+        case EcsCmdRemove:
+            ecs_remove_id(world, e, id);
+            break;
+        case EcsCmdSet:
+            ecs_set_id(world, e, id, flecs_itosize(cmd->size), cmd->value);
+            break;
+        case EcsCmdDelete:
+            ecs_delete(world, e);
+            break;
+        case EcsCmdClone:
+        case EcsCmdBulkNew:
+        case EcsCmdSetDontFragment:
+        case EcsCmdEmplace:
+        case EcsCmdEnsure:
+        case EcsCmdEnsureDontFragment:
+        case EcsCmdModified:
+        case EcsCmdModifiedNoHook:
+        case EcsCmdAddModified:
+        case EcsCmdPath:
+        case EcsCmdClear:
+        case EcsCmdOnDeleteAction:
+        case EcsCmdEnable:
+        case EcsCmdDisable:
+        case EcsCmdEvent:
+        case EcsCmdSkip:
+            ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+            break;
+        }
+    }
+
+    flecs_async_cmd_free(cmd);
+}
+
+void flecs_async_merge(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = ecs_os_aloadp(&q->head);
+    if (!seg) {
+        return;
+    }
+
+    if (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE && 
+        seg->read >= ecs_os_aload(&seg->reserved) && !q->retired) 
+    {
+        /* Nothing to merge */
+        return;
+    }
+
+    /* Merged commands are enqueued to the regular command queue, so that
+     * they're batched with other commands. */
+    ecs_defer_begin(world);
+
+    do {
+        while (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            ecs_async_cmd_t *cmd = &seg->cmds[seg->read];
+            if (ecs_os_adec(&cmd->ready)) {
+                /* Command is claimed but not yet written. Restore the flag and
+                 * stop, so that commands of a thread stay in order. */
+                ecs_os_ainc(&cmd->ready);
+                goto done;
+            }
+
+            flecs_async_cmd_apply(world, cmd);
+            seg->read ++;
+        }
+
+        /* Segment is merged, continue with the next segment */
+        ecs_os_mutex_lock(q->lock);
+        ecs_async_segment_t *next = seg->next;
+        if (next) {
+            q->head = next;
+            seg->next = q->retired;
+            q->retired = seg;
+        }
+        ecs_os_mutex_unlock(q->lock);
+
+        seg = next;
+    } while (seg);
+done:
+    ecs_defer_end(world);
+
+    /* Retired segments can be reused once no producer holds a pointer to them.
+     * Producers that start after this point can only see the tail segment. */
+    if (q->retired) {
+        int32_t producers = ecs_os_ainc(&q->producers) - 1;
+        ecs_os_adec(&q->producers);
+        if (!producers) {
+            ecs_os_mutex_lock(q->lock);
+            while ((seg = q->retired)) {
+                q->retired = seg->next;
+                seg->reserved = 0;
+                seg->read = 0;
+                seg->next = q->free;
+                q->free = seg;
+            }
+            ecs_os_mutex_unlock(q->lock);
+        }
+    }
+}
+
 bool ecs_defer_begin(
     ecs_world_t *world)
 {
@@ -5224,6 +6968,178 @@ error:
     return;
 }
 
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change coalesced merge while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldCoalesceCommands, enable);
+error:
+    return;
+}
+
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldCoalesceCommands);
+error:
+    return false;
+}
+
+/* Returns NULL if the queue has no lock because threading isn't set up */
+static ecs_async_queue_t* flecs_async_queue(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_check(q->lock != 0, ECS_MISSING_OS_API, 
+        "async commands require the threading OS API");
+    if (!q->lock) {
+        /* Checks are compiled out in release builds */
+        return NULL;
+    }
+    return q;
+error:
+    return NULL;
+}
+
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdAdd;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdRemove;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ptr != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    ecs_size_t value_size = flecs_uto(ecs_size_t, size);
+    cmd->kind = EcsCmdSet;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->size = value_size;
+    if (value_size <= FLECS_ASYNC_CMD_INLINE_SIZE) {
+        cmd->value = cmd->inline_value;
+    } else {
+        cmd->value = ecs_os_malloc(value_size);
+    }
+    ecs_os_memcpy(cmd->value, ptr, value_size);
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdDelete;
+    cmd->entity = entity;
+    cmd->id = 0;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc)
+{
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->event != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->table == NULL, ECS_INVALID_PARAMETER, 
+        "async events can only be emitted for entities");
+    ecs_check(!desc->param && !desc->const_param, ECS_INVALID_PARAMETER,
+        "async events can't have a param");
+    ecs_check(desc->ids != NULL && desc->ids->count != 0, 
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+
+    /* Store descriptor, type and ids in a single allocation */
+    int32_t id_count = desc->ids->count;
+    ecs_size_t size = ECS_SIZEOF(ecs_event_desc_t) + ECS_SIZEOF(ecs_type_t) +
+        id_count * ECS_SIZEOF(ecs_id_t);
+    ecs_event_desc_t *desc_cmd = ecs_os_malloc(size);
+    ecs_type_t *type_cmd = ECS_OFFSET(desc_cmd, ECS_SIZEOF(ecs_event_desc_t));
+    ecs_os_memcpy_t(desc_cmd, desc, ecs_event_desc_t);
+    type_cmd->array = ECS_OFFSET(type_cmd, ECS_SIZEOF(ecs_type_t));
+    type_cmd->count = id_count;
+    ecs_os_memcpy_n(type_cmd->array, desc->ids->array, ecs_id_t, id_count);
+    desc_cmd->ids = type_cmd;
+
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdEvent;
+    cmd->entity = desc->entity;
+    cmd->id = 0;
+    cmd->value = desc_cmd;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
 void flecs_invoke_hook(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -6115,6 +8031,12 @@ flecs_component_ptr_t flecs_table_get_component(
 {
     ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
     ecs_column_t *column = &table->data.columns[column_index];
+    if (column->flags & EcsColumnSoA) {
+        /* Members of struct-of-arrays components are not stored contiguously,
+         * so there is no pointer to the component value. */
+        return (flecs_component_ptr_t){ .ti = column->ti };
+    }
+
     return (flecs_component_ptr_t){
         .ti = column->ti,
         .ptr = ECS_ELEM(column->data, column->ti->size, row)
@@ -6303,6 +8225,57 @@ void flecs_commit(
     return;
 }
 
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags)
+{
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != dst_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ecs_table_count(src_table) >= (src_row + count), 
+        ECS_INTERNAL_ERROR, NULL);
+
+    ecs_os_perf_trace_push("flecs.commit_range");
+
+    /* Count traversable entities so that the traversable counters of the
+     * tables can be updated in one step. */
+    const ecs_entity_t *entities = ecs_table_entities(src_table);
+    int32_t i, trav_count = 0;
+    if (src_table->_->traversable_count) {
+        for (i = 0; i < count; i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[src_row + i]);
+            trav_count += (r->row & EcsEntityIsTraversable) != 0;
+        }
+    }
+
+    if (trav_count) {
+        flecs_table_traversable_add(dst_table, trav_count);
+    }
+
+    /* Invoke remove actions for removed components */
+    flecs_actions_move_remove(world, src_table, dst_table, src_row, count, diff);
+
+    /* Move entities & components from src_table to dst_table */
+    int32_t dst_row = flecs_table_move_range(
+        world, dst_table, src_table, src_row, count);
+
+    flecs_actions_move_add(world, dst_table, src_table, dst_row, count, diff,
+        evt_flags, true, 0, true);
+
+    if (trav_count) {
+        flecs_table_traversable_add(src_table, -trav_count);
+    }
+
+    ecs_os_perf_trace_pop("flecs.commit_range");
+}
+
 const ecs_entity_t* flecs_bulk_new(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -6398,6 +8371,19 @@ const ecs_entity_t* flecs_bulk_new(
                 int32_t index = tr->column;
                 ecs_column_t *column = &table->data.columns[index];
                 ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+
+                if (column->flags & EcsColumnSoA) {
+                    /* Struct-of-arrays components have trivial lifecycle, so
+                     * values can be scattered to member arrays for both copy
+                     * and move. */
+                    int32_t e;
+                    for (e = 0; e < count; e ++) {
+                        flecs_table_soa_set(table, index, row + e,
+                            ECS_ELEM(src_ptr, size, e));
+                    }
+                    continue;
+                }
+
                 ptr = ECS_ELEM(column->data, size, row);
 
                 if (is_move) {
@@ -6541,10 +8527,9 @@ flecs_component_ptr_t flecs_ensure(
     if (component < FLECS_HI_COMPONENT_ID) {
         int16_t column_index = table->component_map[component];
         if (column_index > 0) {
-            ecs_column_t *column = &table->data.columns[column_index - 1];
-            ecs_assert(column->ti->size == size, ECS_INTERNAL_ERROR, NULL);
-            dst.ptr = ECS_ELEM(column->data, size, ECS_RECORD_TO_ROW(r->row));
-            dst.ti = column->ti;
+            dst = flecs_table_get_component(
+                table, column_index - 1, ECS_RECORD_TO_ROW(r->row));
+            ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         } else if (column_index < 0) {
             column_index = flecs_ito(int16_t, -column_index - 1);
@@ -6562,7 +8547,7 @@ flecs_component_ptr_t flecs_ensure(
         cr = flecs_components_get(world, component);
         dst = flecs_get_component_ptr(
             world, table, ECS_RECORD_TO_ROW(r->row), cr);
-        if (dst.ptr) {
+        if (dst.ptr || (dst.ti && dst.ti->soa)) {
             ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         }
@@ -6833,7 +8818,8 @@ static void flecs_copy_id(
 
     flecs_type_info_copy(dst_ptr, src_ptr, 1, ti);
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     ecs_table_t *table = r->table;
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -6842,6 +8828,30 @@ static void flecs_copy_id(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, dst_ptr);
 }
 
+/* Scatter value into the member arrays of a struct-of-arrays component. */
+static void flecs_set_soa_id(
+    ecs_world_t *world,
+    ecs_record_t *r,
+    ecs_id_t component,
+    const void *src_ptr,
+    bool on_set)
+{
+    ecs_table_t *table = r->table;
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_component_record_t *cr = flecs_components_get(world, component);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    flecs_table_soa_set(table, tr->column, row, src_ptr);
+    flecs_table_mark_dirty(world, table, component, row);
+
+    if (on_set) {
+        flecs_notify_on_set(world, table, row, component, true, NULL);
+    }
+}
+
 /* If operation is not deferred, add components by finding the target
  * table and moving the entity towards it. */
 static int flecs_traverse_add(
@@ -7577,6 +9587,17 @@ ecs_entity_t ecs_clone(
             int32_t index = ecs_table_column_to_type_index(dst_table, i);
             ecs_id_t component = dst_table->type.array[index];
 
+            if (dst_table->data.columns[i].flags & EcsColumnSoA) {
+                void *value = ecs_os_alloca(dst_table->data.columns[i].ti->size);
+                flecs_table_soa_get(src_table, 
+                    ecs_table_get_column_index(world, src_table, component),
+                    ECS_RECORD_TO_ROW(src_r->row), value);
+                flecs_table_soa_set(dst_table, i, row, value);
+                flecs_notify_on_set(world, dst_table, row, component, true,
+                    NULL);
+                continue;
+            }
+
             void *dst_ptr = ecs_get_mut_id(world, dst, component);
             if (!dst_ptr) {
                 continue;
@@ -7965,7 +9986,7 @@ void flecs_modified_id_if(
 
     flecs_notify_on_set(world, table, row, component, invoke_hook, ptr);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(world, table, component, row);
     flecs_defer_end(world, stage);
 error:
     return;
@@ -8006,7 +10027,8 @@ void ecs_modified_id(
     flecs_notify_on_set(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, NULL);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(
+        world, table, component, ECS_RECORD_TO_ROW(r->row));
     flecs_defer_end(world, stage);
 error:
     return;
@@ -8031,10 +10053,16 @@ void flecs_set_id_move(
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t dst = flecs_ensure(
         world, entity, component, r, flecs_uto(int32_t, size));
-    ecs_check(dst.ptr != NULL, ECS_INVALID_PARAMETER, NULL);
 
     const ecs_type_info_t *ti = dst.ti;
-    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_check(ti != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!dst.ptr) {
+        ecs_check(ti->soa != NULL, ECS_INVALID_PARAMETER, NULL);
+        flecs_set_soa_id(world, r, component, ptr, cmd_kind == EcsCmdSet);
+        flecs_defer_end(world, stage);
+        return;
+    }
 
     if (ti->hooks.on_replace) {
         flecs_invoke_replace_hook(
@@ -8048,7 +10076,8 @@ void flecs_set_id_move(
         flecs_type_info_ctor_move_dtor(dst.ptr, ptr, 1, ti);
     }
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     if (cmd_kind == EcsCmdSet) {
         ecs_table_t *table = r->table;
@@ -8103,6 +10132,12 @@ void ecs_set_id(
     flecs_component_ptr_t dst = flecs_ensure(world, entity, component, r, 
         flecs_uto(int32_t, size));
 
+    if (!dst.ptr) {
+        ecs_assert(dst.ti->soa != NULL, ECS_INTERNAL_ERROR, NULL);
+        flecs_set_soa_id(world, r, component, ptr, true);
+        goto done;
+    }
+
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[component]) {
             ecs_os_memcpy(dst.ptr, ptr, size);
@@ -10645,8 +12680,11 @@ void* ecs_field_w_size(
 
     int16_t column = it->columns[index];
     if (column >= 0) {
-        return ECS_ELEM(it->table->data.columns[column].data,
-            (ecs_size_t)size, it->offset);
+        ecs_column_t *c = &it->table->data.columns[column];
+        ecs_assert(!(c->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+            "field %d has struct-of-arrays storage, use ecs_field_member()",
+                index);
+        return ECS_ELEM(c->data, (ecs_size_t)size, it->offset);
     }
 
     return flecs_field_shared(it, size, index);
@@ -10671,6 +12709,10 @@ void* flecs_field_shared(
         it->real_world, it->ids[index]);
     const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
     int16_t column = tr->column;
+    ecs_assert(!(table->data.columns[column].flags & EcsColumnSoA), 
+        ECS_INVALID_OPERATION,
+        "field %d has struct-of-arrays storage, use ecs_field_member()",
+            index);
 
     return ECS_ELEM(table->data.columns[column].data,
         (ecs_size_t)size, ECS_RECORD_TO_ROW(r->row));
@@ -10755,6 +12797,78 @@ error:
     return NULL;
 }
 
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out)
+{
+    ecs_table_t *table = it->table;
+    int32_t column = it->columns[index], row = it->offset;
+    if (column < 0 || it->sources[index]) {
+        ecs_entity_t src = it->sources[index];
+        if (!src || !ecs_field_is_set(it, index)) {
+            return -1;
+        }
+
+        ecs_record_t *r = flecs_entities_get(it->real_world, src);
+        ecs_component_record_t *cr = flecs_components_get(
+            it->real_world, it->ids[index]);
+        ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (cr->flags & EcsIdSparse) {
+            return -1;
+        }
+
+        table = r->table;
+        const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+        ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+        column = tr->column;
+        row = ECS_RECORD_TO_ROW(r->row);
+    }
+
+    *table_out = table;
+    *row_out = row;
+    return column;
+}
+
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member)
+{
+    ecs_check(it->flags & EcsIterIsValid, ECS_INVALID_PARAMETER,
+        "operation invalid before calling next()");
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER,
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER,
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table;
+    int32_t row, column = flecs_field_column(it, index, &table, &row);
+    if (column < 0) {
+        return NULL;
+    }
+
+    ecs_column_t *c = &table->data.columns[column];
+    ecs_check(c->flags & EcsColumnSoA, ECS_INVALID_OPERATION,
+        "field %d does not have struct-of-arrays storage, use ecs_field()",
+            index);
+
+    const ecs_soa_layout_t *soa = c->ti->soa;
+    ecs_check(member >= 0 && member < soa->count, ECS_INVALID_PARAMETER,
+        "member index %d out of bounds for field %d", member, index);
+
+    const ecs_soa_member_t *m = &soa->members[member];
+    ecs_check(!size || flecs_uto(ecs_size_t, size) == m->size, 
+        ECS_INVALID_PARAMETER, "mismatching size for member %d of field %d",
+            member, index);
+
+    return ECS_OFFSET(c->data, m->offset * table->data.size + m->size * row);
+error:
+    return NULL;
+}
+
 bool ecs_field_is_readonly(
     const ecs_iter_t *it,
     int8_t index)
@@ -10907,6 +13021,34 @@ error:
     return 0;
 }
 
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table = it->table;
+    if (!table || !table->_->bs_count) {
+        return NULL;
+    }
+
+    if (!ecs_field_is_set(it, index) || !ecs_field_is_self(it, index)) {
+        return NULL;
+    }
+
+    ecs_bitset_t *bs = flecs_table_get_toggle(table, it->ids[index]);
+    if (!bs) {
+        return NULL;
+    }
+
+    return bs->data;
+error:
+    return NULL;
+}
+
 size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index)
@@ -10921,6 +13063,52 @@ error:
     return 0;
 }
 
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_size_t size = it->sizes[index];
+    if (!size || (it->row_fields & (1llu << index))) {
+        return 0;
+    }
+
+    int16_t column = it->columns[index];
+    if (!it->ptrs && column >= 0 && 
+        (it->table->data.columns[column].flags & EcsColumnSoA)) 
+    {
+        /* Member arrays don't start at the field pointer */
+        return 0;
+    }
+
+    void *ptr = ecs_field_w_size(it, (size_t)size, index);
+    if (!ptr) {
+        return 0;
+    }
+
+    const ecs_world_t *world = it->real_world;
+    ecs_size_t alignment = world->column_alignment;
+    const ecs_type_info_t *ti = ecs_get_type_info(world, it->ids[index]);
+    if (ti && ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+
+    /* Largest power of two that the address is a multiple of */
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t result = addr & (~addr + 1);
+    if (alignment && result > (uintptr_t)alignment) {
+        result = (uintptr_t)alignment;
+    }
+
+    return (ecs_size_t)result;
+error:
+    return 0;
+}
+
 bool ecs_iter_next(
     ecs_iter_t *iter)
 {
@@ -11231,6 +13419,203 @@ error:
     return (ecs_iter_t){ 0 };
 }
 
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking)
+{
+    ecs_check(chunking != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->min_count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_iter_t result = ecs_worker_iter(it, index, count);
+    if (chunking->disable) {
+        return result;
+    }
+
+    result.priv_.iter.worker.min_count = chunking->min_count;
+    result.priv_.iter.worker.chunk_size = chunking->chunk_size;
+    result.priv_.iter.worker.chunk = -1;
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+/* Get number of rows that worker slices must be a multiple of, so that the
+ * fields of each slice start at an address that has the column alignment. */
+static int32_t flecs_worker_row_granularity(
+    const ecs_iter_t *it)
+{
+    ecs_size_t alignment = it->real_world->column_alignment;
+    if (!alignment || !it->table) {
+        return 1;
+    }
+
+    int32_t result = 1;
+    int8_t i;
+    for (i = 0; i < it->field_count; i ++) {
+        ecs_size_t size = it->sizes[i];
+        if (!size) {
+            continue;
+        }
+
+        /* Largest power of two that the component size is a multiple of */
+        ecs_size_t size_align = size & -size;
+        if (size_align < alignment) {
+            int32_t rows = alignment / size_align;
+            if (rows > result) {
+                result = rows;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Number of bytes of the fields of a chunk when a chunking policy doesn't 
+ * specify a chunk size. 32KB fits in the L1 data cache of most CPUs, and in the
+ * L2 cache of all of them. */
+#ifndef FLECS_WORKER_CHUNK_BYTES
+#define FLECS_WORKER_CHUNK_BYTES (32 * 1024)
+#endif
+
+/* Get number of entities per chunk for a result */
+static int32_t flecs_worker_chunk_size(
+    const ecs_iter_t *it,
+    const ecs_worker_iter_t *iter,
+    int32_t count)
+{
+    int32_t result = iter->chunk_size;
+    if (!result) {
+        /* Don't make chunks larger than needed to give each worker a chunk */
+        result = (count + iter->count - 1) / iter->count;
+
+        ecs_size_t row_size = 0;
+        int8_t i;
+        for (i = 0; i < it->field_count; i ++) {
+            if (!it->sources[i]) {
+                row_size += it->sizes[i];
+            }
+        }
+
+        if (row_size) {
+            int32_t cache_rows = FLECS_WORKER_CHUNK_BYTES / row_size;
+            if (!cache_rows) {
+                cache_rows = 1;
+            }
+            if (cache_rows < result) {
+                result = cache_rows;
+            }
+        }
+    }
+
+    if (result < iter->min_count) {
+        result = iter->min_count;
+    }
+
+    int32_t granularity = flecs_worker_row_granularity(it);
+    if (granularity > 1) {
+        result = ((result + granularity - 1) / granularity) * granularity;
+    }
+
+    return result;
+}
+
+/* Get first row of a worker slice, rounded down to the row granularity. The
+ * row is relative to the start of the table. */
+static int32_t flecs_worker_slice_start(
+    int32_t offset,
+    int32_t count,
+    int32_t index,
+    int32_t worker_count,
+    int32_t granularity)
+{
+    if (index >= worker_count) {
+        return offset + count;
+    }
+
+    int32_t row = offset + (int32_t)(((int64_t)count * index) / worker_count);
+    row -= row % granularity;
+    if (row < offset) {
+        row = offset;
+    }
+
+    return row;
+}
+
+/* Progress worker iterator with chunking policy. Results are split up in
+ * chunks, which are assigned round robin to workers. The first chunk of a
+ * result is assigned to a worker derived from the table id, so that tables
+ * that are processed as a whole are spread out across workers. */
+static bool flecs_worker_chunk_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t res_count = iter->count, res_index = iter->index;
+
+    do {
+        if (iter->chunk == -1) {
+            if (!ecs_iter_next(chain_it)) {
+                return false;
+            }
+
+            if (!chain_it->count) {
+                if (chain_it->table) {
+                    continue;
+                }
+
+                ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+                if (res_index == 0) {
+                    return true;
+                } else {
+                    /* Chained iterator returned true, so clean it up */
+                    ecs_iter_fini(chain_it);
+                    return false;
+                }
+            }
+
+            int32_t start = 0;
+            if (chain_it->table) {
+                start = (int32_t)(chain_it->table->id % (uint64_t)res_count);
+            }
+
+            iter->chunk = (res_index - start + res_count) % res_count;
+        }
+
+        int32_t chunk_size = flecs_worker_chunk_size(
+            chain_it, iter, chain_it->count);
+        int32_t first = iter->chunk * chunk_size;
+        if (first >= chain_it->count) {
+            iter->chunk = -1;
+            continue;
+        }
+
+        int32_t count = chain_it->count - first;
+        if (count > chunk_size) {
+            count = chunk_size;
+        }
+
+        iter->chunk += res_count;
+
+        /* Copy everything up to the private iterator data */
+        ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+        it->frame_offset += first;
+        it->count = count;
+        it->offset += first;
+
+        if (it->table) {
+            it->entities = &(ecs_table_entities(it->table)[it->offset]);
+        } else {
+            it->entities = &it->entities[first];
+        }
+
+        return true;
+    } while (true);
+}
+
 bool ecs_worker_next(
     ecs_iter_t *it)
 {
@@ -11243,6 +13628,10 @@ bool ecs_worker_next(
     int32_t res_count = iter->count, res_index = iter->index;
     int32_t per_worker, first;
 
+    if (iter->min_count || iter->chunk_size) {
+        return flecs_worker_chunk_next(it);
+    }
+
     do {
         if (!ecs_iter_next(chain_it)) {
             return false;
@@ -11252,6 +13641,38 @@ bool ecs_worker_next(
         ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
 
         int32_t count = it->count;
+
+        /* When workers are pinned, keep small tables on a single worker so 
+         * the same core processes the table each frame. */
+        if (it->table && count && count < res_count && 
+            (it->real_world->flags & EcsWorldWorkerAffinity)) 
+        {
+            if ((int32_t)(it->table->id % (uint64_t)res_count) == res_index) {
+                per_worker = count;
+                first = 0;
+                break;
+            }
+
+            per_worker = 0;
+            continue;
+        }
+
+        /* When a column alignment is set, split the table at rows that keep
+         * the arrays of each worker aligned. */
+        int32_t granularity = flecs_worker_row_granularity(it);
+        if (granularity > 1) {
+            int32_t start = flecs_worker_slice_start(
+                it->offset, count, res_index, res_count, granularity);
+            int32_t end = flecs_worker_slice_start(
+                it->offset, count, res_index + 1, res_count, granularity);
+            first = start - it->offset;
+            per_worker = end - start;
+            if (!per_worker && it->table) {
+                continue;
+            }
+            break;
+        }
+
         per_worker = count / res_count;
         first = per_worker * res_index;
         count -= per_worker * res_count;
@@ -14551,6 +16972,23 @@ ecs_observer_t* flecs_observer_init(
         "observer must have at least one term");
 
     int i;
+    /* Components with struct-of-arrays storage can't be accessed with 
+     * ecs_field, which is what observer callbacks (and the C++ API) use. */
+    for (i = 0; i < query->term_count; i ++) {
+        ecs_term_t *term = &query->terms[i];
+        if (!term->id || term->inout == EcsInOutNone || 
+            ecs_id_is_wildcard(term->id)) 
+        {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, term->id);
+        ecs_check(!ti || !ti->soa, ECS_UNSUPPORTED,
+            "observer term for '%s' must have inout None: component has "
+            "struct-of-arrays storage", 
+                flecs_errstr(ecs_id_str(world, term->id)));
+        (void)ti;
+    }
 
     o->run = desc->run;
     o->callback = desc->callback;
@@ -16194,6 +18632,31 @@ static char* ecs_os_api_module_to_etc(const char *module) {
     return ecs_strbuf_get(&lib);
 }
 
+/* Fallbacks for OS API implementations that don't provide atomic loads and
+ * stores. Volatile accesses are not ordered with other memory operations, so
+ * threaded implementations should override these. */
+static
+int32_t ecs_os_api_aload(
+    const int32_t *value)
+{
+    return *(const volatile int32_t*)value;
+}
+
+static
+void* ecs_os_api_aloadp(
+    void *const *value)
+{
+    return *(void *const volatile*)value;
+}
+
+static
+void ecs_os_api_astorep(
+    void **ptr,
+    void *value)
+{
+    *(void *volatile*)ptr = value;
+}
+
 void ecs_os_set_api_defaults(void)
 {
     /* Don't overwrite if already initialized */
@@ -16221,6 +18684,11 @@ void ecs_os_set_api_defaults(void)
     ecs_os_api.fclose_ = ecs_os_api_fclose;
     ecs_os_api.fread_ = ecs_os_api_fread;
 
+    /* Atomics */
+    ecs_os_api.aload_ = ecs_os_api_aload;
+    ecs_os_api.aloadp_ = ecs_os_api_aloadp;
+    ecs_os_api.astorep_ = ecs_os_api_astorep;
+
     /* Time */
     ecs_os_api.get_time_ = ecs_os_gettime;
 
@@ -16256,6 +18724,14 @@ bool ecs_os_has_heap(void) {
         (ecs_os_api.free_ != NULL);
 }
 
+bool ecs_os_has_virtual_memory(void) {
+    return
+        (ecs_os_api.reserve_ != NULL) &&
+        (ecs_os_api.commit_ != NULL) &&
+        (ecs_os_api.decommit_ != NULL) &&
+        (ecs_os_api.release_ != NULL);
+}
+
 bool ecs_os_has_threading(void) {
     return
         (ecs_os_api.mutex_new_ != NULL) &&
@@ -17121,6 +19597,9 @@ static void flecs_stage_merge(
             flecs_poly_assert(s, ecs_stage_t);
             flecs_defer_end(world, s);
         }
+
+        /* Merge commands enqueued by threads that don't own a stage */
+        flecs_async_merge(world);
     }
 
     if (measure_frame_time) {
@@ -17233,6 +19712,27 @@ ecs_stack_t* flecs_stage_get_stack_allocator(
     return &stage->allocators.iter_stack;
 }
 
+static void flecs_stack_first_touch(
+    ecs_stack_t *stack)
+{
+    /* Getting a cursor allocates the first page if the stack doesn't have one
+     * yet. Restoring the cursor keeps the page. */
+    flecs_stack_restore_cursor(stack, flecs_stack_get_cursor(stack));
+}
+
+void flecs_stage_first_touch(
+    ecs_stage_t *stage)
+{
+    flecs_poly_assert(stage, ecs_stage_t);
+
+    /* Stage allocators allocate lazily, so memory is placed on the NUMA node
+     * of the thread that first uses it. Make sure the pages that are used 
+     * every frame are owned by the thread calling this function. */
+    flecs_stack_first_touch(&stage->allocators.iter_stack);
+    flecs_stack_first_touch(&stage->cmd_stack[0].stack);
+    flecs_stack_first_touch(&stage->cmd_stack[1].stack);
+}
+
 ecs_world_t* ecs_stage_new(
     ecs_world_t *world)
 {
@@ -17520,8 +20020,8 @@ void ecs_stage_shrink(
 {
     flecs_sparse_shrink(&stage->cmd_stack[0].entries);
     flecs_sparse_shrink(&stage->cmd_stack[1].entries);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, ecs_cmd_t);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, ecs_cmd_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, uint8_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, uint8_t);
 }
 
 bool ecs_is_deferred(
@@ -18001,6 +20501,10 @@ void ecs_set_hooks_id(
     ecs_check(!ti->component || ti->component == component,
         ECS_INCONSISTENT_COMPONENT_ACTION, NULL);
 
+    ecs_check(!ti->soa || flecs_type_hooks_allow_soa(h), ECS_UNSUPPORTED,
+        "illegal call to set_hooks() for component '%s': component has "
+        "struct-of-arrays storage", flecs_errstr(ecs_get_path(world, component)));
+
     ecs_type_hooks_t prev_hooks = ti->hooks;
 
     if (!ti->size) {
@@ -18211,6 +20715,11 @@ static void flecs_type_info_fini(
         ecs_os_free(ECS_CONST_CAST(char*, ti->name));
         ti->name = NULL;
     }
+    if (ti->soa) {
+        ecs_os_free(ti->soa->members);
+        ecs_os_free(ti->soa);
+        ti->soa = NULL;
+    }
 
     ti->size = 0;
     ti->alignment = 0;
@@ -18384,6 +20893,33 @@ void flecs_type_info_release(
     }
 }
 
+/* Struct-of-arrays storage has no contiguous component values to pass to 
+ * lifecycle hooks or to the hooks that access values with ecs_field. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h)
+{
+    return (!h->ctor || h->ctor == flecs_default_ctor) && !h->dtor && 
+        !h->copy && !h->move && !h->copy_ctor && !h->move_ctor && 
+        !h->ctor_move_dtor && !h->move_dtor && !h->on_add && !h->on_set &&
+        !h->on_remove && !h->on_replace && !h->on_validate;
+}
+
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count)
+{
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ti->soa == NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(members != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_soa_layout_t *soa = ecs_os_calloc_t(ecs_soa_layout_t);
+    soa->members = ecs_os_memdup_n(members, ecs_soa_member_t, count);
+    soa->count = count;
+    ti->soa = soa;
+}
+
 ecs_size_t flecs_type_size(
     ecs_world_t *world, 
     ecs_entity_t type) 
@@ -18537,6 +21073,8 @@ const ecs_entity_t EcsPanic =                       FLECS_HI_COMPONENT_ID + 56;
 /* Storage */
 const ecs_entity_t EcsSparse =                      FLECS_HI_COMPONENT_ID + 57;
 const ecs_entity_t EcsDontFragment =                FLECS_HI_COMPONENT_ID + 58;
+const ecs_entity_t EcsCold =                        FLECS_HI_COMPONENT_ID + 125;
+const ecs_entity_t EcsStableOrder =                 FLECS_HI_COMPONENT_ID + 126;
 
 /* Misc */
 const ecs_entity_t EcsOrderedChildren =               FLECS_HI_COMPONENT_ID + 60;
@@ -18611,6 +21149,7 @@ static void flecs_init_store(
     ecs_vec_init_t(a, &world->store.records, ecs_table_record_t, 0);
     ecs_vec_init_t(a, &world->store.marked_ids, ecs_marked_id_t, 0);
     ecs_vec_init_t(a, &world->store.deleted_components, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &world->store.unordered_tables, uint64_t, 0);
 
     /* Initialize entity index */
     flecs_entities_init(world);
@@ -18621,6 +21160,9 @@ static void flecs_init_store(
 
     /* Initialize table map */
     flecs_table_hashmap_init(world, &world->store.table_map);
+
+    /* Initialize storage region for cold columns */
+    flecs_cold_storage_init(&world->store.cold);
 }
 
 static void flecs_clean_tables(
@@ -18786,6 +21328,9 @@ static void flecs_fini_store(ecs_world_t *world) {
     ecs_vec_fini_t(a, &world->store.records, ecs_table_record_t);
     ecs_vec_fini_t(a, &world->store.marked_ids, ecs_marked_id_t);
     ecs_vec_fini_t(a, &world->store.deleted_components, ecs_entity_t);
+    ecs_vec_fini_t(a, &world->store.unordered_tables, uint64_t);
+
+    flecs_cold_storage_fini(&world->store.cold);
 }
 
 static void flecs_world_allocators_init(
@@ -19045,6 +21590,8 @@ ecs_world_t *ecs_mini(void) {
     }
 
     ecs_map_init(&world->prefab_child_indices, a);
+    ecs_map_init(&world->double_buffered, a);
+    flecs_async_init(world);
 
     ecs_set_stage_count(world, 1);
     ecs_default_lookup_path[0] = EcsFlecsCore;
@@ -19236,6 +21783,7 @@ int ecs_fini(
     /* Purge deferred operations from the queue. This discards operations but
      * makes sure that any resources in the queue are freed */
     flecs_defer_purge(world, world->stages[0]);
+    flecs_async_fini(world);
     ecs_log_pop_1();
 
     /* Cleanup world ctx and binding_ctx */
@@ -19261,7 +21809,9 @@ int ecs_fini(
     flecs_name_index_fini(&world->aliases);
     flecs_name_index_fini(&world->symbols);
     ecs_set_stage_count(world, 0);
+    ecs_vec_fini_t(NULL, &world->worker_affinity, int32_t);
     ecs_map_fini(&world->prefab_child_indices);
+    ecs_map_fini(&world->double_buffered);
     flecs_multi_world_fini(world);
     ecs_log_pop_1();
 
@@ -19391,6 +21941,48 @@ void ecs_run_aperiodic(
     }
 }
 
+/* Estimate of the memory of a table that is returned to the OS allocator when 
+ * the table is shrunk or deleted. Used to report how many bytes were reclaimed
+ * by ecs_delete_empty_tables(). Graph edges, table records and the table 
+ * itself are freed to the allocators of the world, which keep the memory for
+ * new tables, so they are not counted. */
+static ecs_size_t flecs_table_reclaimable_bytes(
+    const ecs_table_t *table,
+    bool with_table)
+{
+    int32_t i, column_count = table->column_count;
+    ecs_size_t row_size = ECS_SIZEOF(ecs_entity_t);
+    for (i = 0; i < column_count; i ++) {
+        const ecs_column_t *column = &table->data.columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) == 
+            EcsColumnCold) 
+        {
+            /* Counted when the cold storage region releases pages */
+            continue;
+        }
+        row_size += column->ti->size;
+    }
+
+    ecs_size_t result = row_size * table->data.size;
+
+    if (with_table) {
+        int32_t type_count = table->type.count;
+        result += (type_count + column_count) * ECS_SIZEOF(int16_t);
+        if (table->component_map != flecs_table_empty_component_map) {
+            result += FLECS_HI_COMPONENT_ID * ECS_SIZEOF(int16_t);
+        }
+    }
+
+    return result;
+}
+
+static bool flecs_table_has_edges(
+    const ecs_table_t *table)
+{
+    const ecs_graph_node_t *node = &table->node;
+    return node->add.lo || node->remove.lo || node->add.hi || node->remove.hi;
+}
+
 int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc)
@@ -19407,7 +21999,9 @@ int32_t ecs_delete_empty_tables(
     uint16_t clear_generation = desc->clear_generation;
     uint16_t delete_generation = desc->delete_generation;
     double time_budget_seconds = desc->time_budget_seconds;
+    float shrink_ratio = desc->shrink_ratio;
     int32_t offset = desc->offset;
+    ecs_size_t cold_reserved = world->store.cold.bytes_reserved;
 
     if (ECS_NEQZERO(time_budget_seconds) || (ecs_should_log_1() && ecs_os_has_time())) {
         ecs_time_measure(&start);
@@ -19464,7 +22058,27 @@ int32_t ecs_delete_empty_tables(
             measure_budget_after = 100;
         }
 
-        if (!table->id || ecs_table_count(table) != 0) {
+        if (!table->id) {
+            i ++;
+            remaining --;
+            continue;
+        }
+
+        int32_t table_count = ecs_table_count(table);
+        if (table_count) {
+            /* Trim storage of tables that are mostly empty, for example after
+             * a large number of entities got deleted. */
+            if (ECS_NEQZERO(shrink_ratio) && 
+                ((float)table_count < shrink_ratio * (float)table->data.size))
+            {
+                ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+                flecs_table_shrink(world, table);
+                bytes -= flecs_table_reclaimable_bytes(table, false);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+                measure_budget_after = 1;
+            }
+
             i ++;
             remaining --;
             continue;
@@ -19472,12 +22086,22 @@ int32_t ecs_delete_empty_tables(
 
         uint16_t gen = ++ table->_->generation;
         if (delete_generation && (gen > delete_generation)) {
+            world->compaction_bytes += 
+                flecs_table_reclaimable_bytes(table, true);
+            world->compaction_count ++;
             flecs_table_fini(world, table);
             measure_budget_after = 1;
             remaining --;
             continue;
         } else if (clear_generation && (gen > clear_generation)) {
-            flecs_table_shrink(world, table);
+            ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+            if (bytes || flecs_table_has_edges(table)) {
+                /* Edges are recreated when the table is used again */
+                flecs_table_shrink(world, table);
+                flecs_table_clear_edges(world, table);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+            }
             measure_budget_after = 1;
         }
 
@@ -19485,12 +22109,65 @@ int32_t ecs_delete_empty_tables(
         remaining --;
     }
 
+    /* Pack cold columns at the start of the cold storage region, so that the
+     * pages at the end of the region are released. */
+    if (flecs_cold_storage_fragmented(&world->store.cold)) {
+        count = flecs_sparse_count(&world->store.tables);
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = flecs_sparse_get_dense_t(
+                &world->store.tables, ecs_table_t, i);
+            if (table->keep || !table->id) {
+                continue;
+            }
+            if (flecs_table_compact_cold(world, table)) {
+                world->compaction_count ++;
+            }
+        }
+    }
+
 done:
+    if (world->store.cold.bytes_reserved < cold_reserved) {
+        world->compaction_bytes += 
+            cold_reserved - world->store.cold.bytes_reserved;
+    }
+
     ecs_os_perf_trace_pop("flecs.delete_empty_tables");
 
     return result;
 }
 
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change table compaction while world is in readonly mode");
+
+    if (desc) {
+        ecs_check(desc->shrink_ratio >= 0 && desc->shrink_ratio <= 1, 
+            ECS_INVALID_PARAMETER, "shrink_ratio must be between 0 and 1");
+        world->compaction = *desc;
+        world->compaction_enabled = true;
+    } else {
+        ecs_os_zeromem(&world->compaction);
+        world->compaction_enabled = false;
+    }
+error:
+    return;
+}
+
+void flecs_table_compaction_run(
+    ecs_world_t *world)
+{
+    if (!world->compaction_enabled) {
+        return;
+    }
+
+    world->compaction.offset = 
+        ecs_delete_empty_tables(world, &world->compaction);
+}
+
 ecs_entities_t ecs_get_entities(
     const ecs_world_t *world)
 {
@@ -19585,6 +22262,54 @@ void ecs_shrink(
     }
 }
 
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(page_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column page size while world is in readonly mode");
+    world->column_page_size = page_size;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_page_size;
+error:
+    return 0;
+}
+
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(alignment >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER,
+        "column alignment must be a power of two");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column alignment while world is in readonly mode");
+    world->column_alignment = alignment;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_alignment;
+error:
+    return 0;
+}
+
 void ecs_exclusive_access_begin(
     ecs_world_t *world,
     const char *thread_name)
@@ -19905,11 +22630,6 @@ int ecs_log_last_error(void)
 
 #endif /* FLECS_JSON_PRIVATE_H */
 
-#ifndef FLECS_SYSTEM_PRIVATE_H
-#define FLECS_SYSTEM_PRIVATE_H
-
-#endif
-
 #ifndef FLECS_USE_OS_ALLOC
 static ecs_size_t flecs_allocator_size(
     ecs_size_t size)
@@ -20174,6 +22894,64 @@ error:
     return;
 }
 
+/* Read 64 bits starting at an arbitrary bit offset. Bits past the allocated
+ * words are read as zero. */
+static uint64_t flecs_bitset_read_word(
+    const ecs_bitset_t *bs,
+    int32_t word_count,
+    int32_t elem)
+{
+    int32_t hi = elem >> 6, lo = elem & 0x3F;
+    if (hi >= word_count) {
+        return 0;
+    }
+
+    uint64_t result = bs->data[hi] >> lo;
+    if (lo && ((hi + 1) < word_count)) {
+        result |= bs->data[hi + 1] << (64 - lo);
+    }
+
+    return result;
+}
+
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count)
+{
+    ecs_check(elem >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check((elem + count) <= bs->count, ECS_INVALID_PARAMETER, NULL);
+    if (!count) {
+        return;
+    }
+
+    int32_t word_count = bs->size / 64;
+    int32_t last = bs->count - count;
+    int32_t first_word = elem >> 6, last_word = (bs->count - 1) >> 6;
+
+    /* Shift words down. Source bits are always at or after the destination,
+     * so words can be written in increasing order. */
+    uint64_t keep = ((uint64_t)1 << (elem & 0x3F)) - 1;
+    int32_t w;
+    for (w = first_word; w <= last_word; w ++) {
+        uint64_t v = flecs_bitset_read_word(bs, word_count, w * 64 + count);
+        bs->data[w] = (bs->data[w] & keep) | (v & ~keep);
+        keep = 0;
+    }
+
+    /* Clear bits that were shifted out of the range */
+    w = last >> 6;
+    bs->data[w] &= ((uint64_t)1 << (last & 0x3F)) - 1;
+    for (w ++; w <= last_word; w ++) {
+        bs->data[w] = 0;
+    }
+
+    bs->count = last;
+error:
+    return;
+}
+
 void flecs_bitset_swap(
     ecs_bitset_t *bs,
     int32_t elem_a,
@@ -23374,7 +26152,7 @@ static int flecs_query_set_caching_policy(
     kind = EcsQueryCacheNone;
     bool require_caching = desc->group_by || desc->group_by_callback || 
             desc->order_by || desc->order_by_callback || 
-            (desc->flags & EcsQueryDetectChanges);
+            (desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges));
 
     /* If the query has a Cascade term it'll use group_by */
     int32_t i, term_count = impl->pub.term_count;
@@ -23396,13 +26174,16 @@ static int flecs_query_set_caching_policy(
     /* If caching policy is default, try to pick a policy that does the right
      * thing in most cases. */
     if (kind == EcsQueryCacheDefault) {
-        if (desc->entity || require_caching) {
+        if (desc->entity || require_caching || 
+            (desc->flags & EcsQueryPrefetch)) 
+        {
             /* If the query is created with an entity handle (typically 
              * indicating that the query is named or belongs to a system) the
              * chance is very high that the query will be reused, so enable
              * caching. 
              * Additionally, if the query uses features that require a cache
-             * such as group_by/order_by, also enable caching. */
+             * such as group_by/order_by, or that only apply to cached queries
+             * such as prefetching, also enable caching. */
             kind = EcsQueryCacheAuto;
         } else {
             /* Be conservative in other scenarios, as caching adds significant
@@ -23742,6 +26523,61 @@ ecs_query_count_t ecs_query_count(
     return result;
 }
 
+/* Estimate the number of entities matched by a query without evaluating it. 
+ * For cached queries this is the number of entities in the cached tables. For
+ * uncached queries it is the number of entities in the tables with the first
+ * component that the query matches on $this, which is an upper bound. */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q)
+{
+    flecs_poly_assert(q, ecs_query_t);
+
+    ecs_flags32_t skip = EcsTableIsPrefab|EcsTableIsDisabled;
+    if (q->flags & EcsQueryMatchPrefab) {
+        skip &= ~(ecs_flags32_t)EcsTableIsPrefab;
+    }
+    if (q->flags & EcsQueryMatchDisabled) {
+        skip &= ~(ecs_flags32_t)EcsTableIsDisabled;
+    }
+
+    int32_t i;
+    for (i = 0; i < q->term_count; i ++) {
+        const ecs_term_t *term = &q->terms[i];
+        if (term->oper != EcsAnd || !ecs_term_match_this(term)) {
+            continue;
+        }
+        if (term->src.id & EcsUp) {
+            continue;
+        }
+        if (term->flags_ & (EcsTermIsSparse|EcsTermDontFragment|
+            EcsTermIsMember|EcsTermNonFragmentingChildOf)) 
+        {
+            continue;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(q->world, term->id);
+        if (!cr) {
+            return 0;
+        }
+
+        int32_t result = 0;
+        ecs_table_cache_iter_t it;
+        if (flecs_table_cache_queryable_iter(&cr->cache, &it, EcsTableNotEmpty)) {
+            const ecs_table_cache_elem_t *elem;
+            while ((elem = flecs_table_cache_next(&it))) {
+                const ecs_table_t *table = elem->table;
+                if (!(table->flags & skip)) {
+                    result += ecs_table_count(table);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    return ecs_query_count(q).entities;
+}
+
 bool ecs_query_is_true(
     const ecs_query_t *q)
 {
@@ -25822,7 +28658,7 @@ int flecs_query_finalize_query(
         "ecs_query_desc_t was not initialized to zero");
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
-    if ((desc->flags & EcsQueryDetectChanges) &&
+    if ((desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges)) &&
         (desc->order_by || desc->order_by_callback))
     {
         ecs_query_validator_ctx_t ctx = {0};
@@ -25938,6 +28774,368 @@ error:
     return -1;
 }
 
+struct ecs_cold_page_t {
+    ecs_cold_page_t *next;
+    ecs_cold_page_t *prev;
+    int32_t index;                   /* Order of page in region */
+    ecs_size_t size;                 /* Size of block area of page */
+};
+
+struct ecs_cold_block_t {
+    ecs_cold_page_t *page;
+    ecs_cold_block_t *next_free;     /* Free list (free blocks only) */
+    ecs_cold_block_t *prev_free;
+    ecs_size_t size;                 /* Size of block including header */
+    ecs_size_t prev_size;            /* Size of previous block, 0 if first */
+    bool used;
+};
+
+#define FLECS_COLD_PAGE_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_page_t), FLECS_COLD_ALIGNMENT)
+#define FLECS_COLD_BLOCK_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_block_t), FLECS_COLD_ALIGNMENT)
+
+/* Blocks aren't split if the remainder would be smaller than this */
+#define FLECS_COLD_BLOCK_MIN \
+    (FLECS_COLD_BLOCK_HEADER + FLECS_COLD_ALIGNMENT)
+
+static
+ecs_cold_block_t* flecs_cold_block_of(
+    const void *ptr)
+{
+    return ECS_CAST(ecs_cold_block_t*,
+        ECS_CAST(char*, ECS_CONST_CAST(void*, ptr)) - FLECS_COLD_BLOCK_HEADER);
+}
+
+static
+ecs_size_t flecs_cold_block_size(
+    ecs_size_t size)
+{
+    ecs_assert(size > 0, ECS_INTERNAL_ERROR, NULL);
+    return FLECS_COLD_BLOCK_HEADER + ECS_ALIGN(size, FLECS_COLD_ALIGNMENT);
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_next(
+    const ecs_cold_block_t *block)
+{
+    const ecs_cold_page_t *page = block->page;
+    const char *end = ECS_CAST(const char*, page) +
+        FLECS_COLD_PAGE_HEADER + page->size;
+    const char *next = ECS_CAST(const char*, block) + block->size;
+    if (next >= end) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*, next));
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_prev(
+    const ecs_cold_block_t *block)
+{
+    if (!block->prev_size) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*,
+        ECS_CAST(const char*, block) - block->prev_size));
+}
+
+/* Update back reference of the block that follows block */
+static
+void flecs_cold_block_link_next(
+    ecs_cold_block_t *block)
+{
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next) {
+        next->prev_size = block->size;
+    }
+}
+
+/* Returns whether block a is stored at a lower address in the region than b */
+static
+bool flecs_cold_block_before(
+    const ecs_cold_block_t *a,
+    const ecs_cold_block_t *b)
+{
+    if (a->page != b->page) {
+        return a->page->index < b->page->index;
+    }
+    return a < b;
+}
+
+static
+void flecs_cold_free_list_insert(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    block->prev_free = NULL;
+    block->next_free = storage->free_list;
+    if (storage->free_list) {
+        storage->free_list->prev_free = block;
+    }
+    storage->free_list = block;
+}
+
+static
+void flecs_cold_free_list_remove(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        ecs_assert(storage->free_list == block, ECS_INTERNAL_ERROR, NULL);
+        storage->free_list = block->next_free;
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+}
+
+static
+ecs_cold_block_t* flecs_cold_page_new(
+    ecs_cold_storage_t *storage,
+    ecs_size_t block_size)
+{
+    ecs_size_t size = FLECS_COLD_PAGE_SIZE - FLECS_COLD_PAGE_HEADER;
+    if (block_size > size) {
+        size = block_size;
+    }
+
+    ecs_cold_page_t *page = ecs_os_malloc(FLECS_COLD_PAGE_HEADER + size);
+    if (!page) {
+        return NULL;
+    }
+
+    page->index = storage->page_index ++;
+    page->size = size;
+    page->next = NULL;
+    page->prev = storage->last;
+    if (storage->last) {
+        storage->last->next = page;
+    } else {
+        storage->first = page;
+    }
+    storage->last = page;
+    storage->bytes_reserved += FLECS_COLD_PAGE_HEADER + size;
+
+    ecs_cold_block_t *block = ECS_OFFSET(page, FLECS_COLD_PAGE_HEADER);
+    block->page = page;
+    block->size = size;
+    block->prev_size = 0;
+    block->used = false;
+    flecs_cold_free_list_insert(storage, block);
+    return block;
+}
+
+static
+void flecs_cold_page_free(
+    ecs_cold_storage_t *storage,
+    ecs_cold_page_t *page)
+{
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        storage->first = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    } else {
+        storage->last = page->prev;
+    }
+
+    storage->bytes_reserved -= FLECS_COLD_PAGE_HEADER + page->size;
+    ecs_os_free(page);
+}
+
+/* Return unused block to the region. The block is merged with adjacent free
+ * blocks, and the page is freed if the block covers the entire page. */
+static
+void flecs_cold_block_release(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    ecs_assert(!block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next && !next->used) {
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_block_t *prev = flecs_cold_block_prev(block);
+    if (prev && !prev->used) {
+        flecs_cold_free_list_remove(storage, prev);
+        prev->size += block->size;
+        block = prev;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_page_t *page = block->page;
+    if (block->size == page->size) {
+        flecs_cold_page_free(storage, page);
+    } else {
+        flecs_cold_free_list_insert(storage, block);
+    }
+}
+
+/* Split off the part of a used block that is not needed to store size bytes */
+static
+void flecs_cold_block_trim(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block,
+    ecs_size_t block_size)
+{
+    ecs_size_t remainder = block->size - block_size;
+    if (remainder < FLECS_COLD_BLOCK_MIN) {
+        return;
+    }
+
+    block->size = block_size;
+    storage->bytes_used -= remainder;
+
+    ecs_cold_block_t *rest = ECS_OFFSET(block, block_size);
+    rest->page = block->page;
+    rest->size = remainder;
+    rest->prev_size = block_size;
+    rest->used = false;
+    flecs_cold_block_link_next(rest);
+    flecs_cold_block_release(storage, rest);
+}
+
+static
+void* flecs_cold_alloc_intern(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const ecs_cold_block_t *limit)
+{
+    ecs_size_t block_size = flecs_cold_block_size(size);
+
+    /* Find the free block with the lowest address that fits */
+    ecs_cold_block_t *cur, *block = NULL;
+    for (cur = storage->free_list; cur; cur = cur->next_free) {
+        if (cur->size < block_size) {
+            continue;
+        }
+        if (limit && !flecs_cold_block_before(cur, limit)) {
+            continue;
+        }
+        if (!block || flecs_cold_block_before(cur, block)) {
+            block = cur;
+        }
+    }
+
+    if (!block) {
+        if (limit) {
+            return NULL;
+        }
+
+        block = flecs_cold_page_new(storage, block_size);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    flecs_cold_free_list_remove(storage, block);
+    block->used = true;
+    storage->bytes_used += block->size;
+    flecs_cold_block_trim(storage, block, block_size);
+
+    return ECS_OFFSET(block, FLECS_COLD_BLOCK_HEADER);
+}
+
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage)
+{
+    ecs_os_zeromem(storage);
+}
+
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage)
+{
+    ecs_assert(storage->bytes_used == 0, ECS_INTERNAL_ERROR,
+        "cold storage region still has blocks in use");
+
+    ecs_cold_page_t *page = storage->first;
+    while (page) {
+        ecs_cold_page_t *next = page->next;
+        ecs_os_free(page);
+        page = next;
+    }
+
+    ecs_os_zeromem(storage);
+}
+
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size)
+{
+    return flecs_cold_alloc_intern(storage, size, NULL);
+}
+
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+    return flecs_cold_alloc_intern(storage, size, flecs_cold_block_of(ptr));
+}
+
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+    block->used = false;
+    storage->bytes_used -= block->size;
+    flecs_cold_block_release(storage, block);
+}
+
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_size_t block_size = flecs_cold_block_size(size);
+    if (block_size > block->size) {
+        ecs_cold_block_t *next = flecs_cold_block_next(block);
+        if (!next || next->used ||
+            ((block->size + next->size) < block_size))
+        {
+            return false;
+        }
+
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        storage->bytes_used += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    flecs_cold_block_trim(storage, block, block_size);
+    return true;
+}
+
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage)
+{
+    return (storage->bytes_reserved - storage->bytes_used) >=
+        FLECS_COLD_PAGE_SIZE;
+}
+
 static ecs_id_record_elem_t* flecs_component_elem(
     ecs_component_record_t *head,
     ecs_id_record_elem_t *list,
@@ -26245,6 +29443,7 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             /* Target determines the type, so unset storage flags */
             result &= ~EcsIdSparse;
             result &= ~EcsIdDontFragment;
+            result &= ~EcsIdCold;
 
             if (ecs_owns_id(world, tgt, EcsSparse)) {
                 result |= EcsIdSparse;
@@ -26253,6 +29452,10 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             if (ecs_owns_id(world, tgt, EcsDontFragment)) {
                 result |= EcsIdDontFragment;
             }
+
+            if (ecs_owns_id(world, tgt, EcsCold)) {
+                result |= EcsIdCold;
+            }
         }
     } else {
         /* Disable flags that only apply to pairs */
@@ -28785,6 +31988,9 @@ static void flecs_table_init_columns(
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, -(i + 1));
         }
+        if (table->_->records[i].hdr.cr->flags & EcsIdStableOrder) {
+            table->_->stable_order = true;
+        }
     }
 
     if (!column_count) {
@@ -28816,6 +32022,12 @@ static void flecs_table_init_columns(
         flecs_table_cache_set_column(&cr->cache, table, tr->column);
 
         columns[cur].ti = ECS_CONST_CAST(ecs_type_info_t*, ti);
+        if (ti->soa) {
+            columns[cur].flags = EcsColumnSoA;
+        }
+        if (cr->flags & EcsIdCold) {
+            columns[cur].flags |= EcsColumnCold;
+        }
         
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, cur + 1);
@@ -28951,6 +32163,10 @@ static void flecs_table_init_flags(
             table->trait_flags |= EcsIdSparse;
         } else if (id == EcsDontFragment) {
             table->trait_flags |= EcsIdDontFragment;
+        } else if (id == EcsCold) {
+            table->trait_flags |= EcsIdCold;
+        } else if (id == EcsStableOrder) {
+            table->trait_flags |= EcsIdStableOrder;
         } else if (id ==  EcsExclusive) {
             table->trait_flags |= EcsIdExclusive;   
         } else if (id == EcsTraversable) {
@@ -29083,6 +32299,60 @@ static void flecs_table_init_overrides(
     table->data.overrides = o;
 }
 
+/* Make sure there is a version stamp for each chunk of rows in the storage of
+ * the table. Stamps are only resized here, on the thread that owns the table
+ * storage, so that workers can mark rows dirty without allocating. */
+static void flecs_table_dirty_chunks_set_size(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t chunk_count = (table->data.size + FLECS_TABLE_DIRTY_CHUNK - 1) 
+        >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_set_min_count_zeromem_t(
+            &world->allocator, &chunks[i], int32_t, chunk_count);
+    }
+}
+
+/* Free row change tracking data */
+static void flecs_table_fini_dirty_chunks(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_fini_t(&world->allocator, &chunks[i], int32_t);
+    }
+
+    flecs_free_n(&world->allocator, ecs_vec_t, count, chunks);
+    table->_->dirty_chunks = NULL;
+}
+
+static void flecs_table_fini_row_order(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
+
+    ecs_vec_fini_t(&world->allocator, &row_order->keys, int32_t);
+    flecs_free_t(&world->allocator, ecs_table_row_order_t, row_order);
+    table->_->row_order = NULL;
+}
+
 static void flecs_table_fini_overrides(
     ecs_world_t *world, 
     ecs_table_t *table)
@@ -29576,6 +32846,67 @@ static void flecs_table_invoke_hook(
         table->type.array[type_index], column->ti, event, callback, NULL);
 }
 
+/* Zero initialize rows of a column with struct-of-arrays storage. The only 
+ * constructor that struct-of-arrays components can have is the default ctor. */
+static void flecs_table_column_soa_zero(
+    void *data,
+    int32_t capacity,
+    int32_t row,
+    int32_t count,
+    const ecs_soa_layout_t *soa)
+{
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &soa->members[i];
+        ecs_os_memset(ECS_OFFSET(data, m->offset * capacity + m->size * row),
+            0, m->size * count);
+    }
+}
+
+/* Copy value of inherited struct-of-arrays component into overriding rows. 
+ * Members of the base are gathered into a temporary value, which is then 
+ * scattered into the member arrays of the instances. */
+static void flecs_table_soa_override(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_entity_t base,
+    ecs_id_t id,
+    int32_t row,
+    int32_t count,
+    const ecs_type_info_t *ti)
+{
+    ecs_record_t *r = flecs_entities_get(world, base);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_table_t *base_table = r->table;
+    ecs_assert(base_table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, base_table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tr->column != -1, ECS_INTERNAL_ERROR, NULL);
+
+    void *value = ecs_os_alloca(ti->size);
+    flecs_table_soa_get(
+        base_table, tr->column, ECS_RECORD_TO_ROW(r->row), value);
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        flecs_table_soa_set(table, column_index, row + i, value);
+    }
+
+    ecs_iter_action_t on_set = ti->hooks.on_set;
+    if (on_set) {
+        int32_t record_index = table->column_map[table->type.count + column_index];
+        const ecs_table_record_t *dst_tr = &table->_->records[record_index];
+        const ecs_entity_t *entities = &ecs_table_entities(table)[row];
+        flecs_invoke_hook(world, table, dst_tr->hdr.cr, dst_tr->column,
+            count, row, entities, ti->component, ti, EcsOnSet,
+            on_set, NULL);
+    }
+}
+
 static void flecs_table_invoke_ctor_for_array(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -29593,6 +32924,12 @@ static void flecs_table_invoke_ctor_for_array(
             if (r->entity) {
                 ecs_id_t id = table->type.array[
                     table->column_map[table->type.count + column_index]];
+                if (ti->soa) {
+                    flecs_table_soa_override(world, table, column_index, 
+                        r->entity, id, row, count, ti);
+                    return;
+                }
+
                 void *base_ptr = ecs_ref_get_id(world, r, id);
                 ecs_assert(base_ptr != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -29622,6 +32959,15 @@ static void flecs_table_invoke_ctor_for_array(
         }
     }
 
+    if (ti->soa) {
+        ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (ti->hooks.ctor) {
+            flecs_table_column_soa_zero(
+                array, table->data.size, row, count, ti->soa);
+        }
+        return;
+    }
+
     flecs_type_info_ctor(ptr, count, ti);
 }
 
@@ -29783,6 +33129,431 @@ static void flecs_table_dtor_all(
 #define FLECS_LOCKED_STORAGE_MSG(operation) \
     "a " #operation " operation failed because the table is locked, fix by surrounding the operation with defer_begin()/defer_end()"
 
+/* Alignment of memory returned by the OS API malloc function */
+#define FLECS_COLUMN_HEAP_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+/* Columns that require a larger alignment than what malloc provides and paged
+ * columns store a header just before the column data. */
+typedef struct ecs_column_header_t {
+    void *base;                      /* Start of allocation or reserved range */
+    ecs_size_t reserved;             /* Reserved bytes (paged columns only) */
+    ecs_size_t committed;            /* Committed bytes (paged columns only) */
+} ecs_column_header_t;
+
+static
+ecs_column_header_t* flecs_table_column_header(
+    const ecs_column_t *column)
+{
+    ecs_assert(column->flags & (EcsColumnPaged|EcsColumnAligned), 
+        ECS_INTERNAL_ERROR, NULL);
+    return ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, column->data) - ECS_SIZEOF(ecs_column_header_t));
+}
+
+/* Get alignment for column storage of component */
+static
+ecs_size_t flecs_table_column_alignment(
+    const ecs_world_t *world,
+    const ecs_type_info_t *ti)
+{
+    ecs_size_t alignment = world->column_alignment;
+    if (ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+    return alignment;
+}
+
+/* Allocate column storage with an alignment that is larger than what malloc
+ * guarantees. */
+static
+void* flecs_table_column_alloc_aligned(
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t header = ECS_SIZEOF(ecs_column_header_t);
+    void *base = ecs_os_malloc(size + header + alignment);
+    if (!base) {
+        return NULL;
+    }
+
+    uintptr_t addr = (uintptr_t)base + (uintptr_t)header;
+    addr = (addr + (uintptr_t)alignment - 1) & ~((uintptr_t)alignment - 1);
+
+    void *result = (void*)addr;
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - header);
+    hdr->base = base;
+    hdr->reserved = 0;
+    hdr->committed = 0;
+    return result;
+}
+
+/* Paged columns reserve a range of address space up front, and commit memory
+ * to the range as the table grows. This keeps column data contiguous, while
+ * ensuring that growing a large column never has to move its elements. Column
+ * data starts at least one cache line after the start of the range. */
+static
+ecs_size_t flecs_table_column_pages_offset(
+    ecs_size_t alignment)
+{
+    return alignment > 64 ? alignment : 64;
+}
+
+/* Round number of bytes to commit up to the column page size */
+static
+ecs_size_t flecs_table_column_pages_round(
+    const ecs_world_t *world,
+    int64_t bytes,
+    ecs_size_t reserved)
+{
+    int64_t page_size = world->column_page_size;
+    if (page_size > 0) {
+        bytes = ((bytes + page_size - 1) / page_size) * page_size;
+    }
+    if (bytes > reserved) {
+        bytes = reserved;
+    }
+    return (ecs_size_t)bytes;
+}
+
+/* Reserve address range for paged column that can hold at least size bytes */
+static
+void* flecs_table_column_reserve(
+    ecs_world_t *world,
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t offset = flecs_table_column_pages_offset(alignment);
+    int64_t needed = (int64_t)size + offset;
+    int64_t reserve = FLECS_COLUMN_RESERVE_SIZE;
+    while (reserve < (needed * 2)) {
+        reserve *= 2;
+    }
+    if (reserve > INT32_MAX) {
+        reserve = INT32_MAX;
+    }
+    if (needed > reserve) {
+        return NULL;
+    }
+
+    void *base = ecs_os_reserve((ecs_size_t)reserve);
+    if (!base) {
+        return NULL;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, (ecs_size_t)reserve);
+    if (!ecs_os_commit(base, commit)) {
+        ecs_os_release(base, (ecs_size_t)reserve);
+        return NULL;
+    }
+
+    void *result = ECS_OFFSET(base, offset);
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - ECS_SIZEOF(ecs_column_header_t));
+    hdr->base = base;
+    hdr->reserved = (ecs_size_t)reserve;
+    hdr->committed = commit;
+    return result;
+}
+
+/* Commit or decommit memory so a paged column can hold size bytes. Returns 
+ * false if the reserved range is too small, or if memory could not be 
+ * committed. In that case the caller must move the column. */
+static
+bool flecs_table_column_commit(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    ecs_size_t size)
+{
+    ecs_column_header_t *hdr = flecs_table_column_header(column);
+    int64_t offset = ECS_CAST(char*, column->data) - ECS_CAST(char*, hdr->base);
+    int64_t needed = (int64_t)size + offset;
+    if (needed > hdr->reserved) {
+        return false;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, hdr->reserved);
+    if (commit > hdr->committed) {
+        if (!ecs_os_commit(ECS_OFFSET(hdr->base, hdr->committed), 
+            commit - hdr->committed)) 
+        {
+            return false;
+        }
+    } else if (commit < hdr->committed) {
+        ecs_os_decommit(ECS_OFFSET(hdr->base, commit), 
+            hdr->committed - commit);
+    }
+
+    hdr->committed = commit;
+    return true;
+}
+
+/* Free column storage */
+static
+void flecs_table_column_fini(
+    ecs_world_t *world,
+    ecs_column_t *column)
+{
+    if (column->flags & EcsColumnPaged) {
+        ecs_column_header_t *hdr = flecs_table_column_header(column);
+        ecs_os_release(hdr->base, hdr->reserved);
+    } else if (column->flags & EcsColumnAligned) {
+        if (column->data) {
+            ecs_os_free(flecs_table_column_header(column)->base);
+        }
+    } else if (column->flags & EcsColumnCold) {
+        flecs_cold_free(&world->store.cold, column->data);
+    } else if (column->data) {
+        ecs_os_free(column->data);
+    }
+
+    column->data = NULL;
+    column->flags &= ~EcsColumnStorageMask;
+}
+
+/* Move the member arrays of a column with struct-of-arrays storage to the 
+ * layout for a different capacity. Source and destination may be the same 
+ * storage, in which case members are moved in an order that ensures that no
+ * member array overwrites another member array that hasn't been moved yet. */
+static
+void flecs_table_column_soa_relayout(
+    const ecs_soa_layout_t *soa,
+    void *dst,
+    int32_t dst_capacity,
+    const void *src,
+    int32_t src_capacity,
+    int32_t count)
+{
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+
+    if (dst_capacity > src_capacity) {
+        for (i = member_count - 1; i >= 0; i --) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    } else {
+        for (i = 0; i < member_count; i ++) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    }
+}
+
+/* Copy rows between (or within) columns with struct-of-arrays storage */
+static
+void flecs_table_column_soa_copy(
+    ecs_column_t *dst,
+    int32_t dst_capacity,
+    int32_t dst_row,
+    const ecs_column_t *src,
+    int32_t src_capacity,
+    int32_t src_row,
+    int32_t count)
+{
+    const ecs_soa_layout_t *soa = dst->ti->soa;
+    ecs_assert(soa != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src->ti->soa == soa, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memmove(
+            ECS_OFFSET(dst->data, m->offset * dst_capacity + m->size * dst_row),
+            ECS_OFFSET(src->data, m->offset * src_capacity + m->size * src_row),
+            m->size * count);
+    }
+}
+
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_layout_t *soa = column->ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            ECS_OFFSET(value, m->offset), m->size);
+    }
+}
+
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+
+    /* Don't leave padding bytes uninitialized */
+    ecs_os_memset(value, 0, ti->size);
+
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(ECS_OFFSET(value, m->offset),
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            m->size);
+    }
+}
+
+/* Change size of column storage. When the column storage is moved, existing
+ * elements are moved with the ctor_move_dtor hook of the component. Columns 
+ * that are larger than the column page size of the world are stored in a 
+ * reserved address range, so that they can grow without moving. Column 
+ * storage is aligned to the largest of the component alignment and the column
+ * alignment of the world. Columns of cold components are stored in the cold 
+ * storage region of the world with the alignment of the component, and grow in
+ * place when the region has space after the column. The member arrays of columns with 
+ * struct-of-arrays storage are moved to the layout for the new size. */
+static
+void flecs_table_column_set_size(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t dst_size)
+{
+    ecs_assert(dst_size >= count, ECS_INTERNAL_ERROR, NULL);
+
+    if (dst_size == size) {
+        return;
+    }
+
+    if (!dst_size) {
+        flecs_table_column_fini(world, column);
+        return;
+    }
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = 
+        (column->flags & EcsColumnSoA) && count ? ti->soa : NULL;
+    ecs_size_t dst_bytes = ti->size * dst_size;
+    ecs_size_t alignment = flecs_table_column_alignment(world, ti);
+
+    if (column->flags & EcsColumnPaged) {
+        bool is_aligned = 
+            !((uintptr_t)column->data & ((uintptr_t)alignment - 1));
+        if (is_aligned) {
+            if (soa && dst_size < size) {
+                /* Compact members before memory is decommitted */
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+                size = dst_size;
+            }
+
+            if (flecs_table_column_commit(world, column, dst_bytes)) {
+                if (soa && dst_size > size) {
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                }
+                return;
+            }
+        }
+    }
+
+    void *dst = NULL;
+    ecs_flags32_t dst_flags = 0;
+    ecs_size_t page_size = world->column_page_size;
+    if (column->flags & EcsColumnCold) {
+        /* Cold columns are not paged and only use the alignment of the 
+         * component, which keeps them compact. */
+        if (ti->alignment > FLECS_COLD_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, ti->alignment);
+            dst_flags = EcsColumnAligned;
+        } else {
+            ecs_cold_storage_t *cold = &world->store.cold;
+            if (column->data) {
+                if (soa && dst_size < size) {
+                    /* Compact members before the block is shrunk */
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                    size = dst_size;
+                }
+
+                if (flecs_cold_resize(cold, column->data, dst_bytes)) {
+                    if (soa && dst_size > size) {
+                        flecs_table_column_soa_relayout(soa, column->data, 
+                            dst_size, column->data, size, count);
+                    }
+                    return;
+                }
+            }
+
+            dst = flecs_cold_alloc(cold, dst_bytes);
+        }
+    } else if (page_size && dst_bytes > page_size && 
+        ecs_os_has_virtual_memory()) 
+    {
+        dst = flecs_table_column_reserve(world, dst_bytes, alignment);
+        if (dst) {
+            dst_flags = EcsColumnPaged;
+        }
+    }
+
+    if (!dst && !(column->flags & EcsColumnCold)) {
+        if (alignment > FLECS_COLUMN_HEAP_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, alignment);
+            dst_flags = EcsColumnAligned;
+        } else if (!(column->flags & EcsColumnStorageMask) && 
+            (!count || !ti->hooks.ctor_move_dtor)) 
+        {
+            /* No elements need to be moved with hooks, realloc storage */
+            if (soa && dst_size < size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            column->data = ecs_os_realloc(column->data, dst_bytes);
+            if (soa && dst_size > size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            return;
+        } else {
+            dst = ecs_os_malloc(dst_bytes);
+        }
+    }
+
+    ecs_assert(dst != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    if (count) {
+        if (soa) {
+            flecs_table_column_soa_relayout(
+                soa, dst, dst_size, column->data, size, count);
+        } else if (ti->hooks.ctor_move_dtor) {
+            flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+        } else {
+            ecs_os_memcpy(dst, column->data, ti->size * count);
+        }
+    }
+
+    flecs_table_column_fini(world, column);
+    column->data = dst;
+    column->flags |= dst_flags;
+}
+
 /* Cleanup table storage */
 static void flecs_table_fini_data(
     ecs_world_t *world,
@@ -29804,10 +33575,7 @@ static void flecs_table_fini_data(
         if (columns) {
             int32_t c, column_count = table->column_count;
             for (c = 0; c < column_count; c ++) {
-                ecs_column_t *column = &columns[c];
-                ecs_vec_t v = ecs_vec_from_column(column, table, column->ti->size);
-                ecs_vec_fini(NULL, &v, column->ti->size);
-                column->data = NULL;
+                flecs_table_column_fini(world, &columns[c]);
             }
 
             flecs_wfree_n(world, ecs_column_t, table->column_count, columns);
@@ -29848,6 +33616,8 @@ static void flecs_table_fini_data(
         table->data.size = 0;
     }
 
+    flecs_table_fini_row_order(world, table);
+
     table->data.count = 0;
     table->_->traversable_count = 0;
     table->flags &= ~EcsTableHasTraversable;
@@ -29931,6 +33701,7 @@ void flecs_table_fini(
     }
 
     flecs_table_fini_overrides(world, table);
+    flecs_table_fini_dirty_chunks(world, table);
     flecs_wfree_n(world, int32_t, table->column_count + 1, table->dirty_state);
     ecs_os_free(table->column_map);
     if (table->component_map != flecs_table_empty_component_map) {
@@ -30007,11 +33778,45 @@ static void flecs_table_mark_table_dirty(
     }
 }
 
+/* Mark range of rows in table column dirty. If the table tracks row changes,
+ * stamp the chunks that contain the rows with the new column version. */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count)
+{
+    ecs_assert(table->dirty_state != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column < table->column_count, ECS_INTERNAL_ERROR, NULL);
+
+    /* Column is offset by 1, 0 is reserved for entity column. */
+    int32_t version = ++ table->dirty_state[column + 1];
+
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks || count <= 0) {
+        return;
+    }
+
+    /* Stamps are sized when the table storage grows, so this doesn't have to
+     * allocate when called from multiple workers. */
+    int32_t first = row >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t last = (row + count - 1) >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    ecs_vec_t *stamps = &chunks[column];
+    ecs_assert(last < ecs_vec_count(stamps), ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i, *array = ecs_vec_first_t(stamps, int32_t);
+    for (i = first; i <= last; i ++) {
+        flecs_table_stamp_store(&array[i], version);
+    }
+}
+
 /* Mark table component dirty */
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component)
+    ecs_entity_t component,
+    int32_t row)
 {
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -30037,8 +33842,7 @@ void flecs_table_mark_dirty(
         }
 
         /* Column is offset by 1, 0 is reserved for entity column. */
-
-        table->dirty_state[column] ++;
+        flecs_table_mark_column_dirty(table, column - 1, row, 1);
 
         ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
             FLECS_LOCKED_STORAGE_MSG("dirty marking"));
@@ -30064,6 +33868,25 @@ int32_t* flecs_table_get_dirty_state(
     return table->dirty_state;
 }
 
+/* Enable row change tracking for table. Writes that happened before tracking
+ * was enabled are not stamped, which is fine since queries that need the
+ * stamps treat tables they haven't synchronized with as fully changed. */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (table->_->dirty_chunks || !table->column_count) {
+        return;
+    }
+
+    flecs_table_get_dirty_state(world, table);
+
+    table->_->dirty_chunks = flecs_calloc_n(
+        &world->allocator, ecs_vec_t, table->column_count);
+    flecs_table_dirty_chunks_set_size(world, table);
+}
+
 /* Table move logic for bitset (toggle component) column */
 static void flecs_table_move_bitset_columns(
     ecs_table_t *dst_table, 
@@ -30153,69 +33976,276 @@ static void flecs_table_move_bitset_columns(
     }
 }
 
-/* Grow table column. When a column needs to be reallocated this function takes
- * care of correctly invoking ctor/move/dtor hooks. */
-static void flecs_table_grow_column(
+/* Defer keeping the rows of a table with StableOrder in order until the current
+ * command flush is done. While deferred, removed rows are filled with the last
+ * row of the table, and the order of the table is restored once for all 
+ * removed rows by flecs_table_restore_row_order(). This avoids shifting the 
+ * tail of the table for each removed row. Returns false if rows must be kept 
+ * in order right away. */
+static bool flecs_table_defer_row_order(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (table->_->row_order) {
+        return true;
+    }
+
+    if (!world->store.defer_row_order) {
+        return false;
+    }
+
+    /* Restoring the order moves values with ctor_move_dtor */
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        const ecs_type_info_t *ti = table->data.columns[i].ti;
+        if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+            return false;
+        }
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_row_order_t *row_order = flecs_alloc_t(a, ecs_table_row_order_t);
+    count = table->data.count;
+    ecs_vec_init_t(a, &row_order->keys, int32_t, count);
+    ecs_vec_set_count_t(a, &row_order->keys, int32_t, count);
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        keys[i] = i;
+    }
+    row_order->next = count;
+
+    table->_->row_order = row_order;
+    ecs_vec_append_t(a, &world->store.unordered_tables, uint64_t)[0] = 
+        table->id;
+
+    return true;
+}
+
+/* Add keys for rows appended to a table of which rows are out of order */
+static void flecs_table_row_order_append(
     ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t count)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    int32_t *keys = ecs_vec_grow_t(
+        &world->allocator, &row_order->keys, int32_t, count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        keys[i] = row_order->next ++;
+    }
+}
+
+/* Move values of a column so that row i gets the value of row src[i] */
+static void flecs_table_permute_column(
     ecs_table_t *table,
     int32_t column_index,
-    ecs_vec_t *column,
-    const ecs_type_info_t *ti,
-    int32_t to_add,
-    int32_t dst_size,
-    bool construct)
+    const int32_t *src,
+    bool *done,
+    void *tmp)
 {
-    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_column_t *column = &table->data.columns[column_index];
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t capacity = table->data.size;
+    bool soa = column->flags & EcsColumnSoA;
+    int32_t i, count = table->data.count;
+
+    ecs_os_memset_n(done, 0, bool, count);
+
+    for (i = 0; i < count; i ++) {
+        if (done[i] || src[i] == i) {
+            continue;
+        }
+
+        /* Rotate the values of the rows in the cycle that starts at row i */
+        if (soa) {
+            flecs_table_soa_get(table, column_index, i, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                tmp, ECS_ELEM(column->data, size, i), 1, ti);
+        }
+
+        int32_t cur = i;
+        while (src[cur] != i) {
+            if (soa) {
+                flecs_table_column_soa_copy(column, capacity, cur, 
+                    column, capacity, src[cur], 1);
+            } else {
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, cur), 
+                    ECS_ELEM(column->data, size, src[cur]), 1, ti);
+            }
+            done[cur] = true;
+            cur = src[cur];
+        }
 
-    int32_t count = ecs_vec_count(column);
-    int32_t size = ecs_vec_size(column);
-    int32_t elem_size = ti->size;
-    int32_t dst_count = count + to_add;
-    bool can_realloc = dst_size != size;
+        if (soa) {
+            flecs_table_soa_set(table, column_index, cur, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(column->data, size, cur), tmp, 1, ti);
+        }
+        done[cur] = true;
+    }
+}
 
-    ecs_assert(dst_size >= dst_count, ECS_INTERNAL_ERROR, NULL);
+/* Sort the rows of a table by their row order key */
+static void flecs_table_restore_rows(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
 
-    /* If the array could possibly realloc and the component has a move action 
-     * defined, move old elements manually */
-    if (count && can_realloc && ti->hooks.ctor_move_dtor) {
-        ecs_assert(ti->hooks.ctor != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("restore row order"));
 
-        /* Create vector */
-        ecs_vec_t dst;
-        ecs_vec_init(NULL, &dst, elem_size, dst_size);
-        dst.count = dst_count;
+    int32_t i, count = table->data.count, key_count = row_order->next;
+    ecs_assert(ecs_vec_count(&row_order->keys) == count, 
+        ECS_INTERNAL_ERROR, NULL);
+    if (!count) {
+        flecs_table_fini_row_order(world, table);
+        return;
+    }
 
-        void *src_buffer = column->array;
-        void *dst_buffer = dst.array;
+    /* Keys are unique and smaller than key_count, so rows can be sorted by
+     * looking up the row of each key. */
+    ecs_allocator_t *a = &world->allocator;
+    int32_t *src = flecs_alloc_n(a, int32_t, key_count);
+    bool *done = flecs_alloc_n(a, bool, count);
+    ecs_os_memset_n(src, -1, int32_t, key_count);
 
-        /* Move (and construct) existing elements to new vector */
-        flecs_type_info_ctor_move_dtor(dst_buffer, src_buffer, count, ti);
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        src[keys[i]] = i;
+    }
 
-        if (construct) {
-            /* Construct new element(s) */
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, dst_buffer, count, to_add, ti);
+    int32_t dst = 0;
+    bool sorted = true;
+    for (i = 0; i < key_count; i ++) {
+        if (src[i] != -1) {
+            sorted &= src[i] == dst;
+            src[dst ++] = src[i];
         }
+    }
 
-        /* Free old vector */
-        ecs_vec_fini(NULL, column, elem_size);
+    ecs_assert(dst == count, ECS_INTERNAL_ERROR, NULL);
 
-        *column = dst;
-    } else {
-        /* If array won't realloc or has no move, simply add new elements */
-        if (can_realloc) {
-            ecs_vec_set_size(NULL, column, elem_size, dst_size);
+    if (!sorted) {
+        /* If the table is monitored, indicate that there has been a change */
+        flecs_table_mark_table_dirty(world, table, 0);
+
+        ecs_entity_t *entities = table->data.entities;
+        ecs_table__t *meta = table->_;
+        int32_t b, bs_count = meta->bs_count;
+        ecs_size_t tmp_size = ECS_MAX(ECS_SIZEOF(ecs_entity_t), bs_count);
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            tmp_size = ECS_MAX(tmp_size, table->data.columns[c].ti->size);
         }
 
-        ecs_vec_grow(NULL, column, elem_size, to_add);
+        void *tmp = flecs_alloc(a, tmp_size);
 
-        if (construct) {
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, column->array, count, to_add, ti);
+        for (c = 0; c < column_count; c ++) {
+            flecs_table_permute_column(table, c, src, done, tmp);
+        }
+
+        /* Permute entity ids and toggle bitsets */
+        ecs_os_memset_n(done, 0, bool, count);
+        for (i = 0; i < count; i ++) {
+            if (done[i] || src[i] == i) {
+                continue;
+            }
+
+            ecs_entity_t e = entities[i];
+            for (b = 0; b < bs_count; b ++) {
+                ECS_CAST(bool*, tmp)[b] = 
+                    flecs_bitset_get(&meta->bs_columns[b], i);
+            }
+
+            int32_t cur = i;
+            while (src[cur] != i) {
+                entities[cur] = entities[src[cur]];
+                for (b = 0; b < bs_count; b ++) {
+                    ecs_bitset_t *bs = &meta->bs_columns[b];
+                    flecs_bitset_set(bs, cur, flecs_bitset_get(bs, src[cur]));
+                }
+                done[cur] = true;
+                cur = src[cur];
+            }
+
+            entities[cur] = e;
+            for (b = 0; b < bs_count; b ++) {
+                flecs_bitset_set(&meta->bs_columns[b], cur, 
+                    ECS_CAST(bool*, tmp)[b]);
+            }
+            done[cur] = true;
+        }
+
+        flecs_free(a, tmp_size, tmp);
+
+        for (i = 0; i < count; i ++) {
+            if (src[i] == i) {
+                continue;
+            }
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
         }
     }
 
-    ecs_assert(column->size == dst_size, ECS_INTERNAL_ERROR, NULL);
+    flecs_free_n(a, bool, count, done);
+    flecs_free_n(a, int32_t, key_count, src);
+    flecs_table_fini_row_order(world, table);
+
+    flecs_table_check_sanity(table);
+}
+
+void flecs_table_restore_row_order(
+    ecs_world_t *world)
+{
+    ecs_vec_t *tables = &world->store.unordered_tables;
+    int32_t i, count = ecs_vec_count(tables);
+    uint64_t *ids = ecs_vec_first_t(tables, uint64_t);
+    for (i = 0; i < count; i ++) {
+        /* Table could have been deleted while commands were flushed */
+        ecs_table_t *table = flecs_sparse_get_t(
+            &world->store.tables, ecs_table_t, ids[i]);
+        if (table) {
+            flecs_table_restore_rows(world, table);
+        }
+    }
+
+    ecs_vec_clear(tables);
+}
+
+/* Grow table column. When a column needs to be reallocated this function takes
+ * care of correctly invoking ctor/move/dtor hooks. */
+static void flecs_table_grow_column(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t to_add,
+    int32_t dst_size,
+    bool construct)
+{
+    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_size >= (count + to_add), ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_column_set_size(world, column, count, size, dst_size);
+
+    if (construct) {
+        /* Construct new element(s) */
+        flecs_table_invoke_ctor_for_array(
+            world, table, column_index, column->data, count, to_add, column->ti);
+    }
 }
 
 /* Grow all data structures in a table */
@@ -30224,7 +34254,8 @@ static int32_t flecs_table_grow_data(
     ecs_table_t *table,
     int32_t to_add,
     int32_t size,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     flecs_poly_assert(world, ecs_world_t);
 
@@ -30259,6 +34290,11 @@ static int32_t flecs_table_grow_data(
     table->data.entities = v_entities.array;
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
+
+    if (to_add && table->_->row_order) {
+        flecs_table_row_order_append(world, table, to_add);
+    }
 
     /* Initialize entity ids and record ptrs */
     int32_t i;
@@ -30276,15 +34312,10 @@ static int32_t flecs_table_grow_data(
     ecs_column_t *columns = table->data.columns;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, to_add, size, true);
-        ecs_assert(v_column.size == size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, ECS_INTERNAL_ERROR, NULL);
-        column->data = v_column.array;
-
-        if (to_add) {
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            to_add, size, construct);
+
+        if (to_add && construct) {
             flecs_table_invoke_add_hooks(
                 world, table, i, e, count, to_add, false);
         }
@@ -30343,17 +34374,21 @@ static void flecs_table_copy_elem(
 
 /* Append operation for tables that don't have any complex logic */
 static void flecs_table_fast_append(
-    ecs_table_t *table)
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size,
+    int32_t dst_size)
 {
-    /* Add elements to each column array */
+    if (size == dst_size) {
+        return;
+    }
+
+    /* Grow each column array */
     ecs_column_t *columns = table->data.columns;
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
-        ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v = ecs_vec_from_column(column, table, ti->size);
-        ecs_vec_append(NULL, &v, ti->size);
-        column->data = v.array;
+        flecs_table_column_set_size(
+            world, &columns[i], table->data.count, size, dst_size);
     }
 }
 
@@ -30384,6 +34419,10 @@ void flecs_table_append(
     ecs_assert(e != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_entity_t *entities = table->data.entities = v_entities.array;
     *e = entity;
+
+    if (table->_->row_order) {
+        flecs_table_row_order_append(world, table, 1);
+    }
  
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);
@@ -30396,9 +34435,10 @@ void flecs_table_append(
 
     /* Fast path: no toggle columns, no lifecycle actions */
     if (!(table->flags & (EcsTableIsComplex|EcsTableHasIsA))) {
-        flecs_table_fast_append(table);
+        flecs_table_fast_append(world, table, table->data.size, v_entities.size);
         table->data.count = v_entities.count;
         table->data.size = v_entities.size;
+        flecs_table_dirty_chunks_set_size(world, table);
         return;
     }
 
@@ -30411,6 +34451,7 @@ void flecs_table_append(
         ECS_INTERNAL_ERROR, NULL);
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
 
     /* Reobtain size to ensure that the columns have the same size as the
      * entities vector. This keeps reasoning about when allocations occur
@@ -30421,20 +34462,14 @@ void flecs_table_append(
     int32_t i;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, 1, size, construct);
-        column->data = v_column.array;
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            1, size, construct);
 
         ecs_iter_action_t on_add_hook;
         if (on_add && (on_add_hook = column->ti->hooks.on_add)) {
             flecs_table_invoke_hook(world, table, on_add_hook, EcsOnAdd, column,
                 &entities[count], count, 1);
         }
-
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, 
-            ECS_INTERNAL_ERROR, NULL);
     }
 
     ecs_table__t *meta = table->_;
@@ -30461,6 +34496,13 @@ static void flecs_table_fast_delete(
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
         ecs_column_t *column = &columns[i];
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_column_soa_copy(
+                column, capacity, row, column, capacity, last, 1);
+            continue;
+        }
+
         ecs_size_t size = column->ti->size;
         flecs_table_copy_elem(
             ECS_ELEM(column->data, size, row),
@@ -30468,6 +34510,167 @@ static void flecs_table_fast_delete(
     }
 }
 
+/* Shift values of a column that can't be moved with ctor_move_dtor. Values 
+ * are moved with move assignments, and the values that end up past the end of
+ * the table are destructed, like flecs_table_delete does with move_dtor. The
+ * values of the removed rows must still be constructed. */
+static void flecs_table_shift_column_w_move(
+    ecs_column_t *column,
+    int32_t row,
+    int32_t count,
+    int32_t move_count)
+{
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t i, src_row = row + count, end = row + move_count;
+
+    for (i = 0; i < move_count; i ++) {
+        void *dst = ECS_ELEM(column->data, size, row + i);
+        void *src = ECS_ELEM(column->data, size, src_row + i);
+        if ((src_row + i) < end) {
+            /* Source is the destination of a later move */
+            flecs_type_info_move(dst, src, 1, ti);
+        } else {
+            flecs_type_info_move_dtor(dst, src, 1, ti);
+        }
+    }
+
+    if (end < src_row) {
+        /* Removed rows that weren't overwritten */
+        flecs_table_invoke_dtor(column, end, src_row - end);
+    }
+}
+
+/* Shift rows after a range of removed rows down, so that the remaining rows
+ * keep their order. Column values of the removed rows must be destructed, 
+ * except for columns that can't be moved with ctor_move_dtor. */
+static void flecs_table_shift_rows(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count)
+{
+    int32_t i, src_row = row + count;
+    int32_t move_count = table->data.count - src_row;
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* Rows are out of order, shift keys along with the rows */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        if (move_count > 0) {
+            ecs_os_memmove_n(&keys[row], &keys[src_row], int32_t, move_count);
+        }
+        ecs_vec_set_count_t(&world->allocator, &row_order->keys, int32_t, 
+            table->data.count - count);
+    }
+
+    if (move_count > 0) {
+        ecs_entity_t *entities = table->data.entities;
+        ecs_os_memmove_n(&entities[row], &entities[src_row], 
+            ecs_entity_t, move_count);
+
+        for (i = row; i < (row + move_count); i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
+        }
+
+        bool has_move = table->flags & (EcsTableHasDtors | EcsTableHasMove);
+        ecs_column_t *columns = table->data.columns;
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            ecs_column_t *column = &columns[c];
+            if (column->flags & EcsColumnSoA) {
+                int32_t capacity = table->data.size;
+                flecs_table_column_soa_copy(column, capacity, row, 
+                    column, capacity, src_row, move_count);
+                continue;
+            }
+
+            ecs_type_info_t *ti = column->ti;
+            ecs_size_t size = ti->size;
+            if (!has_move) {
+                ecs_os_memmove(ECS_ELEM(column->data, size, row), 
+                    ECS_ELEM(column->data, size, src_row), size * move_count);
+                continue;
+            }
+
+            if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+                flecs_table_shift_column_w_move(column, row, count, move_count);
+                continue;
+            }
+
+            /* Move in blocks that don't overlap. The source rows of a block
+             * are destructed by the move and become the next destination. */
+            for (i = 0; i < move_count; i += count) {
+                int32_t n = ECS_MIN(count, move_count - i);
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, row + i), 
+                    ECS_ELEM(column->data, size, src_row + i), n, ti);
+            }
+        }
+    }
+
+    ecs_table__t *meta = table->_;
+    ecs_bitset_t *bs_columns = meta->bs_columns;
+    int32_t bs_count = meta->bs_count;
+    for (i = 0; i < bs_count; i ++) {
+        flecs_bitset_remove_range(&bs_columns[i], row, count);
+    }
+}
+
+/* Delete entity from table with the StableOrder trait */
+static void flecs_table_delete_ordered(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    bool destruct)
+{
+    ecs_entity_t entity_to_delete = table->data.entities[row];
+
+    /* If the table is monitored, indicate that there has been a change */
+    flecs_table_mark_table_dirty(world, table, 0);
+
+    if (table->flags & (EcsTableHasDtors | EcsTableHasMove)) {
+        ecs_column_t *columns = table->data.columns;
+        int32_t i, column_count = table->column_count;
+        for (i = 0; i < column_count; i ++) {
+            ecs_column_t *column = &columns[i];
+            ecs_type_info_t *ti = column->ti;
+
+            /* Values that can't be moved with ctor_move_dtor are shifted with
+             * move assignments, which overwrite the removed value. */
+            bool shift_w_move = 
+                ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL;
+
+            if (destruct) {
+                flecs_table_invoke_remove_hooks(world, table, column, 
+                    &entity_to_delete, row, 1, !shift_w_move);
+                continue;
+            }
+
+            /* Value was moved to another table. If the type does not support
+             * non-destructive moves, the value was already destructed. */
+            if (!shift_w_move && 
+                (ti->hooks.move_ctor || !ti->hooks.ctor_move_dtor)) 
+            {
+                flecs_table_invoke_dtor(column, row, 1);
+            }
+        }
+    }
+
+    flecs_table_shift_rows(world, table, row, 1);
+
+    table->data.count --;
+    if (!table->data.count) {
+        table->flags |= EcsTableEmpty;
+        table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_check_sanity(table);
+}
+
 /* Delete entity from table */
 void flecs_table_delete(
     ecs_world_t *world,
@@ -30487,6 +34690,21 @@ void flecs_table_delete(
     count --;
     ecs_assert(row <= count, ECS_INTERNAL_ERROR, NULL);
 
+    if (table->_->stable_order && (row != count)) {
+        if (!flecs_table_defer_row_order(world, table)) {
+            flecs_table_delete_ordered(world, table, row, destruct);
+            return;
+        }
+    }
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* The last row is moved to the deleted row */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        keys[row] = keys[count];
+        ecs_vec_remove_last(&row_order->keys);
+    }
+
     /* Move last entity id to row */
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t entity_to_move = entities[count];
@@ -30556,6 +34774,13 @@ void flecs_table_delete(
                         EcsOnRemove, column, &entity_to_delete, row, 1);
                 }
 
+                if (column->flags & EcsColumnSoA) {
+                    int32_t capacity = table->data.size;
+                    flecs_table_column_soa_copy(
+                        column, capacity, row, column, capacity, count, 1);
+                    continue;
+                }
+
                 /* If neither move nor move_ctor are set, this indicates that 
                  * non-destructive move semantics are not supported for this 
                  * type. In such cases, use ctor_move_dtor for destructive move
@@ -30608,10 +34833,16 @@ static void flecs_table_fast_move(
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
         if (dst_id == src_id) {
-            int32_t size = dst_column->ti->size;
-            void *dst = ECS_ELEM(dst_column->data, size, dst_index);
-            void *src = ECS_ELEM(src_column->data, size, src_index);
-            flecs_table_copy_elem(dst, src, size);
+            if (dst_column->flags & EcsColumnSoA) {
+                flecs_table_column_soa_copy(
+                    dst_column, dst_table->data.size, dst_index, 
+                    src_column, src_table->data.size, src_index, 1);
+            } else {
+                int32_t size = dst_column->ti->size;
+                void *dst = ECS_ELEM(dst_column->data, size, dst_index);
+                void *src = ECS_ELEM(src_column->data, size, src_index);
+                flecs_table_copy_elem(dst, src, size);
+            }
         }
 
         i_new += dst_id <= src_id;
@@ -30671,7 +34902,11 @@ void flecs_table_move(
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
-        if (dst_id == src_id) {
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(
+                dst_column, dst_table->data.size, dst_index, 
+                src_column, src_table->data.size, src_index, 1);
+        } else if (dst_id == src_id) {
             ecs_type_info_t *ti = dst_column->ti;
             int32_t size = ti->size;
 
@@ -30717,6 +34952,166 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 }
 
+/* Move a range of rows from src to dst table */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count)
+{
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!dst_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(!src_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t src_count = ecs_table_count(src_table);
+    ecs_assert(src_row >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert((src_row + count) <= src_count, ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    /* Append rows to destination table without constructing them. Column 
+     * values are either moved from the source table or constructed by the add
+     * hooks below. */
+    ecs_entity_t *src_entities = src_table->data.entities;
+    int32_t dst_row = ecs_table_count(dst_table);
+    flecs_table_grow_data(world, dst_table, count, dst_row + count, 
+        &src_entities[src_row], false);
+    ecs_entity_t *dst_entities = dst_table->data.entities;
+
+    flecs_table_move_bitset_columns(
+        dst_table, dst_row, src_table, src_row, count, false);
+
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    int32_t dst_size = dst_table->data.size, src_size = src_table->data.size;
+
+    /* Move shared columns as a single block per column. Values are moved with
+     * destructive move semantics, which leaves the source rows uninitialized
+     * so they can be overwritten by the tail of the source table. */
+    for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
+        ecs_column_t *dst_column = &dst_columns[i_new];
+        ecs_column_t *src_column = &src_columns[i_old];
+        ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
+        ecs_id_t src_id = flecs_column_id(src_table, i_old);
+
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(dst_column, dst_size, dst_row, 
+                src_column, src_size, src_row, count);
+        } else if (dst_id == src_id) {
+            ecs_type_info_t *ti = dst_column->ti;
+            int32_t size = ti->size;
+            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(dst_column->data, size, dst_row), 
+                ECS_ELEM(src_column->data, size, src_row), count, ti);
+        } else if (dst_id < src_id) {
+            flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+                &dst_entities[dst_row], dst_row, count, true);
+        } else {
+            flecs_table_invoke_remove_hooks(world, src_table, src_column, 
+                &src_entities[src_row], src_row, count, true);
+        }
+
+        i_new += dst_id <= src_id;
+        i_old += dst_id >= src_id;
+    }
+
+    for (; (i_new < dst_column_count); i_new ++) {
+        flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+            &dst_entities[dst_row], dst_row, count, true);
+    }
+
+    for (; (i_old < src_column_count); i_old ++) {
+        flecs_table_invoke_remove_hooks(world, src_table, &src_columns[i_old],
+            &src_entities[src_row], src_row, count, true);
+    }
+
+    /* Update records of moved entities in a single pass */
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_record_t *r = flecs_entities_get(world, dst_entities[dst_row + i]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+        r->table = dst_table;
+        r->row = ECS_ROW_TO_RECORD(dst_row + i, r->row & ECS_ROW_FLAGS_MASK);
+    }
+
+    if (src_table->_->stable_order) {
+        /* Shift the tail of the table down to keep rows in order */
+        flecs_table_shift_rows(world, src_table, src_row, count);
+    } else {
+        /* Fill the gap in the source table with rows from the end of the 
+         * table. Rows are filled in the same order as deleting the entities 
+         * one by one would, so that the resulting table is the same. */
+        int32_t fill = src_count - (src_row + count);
+        if (fill > count) {
+            fill = count;
+        }
+
+        for (i = 0; i < fill; i ++) {
+            int32_t dst = src_row + i, src = src_count - 1 - i;
+            ecs_entity_t e = src_entities[dst] = src_entities[src];
+            ecs_record_t *r = flecs_entities_get(world, e);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(dst, r->row & ECS_ROW_FLAGS_MASK);
+
+            int32_t c;
+            for (c = 0; c < src_column_count; c ++) {
+                ecs_column_t *column = &src_columns[c];
+                if (column->flags & EcsColumnSoA) {
+                    flecs_table_column_soa_copy(
+                        column, src_size, dst, column, src_size, src, 1);
+                    continue;
+                }
+
+                ecs_type_info_t *ti = column->ti;
+                int32_t size = ti->size;
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, dst), 
+                    ECS_ELEM(column->data, size, src), 1, ti);
+            }
+        }
+
+        ecs_table__t *meta = src_table->_;
+        ecs_bitset_t *bs_columns = meta->bs_columns;
+        int32_t bs_count = meta->bs_count;
+        for (i = 0; i < bs_count; i ++) {
+            ecs_bitset_t *bs = &bs_columns[i];
+            int32_t j;
+            for (j = 0; j < fill; j ++) {
+                flecs_bitset_set(bs, src_row + j, 
+                    flecs_bitset_get(bs, src_count - 1 - j));
+            }
+            for (j = 0; j < count; j ++) {
+                flecs_bitset_remove(bs, src_count - 1 - j);
+            }
+        }
+    }
+
+    src_table->data.count -= count;
+    if (!src_table->data.count) {
+        src_table->flags |= EcsTableEmpty;
+        src_table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_mark_table_dirty(world, src_table, 0);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    return dst_row;
+}
+
 /* Append n entities to table */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
@@ -30738,7 +35133,7 @@ int32_t flecs_table_appendn(
     flecs_table_check_sanity(table);
     int32_t cur_count = ecs_table_count(table);
     int32_t result = flecs_table_grow_data(
-        world, table, to_add, cur_count + to_add, ids);
+        world, table, to_add, cur_count + to_add, ids, true);
     flecs_table_check_sanity(table);
 
     return result;
@@ -30752,7 +35147,6 @@ bool flecs_table_shrink(
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table shrink"));
-    (void)world;
 
     flecs_table_check_sanity(table);
 
@@ -30778,18 +35172,8 @@ bool flecs_table_shrink(
 
     int32_t i, column_count = table->column_count;
     for (i = 0; i < column_count; i ++) {
-        const ecs_type_info_t *ti = columns[i].ti;
-        ecs_size_t component_size = ti->size;
-        void *data = columns[i].data;
-
-        if (count) {
-            columns[i].data = ecs_os_malloc(component_size * count);
-            flecs_type_info_ctor_move_dtor(columns[i].data, data, count, ti);
-        } else {
-            columns[i].data = NULL;
-        }
-
-        ecs_os_free(data);
+        flecs_table_column_set_size(
+            world, &columns[i], count, table->data.size, count);
     }
 
     table->data.size = count;
@@ -30801,6 +35185,66 @@ bool flecs_table_shrink(
     return has_payload;
 }
 
+/* Move cold columns of table to free space at lower addresses of the cold 
+ * storage region, so that pages at the end of the region can be released. 
+ * Returns whether a column was moved. */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("table compaction"));
+
+    ecs_cold_storage_t *cold = &world->store.cold;
+    ecs_column_t *columns = table->data.columns;
+    int32_t count = table->data.count, size = table->data.size;
+    int32_t i, column_count = table->column_count;
+    bool moved = false;
+
+    for (i = 0; i < column_count; i ++) {
+        ecs_column_t *column = &columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) != 
+            EcsColumnCold) 
+        {
+            continue;
+        }
+
+        if (!column->data) {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = column->ti;
+        void *dst = flecs_cold_alloc_before(
+            cold, ti->size * size, column->data);
+        if (!dst) {
+            continue;
+        }
+
+        if (count) {
+            if (column->flags & EcsColumnSoA) {
+                /* Capacity doesn't change, so member arrays keep offsets */
+                ecs_os_memcpy(dst, column->data, ti->size * size);
+            } else if (ti->hooks.ctor_move_dtor) {
+                flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+            } else {
+                ecs_os_memcpy(dst, column->data, ti->size * count);
+            }
+        }
+
+        flecs_cold_free(cold, column->data);
+        column->data = dst;
+        moved = true;
+    }
+
+    if (moved) {
+        /* Invalidate refs to components in the moved columns */
+        flecs_increment_table_version(world, table);
+    }
+
+    return moved;
+}
+
 /* Swap operation for bitset (toggle component) columns */
 static void flecs_table_swap_bitset_columns(
     ecs_table_t *table,
@@ -30840,6 +35284,9 @@ static void flecs_table_swap(
         return;
     }
 
+    /* Rows are sorted relative to the stable order of the table */
+    flecs_table_restore_rows(world, table);
+
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);    
 
@@ -30888,6 +35335,15 @@ static void flecs_table_swap(
         const ecs_type_info_t *ti = column->ti;
         ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
 
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_soa_get(table, i, row_1, tmp);
+            flecs_table_column_soa_copy(
+                column, capacity, row_1, column, capacity, row_2, 1);
+            flecs_table_soa_set(table, i, row_2, tmp);
+            continue;
+        }
+
         void *el_1 = ECS_ELEM(ptr, size, row_1);
         void *el_2 = ECS_ELEM(ptr, size, row_2);
 
@@ -30941,39 +35397,44 @@ static void flecs_table_merge_vec(
 /* Merge data from one table column into other table column */
 static void flecs_table_merge_column(
     ecs_world_t *world,
-    ecs_vec_t *dst_vec,
-    ecs_vec_t *src_vec,
     ecs_column_t *dst,
     ecs_column_t *src,
+    int32_t dst_count,
+    int32_t dst_size,
+    int32_t src_count,
+    int32_t src_size,
     int32_t column_size)
 {
     const ecs_type_info_t *ti = dst->ti;
     ecs_assert(ti == src->ti, ECS_INTERNAL_ERROR, NULL);
-    ecs_size_t elem_size = ti->size;
-    int32_t dst_count = ecs_vec_count(dst_vec);
 
     if (!dst_count) {
-        ecs_vec_fini(NULL, dst_vec, elem_size);
-        *dst_vec = *src_vec;
+        flecs_table_column_fini(world, dst);
+        dst->data = src->data;
+        dst->flags = src->flags;
 
     /* If the new table is not empty, move the contents from the
      * src into the dst. */
     } else {
-        int32_t src_count = src_vec->count;
+        flecs_table_grow_column(world, NULL, -1, dst, dst_count, dst_size,
+            src_count, column_size, false);
 
-        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, src_count, column_size, false);
-        void *dst_ptr = ECS_ELEM(dst_vec->array, elem_size, dst_count);
-        void *src_ptr = src_vec->array;
+        if (dst->flags & EcsColumnSoA) {
+            flecs_table_column_soa_copy(
+                dst, column_size, dst_count, src, src_size, 0, src_count);
+        } else {
+            void *dst_ptr = ECS_ELEM(dst->data, ti->size, dst_count);
+            void *src_ptr = src->data;
 
-        /* Move values into column */
-        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+            /* Move values into column */
+            flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+        }
 
-        ecs_vec_fini(NULL, src_vec, elem_size);
+        flecs_table_column_fini(world, src);
     }
 
-    dst->data = dst_vec->array;
     src->data = NULL;
+    src->flags &= ~EcsColumnStorageMask;
 }
 
 /* Merge storage of two tables. */
@@ -30995,6 +35456,9 @@ static void flecs_table_merge_data(
         return;
     }
 
+    int32_t dst_size = dst_table->data.size;
+    int32_t src_size = src_table->data.size;
+
     /* Merge entities */
     ecs_vec_t dst_entities = ecs_vec_from_entities(dst_table);
     ecs_vec_t src_entities = ecs_vec_from_entities(src_table);
@@ -31004,36 +35468,35 @@ static void flecs_table_merge_data(
         ECS_INTERNAL_ERROR, NULL);
     int32_t column_size = dst_entities.size;
 
+    /* Update destination storage before columns are merged, so that hooks 
+     * that are invoked for new columns see the merged entities. */
+    dst_table->data.entities = dst_entities.array;
+    dst_table->data.count = dst_entities.count;
+    dst_table->data.size = dst_entities.size;
+    flecs_table_dirty_chunks_set_size(world, dst_table);
+
     for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
         ecs_column_t *dst_column = &dst_columns[i_new];
         ecs_column_t *src_column = &src_columns[i_old];
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
-        ecs_size_t dst_elem_size = dst_column->ti->size;
-        ecs_size_t src_elem_size = src_column->ti->size;
-    
-        ecs_vec_t dst_vec = ecs_vec_from_column(
-            dst_column, dst_table, dst_elem_size);
-        ecs_vec_t src_vec = ecs_vec_from_column(
-            src_column, src_table, src_elem_size);
 
         if (dst_id == src_id) {
-            flecs_table_merge_column(world, &dst_vec, &src_vec, dst_column, 
-                src_column, column_size);
+            flecs_table_merge_column(world, dst_column, src_column, dst_count,
+                dst_size, src_count, src_size, column_size);
             flecs_table_mark_table_dirty(world, dst_table, i_new + 1);
             i_new ++;
             i_old ++;
         } else if (dst_id < src_id) {
-            /* New column, make sure vector is large enough. */
-            ecs_vec_set_size(NULL, &dst_vec, dst_elem_size, column_size);
-            dst_column->data = dst_vec.array;
+            /* New column, make sure storage is large enough. */
+            flecs_table_column_set_size(
+                world, dst_column, dst_count, dst_size, column_size);
             flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
             i_new ++;
         } else if (dst_id > src_id) {
             /* Old column does not occur in new table, destruct */
             flecs_table_invoke_dtor(src_column, 0, src_count);
-            ecs_vec_fini(NULL, &src_vec, src_elem_size);
-            src_column->data = NULL;
+            flecs_table_column_fini(world, src_column);
             i_old ++;
         }
     }
@@ -31044,32 +35507,23 @@ static void flecs_table_merge_data(
     /* Initialize remaining columns */
     for (; i_new < dst_column_count; i_new ++) {
         ecs_column_t *column = &dst_columns[i_new];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_vec_t vec = ecs_vec_from_column(column, dst_table, elem_size);
-        ecs_vec_set_size(NULL, &vec, elem_size, column_size);
-        column->data = vec.array;
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
+        flecs_table_column_set_size(
+            world, column, dst_count, dst_size, column_size);
         flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
     }
 
     /* Destruct remaining columns */
     for (; i_old < src_column_count; i_old ++) {
         ecs_column_t *column = &src_columns[i_old];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
         flecs_table_invoke_dtor(column, 0, src_count);
-        ecs_vec_t vec = ecs_vec_from_column(column, src_table, elem_size);
-        ecs_vec_fini(NULL, &vec, elem_size);
-        column->data = vec.array;
+        flecs_table_column_fini(world, column);
     }    
 
     /* Mark entity column as dirty */
     flecs_table_mark_table_dirty(world, dst_table, 0);
 
-    dst_table->data.entities = dst_entities.array;
-    dst_table->data.count = dst_entities.count;
-    dst_table->data.size = dst_entities.size;
-
     src_table->data.entities = src_entities.array;
     src_table->data.count = src_entities.count;
     src_table->data.size = src_entities.size;
@@ -31093,6 +35547,10 @@ void flecs_table_merge(
     flecs_table_check_sanity(src_table);
     flecs_table_check_sanity(dst_table);
 
+    /* Rows of the source table are appended in their stable order */
+    flecs_table_restore_rows(world, src_table);
+    flecs_table_restore_rows(world, dst_table);
+
     const ecs_entity_t *src_entities = ecs_table_entities(src_table);
     int32_t src_count = ecs_table_count(src_table);
     int32_t dst_count = ecs_table_count(dst_table);
@@ -31488,6 +35946,8 @@ void* ecs_table_get_column(
         "column index %d out of range for table", index);
 
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     void *result = column->data;
     if (offset) {
         result = ECS_ELEM(result, column->ti->size, offset);
@@ -31632,6 +36092,8 @@ void* ecs_record_get_by_column(
 
     ecs_check(index < table->column_count, ECS_INVALID_PARAMETER, NULL);
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     ecs_size_t size = column->ti->size;
 
     ecs_check(!flecs_utosize(c_size) || flecs_utosize(c_size) == size, 
@@ -33473,6 +37935,10 @@ ecs_table_t* ecs_table_find(
 
 #endif
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* For pthread_setaffinity_np */
+#endif
+
 #ifdef FLECS_OS_API_IMPL
 #ifdef ECS_TARGET_WINDOWS
 
@@ -33512,11 +37978,73 @@ static void* win_thread_join(
     return NULL;
 }
 
+static DWORD flecs_win_detached_thread(void *ptr) {
+    ecs_win_thread_t *thread = ptr;
+    thread->callback(thread->arg);
+    ecs_os_free(thread);
+    return 0;
+}
+
+/* Tasks are not pooled on Windows, a submitted task runs on its own thread.
+ * The functions to configure and inspect the pool are provided so that 
+ * applications can use the same code on all platforms. */
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    ecs_win_thread_t *thread = ecs_os_malloc_t(ecs_win_thread_t);
+    thread->arg = param;
+    thread->callback = callback;
+    HANDLE handle = CreateThread(NULL, 0, 
+        (LPTHREAD_START_ROUTINE)flecs_win_detached_thread, thread, 0, NULL);
+    if (!handle) {
+        ecs_os_abort();
+    }
+    CloseHandle(handle);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    (void)count;
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    return 0;
+}
+
 static ecs_os_thread_id_t win_thread_self(void)
 {
     return (ecs_os_thread_id_t)GetCurrentThreadId();
 }
 
+static bool win_thread_set_affinity(
+    ecs_os_thread_t thr,
+    int32_t cpu)
+{
+    if (cpu < -1 || cpu >= (int32_t)(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+
+    HANDLE handle = GetCurrentThread();
+    if (thr) {
+        handle = ((ecs_win_thread_t*)(uintptr_t)thr)->thread;
+    }
+
+    DWORD_PTR mask;
+    if (cpu == -1) {
+        /* Allow all cores the process can run on */
+        DWORD_PTR system_mask;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &mask, &system_mask)) {
+            return false;
+        }
+    } else {
+        mask = (DWORD_PTR)1 << cpu;
+    }
+
+    return SetThreadAffinityMask(handle, mask) != 0;
+}
+
 static int32_t win_ainc(
     int32_t *count) 
 {
@@ -33541,6 +38069,27 @@ static int64_t win_ladec(
     return InterlockedDecrement64(count);
 }
 
+static int32_t win_aload(
+    const int32_t *count) 
+{
+    return InterlockedCompareExchange(
+        (volatile long*)ECS_CONST_CAST(int32_t*, count), 0, 0);
+}
+
+static void* win_aloadp(
+    void *const *ptr) 
+{
+    return InterlockedCompareExchangePointer(
+        ECS_CONST_CAST(void *volatile*, ptr), NULL, NULL);
+}
+
+static void win_astorep(
+    void **ptr,
+    void *value) 
+{
+    InterlockedExchangePointer((void *volatile*)ptr, value);
+}
+
 static ecs_os_mutex_t win_mutex_new(void) {
     CRITICAL_SECTION *mutex = ecs_os_malloc_t(CRITICAL_SECTION);
     InitializeCriticalSection(mutex);
@@ -33709,6 +38258,43 @@ static void win_dlclose(ecs_os_dl_t lib) {
     FreeLibrary((HMODULE)(uintptr_t)lib);
 }
 
+static void* win_reserve(
+    ecs_size_t size)
+{
+    return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static bool win_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    return VirtualAlloc(ptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void win_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uintptr_t page_size = (uintptr_t)info.dwPageSize;
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        VirtualFree((void*)start, (SIZE_T)(end - start), MEM_DECOMMIT);
+    }
+}
+
+static void win_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
 static void win_fini(void) {
     if (ecs_os_api.flags_ & EcsOsApiHighResolutionTimer) {
         win_enable_high_timer_resolution(false);
@@ -33723,12 +38309,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = win_thread_new;
     api.thread_join_ = win_thread_join;
     api.thread_self_ = win_thread_self;
+    api.thread_set_affinity_ = win_thread_set_affinity;
     api.task_new_ = win_thread_new;
     api.task_join_ = win_thread_join;
     api.ainc_ = win_ainc;
     api.adec_ = win_adec;
     api.lainc_ = win_lainc;
     api.ladec_ = win_ladec;
+    api.aload_ = win_aload;
+    api.aloadp_ = win_aloadp;
+    api.astorep_ = win_astorep;
     api.mutex_new_ = win_mutex_new;
     api.mutex_free_ = win_mutex_free;
     api.mutex_lock_ = win_mutex_lock;
@@ -33744,6 +38334,10 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = win_dlopen;
     api.dlproc_ = win_dlproc;
     api.dlclose_ = win_dlclose;
+    api.reserve_ = win_reserve;
+    api.commit_ = win_commit;
+    api.decommit_ = win_decommit;
+    api.release_ = win_release;
 
     win_time_setup();
 
@@ -33759,6 +38353,15 @@ void ecs_set_os_api_impl(void) {
 #include "pthread.h"
 #include <dlfcn.h>
 
+#ifndef __EMSCRIPTEN__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach/mach_time.h>
 #elif defined(__EMSCRIPTEN__)
@@ -33797,11 +38400,235 @@ static void* posix_thread_join(
     return arg;
 }
 
+/* Tasks run on a pool of threads, so that creating and joining a task doesn't
+ * have to create and join a thread. A thread is added to the pool when a task 
+ * is created while all threads are busy, as tasks (like pipeline workers) can
+ * block until other tasks are running. When a thread finishes a task and the
+ * pool already has the maximum number of idle threads, the thread exits. The
+ * maximum is 0 by default, in which case each task runs on its own thread. */
+typedef struct posix_task_t {
+    ecs_os_thread_callback_t callback;
+    void *arg;
+    void *result;
+    bool done;
+    bool detached;
+    struct posix_task_t *next;
+} posix_task_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t task_cond;      /* Signaled when a task is queued */
+    pthread_cond_t done_cond;      /* Signaled when a task or thread is done */
+    posix_task_t *first;           /* Queue with tasks that haven't started */
+    posix_task_t *last;
+    int32_t queued_count;
+    int32_t idle_count;
+    int32_t max_idle_count;        /* Idle threads above this count exit */
+    int32_t thread_count;
+    bool quit;
+    ecs_os_api_fini_t prev_fini;   /* Fini callback of previous OS API */
+} posix_task_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .task_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER
+};
+
+static void* posix_task_pool_thread(
+    void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    for (;;) {
+        while (!posix_task_pool.first && !posix_task_pool.quit) {
+            if (posix_task_pool.idle_count >= posix_task_pool.max_idle_count) {
+                /* Don't keep more idle threads than allowed */
+                goto done;
+            }
+            posix_task_pool.idle_count ++;
+            pthread_cond_wait(&posix_task_pool.task_cond, &posix_task_pool.lock);
+            posix_task_pool.idle_count --;
+        }
+
+        /* Finish queued tasks before quitting */
+        posix_task_t *task = posix_task_pool.first;
+        if (!task) {
+            break;
+        }
+
+        posix_task_pool.first = task->next;
+        if (!posix_task_pool.first) {
+            posix_task_pool.last = NULL;
+        }
+        posix_task_pool.queued_count --;
+        pthread_mutex_unlock(&posix_task_pool.lock);
+
+        void *result = task->callback(task->arg);
+
+        pthread_mutex_lock(&posix_task_pool.lock);
+        if (task->detached) {
+            ecs_os_free(task);
+        } else {
+            task->result = result;
+            task->done = true;
+            pthread_cond_broadcast(&posix_task_pool.done_cond);
+        }
+    }
+
+done:
+    posix_task_pool.thread_count --;
+    pthread_cond_broadcast(&posix_task_pool.done_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return NULL;
+}
+
+static posix_task_t* posix_task_push(
+    ecs_os_thread_callback_t callback, 
+    void *arg,
+    bool detached)
+{
+    posix_task_t *task = ecs_os_calloc_t(posix_task_t);
+    task->callback = callback;
+    task->arg = arg;
+    task->detached = detached;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    if (posix_task_pool.last) {
+        posix_task_pool.last->next = task;
+    } else {
+        posix_task_pool.first = task;
+    }
+    posix_task_pool.last = task;
+    posix_task_pool.queued_count ++;
+
+    if (posix_task_pool.idle_count >= posix_task_pool.queued_count) {
+        pthread_cond_signal(&posix_task_pool.task_cond);
+    } else {
+        /* Pool threads are detached, the pool waits for them to exit by 
+         * tracking the number of running threads. */
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, posix_task_pool_thread, NULL) != 0) {
+            ecs_os_abort();
+        }
+        pthread_attr_destroy(&attr);
+        posix_task_pool.thread_count ++;
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return task;
+}
+
+static ecs_os_thread_t posix_task_new(
+    ecs_os_thread_callback_t callback, 
+    void *arg)
+{
+    return (ecs_os_thread_t)(uintptr_t)posix_task_push(callback, arg, false);
+}
+
+static void* posix_task_join(
+    ecs_os_thread_t thread)
+{
+    posix_task_t *task = (posix_task_t*)(uintptr_t)thread;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    while (!task->done) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    void *result = task->result;
+    ecs_os_free(task);
+    return result;
+}
+
+/* Stop pool threads after all queued tasks are done */
+static void posix_task_pool_fini(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.quit = true;
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    while (posix_task_pool.thread_count) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    posix_task_pool.quit = false;
+    ecs_os_api_fini_t prev_fini = posix_task_pool.prev_fini;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    if (prev_fini) {
+        prev_fini();
+    }
+}
+
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    posix_task_push(callback, param, true);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    ecs_assert(count >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.max_idle_count = count;
+
+    /* Wake up idle threads so that threads above the new maximum exit */
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    int32_t result = posix_task_pool.thread_count;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+    return result;
+}
+
 static ecs_os_thread_id_t posix_thread_self(void)
 {
     return (ecs_os_thread_id_t)pthread_self();
 }
 
+static bool posix_thread_set_affinity(
+    ecs_os_thread_t thread,
+    int32_t cpu)
+{
+#if defined(__linux__) && defined(CPU_SET)
+    if (cpu < -1 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    pthread_t thr = pthread_self();
+    if (thread) {
+        thr = *(pthread_t*)(uintptr_t)thread;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu == -1) {
+        /* Allow all cores. Cores that don't exist are ignored. */
+        int32_t i;
+        for (i = 0; i < CPU_SETSIZE; i ++) {
+            CPU_SET((size_t)i, &set);
+        }
+    } else {
+        CPU_SET((size_t)cpu, &set);
+    }
+
+    return pthread_setaffinity_np(thr, sizeof(set), &set) == 0;
+#else
+    /* Thread affinity is not supported on this platform */
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
 static int32_t posix_ainc(
     int32_t *count)
 {
@@ -33878,6 +38705,61 @@ static int64_t posix_ladec(
 #endif
 }
 
+static int32_t posix_aload(
+    const int32_t *count)
+{
+    int32_t value;
+#ifdef __GNUC__
+    value = __atomic_load_n(count, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *count;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void* posix_aloadp(
+    void *const *ptr)
+{
+    void *value;
+#ifdef __GNUC__
+    value = __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *ptr;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void posix_astorep(
+    void **ptr,
+    void *value)
+{
+#ifdef __GNUC__
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    *ptr = value;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+#endif
+}
+
 static ecs_os_mutex_t posix_mutex_new(void) {
     pthread_mutex_t *mutex = ecs_os_malloc(sizeof(pthread_mutex_t));
     if (pthread_mutex_init(mutex, NULL)) {
@@ -34049,6 +38931,66 @@ static void posix_dlclose(ecs_os_dl_t lib) {
     dlclose((void*)(uintptr_t)lib);
 }
 
+#ifndef __EMSCRIPTEN__
+static uintptr_t posix_vm_page_size(void) {
+    static uintptr_t page_size = 0;
+    if (!page_size) {
+        long result = sysconf(_SC_PAGESIZE);
+        page_size = result > 0 ? (uintptr_t)result : 4096;
+    }
+    return page_size;
+}
+
+static void* posix_reserve(
+    ecs_size_t size)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void *result = mmap(NULL, (size_t)size, PROT_NONE, flags, -1, 0);
+    if (result == MAP_FAILED) {
+        return NULL;
+    }
+    return result;
+}
+
+/* Commit rounds the range outwards to page boundaries, so that all bytes in the
+ * requested range are accessible. */
+static bool posix_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = (uintptr_t)ptr & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size + page_size - 1) & 
+        ~(page_size - 1);
+    return mprotect((void*)start, end - start, PROT_READ | PROT_WRITE) == 0;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void posix_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        madvise((void*)start, end - start, MADV_DONTNEED);
+        mprotect((void*)start, end - start, PROT_NONE);
+    }
+}
+
+static void posix_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    munmap(ptr, (size_t)size);
+}
+#endif
+
 void ecs_set_os_api_impl(void) {
     ecs_os_set_api_defaults();
 
@@ -34057,12 +38999,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = posix_thread_new;
     api.thread_join_ = posix_thread_join;
     api.thread_self_ = posix_thread_self;
-    api.task_new_ = posix_thread_new;
-    api.task_join_ = posix_thread_join;
+    api.thread_set_affinity_ = posix_thread_set_affinity;
+    api.task_new_ = posix_task_new;
+    api.task_join_ = posix_task_join;
     api.ainc_ = posix_ainc;
     api.adec_ = posix_adec;
     api.lainc_ = posix_lainc;
     api.ladec_ = posix_ladec;
+    api.aload_ = posix_aload;
+    api.aloadp_ = posix_aloadp;
+    api.astorep_ = posix_astorep;
     api.mutex_new_ = posix_mutex_new;
     api.mutex_free_ = posix_mutex_free;
     api.mutex_lock_ = posix_mutex_lock;
@@ -34077,6 +39023,19 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = posix_dlopen;
     api.dlproc_ = posix_dlproc;
     api.dlclose_ = posix_dlclose;
+#ifndef __EMSCRIPTEN__
+    api.reserve_ = posix_reserve;
+    api.commit_ = posix_commit;
+    api.decommit_ = posix_decommit;
+    api.release_ = posix_release;
+#endif
+
+    /* Chain the fini callback of a previously set OS API, unless this is the
+     * callback of the task pool itself. */
+    if (api.fini_ != posix_task_pool_fini) {
+        posix_task_pool.prev_fini = api.fini_;
+        api.fini_ = posix_task_pool_fini;
+    }
 
     posix_time_setup();
 
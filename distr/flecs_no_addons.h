@@ -393,6 +393,16 @@
 #define FLECS_ENTITY_PAGE_BITS 10
 #endif
 
+/** @def FLECS_COLUMN_RESERVE_SIZE
+ * Size of the address range that is reserved for a table column when it starts
+ * using paged storage (see ecs_set_column_page_size()). Columns that outgrow
+ * the reserved range are moved to a range that is at least twice as large.
+ * Reserving address space does not allocate memory, though 32-bit targets may
+ * want to use a smaller value. */
+#ifndef FLECS_COLUMN_RESERVE_SIZE
+#define FLECS_COLUMN_RESERVE_SIZE (256 * 1024 * 1024)
+#endif
+
 /** @def FLECS_USE_OS_ALLOC
  * When enabled, Flecs will use the OS allocator provided in the OS API directly
  * instead of the built-in block allocator. This can decrease memory utilization
@@ -468,6 +478,12 @@ extern "C" {
 #define EcsWorldMeasureSystemTime     (1u << 6)
 #define EcsWorldMultiThreaded         (1u << 7)
 #define EcsWorldFrameInProgress       (1u << 8)
+#define EcsWorldWorkStealing          (1u << 9)
+#define EcsWorldDagScheduling         (1u << 10)
+#define EcsWorldParallelMerge         (1u << 11)
+#define EcsWorldWorkerAffinity        (1u << 12)
+#define EcsWorldPipelinedFrames       (1u << 13)
+#define EcsWorldCoalesceCommands      (1u << 14)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// OS API flags
@@ -535,6 +551,8 @@ extern "C" {
         EcsIdHasOnTableCreate|EcsIdHasOnTableDelete|EcsIdSparse|\
         EcsIdOrderedChildren|EcsIdHasUpNotify)
 #define EcsIdPrefabChildren            (1u << 26)
+#define EcsIdCold                      (1u << 27)
+#define EcsIdStableOrder               (1u << 28)
 
 #define EcsIdMarkedForDelete           (1u << 30)
 
@@ -557,6 +575,7 @@ extern "C" {
 #define EcsNonTrivialIdSparse          (1u << 0)
 #define EcsNonTrivialIdNonFragmenting  (1u << 1)
 #define EcsNonTrivialIdInherit         (1u << 2)
+#define EcsNonTrivialIdSoA             (1u << 3)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Iterator flags (used by ecs_iter_t::flags)
@@ -1368,6 +1387,9 @@ typedef struct ecs_type_hooks_t ecs_type_hooks_t;
  * alignment, and type hooks. */
 typedef struct ecs_type_info_t ecs_type_info_t;
 
+/** Member layout of a component with struct-of-arrays storage. */
+typedef struct ecs_soa_layout_t ecs_soa_layout_t;
+
 /** Information about an entity, like its table and row. */
 typedef struct ecs_record_t ecs_record_t;
 
@@ -3367,6 +3389,26 @@ typedef
 void* (*ecs_os_api_calloc_t)(
     ecs_size_t size);
 
+/** OS API reserve function type.
+ * Reserves a range of virtual address space without backing it with memory. */
+typedef
+void* (*ecs_os_api_reserve_t)(
+    ecs_size_t size);
+
+/** OS API commit function type.
+ * Backs (part of) a reserved range with memory. Returns false on failure. */
+typedef
+bool (*ecs_os_api_commit_t)(
+    void *ptr,
+    ecs_size_t size);
+
+/** OS API release function type.
+ * Used to decommit part of a reserved range, or to release the entire range. */
+typedef
+void (*ecs_os_api_release_t)(
+    void *ptr,
+    ecs_size_t size);
+
 /** OS API strdup function type. */
 typedef
 char* (*ecs_os_api_strdup_t)(
@@ -3392,6 +3434,14 @@ void* (*ecs_os_api_thread_join_t)(
 typedef
 ecs_os_thread_id_t (*ecs_os_api_thread_self_t)(void);
 
+/** OS API thread_set_affinity function type.
+ * Pins a thread to a core. If thread is 0 the calling thread is pinned. If cpu
+ * is -1 the thread is allowed to run on any core. */
+typedef
+bool (*ecs_os_api_thread_set_affinity_t)(
+    ecs_os_thread_t thread,
+    int32_t cpu);
+
 /** OS API task_new function type. */
 typedef
 ecs_os_thread_t (*ecs_os_api_task_new_t)(
@@ -3414,6 +3464,22 @@ typedef
 int64_t (*ecs_os_api_lainc_t)(
     int64_t *value);
 
+/** OS API aload function type. */
+typedef
+int32_t (*ecs_os_api_aload_t)(
+    const int32_t *value);
+
+/** OS API aloadp function type. */
+typedef
+void* (*ecs_os_api_aloadp_t)(
+    void *const *value);
+
+/** OS API astorep function type. */
+typedef
+void (*ecs_os_api_astorep_t)(
+    void **ptr,
+    void *value);
+
 /** Mutex. */
 /** OS API mutex_new function type. */
 typedef
@@ -3567,6 +3633,12 @@ typedef struct ecs_os_api_t {
     ecs_os_api_calloc_t calloc_;                   /**< calloc callback. */
     ecs_os_api_free_t free_;                       /**< free callback. */
 
+    /* Virtual memory */
+    ecs_os_api_reserve_t reserve_;                 /**< reserve callback. */
+    ecs_os_api_commit_t commit_;                   /**< commit callback. */
+    ecs_os_api_release_t decommit_;                /**< decommit callback. */
+    ecs_os_api_release_t release_;                 /**< release callback. */
+
     /* Strings */
     ecs_os_api_strdup_t strdup_;                   /**< strdup callback. */
 
@@ -3574,16 +3646,20 @@ typedef struct ecs_os_api_t {
     ecs_os_api_thread_new_t thread_new_;           /**< thread_new callback. */
     ecs_os_api_thread_join_t thread_join_;         /**< thread_join callback. */
     ecs_os_api_thread_self_t thread_self_;         /**< thread_self callback. */
+    ecs_os_api_thread_set_affinity_t thread_set_affinity_; /**< thread_set_affinity callback. */
 
     /* Tasks */
     ecs_os_api_thread_new_t task_new_;             /**< task_new callback. */
     ecs_os_api_thread_join_t task_join_;           /**< task_join callback. */
 
-    /* Atomic increment and decrement */
+    /* Atomic increment, decrement, load and store */
     ecs_os_api_ainc_t ainc_;                       /**< ainc callback. */
     ecs_os_api_ainc_t adec_;                       /**< adec callback. */
     ecs_os_api_lainc_t lainc_;                     /**< lainc callback. */
     ecs_os_api_lainc_t ladec_;                     /**< ladec callback. */
+    ecs_os_api_aload_t aload_;                     /**< aload callback. */
+    ecs_os_api_aloadp_t aloadp_;                   /**< aloadp callback. */
+    ecs_os_api_astorep_t astorep_;                 /**< astorep callback. */
 
     /* Mutex */
     ecs_os_api_mutex_new_t mutex_new_;             /**< mutex_new callback. */
@@ -3716,6 +3792,18 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#ifndef ecs_os_reserve
+#define ecs_os_reserve(size) ecs_os_api.reserve_(size)
+#endif
+#ifndef ecs_os_commit
+#define ecs_os_commit(ptr, size) ecs_os_api.commit_(ptr, size)
+#endif
+#ifndef ecs_os_decommit
+#define ecs_os_decommit(ptr, size) ecs_os_api.decommit_(ptr, size)
+#endif
+#ifndef ecs_os_release
+#define ecs_os_release(ptr, size) ecs_os_api.release_(ptr, size)
+#endif
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -3794,6 +3882,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_thread_new(callback, param) ecs_os_api.thread_new_(callback, param)
 #define ecs_os_thread_join(thread) ecs_os_api.thread_join_(thread)
 #define ecs_os_thread_self() ecs_os_api.thread_self_()
+#define ecs_os_thread_set_affinity(thread, cpu) ecs_os_api.thread_set_affinity_(thread, cpu)
 
 /* Tasks */
 #define ecs_os_task_new(callback, param) ecs_os_api.task_new_(callback, param)
@@ -3804,6 +3893,9 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_adec(value) ecs_os_api.adec_(value)
 #define ecs_os_lainc(value) ecs_os_api.lainc_(value)
 #define ecs_os_ladec(value) ecs_os_api.ladec_(value)
+#define ecs_os_aload(value) ecs_os_api.aload_(value)
+#define ecs_os_aloadp(value) ecs_os_api.aloadp_((void *const*)(value))
+#define ecs_os_astorep(ptr, value) ecs_os_api.astorep_((void**)(ptr), value)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new_()
@@ -4038,6 +4130,10 @@ void* ecs_os_memdup(
 FLECS_API
 bool ecs_os_has_heap(void);
 
+/** Are virtual memory functions available? */
+FLECS_API
+bool ecs_os_has_virtual_memory(void);
+
 /** Are threading functions available? */
 FLECS_API
 bool ecs_os_has_threading(void);
@@ -4562,6 +4658,7 @@ struct ecs_type_info_t {
     ecs_entity_t component;  /**< Handle to component (do not set). */
     const char *name;        /**< Type name. */
     int32_t refcount;        /**< Refcount (do not set). */
+    ecs_soa_layout_t *soa;   /**< Struct-of-arrays member layout (do not set). */
 };
 
 #ifndef FLECS_API_TYPES_H
@@ -4640,6 +4737,12 @@ typedef struct ecs_page_iter_t {
 typedef struct ecs_worker_iter_t {
     int32_t index;
     int32_t count;
+    void *tasks;        /* Tasks shared between workers (work stealing) */
+    int32_t result;     /* Current result of chained iterator (work stealing) */
+    int32_t victim;     /* Worker to claim chunks from (work stealing) */
+    int32_t min_count;  /* Minimum number of entities per chunk (chunking) */
+    int32_t chunk_size; /* Maximum number of entities per chunk (chunking) */
+    int32_t chunk;      /* Next chunk in current result, -1 if none (chunking) */
 } ecs_worker_iter_t;
 
 /* Inlined element stored in a table cache. */
@@ -4706,7 +4809,9 @@ typedef struct ecs_iter_private_t {
 
 /* Data structures that store the command queue. */
 typedef struct ecs_commands_t {
-    ecs_vec_t queue;
+    ecs_vec_t queue;            /* Stream of variable length commands. */
+    int32_t count;              /* Number of commands in queue. */
+    uint32_t epoch;             /* Incremented after each flush. */
     ecs_stack_t stack;          /* Temp memory used by deferred commands. */
     ecs_sparse_t entries;       /* <entity, op_entry_t> - command batching. */
 } ecs_commands_t;
@@ -5767,6 +5872,20 @@ struct ecs_iter_t {
     ecs_iter_t *chain_it;         /**< Optional, allows for creating iterator chains. */
 };
 
+/** Prefetch table data while iterating a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * When this flag is set, a cached query issues software prefetches for the
+ * entity array and matched component columns of the next table in the cache
+ * while the current table is processed. This can improve performance of
+ * queries that read many components of tables that don't fit in the CPU
+ * cache. The flag has no effect on uncached queries. If cache_kind is left to
+ * the default value, this flag will cause it to default to EcsQueryCacheAuto.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryPrefetch              (1u << 0u)
+
 /** Query must match prefabs.
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -5791,6 +5910,18 @@ struct ecs_iter_t {
  */
 #define EcsQueryAllowUnresolvedByName (1u << 6u)
 
+/** Enable per-row change detection for a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * This flag implies EcsQueryDetectChanges. In addition, tables matched by the
+ * query keep track of which chunks of rows changed for each column, which
+ * makes it possible to use ecs_iter_changed_rows() to only process the rows
+ * that changed instead of the entire result.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryDetectRowChanges      (1u << 5u)
+
 /** Query only returns whole tables (ignores toggle or member fields).
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -6433,6 +6564,16 @@ FLECS_API extern const ecs_entity_t EcsSparse;
 /** Mark component as non-fragmenting. */
 FLECS_API extern const ecs_entity_t EcsDontFragment;
 
+/** Mark component as cold. Table columns of cold components are stored in a
+ * separate storage region of the world, away from the columns of other 
+ * components. */
+FLECS_API extern const ecs_entity_t EcsCold;
+
+/** Keep rows of tables with the component in order when entities are deleted
+ * from or moved out of the table. By default the last row of a table is moved
+ * into the row of a removed entity. */
+FLECS_API extern const ecs_entity_t EcsStableOrder;
+
 /** Marker used to indicate `$var == ...` matching in queries. */
 FLECS_API extern const ecs_entity_t EcsPredEq;
 
@@ -6818,6 +6959,122 @@ FLECS_API
 bool ecs_is_defer_suspended(
     const ecs_world_t *world);
 
+/** Enable or disable coalesced merging of commands.
+ * When enabled, commands that add, remove or set components are not applied
+ * one entity at a time. Instead the destination table of each entity in a
+ * sequence of such commands is computed first, after which entities are 
+ * grouped by their source and destination table. Each group is moved to its
+ * destination table in a single operation, which emits a single batch of 
+ * OnAdd/OnRemove events for all entities in the group.
+ *
+ * This reduces the cost of merging command queues in which many entities go
+ * through the same table transitions, like when spawning or despawning large
+ * numbers of entities. Note that coalescing reorders entities within their
+ * source table, and that observers for the entities of a group are invoked in
+ * a single batch instead of in the order in which commands were enqueued.
+ * Entities in tables with the StableOrder trait, entities with sparse or 
+ * non-fragmenting components and entities for which commands were enqueued 
+ * that change more than their table are merged as usual.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable coalesced merging.
+ */
+FLECS_API
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if coalesced merging of commands is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using coalesced merging.
+ */
+FLECS_API
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world);
+
+/** Add an id to an entity from a thread that doesn't own a stage.
+ * The async operations can be called from any thread without synchronizing
+ * with the main thread, and without creating a stage. Commands are stored in a
+ * lock-free queue, and are merged by the main thread when stages are merged
+ * (for example at the end of a pipeline sync point) or at the start of the
+ * next frame. Commands are merged in the order in which they were enqueued by
+ * a thread. No ordering is guaranteed between commands of different threads.
+ *
+ * Async operations don't access the world storage, which means that the 
+ * provided entity and id are not validated until the command is merged. If at
+ * that point the entity is no longer alive or the id is no longer valid, the 
+ * command is discarded.
+ *
+ * The async operations require the threading functions of the OS API.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Remove an id from an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Set a component from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The value is copied with memcpy when the command is
+ * enqueued, and the component's copy hook is invoked with the copied value 
+ * when the command is merged. Because of this the operation can only be used
+ * for components that can be copied with memcpy.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The component id.
+ * @param size The size of the component value.
+ * @param ptr Pointer to the component value.
+ */
+FLECS_API
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr);
+
+/** Delete an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity to delete.
+ */
+FLECS_API
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/** Enqueue an event from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The event is enqueued with ecs_enqueue() when the
+ * command is merged. The event descriptor and its ids are copied. Events must
+ * be emitted for an entity (not a table), and can't have a param.
+ *
+ * @param world The world.
+ * @param desc The event parameters.
+ */
+FLECS_API
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc);
+
 /** Configure the world to have N stages.
  * This initializes N stages, which allows applications to defer operations to
  * multiple isolated defer queues. This is typically used for applications with
@@ -7012,6 +7269,77 @@ FLECS_API
 void ecs_shrink(
     ecs_world_t *world);
 
+/** Set page size for table column storage.
+ * By default table columns are stored in a heap allocation, which is 
+ * reallocated when a table grows. For tables with many entities this means
+ * that all components are moved when the table crosses a capacity boundary,
+ * which can cause large frame spikes and temporarily doubles memory usage.
+ *
+ * When a page size is set, columns that are larger than the page size reserve
+ * a range of address space, and commit memory to it in increments of the page
+ * size as the table grows. Column data remains contiguous, and components are
+ * no longer moved when the table grows.
+ *
+ * Paged storage requires the virtual memory functions of the OS API (see
+ * ecs_os_has_virtual_memory()). If they are not available, columns are stored
+ * in heap allocations regardless of the page size. The page size only applies
+ * to columns that are allocated or resized after the operation is called.
+ * Columns of components with the #EcsCold trait are never paged.
+ *
+ * @param world The world.
+ * @param page_size The page size in bytes, or 0 to disable paged storage.
+ */
+FLECS_API
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size);
+
+/** Get page size for table column storage.
+ *
+ * @param world The world.
+ * @return The page size in bytes, or 0 if paged storage is disabled.
+ *
+ * @see ecs_set_column_page_size()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world);
+
+/** Set minimum alignment for table column storage.
+ * Table columns are aligned to the alignment of their component. This
+ * operation sets a minimum alignment for all columns, which allows systems to
+ * use aligned (SIMD) loads and stores on component arrays, and prevents 
+ * columns from sharing cache lines with other allocations.
+ *
+ * When the alignment is set, worker iterators (see ecs_worker_iter()) split
+ * tables at rows that preserve the alignment, so that the arrays of each 
+ * worker start at an aligned address. Use ecs_field_alignment() to obtain the
+ * alignment of a field in an iterator result.
+ *
+ * The alignment only applies to columns that are allocated or resized after
+ * the operation is called. Call this operation before creating entities.
+ * Columns of components with the #EcsCold trait only use the alignment of the
+ * component.
+ *
+ * @param world The world.
+ * @param alignment The alignment in bytes. Must be 0 or a power of two.
+ */
+FLECS_API
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment);
+
+/** Get minimum alignment for table column storage.
+ *
+ * @param world The world.
+ * @return The minimum alignment in bytes, or 0 if not set.
+ *
+ * @see ecs_set_column_alignment()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world);
+
 /** Get the largest issued entity ID (not counting generation).
  *
  * @param world The world.
@@ -7053,6 +7381,10 @@ typedef struct ecs_delete_empty_tables_desc_t {
     /** Table index to start scanning at. The function loops around until it
      * reaches this offset again, or until the time budget is exceeded. */
     int32_t offset;
+
+    /** Trim storage of non-empty tables that use less than this fraction of
+     * their capacity (for example 0.25). Set to 0 to disable. */
+    float shrink_ratio;
 } ecs_delete_empty_tables_desc_t;
 
 /** Clean up empty tables.
@@ -7084,6 +7416,15 @@ typedef struct ecs_delete_empty_tables_desc_t {
  * The function loops around until it reaches this offset again, or until the
  * time budget is exceeded.
  *
+ * When a table reaches the clear generation, its graph edges are pruned in
+ * addition to freeing its storage. Edges are recreated when the table is used
+ * again. When a shrink ratio is specified, the storage of non-empty tables
+ * that use less than that fraction of their capacity is trimmed to the
+ * number of entities in the table.
+ *
+ * The number of tables cleaned up and the (estimated) number of bytes that
+ * were reclaimed are reported by ecs_tables_memory_get() in the stats addon.
+ *
  * @param world The world.
  * @param desc Configuration parameters.
  * @return The index + 1 of the table where the function stopped, or 0 if the
@@ -7095,6 +7436,26 @@ int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc);
 
+/** Enable incremental table compaction.
+ * When enabled, ecs_frame_end() calls ecs_delete_empty_tables() with the
+ * provided parameters. Each frame resumes scanning at the table where the
+ * previous frame stopped, which spreads the cost of compaction over multiple
+ * frames when a time budget is set. The offset member of the descriptor is
+ * used as the initial offset.
+ *
+ * Compaction only runs from ecs_frame_end(), which requires the frame
+ * addon (FLECS_FRAME).
+ *
+ * @param world The world.
+ * @param desc Compaction parameters, or NULL to disable compaction.
+ *
+ * @see ecs_delete_empty_tables()
+ */
+FLECS_API
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc);
+
 /** Get the world from a poly.
  *
  * @param poly A pointer to a poly object.
@@ -9634,6 +9995,51 @@ ecs_iter_t ecs_worker_iter(
     int32_t index,
     int32_t count);
 
+/** Policy for dividing entities across resources of a worker iterator.
+ * Used with ecs_worker_iter_w_chunking(). */
+typedef struct ecs_worker_chunking_t {
+    /** Minimum number of entities in a chunk. Results with fewer entities are
+     * processed as a whole by a single resource. */
+    int32_t min_count;
+
+    /** Maximum number of entities in a chunk. When set, results with more
+     * entities are split into chunks of this size. When 0, the chunk size is
+     * derived from the size of the fields, so that the fields of a chunk fit
+     * in FLECS_WORKER_CHUNK_BYTES. Results are never split into more chunks 
+     * than needed to give each resource a chunk. */
+    int32_t chunk_size;
+
+    /** Disable the chunking policy. A zero-initialized policy doesn't change
+     * the policy of a system in ecs_system_update(), so this can be used to
+     * restore the default policy of a system. */
+    bool disable;
+} ecs_worker_chunking_t;
+
+/** Create a worker iterator with a chunking policy.
+ * Same as ecs_worker_iter(), but instead of dividing each result in equal
+ * parts, results are split up into chunks according to the chunking policy.
+ * Chunks are assigned round robin to resources, starting at a resource that is
+ * determined by the table of the result. This guarantees that the same chunks
+ * of a table are assigned to the same resource as long as the number of
+ * entities in the table does not change.
+ *
+ * If both members of the chunking policy are 0 or the policy is disabled, 
+ * this function is equivalent to ecs_worker_iter(). The iterator must be 
+ * iterated with ecs_worker_next().
+ *
+ * @param it The source iterator.
+ * @param index The index of the current resource.
+ * @param count The total number of resources to divide entities between.
+ * @param chunking The chunking policy.
+ * @return A worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking);
+
 /** Progress a worker iterator.
  * Progress an iterator created by ecs_worker_iter().
  *
@@ -9720,6 +10126,39 @@ void* ecs_field_at_w_size(
     int8_t index,
     int32_t row);
 
+/** Get data for a struct member of a field with struct-of-arrays storage.
+ * Components with the SoA trait (see the meta addon) store each member of the
+ * component in a separate array. Fields for such components cannot be accessed
+ * with ecs_field(), instead this operation returns the array for a single 
+ * member, which contains it->count values:
+ *
+ * @code
+ * while (ecs_query_next(&it)) {
+ *   float *x = ecs_field_member(&it, float, 0, 0);
+ *   float *vx = ecs_field_member(&it, float, 1, 0);
+ *   for (int32_t i = 0; i < it.count; i ++) {
+ *     x[i] += vx[i];
+ *   }
+ * }
+ * @endcode
+ *
+ * The member index is the index of the member in the struct, in the order in
+ * which members were registered. The provided size must be either 0 or must
+ * match the size of the member.
+ *
+ * @param it The iterator.
+ * @param size The size of the member type.
+ * @param index The index of the field.
+ * @param member The index of the member.
+ * @return A pointer to the member array of the field.
+ */
+FLECS_API
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member);
+
 /** Test whether the field is read-only.
  * This operation returns whether the field is read-only. Read-only fields are
  * annotated with [in], or are added as a const type in the C++ API.
@@ -9795,6 +10234,27 @@ ecs_entity_t ecs_field_src(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the enabled mask for a toggleable field.
+ * If the component matched by a field can be toggled (has the CanToggle
+ * trait), this operation returns the words of the bitset that stores which
+ * entities in the iterated table have the component enabled. This lets systems
+ * that iterate whole tables (see EcsQueryTableOnly) skip disabled rows with
+ * branch-free mask operations, instead of receiving one result per span.
+ *
+ * The mask is indexed by table row, not by iterator row. The bit for entity i
+ * of the current result is stored in word (it->offset + i) / 64 at bit
+ * (it->offset + i) % 64. Rows for which the bit is not set are disabled.
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The enabled mask, or NULL if the field has no toggle bitset, is not
+ *         set, or is not matched on the iterated table.
+ */
+FLECS_API
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Return the field type size.
  * Returns the type size of the field. Returns 0 if the field has no data.
  *
@@ -9807,6 +10267,24 @@ size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the alignment of the field data.
+ * Returns the alignment of the pointer returned by ecs_field() for the current
+ * result, up to the alignment guaranteed by table storage. For fields that are
+ * owned by the iterated table this is the largest of the component alignment
+ * and the column alignment (see ecs_set_column_alignment()), unless the 
+ * iterator starts at a row that is not aligned or the component has the 
+ * #EcsCold trait. Returns 0 if the field has no
+ * data, or if the field must be accessed with ecs_field_at().
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The alignment of the field data in bytes.
+ */
+FLECS_API
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Test whether the field is matched on self.
  * This operation returns whether the field is matched on the currently iterated
  * entity. This function will return false when the field is owned by another
@@ -10758,6 +11236,25 @@ void ecs_table_clear_entities(
 
 /** @} */
 
+/**
+ * @defgroup flecs_c_async Async commands
+ * @{
+ */
+
+/** Add a component from a thread that doesn't own a stage. */
+#define ecs_async_add(world, entity, T)\
+    ecs_async_add_id(world, entity, ecs_id(T))
+
+/** Remove a component from a thread that doesn't own a stage. */
+#define ecs_async_remove(world, entity, T)\
+    ecs_async_remove_id(world, entity, ecs_id(T))
+
+/** Set a component value from a thread that doesn't own a stage. */
+#define ecs_async_set(world, entity, component, ...)\
+    ecs_async_set_id(world, entity, ecs_id(component), sizeof(component), &(component)__VA_ARGS__)
+
+/** @} */
+
 /**
  * @defgroup flecs_c_singletons Singletons
  * @{
@@ -11015,6 +11512,10 @@ void ecs_table_clear_entities(
 #define ecs_field_at(it, T, index, row)\
     (ECS_CAST(T*, ecs_field_at_w_size(it, sizeof(T), index, row)))
 
+/** Get member array of a field with struct-of-arrays storage. */
+#define ecs_field_member(it, T, index, member)\
+    (ECS_CAST(T*, ecs_field_member_w_size(it, sizeof(T), index, member)))
+
 /** @} */
 
 /**
@@ -11922,6 +12423,52 @@ extern "C" {
 FLECS_API
 void ecs_set_os_api_impl(void);
 
+/** Set the maximum number of idle threads in the task pool.
+ * The POSIX OS API implementation runs tasks created with ecs_os_task_new(),
+ * which includes the tasks created by ecs_set_task_threads(), on a pool of 
+ * threads. When a thread finishes a task while the pool already has the 
+ * maximum number of idle threads, the thread exits. Threads that are kept can
+ * run the tasks of the next frame without creating a new thread.
+ *
+ * The default is 0, which means that every task runs on a new thread. Busy 
+ * threads are not limited, as tasks (like pipeline workers) can block until 
+ * other tasks are running.
+ *
+ * The task pool is not available on Windows, where this operation has no 
+ * effect.
+ *
+ * @param count The maximum number of idle threads.
+ */
+FLECS_API
+void ecs_os_set_task_pool_max_idle(
+    int32_t count);
+
+/** Submit a task to the task pool.
+ * This operation submits an application task to the pool that runs the tasks
+ * created with ecs_os_task_new(). Unlike tasks created with ecs_os_task_new(),
+ * the task does not need to be joined. Tasks that are still queued or running
+ * when the OS API is deinitialized are finished before the pool stops.
+ *
+ * On Windows the task runs on a new thread.
+ *
+ * @param callback The function to run.
+ * @param param The parameter passed to the function.
+ */
+FLECS_API
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param);
+
+/** Get the number of threads in the task pool.
+ * The pool adds a thread when a task is created while all threads are busy.
+ * Idle threads up to the count set with ecs_os_set_task_pool_max_idle() are 
+ * kept until the OS API is deinitialized. Always returns 0 on Windows.
+ *
+ * @return The number of threads in the task pool.
+ */
+FLECS_API
+int32_t ecs_os_task_pool_count(void);
+
 #ifdef __cplusplus
 }
 #endif
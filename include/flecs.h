@@ -312,6 +312,16 @@
 #define FLECS_ENTITY_PAGE_BITS 10
 #endif
 
+/** @def FLECS_COLUMN_RESERVE_SIZE
+ * Size of the address range that is reserved for a table column when it starts
+ * using paged storage (see ecs_set_column_page_size()). Columns that outgrow
+ * the reserved range are moved to a range that is at least twice as large.
+ * Reserving address space does not allocate memory, though 32-bit targets may
+ * want to use a smaller value. */
+#ifndef FLECS_COLUMN_RESERVE_SIZE
+#define FLECS_COLUMN_RESERVE_SIZE (256 * 1024 * 1024)
+#endif
+
 /** @def FLECS_USE_OS_ALLOC
  * When enabled, Flecs will use the OS allocator provided in the OS API directly
  * instead of the built-in block allocator. This can decrease memory utilization
@@ -498,6 +508,9 @@ typedef struct ecs_type_hooks_t ecs_type_hooks_t;
  * alignment, and type hooks. */
 typedef struct ecs_type_info_t ecs_type_info_t;
 
+/** Member layout of a component with struct-of-arrays storage. */
+typedef struct ecs_soa_layout_t ecs_soa_layout_t;
+
 /** Information about an entity, like its table and row. */
 typedef struct ecs_record_t ecs_record_t;
 
@@ -1054,6 +1067,7 @@ struct ecs_type_info_t {
     ecs_entity_t component;  /**< Handle to component (do not set). */
     const char *name;        /**< Type name. */
     int32_t refcount;        /**< Refcount (do not set). */
+    ecs_soa_layout_t *soa;   /**< Struct-of-arrays member layout (do not set). */
 };
 
 #include "flecs/private/api_types.h"        /* Supporting API types */
@@ -1252,6 +1266,20 @@ struct ecs_iter_t {
 };
 
 
+/** Prefetch table data while iterating a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * When this flag is set, a cached query issues software prefetches for the
+ * entity array and matched component columns of the next table in the cache
+ * while the current table is processed. This can improve performance of
+ * queries that read many components of tables that don't fit in the CPU
+ * cache. The flag has no effect on uncached queries. If cache_kind is left to
+ * the default value, this flag will cause it to default to EcsQueryCacheAuto.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryPrefetch              (1u << 0u)
+
 /** Query must match prefabs.
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -1276,6 +1304,18 @@ struct ecs_iter_t {
  */
 #define EcsQueryAllowUnresolvedByName (1u << 6u)
 
+/** Enable per-row change detection for a query.
+ * Can be combined with other query flags on the ecs_query_desc_t::flags field.
+ *
+ * This flag implies EcsQueryDetectChanges. In addition, tables matched by the
+ * query keep track of which chunks of rows changed for each column, which
+ * makes it possible to use ecs_iter_changed_rows() to only process the rows
+ * that changed instead of the entire result.
+ *
+ * \ingroup queries
+ */
+#define EcsQueryDetectRowChanges      (1u << 5u)
+
 /** Query only returns whole tables (ignores toggle or member fields).
  * Can be combined with other query flags on the ecs_query_desc_t::flags field.
  * \ingroup queries
@@ -1918,6 +1958,16 @@ FLECS_API extern const ecs_entity_t EcsSparse;
 /** Mark component as non-fragmenting. */
 FLECS_API extern const ecs_entity_t EcsDontFragment;
 
+/** Mark component as cold. Table columns of cold components are stored in a
+ * separate storage region of the world, away from the columns of other 
+ * components. */
+FLECS_API extern const ecs_entity_t EcsCold;
+
+/** Keep rows of tables with the component in order when entities are deleted
+ * from or moved out of the table. By default the last row of a table is moved
+ * into the row of a removed entity. */
+FLECS_API extern const ecs_entity_t EcsStableOrder;
+
 /** Marker used to indicate `$var == ...` matching in queries. */
 FLECS_API extern const ecs_entity_t EcsPredEq;
 
@@ -2303,6 +2353,122 @@ FLECS_API
 bool ecs_is_defer_suspended(
     const ecs_world_t *world);
 
+/** Enable or disable coalesced merging of commands.
+ * When enabled, commands that add, remove or set components are not applied
+ * one entity at a time. Instead the destination table of each entity in a
+ * sequence of such commands is computed first, after which entities are 
+ * grouped by their source and destination table. Each group is moved to its
+ * destination table in a single operation, which emits a single batch of 
+ * OnAdd/OnRemove events for all entities in the group.
+ *
+ * This reduces the cost of merging command queues in which many entities go
+ * through the same table transitions, like when spawning or despawning large
+ * numbers of entities. Note that coalescing reorders entities within their
+ * source table, and that observers for the entities of a group are invoked in
+ * a single batch instead of in the order in which commands were enqueued.
+ * Entities in tables with the StableOrder trait, entities with sparse or 
+ * non-fragmenting components and entities for which commands were enqueued 
+ * that change more than their table are merged as usual.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable coalesced merging.
+ */
+FLECS_API
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if coalesced merging of commands is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using coalesced merging.
+ */
+FLECS_API
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world);
+
+/** Add an id to an entity from a thread that doesn't own a stage.
+ * The async operations can be called from any thread without synchronizing
+ * with the main thread, and without creating a stage. Commands are stored in a
+ * lock-free queue, and are merged by the main thread when stages are merged
+ * (for example at the end of a pipeline sync point) or at the start of the
+ * next frame. Commands are merged in the order in which they were enqueued by
+ * a thread. No ordering is guaranteed between commands of different threads.
+ *
+ * Async operations don't access the world storage, which means that the 
+ * provided entity and id are not validated until the command is merged. If at
+ * that point the entity is no longer alive or the id is no longer valid, the 
+ * command is discarded.
+ *
+ * The async operations require the threading functions of the OS API.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Remove an id from an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id);
+
+/** Set a component from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The value is copied with memcpy when the command is
+ * enqueued, and the component's copy hook is invoked with the copied value 
+ * when the command is merged. Because of this the operation can only be used
+ * for components that can be copied with memcpy.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param id The component id.
+ * @param size The size of the component value.
+ * @param ptr Pointer to the component value.
+ */
+FLECS_API
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr);
+
+/** Delete an entity from a thread that doesn't own a stage.
+ * See ecs_async_add_id().
+ *
+ * @param world The world.
+ * @param entity The entity to delete.
+ */
+FLECS_API
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/** Enqueue an event from a thread that doesn't own a stage.
+ * See ecs_async_add_id(). The event is enqueued with ecs_enqueue() when the
+ * command is merged. The event descriptor and its ids are copied. Events must
+ * be emitted for an entity (not a table), and can't have a param.
+ *
+ * @param world The world.
+ * @param desc The event parameters.
+ */
+FLECS_API
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc);
+
 /** Configure the world to have N stages.
  * This initializes N stages, which allows applications to defer operations to
  * multiple isolated defer queues. This is typically used for applications with
@@ -2497,6 +2663,77 @@ FLECS_API
 void ecs_shrink(
     ecs_world_t *world);
 
+/** Set page size for table column storage.
+ * By default table columns are stored in a heap allocation, which is 
+ * reallocated when a table grows. For tables with many entities this means
+ * that all components are moved when the table crosses a capacity boundary,
+ * which can cause large frame spikes and temporarily doubles memory usage.
+ *
+ * When a page size is set, columns that are larger than the page size reserve
+ * a range of address space, and commit memory to it in increments of the page
+ * size as the table grows. Column data remains contiguous, and components are
+ * no longer moved when the table grows.
+ *
+ * Paged storage requires the virtual memory functions of the OS API (see
+ * ecs_os_has_virtual_memory()). If they are not available, columns are stored
+ * in heap allocations regardless of the page size. The page size only applies
+ * to columns that are allocated or resized after the operation is called.
+ * Columns of components with the #EcsCold trait are never paged.
+ *
+ * @param world The world.
+ * @param page_size The page size in bytes, or 0 to disable paged storage.
+ */
+FLECS_API
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size);
+
+/** Get page size for table column storage.
+ *
+ * @param world The world.
+ * @return The page size in bytes, or 0 if paged storage is disabled.
+ *
+ * @see ecs_set_column_page_size()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world);
+
+/** Set minimum alignment for table column storage.
+ * Table columns are aligned to the alignment of their component. This
+ * operation sets a minimum alignment for all columns, which allows systems to
+ * use aligned (SIMD) loads and stores on component arrays, and prevents 
+ * columns from sharing cache lines with other allocations.
+ *
+ * When the alignment is set, worker iterators (see ecs_worker_iter()) split
+ * tables at rows that preserve the alignment, so that the arrays of each 
+ * worker start at an aligned address. Use ecs_field_alignment() to obtain the
+ * alignment of a field in an iterator result.
+ *
+ * The alignment only applies to columns that are allocated or resized after
+ * the operation is called. Call this operation before creating entities.
+ * Columns of components with the #EcsCold trait only use the alignment of the
+ * component.
+ *
+ * @param world The world.
+ * @param alignment The alignment in bytes. Must be 0 or a power of two.
+ */
+FLECS_API
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment);
+
+/** Get minimum alignment for table column storage.
+ *
+ * @param world The world.
+ * @return The minimum alignment in bytes, or 0 if not set.
+ *
+ * @see ecs_set_column_alignment()
+ */
+FLECS_API
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world);
+
 /** Get the largest issued entity ID (not counting generation).
  *
  * @param world The world.
@@ -2538,6 +2775,10 @@ typedef struct ecs_delete_empty_tables_desc_t {
     /** Table index to start scanning at. The function loops around until it
      * reaches this offset again, or until the time budget is exceeded. */
     int32_t offset;
+
+    /** Trim storage of non-empty tables that use less than this fraction of
+     * their capacity (for example 0.25). Set to 0 to disable. */
+    float shrink_ratio;
 } ecs_delete_empty_tables_desc_t;
 
 /** Clean up empty tables.
@@ -2569,6 +2810,15 @@ typedef struct ecs_delete_empty_tables_desc_t {
  * The function loops around until it reaches this offset again, or until the
  * time budget is exceeded.
  *
+ * When a table reaches the clear generation, its graph edges are pruned in
+ * addition to freeing its storage. Edges are recreated when the table is used
+ * again. When a shrink ratio is specified, the storage of non-empty tables
+ * that use less than that fraction of their capacity is trimmed to the
+ * number of entities in the table.
+ *
+ * The number of tables cleaned up and the (estimated) number of bytes that
+ * were reclaimed are reported by ecs_tables_memory_get() in the stats addon.
+ *
  * @param world The world.
  * @param desc Configuration parameters.
  * @return The index + 1 of the table where the function stopped, or 0 if the
@@ -2580,6 +2830,26 @@ int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc);
 
+/** Enable incremental table compaction.
+ * When enabled, ecs_frame_end() calls ecs_delete_empty_tables() with the
+ * provided parameters. Each frame resumes scanning at the table where the
+ * previous frame stopped, which spreads the cost of compaction over multiple
+ * frames when a time budget is set. The offset member of the descriptor is
+ * used as the initial offset.
+ *
+ * Compaction only runs from ecs_frame_end(), which requires the frame
+ * addon (FLECS_FRAME).
+ *
+ * @param world The world.
+ * @param desc Compaction parameters, or NULL to disable compaction.
+ *
+ * @see ecs_delete_empty_tables()
+ */
+FLECS_API
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc);
+
 /** Get the world from a poly.
  *
  * @param poly A pointer to a poly object.
@@ -5479,6 +5749,44 @@ uint64_t ecs_iter_get_group(
 FLECS_API
 bool ecs_iter_changed(
     ecs_iter_t *it);
+
+/** Find the next range of changed rows in the current iterator result.
+ * This operation finds the rows in the currently iterated result for which
+ * fields read by the query changed since the last time they were iterated.
+ * Row changes are tracked in chunks of 64 rows, so a returned range can
+ * contain rows that did not change.
+ *
+ * The row parameter is used both as input and output. On input it specifies
+ * the first row (relative to the result) to check, on output it contains the
+ * first row of the changed range. To find all changed ranges, call the
+ * operation in a loop, starting at 0 and advancing row by count each time:
+ *
+ * @code
+ * int32_t row = 0, count;
+ * while (ecs_iter_changed_rows(&it, &row, &count)) {
+ *   for (int32_t i = row; i < row + count; i ++) {
+ *     // process it.entities[i]
+ *   }
+ *   row += count;
+ * }
+ * @endcode
+ *
+ * If the query was not created with EcsQueryDetectRowChanges, if the table
+ * gained or lost entities, or if a field with a source other than $this
+ * changed, all remaining rows are returned as a single range.
+ *
+ * @param it The iterator.
+ * @param row The first row to check, set to the first changed row.
+ * @param count Set to the number of changed rows.
+ * @return True if a range of changed rows was found, false if not.
+ *
+ * @see ecs_iter_changed()
+ */
+FLECS_API
+bool ecs_iter_changed_rows(
+    ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count);
 #endif
 
 /** Create a paged iterator.
@@ -5538,6 +5846,51 @@ ecs_iter_t ecs_worker_iter(
     int32_t index,
     int32_t count);
 
+/** Policy for dividing entities across resources of a worker iterator.
+ * Used with ecs_worker_iter_w_chunking(). */
+typedef struct ecs_worker_chunking_t {
+    /** Minimum number of entities in a chunk. Results with fewer entities are
+     * processed as a whole by a single resource. */
+    int32_t min_count;
+
+    /** Maximum number of entities in a chunk. When set, results with more
+     * entities are split into chunks of this size. When 0, the chunk size is
+     * derived from the size of the fields, so that the fields of a chunk fit
+     * in FLECS_WORKER_CHUNK_BYTES. Results are never split into more chunks 
+     * than needed to give each resource a chunk. */
+    int32_t chunk_size;
+
+    /** Disable the chunking policy. A zero-initialized policy doesn't change
+     * the policy of a system in ecs_system_update(), so this can be used to
+     * restore the default policy of a system. */
+    bool disable;
+} ecs_worker_chunking_t;
+
+/** Create a worker iterator with a chunking policy.
+ * Same as ecs_worker_iter(), but instead of dividing each result in equal
+ * parts, results are split up into chunks according to the chunking policy.
+ * Chunks are assigned round robin to resources, starting at a resource that is
+ * determined by the table of the result. This guarantees that the same chunks
+ * of a table are assigned to the same resource as long as the number of
+ * entities in the table does not change.
+ *
+ * If both members of the chunking policy are 0 or the policy is disabled, 
+ * this function is equivalent to ecs_worker_iter(). The iterator must be 
+ * iterated with ecs_worker_next().
+ *
+ * @param it The source iterator.
+ * @param index The index of the current resource.
+ * @param count The total number of resources to divide entities between.
+ * @param chunking The chunking policy.
+ * @return A worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking);
+
 /** Progress a worker iterator.
  * Progress an iterator created by ecs_worker_iter().
  *
@@ -5624,6 +5977,39 @@ void* ecs_field_at_w_size(
     int8_t index,
     int32_t row);
 
+/** Get data for a struct member of a field with struct-of-arrays storage.
+ * Components with the SoA trait (see the meta addon) store each member of the
+ * component in a separate array. Fields for such components cannot be accessed
+ * with ecs_field(), instead this operation returns the array for a single 
+ * member, which contains it->count values:
+ *
+ * @code
+ * while (ecs_query_next(&it)) {
+ *   float *x = ecs_field_member(&it, float, 0, 0);
+ *   float *vx = ecs_field_member(&it, float, 1, 0);
+ *   for (int32_t i = 0; i < it.count; i ++) {
+ *     x[i] += vx[i];
+ *   }
+ * }
+ * @endcode
+ *
+ * The member index is the index of the member in the struct, in the order in
+ * which members were registered. The provided size must be either 0 or must
+ * match the size of the member.
+ *
+ * @param it The iterator.
+ * @param size The size of the member type.
+ * @param index The index of the field.
+ * @param member The index of the member.
+ * @return A pointer to the member array of the field.
+ */
+FLECS_API
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member);
+
 /** Test whether the field is read-only.
  * This operation returns whether the field is read-only. Read-only fields are
  * annotated with [in], or are added as a const type in the C++ API.
@@ -5699,6 +6085,27 @@ ecs_entity_t ecs_field_src(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the enabled mask for a toggleable field.
+ * If the component matched by a field can be toggled (has the CanToggle
+ * trait), this operation returns the words of the bitset that stores which
+ * entities in the iterated table have the component enabled. This lets systems
+ * that iterate whole tables (see EcsQueryTableOnly) skip disabled rows with
+ * branch-free mask operations, instead of receiving one result per span.
+ *
+ * The mask is indexed by table row, not by iterator row. The bit for entity i
+ * of the current result is stored in word (it->offset + i) / 64 at bit
+ * (it->offset + i) % 64. Rows for which the bit is not set are disabled.
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The enabled mask, or NULL if the field has no toggle bitset, is not
+ *         set, or is not matched on the iterated table.
+ */
+FLECS_API
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Return the field type size.
  * Returns the type size of the field. Returns 0 if the field has no data.
  *
@@ -5711,6 +6118,24 @@ size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index);
 
+/** Return the alignment of the field data.
+ * Returns the alignment of the pointer returned by ecs_field() for the current
+ * result, up to the alignment guaranteed by table storage. For fields that are
+ * owned by the iterated table this is the largest of the component alignment
+ * and the column alignment (see ecs_set_column_alignment()), unless the 
+ * iterator starts at a row that is not aligned or the component has the 
+ * #EcsCold trait. Returns 0 if the field has no
+ * data, or if the field must be accessed with ecs_field_at().
+ *
+ * @param it The iterator.
+ * @param index The index of the field in the iterator.
+ * @return The alignment of the field data in bytes.
+ */
+FLECS_API
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index);
+
 /** Test whether the field is matched on self.
  * This operation returns whether the field is matched on the currently iterated
  * entity. This function will return false when the field is owned by another
@@ -236,6 +236,10 @@ static const flecs::entity_t Symbol = EcsSymbol;
 static const flecs::entity_t Sparse = EcsSparse;
 /** DontFragment storage tag. */
 static const flecs::entity_t DontFragment = EcsDontFragment;
+/** Cold storage tag. */
+static const flecs::entity_t Cold = EcsCold;
+/** StableOrder storage tag. */
+static const flecs::entity_t StableOrder = EcsStableOrder;
 
 /** PredEq query predicate. */
 static const flecs::entity_t PredEq = EcsPredEq;
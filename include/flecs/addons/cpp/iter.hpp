@@ -203,6 +203,16 @@ public:
         return ecs_field_is_set(iter_, index);
     }
 
+    /** Return the enabled mask for a toggleable field.
+     *
+     * @param index The field index.
+     * @return The enabled mask (indexed by table row), or nullptr.
+     * @see ecs_field_enabled_mask()
+     */
+    const uint64_t* enabled_mask(int8_t index) const {
+        return ecs_field_enabled_mask(iter_, index);
+    }
+
     /** Return whether the field is readonly.
      *
      * @param index The field index.
@@ -229,6 +239,17 @@ public:
         return ecs_field_size(iter_, index);
     }
 
+    /** Alignment of the field data.
+     *
+     * @param index The field index.
+     * @return The alignment of the field data.
+     *
+     * @see ecs_field_alignment()
+     */
+    ecs_size_t alignment(int8_t index) const {
+        return ecs_field_alignment(iter_, index);
+    }
+
     /** Obtain the field source (0 if This).
      *
      * @param index The field index.
@@ -315,6 +336,23 @@ public:
         return get_unchecked_field(index);
     }
 
+    /** Get access to the array of a single struct member.
+     * This function must be used to access fields for components with the SoA
+     * (struct-of-arrays) trait, which store each member in a separate array.
+     *
+     * @tparam T Type of the member.
+     * @param index The field index.
+     * @param member The index of the member in the struct.
+     * @return The member data.
+     */
+    template <typename T>
+    flecs::field<T> field_member(int8_t index, int32_t member) const {
+        bool is_shared = !ecs_field_is_self(iter_, index);
+        size_t count = is_shared ? 1 : static_cast<size_t>(iter_->count);
+        return flecs::field<T>(static_cast<T*>(ecs_field_member_w_size(
+            iter_, sizeof(T), index, member)), count, is_shared);
+    }
+
     /** Get pointer to field at row.
      * This function may be used to access shared fields when row is set to 0.
      *
@@ -385,6 +423,18 @@ public:
         return ecs_iter_changed(iter_);
     }
 
+    /** Find the next range of changed rows in the current result.
+     * Can only be used when iterating queries and/or systems.
+     *
+     * @param row The first row to check, set to the first changed row.
+     * @param count Set to the number of changed rows.
+     * @return True if a range of changed rows was found.
+     * @see ecs_iter_changed_rows()
+     */
+    bool changed_rows(int32_t& row, int32_t& count) {
+        return ecs_iter_changed_rows(iter_, &row, &count);
+    }
+
     /** Skip current table.
      * This indicates to the query that the data in the current table is not
      * modified. By default, iterating a table with a query will mark the
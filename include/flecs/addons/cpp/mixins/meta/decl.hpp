@@ -73,6 +73,7 @@ static const flecs::entity_t F64 = ecs_id(ecs_f64_t);
 static const flecs::entity_t String = ecs_id(ecs_string_t);
 static const flecs::entity_t Entity = ecs_id(ecs_entity_t);
 static const flecs::entity_t Quantity = EcsQuantity;
+static const flecs::entity_t SoA = EcsSoA;
 
 namespace meta {
 
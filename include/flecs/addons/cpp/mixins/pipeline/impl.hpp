@@ -73,4 +73,78 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(world_);
 }
 
+inline void world::set_work_stealing(bool enable) const {
+    ecs_set_work_stealing(world_, enable);
+}
+
+inline bool world::using_work_stealing() const {
+    return ecs_using_work_stealing(world_);
+}
+
+inline void world::set_dag_scheduling(bool enable) const {
+    ecs_set_dag_scheduling(world_, enable);
+}
+
+inline bool world::using_dag_scheduling() const {
+    return ecs_using_dag_scheduling(world_);
+}
+
+inline void world::set_parallel_merge(bool enable) const {
+    ecs_set_parallel_merge(world_, enable);
+}
+
+inline bool world::using_parallel_merge() const {
+    return ecs_using_parallel_merge(world_);
+}
+
+inline void world::set_pipelined_frames(bool enable) const {
+    ecs_set_pipelined_frames(world_, enable);
+}
+
+inline bool world::using_pipelined_frames() const {
+    return ecs_using_pipelined_frames(world_);
+}
+
+template <typename T>
+inline void world::set_double_buffered(bool enable) const {
+    ecs_set_double_buffered(world_, _::type<T>::id(world_), enable);
+}
+
+template <typename T>
+inline bool world::is_double_buffered() const {
+    return ecs_is_double_buffered(world_, _::type<T>::id(world_));
+}
+
+inline void world::set_worker_spin_count(int32_t spin_count) const {
+    ecs_set_worker_spin_count(world_, spin_count);
+}
+
+inline int32_t world::get_worker_spin_count() const {
+    return ecs_get_worker_spin_count(world_);
+}
+
+inline void world::set_worker_min_cost(ecs_ftime_t min_cost) const {
+    ecs_set_worker_min_cost(world_, min_cost);
+}
+
+inline ecs_ftime_t world::get_worker_min_cost() const {
+    return ecs_get_worker_min_cost(world_);
+}
+
+inline void world::set_worker_cost_weight(ecs_ftime_t weight) const {
+    ecs_set_worker_cost_weight(world_, weight);
+}
+
+inline ecs_ftime_t world::get_worker_cost_weight() const {
+    return ecs_get_worker_cost_weight(world_);
+}
+
+inline void world::set_worker_affinity(const int32_t *cpus, int32_t count) const {
+    ecs_set_worker_affinity(world_, cpus, count);
+}
+
+inline int32_t world::get_worker_affinity(int32_t worker) const {
+    return ecs_get_worker_affinity(world_, worker);
+}
+
 }
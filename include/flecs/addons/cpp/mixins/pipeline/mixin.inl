@@ -78,4 +78,96 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Enable or disable work stealing.
+ * @see ecs_set_work_stealing()
+ */
+void set_work_stealing(bool enable = true) const;
+
+/** Return true if work stealing is enabled.
+ * @see ecs_using_work_stealing()
+ */
+bool using_work_stealing() const;
+
+/** Enable or disable dependency graph scheduling.
+ * @see ecs_set_dag_scheduling()
+ */
+void set_dag_scheduling(bool enable = true) const;
+
+/** Return true if dependency graph scheduling is enabled.
+ * @see ecs_using_dag_scheduling()
+ */
+bool using_dag_scheduling() const;
+
+/** Enable or disable parallel merging of command queues.
+ * @see ecs_set_parallel_merge()
+ */
+void set_parallel_merge(bool enable = true) const;
+
+/** Return true if parallel merging of command queues is enabled.
+ * @see ecs_using_parallel_merge()
+ */
+bool using_parallel_merge() const;
+
+/** Enable or disable pipelined frame execution.
+ * @see ecs_set_pipelined_frames()
+ */
+void set_pipelined_frames(bool enable = true) const;
+
+/** Return true if pipelined frame execution is enabled.
+ * @see ecs_using_pipelined_frames()
+ */
+bool using_pipelined_frames() const;
+
+/** Enable or disable double buffering for a component.
+ * @see ecs_set_double_buffered()
+ */
+template <typename T>
+void set_double_buffered(bool enable = true) const;
+
+/** Return true if a component is double buffered.
+ * @see ecs_is_double_buffered()
+ */
+template <typename T>
+bool is_double_buffered() const;
+
+/** Set number of spin iterations for worker synchronization.
+ * @see ecs_set_worker_spin_count()
+ */
+void set_worker_spin_count(int32_t spin_count) const;
+
+/** Get number of spin iterations for worker synchronization.
+ * @see ecs_get_worker_spin_count()
+ */
+int32_t get_worker_spin_count() const;
+
+/** Set minimum estimated time per thread for multithreaded sync points.
+ * @see ecs_set_worker_min_cost()
+ */
+void set_worker_min_cost(ecs_ftime_t min_cost) const;
+
+/** Get minimum estimated time per thread for multithreaded sync points.
+ * @see ecs_get_worker_min_cost()
+ */
+ecs_ftime_t get_worker_min_cost() const;
+
+/** Set weight of the last measurement in the estimated cost of a system.
+ * @see ecs_set_worker_cost_weight()
+ */
+void set_worker_cost_weight(ecs_ftime_t weight) const;
+
+/** Get weight of the last measurement in the estimated cost of a system.
+ * @see ecs_get_worker_cost_weight()
+ */
+ecs_ftime_t get_worker_cost_weight() const;
+
+/** Pin worker threads to cores.
+ * @see ecs_set_worker_affinity()
+ */
+void set_worker_affinity(const int32_t *cpus, int32_t count) const;
+
+/** Get the core a worker thread is pinned to.
+ * @see ecs_get_worker_affinity()
+ */
+int32_t get_worker_affinity(int32_t worker) const;
+
 /** @} */
@@ -45,6 +45,18 @@ struct query_builder_i : term_builder_i<Base> {
         return *this;
     }
 
+    /** Prefetch table data while iterating the query. */
+    Base& prefetch() {
+        desc_->flags |= EcsQueryPrefetch;
+        return *this;
+    }
+
+    /** Enable per-row change detection for the query. */
+    Base& detect_row_changes() {
+        desc_->flags |= EcsQueryDetectRowChanges;
+        return *this;
+    }
+
     /** Set the query expression string. */
     Base& expr(const char *expr) {
         ecs_check(expr_count_ == 0, ECS_INVALID_OPERATION,
@@ -72,6 +72,29 @@ public:
         return *this;
     }
 
+    /** Specify whether the system can overlap with the next frame.
+     *
+     * @param value If true, the system can run while the next frame runs.
+     * @see ecs_set_pipelined_frames()
+     */
+    Base& pipelined(bool value = true) {
+        desc_->pipelined = value;
+        return *this;
+    }
+
+    /** Specify how entities are divided across threads for a multithreaded
+     * system.
+     *
+     * @param min_count Minimum number of entities processed by a thread.
+     * @param chunk_size Maximum number of entities in a chunk (0 = cache-sized chunks).
+     * @see ecs_worker_iter_w_chunking()
+     */
+    Base& chunking(int32_t min_count, int32_t chunk_size = 0) {
+        desc_->chunking.min_count = min_count;
+        desc_->chunking.chunk_size = chunk_size;
+        return *this;
+    }
+
     /** Set the system interval.
      * This operation will cause the system to be run at the specified interval.
      *
@@ -24,6 +24,10 @@ inline void set(world_t *world, flecs::entity_t entity, T&& value, flecs::id_t i
             "operation invalid for empty type");
 
     ecs_cpp_get_mut_t res = ecs_cpp_set(world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     if constexpr (std::is_copy_assignable_v<T>) {
@@ -55,6 +59,10 @@ inline void set(world_t *world, flecs::entity_t entity, const T& value, flecs::i
             "operation invalid for empty type");
 
     ecs_cpp_get_mut_t res = ecs_cpp_set(world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     dst = value;
@@ -112,6 +120,10 @@ inline void assign(world_t *world, flecs::entity_t entity, T&& value, flecs::id_
 
     ecs_cpp_get_mut_t res = ecs_cpp_assign(
         world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     if constexpr (std::is_copy_assignable_v<T>) {
@@ -145,6 +157,10 @@ inline void assign(world_t *world, flecs::entity_t entity, const T& value, flecs
 
     ecs_cpp_get_mut_t res = ecs_cpp_assign(
         world, entity, id, &value, sizeof(T));
+    if (!res.ptr) {
+        /* Value was already assigned (component has struct-of-arrays storage) */
+        return;
+    }
 
     T& dst = *static_cast<remove_reference_t<T>*>(res.ptr);
     dst = value;
@@ -452,6 +468,96 @@ struct world {
         return ecs_is_defer_suspended(world_);
     }
 
+    /** Enable or disable coalesced merging of commands.
+     *
+     * @see ecs_set_coalesced_merge()
+     */
+    void set_coalesced_merge(bool enable = true) const {
+        ecs_set_coalesced_merge(world_, enable);
+    }
+
+    /** Test whether coalesced merging of commands is enabled.
+     *
+     * @see ecs_using_coalesced_merge()
+     */
+    bool using_coalesced_merge() const {
+        return ecs_using_coalesced_merge(world_);
+    }
+
+private:
+    /* Async operations can be called from threads that don't own a stage, 
+     * which must not register components. Get the component id without 
+     * registering it, and assert that it was registered beforehand. */
+    template <typename T>
+    flecs::entity_t async_id() const {
+        ecs_assert(_::type<T>::registered(world_), ECS_INVALID_OPERATION,
+            "component '%s' must be registered before it is used with async "
+            "operations", _::type_name<T>());
+#ifdef FLECS_MULTI_WORLD
+        return flecs_component_ids_get(world_, _::type<T>::index());
+#else
+        return _::type<T>::s_id;
+#endif
+    }
+
+public:
+    /** Add an id to an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_add_id()
+     */
+    void async_add(flecs::entity_t e, flecs::id_t id) const {
+        ecs_async_add_id(world_, e, id);
+    }
+
+    /** Add a component to an entity from a thread that doesn't own a stage.
+     * The component must be registered before this function is called, as
+     * components can't be registered from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_add_id()
+     */
+    template <typename T>
+    void async_add(flecs::entity_t e) const {
+        ecs_async_add_id(world_, e, async_id<T>());
+    }
+
+    /** Remove an id from an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_remove_id()
+     */
+    void async_remove(flecs::entity_t e, flecs::id_t id) const {
+        ecs_async_remove_id(world_, e, id);
+    }
+
+    /** Remove a component from an entity from a thread that doesn't own a 
+     * stage. The component must be registered before this function is called.
+     *
+     * @see ecs_async_remove_id()
+     */
+    template <typename T>
+    void async_remove(flecs::entity_t e) const {
+        ecs_async_remove_id(world_, e, async_id<T>());
+    }
+
+    /** Set a component from a thread that doesn't own a stage.
+     * The component must be registered before this function is called.
+     *
+     * @see ecs_async_set_id()
+     */
+    template <typename T>
+    void async_set(flecs::entity_t e, const T& value) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "async_set requires a trivially copyable component");
+        ecs_async_set_id(world_, e, async_id<T>(), sizeof(T), &value);
+    }
+
+    /** Delete an entity from a thread that doesn't own a stage.
+     *
+     * @see ecs_async_delete()
+     */
+    void async_delete(flecs::entity_t e) const {
+        ecs_async_delete(world_, e);
+    }
+
     /** Configure world to have N stages.
      * This initializes N stages, which allows applications to defer operations to
      * multiple isolated defer queues. This is typically used for applications with
@@ -1305,6 +1411,56 @@ struct world {
         ecs_shrink(world_);
     }
 
+    /** Enable incremental table compaction.
+     * 
+     * @see ecs_set_table_compaction()
+     */
+    void set_table_compaction(
+        const ecs_delete_empty_tables_desc_t& desc) const 
+    {
+        ecs_set_table_compaction(world_, &desc);
+    }
+
+    /** Disable incremental table compaction.
+     * 
+     * @see ecs_set_table_compaction()
+     */
+    void reset_table_compaction() const {
+        ecs_set_table_compaction(world_, nullptr);
+    }
+
+    /** Set page size for table column storage.
+     * 
+     * @see ecs_set_column_page_size()
+     */
+    void set_column_page_size(ecs_size_t page_size) const {
+        ecs_set_column_page_size(world_, page_size);
+    }
+
+    /** Get page size for table column storage.
+     * 
+     * @see ecs_get_column_page_size()
+     */
+    ecs_size_t get_column_page_size() const {
+        return ecs_get_column_page_size(world_);
+    }
+
+    /** Set minimum alignment for table column storage.
+     * 
+     * @see ecs_set_column_alignment()
+     */
+    void set_column_alignment(ecs_size_t alignment) const {
+        ecs_set_column_alignment(world_, alignment);
+    }
+
+    /** Get minimum alignment for table column storage.
+     * 
+     * @see ecs_get_column_alignment()
+     */
+    ecs_size_t get_column_alignment() const {
+        return ecs_get_column_alignment(world_);
+    }
+
     /** Begin exclusive access.
      *
      * @param thread_name Optional thread name for improved debug messages.
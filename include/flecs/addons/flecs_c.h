@@ -431,6 +431,25 @@
 
 /** @} */
 
+/**
+ * @defgroup flecs_c_async Async commands
+ * @{
+ */
+
+/** Add a component from a thread that doesn't own a stage. */
+#define ecs_async_add(world, entity, T)\
+    ecs_async_add_id(world, entity, ecs_id(T))
+
+/** Remove a component from a thread that doesn't own a stage. */
+#define ecs_async_remove(world, entity, T)\
+    ecs_async_remove_id(world, entity, ecs_id(T))
+
+/** Set a component value from a thread that doesn't own a stage. */
+#define ecs_async_set(world, entity, component, ...)\
+    ecs_async_set_id(world, entity, ecs_id(component), sizeof(component), &(component)__VA_ARGS__)
+
+/** @} */
+
 /**
  * @defgroup flecs_c_singletons Singletons
  * @{
@@ -688,6 +707,10 @@
 #define ecs_field_at(it, T, index, row)\
     (ECS_CAST(T*, ecs_field_at_w_size(it, sizeof(T), index, row)))
 
+/** Get member array of a field with struct-of-arrays storage. */
+#define ecs_field_member(it, T, index, member)\
+    (ECS_CAST(T*, ecs_field_member_w_size(it, sizeof(T), index, member)))
+
 /** @} */
 
 /**
@@ -126,6 +126,7 @@ FLECS_API extern const ecs_entity_t ecs_id(EcsOpaque);          /**< ID for comp
 FLECS_API extern const ecs_entity_t ecs_id(EcsUnit);            /**< ID for component that stores unit data. */
 FLECS_API extern const ecs_entity_t ecs_id(EcsUnitPrefix);      /**< ID for component that stores unit prefix data. */
 FLECS_API extern const ecs_entity_t EcsQuantity;                /**< Tag added to unit quantities. */
+FLECS_API extern const ecs_entity_t EcsSoA;                     /**< Trait that stores struct members in separate arrays. */
 
 /* Primitive type component IDs */
 
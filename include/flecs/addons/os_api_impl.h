@@ -27,6 +27,52 @@ extern "C" {
 FLECS_API
 void ecs_set_os_api_impl(void);
 
+/** Set the maximum number of idle threads in the task pool.
+ * The POSIX OS API implementation runs tasks created with ecs_os_task_new(),
+ * which includes the tasks created by ecs_set_task_threads(), on a pool of 
+ * threads. When a thread finishes a task while the pool already has the 
+ * maximum number of idle threads, the thread exits. Threads that are kept can
+ * run the tasks of the next frame without creating a new thread.
+ *
+ * The default is 0, which means that every task runs on a new thread. Busy 
+ * threads are not limited, as tasks (like pipeline workers) can block until 
+ * other tasks are running.
+ *
+ * The task pool is not available on Windows, where this operation has no 
+ * effect.
+ *
+ * @param count The maximum number of idle threads.
+ */
+FLECS_API
+void ecs_os_set_task_pool_max_idle(
+    int32_t count);
+
+/** Submit a task to the task pool.
+ * This operation submits an application task to the pool that runs the tasks
+ * created with ecs_os_task_new(). Unlike tasks created with ecs_os_task_new(),
+ * the task does not need to be joined. Tasks that are still queued or running
+ * when the OS API is deinitialized are finished before the pool stops.
+ *
+ * On Windows the task runs on a new thread.
+ *
+ * @param callback The function to run.
+ * @param param The parameter passed to the function.
+ */
+FLECS_API
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param);
+
+/** Get the number of threads in the task pool.
+ * The pool adds a thread when a task is created while all threads are busy.
+ * Idle threads up to the count set with ecs_os_set_task_pool_max_idle() are 
+ * kept until the OS API is deinitialized. Always returns 0 on Windows.
+ *
+ * @return The number of threads in the task pool.
+ */
+FLECS_API
+int32_t ecs_os_task_pool_count(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -261,6 +261,328 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Number of buckets in the wait time histogram of a sync point. Bucket 0
+ * counts waits shorter than a microsecond, bucket N counts waits shorter than
+ * 2^N microseconds. The last bucket counts all longer waits. */
+#ifndef FLECS_SYNC_WAIT_BUCKETS
+#define FLECS_SYNC_WAIT_BUCKETS (16)
+#endif
+
+/** Worker statistics, obtained with ecs_worker_stats_get(). */
+typedef struct ecs_worker_stats_t {
+    int64_t chunks;                /**< Number of chunks processed by worker. */
+    int64_t steals;                /**< Number of chunks stolen from other workers. */
+    int64_t idle;                  /**< Number of times worker ran out of work. */
+    int64_t spins;                 /**< Number of waits that ended while spinning. */
+    int64_t parks;                 /**< Number of waits that blocked on a condition variable. */
+    bool pinned;                   /**< Whether worker thread is pinned to a core. */
+} ecs_worker_stats_t;
+
+/** Enable or disable work stealing.
+ * By default the entities matched by a multithreaded system are divided evenly
+ * across workers, by giving each worker an equal slice of each table. When
+ * tables are small or when the cost of processing entities is uneven, this can
+ * cause workers to sit idle at the next sync point while one worker finishes.
+ *
+ * When work stealing is enabled, the results of a multithreaded system are
+ * split up into chunks. Each worker starts with an equal range of chunks, and
+ * workers that finish their range steal chunks from workers that haven't.
+ * Which entities are processed by which worker is not deterministic when work
+ * stealing is enabled.
+ *
+ * The operation may be called multiple times, but never while running a system
+ * or pipeline.
+ *
+ * @param world The world.
+ * @param enable Whether to enable work stealing.
+ */
+FLECS_API
+void ecs_set_work_stealing(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if work stealing is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using work stealing.
+ */
+FLECS_API
+bool ecs_using_work_stealing(
+    const ecs_world_t *world);
+
+/** Enable or disable dependency graph scheduling.
+ * By default each multithreaded system is divided across all workers, and
+ * workers run the systems in a pipeline op one after another. For pipelines
+ * with many small systems, the cost of dividing a system across workers can
+ * exceed the cost of running the system.
+ *
+ * When dependency graph scheduling is enabled, the multithreaded systems in a
+ * pipeline op are each run on a single worker. Systems that don't have
+ * conflicting component access, as declared by the inout kind of their terms,
+ * can run at the same time on different workers. A system that writes a
+ * component only runs after the earlier systems that read or write the same
+ * component have finished, and vice versa. Pipeline ops that contain a single
+ * system are still divided across workers.
+ *
+ * Systems without terms are assumed to access all components. The operation
+ * may be called multiple times, but never while running a system or pipeline.
+ *
+ * @param world The world.
+ * @param enable Whether to enable dependency graph scheduling.
+ */
+FLECS_API
+void ecs_set_dag_scheduling(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if dependency graph scheduling is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using dependency graph scheduling.
+ */
+FLECS_API
+bool ecs_using_dag_scheduling(
+    const ecs_world_t *world);
+
+/** Enable or disable parallel merging of command queues.
+ * When enabled, commands enqueued by multithreaded systems that assign a 
+ * component the entity already has are applied by the worker threads before
+ * the remaining commands are merged on the main thread. Entities are 
+ * distributed across workers, and an entity is only merged in parallel if all
+ * of its commands are in the same queue and don't add or remove components.
+ * If any entity has commands in more than one queue, or if any of the queues
+ * deletes or clears an entity, all queues are merged on the main thread.
+ *
+ * All other commands, as well as the OnSet observers for parallel merged 
+ * commands, are still executed on the main thread in the order in which they
+ * were enqueued. Note that this means that component values of parallel 
+ * merged entities are already assigned when the first observer of the merge 
+ * is invoked.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable parallel merging.
+ */
+FLECS_API
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if parallel merging of command queues is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using parallel merging.
+ */
+FLECS_API
+bool ecs_using_parallel_merge(
+    const ecs_world_t *world);
+
+/** Enable or disable pipelined frame execution.
+ * When enabled, the ops at the end of the pipeline that only contain systems 
+ * created with ecs_system_desc_t::pipelined don't run at the end of the frame.
+ * Instead, the data for these systems is copied at the end of the frame, and
+ * the systems are run on the copied data by the worker threads while the first 
+ * op of the next frame runs. This lets read-only systems at the end of a frame,
+ * like render extraction or network snapshotting, overlap with the systems at
+ * the start of the next frame, and removes a sync point from the frame.
+ *
+ * Pipelined systems can only read components that are double buffered with
+ * ecs_set_double_buffered(), or use fields that have no data. Commands 
+ * enqueued by pipelined systems are merged at the end of the first op of the
+ * next frame. Entities that are deleted after the data was copied are skipped
+ * when the systems run. Disabling pipelined frame execution runs the pending 
+ * systems of all pipelines.
+ *
+ * @param world The world.
+ * @param enable Whether to enable or disable pipelined frame execution.
+ */
+FLECS_API
+void ecs_set_pipelined_frames(
+    ecs_world_t *world,
+    bool enable);
+
+/** Return true if pipelined frame execution is enabled.
+ *
+ * @param world The world.
+ * @return Whether the world is using pipelined frame execution.
+ */
+FLECS_API
+bool ecs_using_pipelined_frames(
+    const ecs_world_t *world);
+
+/** Enable or disable double buffering for a component.
+ * The values of a double buffered component are copied at the end of a frame
+ * for the pipelined systems that read the component, so that these systems can
+ * run while the next frame modifies the component. 
+ * See ecs_set_pipelined_frames().
+ *
+ * @param world The world.
+ * @param component The component.
+ * @param enable Whether to enable or disable double buffering.
+ */
+FLECS_API
+void ecs_set_double_buffered(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    bool enable);
+
+/** Return true if a component is double buffered.
+ *
+ * @param world The world.
+ * @param component The component.
+ * @return Whether the component is double buffered.
+ */
+FLECS_API
+bool ecs_is_double_buffered(
+    const ecs_world_t *world,
+    ecs_entity_t component);
+
+/** Set number of spin iterations for worker synchronization.
+ * At each sync point the main thread waits for the workers to finish, after
+ * which workers wait for the main thread to signal that they can continue.
+ * By default threads immediately block on a condition variable, which can add
+ * significant wakeup latency when a frame has many sync points.
+ *
+ * When the spin count is larger than 0, threads first poll the sync state for
+ * up to the specified number of iterations before blocking. This reduces the
+ * latency of sync points at the cost of CPU time spent spinning.
+ *
+ * The operation may be called multiple times, but never while running a 
+ * system or pipeline.
+ *
+ * @param world The world.
+ * @param spin_count The number of iterations to spin before blocking.
+ */
+FLECS_API
+void ecs_set_worker_spin_count(
+    ecs_world_t *world,
+    int32_t spin_count);
+
+/** Get number of spin iterations for worker synchronization.
+ *
+ * @param world The world.
+ * @return The number of iterations threads spin before blocking.
+ */
+FLECS_API
+int32_t ecs_get_worker_spin_count(
+    const ecs_world_t *world);
+
+/** Set minimum estimated time per thread for multithreaded sync points.
+ * By default a multithreaded sync point runs on all threads. Waking up threads
+ * costs more than it saves for sync points with little work, such as systems
+ * that match a few entities.
+ *
+ * When the minimum cost is larger than 0, the pipeline measures the time per
+ * matched entity of each multithreaded system, and uses it to estimate the time
+ * of a sync point from the number of entities its systems match. The sync 
+ * point then runs on as many threads as the estimated time allows, so that
+ * each thread gets at least the minimum cost. If a sync point would run on a
+ * single thread, it runs on the main thread without waking up the workers.
+ *
+ * The number of threads that ran a sync point is available in the 
+ * worker_count member of ecs_sync_stats_t.
+ *
+ * @param world The world.
+ * @param min_cost The minimum estimated time per thread in seconds, or 0 to 
+ *                 always use all threads.
+ */
+FLECS_API
+void ecs_set_worker_min_cost(
+    ecs_world_t *world,
+    ecs_ftime_t min_cost);
+
+/** Get minimum estimated time per thread for multithreaded sync points.
+ *
+ * @param world The world.
+ * @return The minimum estimated time per thread in seconds.
+ */
+FLECS_API
+ecs_ftime_t ecs_get_worker_min_cost(
+    const ecs_world_t *world);
+
+/** Set weight of the last measurement in the estimated cost of a system.
+ * The estimated time per entity of a system is a moving average of the 
+ * measured time per entity, where each new measurement is weighted with the
+ * provided value. A higher weight adapts faster to changes in the cost of a 
+ * system, a lower weight is less sensitive to frames that were slow for 
+ * unrelated reasons. The default is FLECS_WORKER_COST_WEIGHT (0.25), which
+ * can be overridden at compile time.
+ *
+ * The weight is only used when a minimum cost is set with 
+ * ecs_set_worker_min_cost().
+ *
+ * @param world The world.
+ * @param weight The weight of the last measurement, larger than 0 and not 
+ *               larger than 1. A weight of 1 only uses the last measurement.
+ */
+FLECS_API
+void ecs_set_worker_cost_weight(
+    ecs_world_t *world,
+    ecs_ftime_t weight);
+
+/** Get weight of the last measurement in the estimated cost of a system.
+ *
+ * @param world The world.
+ * @return The weight of the last measurement.
+ */
+FLECS_API
+ecs_ftime_t ecs_get_worker_cost_weight(
+    const ecs_world_t *world);
+
+/** Pin worker threads to cores.
+ * By default the OS is free to move worker threads between cores. On machines
+ * with multiple NUMA nodes this can cause workers to access memory that is 
+ * owned by a different node. When worker affinity is set, each worker thread
+ * pins itself to the specified core before it first uses its stage, so that
+ * the memory allocated by the stage is placed on the node of that core.
+ *
+ * Element i of the cpus array contains the core for worker i. Element 0 
+ * corresponds with the main thread, which is not pinned. Workers for which 
+ * the array contains -1, or that are not in the array, are not pinned. If
+ * threads are running, they are pinned (or unpinned) in place. Memory that 
+ * their stages already allocated is not moved to the node of the new core.
+ * Affinity is not applied to task threads, and requires an OS API with a 
+ * thread_set_affinity_ callback.
+ *
+ * When affinity is set, ecs_worker_iter() assigns tables with fewer entities 
+ * than workers to a single worker based on the table id, so that tables are
+ * processed by the same core in each frame.
+ *
+ * @param world The world.
+ * @param cpus Array with core per worker.
+ * @param count Number of elements in the cpus array, or 0 to reset affinity.
+ */
+FLECS_API
+void ecs_set_worker_affinity(
+    ecs_world_t *world,
+    const int32_t *cpus,
+    int32_t count);
+
+/** Get the core a worker thread is pinned to.
+ *
+ * @param world The world.
+ * @param worker The worker index.
+ * @return The core, or -1 if the worker is not pinned.
+ */
+FLECS_API
+int32_t ecs_get_worker_affinity(
+    const ecs_world_t *world,
+    int32_t worker);
+
+/** Get statistics for a worker.
+ * Chunk statistics are collected while work stealing is enabled. Statistics
+ * are reset when the number of threads changes. The main thread is worker 0.
+ *
+ * @param world The world.
+ * @param worker The worker index.
+ * @param stats Out parameter for statistics.
+ * @return true if success, false if the worker does not exist.
+ */
+FLECS_API
+bool ecs_worker_stats_get(
+    const ecs_world_t *world,
+    int32_t worker,
+    ecs_worker_stats_t *stats);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -184,6 +184,10 @@ typedef struct ecs_query_stats_t {
 typedef struct ecs_system_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent processing a system. */
+    ecs_metric_t commands_enqueued; /**< Number of commands merged for system. */
+    ecs_metric_t commands_discarded; /**< Number of discarded commands. */
+    ecs_metric_t commands_coalesced; /**< Number of commands merged in a batch. */
+    ecs_metric_t command_time;     /**< Time spent merging commands of system. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     bool task;                     /**< Whether the system is a task. */
@@ -196,11 +200,17 @@ typedef struct ecs_sync_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent in sync point. */
     ecs_metric_t commands_enqueued; /**< Number of commands enqueued. */
+    ecs_metric_t wait_time;        /**< Time spent waiting for workers. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     int32_t system_count;          /**< Number of systems before sync point. */
+    int32_t worker_count;          /**< Number of threads that ran the sync point. */
     bool multi_threaded;           /**< Whether the sync point is multi-threaded. */
     bool immediate;                /**< Whether the sync point is immediate. */
+
+    /** Cumulative histogram of time spent waiting for workers since the last
+     * pipeline rebuild. See FLECS_SYNC_WAIT_BUCKETS. */
+    int64_t wait_histogram[FLECS_SYNC_WAIT_BUCKETS];
 } ecs_sync_stats_t;
 
 /** Statistics for all systems in a pipeline. */
@@ -220,6 +230,7 @@ typedef struct ecs_pipeline_stats_t {
     int32_t system_count;        /**< Number of systems in pipeline. */
     int32_t active_system_count; /**< Number of active systems in pipeline. */
     int32_t rebuild_count;       /**< Number of times pipeline has rebuilt. */
+    int32_t patch_count;         /**< Number of times pipeline schedule was patched. */
 } ecs_pipeline_stats_t;
 
 /** Get world statistics.
@@ -522,6 +533,7 @@ typedef struct {
     ecs_size_t bytes_table_components_unused; /**< Unused bytes in table columns. */
     ecs_size_t bytes_toggle_bitsets;    /**< Bytes used in bitsets (toggled components). */
     ecs_size_t bytes_sparse_components; /**< Bytes used in component sparse sets. */
+    ecs_size_t bytes_cold_components;   /**< Bytes used by table columns of cold components (included in bytes_table_components). */
 } ecs_component_memory_t;
 
 /** Component index memory. */
@@ -565,6 +577,8 @@ typedef struct {
     ecs_size_t bytes_component_map;     /**< Bytes used by component map. */
     ecs_size_t bytes_dirty_state;       /**< Bytes used by dirty state. */
     ecs_size_t bytes_edges;             /**< Bytes used by table graph edges. */
+    int32_t reclaimed_count;            /**< Tables deleted or trimmed by ecs_delete_empty_tables(). */
+    int64_t reclaimed_bytes;            /**< Estimated bytes returned to the OS allocator by ecs_delete_empty_tables(). */
 } ecs_table_memory_t;
 
 /** Table size histogram. */
@@ -99,6 +99,16 @@ typedef struct ecs_system_desc_t {
     /** If true, the system will have access to the actual world. Cannot be true at the
      * same time as multi_threaded. */
     bool immediate;
+
+    /** If true, the system can run while the first op of the next frame runs
+     * when pipelined frame execution is enabled. See 
+     * ecs_set_pipelined_frames(). */
+    bool pipelined;
+
+    /** Policy for dividing entities across threads when the system is 
+     * multithreaded. When left to 0, the entities of each result are divided
+     * equally across threads. See ecs_worker_iter_w_chunking(). */
+    ecs_worker_chunking_t chunking;
 } ecs_system_desc_t;
 
 /** Create a system.
@@ -163,6 +173,12 @@ typedef struct ecs_system_t {
     /** Whether the system is run in immediate mode. */
     bool immediate;
 
+    /** Whether the system can overlap with the next frame. */
+    bool pipelined;
+
+    /** Policy for dividing entities across threads. */
+    ecs_worker_chunking_t chunking;
+
     /** Cached system name (for perf tracing). */
     const char *name;
 
@@ -187,6 +203,30 @@ typedef struct ecs_system_t {
     /** Time spent on running the system. */
     ecs_ftime_t time_spent;
 
+    /** Estimated time spent per matched entity. Used to select the number of
+     * threads for a sync point. See ecs_set_worker_min_cost(). */
+    ecs_ftime_t cost_per_entity;
+
+    /** Estimated number of entities matched by the system when it last ran.
+     * For systems with a cached query this is the number of entities in the
+     * matched tables, which doesn't require evaluating the query. */
+    int32_t matched_count;
+
+    /** Number of commands enqueued by the system that were merged. Only 
+     * updated when system time is measured. */
+    int64_t commands_enqueued;
+
+    /** Number of commands enqueued by the system that were discarded, for
+     * example because the entity or component no longer existed. */
+    int64_t commands_discarded;
+
+    /** Number of commands enqueued by the system that were merged as part of
+     * a batch of commands. */
+    int64_t commands_coalesced;
+
+    /** Time spent on merging commands enqueued by the system. */
+    ecs_ftime_t command_time;
+
     /** Time passed since the last invocation. */
     ecs_ftime_t time_passed;
 
@@ -97,6 +97,20 @@ void flecs_bitset_remove(
     ecs_bitset_t *bs,
     int32_t elem);
 
+/** Remove a range from a bitset.
+ * Unlike flecs_bitset_remove(), this preserves the order of the remaining
+ * elements.
+ *
+ * @param bs The bitset to remove from.
+ * @param elem Index of the first bit to remove.
+ * @param count Number of bits to remove.
+ */
+FLECS_DBG_API
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count);
+
 /** Swap values in a bitset.
  *
  * @param bs The bitset.
@@ -97,6 +97,26 @@ typedef
 void* (*ecs_os_api_calloc_t)(
     ecs_size_t size);
 
+/** OS API reserve function type.
+ * Reserves a range of virtual address space without backing it with memory. */
+typedef
+void* (*ecs_os_api_reserve_t)(
+    ecs_size_t size);
+
+/** OS API commit function type.
+ * Backs (part of) a reserved range with memory. Returns false on failure. */
+typedef
+bool (*ecs_os_api_commit_t)(
+    void *ptr,
+    ecs_size_t size);
+
+/** OS API release function type.
+ * Used to decommit part of a reserved range, or to release the entire range. */
+typedef
+void (*ecs_os_api_release_t)(
+    void *ptr,
+    ecs_size_t size);
+
 /** OS API strdup function type. */
 typedef
 char* (*ecs_os_api_strdup_t)(
@@ -122,6 +142,14 @@ void* (*ecs_os_api_thread_join_t)(
 typedef
 ecs_os_thread_id_t (*ecs_os_api_thread_self_t)(void);
 
+/** OS API thread_set_affinity function type.
+ * Pins a thread to a core. If thread is 0 the calling thread is pinned. If cpu
+ * is -1 the thread is allowed to run on any core. */
+typedef
+bool (*ecs_os_api_thread_set_affinity_t)(
+    ecs_os_thread_t thread,
+    int32_t cpu);
+
 /** OS API task_new function type. */
 typedef
 ecs_os_thread_t (*ecs_os_api_task_new_t)(
@@ -144,6 +172,22 @@ typedef
 int64_t (*ecs_os_api_lainc_t)(
     int64_t *value);
 
+/** OS API aload function type. */
+typedef
+int32_t (*ecs_os_api_aload_t)(
+    const int32_t *value);
+
+/** OS API aloadp function type. */
+typedef
+void* (*ecs_os_api_aloadp_t)(
+    void *const *value);
+
+/** OS API astorep function type. */
+typedef
+void (*ecs_os_api_astorep_t)(
+    void **ptr,
+    void *value);
+
 /** Mutex. */
 /** OS API mutex_new function type. */
 typedef
@@ -297,6 +341,12 @@ typedef struct ecs_os_api_t {
     ecs_os_api_calloc_t calloc_;                   /**< calloc callback. */
     ecs_os_api_free_t free_;                       /**< free callback. */
 
+    /* Virtual memory */
+    ecs_os_api_reserve_t reserve_;                 /**< reserve callback. */
+    ecs_os_api_commit_t commit_;                   /**< commit callback. */
+    ecs_os_api_release_t decommit_;                /**< decommit callback. */
+    ecs_os_api_release_t release_;                 /**< release callback. */
+
     /* Strings */
     ecs_os_api_strdup_t strdup_;                   /**< strdup callback. */
 
@@ -304,16 +354,20 @@ typedef struct ecs_os_api_t {
     ecs_os_api_thread_new_t thread_new_;           /**< thread_new callback. */
     ecs_os_api_thread_join_t thread_join_;         /**< thread_join callback. */
     ecs_os_api_thread_self_t thread_self_;         /**< thread_self callback. */
+    ecs_os_api_thread_set_affinity_t thread_set_affinity_; /**< thread_set_affinity callback. */
 
     /* Tasks */
     ecs_os_api_thread_new_t task_new_;             /**< task_new callback. */
     ecs_os_api_thread_join_t task_join_;           /**< task_join callback. */
 
-    /* Atomic increment and decrement */
+    /* Atomic increment, decrement, load and store */
     ecs_os_api_ainc_t ainc_;                       /**< ainc callback. */
     ecs_os_api_ainc_t adec_;                       /**< adec callback. */
     ecs_os_api_lainc_t lainc_;                     /**< lainc callback. */
     ecs_os_api_lainc_t ladec_;                     /**< ladec callback. */
+    ecs_os_api_aload_t aload_;                     /**< aload callback. */
+    ecs_os_api_aloadp_t aloadp_;                   /**< aloadp callback. */
+    ecs_os_api_astorep_t astorep_;                 /**< astorep callback. */
 
     /* Mutex */
     ecs_os_api_mutex_new_t mutex_new_;             /**< mutex_new callback. */
@@ -446,6 +500,18 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#ifndef ecs_os_reserve
+#define ecs_os_reserve(size) ecs_os_api.reserve_(size)
+#endif
+#ifndef ecs_os_commit
+#define ecs_os_commit(ptr, size) ecs_os_api.commit_(ptr, size)
+#endif
+#ifndef ecs_os_decommit
+#define ecs_os_decommit(ptr, size) ecs_os_api.decommit_(ptr, size)
+#endif
+#ifndef ecs_os_release
+#define ecs_os_release(ptr, size) ecs_os_api.release_(ptr, size)
+#endif
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -524,6 +590,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_thread_new(callback, param) ecs_os_api.thread_new_(callback, param)
 #define ecs_os_thread_join(thread) ecs_os_api.thread_join_(thread)
 #define ecs_os_thread_self() ecs_os_api.thread_self_()
+#define ecs_os_thread_set_affinity(thread, cpu) ecs_os_api.thread_set_affinity_(thread, cpu)
 
 /* Tasks */
 #define ecs_os_task_new(callback, param) ecs_os_api.task_new_(callback, param)
@@ -534,6 +601,9 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_adec(value) ecs_os_api.adec_(value)
 #define ecs_os_lainc(value) ecs_os_api.lainc_(value)
 #define ecs_os_ladec(value) ecs_os_api.ladec_(value)
+#define ecs_os_aload(value) ecs_os_api.aload_(value)
+#define ecs_os_aloadp(value) ecs_os_api.aloadp_((void *const*)(value))
+#define ecs_os_astorep(ptr, value) ecs_os_api.astorep_((void**)(ptr), value)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new_()
@@ -775,6 +845,10 @@ void* ecs_os_memdup(
 FLECS_API
 bool ecs_os_has_heap(void);
 
+/** Are virtual memory functions available? */
+FLECS_API
+bool ecs_os_has_virtual_memory(void);
+
 /** Are threading functions available? */
 FLECS_API
 bool ecs_os_has_threading(void);
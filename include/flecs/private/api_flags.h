@@ -24,6 +24,12 @@ extern "C" {
 #define EcsWorldMeasureSystemTime     (1u << 6)
 #define EcsWorldMultiThreaded         (1u << 7)
 #define EcsWorldFrameInProgress       (1u << 8)
+#define EcsWorldWorkStealing          (1u << 9)
+#define EcsWorldDagScheduling         (1u << 10)
+#define EcsWorldParallelMerge         (1u << 11)
+#define EcsWorldWorkerAffinity        (1u << 12)
+#define EcsWorldPipelinedFrames       (1u << 13)
+#define EcsWorldCoalesceCommands      (1u << 14)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// OS API flags
@@ -93,6 +99,8 @@ extern "C" {
         EcsIdHasOnTableCreate|EcsIdHasOnTableDelete|EcsIdSparse|\
         EcsIdOrderedChildren|EcsIdHasUpNotify)
 #define EcsIdPrefabChildren            (1u << 26)
+#define EcsIdCold                      (1u << 27)
+#define EcsIdStableOrder               (1u << 28)
 
 #define EcsIdMarkedForDelete           (1u << 30)
 
@@ -121,6 +129,7 @@ extern "C" {
 #define EcsNonTrivialIdSparse          (1u << 0)
 #define EcsNonTrivialIdNonFragmenting  (1u << 1)
 #define EcsNonTrivialIdInherit         (1u << 2)
+#define EcsNonTrivialIdSoA             (1u << 3)
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -100,6 +100,12 @@ typedef struct ecs_page_iter_t {
 typedef struct ecs_worker_iter_t {
     int32_t index;
     int32_t count;
+    void *tasks;        /* Tasks shared between workers (work stealing) */
+    int32_t result;     /* Current result of chained iterator (work stealing) */
+    int32_t victim;     /* Worker to claim chunks from (work stealing) */
+    int32_t min_count;  /* Minimum number of entities per chunk (chunking) */
+    int32_t chunk_size; /* Maximum number of entities per chunk (chunking) */
+    int32_t chunk;      /* Next chunk in current result, -1 if none (chunking) */
 } ecs_worker_iter_t;
 
 /* Inlined element stored in a table cache. */
@@ -185,7 +191,9 @@ typedef struct ecs_iter_private_t {
 
 /* Data structures that store the command queue. */
 typedef struct ecs_commands_t {
-    ecs_vec_t queue;
+    ecs_vec_t queue;            /* Stream of variable length commands. */
+    int32_t count;              /* Number of commands in queue. */
+    uint32_t epoch;             /* Incremented after each flush. */
     ecs_stack_t stack;          /* Temp memory used by deferred commands. */
     ecs_sparse_t entries;       /* <entity, op_entry_t> - command batching. */
 } ecs_commands_t;
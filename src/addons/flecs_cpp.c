@@ -585,6 +585,14 @@ ecs_cpp_get_mut_t ecs_cpp_set(
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t dst = flecs_ensure(world, entity, id, r, 
         flecs_uto(int32_t, size));
+
+    if (!dst.ptr) {
+        /* Struct-of-arrays components can't be assigned in place, scatter the
+         * value to the member arrays instead. */
+        flecs_defer_end(world, stage);
+        ecs_set_id(world, entity, id, size, new_ptr);
+        return (ecs_cpp_get_mut_t){0};
+    }
     
     result.ptr = dst.ptr;
     result.world = world;
@@ -637,6 +645,14 @@ ecs_cpp_get_mut_t ecs_cpp_assign(
     flecs_component_ptr_t dst = flecs_get_mut(world, entity, id, r, 
         flecs_uto(int32_t, size));
 
+    if (!dst.ptr && dst.ti && dst.ti->soa) {
+        /* Struct-of-arrays components can't be assigned in place, scatter the
+         * value to the member arrays instead. */
+        flecs_defer_end(world, stage);
+        ecs_set_id(world, entity, id, size, new_ptr);
+        return (ecs_cpp_get_mut_t){0};
+    }
+
     ecs_assert(dst.ptr != NULL, ECS_INVALID_OPERATION, 
         "entity does not have component, use set() instead");
         
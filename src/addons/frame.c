@@ -139,6 +139,9 @@ ecs_ftime_t ecs_frame_begin(
     world->on_commands_ctx_active = world->on_commands_ctx;
     world->on_commands_ctx = NULL;
 
+    /* Merge commands enqueued by threads that don't own a stage */
+    flecs_async_merge(world);
+
     ecs_run_aperiodic(world, 0);
 
     world->flags |= EcsWorldFrameInProgress;
@@ -164,6 +167,8 @@ void ecs_frame_end(
         flecs_stage_merge_post_frame(world, world->stages[i]);
     }
 
+    flecs_table_compaction_run(world);
+
     flecs_stop_measure_frame(world);
 
     /* Reset command handler each frame */
@@ -169,9 +169,21 @@ static int flecs_json_serialize_iter_result_field_values(
             continue;
         }
 
-        void *ptr;
+        void *ptr, *soa_value = NULL;
+        ecs_table_t *table;
+        int32_t row, column;
         if (row_fields & field_bit) {
             ptr = ecs_field_at_w_size(it, flecs_itosize(it->sizes[f]), f, i);
+        } else if (!it->ptrs && 
+            (column = flecs_field_column(it, f, &table, &row)) >= 0 &&
+            (table->data.columns[column].flags & EcsColumnSoA))
+        {
+            /* Gather members of struct-of-arrays component into a value */
+            if (!it->sources[f]) {
+                row += i;
+            }
+            ptr = soa_value = ecs_os_malloc(it->sizes[f]);
+            flecs_table_soa_get(table, column, row, ptr);
         } else {
             ecs_size_t size = it->sizes[f];
             ptr = ecs_field_w_size(it, flecs_itosize(size), f);
@@ -187,7 +199,11 @@ static int flecs_json_serialize_iter_result_field_values(
         }
 
         flecs_json_next(buf);
-        if (flecs_json_ser_type(world, &value_ctx->ser->ops, ptr, buf) != 0) {
+        int ret = flecs_json_ser_type(world, &value_ctx->ser->ops, ptr, buf);
+        if (soa_value) {
+            ecs_os_free(soa_value);
+        }
+        if (ret != 0) {
             return -1;
         }
     }
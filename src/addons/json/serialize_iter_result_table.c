@@ -382,11 +382,18 @@ static int flecs_json_serialize_table_components(
         }
 
         const ecs_type_info_t *ti;
+        void *soa_value = NULL;
         int32_t column_index = table->column_map ? table->column_map[i] : -1;
         if (column_index != -1) {
             ecs_column_t *column = &table->data.columns[column_index];
             ti = column->ti;
-            ptr = ECS_ELEM(column->data, ti->size, row);
+            if (column->flags & EcsColumnSoA) {
+                /* Gather members of struct-of-arrays component into a value */
+                ptr = soa_value = ecs_os_malloc(ti->size);
+                flecs_table_soa_get(table, column_index, row, ptr);
+            } else {
+                ptr = ECS_ELEM(column->data, ti->size, row);
+            }
         } else {
             if (!(cr->flags & EcsIdSparse) || !cr->type_info) {
                 continue;
@@ -400,9 +407,12 @@ static int flecs_json_serialize_table_components(
             continue;
         }
 
-        if (flecs_json_serialize_component_value(world, id, ptr, ti, buf,
-            ser_ctx, values_ctx, desc, component_count))
-        {
+        int ret = flecs_json_serialize_component_value(world, id, ptr, ti, buf,
+            ser_ctx, values_ctx, desc, component_count);
+        if (soa_value) {
+            ecs_os_free(soa_value);
+        }
+        if (ret) {
             goto error;
         }
     }
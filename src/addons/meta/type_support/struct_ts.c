@@ -640,6 +640,100 @@ ecs_member_t* ecs_struct_get_nth_member(
     return &members[i];
 }
 
+/* Enable struct-of-arrays storage for a struct type. Members are stored in 
+ * separate arrays, which requires that the type doesn't need lifecycle or
+ * component hooks, has no observers and isn't used yet by any table. */
+static void flecs_struct_init_soa(
+    ecs_world_t *world,
+    ecs_entity_t type)
+{
+    char *path = NULL;
+    ecs_soa_member_t *soa_members = NULL;
+
+    const EcsStruct *s = ecs_get(world, type, EcsStruct);
+    ecs_check(s != NULL, ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': type is not a struct",
+            path = ecs_get_path(world, type));
+
+    ecs_type_info_t *ti = ECS_CONST_CAST(ecs_type_info_t*, 
+        ecs_get_type_info(world, type));
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (ti->soa) {
+        return;
+    }
+
+    ecs_check(flecs_type_hooks_allow_soa(&ti->hooks),
+            ECS_INVALID_OPERATION, 
+            "cannot add SoA trait to '%s': type has lifecycle hooks",
+                path = ecs_get_path(world, type));
+
+    ecs_component_record_t *cr = flecs_components_get(world, type);
+    ecs_check(!cr || !(cr->flags & (EcsIdSparse|EcsIdDontFragment)),
+        ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': component is sparse",
+            path = ecs_get_path(world, type));
+
+    ecs_check(!cr || !(cr->flags & 
+        (EcsIdHasOnAdd|EcsIdHasOnSet|EcsIdHasOnRemove)),
+        ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': component has observers",
+            path = ecs_get_path(world, type));
+    (void)cr;
+
+    ecs_check(!ecs_id_in_use(world, type) && 
+        !ecs_id_in_use(world, ecs_pair(type, EcsWildcard)) &&
+        !flecs_component_is_trait_locked(world, type),
+            ECS_INVALID_OPERATION,
+            "cannot add SoA trait to '%s': component is already in use",
+                path = ecs_get_path(world, type));
+
+    const ecs_member_t *members = ecs_vec_first_t(&s->members, ecs_member_t);
+    int32_t i, count = ecs_vec_count(&s->members);
+    ecs_check(count != 0, ECS_INVALID_OPERATION, 
+        "cannot add SoA trait to '%s': struct has no members",
+            path = ecs_get_path(world, type));
+
+    soa_members = ecs_os_malloc_n(ecs_soa_member_t, count);
+    ecs_size_t end = 0;
+    for (i = 0; i < count; i ++) {
+        const ecs_member_t *m = &members[i];
+        ecs_size_t size = m->size;
+        ecs_check(m->offset >= end && (m->offset + size) <= ti->size, 
+            ECS_INVALID_OPERATION,
+            "cannot add SoA trait to '%s': members overlap or are not "
+            "ordered by offset", path = ecs_get_path(world, type));
+        soa_members[i].offset = m->offset;
+        soa_members[i].size = size;
+        end = m->offset + size;
+    }
+    (void)end;
+
+    flecs_type_info_set_soa(ti, soa_members, count);
+    ecs_os_free(soa_members);
+
+    /* Make sure get/ensure/set don't take the fast path that assumes that 
+     * component values are stored contiguously. */
+    if (type < FLECS_HI_COMPONENT_ID) {
+        world->non_trivial_lookup[type] |= EcsNonTrivialIdSoA;
+        world->non_trivial_set[type] = true;
+    }
+
+    return;
+error:
+    ecs_os_free(soa_members);
+    ecs_os_free(path);
+}
+
+static void flecs_add_soa(
+    ecs_iter_t *it)
+{
+    ecs_world_t *world = it->world;
+    int32_t i, count = it->count;
+    for (i = 0; i < count; i ++) {
+        flecs_struct_init_soa(world, it->entities[i]);
+    }
+}
+
 void flecs_meta_struct_init(
     ecs_world_t *world)
 {
@@ -701,6 +795,20 @@ void flecs_meta_struct_init(
     });
 
     ecs_add_pair(world, ecs_id(EcsStruct), EcsWith, ecs_id(EcsComponent));
+
+    ecs_entity_t soa = ecs_entity(world, { .id = EcsSoA,
+        .name = "soa", .symbol = "EcsSoA" });
+#ifdef FLECS_CONSTRAINT_TRAITS
+    ecs_add_id(world, soa, EcsTrait);
+#endif
+
+    ecs_observer(world, {
+        .query.terms[0] = { .id = EcsSoA },
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_add_soa,
+        .global_observer = true
+    });
 }
 
 #endif
@@ -3,6 +3,10 @@
  * @brief Builtin implementation for OS API.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* For pthread_setaffinity_np */
+#endif
+
 #include "../../private_api.h"
 
 #ifdef FLECS_OS_API_IMPL
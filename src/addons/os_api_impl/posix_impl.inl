@@ -6,6 +6,15 @@
 #include "pthread.h"
 #include <dlfcn.h>
 
+#ifndef __EMSCRIPTEN__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach/mach_time.h>
 #elif defined(__EMSCRIPTEN__)
@@ -44,11 +53,235 @@ static void* posix_thread_join(
     return arg;
 }
 
+/* Tasks run on a pool of threads, so that creating and joining a task doesn't
+ * have to create and join a thread. A thread is added to the pool when a task 
+ * is created while all threads are busy, as tasks (like pipeline workers) can
+ * block until other tasks are running. When a thread finishes a task and the
+ * pool already has the maximum number of idle threads, the thread exits. The
+ * maximum is 0 by default, in which case each task runs on its own thread. */
+typedef struct posix_task_t {
+    ecs_os_thread_callback_t callback;
+    void *arg;
+    void *result;
+    bool done;
+    bool detached;
+    struct posix_task_t *next;
+} posix_task_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t task_cond;      /* Signaled when a task is queued */
+    pthread_cond_t done_cond;      /* Signaled when a task or thread is done */
+    posix_task_t *first;           /* Queue with tasks that haven't started */
+    posix_task_t *last;
+    int32_t queued_count;
+    int32_t idle_count;
+    int32_t max_idle_count;        /* Idle threads above this count exit */
+    int32_t thread_count;
+    bool quit;
+    ecs_os_api_fini_t prev_fini;   /* Fini callback of previous OS API */
+} posix_task_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .task_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER
+};
+
+static void* posix_task_pool_thread(
+    void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    for (;;) {
+        while (!posix_task_pool.first && !posix_task_pool.quit) {
+            if (posix_task_pool.idle_count >= posix_task_pool.max_idle_count) {
+                /* Don't keep more idle threads than allowed */
+                goto done;
+            }
+            posix_task_pool.idle_count ++;
+            pthread_cond_wait(&posix_task_pool.task_cond, &posix_task_pool.lock);
+            posix_task_pool.idle_count --;
+        }
+
+        /* Finish queued tasks before quitting */
+        posix_task_t *task = posix_task_pool.first;
+        if (!task) {
+            break;
+        }
+
+        posix_task_pool.first = task->next;
+        if (!posix_task_pool.first) {
+            posix_task_pool.last = NULL;
+        }
+        posix_task_pool.queued_count --;
+        pthread_mutex_unlock(&posix_task_pool.lock);
+
+        void *result = task->callback(task->arg);
+
+        pthread_mutex_lock(&posix_task_pool.lock);
+        if (task->detached) {
+            ecs_os_free(task);
+        } else {
+            task->result = result;
+            task->done = true;
+            pthread_cond_broadcast(&posix_task_pool.done_cond);
+        }
+    }
+
+done:
+    posix_task_pool.thread_count --;
+    pthread_cond_broadcast(&posix_task_pool.done_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return NULL;
+}
+
+static posix_task_t* posix_task_push(
+    ecs_os_thread_callback_t callback, 
+    void *arg,
+    bool detached)
+{
+    posix_task_t *task = ecs_os_calloc_t(posix_task_t);
+    task->callback = callback;
+    task->arg = arg;
+    task->detached = detached;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    if (posix_task_pool.last) {
+        posix_task_pool.last->next = task;
+    } else {
+        posix_task_pool.first = task;
+    }
+    posix_task_pool.last = task;
+    posix_task_pool.queued_count ++;
+
+    if (posix_task_pool.idle_count >= posix_task_pool.queued_count) {
+        pthread_cond_signal(&posix_task_pool.task_cond);
+    } else {
+        /* Pool threads are detached, the pool waits for them to exit by 
+         * tracking the number of running threads. */
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, posix_task_pool_thread, NULL) != 0) {
+            ecs_os_abort();
+        }
+        pthread_attr_destroy(&attr);
+        posix_task_pool.thread_count ++;
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    return task;
+}
+
+static ecs_os_thread_t posix_task_new(
+    ecs_os_thread_callback_t callback, 
+    void *arg)
+{
+    return (ecs_os_thread_t)(uintptr_t)posix_task_push(callback, arg, false);
+}
+
+static void* posix_task_join(
+    ecs_os_thread_t thread)
+{
+    posix_task_t *task = (posix_task_t*)(uintptr_t)thread;
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    while (!task->done) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    void *result = task->result;
+    ecs_os_free(task);
+    return result;
+}
+
+/* Stop pool threads after all queued tasks are done */
+static void posix_task_pool_fini(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.quit = true;
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    while (posix_task_pool.thread_count) {
+        pthread_cond_wait(&posix_task_pool.done_cond, &posix_task_pool.lock);
+    }
+    posix_task_pool.quit = false;
+    ecs_os_api_fini_t prev_fini = posix_task_pool.prev_fini;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+
+    if (prev_fini) {
+        prev_fini();
+    }
+}
+
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    posix_task_push(callback, param, true);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    ecs_assert(count >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    pthread_mutex_lock(&posix_task_pool.lock);
+    posix_task_pool.max_idle_count = count;
+
+    /* Wake up idle threads so that threads above the new maximum exit */
+    pthread_cond_broadcast(&posix_task_pool.task_cond);
+    pthread_mutex_unlock(&posix_task_pool.lock);
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    pthread_mutex_lock(&posix_task_pool.lock);
+    int32_t result = posix_task_pool.thread_count;
+    pthread_mutex_unlock(&posix_task_pool.lock);
+    return result;
+}
+
 static ecs_os_thread_id_t posix_thread_self(void)
 {
     return (ecs_os_thread_id_t)pthread_self();
 }
 
+static bool posix_thread_set_affinity(
+    ecs_os_thread_t thread,
+    int32_t cpu)
+{
+#if defined(__linux__) && defined(CPU_SET)
+    if (cpu < -1 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    pthread_t thr = pthread_self();
+    if (thread) {
+        thr = *(pthread_t*)(uintptr_t)thread;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu == -1) {
+        /* Allow all cores. Cores that don't exist are ignored. */
+        int32_t i;
+        for (i = 0; i < CPU_SETSIZE; i ++) {
+            CPU_SET((size_t)i, &set);
+        }
+    } else {
+        CPU_SET((size_t)cpu, &set);
+    }
+
+    return pthread_setaffinity_np(thr, sizeof(set), &set) == 0;
+#else
+    /* Thread affinity is not supported on this platform */
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
 static int32_t posix_ainc(
     int32_t *count)
 {
@@ -125,6 +358,61 @@ static int64_t posix_ladec(
 #endif
 }
 
+static int32_t posix_aload(
+    const int32_t *count)
+{
+    int32_t value;
+#ifdef __GNUC__
+    value = __atomic_load_n(count, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *count;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void* posix_aloadp(
+    void *const *ptr)
+{
+    void *value;
+#ifdef __GNUC__
+    value = __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = *ptr;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
+static void posix_astorep(
+    void **ptr,
+    void *value)
+{
+#ifdef __GNUC__
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    *ptr = value;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+#endif
+}
+
 static ecs_os_mutex_t posix_mutex_new(void) {
     pthread_mutex_t *mutex = ecs_os_malloc(sizeof(pthread_mutex_t));
     if (pthread_mutex_init(mutex, NULL)) {
@@ -296,6 +584,66 @@ static void posix_dlclose(ecs_os_dl_t lib) {
     dlclose((void*)(uintptr_t)lib);
 }
 
+#ifndef __EMSCRIPTEN__
+static uintptr_t posix_vm_page_size(void) {
+    static uintptr_t page_size = 0;
+    if (!page_size) {
+        long result = sysconf(_SC_PAGESIZE);
+        page_size = result > 0 ? (uintptr_t)result : 4096;
+    }
+    return page_size;
+}
+
+static void* posix_reserve(
+    ecs_size_t size)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void *result = mmap(NULL, (size_t)size, PROT_NONE, flags, -1, 0);
+    if (result == MAP_FAILED) {
+        return NULL;
+    }
+    return result;
+}
+
+/* Commit rounds the range outwards to page boundaries, so that all bytes in the
+ * requested range are accessible. */
+static bool posix_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = (uintptr_t)ptr & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size + page_size - 1) & 
+        ~(page_size - 1);
+    return mprotect((void*)start, end - start, PROT_READ | PROT_WRITE) == 0;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void posix_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    uintptr_t page_size = posix_vm_page_size();
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        madvise((void*)start, end - start, MADV_DONTNEED);
+        mprotect((void*)start, end - start, PROT_NONE);
+    }
+}
+
+static void posix_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    munmap(ptr, (size_t)size);
+}
+#endif
+
 void ecs_set_os_api_impl(void) {
     ecs_os_set_api_defaults();
 
@@ -304,12 +652,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = posix_thread_new;
     api.thread_join_ = posix_thread_join;
     api.thread_self_ = posix_thread_self;
-    api.task_new_ = posix_thread_new;
-    api.task_join_ = posix_thread_join;
+    api.thread_set_affinity_ = posix_thread_set_affinity;
+    api.task_new_ = posix_task_new;
+    api.task_join_ = posix_task_join;
     api.ainc_ = posix_ainc;
     api.adec_ = posix_adec;
     api.lainc_ = posix_lainc;
     api.ladec_ = posix_ladec;
+    api.aload_ = posix_aload;
+    api.aloadp_ = posix_aloadp;
+    api.astorep_ = posix_astorep;
     api.mutex_new_ = posix_mutex_new;
     api.mutex_free_ = posix_mutex_free;
     api.mutex_lock_ = posix_mutex_lock;
@@ -324,6 +676,19 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = posix_dlopen;
     api.dlproc_ = posix_dlproc;
     api.dlclose_ = posix_dlclose;
+#ifndef __EMSCRIPTEN__
+    api.reserve_ = posix_reserve;
+    api.commit_ = posix_commit;
+    api.decommit_ = posix_decommit;
+    api.release_ = posix_release;
+#endif
+
+    /* Chain the fini callback of a previously set OS API, unless this is the
+     * callback of the task pool itself. */
+    if (api.fini_ != posix_task_pool_fini) {
+        posix_task_pool.prev_fini = api.fini_;
+        api.fini_ = posix_task_pool_fini;
+    }
 
     posix_time_setup();
 
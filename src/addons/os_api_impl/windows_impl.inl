@@ -39,11 +39,73 @@ static void* win_thread_join(
     return NULL;
 }
 
+static DWORD flecs_win_detached_thread(void *ptr) {
+    ecs_win_thread_t *thread = ptr;
+    thread->callback(thread->arg);
+    ecs_os_free(thread);
+    return 0;
+}
+
+/* Tasks are not pooled on Windows, a submitted task runs on its own thread.
+ * The functions to configure and inspect the pool are provided so that 
+ * applications can use the same code on all platforms. */
+void ecs_os_task_submit(
+    ecs_os_thread_callback_t callback, 
+    void *param)
+{
+    ecs_win_thread_t *thread = ecs_os_malloc_t(ecs_win_thread_t);
+    thread->arg = param;
+    thread->callback = callback;
+    HANDLE handle = CreateThread(NULL, 0, 
+        (LPTHREAD_START_ROUTINE)flecs_win_detached_thread, thread, 0, NULL);
+    if (!handle) {
+        ecs_os_abort();
+    }
+    CloseHandle(handle);
+}
+
+void ecs_os_set_task_pool_max_idle(
+    int32_t count)
+{
+    (void)count;
+}
+
+int32_t ecs_os_task_pool_count(void) {
+    return 0;
+}
+
 static ecs_os_thread_id_t win_thread_self(void)
 {
     return (ecs_os_thread_id_t)GetCurrentThreadId();
 }
 
+static bool win_thread_set_affinity(
+    ecs_os_thread_t thr,
+    int32_t cpu)
+{
+    if (cpu < -1 || cpu >= (int32_t)(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+
+    HANDLE handle = GetCurrentThread();
+    if (thr) {
+        handle = ((ecs_win_thread_t*)(uintptr_t)thr)->thread;
+    }
+
+    DWORD_PTR mask;
+    if (cpu == -1) {
+        /* Allow all cores the process can run on */
+        DWORD_PTR system_mask;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &mask, &system_mask)) {
+            return false;
+        }
+    } else {
+        mask = (DWORD_PTR)1 << cpu;
+    }
+
+    return SetThreadAffinityMask(handle, mask) != 0;
+}
+
 static int32_t win_ainc(
     int32_t *count) 
 {
@@ -68,6 +130,27 @@ static int64_t win_ladec(
     return InterlockedDecrement64(count);
 }
 
+static int32_t win_aload(
+    const int32_t *count) 
+{
+    return InterlockedCompareExchange(
+        (volatile long*)ECS_CONST_CAST(int32_t*, count), 0, 0);
+}
+
+static void* win_aloadp(
+    void *const *ptr) 
+{
+    return InterlockedCompareExchangePointer(
+        ECS_CONST_CAST(void *volatile*, ptr), NULL, NULL);
+}
+
+static void win_astorep(
+    void **ptr,
+    void *value) 
+{
+    InterlockedExchangePointer((void *volatile*)ptr, value);
+}
+
 static ecs_os_mutex_t win_mutex_new(void) {
     CRITICAL_SECTION *mutex = ecs_os_malloc_t(CRITICAL_SECTION);
     InitializeCriticalSection(mutex);
@@ -236,6 +319,43 @@ static void win_dlclose(ecs_os_dl_t lib) {
     FreeLibrary((HMODULE)(uintptr_t)lib);
 }
 
+static void* win_reserve(
+    ecs_size_t size)
+{
+    return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static bool win_commit(
+    void *ptr,
+    ecs_size_t size)
+{
+    return VirtualAlloc(ptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+/* Decommit rounds the range inwards to page boundaries, so that pages which
+ * are partially in use are not returned to the OS. */
+static void win_decommit(
+    void *ptr,
+    ecs_size_t size)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uintptr_t page_size = (uintptr_t)info.dwPageSize;
+    uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)ptr + (uintptr_t)size) & ~(page_size - 1);
+    if (end > start) {
+        VirtualFree((void*)start, (SIZE_T)(end - start), MEM_DECOMMIT);
+    }
+}
+
+static void win_release(
+    void *ptr,
+    ecs_size_t size)
+{
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
 static void win_fini(void) {
     if (ecs_os_api.flags_ & EcsOsApiHighResolutionTimer) {
         win_enable_high_timer_resolution(false);
@@ -250,12 +370,16 @@ void ecs_set_os_api_impl(void) {
     api.thread_new_ = win_thread_new;
     api.thread_join_ = win_thread_join;
     api.thread_self_ = win_thread_self;
+    api.thread_set_affinity_ = win_thread_set_affinity;
     api.task_new_ = win_thread_new;
     api.task_join_ = win_thread_join;
     api.ainc_ = win_ainc;
     api.adec_ = win_adec;
     api.lainc_ = win_lainc;
     api.ladec_ = win_ladec;
+    api.aload_ = win_aload;
+    api.aloadp_ = win_aloadp;
+    api.astorep_ = win_astorep;
     api.mutex_new_ = win_mutex_new;
     api.mutex_free_ = win_mutex_free;
     api.mutex_lock_ = win_mutex_lock;
@@ -271,6 +395,10 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = win_dlopen;
     api.dlproc_ = win_dlproc;
     api.dlclose_ = win_dlclose;
+    api.reserve_ = win_reserve;
+    api.commit_ = win_commit;
+    api.decommit_ = win_decommit;
+    api.release_ = win_release;
 
     win_time_setup();
 
@@ -19,6 +19,13 @@ static void flecs_pipeline_state_free(
         ecs_allocator_t *a = &world->allocator;
         ecs_vec_fini_t(a, &p->ops, ecs_pipeline_op_t);
         ecs_vec_fini_t(a, &p->systems, ecs_system_t*);
+        ecs_vec_fini_t(a, &p->matched, ecs_pipeline_match_t);
+        ecs_vec_fini_t(a, &p->nodes, ecs_pipeline_node_t);
+        ecs_vec_fini_t(a, &p->deps, int32_t);
+        flecs_worker_tasks_fini(p);
+        flecs_pipeline_snapshot_clear(p);
+        ecs_vec_fini_t(NULL, &p->snapshots, ecs_pipeline_snapshot_t);
+        ecs_vec_fini_t(NULL, &p->snapshot_data, char);
         ecs_os_free(p);
     }
 }
@@ -256,120 +263,393 @@ static EcsPoly* flecs_pipeline_term_system(
     return poly;
 }
 
-static bool flecs_pipeline_build(
-    ecs_world_t *world,
-    ecs_pipeline_state_t *pq)
+/* Component access of a system, used to build the dependency graph */
+typedef struct ecs_pipeline_access_t {
+    ecs_id_t id;
+    bool write;
+} ecs_pipeline_access_t;
+
+static void flecs_pipeline_get_access(
+    ecs_allocator_t *a,
+    const ecs_query_t *query,
+    ecs_vec_t *access)
 {
-    ecs_iter_t it = ecs_query_iter(world, pq->query);
+    ecs_term_t *terms = query->terms;
+    int32_t t, term_count = query->term_count;
 
-    int32_t new_match_count = ecs_query_match_count(pq->query);
-    if (pq->match_count == new_match_count) {
-        /* No need to rebuild the pipeline */
-        ecs_iter_fini(&it);
-        return false;
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &terms[t];
+        int16_t inout = term->inout;
+        if (inout == EcsInOutFilter || inout == EcsInOutNone) {
+            continue;
+        }
+
+        bool from_any = ecs_term_match_0(term);
+        bool from_this = ecs_term_match_this(term);
+        bool is_shared = !from_any && 
+            (!from_this || !(term->src.id & EcsSelf));
+
+        /* Same defaults as flecs_pipeline_check_term */
+        if (inout == EcsInOutDefault) {
+            if (from_any) {
+                continue;
+            } else if (is_shared) {
+                inout = EcsIn;
+            } else {
+                inout = EcsInOut;
+            }
+        }
+
+        ecs_pipeline_access_t *elem = ecs_vec_append_t(
+            a, access, ecs_pipeline_access_t);
+        elem->id = term->id;
+        elem->write = inout != EcsIn;
     }
+}
 
-    world->info.pipeline_build_count_total ++;
-    pq->rebuild_count ++;
+static bool flecs_pipeline_id_overlaps(
+    ecs_id_t a,
+    ecs_id_t b)
+{
+    if (a == b || a == EcsWildcard || b == EcsWildcard) {
+        return true;
+    }
+    return ecs_id_match(a, b) || ecs_id_match(b, a);
+}
+
+/* Two systems conflict if one of them writes a component that the other one
+ * reads or writes. Systems without terms could access anything. */
+static bool flecs_pipeline_access_conflicts(
+    const ecs_pipeline_access_t *a,
+    int32_t a_count,
+    const ecs_pipeline_access_t *b,
+    int32_t b_count)
+{
+    if (!a_count || !b_count) {
+        return true;
+    }
+
+    int32_t i, j;
+    for (i = 0; i < a_count; i ++) {
+        for (j = 0; j < b_count; j ++) {
+            if (!a[i].write && !b[j].write) {
+                continue;
+            }
+            if (flecs_pipeline_id_overlaps(a[i].id, b[j].id)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
 
+/* Add dependencies for the systems in a multithreaded op. Systems in the same
+ * op that don't conflict can run at the same time. */
+static void flecs_pipeline_build_op_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_op_t *op,
+    ecs_vec_t *access)
+{
     ecs_allocator_t *a = &world->allocator;
-    ecs_pipeline_op_t *op = NULL;
-    ecs_write_state_t ws = {0};
-    ecs_map_init(&ws.ids, a);
-    ecs_map_init(&ws.wildcard_ids, a);
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t i, first = op->offset, count = op->count;
+
+    ecs_vec_clear(access);
+    int32_t *access_offsets = flecs_alloc_n(a, int32_t, count + 1);
+    for (i = 0; i < count; i ++) {
+        access_offsets[i] = ecs_vec_count(access);
+        flecs_pipeline_get_access(a, systems[first + i]->query, access);
+    }
+    access_offsets[count] = ecs_vec_count(access);
+
+    ecs_pipeline_access_t *acc = ecs_vec_first_t(
+        access, ecs_pipeline_access_t);
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_node_t *node = &nodes[first + i];
+        node->dep_offset = ecs_vec_count(&pq->deps);
+
+        int32_t j;
+        for (j = 0; j < i; j ++) {
+            if (flecs_pipeline_access_conflicts(
+                &acc[access_offsets[i]], 
+                access_offsets[i + 1] - access_offsets[i],
+                &acc[access_offsets[j]], 
+                access_offsets[j + 1] - access_offsets[j]))
+            {
+                ecs_vec_append_t(a, &pq->deps, int32_t)[0] = first + j;
+                nodes[first + j].notify = true;
+                node->dep_count ++;
+            }
+        }
+    }
 
-    ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
-    ecs_vec_reset_t(a, &pq->systems, ecs_system_t*);
+    flecs_free_n(a, int32_t, count + 1, access_offsets);
+}
 
-    bool multi_threaded = false;
-    bool immediate = false;
-    bool first = true;
+/* Copy the dependencies of an op that didn't change from the graph of the 
+ * previous schedule. The systems of the op moved by shift. */
+static void flecs_pipeline_copy_op_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_op_t *op,
+    const ecs_vec_t *prev_nodes,
+    const ecs_vec_t *prev_deps,
+    int32_t shift)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    const ecs_pipeline_node_t *src_nodes = ecs_vec_first_t(
+        prev_nodes, ecs_pipeline_node_t);
+    const int32_t *src_deps = ecs_vec_first_t(prev_deps, int32_t);
+    int32_t i, last = op->offset + op->count;
+
+    for (i = op->offset; i < last; i ++) {
+        const ecs_pipeline_node_t *src = &src_nodes[i - shift];
+        ecs_pipeline_node_t *node = &nodes[i];
+        node->dep_offset = ecs_vec_count(&pq->deps);
+        node->dep_count = src->dep_count;
+        node->notify = src->notify;
+
+        int32_t d;
+        for (d = 0; d < src->dep_count; d ++) {
+            ecs_vec_append_t(a, &pq->deps, int32_t)[0] = 
+                src_deps[src->dep_offset + d] + shift;
+        }
+    }
+}
 
-    /* Iterate systems in pipeline, add ops for running / merging */
-    while (ecs_query_next(&it)) {
-        EcsPoly *poly = flecs_pipeline_term_system(&it);
+/* Build the dependency graph for the systems in multithreaded ops. When the
+ * schedule was patched, only the graph of the ops in the patched range is
+ * built, and the graph of the other ops is copied from the previous graph. */
+static void flecs_pipeline_build_graph(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t patch_first,
+    int32_t patch_last,
+    int32_t shift)
+{
+    ecs_allocator_t *a = &world->allocator;
+    int32_t count = ecs_vec_count(&pq->systems);
+
+    ecs_vec_t prev_nodes = pq->nodes, prev_deps = pq->deps;
+    ecs_vec_init_t(a, &pq->nodes, ecs_pipeline_node_t, count);
+    ecs_vec_init_t(a, &pq->deps, int32_t, ecs_vec_count(&prev_deps));
+    ecs_vec_set_min_count_zeromem_t(a, &pq->nodes, ecs_pipeline_node_t, count);
+
+    ecs_vec_t access;
+    ecs_vec_init_t(a, &access, ecs_pipeline_access_t, 0);
+
+    ecs_pipeline_op_t *ops = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
+    int32_t o, op_count = ecs_vec_count(&pq->ops);
+    for (o = 0; o < op_count; o ++) {
+        ecs_pipeline_op_t *op = &ops[o];
+        if (!op->multi_threaded) {
+            continue;
+        }
+
+        if (o < patch_first) {
+            flecs_pipeline_copy_op_graph(
+                world, pq, op, &prev_nodes, &prev_deps, 0);
+        } else if (o >= patch_last) {
+            flecs_pipeline_copy_op_graph(
+                world, pq, op, &prev_nodes, &prev_deps, shift);
+        } else {
+            flecs_pipeline_build_op_graph(world, pq, op, &access);
+        }
+    }
+
+    ecs_vec_fini_t(a, &access, ecs_pipeline_access_t);
+    ecs_vec_fini_t(a, &prev_nodes, ecs_pipeline_node_t);
+    ecs_vec_fini_t(a, &prev_deps, int32_t);
+}
+
+/* Get systems matched by the pipeline query, in the order they are run */
+static void flecs_pipeline_get_matched(
+    ecs_world_t *world,
+    ecs_iter_t *it,
+    ecs_vec_t *matched)
+{
+    ecs_allocator_t *a = &world->allocator;
+    while (ecs_query_next(it)) {
+        EcsPoly *poly = flecs_pipeline_term_system(it);
         bool is_active = ecs_table_get_type_index(
-            world, it.table, EcsEmpty) == -1;
+            world, it->table, EcsEmpty) == -1;
 
         int32_t i;
-        for (i = 0; i < it.count; i ++) {
+        for (i = 0; i < it->count; i ++) {
             flecs_poly_assert(poly[i].poly, ecs_system_t);
             ecs_system_t *sys = (ecs_system_t*)poly[i].poly;
-            ecs_query_t *q = sys->query;
+            ecs_pipeline_match_t *m = ecs_vec_append_t(
+                a, matched, ecs_pipeline_match_t);
+            m->system = sys;
+            m->query = sys->query;
+            m->active = is_active;
+            m->multi_threaded = sys->multi_threaded;
+            m->immediate = sys->immediate;
+            m->pipelined = sys->pipelined;
+        }
+    }
+}
 
-            bool needs_merge = false;
-            needs_merge = flecs_pipeline_check_terms(
-                world, q, is_active, &ws);
+static bool flecs_pipeline_match_equals(
+    const ecs_pipeline_match_t *a,
+    const ecs_pipeline_match_t *b)
+{
+    return a->system == b->system && a->query == b->query &&
+        a->active == b->active && a->multi_threaded == b->multi_threaded &&
+        a->immediate == b->immediate && a->pipelined == b->pipelined;
+}
 
-            if (is_active) {
-                if (first) {
-                    multi_threaded = sys->multi_threaded;
-                    immediate = sys->immediate;
-                    first = false;
-                }
+/* Add ops for the matched systems, starting at the specified system. 
+ *
+ * The state of the schedule right after the first system of an op is added 
+ * only depends on that system, as merging resets the write state. This means
+ * that if an op starts at the same system as an op of the previous schedule,
+ * the remaining ops are the same as the ops of the previous schedule. When 
+ * that happens the scan stops, and the index of the op of the previous 
+ * schedule is returned. If the scan reaches the end, -1 is returned. */
+static int32_t flecs_pipeline_schedule(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t first_match,
+    const ecs_pipeline_op_t *prev_ops,
+    int32_t prev_op_count,
+    int32_t sync_match,
+    int32_t match_shift)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_pipeline_op_t *op = NULL;
+    ecs_write_state_t ws = {0};
+    ecs_map_init(&ws.ids, a);
+    ecs_map_init(&ws.wildcard_ids, a);
 
-                if (sys->multi_threaded != multi_threaded) {
-                    needs_merge = true;
-                    multi_threaded = sys->multi_threaded;
-                }
-                if (sys->immediate != immediate) {
-                    needs_merge = true;
-                    immediate = sys->immediate;
-                }
+    bool multi_threaded = false;
+    bool immediate = false;
+    bool pipelined = false;
+    bool first = true;
+    int32_t result = -1, prev_op = 0;
+
+    ecs_pipeline_match_t *matched = ecs_vec_first_t(
+        &pq->matched, ecs_pipeline_match_t);
+    int32_t i, count = ecs_vec_count(&pq->matched);
+
+    /* Iterate systems in pipeline, add ops for running / merging */
+    for (i = first_match; i < count; i ++) {
+        ecs_system_t *sys = matched[i].system;
+        ecs_query_t *q = sys->query;
+        bool is_active = matched[i].active;
+
+        bool needs_merge = false;
+        needs_merge = flecs_pipeline_check_terms(
+            world, q, is_active, &ws);
+
+        if (is_active) {
+            if (first) {
+                multi_threaded = sys->multi_threaded;
+                immediate = sys->immediate;
+                pipelined = sys->pipelined;
+                first = false;
             }
 
-            if (immediate) {
+            if (sys->multi_threaded != multi_threaded) {
                 needs_merge = true;
+                multi_threaded = sys->multi_threaded;
             }
+            if (sys->immediate != immediate) {
+                needs_merge = true;
+                immediate = sys->immediate;
+            }
+            if (sys->pipelined != pipelined) {
+                needs_merge = true;
+                pipelined = sys->pipelined;
+            }
+        }
 
-            if (needs_merge) {
-                /* After merge all components will be merged, so reset state */
-                flecs_pipeline_reset_write_state(&ws);
-
-                /* An inactive system can insert a merge if one of its 
-                 * components got written, which could make the system 
-                 * active. If this is the only system in the pipeline operation,
-                 * it results in an empty operation when we get here. If that's
-                 * the case, reuse the empty operation for the next op. */
-                if (op && op->count) {
-                    op = NULL;
-                }
+        if (immediate) {
+            needs_merge = true;
+        }
 
-                /* Re-evaluate columns to set write flags if system is active.
-                 * If system is inactive, it can't write anything and so it
-                 * should not insert unnecessary merges.  */
-                needs_merge = false;
-                if (is_active) {
-                    needs_merge = flecs_pipeline_check_terms(
-                        world, q, true, &ws);
-                }
+        if (needs_merge) {
+            /* After merge all components will be merged, so reset state */
+            flecs_pipeline_reset_write_state(&ws);
+
+            /* An inactive system can insert a merge if one of its 
+             * components got written, which could make the system 
+             * active. If this is the only system in the pipeline operation,
+             * it results in an empty operation when we get here. If that's
+             * the case, reuse the empty operation for the next op. */
+            if (op && op->count) {
+                op = NULL;
+            }
 
-                /* The component states were just reset, so if we conclude that
-                 * another merge is needed something is wrong. */
-                ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+            /* Re-evaluate columns to set write flags if system is active.
+             * If system is inactive, it can't write anything and so it
+             * should not insert unnecessary merges.  */
+            needs_merge = false;
+            if (is_active) {
+                needs_merge = flecs_pipeline_check_terms(
+                    world, q, true, &ws);
             }
 
-            if (!op) {
-                op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
-                op->offset = ecs_vec_count(&pq->systems);
-                op->count = 0;
-                op->multi_threaded = false;
-                op->immediate = false;
-                op->time_spent = 0;
-                op->commands_enqueued = 0;
+            /* The component states were just reset, so if we conclude that
+             * another merge is needed something is wrong. */
+            ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+        }
+
+        /* If the system starts an op in both the new and the previous 
+         * schedule, the rest of the schedule is the same. */
+        if (is_active && (!op || !op->count) && i >= sync_match) {
+            while (prev_op < prev_op_count && 
+                prev_ops[prev_op].match_offset < (i - match_shift)) 
+            {
+                prev_op ++;
             }
 
-            /* Don't increase count for inactive systems, as they are ignored by
-             * the query used to run the pipeline. */
-            if (is_active) {
-                ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = sys;
-                if (!op->count) {
-                    op->multi_threaded = multi_threaded;
-                    op->immediate = immediate;
+            if (prev_op < prev_op_count && 
+                prev_ops[prev_op].match_offset == (i - match_shift)) 
+            {
+                if (op) {
+                    ecs_vec_remove_last(&pq->ops);
                 }
-                op->count ++;
+                result = prev_op;
+                op = NULL;
+                break;
             }
         }
+
+        if (!op) {
+            op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
+            op->offset = ecs_vec_count(&pq->systems);
+            op->match_offset = i;
+            op->count = 0;
+            op->multi_threaded = false;
+            op->immediate = false;
+            op->pipelined = false;
+            op->time_spent = 0;
+            op->commands_enqueued = 0;
+            op->wait_time = 0;
+            op->worker_count = 0;
+            ecs_os_memset_n(op->wait_histogram, 0, int64_t, 
+                FLECS_SYNC_WAIT_BUCKETS);
+        }
+
+        /* Don't increase count for inactive systems, as they are ignored by
+         * the query used to run the pipeline. */
+        if (is_active) {
+            ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = sys;
+            if (!op->count) {
+                op->multi_threaded = multi_threaded;
+                op->immediate = immediate;
+                op->pipelined = pipelined;
+                op->match_offset = i;
+            }
+            op->count ++;
+        }
     }
 
     if (op && !op->count && ecs_vec_count(&pq->ops) > 1) {
@@ -379,6 +659,141 @@ static bool flecs_pipeline_build(
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
 
+    return result;
+}
+
+static bool flecs_pipeline_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_iter_t it = ecs_query_iter(world, pq->query);
+
+    int32_t new_match_count = ecs_query_match_count(pq->query);
+    if (pq->match_count == new_match_count) {
+        /* No need to rebuild the pipeline */
+        ecs_iter_fini(&it);
+        return false;
+    }
+
+    world->info.pipeline_build_count_total ++;
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t prev_matched = pq->matched;
+    ecs_vec_init_t(a, &pq->matched, ecs_pipeline_match_t, 
+        ecs_vec_count(&prev_matched));
+    flecs_pipeline_get_matched(world, &it, &pq->matched);
+
+    /* Find the range of systems that changed since the previous build */
+    ecs_pipeline_match_t *prev = ecs_vec_first_t(
+        &prev_matched, ecs_pipeline_match_t);
+    ecs_pipeline_match_t *cur = ecs_vec_first_t(
+        &pq->matched, ecs_pipeline_match_t);
+    int32_t prev_count = ecs_vec_count(&prev_matched);
+    int32_t cur_count = ecs_vec_count(&pq->matched);
+    int32_t min_count = prev_count < cur_count ? prev_count : cur_count;
+    int32_t changed = 0, unchanged_tail = 0;
+    while (changed < min_count && 
+        flecs_pipeline_match_equals(&prev[changed], &cur[changed])) 
+    {
+        changed ++;
+    }
+    while (unchanged_tail < (min_count - changed) && 
+        flecs_pipeline_match_equals(&prev[prev_count - unchanged_tail - 1],
+            &cur[cur_count - unchanged_tail - 1]))
+    {
+        unchanged_tail ++;
+    }
+
+    ecs_vec_fini_t(a, &prev_matched, ecs_pipeline_match_t);
+
+    /* Keep the ops that end before the first changed system. The last of 
+     * these ops could absorb systems that were added after it, so the schedule
+     * is rebuilt starting from that op. */
+    ecs_pipeline_op_t *ops = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
+    int32_t op_count = ecs_vec_count(&pq->ops);
+    int32_t patch_first = op_count, first_match = 0, first_system = 0;
+    while (patch_first > 0 && ops[patch_first - 1].match_offset >= changed) {
+        patch_first --;
+    }
+    if (patch_first > 0) {
+        patch_first --;
+        first_match = ops[patch_first].match_offset;
+        first_system = ops[patch_first].offset;
+    }
+
+    /* Move ops and systems that come after the kept ops out of the schedule,
+     * so they can be reused if the rest of the schedule didn't change. */
+    ecs_vec_t prev_ops, prev_systems;
+    ecs_vec_init_t(a, &prev_ops, ecs_pipeline_op_t, op_count - patch_first);
+    ecs_vec_init_t(a, &prev_systems, ecs_system_t*, 
+        ecs_vec_count(&pq->systems) - first_system);
+    int32_t i;
+    for (i = patch_first; i < op_count; i ++) {
+        ecs_vec_append_t(a, &prev_ops, ecs_pipeline_op_t)[0] = ops[i];
+    }
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    for (i = first_system; i < ecs_vec_count(&pq->systems); i ++) {
+        ecs_vec_append_t(a, &prev_systems, ecs_system_t*)[0] = systems[i];
+    }
+    ecs_vec_set_count_t(a, &pq->ops, ecs_pipeline_op_t, patch_first);
+    ecs_vec_set_count_t(a, &pq->systems, ecs_system_t*, first_system);
+
+    int32_t match_shift = cur_count - prev_count;
+    int32_t sync_op = flecs_pipeline_schedule(world, pq, first_match, 
+        ecs_vec_first_t(&prev_ops, ecs_pipeline_op_t), 
+        ecs_vec_count(&prev_ops), cur_count - unchanged_tail, match_shift);
+
+    int32_t patch_last = ecs_vec_count(&pq->ops), shift = 0;
+    if (sync_op != -1) {
+        /* Reuse the remaining ops of the previous schedule */
+        ecs_pipeline_op_t *prev_op = ecs_vec_get_t(
+            &prev_ops, ecs_pipeline_op_t, sync_op);
+        ecs_system_t **prev_sys = ecs_vec_first_t(
+            &prev_systems, ecs_system_t*);
+        int32_t prev_first_system = prev_op->offset;
+        shift = ecs_vec_count(&pq->systems) - prev_first_system;
+
+        for (i = sync_op; i < ecs_vec_count(&prev_ops); i ++, prev_op ++) {
+            ecs_pipeline_op_t *op = ecs_vec_append_t(
+                a, &pq->ops, ecs_pipeline_op_t);
+            *op = *prev_op;
+            op->offset += shift;
+            op->match_offset += match_shift;
+        }
+
+        int32_t prev_system_count = ecs_vec_count(&prev_systems);
+        for (i = prev_first_system - first_system; 
+            i < prev_system_count; i ++) 
+        {
+            ecs_vec_append_t(a, &pq->systems, ecs_system_t*)[0] = prev_sys[i];
+        }
+    }
+
+    ecs_vec_fini_t(a, &prev_ops, ecs_pipeline_op_t);
+    ecs_vec_fini_t(a, &prev_systems, ecs_system_t*);
+
+    if (patch_first || sync_op != -1) {
+        pq->patch_count ++;
+    } else {
+        pq->rebuild_count ++;
+        patch_last = ecs_vec_count(&pq->ops);
+    }
+
+    flecs_pipeline_build_graph(world, pq, patch_first, patch_last, shift);
+
+    /* Ops at the end of the pipeline with only pipelined systems can overlap
+     * with the next frame when pipelined frame execution is enabled. */
+    pq->tail_offset = ecs_vec_count(&pq->systems);
+    ecs_pipeline_op_t *op;
+    int32_t op_i;
+    for (op_i = ecs_vec_count(&pq->ops) - 1; op_i >= 0; op_i --) {
+        op = ecs_vec_get_t(&pq->ops, ecs_pipeline_op_t, op_i);
+        if (!op->pipelined) {
+            break;
+        }
+        pq->tail_offset = op->offset;
+    }
+
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
     if (!op) {
@@ -393,9 +808,9 @@ static bool flecs_pipeline_build(
             op->multi_threaded, !op->immediate);
         ecs_log_push_1();
 
-        int32_t i, count = ecs_vec_count(&pq->systems);
+        int32_t count = ecs_vec_count(&pq->systems);
         int32_t op_index = 0, ran_since_merge = 0;
-        ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+        systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
         for (i = 0; i < count; i ++) {
             ecs_system_t *sys = systems[i];
             ecs_entity_t system = sys->query->entity;
@@ -500,6 +915,8 @@ static bool flecs_pipeline_update(
     ecs_assert(pq->query != NULL, ECS_INTERNAL_ERROR, NULL);
 
     bool rebuilt = flecs_pipeline_build(world, pq);
+    flecs_worker_tasks_update(world, pq);
+
     if (start_of_frame) {
         pq->cur_op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
         pq->cur_i = 0;
@@ -534,6 +951,114 @@ void ecs_run_pipeline(
     }
 }
 
+/* Update the estimated time per entity of a system. The time is measured on a 
+ * single thread that processed its share of the entities of the system. */
+static void flecs_pipeline_system_cost(
+    ecs_system_t *sys,
+    double time_spent,
+    int32_t worker_count,
+    ecs_ftime_t weight)
+{
+    if (!sys->matched_count) {
+        return;
+    }
+
+    ecs_ftime_t cost = (ecs_ftime_t)(time_spent * worker_count / 
+        sys->matched_count);
+    if (sys->cost_per_entity == 0) {
+        sys->cost_per_entity = cost;
+    } else {
+        /* Moving average, so a single slow frame doesn't change the number of
+         * threads for the next frames. */
+        sys->cost_per_entity += (cost - sys->cost_per_entity) * weight;
+    }
+}
+
+/* Select the number of threads for a multithreaded op from the estimated cost
+ * of its systems, so that each thread gets at least the minimum cost. The 
+ * number of matched entities is estimated from the tables in the query cache,
+ * so this doesn't evaluate the queries of the systems. Because the cost per 
+ * entity is measured against the same estimate, an estimate that is too high 
+ * for uncached queries doesn't change the predicted time. */
+static int32_t flecs_pipeline_op_worker_count(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t stage_count)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, last = op->offset + op->count;
+    double cost = 0;
+    bool estimated = true;
+
+    for (i = pq->cur_i; i < last; i ++) {
+        ecs_system_t *sys = systems[i];
+        sys->matched_count = flecs_query_entity_count_estimate(sys->query);
+        if (sys->matched_count && sys->cost_per_entity == 0) {
+            /* System hasn't run yet, use all threads to measure cost */
+            estimated = false;
+        }
+        cost += (double)sys->cost_per_entity * sys->matched_count;
+    }
+
+    if (!estimated) {
+        return stage_count;
+    }
+
+    double worker_count = cost / (double)world->worker_min_cost;
+    if (worker_count < 1) {
+        return 1;
+    }
+    if (worker_count >= stage_count) {
+        return stage_count;
+    }
+    return (int32_t)worker_count;
+}
+
+/* Run the systems of a multithreaded op as a dependency graph. Workers claim
+ * systems in schedule order, wait until the systems they depend on have 
+ * finished, and run each system on all of its matched entities. */
+static int32_t flecs_run_pipeline_graph(
+    ecs_world_t* world,
+    ecs_stage_t* stage,
+    int32_t stage_index,
+    ecs_ftime_t delta_time)
+{
+    ecs_pipeline_state_t* pq = world->pq;
+    ecs_pipeline_op_t* op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, last = op->offset + op->count - 1;
+    bool measure_cost = world->worker_min_cost > 0;
+
+    while ((i = ecs_os_ainc(&pq->next_system) - 1) <= last) {
+        ecs_system_t* sys = systems[i];
+        sys->last_frame = world->info.frame_count_total + 1;
+
+        flecs_wait_for_system_deps(world, pq, i, 1);
+
+        ecs_time_t t = { 0 };
+        if (measure_cost) {
+            ecs_time_measure(&t);
+        }
+
+        flecs_run_system(world, stage, sys->query->entity, sys, stage_index,
+            1, delta_time, NULL, NULL, NULL);
+
+        if (measure_cost) {
+            /* System is claimed by a single thread, so only this thread 
+             * writes to the cost of the system. */
+            flecs_pipeline_system_cost(sys, ecs_time_measure(&t), 1,
+                world->worker_cost_weight);
+        }
+
+        flecs_signal_system_done(world, pq, i);
+
+        ecs_os_linc(&world->info.systems_ran_total);
+    }
+
+    return last;
+}
+
 int32_t flecs_run_pipeline_ops(
     ecs_world_t* world,
     ecs_stage_t* stage,
@@ -547,9 +1072,43 @@ int32_t flecs_run_pipeline_ops(
 
     ecs_assert(!stage_index || op->multi_threaded, ECS_INTERNAL_ERROR, NULL);
 
+    /* Threads that aren't selected for the op don't run anything */
+    if (op->multi_threaded) {
+        if (stage_index >= pq->worker_count) {
+            return i;
+        }
+        stage_count = pq->worker_count;
+    }
+
+    /* Run pipelined systems of the previous frame */
+    if (pq->run_snapshots) {
+        bool workers = op->multi_threaded && world->worker_cond;
+        flecs_pipeline_snapshot_run(world, pq, stage, stage_index, 
+            workers ? stage_count : 1);
+    }
+
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
     int32_t ran_since_merge = i - op->offset;
+    bool measure_cost = !stage_index && op->multi_threaded && 
+        world->worker_min_cost > 0;
+
+    /* If work stealing is enabled, divide the work of multithreaded systems
+     * with tasks that can be claimed by any worker. */
+    ecs_worker_tasks_t *tasks = NULL;
+    if (stage_count > 1 && op->multi_threaded && world->worker_cond) {
+        if ((world->flags & EcsWorldDagScheduling) && !op->immediate &&
+            op->count > 1)
+        {
+            return flecs_run_pipeline_graph(
+                world, stage, stage_index, delta_time);
+        }
+
+        if (world->flags & EcsWorldWorkStealing) {
+            tasks = ecs_vec_first_t(&pq->tasks, ecs_worker_tasks_t);
+            ecs_assert(tasks != NULL, ECS_INTERNAL_ERROR, NULL);
+        }
+    }
 
     for (; i < count; i++) {
         ecs_system_t* sys = systems[i];
@@ -568,8 +1127,28 @@ int32_t flecs_run_pipeline_ops(
             s = stage;
         }
 
-        flecs_run_system(world, s, sys->query->entity, sys, stage_index,
-            stage_count, delta_time, NULL);
+        ecs_time_t t = { 0 };
+        if (measure_cost) {
+            ecs_time_measure(&t);
+        }
+
+        if (tasks) {
+            /* Chunks of a system don't line up with the chunks of the systems
+             * that ran before it, so wait for systems that it depends on. */
+            flecs_wait_for_system_deps(world, pq, i, stage_count);
+            flecs_run_system(world, s, sys->query->entity, sys, stage_index,
+                stage_count, delta_time, NULL, 
+                flecs_worker_steal_iter, &tasks[i]);
+            flecs_signal_system_done(world, pq, i);
+        } else {
+            flecs_run_system(world, s, sys->query->entity, sys, stage_index,
+                stage_count, delta_time, NULL, NULL, NULL);
+        }
+
+        if (measure_cost) {
+            flecs_pipeline_system_cost(sys, ecs_time_measure(&t), stage_count,
+                world->worker_cost_weight);
+        }
 
         ecs_os_linc(&world->info.systems_ran_total);
         ran_since_merge++;
@@ -583,6 +1162,69 @@ int32_t flecs_run_pipeline_ops(
     return i;
 }
 
+/* Add time spent waiting for workers to the wait time histogram of an op */
+static void flecs_pipeline_op_record_wait(
+    ecs_pipeline_op_t *op,
+    double wait_time)
+{
+    int64_t us = (int64_t)(wait_time * 1000000.0);
+    int32_t bucket = 0;
+    while (us && bucket < (FLECS_SYNC_WAIT_BUCKETS - 1)) {
+        us >>= 1;
+        bucket ++;
+    }
+
+    op->wait_time += wait_time;
+    op->wait_histogram[bucket] ++;
+}
+
+/* Reset graph state before workers start running the current op */
+static void flecs_pipeline_reset_graph(
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t i, last = op->offset + op->count;
+    for (i = pq->cur_i; i < last; i ++) {
+        nodes[i].finished = 0;
+    }
+
+    pq->first_system = pq->cur_i;
+    pq->next_system = pq->cur_i;
+}
+
+/* Let workers apply commands that don't change tables before the command 
+ * queues are merged on the main thread. */
+static void flecs_run_pipeline_merge(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_count)
+{
+    if (!(world->flags & EcsWorldParallelMerge)) {
+        return;
+    }
+
+    /* Command capturing and exclusive world access both depend on commands
+     * being merged by a single thread. */
+    if (world->on_commands_active || world->exclusive_access) {
+        return;
+    }
+
+    /* Fall back to the serial merge if commands of one stage can affect the 
+     * entities of another stage. */
+    if (!flecs_commands_can_merge_inplace(world)) {
+        return;
+    }
+
+    pq->merging = true;
+    flecs_signal_workers(world, stage_count);
+    flecs_commands_merge_inplace(world, stage, 0, stage_count);
+    flecs_wait_for_sync(world);
+    pq->merging = false;
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -603,10 +1245,22 @@ void flecs_run_pipeline(
 
     // Update the pipeline the workers will execute
     world->pq = pq;
+    pq->run_count ++;
 
     // Update the pipeline before waking the workers.
     flecs_pipeline_update(world, pq, true);
 
+    // Pipelined systems of the previous frame run during the first op.
+    bool pipelined = world->flags & EcsWorldPipelinedFrames;
+    if (ecs_vec_count(&pq->snapshots)) {
+        if (pipelined) {
+            flecs_pipeline_snapshot_filter(world, pq);
+            pq->run_snapshots = true;
+        } else {
+            flecs_pipeline_snapshot_flush(world, pq);
+        }
+    }
+
     // If there are no operations to execute in the pipeline bail early,
     // no need to wake the workers since they have nothing to do.
     while (pq->cur_op != NULL) {
@@ -615,10 +1269,30 @@ void flecs_run_pipeline(
             continue;
         }
 
+        if (pipelined && pq->cur_i >= pq->tail_offset) {
+            // Copy data for the remaining systems, which will run during the
+            // first op of the next frame.
+            flecs_pipeline_snapshot_flush(world, pq);
+            flecs_pipeline_snapshot_create(world, pq, delta_time);
+            break;
+        }
+
         bool immediate = pq->cur_op->immediate;
         bool op_multi_threaded = multi_threaded && pq->cur_op->multi_threaded;
 
         pq->immediate = immediate;
+        pq->worker_count = stage_count;
+
+        if (op_multi_threaded && world->worker_min_cost > 0) {
+            pq->worker_count = flecs_pipeline_op_worker_count(
+                world, pq, stage_count);
+            if (pq->worker_count == 1) {
+                /* Not worth waking up the workers for */
+                op_multi_threaded = false;
+            }
+        }
+
+        pq->cur_op->worker_count = op_multi_threaded ? pq->worker_count : 1;
 
         if (!immediate) {
             ecs_readonly_begin(world, multi_threaded);
@@ -630,7 +1304,9 @@ void flecs_run_pipeline(
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
-            flecs_signal_workers(world);
+            flecs_pipeline_reset_graph(pq);
+            flecs_worker_tasks_build(world, pq);
+            flecs_signal_workers(world, pq->worker_count);
         }
 
         ecs_time_t st = { 0 };
@@ -648,7 +1324,17 @@ void flecs_run_pipeline(
         }
 
         if (op_multi_threaded) {
+            ecs_time_t wt = { 0 };
+            if (measure_time) {
+                ecs_time_measure(&wt);
+            }
+
             flecs_wait_for_sync(world);
+
+            if (measure_time) {
+                flecs_pipeline_op_record_wait(
+                    pq->cur_op, ecs_time_measure(&wt));
+            }
         }
 
         if (!immediate) {
@@ -657,10 +1343,16 @@ void flecs_run_pipeline(
                 ecs_time_measure(&mt);
             }
 
-            int32_t si;
+            int32_t si, cmd_count = 0;
             for (si = 0; si < stage_count; si ++) {
                 ecs_stage_t *s = world->stages[si];
-                pq->cur_op->commands_enqueued += ecs_vec_count(&s->cmd->queue);
+                cmd_count += s->cmd->count;
+            }
+
+            pq->cur_op->commands_enqueued += cmd_count;
+
+            if (op_multi_threaded && cmd_count) {
+                flecs_run_pipeline_merge(world, pq, stage, stage_count);
             }
 
             ecs_readonly_end(world);
@@ -671,12 +1363,21 @@ void flecs_run_pipeline(
             flecs_defer_end(world, stage);
         }
 
+        if (pq->run_snapshots) {
+            flecs_pipeline_snapshot_clear(pq);
+        }
+
         /* Store the current state of the schedule after we synchronized the
          * threads, to avoid race conditions. */
         pq->cur_i = i;
 
         flecs_pipeline_update(world, pq, false);
     }
+
+    // Pipeline had no ops to run pipelined systems of the previous frame
+    if (pq->run_snapshots) {
+        flecs_pipeline_snapshot_flush(world, pq);
+    }
 }
 
 static void flecs_run_startup_systems(
@@ -993,6 +1694,8 @@ void FlecsPipelineImport(
         }
     });
 
+    world->worker_cost_weight = FLECS_WORKER_COST_WEIGHT;
+
     /* Cleanup thread administration when world is destroyed */
     ecs_atfini(world, FlecsPipelineFini, NULL);
 }
@@ -8,31 +8,149 @@
 
 #include "../../private_api.h"
 
+/* Number of rows in a chunk claimed by a worker when work stealing is enabled.
+ * Each claim costs an atomic increment on a shared cache line, so chunks should
+ * be large enough to amortize it over the rows, but small enough to leave
+ * chunks for idle workers to steal. For components of 8 to 64 bytes a chunk
+ * of 256 rows spans 2 to 16KB per column, which keeps the columns of a chunk in
+ * L1/L2. Systems can override this with ecs_system_desc_t::chunking. */
+#ifndef FLECS_WORKER_CHUNK_SIZE
+#define FLECS_WORKER_CHUNK_SIZE (256)
+#endif
+
+/* Size of a cache line, used to prevent false sharing between workers */
+#ifndef FLECS_CACHE_LINE_SIZE
+#define FLECS_CACHE_LINE_SIZE (64)
+#endif
+
+/* Default weight of the last measurement in the estimated cost per entity of a
+ * system. With 0.25 a change in cost is mostly picked up after 4 to 8 frames,
+ * while a single slow frame doesn't change the number of threads. Can be 
+ * changed at runtime with ecs_set_worker_cost_weight(). */
+#ifndef FLECS_WORKER_COST_WEIGHT
+#define FLECS_WORKER_COST_WEIGHT (0.25f)
+#endif
+
 /** Instruction data for pipeline.
  * This type is the element type in the "ops" vector of a pipeline. */
 typedef struct ecs_pipeline_op_t {
     int32_t offset;             /* Offset in systems vector */
+    int32_t match_offset;       /* Offset of first system in matched vector */
     int32_t count;              /* Number of systems to run before next op */
     double time_spent;          /* Time spent merging commands for sync point */
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
+    double wait_time;           /* Time spent waiting for workers to sync */
+    int64_t wait_histogram[FLECS_SYNC_WAIT_BUCKETS]; /* Wait time histogram */
+    int32_t worker_count;       /* Number of threads that ran op last frame */
     bool multi_threaded;        /* Whether systems can be run multi-threaded */
     bool immediate;           /* Whether systems run in immediate mode */
+    bool pipelined;             /* Whether systems can overlap with next frame */
 } ecs_pipeline_op_t;
 
+/** System matched by the pipeline query. The matched systems of the previous
+ * pipeline build are used to find which part of the schedule changed. */
+typedef struct ecs_pipeline_match_t {
+    ecs_system_t *system;       /* Matched system */
+    ecs_query_t *query;         /* Query of system when it was matched */
+    bool active;                /* Whether system is active */
+    bool multi_threaded;        /* Whether system is multithreaded */
+    bool immediate;             /* Whether system is immediate */
+    bool pipelined;             /* Whether system is pipelined */
+} ecs_pipeline_match_t;
+
+/** Node in the dependency graph of a pipeline. A system depends on the earlier
+ * systems in the same op that it has conflicting component access with. */
+typedef struct ecs_pipeline_node_t {
+    int32_t dep_offset;         /* Offset in deps vector */
+    int32_t dep_count;          /* Number of systems that must finish first */
+    int32_t finished;           /* Number of times system finished in op run */
+    bool notify;                /* Whether other systems depend on system */
+} ecs_pipeline_node_t;
+
+/** Range of chunks assigned to a worker when work stealing is enabled. Chunks
+ * are created before workers start and are never added while they run, so
+ * instead of a deque each range is a shared counter: the owner and workers that
+ * steal from it both claim the next chunk with an atomic increment. */
+typedef struct ecs_worker_range_t {
+    int32_t claimed;            /* Number of claimed chunks (atomic) */
+    int32_t first;              /* First chunk in range */
+    int32_t count;              /* Number of chunks in range */
+
+    /* Prevent false sharing between workers claiming from adjacent ranges */
+    char padding[FLECS_CACHE_LINE_SIZE - 3 * sizeof(int32_t)];
+} ecs_worker_range_t;
+
+/** Query result of a multithreaded system, split up into chunks. */
+typedef struct ecs_worker_result_t {
+    int32_t first_chunk;        /* First chunk of result */
+    int32_t count;              /* Number of entities in result */
+} ecs_worker_result_t;
+
+/** Tasks for a multithreaded system, shared between workers. Created by the
+ * main thread before workers are signaled to run the op of the system. */
+typedef struct ecs_worker_tasks_t {
+    ecs_system_t *system;       /* System for which tasks are created */
+    int32_t run;                /* Pipeline run for which tasks are valid */
+    int32_t chunk_count;        /* Total number of chunks */
+    int32_t chunk_size;         /* Number of entities per chunk */
+    int32_t range_count;        /* Number of workers */
+    ecs_vec_t results;          /* vector<ecs_worker_result_t> */
+    ecs_worker_range_t *ranges; /* One range per worker */
+} ecs_worker_tasks_t;
+
+/** Copy of a query result of a pipelined system. Created at the end of a frame
+ * when pipelined frame execution is enabled, and iterated by the workers while
+ * the first op of the next frame runs. Copied arrays are stored in the snapshot
+ * data of the pipeline, which is reused across frames. Arrays are stored as 
+ * offsets, as the snapshot data can be reallocated while it is populated. */
+typedef struct ecs_pipeline_snapshot_t {
+    ecs_system_t *system;       /* System that matched the result */
+    ecs_ftime_t delta_time;     /* Delta time of frame that created snapshot */
+    ecs_ftime_t delta_system_time; /* Delta system time of snapshot frame */
+    int32_t count;              /* Number of entities in result */
+    ecs_termset_t set_fields;   /* Fields that are set */
+    ecs_termset_t ref_fields;   /* Fields that point to a single value */
+    ecs_termset_t up_fields;    /* Fields matched through up traversal */
+    int32_t entities;           /* Offset of entity ids, -1 if none */
+    int32_t ids;                /* Offset of field ids */
+    int32_t sources;            /* Offset of field sources */
+    int32_t fields[FLECS_TERM_COUNT_MAX]; /* Offset of field data, -1 if none */
+} ecs_pipeline_snapshot_t;
+
 struct ecs_pipeline_state_t {
     ecs_query_t *query;         /* Pipeline query */
     ecs_vec_t ops;              /* Pipeline schedule */
     ecs_vec_t systems;          /* Vector with system ids */
+    ecs_vec_t matched;          /* vector<ecs_pipeline_match_t> */
 
     ecs_entity_t last_system;   /* Last system run by pipeline */
     int32_t match_count;        /* Used to track if rebuild is necessary */
     int32_t rebuild_count;      /* Number of pipeline rebuilds */
+    int32_t patch_count;        /* Number of partial pipeline rebuilds */
+    int32_t run_count;          /* Number of pipeline runs */
+
+    /* Dependency graph, one node per system in systems vector */
+    ecs_vec_t nodes;            /* vector<ecs_pipeline_node_t> */
+    ecs_vec_t deps;             /* vector<int32_t> */
+    int32_t first_system;       /* First system of current op run */
+    int32_t next_system;        /* Next system to claim (atomic) */
+    int32_t worker_count;       /* Number of threads that run current op */
+
+    /* Work stealing tasks, one element per system in systems vector */
+    ecs_vec_t tasks;            /* vector<ecs_worker_tasks_t> */
+
+    /* Pipelined frame execution */
+    int32_t tail_offset;        /* First system of ops that overlap next frame */
+    ecs_vec_t snapshots;        /* vector<ecs_pipeline_snapshot_t> */
+    ecs_vec_t snapshot_data;    /* vector<char>, arrays copied by snapshots */
+    bool run_snapshots;         /* Whether workers run snapshots in current op */
 
     /* Members for continuing pipeline iteration after pipeline rebuild */
     ecs_pipeline_op_t *cur_op;  /* Current pipeline op */
     int32_t cur_i;              /* Index in current result */
     int32_t ran_since_merge;    /* Index in current op */
     bool immediate;           /* Is pipeline in immediate mode */
+    bool merging;               /* Are workers merging command queues */
 };
 
 typedef struct EcsPipeline {
@@ -72,9 +190,65 @@ void flecs_join_worker_threads(
     ecs_world_t *world);
 
 void flecs_signal_workers(
-    ecs_world_t *world);
+    ecs_world_t *world,
+    int32_t count);
 
 void flecs_wait_for_sync(
     ecs_world_t *world);
 
+void flecs_wait_for_system_deps(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system,
+    int32_t required);
+
+void flecs_signal_system_done(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system);
+
+void flecs_worker_tasks_update(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+void flecs_worker_tasks_fini(
+    ecs_pipeline_state_t *pq);
+
+void flecs_worker_tasks_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+ecs_iter_t flecs_worker_steal_iter(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
+////////////////////////////////////////////////////////////////////////////////
+//// Pipelined frame API
+////////////////////////////////////////////////////////////////////////////////
+
+void flecs_pipeline_snapshot_create(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_ftime_t delta_time);
+
+void flecs_pipeline_snapshot_run(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count);
+
+void flecs_pipeline_snapshot_clear(
+    ecs_pipeline_state_t *pq);
+
+void flecs_pipeline_snapshot_filter(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
+void flecs_pipeline_snapshot_flush(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq);
+
 #endif
@@ -0,0 +1,459 @@
+/**
+ * @file addons/pipeline/snapshot.c
+ * @brief Pipelined frame execution.
+ *
+ * When pipelined frame execution is enabled, the ops at the end of a pipeline
+ * that only contain pipelined systems don't run at the end of the frame. The
+ * query results of these systems are copied instead, after which the systems
+ * run on the copies while the first op of the next frame runs.
+ */
+
+#include "flecs.h"
+#include "../system/system.h"
+
+#ifdef FLECS_PIPELINE
+#include "pipeline.h"
+
+/* Only used by checks, which are compiled out in release builds */
+#if !defined(FLECS_NDEBUG) || defined(FLECS_KEEP_ASSERT)
+static bool flecs_pipeline_trivially_copyable(
+    const ecs_type_info_t *ti)
+{
+    return !(ti->hooks.flags & (ECS_TYPE_HOOK_COPY_CTOR |
+        ECS_TYPE_HOOK_COPY | ECS_TYPE_HOOK_DTOR));
+}
+#endif
+
+/* Allocate storage for a copied array in the snapshot data of the pipeline. 
+ * Returns the offset of the storage, as the snapshot data can be reallocated
+ * by the next allocation. */
+static int32_t flecs_pipeline_snapshot_alloc(
+    ecs_pipeline_state_t *pq,
+    ecs_size_t size)
+{
+    ecs_vec_t *data = &pq->snapshot_data;
+    int32_t offset = ECS_ALIGN(ecs_vec_count(data), ECS_SIZEOF(ecs_id_t) * 2);
+    ecs_vec_set_count_t(NULL, data, char, offset + size);
+    return offset;
+}
+
+static void* flecs_pipeline_snapshot_ptr(
+    const ecs_pipeline_state_t *pq,
+    int32_t offset)
+{
+    if (offset == -1) {
+        return NULL;
+    }
+    return ECS_OFFSET(ecs_vec_first(&pq->snapshot_data), offset);
+}
+
+static int32_t flecs_pipeline_snapshot_copy(
+    ecs_pipeline_state_t *pq,
+    const void *src,
+    ecs_size_t size)
+{
+    int32_t offset = flecs_pipeline_snapshot_alloc(pq, size);
+    ecs_os_memcpy(flecs_pipeline_snapshot_ptr(pq, offset), src, size);
+    return offset;
+}
+
+/* Copy field data of a result, so that the copy can be read while the next
+ * frame modifies the component. */
+static int32_t flecs_pipeline_snapshot_field(
+    ecs_pipeline_state_t *pq,
+    ecs_iter_t *it,
+    ecs_system_t *sys,
+    int8_t field)
+{
+    ecs_world_t *world = it->real_world;
+    ecs_size_t size = it->sizes[field];
+    if (!size || !ecs_field_is_set(it, field)) {
+        return -1;
+    }
+
+    ecs_entity_t component = ecs_get_typeid(world, it->ids[field]);
+    const ecs_type_info_t *ti = ecs_get_type_info(world, component);
+    ecs_check(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_check(ecs_field_is_readonly(it, field), ECS_INVALID_OPERATION,
+        "pipelined system '%s' can only read components", sys->name);
+    ecs_check(ecs_is_double_buffered(world, component), ECS_INVALID_OPERATION,
+        "pipelined system '%s' reads component '%s' that is not double "
+        "buffered", sys->name, ti->name);
+    ecs_check(flecs_pipeline_trivially_copyable(ti), ECS_INVALID_OPERATION,
+        "double buffered component '%s' has copy or dtor hooks", ti->name);
+    (void)ti;
+
+    int32_t i, count = ecs_field_is_self(it, field) ? it->count : 1;
+    int32_t result = flecs_pipeline_snapshot_alloc(pq, size * count);
+    void *dst = flecs_pipeline_snapshot_ptr(pq, result);
+
+    if (it->row_fields & (1llu << field)) {
+        for (i = 0; i < count; i ++) {
+            ecs_os_memcpy(ECS_ELEM(dst, size, i),
+                ecs_field_at_w_size(it, flecs_uto(size_t, size), field, i),
+                size);
+        }
+    } else {
+        ecs_os_memcpy(dst, ecs_field_w_size(
+            it, flecs_uto(size_t, size), field), size * count);
+    }
+
+    return result;
+error:
+    return -1;
+}
+
+static void flecs_pipeline_snapshot_result(
+    ecs_pipeline_state_t *pq,
+    ecs_iter_t *it,
+    ecs_system_t *sys,
+    ecs_ftime_t delta_time,
+    ecs_ftime_t delta_system_time)
+{
+    ecs_pipeline_snapshot_t *s = ecs_vec_append_t(
+        NULL, &pq->snapshots, ecs_pipeline_snapshot_t);
+    ecs_os_zeromem(s);
+
+    s->system = sys;
+    s->delta_time = delta_time;
+    s->delta_system_time = delta_system_time;
+    s->count = it->count;
+    s->set_fields = it->set_fields;
+    s->ref_fields = it->ref_fields;
+    s->up_fields = it->up_fields;
+    s->entities = -1;
+
+    if (it->count) {
+        s->entities = flecs_pipeline_snapshot_copy(pq, it->entities, 
+            ECS_SIZEOF(ecs_entity_t) * it->count);
+    }
+
+    int8_t i, field_count = it->field_count;
+    if (!field_count) {
+        return;
+    }
+
+    s->ids = flecs_pipeline_snapshot_copy(pq, it->ids, 
+        ECS_SIZEOF(ecs_id_t) * field_count);
+    s->sources = flecs_pipeline_snapshot_copy(pq, it->sources, 
+        ECS_SIZEOF(ecs_entity_t) * field_count);
+
+    for (i = 0; i < field_count; i ++) {
+        s->fields[i] = flecs_pipeline_snapshot_field(pq, it, sys, i);
+        if (!ecs_field_is_self(it, i)) {
+            s->ref_fields |= (1llu << i);
+        }
+    }
+}
+
+static void flecs_pipeline_snapshot_system(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_system_t *sys,
+    ecs_ftime_t delta_time)
+{
+    ecs_ftime_t time_elapsed = delta_time;
+
+    /* Same as flecs_run_system, only snapshot systems that would run */
+    if (sys->tick_source) {
+        const EcsTickSource *tick = ecs_get(
+            world, sys->tick_source, EcsTickSource);
+        if (!tick || !tick->tick) {
+            return;
+        }
+        time_elapsed = tick->time_elapsed;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, sys->query);
+#ifdef FLECS_CACHED_QUERIES
+    if (sys->group_id_set) {
+        ecs_iter_set_group(&it, sys->group_id);
+    }
+#endif
+
+    if (!sys->query->term_count) {
+        flecs_pipeline_snapshot_result(pq, &it, sys, delta_time, time_elapsed);
+        ecs_iter_fini(&it);
+        return;
+    }
+
+    while (ecs_query_next(&it)) {
+        flecs_pipeline_snapshot_result(pq, &it, sys, delta_time, time_elapsed);
+    }
+}
+
+void flecs_pipeline_snapshot_create(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_ftime_t delta_time)
+{
+    ecs_assert(!ecs_vec_count(&pq->snapshots), ECS_INTERNAL_ERROR, NULL);
+
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, count = ecs_vec_count(&pq->systems);
+    for (i = pq->tail_offset; i < count; i ++) {
+        ecs_system_t *sys = systems[i];
+        sys->last_frame = world->info.frame_count_total + 1;
+        flecs_pipeline_snapshot_system(world, pq, sys, delta_time);
+    }
+}
+
+void flecs_pipeline_snapshot_run(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count)
+{
+    ecs_pipeline_snapshot_t *snapshots = ecs_vec_first_t(
+        &pq->snapshots, ecs_pipeline_snapshot_t);
+    int32_t i, count = ecs_vec_count(&pq->snapshots);
+    bool measure_time = ECS_BIT_IS_SET(world->flags, EcsWorldMeasureSystemTime);
+
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_snapshot_t *s = &snapshots[i];
+        ecs_system_t *sys = s->system;
+
+        /* Systems that aren't multithreaded only run on the main thread */
+        if (!sys->multi_threaded && stage_index) {
+            continue;
+        }
+
+        /* Divide entities across workers, same as ecs_worker_iter() */
+        int32_t first = 0, per_worker = s->count;
+        if (sys->multi_threaded && stage_count > 1) {
+            per_worker = s->count / stage_count;
+            first = per_worker * stage_index;
+            int32_t remaining = s->count - per_worker * stage_count;
+            if (remaining) {
+                if (stage_index < remaining) {
+                    per_worker ++;
+                    first += stage_index;
+                } else {
+                    first += remaining;
+                }
+            }
+        }
+
+        if (!per_worker && (s->count || stage_index)) {
+            continue;
+        }
+
+        ecs_time_t time_start;
+        if (measure_time) {
+            ecs_os_get_time(&time_start);
+        }
+
+        const ecs_query_t *q = sys->query;
+        void *ptrs[FLECS_TERM_COUNT_MAX];
+        int8_t f;
+        for (f = 0; f < q->field_count; f ++) {
+            ptrs[f] = flecs_pipeline_snapshot_ptr(pq, s->fields[f]);
+            if (ptrs[f] && !(s->ref_fields & (1llu << f))) {
+                ptrs[f] = ECS_ELEM(ptrs[f], q->sizes[f], first);
+            }
+        }
+
+        ecs_entity_t *entities = flecs_pipeline_snapshot_ptr(pq, s->entities);
+
+        ecs_iter_t it = {
+            .world = stage->thread_ctx,
+            .real_world = world,
+            .count = per_worker,
+            .entities = entities ? &entities[first] : NULL,
+            .ptrs = ptrs,
+            .sizes = q->sizes,
+            .ids = flecs_pipeline_snapshot_ptr(pq, s->ids),
+            .sources = flecs_pipeline_snapshot_ptr(pq, s->sources),
+            .set_fields = s->set_fields,
+            .ref_fields = s->ref_fields,
+            .up_fields = s->up_fields,
+            .system = sys->query->entity,
+            .field_count = q->field_count,
+            .query = q,
+            .param = sys->ctx,
+            .ctx = sys->ctx,
+            .callback_ctx = sys->callback_ctx,
+            .run_ctx = sys->run_ctx,
+            .delta_time = s->delta_time,
+            .delta_system_time = s->delta_system_time,
+            .frame_offset = first,
+            .flags = EcsIterIsValid,
+            .callback = sys->action
+        };
+
+        ecs_entity_t old_system = flecs_stage_set_system(
+            stage, sys->query->entity);
+        if (sys->run) {
+            /* Run callbacks iterate a single result per snapshot */
+            it.next = flecs_default_next_callback;
+            sys->run(&it);
+        } else {
+            sys->action(&it);
+        }
+        flecs_stage_set_system(stage, old_system);
+
+        if (measure_time) {
+            sys->time_spent += (ecs_ftime_t)ecs_time_measure(&time_start);
+        }
+    }
+}
+
+/* Remove entities from snapshots that were deleted after the snapshots were
+ * created, for example by the application in between two frames. */
+void flecs_pipeline_snapshot_filter(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_snapshot_t *snapshots = ecs_vec_first_t(
+        &pq->snapshots, ecs_pipeline_snapshot_t);
+    int32_t i, count = ecs_vec_count(&pq->snapshots);
+    for (i = 0; i < count; i ++) {
+        ecs_pipeline_snapshot_t *s = &snapshots[i];
+        ecs_entity_t *entities = flecs_pipeline_snapshot_ptr(pq, s->entities);
+        if (!entities) {
+            continue;
+        }
+
+        const ecs_query_t *q = s->system->query;
+        int32_t e, alive = 0;
+        for (e = 0; e < s->count; e ++) {
+            if (!ecs_is_alive(world, entities[e])) {
+                continue;
+            }
+
+            if (alive != e) {
+                entities[alive] = entities[e];
+
+                int8_t f;
+                for (f = 0; f < q->field_count; f ++) {
+                    void *ptr = flecs_pipeline_snapshot_ptr(pq, s->fields[f]);
+                    if (ptr && !(s->ref_fields & (1llu << f))) {
+                        ecs_size_t size = q->sizes[f];
+                        ecs_os_memcpy(ECS_ELEM(ptr, size, alive), 
+                            ECS_ELEM(ptr, size, e), size);
+                    }
+                }
+            }
+
+            alive ++;
+        }
+
+        s->count = alive;
+    }
+}
+
+void flecs_pipeline_snapshot_clear(
+    ecs_pipeline_state_t *pq)
+{
+    /* Keep storage, so the next frame can reuse it */
+    ecs_vec_clear(&pq->snapshots);
+    ecs_vec_clear(&pq->snapshot_data);
+    pq->run_snapshots = false;
+}
+
+void flecs_pipeline_snapshot_flush(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    if (!ecs_vec_count(&pq->snapshots)) {
+        return;
+    }
+
+    flecs_pipeline_snapshot_filter(world, pq);
+
+    ecs_readonly_begin(world, false);
+    flecs_pipeline_snapshot_run(world, pq, world->stages[0], 0, 1);
+    ecs_readonly_end(world);
+    flecs_pipeline_snapshot_clear(pq);
+}
+
+void ecs_set_pipelined_frames(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change pipelined frames while world is in readonly mode");
+
+    if (!enable) {
+        /* Run pending snapshots of all pipelines. Collect pipelines first, as
+         * the systems run by a flush can modify the pipeline table. */
+        ecs_allocator_t *a = &world->allocator;
+        ecs_vec_t pipelines;
+        ecs_vec_init_t(a, &pipelines, ecs_pipeline_state_t*, 0);
+
+        ecs_iter_t it = ecs_each(world, EcsPipeline);
+        while (ecs_each_next(&it)) {
+            EcsPipeline *p = ecs_field(&it, EcsPipeline, 0);
+            int32_t i;
+            for (i = 0; i < it.count; i ++) {
+                if (p[i].state && ecs_vec_count(&p[i].state->snapshots)) {
+                    ecs_vec_append_t(a, &pipelines, 
+                        ecs_pipeline_state_t*)[0] = p[i].state;
+                }
+            }
+        }
+
+        ecs_pipeline_state_t **states = ecs_vec_first(&pipelines);
+        int32_t i, count = ecs_vec_count(&pipelines);
+        for (i = 0; i < count; i ++) {
+            flecs_pipeline_snapshot_flush(world, states[i]);
+        }
+
+        ecs_vec_fini_t(a, &pipelines, ecs_pipeline_state_t*);
+    }
+
+    ECS_BIT_COND(world->flags, EcsWorldPipelinedFrames, enable);
+error:
+    return;
+}
+
+bool ecs_using_pipelined_frames(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldPipelinedFrames);
+error:
+    return false;
+}
+
+void ecs_set_double_buffered(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(component != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change double buffering while world is in readonly mode");
+
+    if (enable) {
+        const ecs_type_info_t *ti = ecs_get_type_info(world, component);
+        ecs_check(ti != NULL, ECS_INVALID_PARAMETER,
+            "double buffered entity must be a component");
+        ecs_check(flecs_pipeline_trivially_copyable(ti),
+            ECS_INVALID_PARAMETER,
+            "double buffered component '%s' has copy or dtor hooks", ti->name);
+        (void)ti;
+        ecs_map_ensure(&world->double_buffered, component)[0] = 1;
+    } else {
+        ecs_map_remove(&world->double_buffered, component);
+    }
+error:
+    return;
+}
+
+bool ecs_is_double_buffered(
+    const ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ecs_map_get(&world->double_buffered, component) != NULL;
+error:
+    return false;
+}
+
+#endif
@@ -9,25 +9,84 @@
 #ifdef FLECS_PIPELINE
 #include "pipeline.h"
 
+/* Wait until main thread signals that worker can continue. Spin for the 
+ * configured number of iterations before blocking on the condition variable.
+ * Workers that aren't selected for a job keep waiting when the condition
+ * variable is broadcast. */
+static void flecs_wait_for_signal(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    int32_t i, spin_count = world->worker_spin_count;
+    for (i = 0; i < spin_count; i ++) {
+        if (ecs_os_aload(&stage->worker_signaled)) {
+            ecs_os_linc(&stage->worker_stats.spins);
+            ecs_os_adec(&stage->worker_signaled);
+            return;
+        }
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    if (!stage->worker_signaled) {
+        stage->worker_stats.parks ++;
+        do {
+            ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        } while (!stage->worker_signaled);
+    }
+    ecs_os_adec(&stage->worker_signaled);
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 /* Synchronize workers */
 static void flecs_sync_worker(
-    ecs_world_t* world)
+    ecs_world_t* world,
+    ecs_stage_t *stage)
 {
     int32_t stage_count = ecs_get_stage_count(world);
     if (stage_count <= 1) {
         return;
     }
 
+    /* The main thread doesn't signal workers again before all signaled workers
+     * are waiting, so the number of signaled workers can't change here. */
+    int32_t signaled = world->workers_signaled;
+
     /* Signal that thread is waiting */
-    ecs_os_mutex_lock(world->sync_mutex);
-    if (++world->workers_waiting == (stage_count - 1)) {
+    if (ecs_os_ainc(&world->workers_waiting) == signaled) {
         /* Only signal main thread when all threads are waiting */
+        ecs_os_mutex_lock(world->sync_mutex);
         ecs_os_cond_signal(world->sync_cond);
+        ecs_os_mutex_unlock(world->sync_mutex);
     }
 
-    /* Wait until main thread signals that thread can continue */
-    ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
-    ecs_os_mutex_unlock(world->sync_mutex);
+    flecs_wait_for_signal(world, stage);
+}
+
+/* Pin worker thread to core. If thread is 0, the calling thread is pinned. */
+static void flecs_worker_set_affinity(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_os_thread_t thread)
+{
+    if (world->workers_use_task_api || !ecs_os_api.thread_set_affinity_) {
+        return;
+    }
+
+    int32_t cpu = ecs_get_worker_affinity(world, stage->id);
+    if (cpu == -1 && !stage->worker_stats.pinned) {
+        return;
+    }
+
+    if (!ecs_os_thread_set_affinity(thread, cpu)) {
+        ecs_warn("worker %d: failed to set affinity to core %d", 
+            stage->id, cpu);
+        return;
+    }
+
+    stage->worker_stats.pinned = cpu != -1;
+    if (!thread && cpu != -1) {
+        flecs_stage_first_touch(stage);
+    }
 }
 
 /* Worker thread */
@@ -40,27 +99,36 @@ static void* flecs_worker(void *arg) {
 
     ecs_dbg_2("worker %d: start", stage->id);
 
+    /* Pin thread before the stage allocates memory, so that memory used by 
+     * the stage is first touched on the NUMA node of the core. */
+    flecs_worker_set_affinity(world, stage, 0);
+
     /* Start worker, increase counter so main thread knows how many
      * workers are ready */
     ecs_os_mutex_lock(world->sync_mutex);
     world->workers_running ++;
+    ecs_os_mutex_unlock(world->sync_mutex);
 
     if (!(world->flags & EcsWorldQuitWorkers)) {
-        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        flecs_wait_for_signal(world, stage);
     }
 
-    ecs_os_mutex_unlock(world->sync_mutex);
-
     while (!(world->flags & EcsWorldQuitWorkers)) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
-        ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        if (world->pq->merging) {
+            ecs_dbg_3("worker %d: merge", stage->id);
+            flecs_commands_merge_inplace(
+                world, stage, stage->id, world->stage_count);
+        } else {
+            ecs_dbg_3("worker %d: run", stage->id);
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
-        flecs_sync_worker(world);
+        flecs_sync_worker(world, stage);
     }
 
     ecs_dbg_2("worker %d: finalizing", stage->id);
@@ -87,6 +155,10 @@ void flecs_create_worker_threads(
         flecs_poly_assert(stage, ecs_stage_t);
 
         ecs_assert(stage->thread == 0, ECS_INTERNAL_ERROR, NULL);
+
+        /* Clear signal that a previous thread for the stage didn't consume */
+        stage->worker_signaled = 0;
+
         if (ecs_using_task_threads(world)) {
             /* workers are using tasks in an external task manager provided via
              * the OS API */
@@ -134,47 +206,123 @@ static void flecs_wait_for_workers(
     } while (wait);
 }
 
-/* Wait until all threads are waiting on sync point */
+/* Wait until all signaled threads are waiting on sync point */
 void flecs_wait_for_sync(
     ecs_world_t *world)
 {
-    int32_t stage_count = ecs_get_stage_count(world);
-    if (stage_count <= 1) {
+    int32_t signaled = world->workers_signaled;
+    if (!signaled) {
         return;
     }
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
-    ecs_os_mutex_lock(world->sync_mutex);
-    if (world->workers_waiting != (stage_count - 1)) {
-        ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
+    ecs_stage_t *stage = world->stages[0];
+    int32_t i, spin_count = world->worker_spin_count;
+    for (i = 0; i < spin_count; i ++) {
+        if (ecs_os_aload(&world->workers_waiting) == signaled) {
+            stage->worker_stats.spins ++;
+            break;
+        }
     }
 
-    /* We shouldn't have been signalled unless all workers are waiting on sync */
-    ecs_assert(world->workers_waiting == (stage_count - 1), 
-        ECS_INTERNAL_ERROR, NULL);
+    ecs_os_mutex_lock(world->sync_mutex);
+    if (world->workers_waiting != signaled) {
+        stage->worker_stats.parks ++;
+        do {
+            ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
+        } while (world->workers_waiting != signaled);
+    }
 
     world->workers_waiting = 0;
+    world->workers_signaled = 0;
     ecs_os_mutex_unlock(world->sync_mutex);
 
     ecs_dbg_3("#[bold]pipeline: workers synced");
 }
 
-/* Signal workers that they can start/resume work */
+/* Signal workers of the first count stages that they can start/resume work */
 void flecs_signal_workers(
-    ecs_world_t *world)
+    ecs_world_t *world,
+    int32_t count)
 {
-    int32_t stage_count = ecs_get_stage_count(world);
-    if (stage_count <= 1) {
+    ecs_assert(count <= ecs_get_stage_count(world), ECS_INTERNAL_ERROR, NULL);
+    if (count <= 1) {
         return;
     }
 
-    ecs_dbg_3("#[bold]pipeline: signal workers");
+    ecs_dbg_3("#[bold]pipeline: signal %d workers", count - 1);
     ecs_os_mutex_lock(world->sync_mutex);
+    world->workers_signaled = count - 1;
+    int32_t i;
+    for (i = 1; i < count; i ++) {
+        ecs_os_ainc(&world->stages[i]->worker_signaled);
+    }
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
+static bool flecs_system_deps_finished(
+    ecs_pipeline_state_t *pq,
+    const ecs_pipeline_node_t *node,
+    int32_t required)
+{
+    ecs_pipeline_node_t *nodes = ecs_vec_first_t(
+        &pq->nodes, ecs_pipeline_node_t);
+    int32_t *deps = ecs_vec_get_t(&pq->deps, int32_t, node->dep_offset);
+    int32_t i;
+    for (i = 0; i < node->dep_count; i ++) {
+        int32_t dep = deps[i];
+        if (dep < pq->first_system) {
+            /* System ran before the current op run started */
+            continue;
+        }
+        if (nodes[dep].finished < required) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Wait until the systems that a system depends on have finished running on 
+ * the required number of workers. */
+void flecs_wait_for_system_deps(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system,
+    int32_t required)
+{
+    ecs_pipeline_node_t *node = ecs_vec_get_t(
+        &pq->nodes, ecs_pipeline_node_t, system);
+    if (!node->dep_count) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    while (!flecs_system_deps_finished(pq, node, required)) {
+        ecs_os_cond_wait(world->system_cond, world->sync_mutex);
+    }
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
+/* Signal workers waiting for a system that it has finished running */
+void flecs_signal_system_done(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq,
+    int32_t system)
+{
+    ecs_pipeline_node_t *node = ecs_vec_get_t(
+        &pq->nodes, ecs_pipeline_node_t, system);
+    if (!node->notify) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    node->finished ++;
+    ecs_os_cond_broadcast(world->system_cond);
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 void flecs_join_worker_threads(
     ecs_world_t *world)
 {
@@ -202,7 +350,7 @@ void flecs_join_worker_threads(
 
     /* Signal threads should quit */
     world->flags |= EcsWorldQuitWorkers;
-    flecs_signal_workers(world);
+    flecs_signal_workers(world, count);
 
     /* Join all threads with main */
     for (i = 1; i < count; i ++) {
@@ -216,9 +364,327 @@ void flecs_join_worker_threads(
     }
 
     world->flags &= ~EcsWorldQuitWorkers;
+    world->workers_signaled = 0;
     ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Make sure there is a tasks element for each system in the pipeline. Called
+ * from the main thread while workers are not running. */
+void flecs_worker_tasks_update(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    if (!(world->flags & EcsWorldWorkStealing)) {
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&pq->systems);
+    if (ecs_vec_count(&pq->tasks) != count) {
+        flecs_worker_tasks_fini(pq);
+        ecs_vec_init_t(NULL, &pq->tasks, ecs_worker_tasks_t, count);
+        ecs_vec_set_min_count_zeromem_t(
+            NULL, &pq->tasks, ecs_worker_tasks_t, count);
+    }
+
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    for (i = 0; i < count; i ++) {
+        if (tasks[i].system != systems[i]) {
+            /* Schedule changed, invalidate tasks */
+            tasks[i].system = systems[i];
+            tasks[i].run = 0;
+        }
+    }
+}
+
+void flecs_worker_tasks_fini(
+    ecs_pipeline_state_t *pq)
+{
+    int32_t i, count = ecs_vec_count(&pq->tasks);
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    for (i = 0; i < count; i ++) {
+        ecs_vec_fini_t(NULL, &tasks[i].results, ecs_worker_result_t);
+        ecs_os_free(tasks[i].ranges);
+    }
+    ecs_vec_fini_t(NULL, &pq->tasks, ecs_worker_tasks_t);
+}
+
+/* Split up the results of a system into chunks, and divide the chunks evenly
+ * across the worker ranges. */
+static void flecs_worker_tasks_init(
+    ecs_world_t *world,
+    ecs_worker_tasks_t *tasks,
+    int32_t stage_count,
+    int32_t run)
+{
+    ecs_system_t *sys = tasks->system;
+    int32_t chunk_size = FLECS_WORKER_CHUNK_SIZE;
+    if (sys->chunking.chunk_size) {
+        chunk_size = sys->chunking.chunk_size;
+    }
+    if (chunk_size < sys->chunking.min_count) {
+        chunk_size = sys->chunking.min_count;
+    }
+    int32_t chunk_count = 0;
+
+    ecs_vec_clear(&tasks->results);
+
+    ecs_iter_t qit = ecs_query_iter(world, sys->query);
+#ifdef FLECS_CACHED_QUERIES
+    if (sys->group_id_set) {
+        ecs_iter_set_group(&qit, sys->group_id);
+    }
+#endif
+
+    while (ecs_query_next(&qit)) {
+        ecs_worker_result_t *r = ecs_vec_append_t(
+            NULL, &tasks->results, ecs_worker_result_t);
+        r->first_chunk = chunk_count;
+        r->count = qit.count;
+        if (qit.table && qit.count) {
+            chunk_count += (qit.count + chunk_size - 1) / chunk_size;
+        } else {
+            /* Results that don't iterate a table are processed as a whole */
+            chunk_count ++;
+        }
+    }
+
+    if (tasks->range_count != stage_count) {
+        tasks->ranges = ecs_os_realloc_n(
+            tasks->ranges, ecs_worker_range_t, stage_count);
+        tasks->range_count = stage_count;
+    }
+
+    int32_t i;
+    for (i = 0; i < stage_count; i ++) {
+        ecs_worker_range_t *r = &tasks->ranges[i];
+        int32_t first = (chunk_count * i) / stage_count;
+        int32_t last = (chunk_count * (i + 1)) / stage_count;
+        r->claimed = 0;
+        r->first = first;
+        r->count = last - first;
+    }
+
+    tasks->chunk_count = chunk_count;
+    tasks->chunk_size = chunk_size;
+    tasks->run = run;
+}
+
+/* Create the tasks for the multithreaded systems of the current op. This runs
+ * on the main thread before the workers are signaled, so that workers don't
+ * have to synchronize with each other to find out who creates the tasks. */
+void flecs_worker_tasks_build(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    int32_t stage_count = pq->worker_count;
+
+    if (!(world->flags & EcsWorldWorkStealing) || stage_count < 2) {
+        return;
+    }
+
+    /* Systems scheduled by the dependency graph don't use tasks */
+    if ((world->flags & EcsWorldDagScheduling) && !op->immediate &&
+        op->count > 1)
+    {
+        return;
+    }
+
+    /* World is readonly, so iterate the system queries with the main stage */
+    ecs_world_t *stage = ecs_get_stage(world, 0);
+    ecs_worker_tasks_t *tasks = ecs_vec_first_t(
+        &pq->tasks, ecs_worker_tasks_t);
+    int32_t i, last = op->offset + op->count;
+    for (i = pq->cur_i; i < last; i ++) {
+        flecs_worker_tasks_init(stage, &tasks[i], stage_count, pq->run_count);
+    }
+}
+
+/* Claim a chunk from the current range. If the range is empty, select the
+ * range with the most remaining chunks to steal from. */
+static int32_t flecs_worker_claim(
+    ecs_stage_t *stage,
+    ecs_worker_iter_t *iter)
+{
+    ecs_worker_tasks_t *tasks = iter->tasks;
+
+    do {
+        ecs_worker_range_t *r = &tasks->ranges[iter->victim];
+        if (ecs_os_aload(&r->claimed) < r->count) {
+            int32_t claimed = ecs_os_ainc(&r->claimed) - 1;
+            if (claimed < r->count) {
+                if (iter->victim != iter->index) {
+                    stage->worker_stats.steals ++;
+                }
+                stage->worker_stats.chunks ++;
+                return r->first + claimed;
+            }
+        }
+
+        int32_t i, victim = -1, max_remaining = 0;
+        for (i = 0; i < tasks->range_count; i ++) {
+            r = &tasks->ranges[i];
+            int32_t remaining = r->count - ecs_os_aload(&r->claimed);
+            if (remaining > max_remaining) {
+                max_remaining = remaining;
+                victim = i;
+            }
+        }
+
+        iter->victim = victim;
+    } while (iter->victim != -1);
+
+    stage->worker_stats.idle ++;
+    return -1;
+}
+
+/* Find index of result that contains chunk */
+static int32_t flecs_worker_result_for_chunk(
+    ecs_worker_tasks_t *tasks,
+    int32_t chunk)
+{
+    ecs_worker_result_t *results = ecs_vec_first_t(
+        &tasks->results, ecs_worker_result_t);
+    int32_t lo = 0, hi = ecs_vec_count(&tasks->results) - 1;
+    while (lo < hi) {
+        int32_t mid = (lo + hi + 1) / 2;
+        if (results[mid].first_chunk <= chunk) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/* Restart the chained query iterator. This happens when a worker steals a chunk
+ * for a result that the iterator has already passed. */
+static void flecs_worker_steal_restart(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_tasks_t *tasks = it->priv_.iter.worker.tasks;
+    ecs_iter_t prev = *chain_it;
+
+    ecs_iter_fini(chain_it);
+    *chain_it = ecs_query_iter(prev.world, prev.query);
+
+    /* Restore members that were set by the system runner */
+    chain_it->system = prev.system;
+    chain_it->delta_time = prev.delta_time;
+    chain_it->delta_system_time = prev.delta_system_time;
+    chain_it->param = prev.param;
+    chain_it->ctx = prev.ctx;
+    chain_it->callback_ctx = prev.callback_ctx;
+    chain_it->run_ctx = prev.run_ctx;
+
+#ifdef FLECS_CACHED_QUERIES
+    if (tasks->system->group_id_set) {
+        ecs_iter_set_group(chain_it, tasks->system->group_id);
+    }
+#else
+    (void)tasks;
+#endif
+
+    it->priv_.iter.worker.result = -1;
+}
+
+static bool flecs_worker_steal_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    ecs_worker_tasks_t *tasks = iter->tasks;
+    ecs_stage_t *stage = it->real_world->stages[iter->index];
+
+    int32_t chunk = flecs_worker_claim(stage, iter);
+    if (chunk == -1) {
+        /* Chained iterator was not depleted, clean it up */
+        ecs_iter_fini(chain_it);
+        iter->result = -2;
+        return false;
+    }
+
+    int32_t result = flecs_worker_result_for_chunk(tasks, chunk);
+    if (result < iter->result) {
+        flecs_worker_steal_restart(it);
+    }
+
+    while (iter->result < result) {
+        if (!ecs_iter_next(chain_it)) {
+            /* Query returned fewer results than when tasks were created, which
+             * can only happen if the world was modified while readonly. */
+            ecs_abort(ECS_INTERNAL_ERROR, NULL);
+        }
+        iter->result ++;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    ecs_worker_result_t *r = ecs_vec_get_t(
+        &tasks->results, ecs_worker_result_t, result);
+    if (!it->table || !r->count) {
+        return true;
+    }
+
+    int32_t first = (chunk - r->first_chunk) * tasks->chunk_size;
+    int32_t count = r->count - first;
+    if (count > tasks->chunk_size) {
+        count = tasks->chunk_size;
+    }
+
+    it->frame_offset += first;
+    it->offset += first;
+    it->count = count;
+    it->entities = &(ecs_table_entities(it->table)[it->offset]);
+
+    return true;
+}
+
+static void flecs_worker_steal_fini(
+    ecs_iter_t *it)
+{
+    ecs_assert(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    if (it->priv_.iter.worker.result != -2) {
+        ecs_iter_fini(it->chain_it);
+        it->priv_.iter.worker.result = -2;
+    }
+    it->chain_it = NULL;
+}
+
+ecs_iter_t flecs_worker_steal_iter(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    ecs_worker_tasks_t *tasks = ctx;
+    ecs_assert(tasks != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tasks->run == it->real_world->pq->run_count,
+        ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tasks->range_count == stage_count, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_iter_t result = *it;
+    result.priv_.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv_.iter.worker = (ecs_worker_iter_t){
+        .index = stage_index,
+        .count = stage_count,
+        .tasks = tasks,
+        .result = -1,
+        .victim = stage_index
+    };
+    result.next = flecs_worker_steal_next;
+    result.fini = flecs_worker_steal_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+
+    return result;
+}
+
 /* -- Private functions -- */
 void flecs_workers_progress(
     ecs_world_t *world,
@@ -264,6 +730,9 @@ static void flecs_set_threads_internal(
             if (world->sync_cond) {
                 ecs_os_cond_free(world->sync_cond);
             }
+            if (world->system_cond) {
+                ecs_os_cond_free(world->system_cond);
+            }
             if (world->sync_mutex) {
                 ecs_os_mutex_free(world->sync_mutex);
             }
@@ -275,6 +744,7 @@ static void flecs_set_threads_internal(
         if (threads > 1) {
             world->worker_cond = ecs_os_cond_new();
             world->sync_cond = ecs_os_cond_new();
+            world->system_cond = ecs_os_cond_new();
             world->sync_mutex = ecs_os_mutex_new();
             flecs_start_workers(world, threads);
         }
@@ -303,4 +773,208 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_work_stealing(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change work stealing while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldWorkStealing, enable);
+error:
+    return;
+}
+
+bool ecs_using_work_stealing(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldWorkStealing);
+error:
+    return false;
+}
+
+void ecs_set_dag_scheduling(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change scheduling while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldDagScheduling, enable);
+error:
+    return;
+}
+
+bool ecs_using_dag_scheduling(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldDagScheduling);
+error:
+    return false;
+}
+
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change parallel merge while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldParallelMerge, enable);
+error:
+    return;
+}
+
+bool ecs_using_parallel_merge(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldParallelMerge);
+error:
+    return false;
+}
+
+void ecs_set_worker_spin_count(
+    ecs_world_t *world,
+    int32_t spin_count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(spin_count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change spin count while world is in readonly mode");
+    world->worker_spin_count = spin_count;
+error:
+    return;
+}
+
+int32_t ecs_get_worker_spin_count(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_spin_count;
+error:
+    return 0;
+}
+
+void ecs_set_worker_min_cost(
+    ecs_world_t *world,
+    ecs_ftime_t min_cost)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(min_cost >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker cost while world is in readonly mode");
+    world->worker_min_cost = min_cost;
+error:
+    return;
+}
+
+ecs_ftime_t ecs_get_worker_min_cost(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_min_cost;
+error:
+    return 0;
+}
+
+void ecs_set_worker_cost_weight(
+    ecs_world_t *world,
+    ecs_ftime_t weight)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(weight > 0 && weight <= 1, ECS_INVALID_PARAMETER, 
+        "weight must be larger than 0 and not larger than 1");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker cost while world is in readonly mode");
+    world->worker_cost_weight = weight;
+error:
+    return;
+}
+
+ecs_ftime_t ecs_get_worker_cost_weight(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->worker_cost_weight;
+error:
+    return 0;
+}
+
+void ecs_set_worker_affinity(
+    ecs_world_t *world,
+    const int32_t *cpus,
+    int32_t count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || cpus != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change worker affinity while world is in readonly mode");
+
+    ecs_vec_set_count_t(NULL, &world->worker_affinity, int32_t, count);
+    if (count) {
+        ecs_os_memcpy_n(ecs_vec_first(&world->worker_affinity), cpus, 
+            int32_t, count);
+    }
+
+    ECS_BIT_COND(world->flags, EcsWorldWorkerAffinity, count != 0);
+
+    /* Pin threads that are already running. Workers are idle while the world
+     * is not readonly, so this doesn't interrupt running systems. */
+    int32_t i, stage_count = ecs_get_stage_count(world);
+    for (i = 1; i < stage_count; i ++) {
+        ecs_stage_t *stage = world->stages[i];
+        if (stage->thread) {
+            flecs_worker_set_affinity(world, stage, stage->thread);
+        }
+    }
+error:
+    return;
+}
+
+int32_t ecs_get_worker_affinity(
+    const ecs_world_t *world,
+    int32_t worker)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(worker >= 0, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+
+    if (worker == 0 || worker >= ecs_vec_count(&world->worker_affinity)) {
+        return -1;
+    }
+
+    return ecs_vec_get_t(&world->worker_affinity, int32_t, worker)[0];
+error:
+    return -1;
+}
+
+bool ecs_worker_stats_get(
+    const ecs_world_t *world,
+    int32_t worker,
+    ecs_worker_stats_t *stats)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(stats != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+
+    if (worker < 0 || worker >= world->stage_count) {
+        return false;
+    }
+
+    *stats = world->stages[worker]->worker_stats;
+    return true;
+error:
+    return false;
+}
+
 #endif
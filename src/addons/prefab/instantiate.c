@@ -161,6 +161,9 @@ static void flecs_instantiate_children(
     ecs_table_diff_t diff = { .added = {0}};
     diff.added.array = ecs_os_alloca_n(ecs_entity_t, type_count + 1);
     void **component_data = ecs_os_alloca_n(void*, type_count + 1);
+    void **gathered = ecs_os_alloca_n(void*, type_count);
+    ecs_size_t *gathered_sizes = ecs_os_alloca_n(ecs_size_t, type_count);
+    int32_t gathered_count = 0;
 
     /* Copy in component identifiers. Find the base index in the component
      * array, since we'll need this to replace the base with the instance id */
@@ -208,8 +211,24 @@ static void flecs_instantiate_children(
 
         int32_t column = ecs_table_type_to_column_index(child_table, i);
         if (column != -1) {
-            component_data[diff.added.count] = ecs_table_get_column(
-                child_table, column, child_range.offset);
+            ecs_column_t *c = &child_table->data.columns[column];
+            if (c->flags & EcsColumnSoA) {
+                /* Members of struct-of-arrays components are stored in 
+                 * separate arrays, gather them into regular values. */
+                ecs_size_t size = c->ti->size;
+                void *values = flecs_walloc(world, size * child_range.count);
+                for (j = 0; j < child_range.count; j ++) {
+                    flecs_table_soa_get(child_table, column, 
+                        child_range.offset + j, ECS_ELEM(values, size, j));
+                }
+                component_data[diff.added.count] = values;
+                gathered[gathered_count] = values;
+                gathered_sizes[gathered_count] = size * child_range.count;
+                gathered_count ++;
+            } else {
+                component_data[diff.added.count] = ecs_table_get_column(
+                    child_table, column, child_range.offset);
+            }
         } else {
             component_data[diff.added.count] = NULL;
         }
@@ -283,6 +302,10 @@ static void flecs_instantiate_children(
     const ecs_entity_t *i_children = flecs_bulk_new(world, i_table, child_ids,
         &diff.added, child_range.count, component_data, false, &child_row, &diff);
 
+    for (j = 0; j < gathered_count; j ++) {
+        flecs_wfree(world, gathered_sizes[j], gathered[j]);
+    }
+
     flecs_instantiate_sparse(
         world, &child_range, children, i_table, i_children, child_row, false);
 
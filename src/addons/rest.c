@@ -1142,6 +1142,10 @@ static void flecs_system_stats_to_json(
     }
 
     ECS_COUNTER_APPEND_T(reply, stats, time_spent, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_enqueued, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_discarded, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, commands_coalesced, stats->query.t, "");
+    ECS_COUNTER_APPEND_T(reply, stats, command_time, stats->query.t, "");
     ecs_strbuf_list_pop(reply, "}");
 }
 
@@ -1158,8 +1162,21 @@ static void flecs_sync_stats_to_json(
     ecs_strbuf_list_appendlit(&reply->body, "\"immediate\":");
     ecs_strbuf_appendbool(&reply->body, stats->immediate);
 
+    ecs_strbuf_list_appendlit(&reply->body, "\"worker_count\":");
+    ecs_strbuf_appendint(&reply->body, stats->worker_count);
+
     ECS_GAUGE_APPEND_T(&reply->body, stats, time_spent, pstats->t, "");
     ECS_GAUGE_APPEND_T(&reply->body, stats, commands_enqueued, pstats->t, "");
+    ECS_GAUGE_APPEND_T(&reply->body, stats, wait_time, pstats->t, "");
+
+    ecs_strbuf_list_appendlit(&reply->body, "\"wait_histogram\":");
+    ecs_strbuf_list_push(&reply->body, "[", ",");
+    int32_t i;
+    for (i = 0; i < FLECS_SYNC_WAIT_BUCKETS; i ++) {
+        ecs_strbuf_list_next(&reply->body);
+        ecs_strbuf_appendint(&reply->body, stats->wait_histogram[i]);
+    }
+    ecs_strbuf_list_pop(&reply->body, "]");
 
     ecs_strbuf_list_pop(&reply->body, "}");
 }
@@ -2019,15 +2036,16 @@ static void flecs_rest_on_commands(
         ecs_rest_cmd_sync_capture_t *sync = ecs_vec_append_t(
             NULL, &capture->syncs, ecs_rest_cmd_sync_capture_t);
 
-        int32_t i, count = ecs_vec_count(commands);
-        ecs_cmd_t *cmds = ecs_vec_first(commands);
+        int32_t cur, end = ecs_vec_count(commands);
+        ecs_cmd_t *cmd;
         sync->buf = ECS_STRBUF_INIT;
         ecs_strbuf_list_push(&sync->buf, "{", ",");
         ecs_strbuf_list_appendlit(&sync->buf, "\"commands\":");
             ecs_strbuf_list_push(&sync->buf, "[", ",");
-            for (i = 0; i < count; i ++) {
+            for (cur = 0; cur < end; cur += cmd->length) {
+                cmd = flecs_cmd_at(commands, cur);
                 ecs_strbuf_list_next(&sync->buf);
-                flecs_rest_cmd_to_json(world, &sync->buf, &cmds[i]);
+                flecs_rest_cmd_to_json(world, &sync->buf, cmd);
             }
             ecs_strbuf_list_pop(&sync->buf, "]");
 
@@ -449,6 +449,10 @@ void ecs_table_component_memory_get(
         
         result->bytes_table_components += used;
         result->bytes_table_components_unused += allocated - used;
+
+        if (column->flags & EcsColumnCold) {
+            result->bytes_cold_components += allocated;
+        }
     }
 
     result->instances += count * table->column_count;
@@ -573,6 +577,15 @@ void ecs_table_memory_get(
         result->bytes_dirty_state += 
             (column_count + 1) * ECS_SIZEOF(int32_t);
     }
+
+    if (table->_ && table->_->dirty_chunks) {
+        result->bytes_dirty_state += column_count * ECS_SIZEOF(ecs_vec_t);
+        int32_t i;
+        for (i = 0; i < column_count; i ++) {
+            result->bytes_dirty_state += ecs_vec_size(
+                &table->_->dirty_chunks[i]) * ECS_SIZEOF(int32_t);
+        }
+    }
     
     flecs_table_graph_edges_memory_get(&table->node.add, result);
     flecs_table_graph_edges_memory_get(&table->node.remove, result);
@@ -588,6 +601,8 @@ ecs_table_memory_t ecs_tables_memory_get(
     int32_t i, count = flecs_sparse_count(tables);
 
     result.count = count;
+    result.reclaimed_count = world->compaction_count;
+    result.reclaimed_bytes = world->compaction_bytes;
 
     result.bytes_table += 
         flecs_sparse_memory_get(tables, ECS_SIZEOF(ecs_table_t));
@@ -1037,8 +1052,7 @@ ecs_misc_memory_t ecs_misc_memory_get(
             ecs_commands_t *cmd = &stage->cmd_stack[j];
             
             /* Calculate queue memory (ecs_vec_t) */
-            result.bytes_commands += 
-                ecs_vec_size(&cmd->queue) * ECS_SIZEOF(ecs_cmd_t);
+            result.bytes_commands += ecs_vec_size(&cmd->queue);
             
             /* Calculate entries memory (ecs_sparse_t) */
             ecs_sparse_t *entries = &cmd->entries;
@@ -1199,7 +1213,8 @@ void flecs_stats_memory_register_reflection(
             { .name = "bytes_table_components", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_table_components_unused", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_toggle_bitset", .type = ecs_id(ecs_i32_t), .unit = unit },
-            { .name = "bytes_sparse_components", .type = ecs_id(ecs_i32_t), .unit = unit }
+            { .name = "bytes_sparse_components", .type = ecs_id(ecs_i32_t), .unit = unit },
+            { .name = "bytes_cold_components", .type = ecs_id(ecs_i32_t), .unit = unit }
         }
     });
 
@@ -1244,7 +1259,9 @@ void flecs_stats_memory_register_reflection(
             { .name = "bytes_column_map", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_component_map", .type = ecs_id(ecs_i32_t), .unit = unit },
             { .name = "bytes_dirty_state", .type = ecs_id(ecs_i32_t), .unit = unit },
-            { .name = "bytes_edges", .type = ecs_id(ecs_i32_t), .unit = unit }
+            { .name = "bytes_edges", .type = ecs_id(ecs_i32_t), .unit = unit },
+            { .name = "reclaimed_count", .type = ecs_id(ecs_i32_t) },
+            { .name = "reclaimed_bytes", .type = ecs_id(ecs_i64_t), .unit = unit }
         }
     });
 
@@ -431,6 +431,10 @@ bool ecs_system_stats_get(
     int32_t t = s->query.t;
 
     ECS_COUNTER_RECORD(&s->time_spent, t, ptr->time_spent);
+    ECS_COUNTER_RECORD(&s->commands_enqueued, t, ptr->commands_enqueued);
+    ECS_COUNTER_RECORD(&s->commands_discarded, t, ptr->commands_discarded);
+    ECS_COUNTER_RECORD(&s->commands_coalesced, t, ptr->commands_coalesced);
+    ECS_COUNTER_RECORD(&s->command_time, t, ptr->command_time);
 
     s->task = !(ptr->query->flags & EcsQueryMatchThis);
 
@@ -529,6 +533,11 @@ bool ecs_pipeline_stats_get(
         return false;
     }
 
+    s->system_count = sys_count;
+    s->active_system_count = active_sys_count;
+    s->rebuild_count = pq->rebuild_count;
+    s->patch_count = pq->patch_count;
+
     if (op) {
         ecs_entity_t *systems = NULL;
         if (pip_count) {
@@ -579,8 +588,12 @@ bool ecs_pipeline_stats_get(
                 ECS_COUNTER_RECORD(&el->time_spent, s->t, cur->time_spent);
                 ECS_COUNTER_RECORD(&el->commands_enqueued, s->t, 
                     cur->commands_enqueued);
+                ECS_COUNTER_RECORD(&el->wait_time, s->t, cur->wait_time);
+                ecs_os_memcpy_n(el->wait_histogram, cur->wait_histogram, 
+                    int64_t, FLECS_SYNC_WAIT_BUCKETS);
 
                 el->system_count = cur->count;
+                el->worker_count = cur->worker_count;
                 el->multi_threaded = cur->multi_threaded;
                 el->immediate = cur->immediate;
             }
@@ -611,6 +624,10 @@ void ecs_pipeline_stats_reduce(
     ecs_entity_t *dst_systems = ecs_vec_first_t(&dst->systems, ecs_entity_t);
     ecs_entity_t *src_systems = ecs_vec_first_t(&src->systems, ecs_entity_t);
     ecs_os_memcpy_n(dst_systems, src_systems, ecs_entity_t, system_count);
+    dst->system_count = src->system_count;
+    dst->active_system_count = src->active_system_count;
+    dst->rebuild_count = src->rebuild_count;
+    dst->patch_count = src->patch_count;
 
     int32_t i, sync_count = ecs_vec_count(&src->sync_points);
     ecs_vec_init_if_t(&dst->sync_points, ecs_sync_stats_t);
@@ -623,8 +640,11 @@ void ecs_pipeline_stats_reduce(
         flecs_stats_reduce(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, src->t);
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 
     dst->t = t_next(dst->t);
@@ -645,8 +665,11 @@ void ecs_pipeline_stats_reduce_last(
         flecs_stats_reduce_last(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, src->t, count);
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 
     dst->t = t_prev(dst->t);
@@ -671,6 +694,11 @@ void ecs_pipeline_stats_copy_last(
     ecs_pipeline_stats_t *dst,
     const ecs_pipeline_stats_t *src)
 {
+    dst->system_count = src->system_count;
+    dst->active_system_count = src->active_system_count;
+    dst->rebuild_count = src->rebuild_count;
+    dst->patch_count = src->patch_count;
+
     int32_t i, sync_count = ecs_vec_count(&src->sync_points);
     ecs_vec_init_if_t(&dst->sync_points, ecs_sync_stats_t);
     ecs_vec_set_min_count_zeromem_t(NULL, &dst->sync_points, ecs_sync_stats_t, sync_count);
@@ -683,8 +711,11 @@ void ecs_pipeline_stats_copy_last(
         flecs_stats_copy_last(ECS_METRIC_FIRST(dst_el), ECS_METRIC_LAST(dst_el),
             ECS_METRIC_FIRST(src_el), dst->t, t_next(src->t));
         dst_el->system_count = src_el->system_count;
+        dst_el->worker_count = src_el->worker_count;
         dst_el->multi_threaded = src_el->multi_threaded;
         dst_el->immediate = src_el->immediate;
+        ecs_os_memcpy_n(dst_el->wait_histogram, src_el->wait_histogram, 
+            int64_t, FLECS_SYNC_WAIT_BUCKETS);
     }
 }
 
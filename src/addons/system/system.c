@@ -27,7 +27,9 @@ ecs_entity_t flecs_run_system(
     int32_t stage_index,
     int32_t stage_count,    
     ecs_ftime_t delta_time,
-    void *param) 
+    void *param,
+    flecs_worker_iter_init_t worker_iter,
+    void *worker_iter_ctx)
 {
     flecs_poly_assert(world, ecs_world_t);
     ecs_ftime_t time_elapsed = delta_time;
@@ -100,7 +102,16 @@ ecs_entity_t flecs_run_system(
 #endif
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (worker_iter) {
+            wit = worker_iter(it, stage_index, stage_count, worker_iter_ctx);
+        } else if (system_data->chunking.min_count || 
+            system_data->chunking.chunk_size) 
+        {
+            wit = ecs_worker_iter_w_chunking(it, stage_index, stage_count, 
+                &system_data->chunking);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -179,7 +190,7 @@ ecs_entity_t ecs_run_worker(
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
         world, stage, system, system_data, stage_index, stage_count, 
-        delta_time, param);
+        delta_time, param, NULL, NULL);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -195,7 +206,8 @@ ecs_entity_t ecs_run(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, 0, 0, delta_time, param);
+        world, stage, system, system_data, 0, 0, delta_time, param, 
+        NULL, NULL);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -330,6 +342,10 @@ ecs_entity_t ecs_system_init(
 
     system->multi_threaded = desc->multi_threaded;
     system->immediate = desc->immediate;
+    system->pipelined = desc->pipelined;
+    if (!desc->chunking.disable) {
+        system->chunking = desc->chunking;
+    }
 
     system->name = ecs_get_path(world, entity);
 
@@ -443,6 +459,16 @@ ecs_entity_t ecs_system_update(
         system->immediate = desc->immediate;
     }
 
+    if (desc->pipelined) {
+        system->pipelined = desc->pipelined;
+    }
+
+    if (desc->chunking.disable) {
+        system->chunking = (ecs_worker_chunking_t){0};
+    } else if (desc->chunking.min_count || desc->chunking.chunk_size) {
+        system->chunking = desc->chunking;
+    }
+
     if (flecs_system_init_timer(world, entity, desc)) {
         return 0;
     }
@@ -15,6 +15,14 @@
 
 extern ecs_mixins_t ecs_system_t_mixins;
 
+/* Creates the iterator that divides the results of a multithreaded system
+ * across workers. When not provided, ecs_worker_iter() is used. */
+typedef ecs_iter_t (*flecs_worker_iter_init_t)(
+    const ecs_iter_t *it,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
 /* Internal function to run a system */
 ecs_entity_t flecs_run_system(
     ecs_world_t *world,
@@ -24,7 +32,9 @@ ecs_entity_t flecs_run_system(
     int32_t stage_current,
     int32_t stage_count,
     ecs_ftime_t delta_time,
-    void *param);
+    void *param,
+    flecs_worker_iter_init_t worker_iter,
+    void *worker_iter_ctx);
 
 #endif
 
@@ -671,6 +671,8 @@ void flecs_bootstrap(
     flecs_bootstrap_make_alive(world, EcsCanToggle);
     flecs_bootstrap_make_alive(world, EcsSparse);
     flecs_bootstrap_make_alive(world, EcsDontFragment);
+    flecs_bootstrap_make_alive(world, EcsCold);
+    flecs_bootstrap_make_alive(world, EcsStableOrder);
     flecs_bootstrap_make_alive(world, EcsObserver);
     flecs_bootstrap_make_alive(world, EcsPairIsTag);
 
@@ -783,6 +785,8 @@ void flecs_bootstrap(
     flecs_bootstrap_trait(world, EcsOnDeleteTarget);
     flecs_bootstrap_trait(world, EcsSparse);
     flecs_bootstrap_trait(world, EcsDontFragment);
+    flecs_bootstrap_trait(world, EcsCold);
+    flecs_bootstrap_trait(world, EcsStableOrder);
 
     flecs_bootstrap_tag(world, EcsRemove);
     flecs_bootstrap_tag(world, EcsDelete);
@@ -906,6 +910,26 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t cold_trait = { EcsIdCold, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsCold }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &cold_trait,
+        .global_observer = true
+    });
+
+    static ecs_on_trait_ctx_t stable_order_trait = { EcsIdStableOrder, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsStableOrder }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &stable_order_trait,
+        .global_observer = true
+    });
+
     ecs_observer(world, {
         .query.terms = {{ .id = EcsOrderedChildren }},
         .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
@@ -4,6 +4,7 @@
  */
 
 #include "private_api.h"
+#include "addons/system/system.h"
 
 static ecs_table_t* flecs_find_table_remove(
     ecs_world_t *world,
@@ -20,40 +21,111 @@ error:
     return NULL;
 }
 
+/* Payload size of command that stores a pointer */
+#define FLECS_CMD_PTR_SIZE ECS_SIZEOF(void*)
+
+/* Returns whether value can be stored inline in the command stream. Inline
+ * values move when the stream grows, so this is only allowed for values that
+ * are trivially copyable and don't need an address that is stable. */
+static bool flecs_cmd_can_inline(
+    const ecs_type_info_t *ti)
+{
+    return ti->size <= FLECS_CMD_INLINE_SIZE && 
+        ti->alignment <= ECS_SIZEOF(ecs_id_t) &&
+        !(ti->hooks.flags & (ECS_TYPE_HOOK_DTOR|ECS_TYPE_HOOK_COPY|
+            ECS_TYPE_HOOK_MOVE|ECS_TYPE_HOOK_COPY_CTOR|
+            ECS_TYPE_HOOK_MOVE_CTOR));
+}
+
+/* Return command value, or NULL if command has no (remaining) value */
+static void* flecs_cmd_value(
+    const ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValueInline) {
+        return ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else if (cmd->flags & EcsCmdValuePtr) {
+        return *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    }
+    return NULL;
+}
+
+static void flecs_cmd_set_ptr(
+    ecs_cmd_t *cmd,
+    void *ptr)
+{
+    ecs_assert(cmd->length >= ECS_SIZEOF(ecs_cmd_t) + FLECS_CMD_PTR_SIZE,
+        ECS_INTERNAL_ERROR, NULL);
+    *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t)) = ptr;
+    cmd->flags |= EcsCmdValuePtr;
+}
+
+/* Free value storage of command after value was moved out or destructed */
+static void flecs_cmd_free_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & (EcsCmdValuePtr|EcsCmdValueMoved)) {
+        void *ptr = *(void**)ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+        if (ptr) {
+            flecs_stack_free(ptr, cmd->size);
+        }
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline|EcsCmdValueMoved));
+}
+
+/* Mark value of command as moved out without freeing its storage, so that the
+ * storage can be freed later by the thread that owns the stage stack. */
+static void flecs_cmd_move_value(
+    ecs_cmd_t *cmd)
+{
+    if (cmd->flags & EcsCmdValuePtr) {
+        cmd->flags |= EcsCmdValueMoved;
+    }
+    cmd->flags &= ECS_CAST(ecs_flags16_t, 
+        ~(EcsCmdValuePtr|EcsCmdValueInline));
+}
+
 static ecs_cmd_t* flecs_cmd_new(
-    ecs_stage_t *stage)
+    ecs_stage_t *stage,
+    ecs_size_t payload)
 {
-    ecs_cmd_t *cmd = ecs_vec_append_t(&stage->allocator, &stage->cmd->queue, 
-        ecs_cmd_t);
-    cmd->is._1.value = NULL;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_size_t length = ECS_SIZEOF(ecs_cmd_t) + 
+        ECS_ALIGN(payload, ECS_SIZEOF(ecs_id_t));
+    ecs_cmd_t *cmd = ecs_vec_grow_t(&stage->allocator, &commands->queue, 
+        uint8_t, length);
     cmd->id = 0;
     cmd->next_for_entity = 0;
-    cmd->entry = NULL;
     cmd->system = stage->system;
+    cmd->size = 0;
+    cmd->length = flecs_ito(int16_t, length);
+    cmd->flags = 0;
+    commands->count ++;
     return cmd;
 }
 
 static ecs_cmd_t* flecs_cmd_new_batched(
     ecs_stage_t *stage, 
-    ecs_entity_t e)
+    ecs_entity_t e,
+    ecs_size_t payload)
 {
-    ecs_vec_t *cmds = &stage->cmd->queue;
+    ecs_commands_t *commands = stage->cmd;
+    ecs_vec_t *cmds = &commands->queue;
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
-        &stage->cmd->entries, ecs_cmd_entry_t, e);
+        &commands->entries, ecs_cmd_entry_t, e);
 
     int32_t cur = ecs_vec_count(cmds);
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, payload);
     bool is_new = false;
     if (entry) {
-        if (entry->first == -1) {
-            /* Existing but invalidated entry */
+        if (entry->epoch != commands->epoch) {
+            /* Existing entry from a queue that was already flushed */
             entry->first = cur;
-            cmd->entry = entry;
+            entry->epoch = commands->epoch;
         } else {
             int32_t last = entry->last;
-            ecs_cmd_t *arr = ecs_vec_first_t(cmds, ecs_cmd_t);
-            if (arr[last].entity == e) {
-                ecs_cmd_t *last_op = &arr[last];
+            ecs_cmd_t *last_op = flecs_cmd_at(cmds, last);
+            if (last_op->entity == e) {
                 last_op->next_for_entity = cur;
                 if (last == entry->first) {
                     /* Flip sign bit so flush logic can tell which command
@@ -71,9 +143,10 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     }
 
     if (is_new) {
-        cmd->entry = entry = flecs_sparse_ensure_fast_t(
-            &stage->cmd->entries, ecs_cmd_entry_t, e);
+        entry = flecs_sparse_ensure_fast_t(
+            &commands->entries, ecs_cmd_entry_t, e);
         entry->first = cur;
+        entry->epoch = commands->epoch;
     }
 
     entry->last = cur;
@@ -81,6 +154,32 @@ static ecs_cmd_t* flecs_cmd_new_batched(
     return cmd;
 }
 
+/* Create command with storage for a component value. If the value can be 
+ * stored inline, it is appended to the command record. Otherwise it is
+ * allocated from the stack allocator of the command queue. */
+static ecs_cmd_t* flecs_cmd_new_w_value(
+    ecs_stage_t *stage,
+    ecs_entity_t e,
+    const ecs_type_info_t *ti,
+    bool is_inline,
+    void **value_out)
+{
+    ecs_cmd_t *cmd;
+    if (is_inline) {
+        cmd = flecs_cmd_new_batched(stage, e, ti->size);
+        cmd->flags = EcsCmdValueInline;
+        *value_out = ECS_OFFSET(cmd, ECS_SIZEOF(ecs_cmd_t));
+    } else {
+        cmd = flecs_cmd_new_batched(stage, e, FLECS_CMD_PTR_SIZE);
+        *value_out = flecs_stack_alloc(
+            &stage->cmd->stack, ti->size, ti->alignment);
+        flecs_cmd_set_ptr(cmd, *value_out);
+    }
+
+    cmd->size = ti->size;
+    return cmd;
+}
+
 bool flecs_defer_begin(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -110,7 +209,7 @@ bool flecs_defer_modified(
     ecs_id_t id)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         if (cmd) {
             cmd->kind = EcsCmdModified;
             cmd->id = id;
@@ -128,11 +227,13 @@ bool flecs_defer_clone(
     bool clone_value)
 {   
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdClone;
         cmd->id = src;
         cmd->entity = entity;
-        cmd->is._1.clone_value = clone_value;
+        if (clone_value) {
+            cmd->flags |= EcsCmdCloneValue;
+        }
         return true;
     }
     return false;   
@@ -145,11 +246,11 @@ bool flecs_defer_path(
     const char *name)
 {
     if (stage->defer > 0) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdPath;
         cmd->entity = entity;
         cmd->id = parent;
-        cmd->is._1.value = ecs_os_strdup(name);
+        flecs_cmd_set_ptr(cmd, ecs_os_strdup(name));
         return true;
     }
     return false;
@@ -160,7 +261,7 @@ bool flecs_defer_delete(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdDelete;
         cmd->entity = entity;
         return true;
@@ -173,7 +274,7 @@ bool flecs_defer_clear(
     ecs_entity_t entity)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdClear;
         cmd->entity = entity;
         return true;
@@ -188,11 +289,13 @@ bool flecs_defer_on_delete_action(
     bool force_delete)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = EcsCmdOnDeleteAction;
         cmd->id = id;
         cmd->entity = action;
-        cmd->is._1.force_delete = force_delete;
+        if (force_delete) {
+            cmd->flags |= EcsCmdForceDelete;
+        }
         return true;
     }
     return false;
@@ -205,7 +308,7 @@ bool flecs_defer_enable(
     bool enable)
 {
     if (flecs_defer_cmd(stage)) {
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
         cmd->kind = enable ? EcsCmdEnable : EcsCmdDisable;
         cmd->entity = entity;
         cmd->id = id;
@@ -233,12 +336,12 @@ bool flecs_defer_bulk_new(
         *ids_out = ids;
 
         /* Store data in cmd */
-        ecs_cmd_t *cmd = flecs_cmd_new(stage);
+        ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
         cmd->kind = EcsCmdBulkNew;
         cmd->id = id;
-        cmd->is._n.entities = ids;
-        cmd->is._n.count = count;
+        cmd->size = count;
         cmd->entity = 0;
+        flecs_cmd_set_ptr(cmd, ids);
         return true;
     }
     return false;
@@ -251,7 +354,7 @@ bool flecs_defer_add(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         cmd->id = id;
         cmd->entity = entity;
@@ -267,7 +370,7 @@ bool flecs_defer_remove(
 {
     if (flecs_defer_cmd(stage)) {
         ecs_assert(id != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity); 
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0); 
         cmd->kind = EcsCmdRemove;
         cmd->id = id;
         cmd->entity = entity;
@@ -316,7 +419,23 @@ bool flecs_defer_remove(
                             ecs_assert(tr->column != -1,
                                 ECS_INTERNAL_ERROR, NULL);
                             ecs_ref_t *ref = &o->refs[tr->column];
-                            if (ref->entity) {
+                            if (ref->entity && ti->soa) {
+                                /* Struct-of-arrays components can't be 
+                                 * accessed with a ref, copy member-wise. */
+                                ecs_record_t *base_r = flecs_entities_get(
+                                    world, ref->entity);
+                                const ecs_table_record_t *base_tr = 
+                                    flecs_component_get_table(
+                                        cr, base_r->table);
+                                ecs_assert(base_tr != NULL, 
+                                    ECS_INTERNAL_ERROR, NULL);
+                                void *value = ecs_os_alloca(ti->size);
+                                flecs_table_soa_get(base_r->table, 
+                                    base_tr->column, 
+                                    ECS_RECORD_TO_ROW(base_r->row), value);
+                                flecs_table_soa_set(table, tr->column,
+                                    ECS_RECORD_TO_ROW(r->row), value);
+                            } else if (ref->entity) {
                                 void *dst = ECS_OFFSET(
                                     table->data.columns[tr->column].data,
                                     ti->size * ECS_RECORD_TO_ROW(r->row));
@@ -380,10 +499,6 @@ void* flecs_defer_emplace(
     ecs_size_t size,
     bool *is_new)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -393,22 +508,23 @@ void* flecs_defer_emplace(
         "provided component is not a type");
     ecs_assert(!size || size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
-    size = ti->size;
 
+    ecs_cmd_t *cmd;
     void *cmd_value = ptr.ptr;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
-        cmd_value = flecs_stack_alloc(stack, size, ti->alignment);
-
+        /* Value is returned to the application, so it can't be inlined */
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, false, &cmd_value);
         cmd->kind = EcsCmdEmplace;
-        cmd->is._1.size = size;
-        cmd->is._1.value = cmd_value;
         if (is_new) *is_new = true;
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
         if (is_new) *is_new = false;
     }
 
+    cmd->entity = entity;
+    cmd->id = id;
+
     return cmd_value;
 error:
     return NULL;
@@ -422,19 +538,19 @@ void* flecs_defer_find_cmd_value(
 {
     ecs_cmd_entry_t *entry = flecs_sparse_get_t(
         &stage->cmd->entries, ecs_cmd_entry_t, entity);
-    if (!entry || entry->first == -1) {
+    if (!entry || entry->epoch != stage->cmd->epoch) {
         return NULL;
     }
 
-    ecs_cmd_t *cmds = ecs_vec_first_t(&stage->cmd->queue, ecs_cmd_t);
-    if (cmds[entry->last].entity != entity) {
+    ecs_vec_t *cmds = &stage->cmd->queue;
+    if (flecs_cmd_at(cmds, entry->last)->entity != entity) {
         return NULL;
     }
 
-    void *result = NULL;
+    ecs_cmd_t *result = NULL;
     int32_t cur = entry->first;
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         switch(cmd->kind) {
         case EcsCmdSet:
         case EcsCmdSetDontFragment:
@@ -442,7 +558,7 @@ void* flecs_defer_find_cmd_value(
         case EcsCmdEnsure:
         case EcsCmdEnsureDontFragment:
             if (cmd->id == id) {
-                result = cmd->is._1.value;
+                result = cmd;
             }
             break;
         case EcsCmdRemove:
@@ -473,7 +589,22 @@ void* flecs_defer_find_cmd_value(
         cur = next < 0 ? -next : next;
     } while (cur);
 
-    return result;
+    if (!result) {
+        return NULL;
+    }
+
+    if (result->flags & EcsCmdValueInline) {
+        /* Value is returned to the application, which requires a stable 
+         * address. Move it out of the command stream. The record is large 
+         * enough to store the pointer in place of the value. */
+        void *value = flecs_stack_alloc(&stage->cmd->stack, result->size, 
+            ECS_SIZEOF(ecs_id_t));
+        ecs_os_memcpy(value, flecs_cmd_value(result), result->size);
+        result->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdValueInline);
+        flecs_cmd_set_ptr(result, value);
+    }
+
+    return flecs_cmd_value(result);
 }
 
 void* flecs_defer_ensure(
@@ -502,17 +633,14 @@ void* flecs_defer_ensure(
         }
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_table_t *table = r->table;
     if (!ptr.ptr) {
-        ecs_stack_t *stack = &stage->cmd->stack;
+        /* Value is returned to the application, so it can't be inlined */
+        ecs_cmd_t *cmd = flecs_cmd_new_w_value(
+            stage, entity, ti, false, &ptr.ptr);
         cmd->kind = EcsCmdEnsure;
-        cmd->is._1.size = size;
-        cmd->is._1.value = ptr.ptr = 
-            flecs_stack_alloc(stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Check if entity inherits component */
         void *base = NULL;
@@ -529,7 +657,10 @@ void* flecs_defer_ensure(
             flecs_type_info_copy_ctor(ptr.ptr, base, 1, ti);
         }
     } else {
+        ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAdd;
+        cmd->entity = entity;
+        cmd->id = id;
     }
 
     return ptr.ptr;
@@ -548,11 +679,6 @@ void* flecs_defer_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -571,24 +697,30 @@ void* flecs_defer_set(
         "mismatching size specified for component in ensure/emplace/set (%u vs %u)",
             size, ti->size);
 
+    /* The returned pointer is not used after the next command is inserted, 
+     * which allows for storing small values in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                 * that a preceding remove command doesn't cause the entity to
                 * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -597,13 +729,16 @@ void* flecs_defer_set(
     if (!ptr.ptr) {
         bool is_dont_fragment = 
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
         flecs_type_info_copy_ctor(ptr.ptr, value, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -631,11 +766,6 @@ void* flecs_defer_cpp_set(
     ecs_assert(value != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_cmd_t *cmd = flecs_cmd_new_batched(stage, entity);
-    ecs_assert(cmd != NULL, ECS_INTERNAL_ERROR, NULL);
-    cmd->entity = entity;
-    cmd->id = id;
-
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t ptr = flecs_defer_get_existing(
         world, entity, r, id, size);
@@ -646,24 +776,30 @@ void* flecs_defer_cpp_set(
     ecs_assert(size == ti->size, ECS_INVALID_PARAMETER,
         "mismatching size specified for component in ensure/emplace/set");
 
+    /* The C++ API assigns the value before inserting other commands, so 
+     * small trivially copyable values can be stored in the command stream. */
+    ecs_cmd_t *cmd;
+    bool is_inline = flecs_cmd_can_inline(ti);
+
     /* Handle trivial set command (no hooks, OnSet observers) */
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[id]) {
             if (!ptr.ptr) {
-                ptr.ptr = flecs_stack_alloc(
-                    &stage->cmd->stack, size, ti->alignment);
-                
                 /* No OnSet observers, so ensure is enough */
+                cmd = flecs_cmd_new_w_value(
+                    stage, entity, ti, is_inline, &ptr.ptr);
                 cmd->kind = EcsCmdEnsure;
-                cmd->is._1.size = size;
-                cmd->is._1.value = ptr.ptr;
             } else {
                 /* No OnSet observers, so the only thing we need to do is make sure
                  * that a preceding remove command doesn't cause the entity to
                  * end up without the component. */
+                cmd = flecs_cmd_new_batched(stage, entity, 0);
                 cmd->kind = EcsCmdAdd;
             }
 
+            cmd->entity = entity;
+            cmd->id = id;
+
             ecs_os_memcpy(ptr.ptr, value, size);
             return ptr.ptr;
         }
@@ -672,14 +808,17 @@ void* flecs_defer_cpp_set(
     if (!ptr.ptr) {
         bool is_dont_fragment =
             flecs_component_get_flags(world, id) & EcsIdDontFragment;
+        cmd = flecs_cmd_new_w_value(stage, entity, ti, is_inline, &ptr.ptr);
         cmd->kind = is_dont_fragment ? EcsCmdSetDontFragment : EcsCmdSet;
-        cmd->is._1.size = size;
-        ptr.ptr = cmd->is._1.value =
-            flecs_stack_alloc(&stage->cmd->stack, size, ti->alignment);
+        cmd->entity = entity;
+        cmd->id = id;
 
         flecs_type_info_ctor(ptr.ptr, 1, ti);
     } else {
+        cmd = flecs_cmd_new_batched(stage, entity, 0);
         cmd->kind = EcsCmdAddModified;
+        cmd->entity = entity;
+        cmd->id = id;
 
         /* Call on_replace hook before copying the new value. */
         if (ti->hooks.on_replace) {
@@ -721,7 +860,7 @@ void* flecs_defer_cpp_assign(
             world, r->table, entity, id, ptr.ptr, value, ptr.ti);
     }
 
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, 0);
     cmd->kind = EcsCmdModified;
     cmd->entity = entity;
     cmd->id = id;
@@ -734,7 +873,7 @@ void flecs_enqueue(
     ecs_stage_t *stage,
     ecs_event_desc_t *desc)
 {
-    ecs_cmd_t *cmd = flecs_cmd_new(stage);
+    ecs_cmd_t *cmd = flecs_cmd_new(stage, FLECS_CMD_PTR_SIZE);
     cmd->kind = EcsCmdEvent;
     cmd->entity = desc->entity;
 
@@ -753,8 +892,8 @@ void flecs_enqueue(
         desc_cmd->ids = NULL;
     }
 
-    cmd->is._1.value = desc_cmd;
-    cmd->is._1.size = ECS_SIZEOF(ecs_event_desc_t);
+    cmd->size = ECS_SIZEOF(ecs_event_desc_t);
+    flecs_cmd_set_ptr(cmd, desc_cmd);
 
     if (desc->param || desc->const_param) {
         ecs_assert(!(desc->const_param && desc->param), ECS_INVALID_PARAMETER, 
@@ -781,10 +920,10 @@ static void flecs_flush_bulk_new(
     ecs_world_t *world,
     ecs_cmd_t *cmd)
 {
-    ecs_entity_t *entities = cmd->is._n.entities;
+    ecs_entity_t *entities = flecs_cmd_value(cmd);
 
     if (cmd->id) {
-        int i, count = cmd->is._n.count;
+        int i, count = cmd->size;
         for (i = 0; i < count; i ++) {
             ecs_record_t *r = flecs_entities_ensure(world, entities[i]);
             if (!r->table) {
@@ -831,16 +970,16 @@ static void flecs_discard_cmd(
     ecs_cmd_t *cmd)
 {
     if (cmd->kind == EcsCmdBulkNew) {
-        ecs_os_free(cmd->is._n.entities);
+        ecs_os_free(flecs_cmd_value(cmd));
     } else if (cmd->kind == EcsCmdEvent) {
-        flecs_free_cmd_event(world, cmd->is._1.value);
+        flecs_free_cmd_event(world, flecs_cmd_value(cmd));
     } else {
         ecs_assert(cmd->kind != EcsCmdEvent, ECS_INTERNAL_ERROR, NULL);
-        void *value = cmd->is._1.value;
+        void *value = flecs_cmd_value(cmd);
         if (value) {
             flecs_dtor_value(world, cmd->id, value);
-            flecs_stack_free(value, cmd->is._1.size);
         }
+        flecs_cmd_free_value(cmd);
     }
 }
 
@@ -895,11 +1034,191 @@ static bool flecs_remove_invalid(
     return true;
 }
 
+/* Batch add/remove commands for consecutive entities in the same table. This
+ * is the common result of adding or removing a component for all entities
+ * returned by a query, and moves all entities to the new table in a single
+ * operation. Returns the offset of the first command after the batch, or 0 if
+ * no commands were batched. */
+static int32_t flecs_cmd_batch_range(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t start)
+{
+    ecs_cmd_t *cmd = flecs_cmd_at(cmds, start);
+    ecs_cmd_kind_t kind = cmd->kind;
+    ecs_id_t id = cmd->id;
+
+    if (kind != EcsCmdAdd && kind != EcsCmdRemove) {
+        return 0;
+    }
+
+    int32_t end = ecs_vec_count(cmds);
+    int32_t cur = start + cmd->length;
+    if (cur == end) {
+        return 0;
+    }
+
+    ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+    if (!r || !r->table) {
+        return 0;
+    }
+
+    ecs_table_t *table = r->table;
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    int32_t table_count = ecs_table_count(table);
+    int32_t batch_count = 1;
+
+    /* Find number of commands that can be batched */
+    for (; cur < end; cur += cmd->length) {
+        cmd = flecs_cmd_at(cmds, cur);
+        if (cmd->kind != kind || cmd->id != id || cmd->next_for_entity) {
+            break;
+        }
+
+        int32_t next_row = row + batch_count;
+        if (next_row >= table_count) {
+            break;
+        }
+
+        if (ecs_table_entities(table)[next_row] != cmd->entity) {
+            break;
+        }
+
+        batch_count ++;
+    }
+
+    if (batch_count < 2) {
+        return 0;
+    }
+
+    if (kind == EcsCmdAdd) {
+        ecs_id_t valid_id = id;
+        if (!flecs_remove_invalid(world, id, &valid_id) || !valid_id) {
+            /* Let regular command processing handle invalid ids */
+            return 0;
+        }
+    }
+
+    ecs_table_diff_t diff = ECS_TABLE_DIFF_INIT;
+    ecs_table_t *dst_table;
+    if (kind == EcsCmdAdd) {
+        dst_table = flecs_table_traverse_add(world, table, &id, &diff);
+    } else {
+        dst_table = flecs_table_traverse_remove(world, table, &id, &diff);
+    }
+
+    if (dst_table == table) {
+        /* Nothing to move, or non-fragmenting component */
+        return 0;
+    }
+
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, table, row, batch_count, dst_table, &diff, 0);
+    flecs_defer_end(world, world->stages[0]);
+
+    if (kind == EcsCmdAdd) {
+        world->info.cmd.add_count += batch_count;
+    } else {
+        world->info.cmd.remove_count += batch_count;
+    }
+
+    world->info.cmd.batched_entity_count += batch_count;
+    world->info.cmd.batched_command_count += batch_count;
+
+    return cur;
+}
+
+/* Returns whether the value of a set or ensure command can be moved into the
+ * storage of the destination table without first constructing it.
+ * This is possible for components that are added by the batch and that are
+ * stored in a regular table column. Components with an on_replace hook are
+ * excluded, as the hook is invoked with the existing value. Components with an
+ * on_add hook or OnAdd observers are excluded, as the hook is invoked by the
+ * commit before the value is moved into the storage. A component that
+ * the entity had before the batch is moved from the source table, even if it
+ * was removed and added again by the batch. The other components added by the
+ * batch are checked by flecs_cmd_batch_has_on_add(). */
+static bool flecs_cmd_can_emplace(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    ecs_table_t *table,
+    ecs_id_t id)
+{
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    if (!cr || (cr->flags & (EcsIdSparse|EcsIdDontFragment|EcsIdHasOnAdd))) {
+        return false;
+    }
+
+    const ecs_type_info_t *ti = cr->type_info;
+    if (!ti || ti->soa || ti->hooks.on_replace || ti->hooks.on_add ||
+        (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL)) 
+    {
+        return false;
+    }
+
+    return !flecs_component_get_table(cr, src_table) &&
+        !flecs_component_get_table(cr, table);
+}
+
+/* Returns whether a component added by the batch, other than the emplaced
+ * component, has an on_add hook or OnAdd observers. These can access the 
+ * emplaced component during the commit, before its value is moved into the
+ * storage, so the component must be constructed by the commit. */
+static bool flecs_cmd_batch_has_on_add(
+    ecs_world_t *world,
+    const ecs_type_t *added,
+    ecs_id_t emplace_id)
+{
+    int32_t i;
+    for (i = 0; i < added->count; i ++) {
+        ecs_id_t id = added->array[i];
+        if (id == emplace_id) {
+            continue;
+        }
+
+        if (flecs_id_flags_get(world, id) & EcsIdHasOnAdd) {
+            return true;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr && cr->type_info && cr->type_info->hooks.on_add) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Move value of command into the component storage that was not constructed
+ * when the entity was committed to its destination table. */
+static void flecs_cmd_batch_emplace(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *r,
+    ecs_cmd_t *cmd)
+{
+    flecs_component_ptr_t dst = flecs_get_mut(
+        world, entity, cmd->id, r, cmd->size);
+    if (!dst.ptr) {
+        /* Entity was deleted or moved by a hook, value will be discarded */
+        cmd->kind = EcsCmdSkip;
+        cmd->flags &= ECS_CAST(ecs_flags16_t, ~EcsCmdBatched);
+        return;
+    }
+
+    flecs_type_info_ctor_move_dtor(dst.ptr, flecs_cmd_value(cmd), 1, dst.ti);
+    flecs_cmd_free_value(cmd);
+
+    /* Same as for other batched set commands, only OnSet observers are left
+     * to be invoked. */
+    cmd->kind = (cmd->kind == EcsCmdSet) ? EcsCmdModified : EcsCmdSkip;
+}
+
 static void flecs_cmd_batch_for_entity(
     ecs_world_t *world,
     ecs_table_diff_builder_t *diff,
     ecs_entity_t entity,
-    ecs_cmd_t *cmds,
+    ecs_vec_t *cmds,
     int32_t start)
 {
     ecs_record_t *r = flecs_entities_get(world, entity);
@@ -915,8 +1234,14 @@ static void flecs_cmd_batch_for_entity(
     int32_t cur = start;
     int32_t next_for_entity;
 
+    /* The value of one set or ensure command in the batch can be moved into
+     * the storage of the destination table without first constructing it. */
+    ecs_id_t emplace_id = 0;
+    int32_t emplace_cmd = -1;
+    bool can_emplace = true;
+
     do {
-        ecs_cmd_t *cmd = &cmds[cur];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
         ecs_id_t id = cmd->id;
         next_for_entity = cmd->next_for_entity;
         if (next_for_entity < 0) {
@@ -967,6 +1292,7 @@ static void flecs_cmd_batch_for_entity(
         case EcsCmdAddModified:
             /* Add is batched, but keep Modified */
             cmd->kind = EcsCmdModified;
+            cmd->flags |= EcsCmdBatched;
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             break;
@@ -974,11 +1300,19 @@ static void flecs_cmd_batch_for_entity(
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         case EcsCmdSet:
         case EcsCmdEnsure: {
+            if (can_emplace && !emplace_id && 
+                flecs_cmd_can_emplace(world, start_table, table, id)) 
+            {
+                emplace_id = id;
+                emplace_cmd = cur;
+            }
             table = flecs_find_table_add(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
+            cmd->flags |= EcsCmdBatched;
             has_set = true;
             break;
         }
@@ -987,9 +1321,17 @@ static void flecs_cmd_batch_for_entity(
              * the constructor is not invoked for the component */
             break;
         case EcsCmdRemove: {
+            if (emplace_id && ecs_id_match(emplace_id, id)) {
+                /* Component is removed again. Values must be assigned in the
+                 * order of the commands, so construct it as usual. */
+                emplace_id = 0;
+                emplace_cmd = -1;
+                can_emplace = false;
+            }
             table = flecs_find_table_remove(world, table, id, diff);
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
             break;
         }
         case EcsCmdClear:
@@ -1004,6 +1346,10 @@ static void flecs_cmd_batch_for_entity(
             table = &world->store.root;
             world->info.cmd.batched_command_count ++;
             cmd->kind = EcsCmdSkip;
+            cmd->flags |= EcsCmdBatched;
+            emplace_id = 0;
+            emplace_cmd = -1;
+            can_emplace = false;
             break;
         case EcsCmdDelete:
             /* Entity is deleted, don't batch commands after the delete */
@@ -1035,12 +1381,34 @@ static void flecs_cmd_batch_for_entity(
     diff->added.array = NULL;
     diff->added.count = 0;
 
+    /* Set and ensure values of inherited components are initialized with the
+     * value of the base by the constructor, which invokes the on_set hook. */
+    if ((emplace_cmd != -1) && (table->flags & EcsTableHasIsA)) {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
+    /* Hooks of other added components must see a constructed value */
+    if ((emplace_cmd != -1) && 
+        flecs_cmd_batch_has_on_add(world, &added, emplace_id)) 
+    {
+        emplace_id = 0;
+        emplace_cmd = -1;
+    }
+
     /* Move entity to destination table in single operation */
     flecs_table_diff_build_noalloc(diff, &table_diff);
     flecs_defer_begin(world, world->stages[0]);
-    flecs_commit(world, entity, r, table, &table_diff, 0, 0);
+    flecs_commit(world, entity, r, table, &table_diff, emplace_id, 0);
     flecs_defer_end(world, world->stages[0]);
 
+    /* Move value into component storage that wasn't constructed by the commit
+     * before any hooks or observers can access it. */
+    if (emplace_cmd != -1) {
+        flecs_cmd_batch_emplace(
+            world, entity, r, flecs_cmd_at(cmds, emplace_cmd));
+    }
+
     /* If destination table has new sparse components, make sure they're created
      * for the entity. */
     if ((table_diff.added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) && added.count) {
@@ -1062,7 +1430,7 @@ static void flecs_cmd_batch_for_entity(
     if (has_set) {
         cur = start;
         do {
-            ecs_cmd_t *cmd = &cmds[cur];
+            ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
             next_for_entity = cmd->next_for_entity;
             if (next_for_entity < 0) {
                 next_for_entity *= -1;
@@ -1072,13 +1440,13 @@ static void flecs_cmd_batch_for_entity(
             case EcsCmdSet:
             case EcsCmdEnsure: {
                 flecs_component_ptr_t dst = flecs_get_mut(
-                    world, entity, cmd->id, r, cmd->is._1.size);
+                    world, entity, cmd->id, r, cmd->size);
 
                 /* It's possible that even though the component was set, the
                  * command queue also contained a remove command, so before we
                  * do anything ensure the entity actually has the component. */
                 if (dst.ptr) {
-                    void *ptr = cmd->is._1.value;
+                    void *ptr = flecs_cmd_value(cmd);
                     const ecs_type_info_t *ti = dst.ti;
                     if (ti->hooks.on_replace) {
                         ecs_table_t *prev_table = r->table;
@@ -1092,7 +1460,7 @@ static void flecs_cmd_batch_for_entity(
                         /* Refetch pointer as the hook could have grown the
                          * table or moved the entity to a different table. */
                         dst = flecs_get_mut(
-                            world, entity, cmd->id, r, cmd->is._1.size);
+                            world, entity, cmd->id, r, cmd->size);
                         if (!dst.ptr) {
                             cmd->kind = EcsCmdSkip;
                             break;
@@ -1105,8 +1473,7 @@ static void flecs_cmd_batch_for_entity(
                         flecs_type_info_dtor(ptr, 1, ti);
                     }
 
-                    flecs_stack_free(ptr, cmd->is._1.size);
-                    cmd->is._1.value = NULL;
+                    flecs_cmd_free_value(cmd);
 
                     if (cmd->kind == EcsCmdSet) {
                         /* A set operation is add + copy + modified. We just did
@@ -1175,99 +1542,895 @@ done:
     flecs_table_diff_builder_clear(diff);
 }
 
-/* Leave safe section. Run all deferred commands. */
-bool flecs_defer_end(
-    ecs_world_t *world,
-    ecs_stage_t *stage)
+/* Entity with commands that can be applied as part of a coalesced group */
+typedef struct ecs_cmd_coalesce_elem_t {
+    ecs_table_t *src;                /* Table of entity before flush */
+    ecs_table_t *dst;                /* Table of entity after flush */
+    int32_t first;                   /* Offset of first command for entity */
+    int32_t row;                     /* Row of entity in source table */
+} ecs_cmd_coalesce_elem_t;
+
+static int flecs_cmd_coalesce_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
 {
-    flecs_poly_assert(world, ecs_world_t);
-    flecs_poly_assert(stage, ecs_stage_t);
+    const ecs_cmd_coalesce_elem_t *e1 = ptr_1;
+    const ecs_cmd_coalesce_elem_t *e2 = ptr_2;
+    if (e1->src != e2->src) {
+        return (e1->src->id > e2->src->id) - (e1->src->id < e2->src->id);
+    }
+    if (e1->dst != e2->dst) {
+        return (e1->dst->id > e2->dst->id) - (e1->dst->id < e2->dst->id);
+    }
+    return (e1->first > e2->first) - (e1->first < e2->first);
+}
 
-    flecs_check_exclusive_world_access_write(world);
+static int flecs_cmd_coalesce_row_cmp(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    int32_t r1 = *(const int32_t*)ptr_1;
+    int32_t r2 = *(const int32_t*)ptr_2;
+    return (r1 > r2) - (r1 < r2);
+}
 
-    if (stage->defer < 0) {
-        /* Suspending defer makes it possible to do operations on the storage
-         * without flushing the commands in the queue */
-        return false;
-    }
+/* Commands that only change the table of an entity, and can be coalesced */
+static bool flecs_cmd_coalesce_kind(
+    ecs_cmd_kind_t kind)
+{
+    return kind == EcsCmdAdd || kind == EcsCmdRemove || 
+        kind == EcsCmdSet || kind == EcsCmdEnsure || 
+        kind == EcsCmdAddModified;
+}
 
-    ecs_assert(stage->defer > 0, ECS_INTERNAL_ERROR, NULL);
+/* Compute destination table of entity for the commands in its chain. Returns
+ * NULL if the commands for the entity can't be applied as part of a group. */
+static ecs_table_t* flecs_cmd_coalesce_dst(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    int32_t first,
+    int32_t segment_end,
+    ecs_table_t *src,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_table_t *table = src;
+    int32_t cur = first, next;
 
-    if (!--stage->defer && !stage->cmd_flushing) {
-        ecs_os_perf_trace_push("flecs.commands.merge");
+    flecs_table_diff_builder_clear(diff);
+    diff->added_flags = 0;
+    diff->removed_flags = 0;
 
-        /* Test whether we're flushing to another queue or whether we're 
-         * flushing to the storage */
-        bool merge_to_world = false;
-        if (flecs_poly_is(world, ecs_world_t)) {
-            merge_to_world = world->stages[0]->defer == 0;
+    do {
+        if (cur >= segment_end) {
+            /* Entity has commands outside of segment */
+            return NULL;
         }
 
-        do {
-            ecs_stage_t *dst_stage = flecs_stage_from_world(&world);
-            ecs_commands_t *commands = stage->cmd;
-            ecs_vec_t *queue = &commands->queue;
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_cmd_kind_t kind = cmd->kind;
+        ecs_id_t id = cmd->id, valid_id = id;
+        if (!flecs_cmd_coalesce_kind(kind)) {
+            return NULL;
+        }
 
-            if (stage->cmd == &stage->cmd_stack[0]) {
-                stage->cmd = &stage->cmd_stack[1];
-            } else {
-                stage->cmd = &stage->cmd_stack[0];
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (cr) {
+            if (cr->flags & (EcsIdSparse|EcsIdDontFragment)) {
+                return NULL;
             }
+        }
 
-            if (!ecs_vec_count(queue)) {
-                break;
+        if (kind == EcsCmdSet || kind == EcsCmdEnsure) {
+            if (!cr || !cr->type_info || !flecs_cmd_value(cmd)) {
+                return NULL;
             }
-
-            stage->cmd_flushing = true;
-
-            /* Internal callback for capturing commands */
-            if (world->on_commands_active) {
-                world->on_commands_active(stage, queue, 
-                    world->on_commands_ctx_active);
+            if (cr->type_info->hooks.on_replace) {
+                return NULL;
             }
+        }
 
-            ecs_cmd_t *cmds = ecs_vec_first(queue);
-            int32_t i, count = ecs_vec_count(queue);
-
-            ecs_table_diff_builder_t diff = {0};
-            bool diff_builder_used = false;
+        if (!flecs_remove_invalid(world, id, &valid_id) || valid_id != id) {
+            /* Let regular command processing run cleanup actions */
+            return NULL;
+        }
 
-            for (i = 0; i < count; i ++) {
-                ecs_cmd_t *cmd = &cmds[i];
-                ecs_entity_t e = cmd->entity;
-                bool is_alive = flecs_entities_is_alive(world, e);
+        if (kind == EcsCmdRemove) {
+            table = flecs_find_table_remove(world, table, id, diff);
+        } else {
+            table = flecs_find_table_add(world, table, id, diff);
+        }
 
-                /* A negative index indicates the first command for an entity */
-                if (merge_to_world && (cmd->next_for_entity < 0)) {
-                    diff.added_flags = 0;
-                    diff.removed_flags = 0;
+        if (!table) {
+            return NULL;
+        }
 
-                    /* Batch commands for entity to limit archetype moves */
-                    if (is_alive) {
-                        if (!diff_builder_used) {
-                            flecs_table_diff_builder_init(world, &diff);
-                            diff_builder_used = true;
-                        }
+        next = cmd->next_for_entity;
+        if (next < 0) {
+            next *= -1;
+        }
+    } while ((cur = next));
 
-                        flecs_cmd_batch_for_entity(world, &diff, e, cmds, i);
+    if (table == src) {
+        return NULL;
+    }
 
-                        is_alive = flecs_entities_is_alive(world, e);
-                    } else {
-                        world->info.cmd.discard_count ++;
-                    }
-                }
+    if (diff->added_flags & (EcsTableHasSparse|EcsTableHasDontFragment)) {
+        return NULL;
+    }
 
-                /* Invalidate entry */
-                if (cmd->entry) {
-                    cmd->entry->first = -1;
-                }
+    return table;
+}
+
+static bool flecs_cmd_coalesce_diff_eq(
+    const ecs_table_diff_builder_t *d1,
+    const ecs_table_diff_builder_t *d2)
+{
+    if (d1->added_flags != d2->added_flags || 
+        d1->removed_flags != d2->removed_flags) 
+    {
+        return false;
+    }
+
+    int32_t added = ecs_vec_count(&d1->added);
+    int32_t removed = ecs_vec_count(&d1->removed);
+    if (added != ecs_vec_count(&d2->added) || 
+        removed != ecs_vec_count(&d2->removed)) 
+    {
+        return false;
+    }
+
+    if (added && ecs_os_memcmp(ecs_vec_first(&d1->added), 
+        ecs_vec_first(&d2->added), ECS_SIZEOF(ecs_id_t) * added)) 
+    {
+        return false;
+    }
+
+    if (removed && ecs_os_memcmp(ecs_vec_first(&d1->removed), 
+        ecs_vec_first(&d2->removed), ECS_SIZEOF(ecs_id_t) * removed)) 
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* Apply commands for a group of entities that move from the same source table
+ * to the same destination table. The entities are moved to the end of the
+ * source table, so that they can be moved to the destination table with a
+ * single range operation. */
+static void flecs_cmd_coalesce_group(
+    ecs_world_t *world,
+    ecs_vec_t *cmds,
+    ecs_cmd_coalesce_elem_t *elems,
+    int32_t elem_count,
+    int32_t segment_end,
+    ecs_table_diff_builder_t *diff,
+    ecs_table_diff_builder_t *tmp,
+    ecs_vec_t *rows)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_t *src = elems[0].src, *dst = elems[0].dst;
+    int32_t i, count = 0;
+
+    ecs_vec_clear(rows);
+
+    /* Observers and hooks of previous groups can't change the tables of 
+     * entities since they're deferred, but can have moved rows. Also make
+     * sure the diff of each entity matches, since the same destination can
+     * be reached with different sequences of commands. */
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, elem->first);
+        ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+        if (r->table != src) {
+            elem->src = NULL;
+            continue;
+        }
+
+        ecs_table_diff_builder_t *elem_diff = count ? tmp : diff;
+        if (flecs_cmd_coalesce_dst(world, cmds, elem->first, segment_end, 
+            src, elem_diff) != dst) 
+        {
+            elem->src = NULL;
+            continue;
+        }
+
+        if (count && !flecs_cmd_coalesce_diff_eq(diff, tmp)) {
+            elem->src = NULL;
+            continue;
+        }
+
+        elem->row = ECS_RECORD_TO_ROW(r->row);
+        ecs_vec_append_t(a, rows, int32_t)[0] = elem->row;
+        count ++;
+    }
+
+    if (count < 2) {
+        /* Let regular command processing handle remaining entities */
+        flecs_table_diff_builder_clear(diff);
+        return;
+    }
+
+    /* Swap entities that aren't in the last count rows of the table with rows
+     * that don't belong to the group. */
+    int32_t *row_array = ecs_vec_first_t(rows, int32_t);
+    qsort(row_array, flecs_itosize(count), sizeof(int32_t), 
+        flecs_cmd_coalesce_row_cmp);
+
+    int32_t tail = ecs_table_count(src) - count;
+    int32_t outside = 0;
+    while (outside < count && row_array[outside] < tail) {
+        outside ++;
+    }
+
+    int32_t swap_row = tail, tail_member = outside;
+    for (i = 0; i < outside; i ++) {
+        while (tail_member < count && row_array[tail_member] == swap_row) {
+            tail_member ++;
+            swap_row ++;
+        }
+        ecs_table_swap_rows(world, src, row_array[i], swap_row);
+        swap_row ++;
+    }
+
+    /* Save added ids and clear from diff so that they won't be emitted as
+     * part of the commit, same as for a single entity. */
+    ecs_table_diff_t table_diff;
+    ecs_type_t added = { diff->added.array, diff->added.count };
+    diff->added.array = NULL;
+    diff->added.count = 0;
+    flecs_table_diff_build_noalloc(diff, &table_diff);
+
+    int32_t dst_row = ecs_table_count(dst);
+    flecs_defer_begin(world, world->stages[0]);
+    flecs_commit_range(world, src, tail, count, dst, &table_diff, 0);
+    flecs_defer_end(world, world->stages[0]);
+
+    /* Assign values of set commands before OnAdd observers are invoked */
+    int32_t cmd_count = 0;
+    for (i = 0; i < elem_count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elems[i];
+        if (!elem->src) {
+            continue;
+        }
+
+        int32_t cur = elem->first, next;
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        ecs_entity_t e = cmd->entity;
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r->table == dst, ECS_INTERNAL_ERROR, NULL);
+
+        /* Prevent entity from being batched again */
+        if (cmd->next_for_entity < 0) {
+            cmd->next_for_entity *= -1;
+        }
+
+        do {
+            cmd = flecs_cmd_at(cmds, cur);
+            next = cmd->next_for_entity;
+            cmd_count ++;
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure: {
+                flecs_component_ptr_t ptr = flecs_get_mut(
+                    world, e, cmd->id, r, cmd->size);
+                if (ptr.ptr) {
+                    void *value = flecs_cmd_value(cmd);
+                    const ecs_type_info_t *ti = ptr.ti;
+                    bool move_hook = ti->hooks.move != NULL;
+                    flecs_type_info_move(ptr.ptr, value, 1, ti);
+                    if (move_hook) {
+                        flecs_type_info_dtor(value, 1, ti);
+                    }
+                    flecs_cmd_free_value(cmd);
+                    cmd->kind = (cmd->kind == EcsCmdSet) ? 
+                        EcsCmdModified : EcsCmdSkip;
+                    cmd->flags |= EcsCmdBatched;
+                } else {
+                    /* Component was removed by a later command */
+                    cmd->kind = EcsCmdSkip;
+                }
+                break;
+            }
+            case EcsCmdAddModified:
+                cmd->kind = EcsCmdModified;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+                cmd->kind = EcsCmdSkip;
+                cmd->flags |= EcsCmdBatched;
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            case EcsCmdSkip:
+                ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+                break;
+            }
+        } while ((cur = next));
+    }
+
+    /* Emit OnAdd events for all entities in the group in a single batch */
+    if (added.count) {
+        ecs_table_diff_t add_diff = ECS_TABLE_DIFF_INIT;
+        add_diff.added = added;
+        add_diff.added_flags = table_diff.added_flags;
+
+        bool update_parent_records = !table_diff.removed.count ||
+            !(src->flags & EcsTableHasParent);
+
+        flecs_defer_begin(world, world->stages[0]);
+        flecs_actions_move_add(world, dst, src, dst_row, count, &add_diff, 
+            0, false, 0, update_parent_records);
+        flecs_defer_end(world, world->stages[0]);
+    }
+
+    diff->added.array = added.array;
+    diff->added.count = added.count;
+    flecs_table_diff_builder_clear(diff);
+
+    world->info.cmd.batched_entity_count += count;
+    world->info.cmd.batched_command_count += cmd_count;
+}
+
+/* Coalesce table changes for the segment of add/remove/set commands that 
+ * starts at the specified offset. The destination table of each entity in the
+ * segment is computed first, after which entities are sorted by (source, 
+ * destination) table. Each group of entities with the same table transition 
+ * is then moved in a single operation, with a single OnAdd/OnRemove batch.
+ * Returns the offset of the first command after the segment. */
+static int32_t flecs_cmd_coalesce(
+    ecs_world_t *world,
+    ecs_commands_t *commands,
+    int32_t start,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_vec_t *cmds = &commands->queue;
+    int32_t cur, end = ecs_vec_count(cmds);
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t elems;
+    ecs_vec_init_t(a, &elems, ecs_cmd_coalesce_elem_t, 0);
+
+    for (cur = start; cur < end; cur += flecs_cmd_at(cmds, cur)->length) {
+        ecs_cmd_t *cmd = flecs_cmd_at(cmds, cur);
+        if (!flecs_cmd_coalesce_kind(cmd->kind)) {
+            break;
+        }
+
+        if (cmd->next_for_entity > 0) {
+            /* Not the first command for the entity */
+            continue;
+        }
+
+        if (!cmd->next_for_entity) {
+            /* Either the only command for the entity, or the last command of
+             * a chain. */
+            ecs_cmd_entry_t *entry = flecs_sparse_get_t(
+                &commands->entries, ecs_cmd_entry_t, cmd->entity);
+            if (!entry || entry->epoch != commands->epoch || 
+                entry->first != cur) 
+            {
+                continue;
+            }
+        }
+
+        ecs_record_t *r = flecs_entities_try(world, cmd->entity);
+        if (!r || !r->table) {
+            continue;
+        }
+
+        if (r->table->_->stable_order) {
+            /* Moving rows around would change the order of the table */
+            continue;
+        }
+
+        ecs_cmd_coalesce_elem_t *elem = ecs_vec_append_t(
+            a, &elems, ecs_cmd_coalesce_elem_t);
+        elem->src = r->table;
+        elem->dst = NULL;
+        elem->first = cur;
+        elem->row = 0;
+    }
+
+    int32_t segment_end = cur;
+    int32_t i, count = ecs_vec_count(&elems);
+    if (count < 2) {
+        goto done;
+    }
+
+    ecs_cmd_coalesce_elem_t *elem_array = ecs_vec_first(&elems);
+
+    /* Find destination table of each entity */
+    int32_t valid_count = 0;
+    for (i = 0; i < count; i ++) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        elem->dst = flecs_cmd_coalesce_dst(world, cmds, elem->first, 
+            segment_end, elem->src, diff);
+        if (elem->dst) {
+            elem_array[valid_count ++] = *elem;
+        }
+    }
+
+    flecs_table_diff_builder_clear(diff);
+
+    if (valid_count < 2) {
+        goto done;
+    }
+
+    qsort(elem_array, flecs_itosize(valid_count), 
+        sizeof(ecs_cmd_coalesce_elem_t), flecs_cmd_coalesce_cmp);
+
+    ecs_table_diff_builder_t tmp;
+    flecs_table_diff_builder_init(world, &tmp);
+    ecs_vec_t rows;
+    ecs_vec_init_t(a, &rows, int32_t, 0);
+
+    for (i = 0; i < valid_count; ) {
+        ecs_cmd_coalesce_elem_t *elem = &elem_array[i];
+        int32_t j = i + 1;
+        while (j < valid_count && elem_array[j].src == elem->src && 
+            elem_array[j].dst == elem->dst) 
+        {
+            j ++;
+        }
+
+        if ((j - i) > 1) {
+            flecs_cmd_coalesce_group(world, cmds, elem, j - i, segment_end,
+                diff, &tmp, &rows);
+        }
+
+        i = j;
+    }
+
+    ecs_vec_fini_t(a, &rows, int32_t);
+    flecs_table_diff_builder_fini(world, &tmp);
+done:
+    ecs_vec_fini_t(a, &elems, ecs_cmd_coalesce_elem_t);
+    return segment_end;
+}
+
+/* Marks entity that can't be merged in place */
+#define FLECS_CMD_NOT_INPLACE (UINT64_MAX)
+
+/* Return pointer to storage of a component that a set/ensure command can be
+ * applied to without changing the table of the entity. */
+static flecs_component_ptr_t flecs_cmd_inplace_ptr(
+    ecs_world_t *world,
+    const ecs_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+    if (!id || !flecs_cmd_value(cmd) || !flecs_entities_is_alive(world, e)) {
+        return (flecs_component_ptr_t){0};
+    }
+
+    if (id >= FLECS_HI_COMPONENT_ID || world->non_trivial_lookup[id]) {
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        if (!cr || (cr->flags & (EcsIdDontFragment|EcsIdSparse))) {
+            return (flecs_component_ptr_t){0};
+        }
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    flecs_component_ptr_t ptr = flecs_get_mut(world, e, id, r, cmd->size);
+    if (ptr.ptr && ptr.ti->hooks.on_replace) {
+        /* Hook must be invoked in merge order */
+        return (flecs_component_ptr_t){0};
+    }
+
+    return ptr;
+}
+
+/* Find entities owned by worker for which all commands can be merged in 
+ * place. This is the case if all commands for the entity are in the same 
+ * stage, and only assign components the entity already has. */
+static void flecs_cmd_find_inplace(
+    ecs_world_t *world,
+    ecs_map_t *entities,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+
+            if (cmd->kind == EcsCmdClone && 
+                ((uint32_t)cmd->id % (uint32_t)worker_count) == 
+                    (uint32_t)worker_index) 
+            {
+                /* Clone must copy the value of the source entity as it was at
+                 * this point in the merge. */
+                ecs_map_ensure(entities, cmd->id)[0] = FLECS_CMD_NOT_INPLACE;
+            }
+
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(entities, e);
+            if (*v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Commands for entity in multiple stages */
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            switch(cmd->kind) {
+            case EcsCmdSet:
+            case EcsCmdEnsure:
+                if (!flecs_cmd_inplace_ptr(world, cmd).ptr) {
+                    *v = FLECS_CMD_NOT_INPLACE;
+                    continue;
+                }
+                break;
+            case EcsCmdModified:
+            case EcsCmdModifiedNoHook:
+            case EcsCmdSkip:
+                break;
+            case EcsCmdClone:
+            case EcsCmdBulkNew:
+            case EcsCmdAdd:
+            case EcsCmdRemove:
+            case EcsCmdSetDontFragment:
+            case EcsCmdEmplace:
+            case EcsCmdEnsureDontFragment:
+            case EcsCmdAddModified:
+            case EcsCmdPath:
+            case EcsCmdDelete:
+            case EcsCmdClear:
+            case EcsCmdOnDeleteAction:
+            case EcsCmdEnable:
+            case EcsCmdDisable:
+            case EcsCmdEvent:
+            default:
+                *v = FLECS_CMD_NOT_INPLACE;
+                continue;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+}
+
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world)
+{
+    bool result = true;
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count && result; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+
+            /* Deleting an entity can cascade to other entities, or remove a
+             * component from entities that are assigned in place, which would
+             * change the order in which commands are applied. */
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind == EcsCmdDelete || kind == EcsCmdClear || 
+                kind == EcsCmdOnDeleteAction) 
+            {
+                result = false;
+                break;
+            }
+
+            ecs_entity_t e = cmd->entity;
+            if (!e) {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_ensure(&entities, e);
+            if (*v && *v != (ecs_map_val_t)(s + 1)) {
+                /* Entity is used by commands in multiple stages */
+                result = false;
+                break;
+            }
+
+            *v = (ecs_map_val_t)(s + 1);
+        }
+    }
+
+    ecs_map_fini(&entities);
+    return result;
+}
+
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count)
+{
+    ecs_assert(worker_count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(worker_index < worker_count, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_map_t entities;
+    ecs_map_init(&entities, &stage->allocator);
+    flecs_cmd_find_inplace(world, &entities, worker_index, worker_count);
+
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        ecs_vec_t *queue = &world->stages[s]->cmd->queue;
+        int32_t cur, end = ecs_vec_count(queue);
+        ecs_cmd_t *cmd;
+
+        for (cur = 0; cur < end; cur += cmd->length) {
+            cmd = flecs_cmd_at(queue, cur);
+            ecs_entity_t e = cmd->entity;
+            if (!e || ((uint32_t)e % (uint32_t)worker_count) != 
+                (uint32_t)worker_index) 
+            {
+                continue;
+            }
+
+            ecs_map_val_t *v = ecs_map_get(&entities, e);
+            if (!v || *v == FLECS_CMD_NOT_INPLACE) {
+                continue;
+            }
+
+            /* Commands no longer change the table, so entity doesn't need to
+             * be batched by the regular merge. */
+            if (cmd->next_for_entity < 0) {
+                cmd->next_for_entity *= -1;
+            }
+
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind != EcsCmdSet && kind != EcsCmdEnsure) {
+                continue;
+            }
+
+            flecs_component_ptr_t dst = flecs_cmd_inplace_ptr(world, cmd);
+            ecs_assert(dst.ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            void *ptr = flecs_cmd_value(cmd);
+            const ecs_type_info_t *ti = dst.ti;
+            bool move_hook = ti->hooks.move != NULL;
+            flecs_type_info_move(dst.ptr, ptr, 1, ti);
+            if (move_hook) {
+                flecs_type_info_dtor(ptr, 1, ti);
+            }
+
+            /* Stage stacks are not thread safe, so value storage is freed by
+             * the main thread in the regular merge. */
+            flecs_cmd_move_value(cmd);
+
+            /* Same as for batched set commands, the only thing left to do for
+             * a set is to invoke OnSet observers in the regular merge. */
+            if (kind == EcsCmdSet) {
+                cmd->kind = EcsCmdModified;
+            } else {
+                cmd->kind = EcsCmdSkip;
+            }
+
+            cmd->flags |= EcsCmdBatched;
+        }
+    }
+
+    ecs_map_fini(&entities);
+}
+
+/* Command statistics for a sequence of commands enqueued by the same system */
+typedef struct ecs_cmd_system_stats_t {
+    ecs_entity_t system;             /* System that enqueued the commands */
+    int32_t enqueued;                /* Number of commands in sequence */
+    int32_t discarded;               /* Commands that were not applied */
+    int32_t coalesced;               /* Commands applied as part of a batch */
+    ecs_time_t start;                /* Time at start of sequence */
+} ecs_cmd_system_stats_t;
+
+/* Add statistics for a sequence of commands to the system that enqueued them,
+ * and start a new sequence for the next system. */
+static void flecs_cmd_system_stats_flush(
+    ecs_world_t *world,
+    ecs_cmd_system_stats_t *stats,
+    ecs_entity_t next_system)
+{
+    double time_spent = ecs_time_measure(&stats->start);
+
+#ifdef FLECS_SYSTEM
+    ecs_entity_t system = stats->system;
+    if (system && flecs_entities_is_alive(world, system)) {
+        /* Commands can also be enqueued by observers, which are ignored */
+        ecs_system_t *ptr = flecs_poly_get(world, system, ecs_system_t);
+        if (ptr) {
+            ptr->commands_enqueued += stats->enqueued;
+            ptr->commands_discarded += stats->discarded;
+            ptr->commands_coalesced += stats->coalesced;
+            ptr->command_time += (ecs_ftime_t)time_spent;
+        }
+    }
+#else
+    (void)world;
+    (void)time_spent;
+#endif
+
+    stats->system = next_system;
+    stats->enqueued = 0;
+    stats->discarded = 0;
+    stats->coalesced = 0;
+}
+
+/* Leave safe section. Run all deferred commands. */
+bool flecs_defer_end(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    flecs_poly_assert(stage, ecs_stage_t);
+
+    flecs_check_exclusive_world_access_write(world);
+
+    if (stage->defer < 0) {
+        /* Suspending defer makes it possible to do operations on the storage
+         * without flushing the commands in the queue */
+        return false;
+    }
+
+    ecs_assert(stage->defer > 0, ECS_INTERNAL_ERROR, NULL);
+
+    if (!--stage->defer && !stage->cmd_flushing) {
+        ecs_os_perf_trace_push("flecs.commands.merge");
+
+        /* Test whether we're flushing to another queue or whether we're 
+         * flushing to the storage */
+        bool merge_to_world = false;
+        if (flecs_poly_is(world, ecs_world_t)) {
+            merge_to_world = world->stages[0]->defer == 0;
+        }
+
+        if (merge_to_world) {
+            /* Rows removed from tables with StableOrder are put back in order
+             * once, after all commands are flushed. */
+            world->store.defer_row_order ++;
+        }
+
+        do {
+            ecs_stage_t *dst_stage = flecs_stage_from_world(&world);
+            ecs_commands_t *commands = stage->cmd;
+            ecs_vec_t *queue = &commands->queue;
+
+            if (stage->cmd == &stage->cmd_stack[0]) {
+                stage->cmd = &stage->cmd_stack[1];
+            } else {
+                stage->cmd = &stage->cmd_stack[0];
+            }
+
+            if (!ecs_vec_count(queue)) {
+                break;
+            }
+
+            stage->cmd_flushing = true;
+
+            /* Internal callback for capturing commands */
+            if (world->on_commands_active) {
+                world->on_commands_active(stage, queue, 
+                    world->on_commands_ctx_active);
+            }
+
+            int32_t cur, next, end = ecs_vec_count(queue);
+
+            ecs_table_diff_builder_t diff = {0};
+            bool diff_builder_used = false;
+            bool coalesce = merge_to_world && 
+                (world->flags & EcsWorldCoalesceCommands);
+            int32_t coalesced_end = 0;
+
+            /* Attribute merged commands to the systems that enqueued them */
+            ecs_cmd_system_stats_t sys_stats = {0};
+            bool measure_time = merge_to_world && 
+                (world->flags & EcsWorldMeasureSystemTime);
+            if (measure_time) {
+                ecs_os_get_time(&sys_stats.start);
+            }
+
+            /* Decode commands sequentially from the command stream. The queue
+             * doesn't grow while it's flushed, so command pointers are stable
+             * for the duration of the loop. */
+            for (cur = 0; cur < end; cur = next) {
+                ecs_cmd_t *cmd = flecs_cmd_at(queue, cur);
+                ecs_entity_t e = cmd->entity;
+                next = cur + cmd->length;
+
+                if (measure_time && (cmd->system != sys_stats.system)) {
+                    flecs_cmd_system_stats_flush(
+                        world, &sys_stats, cmd->system);
+                }
+
+                sys_stats.enqueued ++;
+
+                /* Move entities with the same table transition in a segment of
+                 * add/remove/set commands to the new table in bulk. */
+                if (coalesce && cur >= coalesced_end && 
+                    flecs_cmd_coalesce_kind(cmd->kind)) 
+                {
+                    if (!diff_builder_used) {
+                        flecs_table_diff_builder_init(world, &diff);
+                        diff_builder_used = true;
+                    }
+
+                    coalesced_end = flecs_cmd_coalesce(
+                        world, commands, cur, &diff);
+                }
+
+                /* Move entities that get the same component added or removed
+                 * to the new table in a single operation. */
+                if (merge_to_world && !cmd->next_for_entity) {
+                    int32_t batch_end = flecs_cmd_batch_range(
+                        world, queue, cur);
+                    if (batch_end) {
+                        int32_t batch_count = (batch_end - cur) / cmd->length;
+                        sys_stats.enqueued += batch_count - 1;
+                        sys_stats.coalesced += batch_count;
+                        next = batch_end;
+                        continue;
+                    }
+                }
+
+                bool is_alive = flecs_entities_is_alive(world, e);
+
+                /* A negative index indicates the first command for an entity */
+                if (merge_to_world && (cmd->next_for_entity < 0)) {
+                    diff.added_flags = 0;
+                    diff.removed_flags = 0;
+
+                    /* Batch commands for entity to limit archetype moves */
+                    if (is_alive) {
+                        if (!diff_builder_used) {
+                            flecs_table_diff_builder_init(world, &diff);
+                            diff_builder_used = true;
+                        }
+
+                        flecs_cmd_batch_for_entity(world, &diff, e, queue, cur);
+
+                        is_alive = flecs_entities_is_alive(world, e);
+                    } else {
+                        world->info.cmd.discard_count ++;
+                    }
+                }
 
                 /* If entity is no longer alive, this could be because the queue
                  * contained both a delete and a subsequent add/remove/set which
                  * should be ignored. */
                 ecs_cmd_kind_t kind = cmd->kind;
+                bool batched = cmd->flags & EcsCmdBatched;
+                if (batched) {
+                    sys_stats.coalesced ++;
+                }
+
                 if ((kind != EcsCmdPath) && ((kind == EcsCmdSkip) || (e && !is_alive))) {
                     world->info.cmd.discard_count ++;
+                    if (!batched) {
+                        sys_stats.discarded ++;
+                    }
                     flecs_discard_cmd(world, cmd);
                     continue;
                 }
@@ -1283,9 +2446,11 @@ bool flecs_defer_end(
                             flecs_add_id(world, e, id);
                         } else {
                             world->info.cmd.discard_count ++;
+                            sys_stats.discarded ++;
                         }
                     } else {
                         world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
                         ecs_delete(world, e);
                     }
                     break;
@@ -1295,38 +2460,40 @@ bool flecs_defer_end(
                     break;
                 case EcsCmdClone:
                     if (flecs_entities_is_alive(world, id)) {
-                        ecs_clone(world, e, id, cmd->is._1.clone_value);
+                        ecs_clone(world, e, id, 
+                            cmd->flags & EcsCmdCloneValue);
                         world->info.cmd.other_count ++;
                     } else {
                         world->info.cmd.discard_count ++;
+                        sys_stats.discarded ++;
                     }
                     break;
                 case EcsCmdSet:
                 case EcsCmdSetDontFragment:
                     flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.set_count ++;
                     break;
                 case EcsCmdEmplace:
                     if (merge_to_world) {
                         bool is_new;
                         ecs_emplace_id(world, e, id, 
-                            flecs_itosize(cmd->is._1.size), &is_new);
+                            flecs_itosize(cmd->size), &is_new);
                         if (!is_new) {
                             kind = EcsCmdEnsure;
                         }
                     }
                     flecs_set_id_move(world, dst_stage, e, 
-                        cmd->id, flecs_itosize(cmd->is._1.size), 
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size), 
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.ensure_count ++;
                     break;
                 case EcsCmdEnsure:
                 case EcsCmdEnsureDontFragment:
                     flecs_set_id_move(world, dst_stage, e,
-                        cmd->id, flecs_itosize(cmd->is._1.size),
-                        cmd->is._1.value, kind);
+                        cmd->id, flecs_itosize(cmd->size),
+                        flecs_cmd_value(cmd), kind);
                     world->info.cmd.ensure_count ++;
                     break;
                 case EcsCmdModified:
@@ -1354,7 +2521,7 @@ bool flecs_defer_end(
                 case EcsCmdOnDeleteAction:
                     ecs_defer_begin(world);
                     flecs_on_delete(world, id, e, false,
-                        cmd->is._1.force_delete);
+                        cmd->flags & EcsCmdForceDelete);
                     ecs_defer_end(world);
                     world->info.cmd.other_count ++;
                     break;
@@ -1382,15 +2549,15 @@ bool flecs_defer_end(
                         }
                     }
                     if (keep_alive) {
-                        ecs_set_name(world, e, cmd->is._1.value);
+                        ecs_set_name(world, e, flecs_cmd_value(cmd));
                     }
-                    ecs_os_free(cmd->is._1.value);
-                    cmd->is._1.value = NULL;
+                    ecs_os_free(flecs_cmd_value(cmd));
+                    cmd->flags = 0;
                     world->info.cmd.other_count ++;
                     break;
                 }
                 case EcsCmdEvent: {
-                    ecs_event_desc_t *desc = cmd->is._1.value;
+                    ecs_event_desc_t *desc = flecs_cmd_value(cmd);
                     ecs_assert(desc != NULL, ECS_INTERNAL_ERROR, NULL);
                     ecs_emit((ecs_world_t*)stage, desc);
                     flecs_free_cmd_event(world, desc);
@@ -1401,15 +2568,21 @@ bool flecs_defer_end(
                     break;
                 }
 
-                if (cmd->is._1.value) {
-                    flecs_stack_free(cmd->is._1.value, cmd->is._1.size);
-                }
+                flecs_cmd_free_value(cmd);
+            }
+
+            if (measure_time) {
+                flecs_cmd_system_stats_flush(world, &sys_stats, 0);
             }
 
             stage->cmd_flushing = false;
 
+            /* Invalidate entries, as their offsets point into the queue */
+            commands->epoch ++;
+
             flecs_stack_reset(&commands->stack);
             ecs_vec_clear(queue);
+            commands->count = 0;
 
             if (diff_builder_used) {
                 flecs_table_diff_builder_fini(world, &diff);
@@ -1422,6 +2595,10 @@ bool flecs_defer_end(
             }
         } while (true);
 
+        if (merge_to_world && !--world->store.defer_row_order) {
+            flecs_table_restore_row_order(world);
+        }
+
         ecs_os_perf_trace_pop("flecs.commands.merge");
 
         return true;
@@ -1442,13 +2619,15 @@ bool flecs_defer_purge(
         ecs_vec_t commands = stage->cmd->queue;
 
         if (ecs_vec_count(&commands)) {
-            ecs_cmd_t *cmds = ecs_vec_first(&commands);
-            int32_t i, count = ecs_vec_count(&commands);
-            for (i = 0; i < count; i ++) {
-                flecs_discard_cmd(world, &cmds[i]);
+            int32_t cur, end = ecs_vec_count(&commands);
+            ecs_cmd_t *cmd;
+            for (cur = 0; cur < end; cur += cmd->length) {
+                cmd = flecs_cmd_at(&commands, cur);
+                flecs_discard_cmd(world, cmd);
             }
 
-            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, ecs_cmd_t);
+            ecs_vec_fini_t(&stage->allocator, &stage->cmd->queue, uint8_t);
+            stage->cmd->count = 0;
 
             ecs_vec_clear(&commands);
             flecs_stack_reset(&stage->cmd->stack);
@@ -1467,7 +2646,9 @@ void flecs_commands_init(
     ecs_commands_t *cmd)
 {
     flecs_stack_init(&cmd->stack);
-    ecs_vec_init_t(&stage->allocator, &cmd->queue, ecs_cmd_t, 0);
+    ecs_vec_init_t(&stage->allocator, &cmd->queue, uint8_t, 0);
+    cmd->count = 0;
+    cmd->epoch = 0;
     flecs_sparse_init_t(&cmd->entries, &stage->allocator,
         &stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t);
 }
@@ -1480,10 +2661,242 @@ void flecs_commands_fini(
     ecs_assert(ecs_vec_count(&cmd->queue) == 0, ECS_INTERNAL_ERROR, NULL);
 
     flecs_stack_fini(&cmd->stack);
-    ecs_vec_fini_t(&stage->allocator, &cmd->queue, ecs_cmd_t);
+    ecs_vec_fini_t(&stage->allocator, &cmd->queue, uint8_t);
     flecs_sparse_fini(&cmd->entries);
 }
 
+void flecs_async_init(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_os_zeromem(q);
+    if (ecs_os_has_threading()) {
+        q->lock = ecs_os_mutex_new();
+    }
+}
+
+static void flecs_async_cmd_free(
+    ecs_async_cmd_t *cmd)
+{
+    if (cmd->value && (cmd->value != cmd->inline_value)) {
+        ecs_os_free(cmd->value);
+    }
+    cmd->value = NULL;
+}
+
+static void flecs_async_segments_free(
+    ecs_async_segment_t *seg)
+{
+    while (seg) {
+        ecs_async_segment_t *next = seg->next;
+        ecs_os_free(seg);
+        seg = next;
+    }
+}
+
+void flecs_async_fini(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = q->head;
+
+    /* Free values of commands that weren't merged */
+    while (seg) {
+        int32_t i, count = ecs_os_aload(&seg->reserved);
+        if (count > FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            count = FLECS_ASYNC_CMD_SEGMENT_SIZE;
+        }
+        for (i = seg->read; i < count; i ++) {
+            flecs_async_cmd_free(&seg->cmds[i]);
+        }
+        seg = seg->next;
+    }
+
+    flecs_async_segments_free(q->head);
+    flecs_async_segments_free(q->retired);
+    flecs_async_segments_free(q->free);
+
+    if (q->lock) {
+        ecs_os_mutex_free(q->lock);
+    }
+
+    ecs_os_zeromem(q);
+}
+
+/* Claim a slot in the async queue. This only takes a lock if the last segment
+ * of the queue is full. */
+static ecs_async_cmd_t* flecs_async_cmd_new(
+    ecs_async_queue_t *q)
+{
+    ecs_assert(q != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(q->lock != 0, ECS_INTERNAL_ERROR, NULL);
+
+    /* Segments are only reused by the consumer while no producer is active */
+    ecs_os_ainc(&q->producers);
+
+    do {
+        ecs_async_segment_t *seg = ecs_os_aloadp(&q->tail);
+        if (seg) {
+            int32_t index = ecs_os_ainc(&seg->reserved) - 1;
+            if (index < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+                return &seg->cmds[index];
+            }
+        }
+
+        ecs_os_mutex_lock(q->lock);
+        if (q->tail == seg) {
+            /* No other thread linked a new segment yet */
+            ecs_async_segment_t *new_seg = q->free;
+            if (new_seg) {
+                q->free = new_seg->next;
+                new_seg->next = NULL;
+            } else {
+                new_seg = ecs_os_calloc_t(ecs_async_segment_t);
+            }
+
+            /* Publish the segment after it is initialized */
+            if (seg) {
+                seg->next = new_seg;
+            } else {
+                ecs_os_astorep(&q->head, new_seg);
+            }
+            ecs_os_astorep(&q->tail, new_seg);
+        }
+        ecs_os_mutex_unlock(q->lock);
+    } while (true);
+}
+
+/* Make command visible to the consumer */
+static void flecs_async_cmd_publish(
+    ecs_async_queue_t *q,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_os_ainc(&cmd->ready);
+    ecs_os_adec(&q->producers);
+}
+
+static void flecs_async_cmd_apply(
+    ecs_world_t *world,
+    ecs_async_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    ecs_id_t id = cmd->id;
+
+    if (cmd->kind == EcsCmdEvent) {
+        if (!e || ecs_is_alive(world, e)) {
+            ecs_enqueue(world, cmd->value);
+            world->info.cmd.event_count ++;
+        } else {
+            world->info.cmd.discard_count ++;
+        }
+    } else if (!ecs_is_alive(world, e) || (id && !ecs_id_is_valid(world, id))) {
+        world->info.cmd.discard_count ++;
+    } else {
+        switch(cmd->kind) {
+        case EcsCmdAdd:
+            ecs_add_id(world, e, id);
+            break;
+        case EcsCmdRemove:
+            ecs_remove_id(world, e, id);
+            break;
+        case EcsCmdSet:
+            ecs_set_id(world, e, id, flecs_itosize(cmd->size), cmd->value);
+            break;
+        case EcsCmdDelete:
+            ecs_delete(world, e);
+            break;
+        case EcsCmdClone:
+        case EcsCmdBulkNew:
+        case EcsCmdSetDontFragment:
+        case EcsCmdEmplace:
+        case EcsCmdEnsure:
+        case EcsCmdEnsureDontFragment:
+        case EcsCmdModified:
+        case EcsCmdModifiedNoHook:
+        case EcsCmdAddModified:
+        case EcsCmdPath:
+        case EcsCmdClear:
+        case EcsCmdOnDeleteAction:
+        case EcsCmdEnable:
+        case EcsCmdDisable:
+        case EcsCmdEvent:
+        case EcsCmdSkip:
+            ecs_assert(false, ECS_INTERNAL_ERROR, NULL);
+            break;
+        }
+    }
+
+    flecs_async_cmd_free(cmd);
+}
+
+void flecs_async_merge(
+    ecs_world_t *world)
+{
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_async_segment_t *seg = ecs_os_aloadp(&q->head);
+    if (!seg) {
+        return;
+    }
+
+    if (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE && 
+        seg->read >= ecs_os_aload(&seg->reserved) && !q->retired) 
+    {
+        /* Nothing to merge */
+        return;
+    }
+
+    /* Merged commands are enqueued to the regular command queue, so that
+     * they're batched with other commands. */
+    ecs_defer_begin(world);
+
+    do {
+        while (seg->read < FLECS_ASYNC_CMD_SEGMENT_SIZE) {
+            ecs_async_cmd_t *cmd = &seg->cmds[seg->read];
+            if (ecs_os_adec(&cmd->ready)) {
+                /* Command is claimed but not yet written. Restore the flag and
+                 * stop, so that commands of a thread stay in order. */
+                ecs_os_ainc(&cmd->ready);
+                goto done;
+            }
+
+            flecs_async_cmd_apply(world, cmd);
+            seg->read ++;
+        }
+
+        /* Segment is merged, continue with the next segment */
+        ecs_os_mutex_lock(q->lock);
+        ecs_async_segment_t *next = seg->next;
+        if (next) {
+            q->head = next;
+            seg->next = q->retired;
+            q->retired = seg;
+        }
+        ecs_os_mutex_unlock(q->lock);
+
+        seg = next;
+    } while (seg);
+done:
+    ecs_defer_end(world);
+
+    /* Retired segments can be reused once no producer holds a pointer to them.
+     * Producers that start after this point can only see the tail segment. */
+    if (q->retired) {
+        int32_t producers = ecs_os_ainc(&q->producers) - 1;
+        ecs_os_adec(&q->producers);
+        if (!producers) {
+            ecs_os_mutex_lock(q->lock);
+            while ((seg = q->retired)) {
+                q->retired = seg->next;
+                seg->reserved = 0;
+                seg->read = 0;
+                seg->next = q->free;
+                q->free = seg;
+            }
+            ecs_os_mutex_unlock(q->lock);
+        }
+    }
+}
+
 bool ecs_defer_begin(
     ecs_world_t *world)
 {
@@ -1529,3 +2942,175 @@ void ecs_defer_resume(
 error:
     return;
 }
+
+void ecs_set_coalesced_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change coalesced merge while world is in readonly mode");
+    ECS_BIT_COND(world->flags, EcsWorldCoalesceCommands, enable);
+error:
+    return;
+}
+
+bool ecs_using_coalesced_merge(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return ECS_BIT_IS_SET(world->flags, EcsWorldCoalesceCommands);
+error:
+    return false;
+}
+
+/* Returns NULL if the queue has no lock because threading isn't set up */
+static ecs_async_queue_t* flecs_async_queue(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_async_queue_t *q = &world->async_queue;
+    ecs_check(q->lock != 0, ECS_MISSING_OS_API, 
+        "async commands require the threading OS API");
+    if (!q->lock) {
+        /* Checks are compiled out in release builds */
+        return NULL;
+    }
+    return q;
+error:
+    return NULL;
+}
+
+void ecs_async_add_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdAdd;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_remove_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdRemove;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_set_id(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_id_t id,
+    size_t size,
+    const void *ptr)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(id != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ptr != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    ecs_size_t value_size = flecs_uto(ecs_size_t, size);
+    cmd->kind = EcsCmdSet;
+    cmd->entity = entity;
+    cmd->id = id;
+    cmd->size = value_size;
+    if (value_size <= FLECS_ASYNC_CMD_INLINE_SIZE) {
+        cmd->value = cmd->inline_value;
+    } else {
+        cmd->value = ecs_os_malloc(value_size);
+    }
+    ecs_os_memcpy(cmd->value, ptr, value_size);
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_check(entity != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdDelete;
+    cmd->entity = entity;
+    cmd->id = 0;
+    cmd->value = NULL;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
+
+void ecs_async_enqueue(
+    ecs_world_t *world,
+    const ecs_event_desc_t *desc)
+{
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->event != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->table == NULL, ECS_INVALID_PARAMETER, 
+        "async events can only be emitted for entities");
+    ecs_check(!desc->param && !desc->const_param, ECS_INVALID_PARAMETER,
+        "async events can't have a param");
+    ecs_check(desc->ids != NULL && desc->ids->count != 0, 
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_async_queue_t *q = flecs_async_queue(world);
+    if (!q) {
+        return;
+    }
+
+    /* Store descriptor, type and ids in a single allocation */
+    int32_t id_count = desc->ids->count;
+    ecs_size_t size = ECS_SIZEOF(ecs_event_desc_t) + ECS_SIZEOF(ecs_type_t) +
+        id_count * ECS_SIZEOF(ecs_id_t);
+    ecs_event_desc_t *desc_cmd = ecs_os_malloc(size);
+    ecs_type_t *type_cmd = ECS_OFFSET(desc_cmd, ECS_SIZEOF(ecs_event_desc_t));
+    ecs_os_memcpy_t(desc_cmd, desc, ecs_event_desc_t);
+    type_cmd->array = ECS_OFFSET(type_cmd, ECS_SIZEOF(ecs_type_t));
+    type_cmd->count = id_count;
+    ecs_os_memcpy_n(type_cmd->array, desc->ids->array, ecs_id_t, id_count);
+    desc_cmd->ids = type_cmd;
+
+    ecs_async_cmd_t *cmd = flecs_async_cmd_new(q);
+    cmd->kind = EcsCmdEvent;
+    cmd->entity = desc->entity;
+    cmd->id = 0;
+    cmd->value = desc_cmd;
+    flecs_async_cmd_publish(q, cmd);
+error:
+    return;
+}
@@ -30,40 +30,97 @@ typedef enum ecs_cmd_kind_t {
     EcsCmdSkip
 } ecs_cmd_kind_t;
 
-/* Entity specific metadata for command in queue */
+/* Entity specific metadata for command in queue. Offsets point into the
+ * command stream. */
 typedef struct ecs_cmd_entry_t {
     int32_t first;
-    int32_t last;                    /* If -1, a delete command was inserted */
+    int32_t last;
+    uint32_t epoch;                  /* Entry is invalid if it doesn't match 
+                                      * the epoch of the queue */
 } ecs_cmd_entry_t;
 
-typedef struct ecs_cmd_1_t {
-    void *value;                     /* Component value (used by set / ensure) */
-    ecs_size_t size;                 /* Size of value */
-    bool clone_value;                /* Clone entity with value (used for clone) */ 
-    bool force_delete;               /* Delete prefab tables (used for delete_with) */
-} ecs_cmd_1_t;
+/* Command flags */
+#define EcsCmdValuePtr               (1u << 0) /* Command has pointer payload */
+#define EcsCmdValueInline            (1u << 1) /* Value is stored in stream */
+#define EcsCmdCloneValue             (1u << 2) /* Clone entity with value */
+#define EcsCmdForceDelete            (1u << 3) /* Delete prefab tables */
+#define EcsCmdBatched                (1u << 4) /* Applied as part of a batch */
+#define EcsCmdValueMoved             (1u << 5) /* Value moved out, storage not freed */
 
-typedef struct ecs_cmd_n_t {
-    ecs_entity_t *entities;  
-    int32_t count;
-} ecs_cmd_n_t;
+/* Largest component value that is stored inline in the command stream */
+#define FLECS_CMD_INLINE_SIZE        (64)
 
+/* Commands are stored as a stream of variable length records. Each record 
+ * starts with a command header, optionally followed by a payload:
+ *  - no payload for commands that only need an entity and id
+ *  - a pointer for values that must have a stable address (ensure, emplace),
+ *    for the entity array of bulk_new, the name of path and the descriptor
+ *    of event commands (EcsCmdValuePtr)
+ *  - the component value itself for small trivially copyable values passed to
+ *    set (EcsCmdValueInline).
+ * Records are aligned to 8 bytes, and are decoded sequentially on flush. */
 typedef struct ecs_cmd_t {
     ecs_cmd_kind_t kind;             /* Command kind */
-    int32_t next_for_entity;         /* Next operation for entity */    
+    int32_t next_for_entity;         /* Offset of next command for entity */
     ecs_id_t id;                     /* (Component) id */
-    ecs_cmd_entry_t *entry;
     ecs_entity_t entity;             /* Entity id */
-
-    union {
-        ecs_cmd_1_t _1;              /* Data for single entity operation */
-        ecs_cmd_n_t _n;              /* Data for multi entity operation */
-    } is;
-
     ecs_entity_t system;             /* System that enqueued the command */
+    int32_t size;                    /* Value size, or entity count (bulk_new) */
+    int16_t length;                  /* Length of record, including payload */
+    ecs_flags16_t flags;             /* Command flags */
 } ecs_cmd_t;
 
-/** Callback used to capture commands of a frame */
+/* Get command at offset in command stream */
+#define flecs_cmd_at(queue, offset)\
+    ECS_CAST(ecs_cmd_t*, ECS_OFFSET(ecs_vec_first(queue), offset))
+
+/* Number of commands in a segment of the async command queue */
+#define FLECS_ASYNC_CMD_SEGMENT_SIZE (256)
+
+/* Largest component value that is stored inline in an async command */
+#define FLECS_ASYNC_CMD_INLINE_SIZE  (32)
+
+/* Command enqueued by a thread that doesn't own a stage */
+typedef struct ecs_async_cmd_t {
+    ecs_cmd_kind_t kind;             /* Command kind */
+    int32_t ready;                   /* Set by producer after writing command */
+    ecs_id_t id;                     /* (Component) id */
+    ecs_entity_t entity;             /* Entity id */
+    void *value;                     /* Component value or event descriptor */
+    ecs_size_t size;                 /* Size of component value */
+    uint64_t inline_value[FLECS_ASYNC_CMD_INLINE_SIZE / 8];
+} ecs_async_cmd_t;
+
+/* Fixed size segment of the async command queue. Producers claim slots with an
+ * atomic increment, so a slot is only written by a single thread. */
+typedef struct ecs_async_segment_t {
+    ecs_async_cmd_t cmds[FLECS_ASYNC_CMD_SEGMENT_SIZE];
+    int32_t reserved;                /* Number of slots claimed by producers */
+    int32_t read;                    /* Number of slots merged */
+    struct ecs_async_segment_t *next;
+} ecs_async_segment_t;
+
+/* Multi producer, single consumer queue for commands enqueued by threads that
+ * don't own a stage. Enqueueing a command doesn't take a lock unless the last 
+ * segment is full. Commands are merged by the main thread when stages are 
+ * merged, or at the start of a frame.
+ *
+ * The OS API has no compare-and-swap, so slots are claimed with an atomic 
+ * increment, and new segments are linked under a lock. Segment pointers that
+ * are read without the lock are published with the atomic pointer load/store
+ * functions (aloadp_, astorep_) that were added to the OS API for the queue.
+ * The queue can't be used if the OS API has no mutex support. */
+typedef struct ecs_async_queue_t {
+    ecs_async_segment_t *head;       /* Segment that is merged next */
+    ecs_async_segment_t *tail;       /* Segment that commands are appended to */
+    ecs_async_segment_t *retired;    /* Merged segments that are not reused yet */
+    ecs_async_segment_t *free;       /* Segments that can be reused */
+    int32_t producers;               /* Number of threads enqueueing commands */
+    ecs_os_mutex_t lock;             /* Protects linking of new segments */
+} ecs_async_queue_t;
+
+/** Callback used to capture commands of a frame. The commands vector is the
+ * command stream, which is iterated by advancing with the command length. */
 typedef void (*ecs_on_commands_action_t)(
     const ecs_stage_t *stage,
     const ecs_vec_t *commands,
@@ -79,6 +136,24 @@ void flecs_commands_fini(
     ecs_stage_t *stage,
     ecs_commands_t *cmd);
 
+/* Test whether the command queues of all stages can be merged in place by
+ * multiple threads. This is not the case if an entity is used by commands in
+ * more than one stage, or if the queues contain commands that delete entities,
+ * as the cascading deletes can affect entities owned by other threads. */
+bool flecs_commands_can_merge_inplace(
+    ecs_world_t *world);
+
+/* Apply set/ensure commands that don't change the table of an entity directly
+ * to component storage. Can be called from multiple threads at the same time
+ * with different worker indices, as each worker only processes the commands 
+ * for the entities it owns. Value storage of applied commands is freed by the
+ * regular merge, which runs on the main thread. */
+void flecs_commands_merge_inplace(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t worker_index,
+    int32_t worker_count);
+
 /* Begin deferring, or return whether already deferred. */
 bool flecs_defer_cmd(
     ecs_stage_t *stage);
@@ -202,5 +277,17 @@ void flecs_enqueue(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_event_desc_t *desc);
+
+/* Initialize async command queue. */
+void flecs_async_init(
+    ecs_world_t *world);
+
+/* Free async command queue, discards commands that weren't merged. */
+void flecs_async_fini(
+    ecs_world_t *world);
+
+/* Merge commands that were enqueued by threads that don't own a stage. */
+void flecs_async_merge(
+    ecs_world_t *world);
  
 #endif
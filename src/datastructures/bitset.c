@@ -106,6 +106,64 @@ error:
     return;
 }
 
+/* Read 64 bits starting at an arbitrary bit offset. Bits past the allocated
+ * words are read as zero. */
+static uint64_t flecs_bitset_read_word(
+    const ecs_bitset_t *bs,
+    int32_t word_count,
+    int32_t elem)
+{
+    int32_t hi = elem >> 6, lo = elem & 0x3F;
+    if (hi >= word_count) {
+        return 0;
+    }
+
+    uint64_t result = bs->data[hi] >> lo;
+    if (lo && ((hi + 1) < word_count)) {
+        result |= bs->data[hi + 1] << (64 - lo);
+    }
+
+    return result;
+}
+
+void flecs_bitset_remove_range(
+    ecs_bitset_t *bs,
+    int32_t elem,
+    int32_t count)
+{
+    ecs_check(elem >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check((elem + count) <= bs->count, ECS_INVALID_PARAMETER, NULL);
+    if (!count) {
+        return;
+    }
+
+    int32_t word_count = bs->size / 64;
+    int32_t last = bs->count - count;
+    int32_t first_word = elem >> 6, last_word = (bs->count - 1) >> 6;
+
+    /* Shift words down. Source bits are always at or after the destination,
+     * so words can be written in increasing order. */
+    uint64_t keep = ((uint64_t)1 << (elem & 0x3F)) - 1;
+    int32_t w;
+    for (w = first_word; w <= last_word; w ++) {
+        uint64_t v = flecs_bitset_read_word(bs, word_count, w * 64 + count);
+        bs->data[w] = (bs->data[w] & keep) | (v & ~keep);
+        keep = 0;
+    }
+
+    /* Clear bits that were shifted out of the range */
+    w = last >> 6;
+    bs->data[w] &= ((uint64_t)1 << (last & 0x3F)) - 1;
+    for (w ++; w <= last_word; w ++) {
+        bs->data[w] = 0;
+    }
+
+    bs->count = last;
+error:
+    return;
+}
+
 void flecs_bitset_swap(
     ecs_bitset_t *bs,
     int32_t elem_a,
@@ -20,6 +20,12 @@ flecs_component_ptr_t flecs_table_get_component(
 {
     ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
     ecs_column_t *column = &table->data.columns[column_index];
+    if (column->flags & EcsColumnSoA) {
+        /* Members of struct-of-arrays components are not stored contiguously,
+         * so there is no pointer to the component value. */
+        return (flecs_component_ptr_t){ .ti = column->ti };
+    }
+
     return (flecs_component_ptr_t){
         .ti = column->ti,
         .ptr = ECS_ELEM(column->data, column->ti->size, row)
@@ -215,6 +221,57 @@ void flecs_commit(
     return;
 }
 
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags)
+{
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != dst_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ecs_table_count(src_table) >= (src_row + count), 
+        ECS_INTERNAL_ERROR, NULL);
+
+    ecs_os_perf_trace_push("flecs.commit_range");
+
+    /* Count traversable entities so that the traversable counters of the
+     * tables can be updated in one step. */
+    const ecs_entity_t *entities = ecs_table_entities(src_table);
+    int32_t i, trav_count = 0;
+    if (src_table->_->traversable_count) {
+        for (i = 0; i < count; i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[src_row + i]);
+            trav_count += (r->row & EcsEntityIsTraversable) != 0;
+        }
+    }
+
+    if (trav_count) {
+        flecs_table_traversable_add(dst_table, trav_count);
+    }
+
+    /* Invoke remove actions for removed components */
+    flecs_actions_move_remove(world, src_table, dst_table, src_row, count, diff);
+
+    /* Move entities & components from src_table to dst_table */
+    int32_t dst_row = flecs_table_move_range(
+        world, dst_table, src_table, src_row, count);
+
+    flecs_actions_move_add(world, dst_table, src_table, dst_row, count, diff,
+        evt_flags, true, 0, true);
+
+    if (trav_count) {
+        flecs_table_traversable_add(src_table, -trav_count);
+    }
+
+    ecs_os_perf_trace_pop("flecs.commit_range");
+}
+
 const ecs_entity_t* flecs_bulk_new(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -310,6 +367,19 @@ const ecs_entity_t* flecs_bulk_new(
                 int32_t index = tr->column;
                 ecs_column_t *column = &table->data.columns[index];
                 ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+
+                if (column->flags & EcsColumnSoA) {
+                    /* Struct-of-arrays components have trivial lifecycle, so
+                     * values can be scattered to member arrays for both copy
+                     * and move. */
+                    int32_t e;
+                    for (e = 0; e < count; e ++) {
+                        flecs_table_soa_set(table, index, row + e,
+                            ECS_ELEM(src_ptr, size, e));
+                    }
+                    continue;
+                }
+
                 ptr = ECS_ELEM(column->data, size, row);
 
                 if (is_move) {
@@ -453,10 +523,9 @@ flecs_component_ptr_t flecs_ensure(
     if (component < FLECS_HI_COMPONENT_ID) {
         int16_t column_index = table->component_map[component];
         if (column_index > 0) {
-            ecs_column_t *column = &table->data.columns[column_index - 1];
-            ecs_assert(column->ti->size == size, ECS_INTERNAL_ERROR, NULL);
-            dst.ptr = ECS_ELEM(column->data, size, ECS_RECORD_TO_ROW(r->row));
-            dst.ti = column->ti;
+            dst = flecs_table_get_component(
+                table, column_index - 1, ECS_RECORD_TO_ROW(r->row));
+            ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         } else if (column_index < 0) {
             column_index = flecs_ito(int16_t, -column_index - 1);
@@ -474,7 +543,7 @@ flecs_component_ptr_t flecs_ensure(
         cr = flecs_components_get(world, component);
         dst = flecs_get_component_ptr(
             world, table, ECS_RECORD_TO_ROW(r->row), cr);
-        if (dst.ptr) {
+        if (dst.ptr || (dst.ti && dst.ti->soa)) {
             ecs_assert(dst.ti->size == size, ECS_INTERNAL_ERROR, NULL);
             return dst;
         }
@@ -745,7 +814,8 @@ static void flecs_copy_id(
 
     flecs_type_info_copy(dst_ptr, src_ptr, 1, ti);
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     ecs_table_t *table = r->table;
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -754,6 +824,30 @@ static void flecs_copy_id(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, dst_ptr);
 }
 
+/* Scatter value into the member arrays of a struct-of-arrays component. */
+static void flecs_set_soa_id(
+    ecs_world_t *world,
+    ecs_record_t *r,
+    ecs_id_t component,
+    const void *src_ptr,
+    bool on_set)
+{
+    ecs_table_t *table = r->table;
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_component_record_t *cr = flecs_components_get(world, component);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t row = ECS_RECORD_TO_ROW(r->row);
+    flecs_table_soa_set(table, tr->column, row, src_ptr);
+    flecs_table_mark_dirty(world, table, component, row);
+
+    if (on_set) {
+        flecs_notify_on_set(world, table, row, component, true, NULL);
+    }
+}
+
 /* If operation is not deferred, add components by finding the target
  * table and moving the entity towards it. */
 static int flecs_traverse_add(
@@ -1489,6 +1583,17 @@ ecs_entity_t ecs_clone(
             int32_t index = ecs_table_column_to_type_index(dst_table, i);
             ecs_id_t component = dst_table->type.array[index];
 
+            if (dst_table->data.columns[i].flags & EcsColumnSoA) {
+                void *value = ecs_os_alloca(dst_table->data.columns[i].ti->size);
+                flecs_table_soa_get(src_table, 
+                    ecs_table_get_column_index(world, src_table, component),
+                    ECS_RECORD_TO_ROW(src_r->row), value);
+                flecs_table_soa_set(dst_table, i, row, value);
+                flecs_notify_on_set(world, dst_table, row, component, true,
+                    NULL);
+                continue;
+            }
+
             void *dst_ptr = ecs_get_mut_id(world, dst, component);
             if (!dst_ptr) {
                 continue;
@@ -1877,7 +1982,7 @@ void flecs_modified_id_if(
 
     flecs_notify_on_set(world, table, row, component, invoke_hook, ptr);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(world, table, component, row);
     flecs_defer_end(world, stage);
 error:
     return;
@@ -1918,7 +2023,8 @@ void ecs_modified_id(
     flecs_notify_on_set(
         world, table, ECS_RECORD_TO_ROW(r->row), component, true, NULL);
 
-    flecs_table_mark_dirty(world, table, component);
+    flecs_table_mark_dirty(
+        world, table, component, ECS_RECORD_TO_ROW(r->row));
     flecs_defer_end(world, stage);
 error:
     return;
@@ -1943,10 +2049,16 @@ void flecs_set_id_move(
     ecs_record_t *r = flecs_entities_get(world, entity);
     flecs_component_ptr_t dst = flecs_ensure(
         world, entity, component, r, flecs_uto(int32_t, size));
-    ecs_check(dst.ptr != NULL, ECS_INVALID_PARAMETER, NULL);
 
     const ecs_type_info_t *ti = dst.ti;
-    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_check(ti != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!dst.ptr) {
+        ecs_check(ti->soa != NULL, ECS_INVALID_PARAMETER, NULL);
+        flecs_set_soa_id(world, r, component, ptr, cmd_kind == EcsCmdSet);
+        flecs_defer_end(world, stage);
+        return;
+    }
 
     if (ti->hooks.on_replace) {
         flecs_invoke_replace_hook(
@@ -1960,7 +2072,8 @@ void flecs_set_id_move(
         flecs_type_info_ctor_move_dtor(dst.ptr, ptr, 1, ti);
     }
 
-    flecs_table_mark_dirty(world, r->table, component);
+    flecs_table_mark_dirty(
+        world, r->table, component, ECS_RECORD_TO_ROW(r->row));
 
     if (cmd_kind == EcsCmdSet) {
         ecs_table_t *table = r->table;
@@ -2015,6 +2128,12 @@ void ecs_set_id(
     flecs_component_ptr_t dst = flecs_ensure(world, entity, component, r, 
         flecs_uto(int32_t, size));
 
+    if (!dst.ptr) {
+        ecs_assert(dst.ti->soa != NULL, ECS_INTERNAL_ERROR, NULL);
+        flecs_set_soa_id(world, r, component, ptr, true);
+        goto done;
+    }
+
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_set[component]) {
             ecs_os_memcpy(dst.ptr, ptr, size);
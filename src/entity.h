@@ -117,6 +117,16 @@ void flecs_commit(
     ecs_id_t emplace_id,
     ecs_flags32_t evt_flags);
 
+/* Commit a range of entities in the same table to a new table. */
+void flecs_commit_range(
+    ecs_world_t *world,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff,
+    ecs_flags32_t evt_flags);
+
 /* Like regular modified, but doesn't assert if entity doesn't have component. */
 void flecs_modified_id_if(
     ecs_world_t *world,
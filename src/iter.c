@@ -130,8 +130,11 @@ void* ecs_field_w_size(
 
     int16_t column = it->columns[index];
     if (column >= 0) {
-        return ECS_ELEM(it->table->data.columns[column].data,
-            (ecs_size_t)size, it->offset);
+        ecs_column_t *c = &it->table->data.columns[column];
+        ecs_assert(!(c->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+            "field %d has struct-of-arrays storage, use ecs_field_member()",
+                index);
+        return ECS_ELEM(c->data, (ecs_size_t)size, it->offset);
     }
 
     return flecs_field_shared(it, size, index);
@@ -156,6 +159,10 @@ void* flecs_field_shared(
         it->real_world, it->ids[index]);
     const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
     int16_t column = tr->column;
+    ecs_assert(!(table->data.columns[column].flags & EcsColumnSoA), 
+        ECS_INVALID_OPERATION,
+        "field %d has struct-of-arrays storage, use ecs_field_member()",
+            index);
 
     return ECS_ELEM(table->data.columns[column].data,
         (ecs_size_t)size, ECS_RECORD_TO_ROW(r->row));
@@ -240,6 +247,78 @@ error:
     return NULL;
 }
 
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out)
+{
+    ecs_table_t *table = it->table;
+    int32_t column = it->columns[index], row = it->offset;
+    if (column < 0 || it->sources[index]) {
+        ecs_entity_t src = it->sources[index];
+        if (!src || !ecs_field_is_set(it, index)) {
+            return -1;
+        }
+
+        ecs_record_t *r = flecs_entities_get(it->real_world, src);
+        ecs_component_record_t *cr = flecs_components_get(
+            it->real_world, it->ids[index]);
+        ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (cr->flags & EcsIdSparse) {
+            return -1;
+        }
+
+        table = r->table;
+        const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+        ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+        column = tr->column;
+        row = ECS_RECORD_TO_ROW(r->row);
+    }
+
+    *table_out = table;
+    *row_out = row;
+    return column;
+}
+
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int8_t index,
+    int32_t member)
+{
+    ecs_check(it->flags & EcsIterIsValid, ECS_INVALID_PARAMETER,
+        "operation invalid before calling next()");
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER,
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER,
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table;
+    int32_t row, column = flecs_field_column(it, index, &table, &row);
+    if (column < 0) {
+        return NULL;
+    }
+
+    ecs_column_t *c = &table->data.columns[column];
+    ecs_check(c->flags & EcsColumnSoA, ECS_INVALID_OPERATION,
+        "field %d does not have struct-of-arrays storage, use ecs_field()",
+            index);
+
+    const ecs_soa_layout_t *soa = c->ti->soa;
+    ecs_check(member >= 0 && member < soa->count, ECS_INVALID_PARAMETER,
+        "member index %d out of bounds for field %d", member, index);
+
+    const ecs_soa_member_t *m = &soa->members[member];
+    ecs_check(!size || flecs_uto(ecs_size_t, size) == m->size, 
+        ECS_INVALID_PARAMETER, "mismatching size for member %d of field %d",
+            member, index);
+
+    return ECS_OFFSET(c->data, m->offset * table->data.size + m->size * row);
+error:
+    return NULL;
+}
+
 bool ecs_field_is_readonly(
     const ecs_iter_t *it,
     int8_t index)
@@ -392,6 +471,34 @@ error:
     return 0;
 }
 
+const uint64_t* ecs_field_enabled_mask(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_table_t *table = it->table;
+    if (!table || !table->_->bs_count) {
+        return NULL;
+    }
+
+    if (!ecs_field_is_set(it, index) || !ecs_field_is_self(it, index)) {
+        return NULL;
+    }
+
+    ecs_bitset_t *bs = flecs_table_get_toggle(table, it->ids[index]);
+    if (!bs) {
+        return NULL;
+    }
+
+    return bs->data;
+error:
+    return NULL;
+}
+
 size_t ecs_field_size(
     const ecs_iter_t *it,
     int8_t index)
@@ -406,6 +513,52 @@ error:
     return 0;
 }
 
+ecs_size_t ecs_field_alignment(
+    const ecs_iter_t *it,
+    int8_t index)
+{
+    ecs_check(index >= 0, ECS_INVALID_PARAMETER, 
+        "invalid field index %d", index);
+    ecs_check(index < it->field_count, ECS_INVALID_PARAMETER, 
+        "field index %d out of bounds", index);
+
+    ecs_size_t size = it->sizes[index];
+    if (!size || (it->row_fields & (1llu << index))) {
+        return 0;
+    }
+
+    int16_t column = it->columns[index];
+    if (!it->ptrs && column >= 0 && 
+        (it->table->data.columns[column].flags & EcsColumnSoA)) 
+    {
+        /* Member arrays don't start at the field pointer */
+        return 0;
+    }
+
+    void *ptr = ecs_field_w_size(it, (size_t)size, index);
+    if (!ptr) {
+        return 0;
+    }
+
+    const ecs_world_t *world = it->real_world;
+    ecs_size_t alignment = world->column_alignment;
+    const ecs_type_info_t *ti = ecs_get_type_info(world, it->ids[index]);
+    if (ti && ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+
+    /* Largest power of two that the address is a multiple of */
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t result = addr & (~addr + 1);
+    if (alignment && result > (uintptr_t)alignment) {
+        result = (uintptr_t)alignment;
+    }
+
+    return (ecs_size_t)result;
+error:
+    return 0;
+}
+
 bool ecs_iter_next(
     ecs_iter_t *iter)
 {
@@ -972,6 +1125,203 @@ error:
     return (ecs_iter_t){ 0 };
 }
 
+ecs_iter_t ecs_worker_iter_w_chunking(
+    const ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking)
+{
+    ecs_check(chunking != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->min_count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunking->chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_iter_t result = ecs_worker_iter(it, index, count);
+    if (chunking->disable) {
+        return result;
+    }
+
+    result.priv_.iter.worker.min_count = chunking->min_count;
+    result.priv_.iter.worker.chunk_size = chunking->chunk_size;
+    result.priv_.iter.worker.chunk = -1;
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+/* Get number of rows that worker slices must be a multiple of, so that the
+ * fields of each slice start at an address that has the column alignment. */
+static int32_t flecs_worker_row_granularity(
+    const ecs_iter_t *it)
+{
+    ecs_size_t alignment = it->real_world->column_alignment;
+    if (!alignment || !it->table) {
+        return 1;
+    }
+
+    int32_t result = 1;
+    int8_t i;
+    for (i = 0; i < it->field_count; i ++) {
+        ecs_size_t size = it->sizes[i];
+        if (!size) {
+            continue;
+        }
+
+        /* Largest power of two that the component size is a multiple of */
+        ecs_size_t size_align = size & -size;
+        if (size_align < alignment) {
+            int32_t rows = alignment / size_align;
+            if (rows > result) {
+                result = rows;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Number of bytes of the fields of a chunk when a chunking policy doesn't 
+ * specify a chunk size. 32KB fits in the L1 data cache of most CPUs, and in the
+ * L2 cache of all of them. */
+#ifndef FLECS_WORKER_CHUNK_BYTES
+#define FLECS_WORKER_CHUNK_BYTES (32 * 1024)
+#endif
+
+/* Get number of entities per chunk for a result */
+static int32_t flecs_worker_chunk_size(
+    const ecs_iter_t *it,
+    const ecs_worker_iter_t *iter,
+    int32_t count)
+{
+    int32_t result = iter->chunk_size;
+    if (!result) {
+        /* Don't make chunks larger than needed to give each worker a chunk */
+        result = (count + iter->count - 1) / iter->count;
+
+        ecs_size_t row_size = 0;
+        int8_t i;
+        for (i = 0; i < it->field_count; i ++) {
+            if (!it->sources[i]) {
+                row_size += it->sizes[i];
+            }
+        }
+
+        if (row_size) {
+            int32_t cache_rows = FLECS_WORKER_CHUNK_BYTES / row_size;
+            if (!cache_rows) {
+                cache_rows = 1;
+            }
+            if (cache_rows < result) {
+                result = cache_rows;
+            }
+        }
+    }
+
+    if (result < iter->min_count) {
+        result = iter->min_count;
+    }
+
+    int32_t granularity = flecs_worker_row_granularity(it);
+    if (granularity > 1) {
+        result = ((result + granularity - 1) / granularity) * granularity;
+    }
+
+    return result;
+}
+
+/* Get first row of a worker slice, rounded down to the row granularity. The
+ * row is relative to the start of the table. */
+static int32_t flecs_worker_slice_start(
+    int32_t offset,
+    int32_t count,
+    int32_t index,
+    int32_t worker_count,
+    int32_t granularity)
+{
+    if (index >= worker_count) {
+        return offset + count;
+    }
+
+    int32_t row = offset + (int32_t)(((int64_t)count * index) / worker_count);
+    row -= row % granularity;
+    if (row < offset) {
+        row = offset;
+    }
+
+    return row;
+}
+
+/* Progress worker iterator with chunking policy. Results are split up in
+ * chunks, which are assigned round robin to workers. The first chunk of a
+ * result is assigned to a worker derived from the table id, so that tables
+ * that are processed as a whole are spread out across workers. */
+static bool flecs_worker_chunk_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t res_count = iter->count, res_index = iter->index;
+
+    do {
+        if (iter->chunk == -1) {
+            if (!ecs_iter_next(chain_it)) {
+                return false;
+            }
+
+            if (!chain_it->count) {
+                if (chain_it->table) {
+                    continue;
+                }
+
+                ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+                if (res_index == 0) {
+                    return true;
+                } else {
+                    /* Chained iterator returned true, so clean it up */
+                    ecs_iter_fini(chain_it);
+                    return false;
+                }
+            }
+
+            int32_t start = 0;
+            if (chain_it->table) {
+                start = (int32_t)(chain_it->table->id % (uint64_t)res_count);
+            }
+
+            iter->chunk = (res_index - start + res_count) % res_count;
+        }
+
+        int32_t chunk_size = flecs_worker_chunk_size(
+            chain_it, iter, chain_it->count);
+        int32_t first = iter->chunk * chunk_size;
+        if (first >= chain_it->count) {
+            iter->chunk = -1;
+            continue;
+        }
+
+        int32_t count = chain_it->count - first;
+        if (count > chunk_size) {
+            count = chunk_size;
+        }
+
+        iter->chunk += res_count;
+
+        /* Copy everything up to the private iterator data */
+        ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+        it->frame_offset += first;
+        it->count = count;
+        it->offset += first;
+
+        if (it->table) {
+            it->entities = &(ecs_table_entities(it->table)[it->offset]);
+        } else {
+            it->entities = &it->entities[first];
+        }
+
+        return true;
+    } while (true);
+}
+
 bool ecs_worker_next(
     ecs_iter_t *it)
 {
@@ -984,6 +1334,10 @@ bool ecs_worker_next(
     int32_t res_count = iter->count, res_index = iter->index;
     int32_t per_worker, first;
 
+    if (iter->min_count || iter->chunk_size) {
+        return flecs_worker_chunk_next(it);
+    }
+
     do {
         if (!ecs_iter_next(chain_it)) {
             return false;
@@ -993,6 +1347,38 @@ bool ecs_worker_next(
         ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
 
         int32_t count = it->count;
+
+        /* When workers are pinned, keep small tables on a single worker so 
+         * the same core processes the table each frame. */
+        if (it->table && count && count < res_count && 
+            (it->real_world->flags & EcsWorldWorkerAffinity)) 
+        {
+            if ((int32_t)(it->table->id % (uint64_t)res_count) == res_index) {
+                per_worker = count;
+                first = 0;
+                break;
+            }
+
+            per_worker = 0;
+            continue;
+        }
+
+        /* When a column alignment is set, split the table at rows that keep
+         * the arrays of each worker aligned. */
+        int32_t granularity = flecs_worker_row_granularity(it);
+        if (granularity > 1) {
+            int32_t start = flecs_worker_slice_start(
+                it->offset, count, res_index, res_count, granularity);
+            int32_t end = flecs_worker_slice_start(
+                it->offset, count, res_index + 1, res_count, granularity);
+            first = start - it->offset;
+            per_worker = end - start;
+            if (!per_worker && it->table) {
+                continue;
+            }
+            break;
+        }
+
         per_worker = count / res_count;
         first = per_worker * res_index;
         count -= per_worker * res_count;
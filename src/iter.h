@@ -18,6 +18,14 @@ void* flecs_field_shared(
     size_t size,
     int8_t index);
 
+/* Find table, column and row at which the value(s) of a field are stored. 
+ * Returns -1 if the field is not stored in a table column. */
+int32_t flecs_field_column(
+    const ecs_iter_t *it,
+    int8_t index,
+    ecs_table_t **table_out,
+    int32_t *row_out);
+
 /* Free iterator memory block. */
 void flecs_iter_free(
     void *ptr,
@@ -1325,6 +1325,24 @@ ecs_observer_t* flecs_observer_init(
         "observer must have at least one term");
 
     int i;
+    /* Components with struct-of-arrays storage can't be accessed with 
+     * ecs_field, which is what observer callbacks (and the C++ API) use. */
+    for (i = 0; i < query->term_count; i ++) {
+        ecs_term_t *term = &query->terms[i];
+        if (!term->id || term->inout == EcsInOutNone || 
+            ecs_id_is_wildcard(term->id)) 
+        {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, term->id);
+        ecs_check(!ti || !ti->soa, ECS_UNSUPPORTED,
+            "observer term for '%s' must have inout None: component has "
+            "struct-of-arrays storage", 
+                flecs_errstr(ecs_id_str(world, term->id)));
+        (void)ti;
+    }
+
 #ifdef FLECS_QUERY_PLANS
     int var_count = 0;
     for (i = 0; i < query->term_count; i ++) {
@@ -522,6 +522,31 @@ static char* ecs_os_api_module_to_etc(const char *module) {
     return ecs_strbuf_get(&lib);
 }
 
+/* Fallbacks for OS API implementations that don't provide atomic loads and
+ * stores. Volatile accesses are not ordered with other memory operations, so
+ * threaded implementations should override these. */
+static
+int32_t ecs_os_api_aload(
+    const int32_t *value)
+{
+    return *(const volatile int32_t*)value;
+}
+
+static
+void* ecs_os_api_aloadp(
+    void *const *value)
+{
+    return *(void *const volatile*)value;
+}
+
+static
+void ecs_os_api_astorep(
+    void **ptr,
+    void *value)
+{
+    *(void *volatile*)ptr = value;
+}
+
 void ecs_os_set_api_defaults(void)
 {
     /* Don't overwrite if already initialized */
@@ -549,6 +574,11 @@ void ecs_os_set_api_defaults(void)
     ecs_os_api.fclose_ = ecs_os_api_fclose;
     ecs_os_api.fread_ = ecs_os_api_fread;
 
+    /* Atomics */
+    ecs_os_api.aload_ = ecs_os_api_aload;
+    ecs_os_api.aloadp_ = ecs_os_api_aloadp;
+    ecs_os_api.astorep_ = ecs_os_api_astorep;
+
     /* Time */
     ecs_os_api.get_time_ = ecs_os_gettime;
 
@@ -584,6 +614,14 @@ bool ecs_os_has_heap(void) {
         (ecs_os_api.free_ != NULL);
 }
 
+bool ecs_os_has_virtual_memory(void) {
+    return
+        (ecs_os_api.reserve_ != NULL) &&
+        (ecs_os_api.commit_ != NULL) &&
+        (ecs_os_api.decommit_ != NULL) &&
+        (ecs_os_api.release_ != NULL);
+}
+
 bool ecs_os_has_threading(void) {
     return
         (ecs_os_api.mutex_new_ != NULL) &&
@@ -34,6 +34,7 @@
 #include "storage/table_cache.h"
 #include "storage/component_index.h"
 #include "storage/table.h"
+#include "storage/cold_storage.h"
 #include "storage/sparse_storage.h"
 #include "storage/ordered_children.h"
 #include "storage/non_fragmenting_childof.h"
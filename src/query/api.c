@@ -81,7 +81,7 @@ static int flecs_query_set_caching_policy(
 #endif
     bool require_caching = desc->group_by || desc->group_by_callback || 
             desc->order_by || desc->order_by_callback || 
-            (desc->flags & EcsQueryDetectChanges);
+            (desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges));
 
     /* If the query has a Cascade term it'll use group_by */
     int32_t i, term_count = impl->pub.term_count;
@@ -103,13 +103,16 @@ static int flecs_query_set_caching_policy(
     /* If caching policy is default, try to pick a policy that does the right
      * thing in most cases. */
     if (kind == EcsQueryCacheDefault) {
-        if (desc->entity || require_caching) {
+        if (desc->entity || require_caching || 
+            (desc->flags & EcsQueryPrefetch)) 
+        {
             /* If the query is created with an entity handle (typically 
              * indicating that the query is named or belongs to a system) the
              * chance is very high that the query will be reused, so enable
              * caching. 
              * Additionally, if the query uses features that require a cache
-             * such as group_by/order_by, also enable caching. */
+             * such as group_by/order_by, or that only apply to cached queries
+             * such as prefetching, also enable caching. */
             kind = EcsQueryCacheAuto;
         } else {
             /* Be conservative in other scenarios, as caching adds significant
@@ -602,6 +605,68 @@ ecs_query_count_t ecs_query_count(
     return result;
 }
 
+/* Estimate the number of entities matched by a query without evaluating it. 
+ * For cached queries this is the number of entities in the cached tables. For
+ * uncached queries it is the number of entities in the tables with the first
+ * component that the query matches on $this, which is an upper bound. */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q)
+{
+    flecs_poly_assert(q, ecs_query_t);
+
+#ifdef FLECS_CACHED_QUERIES
+    ecs_query_impl_t *impl = flecs_query_impl(q);
+    if (impl->cache) {
+        return flecs_query_cache_entity_count(impl->cache);
+    }
+#endif
+
+    ecs_flags32_t skip = EcsTableIsPrefab|EcsTableIsDisabled;
+    if (q->flags & EcsQueryMatchPrefab) {
+        skip &= ~(ecs_flags32_t)EcsTableIsPrefab;
+    }
+    if (q->flags & EcsQueryMatchDisabled) {
+        skip &= ~(ecs_flags32_t)EcsTableIsDisabled;
+    }
+
+    int32_t i;
+    for (i = 0; i < q->term_count; i ++) {
+        const ecs_term_t *term = &q->terms[i];
+        if (term->oper != EcsAnd || !ecs_term_match_this(term)) {
+            continue;
+        }
+        if (term->src.id & EcsUp) {
+            continue;
+        }
+        if (term->flags_ & (EcsTermIsSparse|EcsTermDontFragment|
+            EcsTermIsMember|EcsTermNonFragmentingChildOf)) 
+        {
+            continue;
+        }
+
+        ecs_component_record_t *cr = flecs_components_get(q->world, term->id);
+        if (!cr) {
+            return 0;
+        }
+
+        int32_t result = 0;
+        ecs_table_cache_iter_t it;
+        if (flecs_table_cache_queryable_iter(&cr->cache, &it, EcsTableNotEmpty)) {
+            const ecs_table_cache_elem_t *elem;
+            while ((elem = flecs_table_cache_next(&it))) {
+                const ecs_table_t *table = elem->table;
+                if (!(table->flags & skip)) {
+                    result += ecs_table_count(table);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    return ecs_query_count(q).entities;
+}
+
 bool ecs_query_is_true(
     const ecs_query_t *q)
 {
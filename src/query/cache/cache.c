@@ -152,6 +152,37 @@ ecs_size_t flecs_query_cache_elem_size(
         ;
 }
 
+/* Number of entities in the tables matched by the cache. Tables that match
+ * multiple times for wildcard queries are counted for each match. */
+int32_t flecs_query_cache_entity_count(
+    const ecs_query_cache_t *cache)
+{
+    ecs_size_t elem_size = flecs_query_cache_elem_size(cache);
+    bool trivial = flecs_query_cache_is_trivial(cache);
+    int32_t result = 0;
+
+    const ecs_query_cache_group_t *cur = cache->first_group;
+    do {
+        int32_t i, count = ecs_vec_count(&cur->tables);
+        for (i = 0; i < count; i ++) {
+            const ecs_query_triv_cache_match_t *qm = 
+                ecs_vec_get(&cur->tables, elem_size, i);
+            int32_t table_count = ecs_table_count(qm->table);
+            result += table_count;
+
+            if (!trivial) {
+                const ecs_query_cache_match_t *m = 
+                    (const ecs_query_cache_match_t*)qm;
+                if (m->wildcard_matches) {
+                    result += table_count * ecs_vec_count(m->wildcard_matches);
+                }
+            }
+        }
+    } while ((cur = cur->next));
+
+    return result;
+}
+
 /* The default group_by function. When an application specifies a relationship
  * for the ecs_query_desc_t::group_by field but does not provide a 
  * group_by_callback, this function will be automatically used. It will cause
@@ -492,6 +523,15 @@ static int flecs_query_cache_order_by(
             ecs_os_free(id_str);
             goto error;
         }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, order_by);
+        if (ti && ti->soa) {
+            char *id_str = ecs_id_str(world, order_by);
+            ecs_err("cannot order_by component '%s' with struct-of-arrays "
+                "storage", id_str);
+            ecs_os_free(id_str);
+            goto error;
+        }
     }
 
     cache->order_by = order_by;
@@ -760,7 +800,8 @@ ecs_query_cache_t* flecs_query_cache_init(
             if (!const_desc->order_by && !const_desc->group_by && 
                 !const_desc->order_by_callback && 
                 !const_desc->group_by_callback &&
-                !(const_desc->flags & EcsQueryDetectChanges))
+                !(const_desc->flags & 
+                    (EcsQueryDetectChanges|EcsQueryDetectRowChanges)))
             {
                 
                 q->flags |= EcsQueryTrivialCache;
@@ -768,7 +809,7 @@ ecs_query_cache_t* flecs_query_cache_init(
         }
     }
 
-    if (const_desc->flags & EcsQueryDetectChanges) {
+    if (const_desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges)) {
         for (int i = 0; i < q->term_count; i ++) {
             ecs_term_t *term = &q->terms[i];
 
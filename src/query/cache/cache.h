@@ -136,6 +136,9 @@ bool flecs_query_cache_is_trivial(
 ecs_size_t flecs_query_cache_elem_size(
     const ecs_query_cache_t *cache);
 
+int32_t flecs_query_cache_entity_count(
+    const ecs_query_cache_t *cache);
+
 #include "cache_iter.h"
 #include "group.h"
 #include "match.h"
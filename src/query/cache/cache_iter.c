@@ -7,6 +7,46 @@
 
 #ifdef FLECS_CACHED_QUERIES
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/* Portable software prefetch hint for data that will be read soon. */
+static inline void flecs_prefetch(
+    const void *addr)
+{
+#if defined(__clang__) || defined(__GNUC__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)addr, _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
+/* Prefetch the entity array and the heads of the matched columns of a table
+ * that will be iterated next, so that the loads overlap with processing the
+ * current table. Used by queries with the EcsQueryPrefetch flag. */
+static void flecs_query_cache_prefetch(
+    const ecs_query_run_ctx_t *ctx,
+    const ecs_query_triv_cache_match_t *qm)
+{
+    const ecs_table_t *table = qm->table;
+    flecs_prefetch(table->data.entities);
+
+    const ecs_column_t *columns = table->data.columns;
+    const int16_t *field_columns = qm->columns;
+    int32_t i, field_count = ctx->query->cache->query->field_count;
+    for (i = 0; i < field_count; i ++) {
+        int16_t column = field_columns[i];
+        if (column < 0) {
+            continue;
+        }
+
+        flecs_prefetch(columns[column].data);
+    }
+}
+
 /* Initialize cached query iterator. */
 void flecs_query_cache_iter_init(
     ecs_iter_t *it,
@@ -116,6 +156,13 @@ static ecs_query_cache_match_t* flecs_query_cache_next(
             qit->cur ++;
         }
 
+        if (ctx->query->pub.flags & EcsQueryPrefetch) {
+            if (qit->cur < ecs_vec_count(qit->tables)) {
+                flecs_query_cache_prefetch(ctx, &ecs_vec_get_t(qit->tables, 
+                    ecs_query_cache_match_t, qit->cur)->base);
+            }
+        }
+
 #ifdef FLECS_QUERY_PLANS
         ctx->vars[0].range.table = table;
 #else
@@ -146,6 +193,13 @@ static ecs_query_cache_match_t* flecs_query_trivial_cache_next(
 
         qit->cur ++;
 
+        if (ctx->query->pub.flags & EcsQueryPrefetch) {
+            if (qit->cur < ecs_vec_count(qit->tables)) {
+                flecs_query_cache_prefetch(ctx, ecs_vec_get_t(qit->tables, 
+                    ecs_query_triv_cache_match_t, qit->cur));
+            }
+        }
+
         if (!count) {
             if (!(it->flags & EcsIterMatchEmptyTables)) {
                 goto repeat;
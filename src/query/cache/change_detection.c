@@ -136,6 +136,10 @@ static bool flecs_query_get_match_monitor(
 
     impl->pub.flags |= EcsQueryHasChangeDetection;
 
+    if ((impl->pub.flags & EcsQueryDetectRowChanges) && match->base.table) {
+        flecs_table_track_row_changes(q->real_world, match->base.table);
+    }
+
     return true;
 }
 
@@ -428,6 +432,139 @@ static bool flecs_query_check_match_monitor(
     return false;
 }
 
+/* Check if a chunk of rows changed for any of the provided columns. */
+static bool flecs_query_check_chunk_monitor(
+    const ecs_vec_t *chunks,
+    const int32_t *columns,
+    const int32_t *monitor,
+    int32_t column_count,
+    int32_t chunk)
+{
+    int32_t i;
+    for (i = 0; i < column_count; i ++) {
+        const ecs_vec_t *stamps = &chunks[columns[i]];
+        if (chunk >= ecs_vec_count(stamps)) {
+            continue; /* Chunk wasn't written to since tracking started */
+        }
+
+        if (flecs_table_stamp_load(
+            ecs_vec_get_t(stamps, int32_t, chunk)) > monitor[i]) 
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Find the next range of rows in the iterated result that changed. Rows are
+ * tracked in chunks, so a range can include rows that were not modified if they
+ * share a chunk with rows that were. */
+static bool flecs_query_check_match_monitor_rows(
+    ecs_query_impl_t *impl,
+    ecs_query_cache_match_t *match,
+    const ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count)
+{
+    ecs_query_cache_t *cache = impl->cache;
+    const ecs_query_t *query = cache->query;
+    int32_t columns[FLECS_TERM_COUNT_MAX];
+    int32_t versions[FLECS_TERM_COUNT_MAX];
+    int32_t i, changed_count = 0, field_count = query->field_count;
+    int32_t offset = it->offset, cur, last, first = -1;
+    ecs_table_t *table = match->base.table;
+    ecs_entity_t *sources = match->_sources;
+    ecs_vec_t *chunks;
+    int32_t *monitor, *dirty_state;
+
+    if (flecs_query_get_match_monitor(impl, match)) {
+        goto all; /* Result was never synchronized with the query */
+    }
+
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    monitor = match->_monitor;
+    dirty_state = flecs_table_get_dirty_state(query->world, table);
+    if (monitor[0] != dirty_state[0]) {
+        goto all; /* Table gained or lost entities, rows may have moved */
+    }
+
+    chunks = table->_->dirty_chunks;
+
+    for (i = 0; i < field_count; i ++) {
+        int32_t mon = monitor[i + 1];
+        if (mon == -1) {
+            continue;
+        }
+
+        int32_t set_field_index = i;
+        if (cache->field_map) {
+            set_field_index = cache->field_map[i];
+        }
+
+        if (!(it->set_fields & (1llu << set_field_index))) {
+            continue;
+        }
+
+        int32_t column = match->base.columns[i];
+        ecs_entity_t src = sources ? sources[i] : 0;
+        if (src) {
+            /* Component from non-this source applies to all rows */
+            flecs_table_column_t tc;
+            flecs_query_get_column_for_field(query, match, i, &tc);
+            if (!tc.table || tc.column < 0) {
+                continue;
+            }
+
+            if (mon != flecs_table_get_dirty_state(
+                query->world, tc.table)[tc.column + 1])
+            {
+                goto all;
+            }
+        } else if (column >= 0 && mon != dirty_state[column + 1]) {
+            if (!chunks) {
+                goto all;
+            }
+
+            columns[changed_count] = column;
+            versions[changed_count] = mon;
+            changed_count ++;
+        }
+    }
+
+    if (!changed_count) {
+        return false;
+    }
+
+    cur = offset + *row;
+    last = offset + it->count;
+    while (cur < last) {
+        int32_t chunk = cur >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+        if (flecs_query_check_chunk_monitor(
+            chunks, columns, versions, changed_count, chunk))
+        {
+            if (first == -1) {
+                first = cur;
+            }
+        } else if (first != -1) {
+            break;
+        }
+
+        cur = (chunk + 1) << FLECS_TABLE_DIRTY_CHUNK_BITS;
+    }
+
+    if (first == -1) {
+        return false;
+    }
+
+    *row = first - offset;
+    *count = ECS_MIN(cur, last) - first;
+    return true;
+all:
+    *count = it->count - *row;
+    return true;
+}
+
 /* Check if one or more fields of a specific match have changed. */
 static bool flecs_query_check_table_monitor_match(
     ecs_query_impl_t *impl,
@@ -495,14 +632,20 @@ void flecs_query_mark_fields_dirty(
 
         ecs_entity_t src = it->sources[i];
         ecs_table_t *table;
+        int32_t row, count;
         if (!src) {
             table = it->table;
+            row = it->offset;
+            count = it->count;
         } else {
             ecs_record_t *r = flecs_entities_get(world, src);
             if (!r || !(table = r->table)) {
                 continue;
             }
 
+            row = ECS_RECORD_TO_ROW(r->row);
+            count = 1;
+
             if (q->shared_readonly_fields & flecs_ito(uint32_t, 1 << i)) {
                 /* Shared fields that aren't marked explicitly as out/inout
                  * default to readonly */
@@ -522,14 +665,17 @@ void flecs_query_mark_fields_dirty(
         ecs_assert(type_index >= 0, ECS_INTERNAL_ERROR, NULL);
 
         ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
-        int32_t *dirty_state = table->dirty_state;
-        if (!dirty_state) {
+        if (!table->dirty_state) {
             continue;
         }
 
         ecs_assert(type_index < table->type.count, ECS_INTERNAL_ERROR, NULL);
         int32_t column = table->column_map[type_index];
-        dirty_state[column + 1] ++;
+        if (column == -1) {
+            continue; /* Tags don't have data that can change */
+        }
+
+        flecs_table_mark_column_dirty(table, column, row, count);
     }
 }
 
@@ -561,8 +707,7 @@ void flecs_query_mark_fixed_fields_dirty(
             continue;
         }
 
-        int32_t *dirty_state = table->dirty_state;
-        if (!dirty_state) {
+        if (!table->dirty_state) {
             continue;
         }
 
@@ -575,7 +720,8 @@ void flecs_query_mark_fixed_fields_dirty(
         }
         ecs_assert(tr->column >= 0, ECS_INTERNAL_ERROR, NULL);
         int32_t column = table->column_map[tr->index];
-        dirty_state[column + 1] ++;
+        flecs_table_mark_column_dirty(
+            table, column, ECS_RECORD_TO_ROW(r->row), 1);
     }
 }
 
@@ -713,6 +859,52 @@ error:
     return false;
 }
 
+/* Public API call to find the changed rows in the currently iterated result. */
+bool ecs_iter_changed_rows(
+    ecs_iter_t *it,
+    int32_t *row,
+    int32_t *count)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(row != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_query_next, ECS_UNSUPPORTED, NULL);
+    ecs_check(ECS_BIT_IS_SET(it->flags, EcsIterIsValid),
+        ECS_INVALID_PARAMETER, NULL);
+    ecs_check(*row >= 0, ECS_INVALID_PARAMETER, NULL);
+
+    if (*row >= it->count) {
+        return false;
+    }
+
+    ecs_query_impl_t *impl = flecs_query_impl(it->query);
+    ecs_query_t *q = &impl->pub;
+
+    /* Changes to terms with fixed sources apply to all rows */
+    if (q->read_fields & q->fixed_fields) {
+        if (!(it->flags & EcsIterFixedInChangeComputed)) {
+            it->flags |= EcsIterFixedInChangeComputed;
+            ECS_BIT_COND(it->flags, EcsIterFixedInChanged,
+                flecs_query_check_fixed_monitor(impl));
+        }
+
+        if (it->flags & EcsIterFixedInChanged) {
+            *count = it->count - *row;
+            return true;
+        }
+    }
+
+    if (impl->cache) {
+        ecs_query_cache_match_t *qm = 
+            (ecs_query_cache_match_t*)it->priv_.iter.query.elem;
+        ecs_check(qm != NULL, ECS_INVALID_PARAMETER, NULL);
+        return flecs_query_check_match_monitor_rows(impl, qm, it, row, count);
+    }
+
+error:
+    return false;
+}
+
 /* Public API call for skipping change detection (don't mark fields dirty) */
 void ecs_iter_skip(
     ecs_iter_t *it)
@@ -9,6 +9,27 @@
 
 ECS_SORT_TABLE_WITH_COMPARE(_, flecs_query_cache_sort_table_generic, order_by, static)
 
+/* Tables that were sorted before stay sorted when entities are deleted from
+ * tables with the StableOrder trait, so test this before sorting. */
+static bool flecs_query_cache_table_is_sorted(
+    const ecs_entity_t *entities,
+    const void *ptr,
+    int32_t size,
+    int32_t count,
+    ecs_order_by_action_t compare)
+{
+    int32_t i;
+    for (i = 1; i < count; i ++) {
+        if (compare(entities[i - 1], ECS_ELEM(ptr, size, i - 1), 
+            entities[i], ECS_ELEM(ptr, size, i)) > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static void flecs_query_cache_sort_table(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -36,6 +57,12 @@ static void flecs_query_cache_sort_table(
         ptr = column->data;
     }
 
+    if (table->_->stable_order && flecs_query_cache_table_is_sorted(
+        entities, ptr, size, count, compare))
+    {
+        return;
+    }
+
     if (sort) {
         sort(world, table, entities, ptr, size, 0, count - 1, compare);
     } else {
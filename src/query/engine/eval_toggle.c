@@ -266,6 +266,33 @@ next_block:
     int32_t row = tz + (block_index * 64);
     cur = tz + run_len + (block_index * 64);
 
+    /* If the run ends at the end of the block, it may continue in the next
+     * blocks. Extend it a block at a time, so that a span of enabled entities
+     * is returned as a single result instead of one result per block. */
+    if ((tz + run_len) == 64) {
+        while (cur < last) {
+            flecs_query_row_mask_t row_mask = flecs_query_get_row_mask(
+                it, table, block_index + 1, and_fields, not_fields, op_ctx);
+            ecs_assert(row_mask.has_bitset, ECS_INTERNAL_ERROR, NULL);
+
+            block_index ++;
+            block = row_mask.mask;
+
+            int32_t len = 64;
+            if (~block != 0ull) {
+                len = flecs_ctz64(~block);
+            }
+
+            cur = ECS_MIN(cur + len, last);
+            if (len != 64) {
+                break;
+            }
+        }
+
+        op_ctx->block_index = block_index;
+        op_ctx->block = block;
+    }
+
     ecs_assert(cur <= last, ECS_INTERNAL_ERROR, NULL);
 
     if (!(cur - row)) {
@@ -46,6 +46,10 @@ int flecs_query_trivial_has_range(
     int32_t offset,
     int32_t count);
 
+/* Estimate number of matched entities without evaluating the query */
+int32_t flecs_query_entity_count_estimate(
+    const ecs_query_t *q);
+
 /* Internal function for initializing an iterator after vars are constrained */
 void flecs_query_iter_constrain(
     ecs_iter_t *it);
@@ -2077,7 +2077,7 @@ int flecs_query_finalize_query(
         "ecs_query_desc_t was not initialized to zero");
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
-    if ((desc->flags & EcsQueryDetectChanges) &&
+    if ((desc->flags & (EcsQueryDetectChanges|EcsQueryDetectRowChanges)) &&
         (desc->order_by || desc->order_by_callback))
     {
         ecs_query_validator_ctx_t ctx = {0};
@@ -47,6 +47,9 @@ static void flecs_stage_merge(
             flecs_poly_assert(s, ecs_stage_t);
             flecs_defer_end(world, s);
         }
+
+        /* Merge commands enqueued by threads that don't own a stage */
+        flecs_async_merge(world);
     }
 
     if (measure_frame_time) {
@@ -171,6 +174,27 @@ ecs_stack_t* flecs_stage_get_stack_allocator(
     return &stage->allocators.iter_stack;
 }
 
+static void flecs_stack_first_touch(
+    ecs_stack_t *stack)
+{
+    /* Getting a cursor allocates the first page if the stack doesn't have one
+     * yet. Restoring the cursor keeps the page. */
+    flecs_stack_restore_cursor(stack, flecs_stack_get_cursor(stack));
+}
+
+void flecs_stage_first_touch(
+    ecs_stage_t *stage)
+{
+    flecs_poly_assert(stage, ecs_stage_t);
+
+    /* Stage allocators allocate lazily, so memory is placed on the NUMA node
+     * of the thread that first uses it. Make sure the pages that are used 
+     * every frame are owned by the thread calling this function. */
+    flecs_stack_first_touch(&stage->allocators.iter_stack);
+    flecs_stack_first_touch(&stage->cmd_stack[0].stack);
+    flecs_stack_first_touch(&stage->cmd_stack[1].stack);
+}
+
 ecs_world_t* ecs_stage_new(
     ecs_world_t *world)
 {
@@ -458,8 +482,8 @@ void ecs_stage_shrink(
 {
     flecs_sparse_shrink(&stage->cmd_stack[0].entries);
     flecs_sparse_shrink(&stage->cmd_stack[1].entries);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, ecs_cmd_t);
-    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, ecs_cmd_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[0].queue, uint8_t);
+    ecs_vec_reclaim_t(&stage->allocator, &stage->cmd_stack[1].queue, uint8_t);
 }
 
 bool ecs_is_deferred(
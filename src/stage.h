@@ -64,6 +64,14 @@ struct ecs_stage_t {
     ecs_vec_t variables;
     ecs_vec_t operations;
 
+#ifdef FLECS_PIPELINE
+    /* Statistics for work stealing scheduler */
+    ecs_worker_stats_t worker_stats;
+
+    /* Set when the worker is signaled to start/resume work */
+    int32_t worker_signaled;
+#endif
+
 #ifdef FLECS_SCRIPT
     /* Thread-specific runtime for script execution */
     ecs_script_runtime_t *runtime;
@@ -88,6 +96,10 @@ ecs_allocator_t* flecs_stage_get_allocator(
 ecs_stack_t* flecs_stage_get_stack_allocator(
     ecs_world_t *world);
 
+/* Allocate first pages of stage allocators from the calling thread. */
+void flecs_stage_first_touch(
+    ecs_stage_t *stage);
+
 /* Shrink memory for stage data structures. */
 void ecs_stage_shrink(
     ecs_stage_t *stage);
@@ -0,0 +1,368 @@
+/**
+ * @file storage/cold_storage.c
+ * @brief Storage region for columns of cold components.
+ */
+
+#include "../private_api.h"
+
+struct ecs_cold_page_t {
+    ecs_cold_page_t *next;
+    ecs_cold_page_t *prev;
+    int32_t index;                   /* Order of page in region */
+    ecs_size_t size;                 /* Size of block area of page */
+};
+
+struct ecs_cold_block_t {
+    ecs_cold_page_t *page;
+    ecs_cold_block_t *next_free;     /* Free list (free blocks only) */
+    ecs_cold_block_t *prev_free;
+    ecs_size_t size;                 /* Size of block including header */
+    ecs_size_t prev_size;            /* Size of previous block, 0 if first */
+    bool used;
+};
+
+#define FLECS_COLD_PAGE_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_page_t), FLECS_COLD_ALIGNMENT)
+#define FLECS_COLD_BLOCK_HEADER \
+    ECS_ALIGN(ECS_SIZEOF(ecs_cold_block_t), FLECS_COLD_ALIGNMENT)
+
+/* Blocks aren't split if the remainder would be smaller than this */
+#define FLECS_COLD_BLOCK_MIN \
+    (FLECS_COLD_BLOCK_HEADER + FLECS_COLD_ALIGNMENT)
+
+static
+ecs_cold_block_t* flecs_cold_block_of(
+    const void *ptr)
+{
+    return ECS_CAST(ecs_cold_block_t*,
+        ECS_CAST(char*, ECS_CONST_CAST(void*, ptr)) - FLECS_COLD_BLOCK_HEADER);
+}
+
+static
+ecs_size_t flecs_cold_block_size(
+    ecs_size_t size)
+{
+    ecs_assert(size > 0, ECS_INTERNAL_ERROR, NULL);
+    return FLECS_COLD_BLOCK_HEADER + ECS_ALIGN(size, FLECS_COLD_ALIGNMENT);
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_next(
+    const ecs_cold_block_t *block)
+{
+    const ecs_cold_page_t *page = block->page;
+    const char *end = ECS_CAST(const char*, page) +
+        FLECS_COLD_PAGE_HEADER + page->size;
+    const char *next = ECS_CAST(const char*, block) + block->size;
+    if (next >= end) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*, next));
+}
+
+static
+ecs_cold_block_t* flecs_cold_block_prev(
+    const ecs_cold_block_t *block)
+{
+    if (!block->prev_size) {
+        return NULL;
+    }
+    return ECS_CAST(ecs_cold_block_t*, ECS_CONST_CAST(char*,
+        ECS_CAST(const char*, block) - block->prev_size));
+}
+
+/* Update back reference of the block that follows block */
+static
+void flecs_cold_block_link_next(
+    ecs_cold_block_t *block)
+{
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next) {
+        next->prev_size = block->size;
+    }
+}
+
+/* Returns whether block a is stored at a lower address in the region than b */
+static
+bool flecs_cold_block_before(
+    const ecs_cold_block_t *a,
+    const ecs_cold_block_t *b)
+{
+    if (a->page != b->page) {
+        return a->page->index < b->page->index;
+    }
+    return a < b;
+}
+
+static
+void flecs_cold_free_list_insert(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    block->prev_free = NULL;
+    block->next_free = storage->free_list;
+    if (storage->free_list) {
+        storage->free_list->prev_free = block;
+    }
+    storage->free_list = block;
+}
+
+static
+void flecs_cold_free_list_remove(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        ecs_assert(storage->free_list == block, ECS_INTERNAL_ERROR, NULL);
+        storage->free_list = block->next_free;
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+}
+
+static
+ecs_cold_block_t* flecs_cold_page_new(
+    ecs_cold_storage_t *storage,
+    ecs_size_t block_size)
+{
+    ecs_size_t size = FLECS_COLD_PAGE_SIZE - FLECS_COLD_PAGE_HEADER;
+    if (block_size > size) {
+        size = block_size;
+    }
+
+    ecs_cold_page_t *page = ecs_os_malloc(FLECS_COLD_PAGE_HEADER + size);
+    if (!page) {
+        return NULL;
+    }
+
+    page->index = storage->page_index ++;
+    page->size = size;
+    page->next = NULL;
+    page->prev = storage->last;
+    if (storage->last) {
+        storage->last->next = page;
+    } else {
+        storage->first = page;
+    }
+    storage->last = page;
+    storage->bytes_reserved += FLECS_COLD_PAGE_HEADER + size;
+
+    ecs_cold_block_t *block = ECS_OFFSET(page, FLECS_COLD_PAGE_HEADER);
+    block->page = page;
+    block->size = size;
+    block->prev_size = 0;
+    block->used = false;
+    flecs_cold_free_list_insert(storage, block);
+    return block;
+}
+
+static
+void flecs_cold_page_free(
+    ecs_cold_storage_t *storage,
+    ecs_cold_page_t *page)
+{
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        storage->first = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    } else {
+        storage->last = page->prev;
+    }
+
+    storage->bytes_reserved -= FLECS_COLD_PAGE_HEADER + page->size;
+    ecs_os_free(page);
+}
+
+/* Return unused block to the region. The block is merged with adjacent free
+ * blocks, and the page is freed if the block covers the entire page. */
+static
+void flecs_cold_block_release(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block)
+{
+    ecs_assert(!block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *next = flecs_cold_block_next(block);
+    if (next && !next->used) {
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_block_t *prev = flecs_cold_block_prev(block);
+    if (prev && !prev->used) {
+        flecs_cold_free_list_remove(storage, prev);
+        prev->size += block->size;
+        block = prev;
+        flecs_cold_block_link_next(block);
+    }
+
+    ecs_cold_page_t *page = block->page;
+    if (block->size == page->size) {
+        flecs_cold_page_free(storage, page);
+    } else {
+        flecs_cold_free_list_insert(storage, block);
+    }
+}
+
+/* Split off the part of a used block that is not needed to store size bytes */
+static
+void flecs_cold_block_trim(
+    ecs_cold_storage_t *storage,
+    ecs_cold_block_t *block,
+    ecs_size_t block_size)
+{
+    ecs_size_t remainder = block->size - block_size;
+    if (remainder < FLECS_COLD_BLOCK_MIN) {
+        return;
+    }
+
+    block->size = block_size;
+    storage->bytes_used -= remainder;
+
+    ecs_cold_block_t *rest = ECS_OFFSET(block, block_size);
+    rest->page = block->page;
+    rest->size = remainder;
+    rest->prev_size = block_size;
+    rest->used = false;
+    flecs_cold_block_link_next(rest);
+    flecs_cold_block_release(storage, rest);
+}
+
+static
+void* flecs_cold_alloc_intern(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const ecs_cold_block_t *limit)
+{
+    ecs_size_t block_size = flecs_cold_block_size(size);
+
+    /* Find the free block with the lowest address that fits */
+    ecs_cold_block_t *cur, *block = NULL;
+    for (cur = storage->free_list; cur; cur = cur->next_free) {
+        if (cur->size < block_size) {
+            continue;
+        }
+        if (limit && !flecs_cold_block_before(cur, limit)) {
+            continue;
+        }
+        if (!block || flecs_cold_block_before(cur, block)) {
+            block = cur;
+        }
+    }
+
+    if (!block) {
+        if (limit) {
+            return NULL;
+        }
+
+        block = flecs_cold_page_new(storage, block_size);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    flecs_cold_free_list_remove(storage, block);
+    block->used = true;
+    storage->bytes_used += block->size;
+    flecs_cold_block_trim(storage, block, block_size);
+
+    return ECS_OFFSET(block, FLECS_COLD_BLOCK_HEADER);
+}
+
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage)
+{
+    ecs_os_zeromem(storage);
+}
+
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage)
+{
+    ecs_assert(storage->bytes_used == 0, ECS_INTERNAL_ERROR,
+        "cold storage region still has blocks in use");
+
+    ecs_cold_page_t *page = storage->first;
+    while (page) {
+        ecs_cold_page_t *next = page->next;
+        ecs_os_free(page);
+        page = next;
+    }
+
+    ecs_os_zeromem(storage);
+}
+
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size)
+{
+    return flecs_cold_alloc_intern(storage, size, NULL);
+}
+
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+    return flecs_cold_alloc_intern(storage, size, flecs_cold_block_of(ptr));
+}
+
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+    block->used = false;
+    storage->bytes_used -= block->size;
+    flecs_cold_block_release(storage, block);
+}
+
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size)
+{
+    ecs_assert(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_cold_block_t *block = flecs_cold_block_of(ptr);
+    ecs_assert(block->used, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_size_t block_size = flecs_cold_block_size(size);
+    if (block_size > block->size) {
+        ecs_cold_block_t *next = flecs_cold_block_next(block);
+        if (!next || next->used ||
+            ((block->size + next->size) < block_size))
+        {
+            return false;
+        }
+
+        flecs_cold_free_list_remove(storage, next);
+        block->size += next->size;
+        storage->bytes_used += next->size;
+        flecs_cold_block_link_next(block);
+    }
+
+    flecs_cold_block_trim(storage, block, block_size);
+    return true;
+}
+
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage)
+{
+    return (storage->bytes_reserved - storage->bytes_used) >=
+        FLECS_COLD_PAGE_SIZE;
+}
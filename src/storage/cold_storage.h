@@ -0,0 +1,69 @@
+/**
+ * @file storage/cold_storage.h
+ * @brief Storage region for columns of cold components.
+ *
+ * Columns of components with the Cold trait are stored in a per-world region
+ * that is separate from the storage of other columns. The region consists of
+ * pages that are packed with column blocks. Blocks are allocated first-fit in
+ * address order, so that the data of cold columns stays at the start of the
+ * region. Pages that no longer contain any blocks are returned to the OS.
+ */
+
+#ifndef FLECS_COLD_STORAGE_H
+#define FLECS_COLD_STORAGE_H
+
+/* Minimum size of a page in the cold region */
+#define FLECS_COLD_PAGE_SIZE (64 * 1024)
+
+/* Alignment of blocks in the cold region */
+#define FLECS_COLD_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+typedef struct ecs_cold_page_t ecs_cold_page_t;
+typedef struct ecs_cold_block_t ecs_cold_block_t;
+
+typedef struct ecs_cold_storage_t {
+    ecs_cold_page_t *first;          /* Pages in the order they were created */
+    ecs_cold_page_t *last;
+    ecs_cold_block_t *free_list;     /* Blocks that are not in use */
+    int32_t page_index;              /* Index assigned to the next page */
+    ecs_size_t bytes_reserved;       /* Bytes allocated for pages */
+    ecs_size_t bytes_used;           /* Bytes of blocks that are in use */
+} ecs_cold_storage_t;
+
+/* Initialize cold storage region. */
+void flecs_cold_storage_init(
+    ecs_cold_storage_t *storage);
+
+/* Free all pages of the cold storage region. */
+void flecs_cold_storage_fini(
+    ecs_cold_storage_t *storage);
+
+/* Allocate block. Returns memory aligned to FLECS_COLD_ALIGNMENT. */
+void* flecs_cold_alloc(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size);
+
+/* Allocate block at a lower address in the region than ptr. Returns NULL if
+ * there is no space for the block before ptr. */
+void* flecs_cold_alloc_before(
+    ecs_cold_storage_t *storage,
+    ecs_size_t size,
+    const void *ptr);
+
+/* Free block. Pages that become empty are returned to the OS. */
+void flecs_cold_free(
+    ecs_cold_storage_t *storage,
+    void *ptr);
+
+/* Resize block without moving it. Returns false if the block can't grow in
+ * place, in which case the block is not modified. */
+bool flecs_cold_resize(
+    ecs_cold_storage_t *storage,
+    void *ptr,
+    ecs_size_t size);
+
+/* Returns whether compacting the region could release at least one page. */
+bool flecs_cold_storage_fragmented(
+    const ecs_cold_storage_t *storage);
+
+#endif
@@ -323,6 +323,7 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             /* Target determines the type, so unset storage flags */
             result &= ~EcsIdSparse;
             result &= ~EcsIdDontFragment;
+            result &= ~EcsIdCold;
 
             if (ecs_owns_id(world, tgt, EcsSparse)) {
                 result |= EcsIdSparse;
@@ -331,6 +332,10 @@ static ecs_flags32_t flecs_component_get_flags_intern(
             if (ecs_owns_id(world, tgt, EcsDontFragment)) {
                 result |= EcsIdDontFragment;
             }
+
+            if (ecs_owns_id(world, tgt, EcsCold)) {
+                result |= EcsIdCold;
+            }
         }
     } else {
         /* Disable flags that only apply to pairs */
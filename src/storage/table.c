@@ -132,6 +132,9 @@ static void flecs_table_init_columns(
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, -(i + 1));
         }
+        if (table->_->records[i].hdr.cr->flags & EcsIdStableOrder) {
+            table->_->stable_order = true;
+        }
     }
 
     if (!column_count) {
@@ -163,6 +166,12 @@ static void flecs_table_init_columns(
         flecs_table_cache_set_column(&cr->cache, table, tr->column);
 
         columns[cur].ti = ECS_CONST_CAST(ecs_type_info_t*, ti);
+        if (ti->soa) {
+            columns[cur].flags = EcsColumnSoA;
+        }
+        if (cr->flags & EcsIdCold) {
+            columns[cur].flags |= EcsColumnCold;
+        }
         
         if (id < FLECS_HI_COMPONENT_ID) {
             table->component_map[id] = flecs_ito(int16_t, cur + 1);
@@ -314,6 +323,10 @@ static void flecs_table_init_flags(
             table->trait_flags |= EcsIdSparse;
         } else if (id == EcsDontFragment) {
             table->trait_flags |= EcsIdDontFragment;
+        } else if (id == EcsCold) {
+            table->trait_flags |= EcsIdCold;
+        } else if (id == EcsStableOrder) {
+            table->trait_flags |= EcsIdStableOrder;
         } else if (id ==  EcsExclusive) {
             table->trait_flags |= EcsIdExclusive;   
         } else if (id == EcsTraversable) {
@@ -446,6 +459,60 @@ static void flecs_table_init_overrides(
     table->data.overrides = o;
 }
 
+/* Make sure there is a version stamp for each chunk of rows in the storage of
+ * the table. Stamps are only resized here, on the thread that owns the table
+ * storage, so that workers can mark rows dirty without allocating. */
+static void flecs_table_dirty_chunks_set_size(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t chunk_count = (table->data.size + FLECS_TABLE_DIRTY_CHUNK - 1) 
+        >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_set_min_count_zeromem_t(
+            &world->allocator, &chunks[i], int32_t, chunk_count);
+    }
+}
+
+/* Free row change tracking data */
+static void flecs_table_fini_dirty_chunks(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks) {
+        return;
+    }
+
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        ecs_vec_fini_t(&world->allocator, &chunks[i], int32_t);
+    }
+
+    flecs_free_n(&world->allocator, ecs_vec_t, count, chunks);
+    table->_->dirty_chunks = NULL;
+}
+
+static void flecs_table_fini_row_order(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
+
+    ecs_vec_fini_t(&world->allocator, &row_order->keys, int32_t);
+    flecs_free_t(&world->allocator, ecs_table_row_order_t, row_order);
+    table->_->row_order = NULL;
+}
+
 static void flecs_table_fini_overrides(
     ecs_world_t *world, 
     ecs_table_t *table)
@@ -945,6 +1012,67 @@ static void flecs_table_invoke_hook(
         table->type.array[type_index], column->ti, event, callback, NULL);
 }
 
+/* Zero initialize rows of a column with struct-of-arrays storage. The only 
+ * constructor that struct-of-arrays components can have is the default ctor. */
+static void flecs_table_column_soa_zero(
+    void *data,
+    int32_t capacity,
+    int32_t row,
+    int32_t count,
+    const ecs_soa_layout_t *soa)
+{
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &soa->members[i];
+        ecs_os_memset(ECS_OFFSET(data, m->offset * capacity + m->size * row),
+            0, m->size * count);
+    }
+}
+
+/* Copy value of inherited struct-of-arrays component into overriding rows. 
+ * Members of the base are gathered into a temporary value, which is then 
+ * scattered into the member arrays of the instances. */
+static void flecs_table_soa_override(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_entity_t base,
+    ecs_id_t id,
+    int32_t row,
+    int32_t count,
+    const ecs_type_info_t *ti)
+{
+    ecs_record_t *r = flecs_entities_get(world, base);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_table_t *base_table = r->table;
+    ecs_assert(base_table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, base_table);
+    ecs_assert(tr != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(tr->column != -1, ECS_INTERNAL_ERROR, NULL);
+
+    void *value = ecs_os_alloca(ti->size);
+    flecs_table_soa_get(
+        base_table, tr->column, ECS_RECORD_TO_ROW(r->row), value);
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        flecs_table_soa_set(table, column_index, row + i, value);
+    }
+
+    ecs_iter_action_t on_set = ti->hooks.on_set;
+    if (on_set) {
+        int32_t record_index = table->column_map[table->type.count + column_index];
+        const ecs_table_record_t *dst_tr = &table->_->records[record_index];
+        const ecs_entity_t *entities = &ecs_table_entities(table)[row];
+        flecs_invoke_hook(world, table, dst_tr->hdr.cr, dst_tr->column,
+            count, row, entities, ti->component, ti, EcsOnSet,
+            on_set, NULL);
+    }
+}
+
 static void flecs_table_invoke_ctor_for_array(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -962,6 +1090,12 @@ static void flecs_table_invoke_ctor_for_array(
             if (r->entity) {
                 ecs_id_t id = table->type.array[
                     table->column_map[table->type.count + column_index]];
+                if (ti->soa) {
+                    flecs_table_soa_override(world, table, column_index, 
+                        r->entity, id, row, count, ti);
+                    return;
+                }
+
                 void *base_ptr = ecs_ref_get_id(world, r, id);
                 ecs_assert(base_ptr != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -991,6 +1125,15 @@ static void flecs_table_invoke_ctor_for_array(
         }
     }
 
+    if (ti->soa) {
+        ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (ti->hooks.ctor) {
+            flecs_table_column_soa_zero(
+                array, table->data.size, row, count, ti->soa);
+        }
+        return;
+    }
+
     flecs_type_info_ctor(ptr, count, ti);
 }
 
@@ -1152,6 +1295,431 @@ static void flecs_table_dtor_all(
 #define FLECS_LOCKED_STORAGE_MSG(operation) \
     "a " #operation " operation failed because the table is locked, fix by surrounding the operation with defer_begin()/defer_end()"
 
+/* Alignment of memory returned by the OS API malloc function */
+#define FLECS_COLUMN_HEAP_ALIGNMENT (2 * ECS_SIZEOF(void*))
+
+/* Columns that require a larger alignment than what malloc provides and paged
+ * columns store a header just before the column data. */
+typedef struct ecs_column_header_t {
+    void *base;                      /* Start of allocation or reserved range */
+    ecs_size_t reserved;             /* Reserved bytes (paged columns only) */
+    ecs_size_t committed;            /* Committed bytes (paged columns only) */
+} ecs_column_header_t;
+
+static
+ecs_column_header_t* flecs_table_column_header(
+    const ecs_column_t *column)
+{
+    ecs_assert(column->flags & (EcsColumnPaged|EcsColumnAligned), 
+        ECS_INTERNAL_ERROR, NULL);
+    return ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, column->data) - ECS_SIZEOF(ecs_column_header_t));
+}
+
+/* Get alignment for column storage of component */
+static
+ecs_size_t flecs_table_column_alignment(
+    const ecs_world_t *world,
+    const ecs_type_info_t *ti)
+{
+    ecs_size_t alignment = world->column_alignment;
+    if (ti->alignment > alignment) {
+        alignment = ti->alignment;
+    }
+    return alignment;
+}
+
+/* Allocate column storage with an alignment that is larger than what malloc
+ * guarantees. */
+static
+void* flecs_table_column_alloc_aligned(
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t header = ECS_SIZEOF(ecs_column_header_t);
+    void *base = ecs_os_malloc(size + header + alignment);
+    if (!base) {
+        return NULL;
+    }
+
+    uintptr_t addr = (uintptr_t)base + (uintptr_t)header;
+    addr = (addr + (uintptr_t)alignment - 1) & ~((uintptr_t)alignment - 1);
+
+    void *result = (void*)addr;
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - header);
+    hdr->base = base;
+    hdr->reserved = 0;
+    hdr->committed = 0;
+    return result;
+}
+
+/* Paged columns reserve a range of address space up front, and commit memory
+ * to the range as the table grows. This keeps column data contiguous, while
+ * ensuring that growing a large column never has to move its elements. Column
+ * data starts at least one cache line after the start of the range. */
+static
+ecs_size_t flecs_table_column_pages_offset(
+    ecs_size_t alignment)
+{
+    return alignment > 64 ? alignment : 64;
+}
+
+/* Round number of bytes to commit up to the column page size */
+static
+ecs_size_t flecs_table_column_pages_round(
+    const ecs_world_t *world,
+    int64_t bytes,
+    ecs_size_t reserved)
+{
+    int64_t page_size = world->column_page_size;
+    if (page_size > 0) {
+        bytes = ((bytes + page_size - 1) / page_size) * page_size;
+    }
+    if (bytes > reserved) {
+        bytes = reserved;
+    }
+    return (ecs_size_t)bytes;
+}
+
+/* Reserve address range for paged column that can hold at least size bytes */
+static
+void* flecs_table_column_reserve(
+    ecs_world_t *world,
+    ecs_size_t size,
+    ecs_size_t alignment)
+{
+    ecs_size_t offset = flecs_table_column_pages_offset(alignment);
+    int64_t needed = (int64_t)size + offset;
+    int64_t reserve = FLECS_COLUMN_RESERVE_SIZE;
+    while (reserve < (needed * 2)) {
+        reserve *= 2;
+    }
+    if (reserve > INT32_MAX) {
+        reserve = INT32_MAX;
+    }
+    if (needed > reserve) {
+        return NULL;
+    }
+
+    void *base = ecs_os_reserve((ecs_size_t)reserve);
+    if (!base) {
+        return NULL;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, (ecs_size_t)reserve);
+    if (!ecs_os_commit(base, commit)) {
+        ecs_os_release(base, (ecs_size_t)reserve);
+        return NULL;
+    }
+
+    void *result = ECS_OFFSET(base, offset);
+    ecs_column_header_t *hdr = ECS_CAST(ecs_column_header_t*, 
+        ECS_CAST(char*, result) - ECS_SIZEOF(ecs_column_header_t));
+    hdr->base = base;
+    hdr->reserved = (ecs_size_t)reserve;
+    hdr->committed = commit;
+    return result;
+}
+
+/* Commit or decommit memory so a paged column can hold size bytes. Returns 
+ * false if the reserved range is too small, or if memory could not be 
+ * committed. In that case the caller must move the column. */
+static
+bool flecs_table_column_commit(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    ecs_size_t size)
+{
+    ecs_column_header_t *hdr = flecs_table_column_header(column);
+    int64_t offset = ECS_CAST(char*, column->data) - ECS_CAST(char*, hdr->base);
+    int64_t needed = (int64_t)size + offset;
+    if (needed > hdr->reserved) {
+        return false;
+    }
+
+    ecs_size_t commit = flecs_table_column_pages_round(
+        world, needed, hdr->reserved);
+    if (commit > hdr->committed) {
+        if (!ecs_os_commit(ECS_OFFSET(hdr->base, hdr->committed), 
+            commit - hdr->committed)) 
+        {
+            return false;
+        }
+    } else if (commit < hdr->committed) {
+        ecs_os_decommit(ECS_OFFSET(hdr->base, commit), 
+            hdr->committed - commit);
+    }
+
+    hdr->committed = commit;
+    return true;
+}
+
+/* Free column storage */
+static
+void flecs_table_column_fini(
+    ecs_world_t *world,
+    ecs_column_t *column)
+{
+    if (column->flags & EcsColumnPaged) {
+        ecs_column_header_t *hdr = flecs_table_column_header(column);
+        ecs_os_release(hdr->base, hdr->reserved);
+    } else if (column->flags & EcsColumnAligned) {
+        if (column->data) {
+            ecs_os_free(flecs_table_column_header(column)->base);
+        }
+    } else if (column->flags & EcsColumnCold) {
+        flecs_cold_free(&world->store.cold, column->data);
+    } else if (column->data) {
+        ecs_os_free(column->data);
+    }
+
+    column->data = NULL;
+    column->flags &= ~EcsColumnStorageMask;
+}
+
+/* Move the member arrays of a column with struct-of-arrays storage to the 
+ * layout for a different capacity. Source and destination may be the same 
+ * storage, in which case members are moved in an order that ensures that no
+ * member array overwrites another member array that hasn't been moved yet. */
+static
+void flecs_table_column_soa_relayout(
+    const ecs_soa_layout_t *soa,
+    void *dst,
+    int32_t dst_capacity,
+    const void *src,
+    int32_t src_capacity,
+    int32_t count)
+{
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+
+    if (dst_capacity > src_capacity) {
+        for (i = member_count - 1; i >= 0; i --) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    } else {
+        for (i = 0; i < member_count; i ++) {
+            const ecs_soa_member_t *m = &members[i];
+            ecs_os_memmove(ECS_OFFSET(dst, m->offset * dst_capacity),
+                ECS_OFFSET(src, m->offset * src_capacity), m->size * count);
+        }
+    }
+}
+
+/* Copy rows between (or within) columns with struct-of-arrays storage */
+static
+void flecs_table_column_soa_copy(
+    ecs_column_t *dst,
+    int32_t dst_capacity,
+    int32_t dst_row,
+    const ecs_column_t *src,
+    int32_t src_capacity,
+    int32_t src_row,
+    int32_t count)
+{
+    const ecs_soa_layout_t *soa = dst->ti->soa;
+    ecs_assert(soa != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src->ti->soa == soa, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memmove(
+            ECS_OFFSET(dst->data, m->offset * dst_capacity + m->size * dst_row),
+            ECS_OFFSET(src->data, m->offset * src_capacity + m->size * src_row),
+            m->size * count);
+    }
+}
+
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_soa_layout_t *soa = column->ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            ECS_OFFSET(value, m->offset), m->size);
+    }
+}
+
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value)
+{
+    ecs_assert(column_index < table->column_count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row < table->data.count, ECS_INTERNAL_ERROR, NULL);
+    const ecs_column_t *column = &table->data.columns[column_index];
+    ecs_assert(column->flags & EcsColumnSoA, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = ti->soa;
+    const ecs_soa_member_t *members = soa->members;
+    int32_t i, member_count = soa->count, capacity = table->data.size;
+
+    /* Don't leave padding bytes uninitialized */
+    ecs_os_memset(value, 0, ti->size);
+
+    for (i = 0; i < member_count; i ++) {
+        const ecs_soa_member_t *m = &members[i];
+        ecs_os_memcpy(ECS_OFFSET(value, m->offset),
+            ECS_OFFSET(column->data, m->offset * capacity + m->size * row),
+            m->size);
+    }
+}
+
+/* Change size of column storage. When the column storage is moved, existing
+ * elements are moved with the ctor_move_dtor hook of the component. Columns 
+ * that are larger than the column page size of the world are stored in a 
+ * reserved address range, so that they can grow without moving. Column 
+ * storage is aligned to the largest of the component alignment and the column
+ * alignment of the world. Columns of cold components are stored in the cold 
+ * storage region of the world with the alignment of the component, and grow in
+ * place when the region has space after the column. The member arrays of columns with 
+ * struct-of-arrays storage are moved to the layout for the new size. */
+static
+void flecs_table_column_set_size(
+    ecs_world_t *world,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t dst_size)
+{
+    ecs_assert(dst_size >= count, ECS_INTERNAL_ERROR, NULL);
+
+    if (dst_size == size) {
+        return;
+    }
+
+    if (!dst_size) {
+        flecs_table_column_fini(world, column);
+        return;
+    }
+
+    const ecs_type_info_t *ti = column->ti;
+    const ecs_soa_layout_t *soa = 
+        (column->flags & EcsColumnSoA) && count ? ti->soa : NULL;
+    ecs_size_t dst_bytes = ti->size * dst_size;
+    ecs_size_t alignment = flecs_table_column_alignment(world, ti);
+
+    if (column->flags & EcsColumnPaged) {
+        bool is_aligned = 
+            !((uintptr_t)column->data & ((uintptr_t)alignment - 1));
+        if (is_aligned) {
+            if (soa && dst_size < size) {
+                /* Compact members before memory is decommitted */
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+                size = dst_size;
+            }
+
+            if (flecs_table_column_commit(world, column, dst_bytes)) {
+                if (soa && dst_size > size) {
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                }
+                return;
+            }
+        }
+    }
+
+    void *dst = NULL;
+    ecs_flags32_t dst_flags = 0;
+    ecs_size_t page_size = world->column_page_size;
+    if (column->flags & EcsColumnCold) {
+        /* Cold columns are not paged and only use the alignment of the 
+         * component, which keeps them compact. */
+        if (ti->alignment > FLECS_COLD_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, ti->alignment);
+            dst_flags = EcsColumnAligned;
+        } else {
+            ecs_cold_storage_t *cold = &world->store.cold;
+            if (column->data) {
+                if (soa && dst_size < size) {
+                    /* Compact members before the block is shrunk */
+                    flecs_table_column_soa_relayout(soa, column->data, 
+                        dst_size, column->data, size, count);
+                    size = dst_size;
+                }
+
+                if (flecs_cold_resize(cold, column->data, dst_bytes)) {
+                    if (soa && dst_size > size) {
+                        flecs_table_column_soa_relayout(soa, column->data, 
+                            dst_size, column->data, size, count);
+                    }
+                    return;
+                }
+            }
+
+            dst = flecs_cold_alloc(cold, dst_bytes);
+        }
+    } else if (page_size && dst_bytes > page_size && 
+        ecs_os_has_virtual_memory()) 
+    {
+        dst = flecs_table_column_reserve(world, dst_bytes, alignment);
+        if (dst) {
+            dst_flags = EcsColumnPaged;
+        }
+    }
+
+    if (!dst && !(column->flags & EcsColumnCold)) {
+        if (alignment > FLECS_COLUMN_HEAP_ALIGNMENT) {
+            dst = flecs_table_column_alloc_aligned(dst_bytes, alignment);
+            dst_flags = EcsColumnAligned;
+        } else if (!(column->flags & EcsColumnStorageMask) && 
+            (!count || !ti->hooks.ctor_move_dtor)) 
+        {
+            /* No elements need to be moved with hooks, realloc storage */
+            if (soa && dst_size < size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            column->data = ecs_os_realloc(column->data, dst_bytes);
+            if (soa && dst_size > size) {
+                flecs_table_column_soa_relayout(soa, column->data, dst_size, 
+                    column->data, size, count);
+            }
+            return;
+        } else {
+            dst = ecs_os_malloc(dst_bytes);
+        }
+    }
+
+    ecs_assert(dst != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    if (count) {
+        if (soa) {
+            flecs_table_column_soa_relayout(
+                soa, dst, dst_size, column->data, size, count);
+        } else if (ti->hooks.ctor_move_dtor) {
+            flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+        } else {
+            ecs_os_memcpy(dst, column->data, ti->size * count);
+        }
+    }
+
+    flecs_table_column_fini(world, column);
+    column->data = dst;
+    column->flags |= dst_flags;
+}
+
 /* Cleanup table storage */
 static void flecs_table_fini_data(
     ecs_world_t *world,
@@ -1173,10 +1741,7 @@ static void flecs_table_fini_data(
         if (columns) {
             int32_t c, column_count = table->column_count;
             for (c = 0; c < column_count; c ++) {
-                ecs_column_t *column = &columns[c];
-                ecs_vec_t v = ecs_vec_from_column(column, table, column->ti->size);
-                ecs_vec_fini(NULL, &v, column->ti->size);
-                column->data = NULL;
+                flecs_table_column_fini(world, &columns[c]);
             }
 
             flecs_wfree_n(world, ecs_column_t, table->column_count, columns);
@@ -1217,6 +1782,8 @@ static void flecs_table_fini_data(
         table->data.size = 0;
     }
 
+    flecs_table_fini_row_order(world, table);
+
     table->data.count = 0;
     table->_->traversable_count = 0;
     table->flags &= ~EcsTableHasTraversable;
@@ -1300,6 +1867,7 @@ void flecs_table_fini(
     }
 
     flecs_table_fini_overrides(world, table);
+    flecs_table_fini_dirty_chunks(world, table);
     flecs_wfree_n(world, int32_t, table->column_count + 1, table->dirty_state);
     ecs_os_free(table->column_map);
     if (table->component_map != flecs_table_empty_component_map) {
@@ -1376,11 +1944,45 @@ static void flecs_table_mark_table_dirty(
     }
 }
 
+/* Mark range of rows in table column dirty. If the table tracks row changes,
+ * stamp the chunks that contain the rows with the new column version. */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count)
+{
+    ecs_assert(table->dirty_state != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(column < table->column_count, ECS_INTERNAL_ERROR, NULL);
+
+    /* Column is offset by 1, 0 is reserved for entity column. */
+    int32_t version = ++ table->dirty_state[column + 1];
+
+    ecs_vec_t *chunks = table->_->dirty_chunks;
+    if (!chunks || count <= 0) {
+        return;
+    }
+
+    /* Stamps are sized when the table storage grows, so this doesn't have to
+     * allocate when called from multiple workers. */
+    int32_t first = row >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    int32_t last = (row + count - 1) >> FLECS_TABLE_DIRTY_CHUNK_BITS;
+    ecs_vec_t *stamps = &chunks[column];
+    ecs_assert(last < ecs_vec_count(stamps), ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i, *array = ecs_vec_first_t(stamps, int32_t);
+    for (i = first; i <= last; i ++) {
+        flecs_table_stamp_store(&array[i], version);
+    }
+}
+
 /* Mark table component dirty */
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component)
+    ecs_entity_t component,
+    int32_t row)
 {
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -1406,8 +2008,7 @@ void flecs_table_mark_dirty(
         }
 
         /* Column is offset by 1, 0 is reserved for entity column. */
-
-        table->dirty_state[column] ++;
+        flecs_table_mark_column_dirty(table, column - 1, row, 1);
 
         ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
             FLECS_LOCKED_STORAGE_MSG("dirty marking"));
@@ -1433,6 +2034,25 @@ int32_t* flecs_table_get_dirty_state(
     return table->dirty_state;
 }
 
+/* Enable row change tracking for table. Writes that happened before tracking
+ * was enabled are not stamped, which is fine since queries that need the
+ * stamps treat tables they haven't synchronized with as fully changed. */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (table->_->dirty_chunks || !table->column_count) {
+        return;
+    }
+
+    flecs_table_get_dirty_state(world, table);
+
+    table->_->dirty_chunks = flecs_calloc_n(
+        &world->allocator, ecs_vec_t, table->column_count);
+    flecs_table_dirty_chunks_set_size(world, table);
+}
+
 /* Table move logic for bitset (toggle component) column */
 static void flecs_table_move_bitset_columns(
     ecs_table_t *dst_table, 
@@ -1522,69 +2142,276 @@ static void flecs_table_move_bitset_columns(
     }
 }
 
-/* Grow table column. When a column needs to be reallocated this function takes
- * care of correctly invoking ctor/move/dtor hooks. */
-static void flecs_table_grow_column(
+/* Defer keeping the rows of a table with StableOrder in order until the current
+ * command flush is done. While deferred, removed rows are filled with the last
+ * row of the table, and the order of the table is restored once for all 
+ * removed rows by flecs_table_restore_row_order(). This avoids shifting the 
+ * tail of the table for each removed row. Returns false if rows must be kept 
+ * in order right away. */
+static bool flecs_table_defer_row_order(
     ecs_world_t *world,
-    ecs_table_t *table,
-    int32_t column_index,
-    ecs_vec_t *column,
-    const ecs_type_info_t *ti,
-    int32_t to_add,
-    int32_t dst_size,
-    bool construct)
+    ecs_table_t *table)
 {
-    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (table->_->row_order) {
+        return true;
+    }
 
-    int32_t count = ecs_vec_count(column);
-    int32_t size = ecs_vec_size(column);
-    int32_t elem_size = ti->size;
-    int32_t dst_count = count + to_add;
-    bool can_realloc = dst_size != size;
+    if (!world->store.defer_row_order) {
+        return false;
+    }
 
-    ecs_assert(dst_size >= dst_count, ECS_INTERNAL_ERROR, NULL);
+    /* Restoring the order moves values with ctor_move_dtor */
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        const ecs_type_info_t *ti = table->data.columns[i].ti;
+        if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+            return false;
+        }
+    }
 
-    /* If the array could possibly realloc and the component has a move action 
-     * defined, move old elements manually */
-    if (count && can_realloc && ti->hooks.ctor_move_dtor) {
-        ecs_assert(ti->hooks.ctor != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_allocator_t *a = &world->allocator;
+    ecs_table_row_order_t *row_order = flecs_alloc_t(a, ecs_table_row_order_t);
+    count = table->data.count;
+    ecs_vec_init_t(a, &row_order->keys, int32_t, count);
+    ecs_vec_set_count_t(a, &row_order->keys, int32_t, count);
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        keys[i] = i;
+    }
+    row_order->next = count;
 
-        /* Create vector */
-        ecs_vec_t dst;
-        ecs_vec_init(NULL, &dst, elem_size, dst_size);
-        dst.count = dst_count;
+    table->_->row_order = row_order;
+    ecs_vec_append_t(a, &world->store.unordered_tables, uint64_t)[0] = 
+        table->id;
 
-        void *src_buffer = column->array;
-        void *dst_buffer = dst.array;
+    return true;
+}
 
-        /* Move (and construct) existing elements to new vector */
-        flecs_type_info_ctor_move_dtor(dst_buffer, src_buffer, count, ti);
+/* Add keys for rows appended to a table of which rows are out of order */
+static void flecs_table_row_order_append(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t count)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    int32_t *keys = ecs_vec_grow_t(
+        &world->allocator, &row_order->keys, int32_t, count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        keys[i] = row_order->next ++;
+    }
+}
+
+/* Move values of a column so that row i gets the value of row src[i] */
+static void flecs_table_permute_column(
+    ecs_table_t *table,
+    int32_t column_index,
+    const int32_t *src,
+    bool *done,
+    void *tmp)
+{
+    ecs_column_t *column = &table->data.columns[column_index];
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t capacity = table->data.size;
+    bool soa = column->flags & EcsColumnSoA;
+    int32_t i, count = table->data.count;
 
-        if (construct) {
-            /* Construct new element(s) */
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, dst_buffer, count, to_add, ti);
+    ecs_os_memset_n(done, 0, bool, count);
+
+    for (i = 0; i < count; i ++) {
+        if (done[i] || src[i] == i) {
+            continue;
         }
 
-        /* Free old vector */
-        ecs_vec_fini(NULL, column, elem_size);
+        /* Rotate the values of the rows in the cycle that starts at row i */
+        if (soa) {
+            flecs_table_soa_get(table, column_index, i, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                tmp, ECS_ELEM(column->data, size, i), 1, ti);
+        }
 
-        *column = dst;
-    } else {
-        /* If array won't realloc or has no move, simply add new elements */
-        if (can_realloc) {
-            ecs_vec_set_size(NULL, column, elem_size, dst_size);
+        int32_t cur = i;
+        while (src[cur] != i) {
+            if (soa) {
+                flecs_table_column_soa_copy(column, capacity, cur, 
+                    column, capacity, src[cur], 1);
+            } else {
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, cur), 
+                    ECS_ELEM(column->data, size, src[cur]), 1, ti);
+            }
+            done[cur] = true;
+            cur = src[cur];
         }
 
-        ecs_vec_grow(NULL, column, elem_size, to_add);
+        if (soa) {
+            flecs_table_soa_set(table, column_index, cur, tmp);
+        } else {
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(column->data, size, cur), tmp, 1, ti);
+        }
+        done[cur] = true;
+    }
+}
+
+/* Sort the rows of a table by their row order key */
+static void flecs_table_restore_rows(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (!row_order) {
+        return;
+    }
+
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("restore row order"));
+
+    int32_t i, count = table->data.count, key_count = row_order->next;
+    ecs_assert(ecs_vec_count(&row_order->keys) == count, 
+        ECS_INTERNAL_ERROR, NULL);
+    if (!count) {
+        flecs_table_fini_row_order(world, table);
+        return;
+    }
+
+    /* Keys are unique and smaller than key_count, so rows can be sorted by
+     * looking up the row of each key. */
+    ecs_allocator_t *a = &world->allocator;
+    int32_t *src = flecs_alloc_n(a, int32_t, key_count);
+    bool *done = flecs_alloc_n(a, bool, count);
+    ecs_os_memset_n(src, -1, int32_t, key_count);
+
+    int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+    for (i = 0; i < count; i ++) {
+        src[keys[i]] = i;
+    }
 
-        if (construct) {
-            flecs_table_invoke_ctor_for_array(
-                world, table, column_index, column->array, count, to_add, ti);
+    int32_t dst = 0;
+    bool sorted = true;
+    for (i = 0; i < key_count; i ++) {
+        if (src[i] != -1) {
+            sorted &= src[i] == dst;
+            src[dst ++] = src[i];
         }
     }
 
-    ecs_assert(column->size == dst_size, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst == count, ECS_INTERNAL_ERROR, NULL);
+
+    if (!sorted) {
+        /* If the table is monitored, indicate that there has been a change */
+        flecs_table_mark_table_dirty(world, table, 0);
+
+        ecs_entity_t *entities = table->data.entities;
+        ecs_table__t *meta = table->_;
+        int32_t b, bs_count = meta->bs_count;
+        ecs_size_t tmp_size = ECS_MAX(ECS_SIZEOF(ecs_entity_t), bs_count);
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            tmp_size = ECS_MAX(tmp_size, table->data.columns[c].ti->size);
+        }
+
+        void *tmp = flecs_alloc(a, tmp_size);
+
+        for (c = 0; c < column_count; c ++) {
+            flecs_table_permute_column(table, c, src, done, tmp);
+        }
+
+        /* Permute entity ids and toggle bitsets */
+        ecs_os_memset_n(done, 0, bool, count);
+        for (i = 0; i < count; i ++) {
+            if (done[i] || src[i] == i) {
+                continue;
+            }
+
+            ecs_entity_t e = entities[i];
+            for (b = 0; b < bs_count; b ++) {
+                ECS_CAST(bool*, tmp)[b] = 
+                    flecs_bitset_get(&meta->bs_columns[b], i);
+            }
+
+            int32_t cur = i;
+            while (src[cur] != i) {
+                entities[cur] = entities[src[cur]];
+                for (b = 0; b < bs_count; b ++) {
+                    ecs_bitset_t *bs = &meta->bs_columns[b];
+                    flecs_bitset_set(bs, cur, flecs_bitset_get(bs, src[cur]));
+                }
+                done[cur] = true;
+                cur = src[cur];
+            }
+
+            entities[cur] = e;
+            for (b = 0; b < bs_count; b ++) {
+                flecs_bitset_set(&meta->bs_columns[b], cur, 
+                    ECS_CAST(bool*, tmp)[b]);
+            }
+            done[cur] = true;
+        }
+
+        flecs_free(a, tmp_size, tmp);
+
+        for (i = 0; i < count; i ++) {
+            if (src[i] == i) {
+                continue;
+            }
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
+        }
+    }
+
+    flecs_free_n(a, bool, count, done);
+    flecs_free_n(a, int32_t, key_count, src);
+    flecs_table_fini_row_order(world, table);
+
+    flecs_table_check_sanity(table);
+}
+
+void flecs_table_restore_row_order(
+    ecs_world_t *world)
+{
+    ecs_vec_t *tables = &world->store.unordered_tables;
+    int32_t i, count = ecs_vec_count(tables);
+    uint64_t *ids = ecs_vec_first_t(tables, uint64_t);
+    for (i = 0; i < count; i ++) {
+        /* Table could have been deleted while commands were flushed */
+        ecs_table_t *table = flecs_sparse_get_t(
+            &world->store.tables, ecs_table_t, ids[i]);
+        if (table) {
+            flecs_table_restore_rows(world, table);
+        }
+    }
+
+    ecs_vec_clear(tables);
+}
+
+/* Grow table column. When a column needs to be reallocated this function takes
+ * care of correctly invoking ctor/move/dtor hooks. */
+static void flecs_table_grow_column(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t column_index,
+    ecs_column_t *column,
+    int32_t count,
+    int32_t size,
+    int32_t to_add,
+    int32_t dst_size,
+    bool construct)
+{
+    ecs_assert(column != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_size >= (count + to_add), ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_column_set_size(world, column, count, size, dst_size);
+
+    if (construct) {
+        /* Construct new element(s) */
+        flecs_table_invoke_ctor_for_array(
+            world, table, column_index, column->data, count, to_add, column->ti);
+    }
 }
 
 /* Grow all data structures in a table */
@@ -1593,7 +2420,8 @@ static int32_t flecs_table_grow_data(
     ecs_table_t *table,
     int32_t to_add,
     int32_t size,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     flecs_poly_assert(world, ecs_world_t);
 
@@ -1628,6 +2456,11 @@ static int32_t flecs_table_grow_data(
     table->data.entities = v_entities.array;
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
+
+    if (to_add && table->_->row_order) {
+        flecs_table_row_order_append(world, table, to_add);
+    }
 
     /* Initialize entity ids and record ptrs */
     int32_t i;
@@ -1645,15 +2478,10 @@ static int32_t flecs_table_grow_data(
     ecs_column_t *columns = table->data.columns;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, to_add, size, true);
-        ecs_assert(v_column.size == size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, ECS_INTERNAL_ERROR, NULL);
-        column->data = v_column.array;
-
-        if (to_add) {
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            to_add, size, construct);
+
+        if (to_add && construct) {
             flecs_table_invoke_add_hooks(
                 world, table, i, e, count, to_add, false);
         }
@@ -1712,17 +2540,21 @@ static void flecs_table_copy_elem(
 
 /* Append operation for tables that don't have any complex logic */
 static void flecs_table_fast_append(
-    ecs_table_t *table)
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size,
+    int32_t dst_size)
 {
-    /* Add elements to each column array */
+    if (size == dst_size) {
+        return;
+    }
+
+    /* Grow each column array */
     ecs_column_t *columns = table->data.columns;
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
-        ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v = ecs_vec_from_column(column, table, ti->size);
-        ecs_vec_append(NULL, &v, ti->size);
-        column->data = v.array;
+        flecs_table_column_set_size(
+            world, &columns[i], table->data.count, size, dst_size);
     }
 }
 
@@ -1753,6 +2585,10 @@ void flecs_table_append(
     ecs_assert(e != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_entity_t *entities = table->data.entities = v_entities.array;
     *e = entity;
+
+    if (table->_->row_order) {
+        flecs_table_row_order_append(world, table, 1);
+    }
  
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);
@@ -1765,9 +2601,10 @@ void flecs_table_append(
 
     /* Fast path: no toggle columns, no lifecycle actions */
     if (!(table->flags & (EcsTableIsComplex|EcsTableHasIsA))) {
-        flecs_table_fast_append(table);
+        flecs_table_fast_append(world, table, table->data.size, v_entities.size);
         table->data.count = v_entities.count;
         table->data.size = v_entities.size;
+        flecs_table_dirty_chunks_set_size(world, table);
         return;
     }
 
@@ -1780,6 +2617,7 @@ void flecs_table_append(
         ECS_INTERNAL_ERROR, NULL);
     table->data.count = v_entities.count;
     table->data.size = v_entities.size;
+    flecs_table_dirty_chunks_set_size(world, table);
 
     /* Reobtain size to ensure that the columns have the same size as the
      * entities vector. This keeps reasoning about when allocations occur
@@ -1790,20 +2628,14 @@ void flecs_table_append(
     int32_t i;
     for (i = 0; i < column_count; i ++) {
         ecs_column_t *column = &columns[i];
-        const ecs_type_info_t *ti = column->ti;
-        ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, 1, size, construct);
-        column->data = v_column.array;
+        flecs_table_grow_column(world, table, i, column, prev_count, prev_size,
+            1, size, construct);
 
         ecs_iter_action_t on_add_hook;
         if (on_add && (on_add_hook = column->ti->hooks.on_add)) {
             flecs_table_invoke_hook(world, table, on_add_hook, EcsOnAdd, column,
                 &entities[count], count, 1);
         }
-
-        ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
-        ecs_assert(v_column.count == v_entities.count, 
-            ECS_INTERNAL_ERROR, NULL);
     }
 
     ecs_table__t *meta = table->_;
@@ -1830,6 +2662,13 @@ static void flecs_table_fast_delete(
     int32_t i, count = table->column_count;
     for (i = 0; i < count; i ++) {
         ecs_column_t *column = &columns[i];
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_column_soa_copy(
+                column, capacity, row, column, capacity, last, 1);
+            continue;
+        }
+
         ecs_size_t size = column->ti->size;
         flecs_table_copy_elem(
             ECS_ELEM(column->data, size, row),
@@ -1837,6 +2676,167 @@ static void flecs_table_fast_delete(
     }
 }
 
+/* Shift values of a column that can't be moved with ctor_move_dtor. Values 
+ * are moved with move assignments, and the values that end up past the end of
+ * the table are destructed, like flecs_table_delete does with move_dtor. The
+ * values of the removed rows must still be constructed. */
+static void flecs_table_shift_column_w_move(
+    ecs_column_t *column,
+    int32_t row,
+    int32_t count,
+    int32_t move_count)
+{
+    const ecs_type_info_t *ti = column->ti;
+    ecs_size_t size = ti->size;
+    int32_t i, src_row = row + count, end = row + move_count;
+
+    for (i = 0; i < move_count; i ++) {
+        void *dst = ECS_ELEM(column->data, size, row + i);
+        void *src = ECS_ELEM(column->data, size, src_row + i);
+        if ((src_row + i) < end) {
+            /* Source is the destination of a later move */
+            flecs_type_info_move(dst, src, 1, ti);
+        } else {
+            flecs_type_info_move_dtor(dst, src, 1, ti);
+        }
+    }
+
+    if (end < src_row) {
+        /* Removed rows that weren't overwritten */
+        flecs_table_invoke_dtor(column, end, src_row - end);
+    }
+}
+
+/* Shift rows after a range of removed rows down, so that the remaining rows
+ * keep their order. Column values of the removed rows must be destructed, 
+ * except for columns that can't be moved with ctor_move_dtor. */
+static void flecs_table_shift_rows(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count)
+{
+    int32_t i, src_row = row + count;
+    int32_t move_count = table->data.count - src_row;
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* Rows are out of order, shift keys along with the rows */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        if (move_count > 0) {
+            ecs_os_memmove_n(&keys[row], &keys[src_row], int32_t, move_count);
+        }
+        ecs_vec_set_count_t(&world->allocator, &row_order->keys, int32_t, 
+            table->data.count - count);
+    }
+
+    if (move_count > 0) {
+        ecs_entity_t *entities = table->data.entities;
+        ecs_os_memmove_n(&entities[row], &entities[src_row], 
+            ecs_entity_t, move_count);
+
+        for (i = row; i < (row + move_count); i ++) {
+            ecs_record_t *r = flecs_entities_get(world, entities[i]);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(i, r->row & ECS_ROW_FLAGS_MASK);
+        }
+
+        bool has_move = table->flags & (EcsTableHasDtors | EcsTableHasMove);
+        ecs_column_t *columns = table->data.columns;
+        int32_t c, column_count = table->column_count;
+        for (c = 0; c < column_count; c ++) {
+            ecs_column_t *column = &columns[c];
+            if (column->flags & EcsColumnSoA) {
+                int32_t capacity = table->data.size;
+                flecs_table_column_soa_copy(column, capacity, row, 
+                    column, capacity, src_row, move_count);
+                continue;
+            }
+
+            ecs_type_info_t *ti = column->ti;
+            ecs_size_t size = ti->size;
+            if (!has_move) {
+                ecs_os_memmove(ECS_ELEM(column->data, size, row), 
+                    ECS_ELEM(column->data, size, src_row), size * move_count);
+                continue;
+            }
+
+            if (ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL) {
+                flecs_table_shift_column_w_move(column, row, count, move_count);
+                continue;
+            }
+
+            /* Move in blocks that don't overlap. The source rows of a block
+             * are destructed by the move and become the next destination. */
+            for (i = 0; i < move_count; i += count) {
+                int32_t n = ECS_MIN(count, move_count - i);
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, row + i), 
+                    ECS_ELEM(column->data, size, src_row + i), n, ti);
+            }
+        }
+    }
+
+    ecs_table__t *meta = table->_;
+    ecs_bitset_t *bs_columns = meta->bs_columns;
+    int32_t bs_count = meta->bs_count;
+    for (i = 0; i < bs_count; i ++) {
+        flecs_bitset_remove_range(&bs_columns[i], row, count);
+    }
+}
+
+/* Delete entity from table with the StableOrder trait */
+static void flecs_table_delete_ordered(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    bool destruct)
+{
+    ecs_entity_t entity_to_delete = table->data.entities[row];
+
+    /* If the table is monitored, indicate that there has been a change */
+    flecs_table_mark_table_dirty(world, table, 0);
+
+    if (table->flags & (EcsTableHasDtors | EcsTableHasMove)) {
+        ecs_column_t *columns = table->data.columns;
+        int32_t i, column_count = table->column_count;
+        for (i = 0; i < column_count; i ++) {
+            ecs_column_t *column = &columns[i];
+            ecs_type_info_t *ti = column->ti;
+
+            /* Values that can't be moved with ctor_move_dtor are shifted with
+             * move assignments, which overwrite the removed value. */
+            bool shift_w_move = 
+                ti->hooks.flags & ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL;
+
+            if (destruct) {
+                flecs_table_invoke_remove_hooks(world, table, column, 
+                    &entity_to_delete, row, 1, !shift_w_move);
+                continue;
+            }
+
+            /* Value was moved to another table. If the type does not support
+             * non-destructive moves, the value was already destructed. */
+            if (!shift_w_move && 
+                (ti->hooks.move_ctor || !ti->hooks.ctor_move_dtor)) 
+            {
+                flecs_table_invoke_dtor(column, row, 1);
+            }
+        }
+    }
+
+    flecs_table_shift_rows(world, table, row, 1);
+
+    table->data.count --;
+    if (!table->data.count) {
+        table->flags |= EcsTableEmpty;
+        table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_check_sanity(table);
+}
+
 /* Delete entity from table */
 void flecs_table_delete(
     ecs_world_t *world,
@@ -1856,6 +2856,21 @@ void flecs_table_delete(
     count --;
     ecs_assert(row <= count, ECS_INTERNAL_ERROR, NULL);
 
+    if (table->_->stable_order && (row != count)) {
+        if (!flecs_table_defer_row_order(world, table)) {
+            flecs_table_delete_ordered(world, table, row, destruct);
+            return;
+        }
+    }
+
+    ecs_table_row_order_t *row_order = table->_->row_order;
+    if (row_order) {
+        /* The last row is moved to the deleted row */
+        int32_t *keys = ecs_vec_first_t(&row_order->keys, int32_t);
+        keys[row] = keys[count];
+        ecs_vec_remove_last(&row_order->keys);
+    }
+
     /* Move last entity id to row */
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t entity_to_move = entities[count];
@@ -1925,6 +2940,13 @@ void flecs_table_delete(
                         EcsOnRemove, column, &entity_to_delete, row, 1);
                 }
 
+                if (column->flags & EcsColumnSoA) {
+                    int32_t capacity = table->data.size;
+                    flecs_table_column_soa_copy(
+                        column, capacity, row, column, capacity, count, 1);
+                    continue;
+                }
+
                 /* If neither move nor move_ctor are set, this indicates that 
                  * non-destructive move semantics are not supported for this 
                  * type. In such cases, use ctor_move_dtor for destructive move
@@ -1977,10 +2999,16 @@ static void flecs_table_fast_move(
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
         if (dst_id == src_id) {
-            int32_t size = dst_column->ti->size;
-            void *dst = ECS_ELEM(dst_column->data, size, dst_index);
-            void *src = ECS_ELEM(src_column->data, size, src_index);
-            flecs_table_copy_elem(dst, src, size);
+            if (dst_column->flags & EcsColumnSoA) {
+                flecs_table_column_soa_copy(
+                    dst_column, dst_table->data.size, dst_index, 
+                    src_column, src_table->data.size, src_index, 1);
+            } else {
+                int32_t size = dst_column->ti->size;
+                void *dst = ECS_ELEM(dst_column->data, size, dst_index);
+                void *src = ECS_ELEM(src_column->data, size, src_index);
+                flecs_table_copy_elem(dst, src, size);
+            }
         }
 
         i_new += dst_id <= src_id;
@@ -2040,7 +3068,11 @@ void flecs_table_move(
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
 
-        if (dst_id == src_id) {
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(
+                dst_column, dst_table->data.size, dst_index, 
+                src_column, src_table->data.size, src_index, 1);
+        } else if (dst_id == src_id) {
             ecs_type_info_t *ti = dst_column->ti;
             int32_t size = ti->size;
 
@@ -2086,6 +3118,166 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 }
 
+/* Move a range of rows from src to dst table */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count)
+{
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!dst_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(!src_table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("bulk move"));
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t src_count = ecs_table_count(src_table);
+    ecs_assert(src_row >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert((src_row + count) <= src_count, ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    /* Append rows to destination table without constructing them. Column 
+     * values are either moved from the source table or constructed by the add
+     * hooks below. */
+    ecs_entity_t *src_entities = src_table->data.entities;
+    int32_t dst_row = ecs_table_count(dst_table);
+    flecs_table_grow_data(world, dst_table, count, dst_row + count, 
+        &src_entities[src_row], false);
+    ecs_entity_t *dst_entities = dst_table->data.entities;
+
+    flecs_table_move_bitset_columns(
+        dst_table, dst_row, src_table, src_row, count, false);
+
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    int32_t dst_size = dst_table->data.size, src_size = src_table->data.size;
+
+    /* Move shared columns as a single block per column. Values are moved with
+     * destructive move semantics, which leaves the source rows uninitialized
+     * so they can be overwritten by the tail of the source table. */
+    for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
+        ecs_column_t *dst_column = &dst_columns[i_new];
+        ecs_column_t *src_column = &src_columns[i_old];
+        ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
+        ecs_id_t src_id = flecs_column_id(src_table, i_old);
+
+        if (dst_id == src_id && (dst_column->flags & EcsColumnSoA)) {
+            flecs_table_column_soa_copy(dst_column, dst_size, dst_row, 
+                src_column, src_size, src_row, count);
+        } else if (dst_id == src_id) {
+            ecs_type_info_t *ti = dst_column->ti;
+            int32_t size = ti->size;
+            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+            flecs_type_info_ctor_move_dtor(
+                ECS_ELEM(dst_column->data, size, dst_row), 
+                ECS_ELEM(src_column->data, size, src_row), count, ti);
+        } else if (dst_id < src_id) {
+            flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+                &dst_entities[dst_row], dst_row, count, true);
+        } else {
+            flecs_table_invoke_remove_hooks(world, src_table, src_column, 
+                &src_entities[src_row], src_row, count, true);
+        }
+
+        i_new += dst_id <= src_id;
+        i_old += dst_id >= src_id;
+    }
+
+    for (; (i_new < dst_column_count); i_new ++) {
+        flecs_table_invoke_add_hooks(world, dst_table, i_new, 
+            &dst_entities[dst_row], dst_row, count, true);
+    }
+
+    for (; (i_old < src_column_count); i_old ++) {
+        flecs_table_invoke_remove_hooks(world, src_table, &src_columns[i_old],
+            &src_entities[src_row], src_row, count, true);
+    }
+
+    /* Update records of moved entities in a single pass */
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_record_t *r = flecs_entities_get(world, dst_entities[dst_row + i]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+        r->table = dst_table;
+        r->row = ECS_ROW_TO_RECORD(dst_row + i, r->row & ECS_ROW_FLAGS_MASK);
+    }
+
+    if (src_table->_->stable_order) {
+        /* Shift the tail of the table down to keep rows in order */
+        flecs_table_shift_rows(world, src_table, src_row, count);
+    } else {
+        /* Fill the gap in the source table with rows from the end of the 
+         * table. Rows are filled in the same order as deleting the entities 
+         * one by one would, so that the resulting table is the same. */
+        int32_t fill = src_count - (src_row + count);
+        if (fill > count) {
+            fill = count;
+        }
+
+        for (i = 0; i < fill; i ++) {
+            int32_t dst = src_row + i, src = src_count - 1 - i;
+            ecs_entity_t e = src_entities[dst] = src_entities[src];
+            ecs_record_t *r = flecs_entities_get(world, e);
+            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+            ecs_assert(r->table == src_table, ECS_INTERNAL_ERROR, NULL);
+            r->row = ECS_ROW_TO_RECORD(dst, r->row & ECS_ROW_FLAGS_MASK);
+
+            int32_t c;
+            for (c = 0; c < src_column_count; c ++) {
+                ecs_column_t *column = &src_columns[c];
+                if (column->flags & EcsColumnSoA) {
+                    flecs_table_column_soa_copy(
+                        column, src_size, dst, column, src_size, src, 1);
+                    continue;
+                }
+
+                ecs_type_info_t *ti = column->ti;
+                int32_t size = ti->size;
+                flecs_type_info_ctor_move_dtor(
+                    ECS_ELEM(column->data, size, dst), 
+                    ECS_ELEM(column->data, size, src), 1, ti);
+            }
+        }
+
+        ecs_table__t *meta = src_table->_;
+        ecs_bitset_t *bs_columns = meta->bs_columns;
+        int32_t bs_count = meta->bs_count;
+        for (i = 0; i < bs_count; i ++) {
+            ecs_bitset_t *bs = &bs_columns[i];
+            int32_t j;
+            for (j = 0; j < fill; j ++) {
+                flecs_bitset_set(bs, src_row + j, 
+                    flecs_bitset_get(bs, src_count - 1 - j));
+            }
+            for (j = 0; j < count; j ++) {
+                flecs_bitset_remove(bs, src_count - 1 - j);
+            }
+        }
+    }
+
+    src_table->data.count -= count;
+    if (!src_table->data.count) {
+        src_table->flags |= EcsTableEmpty;
+        src_table->flags &= ~EcsTableNotEmpty;
+    }
+
+    flecs_table_mark_table_dirty(world, src_table, 0);
+
+    flecs_table_check_sanity(dst_table);
+    flecs_table_check_sanity(src_table);
+
+    return dst_row;
+}
+
 /* Append n entities to table */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
@@ -2107,7 +3299,7 @@ int32_t flecs_table_appendn(
     flecs_table_check_sanity(table);
     int32_t cur_count = ecs_table_count(table);
     int32_t result = flecs_table_grow_data(
-        world, table, to_add, cur_count + to_add, ids);
+        world, table, to_add, cur_count + to_add, ids, true);
     flecs_table_check_sanity(table);
 
     return result;
@@ -2121,7 +3313,6 @@ bool flecs_table_shrink(
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table shrink"));
-    (void)world;
 
     flecs_table_check_sanity(table);
 
@@ -2147,18 +3338,8 @@ bool flecs_table_shrink(
 
     int32_t i, column_count = table->column_count;
     for (i = 0; i < column_count; i ++) {
-        const ecs_type_info_t *ti = columns[i].ti;
-        ecs_size_t component_size = ti->size;
-        void *data = columns[i].data;
-
-        if (count) {
-            columns[i].data = ecs_os_malloc(component_size * count);
-            flecs_type_info_ctor_move_dtor(columns[i].data, data, count, ti);
-        } else {
-            columns[i].data = NULL;
-        }
-
-        ecs_os_free(data);
+        flecs_table_column_set_size(
+            world, &columns[i], count, table->data.size, count);
     }
 
     table->data.size = count;
@@ -2170,6 +3351,66 @@ bool flecs_table_shrink(
     return has_payload;
 }
 
+/* Move cold columns of table to free space at lower addresses of the cold 
+ * storage region, so that pages at the end of the region can be released. 
+ * Returns whether a column was moved. */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("table compaction"));
+
+    ecs_cold_storage_t *cold = &world->store.cold;
+    ecs_column_t *columns = table->data.columns;
+    int32_t count = table->data.count, size = table->data.size;
+    int32_t i, column_count = table->column_count;
+    bool moved = false;
+
+    for (i = 0; i < column_count; i ++) {
+        ecs_column_t *column = &columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) != 
+            EcsColumnCold) 
+        {
+            continue;
+        }
+
+        if (!column->data) {
+            continue;
+        }
+
+        const ecs_type_info_t *ti = column->ti;
+        void *dst = flecs_cold_alloc_before(
+            cold, ti->size * size, column->data);
+        if (!dst) {
+            continue;
+        }
+
+        if (count) {
+            if (column->flags & EcsColumnSoA) {
+                /* Capacity doesn't change, so member arrays keep offsets */
+                ecs_os_memcpy(dst, column->data, ti->size * size);
+            } else if (ti->hooks.ctor_move_dtor) {
+                flecs_type_info_ctor_move_dtor(dst, column->data, count, ti);
+            } else {
+                ecs_os_memcpy(dst, column->data, ti->size * count);
+            }
+        }
+
+        flecs_cold_free(cold, column->data);
+        column->data = dst;
+        moved = true;
+    }
+
+    if (moved) {
+        /* Invalidate refs to components in the moved columns */
+        flecs_increment_table_version(world, table);
+    }
+
+    return moved;
+}
+
 /* Swap operation for bitset (toggle component) columns */
 static void flecs_table_swap_bitset_columns(
     ecs_table_t *table,
@@ -2209,6 +3450,9 @@ static void flecs_table_swap(
         return;
     }
 
+    /* Rows are sorted relative to the stable order of the table */
+    flecs_table_restore_rows(world, table);
+
     /* If the table is monitored, indicate that there has been a change */
     flecs_table_mark_table_dirty(world, table, 0);    
 
@@ -2257,6 +3501,15 @@ static void flecs_table_swap(
         const ecs_type_info_t *ti = column->ti;
         ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
 
+        if (column->flags & EcsColumnSoA) {
+            int32_t capacity = table->data.size;
+            flecs_table_soa_get(table, i, row_1, tmp);
+            flecs_table_column_soa_copy(
+                column, capacity, row_1, column, capacity, row_2, 1);
+            flecs_table_soa_set(table, i, row_2, tmp);
+            continue;
+        }
+
         void *el_1 = ECS_ELEM(ptr, size, row_1);
         void *el_2 = ECS_ELEM(ptr, size, row_2);
 
@@ -2310,39 +3563,44 @@ static void flecs_table_merge_vec(
 /* Merge data from one table column into other table column */
 static void flecs_table_merge_column(
     ecs_world_t *world,
-    ecs_vec_t *dst_vec,
-    ecs_vec_t *src_vec,
     ecs_column_t *dst,
     ecs_column_t *src,
+    int32_t dst_count,
+    int32_t dst_size,
+    int32_t src_count,
+    int32_t src_size,
     int32_t column_size)
 {
     const ecs_type_info_t *ti = dst->ti;
     ecs_assert(ti == src->ti, ECS_INTERNAL_ERROR, NULL);
-    ecs_size_t elem_size = ti->size;
-    int32_t dst_count = ecs_vec_count(dst_vec);
 
     if (!dst_count) {
-        ecs_vec_fini(NULL, dst_vec, elem_size);
-        *dst_vec = *src_vec;
+        flecs_table_column_fini(world, dst);
+        dst->data = src->data;
+        dst->flags = src->flags;
 
     /* If the new table is not empty, move the contents from the
      * src into the dst. */
     } else {
-        int32_t src_count = src_vec->count;
+        flecs_table_grow_column(world, NULL, -1, dst, dst_count, dst_size,
+            src_count, column_size, false);
 
-        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, src_count, column_size, false);
-        void *dst_ptr = ECS_ELEM(dst_vec->array, elem_size, dst_count);
-        void *src_ptr = src_vec->array;
+        if (dst->flags & EcsColumnSoA) {
+            flecs_table_column_soa_copy(
+                dst, column_size, dst_count, src, src_size, 0, src_count);
+        } else {
+            void *dst_ptr = ECS_ELEM(dst->data, ti->size, dst_count);
+            void *src_ptr = src->data;
 
-        /* Move values into column */
-        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+            /* Move values into column */
+            flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
+        }
 
-        ecs_vec_fini(NULL, src_vec, elem_size);
+        flecs_table_column_fini(world, src);
     }
 
-    dst->data = dst_vec->array;
     src->data = NULL;
+    src->flags &= ~EcsColumnStorageMask;
 }
 
 /* Merge storage of two tables. */
@@ -2364,6 +3622,9 @@ static void flecs_table_merge_data(
         return;
     }
 
+    int32_t dst_size = dst_table->data.size;
+    int32_t src_size = src_table->data.size;
+
     /* Merge entities */
     ecs_vec_t dst_entities = ecs_vec_from_entities(dst_table);
     ecs_vec_t src_entities = ecs_vec_from_entities(src_table);
@@ -2373,36 +3634,35 @@ static void flecs_table_merge_data(
         ECS_INTERNAL_ERROR, NULL);
     int32_t column_size = dst_entities.size;
 
+    /* Update destination storage before columns are merged, so that hooks 
+     * that are invoked for new columns see the merged entities. */
+    dst_table->data.entities = dst_entities.array;
+    dst_table->data.count = dst_entities.count;
+    dst_table->data.size = dst_entities.size;
+    flecs_table_dirty_chunks_set_size(world, dst_table);
+
     for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
         ecs_column_t *dst_column = &dst_columns[i_new];
         ecs_column_t *src_column = &src_columns[i_old];
         ecs_id_t dst_id = flecs_column_id(dst_table, i_new);
         ecs_id_t src_id = flecs_column_id(src_table, i_old);
-        ecs_size_t dst_elem_size = dst_column->ti->size;
-        ecs_size_t src_elem_size = src_column->ti->size;
-    
-        ecs_vec_t dst_vec = ecs_vec_from_column(
-            dst_column, dst_table, dst_elem_size);
-        ecs_vec_t src_vec = ecs_vec_from_column(
-            src_column, src_table, src_elem_size);
 
         if (dst_id == src_id) {
-            flecs_table_merge_column(world, &dst_vec, &src_vec, dst_column, 
-                src_column, column_size);
+            flecs_table_merge_column(world, dst_column, src_column, dst_count,
+                dst_size, src_count, src_size, column_size);
             flecs_table_mark_table_dirty(world, dst_table, i_new + 1);
             i_new ++;
             i_old ++;
         } else if (dst_id < src_id) {
-            /* New column, make sure vector is large enough. */
-            ecs_vec_set_size(NULL, &dst_vec, dst_elem_size, column_size);
-            dst_column->data = dst_vec.array;
+            /* New column, make sure storage is large enough. */
+            flecs_table_column_set_size(
+                world, dst_column, dst_count, dst_size, column_size);
             flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
             i_new ++;
         } else if (dst_id > src_id) {
             /* Old column does not occur in new table, destruct */
             flecs_table_invoke_dtor(src_column, 0, src_count);
-            ecs_vec_fini(NULL, &src_vec, src_elem_size);
-            src_column->data = NULL;
+            flecs_table_column_fini(world, src_column);
             i_old ++;
         }
     }
@@ -2413,32 +3673,23 @@ static void flecs_table_merge_data(
     /* Initialize remaining columns */
     for (; i_new < dst_column_count; i_new ++) {
         ecs_column_t *column = &dst_columns[i_new];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
-        ecs_vec_t vec = ecs_vec_from_column(column, dst_table, elem_size);
-        ecs_vec_set_size(NULL, &vec, elem_size, column_size);
-        column->data = vec.array;
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
+        flecs_table_column_set_size(
+            world, column, dst_count, dst_size, column_size);
         flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
     }
 
     /* Destruct remaining columns */
     for (; i_old < src_column_count; i_old ++) {
         ecs_column_t *column = &src_columns[i_old];
-        int32_t elem_size = column->ti->size;
-        ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(column->ti->size != 0, ECS_INTERNAL_ERROR, NULL);
         flecs_table_invoke_dtor(column, 0, src_count);
-        ecs_vec_t vec = ecs_vec_from_column(column, src_table, elem_size);
-        ecs_vec_fini(NULL, &vec, elem_size);
-        column->data = vec.array;
+        flecs_table_column_fini(world, column);
     }    
 
     /* Mark entity column as dirty */
     flecs_table_mark_table_dirty(world, dst_table, 0);
 
-    dst_table->data.entities = dst_entities.array;
-    dst_table->data.count = dst_entities.count;
-    dst_table->data.size = dst_entities.size;
-
     src_table->data.entities = src_entities.array;
     src_table->data.count = src_entities.count;
     src_table->data.size = src_entities.size;
@@ -2462,6 +3713,10 @@ void flecs_table_merge(
     flecs_table_check_sanity(src_table);
     flecs_table_check_sanity(dst_table);
 
+    /* Rows of the source table are appended in their stable order */
+    flecs_table_restore_rows(world, src_table);
+    flecs_table_restore_rows(world, dst_table);
+
     const ecs_entity_t *src_entities = ecs_table_entities(src_table);
     int32_t src_count = ecs_table_count(src_table);
     int32_t dst_count = ecs_table_count(dst_table);
@@ -2859,6 +4114,8 @@ void* ecs_table_get_column(
         "column index %d out of range for table", index);
 
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     void *result = column->data;
     if (offset) {
         result = ECS_ELEM(result, column->ti->size, offset);
@@ -3008,6 +4265,8 @@ void* ecs_record_get_by_column(
 
     ecs_check(index < table->column_count, ECS_INVALID_PARAMETER, NULL);
     ecs_column_t *column = &table->data.columns[index];
+    ecs_check(!(column->flags & EcsColumnSoA), ECS_INVALID_OPERATION,
+        "column %d has struct-of-arrays storage", index);
     ecs_size_t size = column->ti->size;
 
     ecs_check(!flecs_utosize(c_size) || flecs_utosize(c_size) == size, 
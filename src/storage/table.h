@@ -52,6 +52,24 @@
 #define ecs_vec_from_column_t(arg_column, table, T)\
     ecs_vec_from_column(arg_column, table, ECS_SIZEOF(T))
 
+/* Number of rows that share a version stamp for row change tracking */
+#define FLECS_TABLE_DIRTY_CHUNK_BITS (6)
+#define FLECS_TABLE_DIRTY_CHUNK (1 << FLECS_TABLE_DIRTY_CHUNK_BITS)
+
+/* Version stamps are written by the workers of multithreaded systems that
+ * iterate the same table, so access them with relaxed atomics. */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_table_stamp_store(ptr, value)\
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#define flecs_table_stamp_load(ptr)\
+    __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#else
+#define flecs_table_stamp_store(ptr, value)\
+    (*(volatile int32_t*)(ptr) = (value))
+#define flecs_table_stamp_load(ptr)\
+    (*(const volatile int32_t*)(ptr))
+#endif
+
 /* Table event type for notifying tables of world events */
 typedef enum ecs_table_eventkind_t {
     EcsTableTriggersForId,
@@ -95,6 +113,14 @@ typedef struct ecs_table_overrides_t {
     ecs_ref_t *refs;                 /* Refs to base components (one for each column) */
 } ecs_table_overrides_t;
 
+/* Order of the rows of a table with StableOrder while a command flush removes
+ * rows by moving the last row of the table into the removed row. Sorting the
+ * rows by key restores the order of the table. */
+typedef struct ecs_table_row_order_t {
+    ecs_vec_t keys;                  /* vector<int32_t>, sort key of each row */
+    int32_t next;                    /* Key of the next appended row */
+} ecs_table_row_order_t;
+
 /** Infrequently accessed data not stored inline in ecs_table_t */
 typedef struct ecs_table__t {
     uint64_t hash;                   /* Type hash */
@@ -108,6 +134,12 @@ typedef struct ecs_table__t {
     int16_t bs_offset;
     ecs_bitset_t *bs_columns;        /* Bitset columns */
 
+    bool stable_order;               /* Removing rows preserves row order */
+    ecs_table_row_order_t *row_order; /* Set while rows are out of order */
+
+    ecs_vec_t *dirty_chunks;         /* Per column version of each chunk of
+                                      * FLECS_TABLE_DIRTY_CHUNK rows */
+
     struct ecs_table_record_t *records; /* Array with table records */
 
 #ifdef FLECS_DEBUG_INFO
@@ -122,10 +154,41 @@ typedef struct ecs_table__t {
 #endif
 } ecs_table__t;
 
+/* Column data is stored in a reserved address range (see column_page_size) */
+#define EcsColumnPaged (1u << 0)
+
+/* Column data is stored in a heap allocation with custom alignment */
+#define EcsColumnAligned (1u << 1)
+
+/* Column stores each member of the component in a separate array */
+#define EcsColumnSoA (1u << 2)
+
+/* Column stores a rarely accessed (cold) component. Column data is stored in
+ * the cold storage region of the world, unless EcsColumnAligned is set. */
+#define EcsColumnCold (1u << 3)
+
+/* Flags that describe how column storage is allocated */
+#define EcsColumnStorageMask (EcsColumnPaged|EcsColumnAligned)
+
+/** Member of a component with struct-of-arrays storage */
+typedef struct ecs_soa_member_t {
+    ecs_size_t offset;               /* Offset of member in component */
+    ecs_size_t size;                 /* Size of member */
+} ecs_soa_member_t;
+
+/** Struct-of-arrays layout. Member i of the element at row r is stored at
+ * data + offset_i * capacity + size_i * r. Because member offsets are aligned
+ * for the member type, so are the member arrays. */
+struct ecs_soa_layout_t {
+    ecs_soa_member_t *members;       /* Members, in order of increasing offset */
+    int32_t count;                   /* Number of members */
+};
+
 /** Table column */
 typedef struct ecs_column_t {
     void *data;                      /* Array with component data */
     ecs_type_info_t *ti;             /* Component type info */
+    ecs_flags32_t flags;             /* Column storage flags */
 } ecs_column_t;
 
 /** Table data */
@@ -212,6 +275,16 @@ void flecs_table_move(
     int32_t old_index,
     ecs_id_t emplace_id);
 
+/* Move a range of rows from one table to another. Rows are appended to the
+ * destination table and the records of moved entities are updated. Returns
+ * the index of the first row in the destination table. */
+int32_t flecs_table_move_range(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    int32_t src_row,
+    int32_t count);
+
 /* Grow table with specified number of records. Populate table with the
  * specified entity ids. */
 int32_t flecs_table_appendn(
@@ -225,11 +298,46 @@ bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Restore order of rows of tables with StableOrder after a command flush */
+void flecs_table_restore_row_order(
+    ecs_world_t *world);
+
+/* Move cold columns of table to lower addresses in the cold storage region */
+bool flecs_table_compact_cold(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Copy value into column with struct-of-arrays storage */
+void flecs_table_soa_set(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    const void *value);
+
+/* Copy value out of column with struct-of-arrays storage */
+void flecs_table_soa_get(
+    const ecs_table_t *table,
+    int32_t column_index,
+    int32_t row,
+    void *value);
+
 /* Get dirty state for table columns */
 int32_t* flecs_table_get_dirty_state(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Enable tracking of which chunks of rows changed for table columns */
+void flecs_table_track_row_changes(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Mark range of rows in table column dirty */
+void flecs_table_mark_column_dirty(
+    ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    int32_t count);
+
 /* Initialize root table */
 void flecs_init_root_table(
     ecs_world_t *world);
@@ -258,7 +366,8 @@ void flecs_table_merge(
 void flecs_table_mark_dirty(
     ecs_world_t *world,
     ecs_table_t *table,
-    ecs_entity_t component);
+    ecs_entity_t component,
+    int32_t row);
 
 void flecs_table_notify(
     ecs_world_t *world,
@@ -463,6 +463,10 @@ void ecs_set_hooks_id(
     ecs_check(!ti->component || ti->component == component,
         ECS_INCONSISTENT_COMPONENT_ACTION, NULL);
 
+    ecs_check(!ti->soa || flecs_type_hooks_allow_soa(h), ECS_UNSUPPORTED,
+        "illegal call to set_hooks() for component '%s': component has "
+        "struct-of-arrays storage", flecs_errstr(ecs_get_path(world, component)));
+
     ecs_type_hooks_t prev_hooks = ti->hooks;
 
     if (!ti->size) {
@@ -673,6 +677,11 @@ static void flecs_type_info_fini(
         ecs_os_free(ECS_CONST_CAST(char*, ti->name));
         ti->name = NULL;
     }
+    if (ti->soa) {
+        ecs_os_free(ti->soa->members);
+        ecs_os_free(ti->soa);
+        ti->soa = NULL;
+    }
 
     ti->size = 0;
     ti->alignment = 0;
@@ -846,6 +855,33 @@ void flecs_type_info_release(
     }
 }
 
+/* Struct-of-arrays storage has no contiguous component values to pass to 
+ * lifecycle hooks or to the hooks that access values with ecs_field. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h)
+{
+    return (!h->ctor || h->ctor == flecs_default_ctor) && !h->dtor && 
+        !h->copy && !h->move && !h->copy_ctor && !h->move_ctor && 
+        !h->ctor_move_dtor && !h->move_dtor && !h->on_add && !h->on_set &&
+        !h->on_remove && !h->on_replace && !h->on_validate;
+}
+
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count)
+{
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(ti->soa == NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(members != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(count > 0, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_soa_layout_t *soa = ecs_os_calloc_t(ecs_soa_layout_t);
+    soa->members = ecs_os_memdup_n(members, ecs_soa_member_t, count);
+    soa->count = count;
+    ti->soa = soa;
+}
+
 ecs_size_t flecs_type_size(
     ecs_world_t *world, 
     ecs_entity_t type) 
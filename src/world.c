@@ -104,6 +104,8 @@ const ecs_entity_t EcsPanic =                       FLECS_HI_COMPONENT_ID + 56;
 /* Storage */
 const ecs_entity_t EcsSparse =                      FLECS_HI_COMPONENT_ID + 57;
 const ecs_entity_t EcsDontFragment =                FLECS_HI_COMPONENT_ID + 58;
+const ecs_entity_t EcsCold =                        FLECS_HI_COMPONENT_ID + 125;
+const ecs_entity_t EcsStableOrder =                 FLECS_HI_COMPONENT_ID + 126;
 
 /* Misc */
 const ecs_entity_t EcsOrderedChildren =               FLECS_HI_COMPONENT_ID + 60;
@@ -175,6 +177,7 @@ const ecs_entity_t ecs_id(EcsUnitPrefix) =          FLECS_HI_COMPONENT_ID + 112;
 const ecs_entity_t EcsQuantity =                    FLECS_HI_COMPONENT_ID + 113;
 const ecs_entity_t ecs_id(EcsMap) =                 FLECS_HI_COMPONENT_ID + 122;
 const ecs_entity_t ecs_id(ecs_value_t) =          FLECS_HI_COMPONENT_ID + 123;
+const ecs_entity_t EcsSoA =                         FLECS_HI_COMPONENT_ID + 124;
 #endif
 
 const ecs_entity_t EcsConstant =                    FLECS_HI_COMPONENT_ID + 114;
@@ -395,6 +398,7 @@ static void flecs_init_store(
     ecs_vec_init_t(a, &world->store.records, ecs_table_record_t, 0);
     ecs_vec_init_t(a, &world->store.marked_ids, ecs_marked_id_t, 0);
     ecs_vec_init_t(a, &world->store.deleted_components, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &world->store.unordered_tables, uint64_t, 0);
 
     /* Initialize entity index */
     flecs_entities_init(world);
@@ -405,6 +409,9 @@ static void flecs_init_store(
 
     /* Initialize table map */
     flecs_table_hashmap_init(world, &world->store.table_map);
+
+    /* Initialize storage region for cold columns */
+    flecs_cold_storage_init(&world->store.cold);
 }
 
 static void flecs_clean_tables(
@@ -570,6 +577,9 @@ static void flecs_fini_store(ecs_world_t *world) {
     ecs_vec_fini_t(a, &world->store.records, ecs_table_record_t);
     ecs_vec_fini_t(a, &world->store.marked_ids, ecs_marked_id_t);
     ecs_vec_fini_t(a, &world->store.deleted_components, ecs_entity_t);
+    ecs_vec_fini_t(a, &world->store.unordered_tables, uint64_t);
+
+    flecs_cold_storage_fini(&world->store.cold);
 }
 
 static void flecs_world_allocators_init(
@@ -935,6 +945,8 @@ ecs_world_t *ecs_mini(void) {
     }
 
     ecs_map_init(&world->prefab_child_indices, a);
+    ecs_map_init(&world->double_buffered, a);
+    flecs_async_init(world);
 
     ecs_set_stage_count(world, 1);
     ecs_default_lookup_path[0] = EcsFlecsCore;
@@ -1164,6 +1176,7 @@ int ecs_fini(
     /* Purge deferred operations from the queue. This discards operations but
      * makes sure that any resources in the queue are freed */
     flecs_defer_purge(world, world->stages[0]);
+    flecs_async_fini(world);
     ecs_log_pop_1();
 
     /* Cleanup world ctx and binding_ctx */
@@ -1189,7 +1202,9 @@ int ecs_fini(
     flecs_name_index_fini(&world->aliases);
     flecs_name_index_fini(&world->symbols);
     ecs_set_stage_count(world, 0);
+    ecs_vec_fini_t(NULL, &world->worker_affinity, int32_t);
     ecs_map_fini(&world->prefab_child_indices);
+    ecs_map_fini(&world->double_buffered);
     flecs_multi_world_fini(world);
     ecs_log_pop_1();
 
@@ -1388,6 +1403,48 @@ void ecs_run_aperiodic(
     }
 }
 
+/* Estimate of the memory of a table that is returned to the OS allocator when 
+ * the table is shrunk or deleted. Used to report how many bytes were reclaimed
+ * by ecs_delete_empty_tables(). Graph edges, table records and the table 
+ * itself are freed to the allocators of the world, which keep the memory for
+ * new tables, so they are not counted. */
+static ecs_size_t flecs_table_reclaimable_bytes(
+    const ecs_table_t *table,
+    bool with_table)
+{
+    int32_t i, column_count = table->column_count;
+    ecs_size_t row_size = ECS_SIZEOF(ecs_entity_t);
+    for (i = 0; i < column_count; i ++) {
+        const ecs_column_t *column = &table->data.columns[i];
+        if ((column->flags & (EcsColumnCold|EcsColumnAligned)) == 
+            EcsColumnCold) 
+        {
+            /* Counted when the cold storage region releases pages */
+            continue;
+        }
+        row_size += column->ti->size;
+    }
+
+    ecs_size_t result = row_size * table->data.size;
+
+    if (with_table) {
+        int32_t type_count = table->type.count;
+        result += (type_count + column_count) * ECS_SIZEOF(int16_t);
+        if (table->component_map != flecs_table_empty_component_map) {
+            result += FLECS_HI_COMPONENT_ID * ECS_SIZEOF(int16_t);
+        }
+    }
+
+    return result;
+}
+
+static bool flecs_table_has_edges(
+    const ecs_table_t *table)
+{
+    const ecs_graph_node_t *node = &table->node;
+    return node->add.lo || node->remove.lo || node->add.hi || node->remove.hi;
+}
+
 int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc)
@@ -1404,7 +1461,9 @@ int32_t ecs_delete_empty_tables(
     uint16_t clear_generation = desc->clear_generation;
     uint16_t delete_generation = desc->delete_generation;
     double time_budget_seconds = desc->time_budget_seconds;
+    float shrink_ratio = desc->shrink_ratio;
     int32_t offset = desc->offset;
+    ecs_size_t cold_reserved = world->store.cold.bytes_reserved;
 
     if (ECS_NEQZERO(time_budget_seconds) || (ecs_should_log_1() && ecs_os_has_time())) {
         ecs_time_measure(&start);
@@ -1461,7 +1520,27 @@ int32_t ecs_delete_empty_tables(
             measure_budget_after = 100;
         }
 
-        if (!table->id || ecs_table_count(table) != 0) {
+        if (!table->id) {
+            i ++;
+            remaining --;
+            continue;
+        }
+
+        int32_t table_count = ecs_table_count(table);
+        if (table_count) {
+            /* Trim storage of tables that are mostly empty, for example after
+             * a large number of entities got deleted. */
+            if (ECS_NEQZERO(shrink_ratio) && 
+                ((float)table_count < shrink_ratio * (float)table->data.size))
+            {
+                ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+                flecs_table_shrink(world, table);
+                bytes -= flecs_table_reclaimable_bytes(table, false);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+                measure_budget_after = 1;
+            }
+
             i ++;
             remaining --;
             continue;
@@ -1469,12 +1548,22 @@ int32_t ecs_delete_empty_tables(
 
         uint16_t gen = ++ table->_->generation;
         if (delete_generation && (gen > delete_generation)) {
+            world->compaction_bytes += 
+                flecs_table_reclaimable_bytes(table, true);
+            world->compaction_count ++;
             flecs_table_fini(world, table);
             measure_budget_after = 1;
             remaining --;
             continue;
         } else if (clear_generation && (gen > clear_generation)) {
-            flecs_table_shrink(world, table);
+            ecs_size_t bytes = flecs_table_reclaimable_bytes(table, false);
+            if (bytes || flecs_table_has_edges(table)) {
+                /* Edges are recreated when the table is used again */
+                flecs_table_shrink(world, table);
+                flecs_table_clear_edges(world, table);
+                world->compaction_bytes += bytes;
+                world->compaction_count ++;
+            }
             measure_budget_after = 1;
         }
 
@@ -1482,12 +1571,65 @@ int32_t ecs_delete_empty_tables(
         remaining --;
     }
 
+    /* Pack cold columns at the start of the cold storage region, so that the
+     * pages at the end of the region are released. */
+    if (flecs_cold_storage_fragmented(&world->store.cold)) {
+        count = flecs_sparse_count(&world->store.tables);
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = flecs_sparse_get_dense_t(
+                &world->store.tables, ecs_table_t, i);
+            if (table->keep || !table->id) {
+                continue;
+            }
+            if (flecs_table_compact_cold(world, table)) {
+                world->compaction_count ++;
+            }
+        }
+    }
+
 done:
+    if (world->store.cold.bytes_reserved < cold_reserved) {
+        world->compaction_bytes += 
+            cold_reserved - world->store.cold.bytes_reserved;
+    }
+
     ecs_os_perf_trace_pop("flecs.delete_empty_tables");
 
     return result;
 }
 
+void ecs_set_table_compaction(
+    ecs_world_t *world,
+    const ecs_delete_empty_tables_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change table compaction while world is in readonly mode");
+
+    if (desc) {
+        ecs_check(desc->shrink_ratio >= 0 && desc->shrink_ratio <= 1, 
+            ECS_INVALID_PARAMETER, "shrink_ratio must be between 0 and 1");
+        world->compaction = *desc;
+        world->compaction_enabled = true;
+    } else {
+        ecs_os_zeromem(&world->compaction);
+        world->compaction_enabled = false;
+    }
+error:
+    return;
+}
+
+void flecs_table_compaction_run(
+    ecs_world_t *world)
+{
+    if (!world->compaction_enabled) {
+        return;
+    }
+
+    world->compaction.offset = 
+        ecs_delete_empty_tables(world, &world->compaction);
+}
+
 ecs_entities_t ecs_get_entities(
     const ecs_world_t *world)
 {
@@ -1588,6 +1730,54 @@ void ecs_shrink(
     }
 }
 
+void ecs_set_column_page_size(
+    ecs_world_t *world,
+    ecs_size_t page_size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(page_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column page size while world is in readonly mode");
+    world->column_page_size = page_size;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_page_size(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_page_size;
+error:
+    return 0;
+}
+
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    ecs_size_t alignment)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(alignment >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER,
+        "column alignment must be a power of two");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot change column alignment while world is in readonly mode");
+    world->column_alignment = alignment;
+error:
+    return;
+}
+
+ecs_size_t ecs_get_column_alignment(
+    const ecs_world_t *world)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world = ecs_get_world(world);
+    return world->column_alignment;
+error:
+    return 0;
+}
+
 void ecs_exclusive_access_begin(
     ecs_world_t *world,
     const char *thread_name)
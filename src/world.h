@@ -59,6 +59,14 @@ typedef struct ecs_store_t {
      * type info so it's guaranteed that this data is available while the
      * storage is cleaning up tables. */
     ecs_vec_t deleted_components;    /* vector<ecs_entity_t> */
+
+    /* Tables with StableOrder of which rows are out of order until the 
+     * current command flush is done. */
+    ecs_vec_t unordered_tables;      /* vector<uint64_t> */
+    int32_t defer_row_order;         /* Nesting level of flushes */
+
+    /* Storage region for columns of cold components */
+    ecs_cold_storage_t cold;
 } ecs_store_t;
 
 /* fini actions */
@@ -124,6 +132,14 @@ struct ecs_world_t {
 
     /* --  Data storage -- */
     ecs_store_t store;
+    ecs_size_t column_page_size;     /* Columns larger than this use paged storage */
+    ecs_size_t column_alignment;     /* Minimum alignment of column storage */
+
+    /* -- Table compaction -- */
+    ecs_delete_empty_tables_desc_t compaction; /* Per-frame compaction settings */
+    bool compaction_enabled;         /* Run compaction in ecs_frame_end() */
+    int32_t compaction_count;        /* Tables deleted or trimmed by cleanup */
+    int64_t compaction_bytes;        /* Bytes reclaimed by cleanup */
 
     /* -- Systems -- */
     ecs_entity_t pipeline;           /* Current pipeline */
@@ -156,11 +172,19 @@ struct ecs_world_t {
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
     ecs_os_cond_t sync_cond;         /* Signal that worker thread job is done */
+    ecs_os_cond_t system_cond;       /* Signal that a system finished running */
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t workers_signaled;        /* Number of workers signaled for job */
+    int32_t worker_spin_count;       /* Iterations to spin before blocking */
+    ecs_ftime_t worker_min_cost;     /* Minimum estimated op time per thread */
+    ecs_ftime_t worker_cost_weight;  /* Weight of last measurement in system cost */
+    ecs_vec_t worker_affinity;       /* Core per worker, -1 if not pinned */
+    ecs_map_t double_buffered;       /* Components copied for pipelined systems */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
+    ecs_async_queue_t async_queue;   /* Commands enqueued by non-stage threads */
 
     /* -- Exclusive access -- */
     ecs_os_thread_id_t exclusive_access; /* If set, world can only be mutated by thread */
@@ -228,6 +252,16 @@ void flecs_type_info_claim(
 void flecs_type_info_release(
     const ecs_type_info_t *ti);
 
+/* Test if type hooks can be used with struct-of-arrays storage. */
+bool flecs_type_hooks_allow_soa(
+    const ecs_type_hooks_t *h);
+
+/* Set struct-of-arrays layout for type. Members must be ordered by offset. */
+void flecs_type_info_set_soa(
+    ecs_type_info_t *ti,
+    const ecs_soa_member_t *members,
+    int32_t count);
+
 /* Notify tables with component of event (or all tables if id is 0). */
 void flecs_notify_tables(
     ecs_world_t *world,
@@ -244,6 +278,10 @@ uint32_t flecs_get_table_version_fast(
     const ecs_world_t *world,
     const uint64_t table_id);
 
+/* Run a table compaction step if enabled with ecs_set_table_compaction(). */
+void flecs_table_compaction_run(
+    ecs_world_t *world);
+
 /* Throws error when (OnDelete*, Panic) constraint is violated. */
 void flecs_throw_invalid_delete(
     ecs_world_t *world,
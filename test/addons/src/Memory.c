@@ -460,3 +460,97 @@ void Memory_sparse_tag_memory(void) {
 
     ecs_fini(world);
 }
+
+void Memory_cold_component_memory(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+
+    {
+        ecs_component_memory_t mem = ecs_component_memory_get(world);
+        test_assert(mem.bytes_cold_components == 0);
+    }
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_add(world, e, Velocity);
+
+    {
+        ecs_component_memory_t mem = ecs_component_memory_get(world);
+        ecs_table_t *table = ecs_get_table(world, e);
+        test_int(mem.bytes_cold_components, 
+            ecs_table_size(table) * ECS_SIZEOF(Velocity));
+        test_assert(mem.bytes_table_components > 
+            mem.bytes_cold_components);
+    }
+
+    ecs_fini(world);
+}
+
+void Memory_table_memory_reclaimed(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    {
+        ecs_table_memory_t mem = ecs_tables_memory_get(world);
+        test_int(mem.reclaimed_count, 0);
+        test_int(mem.reclaimed_bytes, 0);
+    }
+
+    ecs_entity_t entities[64];
+    for (int i = 0; i < 64; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    int32_t size = ecs_table_size(table);
+
+    /* Trim builtin tables first so only the Position table is trimmed next */
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .shrink_ratio = 0.25f
+    });
+
+    ecs_table_memory_t before = ecs_tables_memory_get(world);
+    test_int(ecs_table_size(table), size);
+
+    for (int i = 4; i < 64; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .shrink_ratio = 0.25f
+    });
+
+    int64_t bytes_shrunk = (size - 4) * 
+        (ECS_SIZEOF(ecs_entity_t) + ECS_SIZEOF(Position));
+
+    {
+        ecs_table_memory_t mem = ecs_tables_memory_get(world);
+        test_int(mem.reclaimed_count, before.reclaimed_count + 1);
+        test_int(mem.reclaimed_bytes, before.reclaimed_bytes + bytes_shrunk);
+    }
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_add(world, e, Velocity);
+    ecs_delete(world, e);
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+
+    {
+        ecs_table_memory_t mem = ecs_tables_memory_get(world);
+        test_assert(mem.reclaimed_count > before.reclaimed_count + 1);
+        test_assert(mem.reclaimed_bytes > 
+            before.reclaimed_bytes + bytes_shrunk);
+    }
+
+    ecs_fini(world);
+}
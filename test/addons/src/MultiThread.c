@@ -1370,3 +1370,1885 @@ void MultiThread_run_single_thread_on_main(void) {
 
     ecs_fini(world);
 }
+
+static const ecs_entity_t* bulk_new_zeroed(
+    ecs_world_t *world, 
+    ecs_entity_t component,
+    int32_t count)
+{
+    const ecs_entity_t *result = ecs_bulk_new_w_id(world, component, count);
+    ecs_iter_t it = ecs_each_id(world, component);
+    while (ecs_each_next(&it)) {
+        ecs_os_memset(ecs_field_w_size(&it, sizeof(Position), 0), 0, 
+            it.count * ECS_SIZEOF(Position));
+    }
+    return result;
+}
+
+static void Increment(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+void MultiThread_work_stealing_1000_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    const ecs_entity_t *entities = bulk_new_zeroed(
+        world, ecs_id(Position), 1000);
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, 1000);
+    ecs_os_memcpy_n(handles, entities, ecs_entity_t, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_work_stealing(world, true);
+    test_bool(ecs_using_work_stealing(world), true);
+
+    ecs_progress(world, 0);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_work_stealing_many_small_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    /* Create 50 tables with 2 entities each */
+    ecs_entity_t handles[100], tag = 0;
+    int i;
+    for (i = 0; i < 100; i ++) {
+        if (!(i % 2)) {
+            tag = ecs_new(world);
+        }
+        handles[i] = ecs_insert(world, ecs_value(Position, {0, 0}));
+        ecs_add_id(world, handles[i], tag);
+    }
+
+    set_worker_kind(world, 3);
+    ecs_set_work_stealing(world, true);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 100; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    /* Each table is one chunk, for two frames */
+    int64_t chunks = 0;
+    for (i = 0; i < 3; i ++) {
+        ecs_worker_stats_t stats;
+        test_bool(ecs_worker_stats_get(world, i, &stats), true);
+        chunks += stats.chunks;
+    }
+    test_int(chunks, 100);
+
+    ecs_fini(world);
+}
+
+static ecs_world_t *steal_world;
+
+static void steal_wait_for_chunks(int32_t worker, int64_t chunks) {
+    ecs_worker_stats_t stats = {0};
+    int retries = 0;
+    do {
+        ecs_worker_stats_get(steal_world, worker, &stats);
+        if (stats.chunks >= chunks) {
+            break;
+        }
+        ecs_os_sleep(0, 1000 * 1000);
+    } while (++ retries < 5000);
+}
+
+static void SlowOnWorker(ecs_iter_t *it) {
+    if (ecs_stage_get_id(it->world) == 0) {
+        /* Make sure worker has claimed its first chunk */
+        steal_wait_for_chunks(1, 1);
+    } else {
+        /* Block worker until main thread has stolen its remaining chunk */
+        steal_wait_for_chunks(0, 3);
+    }
+
+    Increment(it);
+}
+
+void MultiThread_work_stealing_steal_from_slow_worker(void) {
+    ecs_world_t *world = steal_world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = SlowOnWorker,
+        .multi_threaded = true
+    });
+
+    /* 4 chunks, 2 for each worker */
+    bulk_new_zeroed(world, ecs_id(Position), 4 * 256);
+
+    set_worker_kind(world, 2);
+    ecs_set_work_stealing(world, true);
+
+    ecs_progress(world, 0);
+
+    ecs_worker_stats_t main_stats, worker_stats;
+    test_bool(ecs_worker_stats_get(world, 0, &main_stats), true);
+    test_bool(ecs_worker_stats_get(world, 1, &worker_stats), true);
+
+    test_int(main_stats.chunks, 3);
+    test_int(main_stats.steals, 1);
+    test_int(main_stats.idle, 1);
+    test_int(worker_stats.chunks, 1);
+    test_int(worker_stats.steals, 0);
+    test_int(worker_stats.idle, 1);
+
+    ecs_iter_t it = ecs_each(world, Position);
+    while (ecs_each_next(&it)) {
+        Position *p = ecs_field(&it, Position, 0);
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            test_int(p[i].x, 1);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+static void IncrementRun(ecs_iter_t *it) {
+    while (ecs_iter_next(it)) {
+        Increment(it);
+    }
+}
+
+void MultiThread_work_stealing_w_run(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .run = IncrementRun,
+        .multi_threaded = true
+    });
+
+    const ecs_entity_t *entities = bulk_new_zeroed(
+        world, ecs_id(Position), 1000);
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, 1000);
+    ecs_os_memcpy_n(handles, entities, ecs_entity_t, 1000);
+
+    set_worker_kind(world, 3);
+    ecs_set_work_stealing(world, true);
+
+    ecs_progress(world, 0);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_work_stealing_disable(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    set_worker_kind(world, 2);
+    ecs_set_work_stealing(world, true);
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 1);
+
+    ecs_set_work_stealing(world, false);
+    test_bool(ecs_using_work_stealing(world), false);
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 2);
+
+    /* Stats are only collected while work stealing is enabled */
+    ecs_worker_stats_t main_stats, worker_stats;
+    test_bool(ecs_worker_stats_get(world, 0, &main_stats), true);
+    test_bool(ecs_worker_stats_get(world, 1, &worker_stats), true);
+    test_int(main_stats.chunks + worker_stats.chunks, 1);
+    test_bool(ecs_worker_stats_get(world, 2, &worker_stats), false);
+
+    ecs_fini(world);
+}
+
+static int32_t dag_invoked_position = 0;
+static int32_t dag_invoked_velocity = 0;
+
+static void DagIncrementPosition(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+    ecs_os_ainc(&dag_invoked_position);
+}
+
+static void DagIncrementVelocity(ecs_iter_t *it) {
+    Velocity *v = ecs_field(it, Velocity, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        v[i].x ++;
+    }
+    ecs_os_ainc(&dag_invoked_velocity);
+}
+
+static void DagCopyPosition(ecs_iter_t *it) {
+    const Position *p = ecs_field(it, Position, 0);
+    Velocity *v = ecs_field(it, Velocity, 1);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        v[i].x = p[i].x;
+    }
+}
+
+static ecs_entity_t* dag_new_entities(
+    ecs_world_t *world,
+    int32_t count)
+{
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t *result = ecs_os_malloc_n(ecs_entity_t, count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        result[i] = ecs_insert(world, 
+            ecs_value(Position, {0, 0}), 
+            ecs_value(Velocity, {0, 0}));
+    }
+    return result;
+}
+
+void MultiThread_dag_independent_systems(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = DagIncrementPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Velocity) }},
+        .callback = DagIncrementVelocity,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_dag_scheduling(world, true);
+    test_bool(ecs_using_dag_scheduling(world), true);
+
+    dag_invoked_position = 0;
+    dag_invoked_velocity = 0;
+
+    ecs_progress(world, 0);
+
+    /* Each system is run by a single worker on the entire table */
+    test_int(dag_invoked_position, 1);
+    test_int(dag_invoked_velocity, 1);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 1);
+        test_int(ecs_get(world, entities[i], Velocity)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    test_int(dag_invoked_position, 2);
+    test_int(dag_invoked_velocity, 2);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 2);
+        test_int(ecs_get(world, entities[i], Velocity)->x, 2);
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_dag_dependent_systems(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = DagIncrementPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {
+            { ecs_id(Position), .inout = EcsIn },
+            { ecs_id(Velocity), .inout = EcsOut }
+        },
+        .callback = DagCopyPosition,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_dag_scheduling(world, true);
+
+    int f, i;
+    for (f = 1; f <= 3; f ++) {
+        ecs_progress(world, 0);
+        for (i = 0; i < 1000; i ++) {
+            test_int(ecs_get(world, entities[i], Position)->x, f);
+            test_int(ecs_get(world, entities[i], Velocity)->x, f);
+        }
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_dag_chain_of_systems(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    /* Alternate between independent and dependent systems */
+    int s;
+    for (s = 0; s < 5; s ++) {
+        ecs_system(world, {
+            .phase = EcsOnUpdate,
+            .query.terms = {{ ecs_id(Position) }},
+            .callback = DagIncrementPosition,
+            .multi_threaded = true
+        });
+
+        ecs_system(world, {
+            .phase = EcsOnUpdate,
+            .query.terms = {{ ecs_id(Velocity) }},
+            .callback = DagIncrementVelocity,
+            .multi_threaded = true
+        });
+    }
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {
+            { ecs_id(Position), .inout = EcsIn },
+            { ecs_id(Velocity), .inout = EcsInOut }
+        },
+        .callback = DagCopyPosition,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 100);
+
+    set_worker_kind(world, 3);
+    ecs_set_dag_scheduling(world, true);
+
+    dag_invoked_position = 0;
+    dag_invoked_velocity = 0;
+
+    ecs_progress(world, 0);
+
+    test_int(dag_invoked_position, 5);
+    test_int(dag_invoked_velocity, 5);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 5);
+        test_int(ecs_get(world, entities[i], Velocity)->x, 5);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 100; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 10);
+        test_int(ecs_get(world, entities[i], Velocity)->x, 10);
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_dag_disable(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = DagIncrementPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Velocity) }},
+        .callback = DagIncrementVelocity,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 2);
+    ecs_set_dag_scheduling(world, true);
+    ecs_progress(world, 0);
+
+    ecs_set_dag_scheduling(world, false);
+    test_bool(ecs_using_dag_scheduling(world), false);
+
+    dag_invoked_position = 0;
+    dag_invoked_velocity = 0;
+
+    ecs_progress(world, 0);
+
+    /* Systems are divided across workers again */
+    test_int(dag_invoked_position, 2);
+    test_int(dag_invoked_velocity, 2);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 2);
+        test_int(ecs_get(world, entities[i], Velocity)->x, 2);
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_work_stealing_dependent_systems(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = DagIncrementPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {
+            { ecs_id(Position), .inout = EcsIn },
+            { ecs_id(Velocity), .inout = EcsOut }
+        },
+        .callback = DagCopyPosition,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 2000);
+
+    set_worker_kind(world, 4);
+    ecs_set_work_stealing(world, true);
+
+    int f, i;
+    for (f = 1; f <= 3; f ++) {
+        ecs_progress(world, 0);
+        for (i = 0; i < 2000; i ++) {
+            test_int(ecs_get(world, entities[i], Position)->x, f);
+            test_int(ecs_get(world, entities[i], Velocity)->x, f);
+        }
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_spin_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    test_int(ecs_get_worker_spin_count(world), 0);
+
+    ecs_set_worker_spin_count(world, 1000);
+    test_int(ecs_get_worker_spin_count(world), 1000);
+
+    ecs_set_worker_spin_count(world, 0);
+    test_int(ecs_get_worker_spin_count(world), 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_sync_w_spin(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    /* Single threaded system in between inserts sync points */
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = DagIncrementPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Velocity) }},
+        .callback = DagIncrementVelocity
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {
+            { ecs_id(Position), .inout = EcsIn },
+            { ecs_id(Velocity), .inout = EcsOut }
+        },
+        .callback = DagCopyPosition,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_spin_count(world, 100000);
+
+    int f, i;
+    for (f = 1; f <= 5; f ++) {
+        ecs_progress(world, 0);
+        for (i = 0; i < 1000; i ++) {
+            test_int(ecs_get(world, entities[i], Position)->x, f);
+            test_int(ecs_get(world, entities[i], Velocity)->x, f);
+        }
+    }
+
+    /* Each worker waits for a signal at least once per sync point */
+    ecs_worker_stats_t stats;
+    for (i = 1; i < 4; i ++) {
+        test_bool(ecs_worker_stats_get(world, i, &stats), true);
+        test_assert((stats.spins + stats.parks) >= 5);
+    }
+
+    ecs_os_free(entities);
+
+    ecs_fini(world);
+}
+
+void MultiThread_sync_w_spin_after_disable(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    set_worker_kind(world, 2);
+    ecs_set_worker_spin_count(world, 100000);
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 1);
+
+    ecs_set_worker_spin_count(world, 0);
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 2);
+
+    ecs_worker_stats_t stats;
+    test_bool(ecs_worker_stats_get(world, 1, &stats), true);
+    test_assert(stats.parks >= 1);
+
+    ecs_fini(world);
+}
+
+static void MergeSetPosition(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    ecs_id_t ecs_id(Position) = ecs_field_id(it, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_set(it->world, it->entities[i], Position, {p[i].x + 1, p[i].y});
+    }
+}
+
+static void MergeSetVelocity(ecs_iter_t *it) {
+    ecs_id_t ecs_id(Velocity) = ecs_field_id(it, 1);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        if (!(i % 2)) {
+            ecs_set(it->world, it->entities[i], Velocity, {1, 2});
+        }
+    }
+}
+
+static ecs_entity_t merge_on_set_log[1000];
+static int32_t merge_on_set_count = 0;
+
+static void MergeOnSetPosition(ecs_iter_t *it) {
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        test_assert(merge_on_set_count < 1000);
+        merge_on_set_log[merge_on_set_count ++] = it->entities[i];
+    }
+}
+
+static ecs_world_t* merge_world_init(
+    ecs_entity_t **entities_out,
+    bool parallel_merge)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = MergeSetPosition,
+        .multi_threaded = true
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = MergeOnSetPosition
+    });
+
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, 500);
+    int32_t i;
+    for (i = 0; i < 500; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, 0}));
+    }
+
+    set_worker_kind(world, 4);
+    ecs_set_parallel_merge(world, parallel_merge);
+    *entities_out = entities;
+    return world;
+}
+
+void MultiThread_parallel_merge_set(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = merge_world_init(&entities, true);
+
+    ECS_COMPONENT(world, Position);
+    test_bool(ecs_using_parallel_merge(world), true);
+
+    merge_on_set_count = 0;
+    ecs_progress(world, 0);
+    test_int(merge_on_set_count, 500);
+
+    ecs_progress(world, 0);
+    test_int(merge_on_set_count, 1000);
+
+    int i;
+    for (i = 0; i < 500; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_int(p->x, i + 2);
+        test_int(p->y, 0);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_observer_order(void) {
+    ecs_entity_t expect[500];
+
+    {
+        ecs_entity_t *entities;
+        ecs_world_t *world = merge_world_init(&entities, false);
+        merge_on_set_count = 0;
+        ecs_progress(world, 0);
+        test_int(merge_on_set_count, 500);
+        ecs_os_memcpy_n(expect, merge_on_set_log, ecs_entity_t, 500);
+        ecs_os_free(entities);
+        ecs_fini(world);
+    }
+
+    {
+        ecs_entity_t *entities;
+        ecs_world_t *world = merge_world_init(&entities, true);
+        merge_on_set_count = 0;
+        ecs_progress(world, 0);
+        test_int(merge_on_set_count, 500);
+
+        /* Observers are invoked in the same order as the serial merge */
+        int i;
+        for (i = 0; i < 500; i ++) {
+            test_uint(merge_on_set_log[i], expect[i]);
+        }
+
+        ecs_os_free(entities);
+        ecs_fini(world);
+    }
+}
+
+void MultiThread_parallel_merge_w_add(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = MergeSetPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .oper = EcsNot }},
+        .callback = MergeSetVelocity,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t entities[500];
+    int32_t i;
+    for (i = 0; i < 500; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, 0}));
+    }
+
+    set_worker_kind(world, 4);
+    ecs_set_parallel_merge(world, true);
+
+    ecs_progress(world, 0);
+
+    /* Entities that had Velocity added are merged on the main thread */
+    int32_t with_velocity = 0;
+    for (i = 0; i < 500; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_int(p->x, i + 1);
+        const Velocity *v = ecs_get(world, entities[i], Velocity);
+        if (v) {
+            test_int(v->x, 1);
+            test_int(v->y, 2);
+            with_velocity ++;
+        }
+    }
+
+    test_assert(with_velocity > 0);
+    test_assert(with_velocity < 500);
+
+    ecs_fini(world);
+}
+
+static void MergeDeleteParent(ecs_iter_t *it) {
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_delete(it->world, it->entities[i]);
+    }
+}
+
+static int32_t merge_w_delete(
+    ecs_entity_t *log,
+    bool parallel_merge) 
+{
+    ecs_entity_t *entities;
+    ecs_world_t *world = merge_world_init(&entities, parallel_merge);
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Parent);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ Parent }},
+        .callback = MergeDeleteParent,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t parent = ecs_new_w(world, Parent);
+    int32_t i;
+    for (i = 0; i < 500; i += 10) {
+        ecs_add_pair(world, entities[i], EcsChildOf, parent);
+    }
+
+    merge_on_set_count = 0;
+    ecs_progress(world, 0);
+
+    test_assert(!ecs_is_alive(world, parent));
+    for (i = 0; i < 500; i ++) {
+        if (!(i % 10)) {
+            test_assert(!ecs_is_alive(world, entities[i]));
+        } else {
+            test_int(ecs_get(world, entities[i], Position)->x, i + 1);
+        }
+    }
+
+    ecs_os_memcpy_n(log, merge_on_set_log, ecs_entity_t, merge_on_set_count);
+    ecs_os_free(entities);
+    ecs_fini(world);
+    return merge_on_set_count;
+}
+
+void MultiThread_parallel_merge_w_delete(void) {
+    ecs_entity_t expect[1000], log[1000];
+    int32_t expect_count = merge_w_delete(expect, false);
+    int32_t count = merge_w_delete(log, true);
+
+    /* Deletes fall back to the serial merge */
+    test_int(count, expect_count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        test_uint(log[i], expect[i]);
+    }
+}
+
+void MultiThread_parallel_merge_disable(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = merge_world_init(&entities, true);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_progress(world, 0);
+
+    ecs_set_parallel_merge(world, false);
+    test_bool(ecs_using_parallel_merge(world), false);
+
+    merge_on_set_count = 0;
+    ecs_progress(world, 0);
+    test_int(merge_on_set_count, 500);
+
+    int i;
+    for (i = 0; i < 500; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, i + 2);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_worker_affinity(void) {
+    ecs_world_t *world = ecs_init();
+
+    test_int(ecs_get_worker_affinity(world, 0), -1);
+    test_int(ecs_get_worker_affinity(world, 1), -1);
+
+    int32_t cpus[] = {-1, 0, 1};
+    ecs_set_worker_affinity(world, cpus, 3);
+    test_int(ecs_get_worker_affinity(world, 0), -1);
+    test_int(ecs_get_worker_affinity(world, 1), 0);
+    test_int(ecs_get_worker_affinity(world, 2), 1);
+    test_int(ecs_get_worker_affinity(world, 3), -1);
+
+    ecs_set_worker_affinity(world, NULL, 0);
+    test_int(ecs_get_worker_affinity(world, 1), -1);
+    test_int(ecs_get_worker_affinity(world, 2), -1);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_affinity_run(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    /* Every platform that supports affinity has a core 0 */
+    int32_t cpus[] = {-1, 0, 0, 0};
+    ecs_set_worker_affinity(world, cpus, 4);
+    set_worker_kind(world, 4);
+
+    int f, i;
+    for (f = 1; f <= 3; f ++) {
+        ecs_progress(world, 0);
+        for (i = 0; i < 1000; i ++) {
+            test_int(ecs_get(world, entities[i], Position)->x, f);
+        }
+    }
+
+    /* Main thread is never pinned, task threads are not pinned */
+    ecs_worker_stats_t stats;
+    test_bool(ecs_worker_stats_get(world, 0, &stats), true);
+    test_bool(stats.pinned, false);
+
+    const char *worker_kind = test_param("worker_kind");
+    bool use_tasks = worker_kind && !strcmp(worker_kind, "task");
+    test_bool(ecs_worker_stats_get(world, 1, &stats), true);
+    bool pinned = stats.pinned;
+    if (use_tasks) {
+        test_bool(pinned, false);
+    }
+
+    for (i = 2; i < 4; i ++) {
+        test_bool(ecs_worker_stats_get(world, i, &stats), true);
+        test_bool(stats.pinned, pinned);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_worker_affinity_running_threads(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    set_worker_kind(world, 2);
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 1);
+
+    const char *worker_kind = test_param("worker_kind");
+    bool use_tasks = worker_kind && !strcmp(worker_kind, "task");
+
+    /* Running threads are pinned without being restarted */
+    ecs_worker_stats_t stats;
+    ecs_world_t *stage = ecs_get_stage(world, 1);
+    test_bool(ecs_worker_stats_get(world, 1, &stats), true);
+    test_bool(stats.pinned, false);
+
+    int32_t cpus[] = {-1, 0};
+    ecs_set_worker_affinity(world, cpus, 2);
+    test_int(ecs_get_stage_count(world), 2);
+    test_assert(ecs_get_stage(world, 1) == stage);
+
+    test_bool(ecs_worker_stats_get(world, 1, &stats), true);
+    bool pinned = stats.pinned;
+    if (use_tasks) {
+        test_bool(pinned, false);
+    }
+
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 2);
+
+    ecs_set_worker_affinity(world, NULL, 0);
+    test_int(ecs_get_stage_count(world), 2);
+    test_assert(ecs_get_stage(world, 1) == stage);
+
+    test_bool(ecs_worker_stats_get(world, 1, &stats), true);
+    test_bool(stats.pinned, false);
+
+    ecs_progress(world, 0);
+    test_int(ecs_get(world, e, Position)->x, 3);
+
+    ecs_fini(world);
+}
+
+static int32_t affinity_table_invoked[4];
+
+static void AffinityCountTables(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+    affinity_table_invoked[it->world == it->real_world ? 0 : 
+        ecs_stage_get_id(it->world)] ++;
+}
+
+void MultiThread_worker_affinity_small_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = AffinityCountTables,
+        .multi_threaded = true
+    });
+
+    /* Tables with fewer entities than workers */
+    ecs_entity_t entities[20];
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t tag = ecs_new(world);
+        entities[i * 2] = ecs_insert(world, ecs_value(Position, {0, 0}));
+        entities[i * 2 + 1] = ecs_insert(world, ecs_value(Position, {0, 0}));
+        ecs_add_id(world, entities[i * 2], tag);
+        ecs_add_id(world, entities[i * 2 + 1], tag);
+    }
+
+    int32_t cpus[] = {-1, 0, 0, 0};
+    ecs_set_worker_affinity(world, cpus, 4);
+    set_worker_kind(world, 4);
+
+    ecs_os_zeromem(&affinity_table_invoked);
+    ecs_progress(world, 0);
+
+    /* Each table is processed by a single worker */
+    int32_t total = 0;
+    for (i = 0; i < 4; i ++) {
+        total += affinity_table_invoked[i];
+    }
+    test_int(total, 10);
+
+    for (i = 0; i < 20; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 1);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_chunking_min_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = AffinityCountTables,
+        .multi_threaded = true,
+        .chunking.min_count = 4
+    });
+
+    /* Tables with fewer entities than min_count */
+    ecs_entity_t entities[30];
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t tag = ecs_new(world);
+        int j;
+        for (j = 0; j < 3; j ++) {
+            entities[i * 3 + j] = ecs_insert(world, ecs_value(Position, {0, 0}));
+            ecs_add_id(world, entities[i * 3 + j], tag);
+        }
+    }
+
+    set_worker_kind(world, 4);
+
+    ecs_os_zeromem(&affinity_table_invoked);
+    ecs_progress(world, 0);
+
+    /* Each table is processed as a whole by a single worker */
+    int32_t total = 0;
+    for (i = 0; i < 4; i ++) {
+        total += affinity_table_invoked[i];
+    }
+    test_int(total, 10);
+
+    for (i = 0; i < 30; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 1);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_chunking_chunk_size(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = AffinityCountTables,
+        .multi_threaded = true,
+        .chunking.chunk_size = 100
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 4);
+
+    ecs_os_zeromem(&affinity_table_invoked);
+    ecs_progress(world, 0);
+
+    /* Table is split up in chunks of 100 entities */
+    int32_t i, total = 0;
+    for (i = 0; i < 4; i ++) {
+        total += affinity_table_invoked[i];
+    }
+    test_int(total, 10);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 1);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_chunking_w_work_stealing(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = AffinityCountTables,
+        .multi_threaded = true,
+        .chunking.chunk_size = 100
+    });
+
+    ecs_entity_t *entities = dag_new_entities(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_work_stealing(world, true);
+
+    ecs_os_zeromem(&affinity_table_invoked);
+    ecs_progress(world, 0);
+
+    /* Work stealing uses chunk size of system */
+    int32_t i, total = 0;
+    for (i = 0; i < 4; i ++) {
+        total += affinity_table_invoked[i];
+    }
+    test_int(total, 10);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 1);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_chunking_update(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t s = ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    const ecs_system_t *sys = ecs_system_get(world, s);
+    test_int(sys->chunking.min_count, 0);
+    test_int(sys->chunking.chunk_size, 0);
+
+    ecs_system_update(world, s, &(ecs_system_desc_t){
+        .chunking = { .min_count = 16, .chunk_size = 64 }
+    });
+
+    test_int(sys->chunking.min_count, 16);
+    test_int(sys->chunking.chunk_size, 64);
+
+    ecs_system_update(world, s, &(ecs_system_desc_t){
+        .callback = Increment
+    });
+
+    test_int(sys->chunking.min_count, 16);
+    test_int(sys->chunking.chunk_size, 64);
+
+    ecs_system_update(world, s, &(ecs_system_desc_t){
+        .chunking = { .disable = true }
+    });
+
+    test_int(sys->chunking.min_count, 0);
+    test_int(sys->chunking.chunk_size, 0);
+
+    ecs_fini(world);
+}
+
+static int64_t pipelined_sum[4];
+static int32_t pipelined_count[4];
+
+static void PipelinedRead(ecs_iter_t *it) {
+    const Position *p = ecs_field(it, Position, 0);
+    int32_t stage = it->world == it->real_world ? 0 : 
+        ecs_stage_get_id(it->world);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        pipelined_sum[stage] += (int64_t)p[i].x;
+    }
+    pipelined_count[stage] += it->count;
+}
+
+static int64_t pipelined_total_sum(void) {
+    return pipelined_sum[0] + pipelined_sum[1] + 
+        pipelined_sum[2] + pipelined_sum[3];
+}
+
+static int32_t pipelined_total_count(void) {
+    return pipelined_count[0] + pipelined_count[1] + 
+        pipelined_count[2] + pipelined_count[3];
+}
+
+static void pipelined_reset(void) {
+    ecs_os_zeromem(&pipelined_sum);
+    ecs_os_zeromem(&pipelined_count);
+}
+
+static ecs_world_t* pipelined_world_init(
+    ecs_entity_t **entities_out,
+    int32_t entity_count,
+    bool multi_threaded)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Increment,
+        .multi_threaded = multi_threaded
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnStore,
+        .query.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .callback = PipelinedRead,
+        .multi_threaded = multi_threaded,
+        .pipelined = true
+    });
+
+    *entities_out = dag_new_entities(world, entity_count);
+    ecs_set_double_buffered(world, ecs_id(Position), true);
+    pipelined_reset();
+
+    return world;
+}
+
+void MultiThread_pipelined_frames(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    test_bool(ecs_using_pipelined_frames(world), false);
+    ecs_set_pipelined_frames(world, true);
+    test_bool(ecs_using_pipelined_frames(world), true);
+    ecs_set_pipelined_frames(world, false);
+    test_bool(ecs_using_pipelined_frames(world), false);
+
+    test_bool(ecs_is_double_buffered(world, ecs_id(Position)), false);
+    ecs_set_double_buffered(world, ecs_id(Position), true);
+    test_bool(ecs_is_double_buffered(world, ecs_id(Position)), true);
+    ecs_set_double_buffered(world, ecs_id(Position), false);
+    test_bool(ecs_is_double_buffered(world, ecs_id(Position)), false);
+
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_run(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 100, false);
+
+    ecs_set_pipelined_frames(world, true);
+
+    /* Pipelined system doesn't run in first frame */
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 0);
+
+    /* Pipelined system reads values from the previous frame */
+    int f;
+    for (f = 2; f <= 5; f ++) {
+        pipelined_reset();
+        ecs_progress(world, 0);
+        test_int(pipelined_total_count(), 100);
+        test_int(pipelined_total_sum(), 100 * (f - 1));
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_multithreaded(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 1000, true);
+
+    ECS_COMPONENT(world, Position);
+
+    set_worker_kind(world, 4);
+    ecs_set_pipelined_frames(world, true);
+
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 0);
+
+    int f, i;
+    for (f = 2; f <= 5; f ++) {
+        pipelined_reset();
+        ecs_progress(world, 0);
+        test_int(pipelined_total_count(), 1000);
+        test_int(pipelined_total_sum(), 1000 * (f - 1));
+    }
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, entities[i], Position)->x, 5);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_disable(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 100, false);
+
+    ecs_set_pipelined_frames(world, true);
+
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 0);
+
+    /* Disabling runs pending systems */
+    ecs_set_pipelined_frames(world, false);
+    test_int(pipelined_total_count(), 100);
+    test_int(pipelined_total_sum(), 100);
+
+    /* Pipelined system runs in same frame */
+    pipelined_reset();
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 100);
+    test_int(pipelined_total_sum(), 200);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_disable_w_custom_pipeline(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 100, false);
+
+    ecs_entity_t pipeline = ecs_pipeline(world, {
+        .query.terms = {
+            { .id = EcsSystem },
+            { .id = EcsPhase, .src.id = EcsCascade, .trav = EcsDependsOn }
+        }
+    });
+
+    ecs_set_pipelined_frames(world, true);
+
+    ecs_run_pipeline(world, pipeline, 0);
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 0);
+
+    /* Disabling runs pending systems of all pipelines */
+    ecs_set_pipelined_frames(world, false);
+    test_int(pipelined_total_count(), 200);
+    test_int(pipelined_total_sum(), 300);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_new_entities(void) {
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 100, false);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_pipelined_frames(world, true);
+    ecs_progress(world, 0);
+
+    /* Entities deleted between frames are removed from copied data */
+    int i;
+    for (i = 0; i < 50; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    pipelined_reset();
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 50);
+    test_int(pipelined_total_sum(), 50);
+
+    pipelined_reset();
+    ecs_progress(world, 0);
+    test_int(pipelined_total_count(), 50);
+    test_int(pipelined_total_sum(), 100);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+void MultiThread_pipelined_frames_not_double_buffered(void) {
+    install_test_abort();
+
+    ecs_entity_t *entities;
+    ecs_world_t *world = pipelined_world_init(&entities, 100, false);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_double_buffered(world, ecs_id(Position), false);
+    ecs_set_pipelined_frames(world, true);
+
+    test_expect_abort();
+    ecs_progress(world, 0);
+}
+
+static int32_t cost_stage_count[4];
+
+static void CostCountStages(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int32_t i, stage = ecs_stage_get_id(it->world);
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+    cost_stage_count[stage] += it->count;
+}
+
+static ecs_entity_t cost_world_init(
+    ecs_world_t *world,
+    int32_t entity_count)
+{
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t system = ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = CostCountStages,
+        .multi_threaded = true
+    });
+
+    if (entity_count) {
+        ecs_os_free(dag_new_entities(world, entity_count));
+    }
+
+    ecs_os_zeromem(&cost_stage_count);
+
+    return system;
+}
+
+static int32_t cost_sync_worker_count(
+    ecs_world_t *world)
+{
+    ecs_pipeline_stats_t stats = {0};
+    test_bool(ecs_pipeline_stats_get(
+        world, ecs_get_pipeline(world), &stats), true);
+    test_assert(ecs_vec_count(&stats.sync_points) != 0);
+    int32_t result = ecs_vec_first_t(
+        &stats.sync_points, ecs_sync_stats_t)->worker_count;
+    ecs_pipeline_stats_fini(&stats);
+    return result;
+}
+
+void MultiThread_worker_min_cost(void) {
+    ecs_world_t *world = ecs_init();
+
+    test_assert(ecs_get_worker_min_cost(world) == 0);
+
+    ecs_set_worker_min_cost(world, 0.001f);
+    test_assert(ecs_get_worker_min_cost(world) == 0.001f);
+
+    ecs_set_worker_min_cost(world, 0);
+    test_assert(ecs_get_worker_min_cost(world) == 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_cost_weight(void) {
+    ecs_world_t *world = ecs_init();
+
+    test_assert(ecs_get_worker_cost_weight(world) == 0.25f);
+
+    ecs_set_worker_cost_weight(world, 1);
+    test_assert(ecs_get_worker_cost_weight(world) == 1);
+
+    ecs_set_worker_cost_weight(world, 0.5f);
+    test_assert(ecs_get_worker_cost_weight(world) == 0.5f);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_min_cost_all_threads(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t system = cost_world_init(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_min_cost(world, 0.000000001f);
+
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+
+    int32_t i;
+    for (i = 0; i < 4; i ++) {
+        test_int(cost_stage_count[i], 500);
+    }
+
+    const ecs_system_t *sys = ecs_system_get(world, system);
+    test_int(sys->matched_count, 1000);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_min_cost_single_thread(void) {
+    ecs_world_t *world = ecs_init();
+
+    cost_world_init(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_min_cost(world, 1000);
+
+    /* First frame runs on all threads to measure cost */
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+    test_int(cost_stage_count[0], 250);
+
+    /* Estimated cost is lower than minimum cost for a single thread */
+    ecs_os_zeromem(&cost_stage_count);
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 1);
+    test_int(cost_stage_count[0], 1000);
+    test_int(cost_stage_count[1], 0);
+    test_int(cost_stage_count[2], 0);
+    test_int(cost_stage_count[3], 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_min_cost_dag(void) {
+    ecs_world_t *world = ecs_init();
+
+    cost_world_init(world, 1000);
+
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Velocity) }},
+        .callback = DagIncrementVelocity,
+        .multi_threaded = true
+    });
+
+    set_worker_kind(world, 4);
+    ecs_set_dag_scheduling(world, true);
+    ecs_set_worker_min_cost(world, 1000);
+
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+    test_int(cost_stage_count[0] + cost_stage_count[1] + 
+        cost_stage_count[2] + cost_stage_count[3], 1000);
+
+    /* Systems of the sync point run on the main thread */
+    ecs_os_zeromem(&cost_stage_count);
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 1);
+    test_int(cost_stage_count[0], 1000);
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_min_cost_disable(void) {
+    ecs_world_t *world = ecs_init();
+
+    cost_world_init(world, 1000);
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_min_cost(world, 1000);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 1);
+
+    ecs_set_worker_min_cost(world, 0);
+
+    ecs_os_zeromem(&cost_stage_count);
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+
+    int32_t i;
+    for (i = 0; i < 4; i ++) {
+        test_int(cost_stage_count[i], 250);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_worker_min_cost_surplus_workers_wait(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t system = cost_world_init(world, 1000);
+
+    ecs_set_threads(world, 4);
+    ecs_set_worker_spin_count(world, 0);
+    ecs_set_worker_min_cost(world, 500);
+
+    /* First frame runs on all threads to measure cost */
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+
+    ecs_system_t *sys = ECS_CONST_CAST(ecs_system_t*, 
+        ecs_system_get(world, system));
+    sys->cost_per_entity = 1;
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 2);
+
+    ecs_worker_stats_t before;
+    test_bool(ecs_worker_stats_get(world, 3, &before), true);
+
+    ecs_os_zeromem(&cost_stage_count);
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        sys->cost_per_entity = 1;
+        ecs_progress(world, 0);
+        test_int(cost_sync_worker_count(world), 2);
+    }
+
+    test_int(cost_stage_count[0] + cost_stage_count[1], 10000);
+    test_int(cost_stage_count[2], 0);
+    test_int(cost_stage_count[3], 0);
+
+    /* Workers that weren't selected for the sync point weren't woken up. The
+     * worker may still be parking after the previous frame. */
+    ecs_worker_stats_t after;
+    test_bool(ecs_worker_stats_get(world, 3, &after), true);
+    test_assert((after.spins + after.parks) <= (before.spins + before.parks + 1));
+
+    /* Surplus workers resume when all threads are used again */
+    ecs_set_worker_min_cost(world, 0);
+    ecs_os_zeromem(&cost_stage_count);
+    ecs_progress(world, 0);
+    test_int(cost_sync_worker_count(world), 4);
+    for (i = 0; i < 4; i ++) {
+        test_int(cost_stage_count[i], 250);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_task_threads_reuse_pool(void) {
+    ecs_world_t *world = init_world();
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    ecs_os_set_task_pool_max_idle(3);
+    ecs_set_task_threads(world, 4);
+
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    /* Tasks of the next frame run on the threads of the previous frame */
+    test_int(ecs_os_task_pool_count(), 3);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+
+    ecs_fini(world);
+
+    test_int(ecs_os_task_pool_count(), 0);
+}
+
+void MultiThread_task_pool_disabled(void) {
+    ecs_world_t *world = init_world();
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    ecs_set_task_threads(world, 4);
+
+    ecs_progress(world, 0);
+
+    /* Without idle threads each task runs on a new thread */
+    test_int(ecs_os_task_pool_count(), 0);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 1);
+
+    ecs_fini(world);
+}
+
+void MultiThread_task_pool_max_idle(void) {
+    ecs_world_t *world = init_world();
+
+    ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    ecs_os_set_task_pool_max_idle(1);
+    ecs_set_task_threads(world, 4);
+
+    ecs_progress(world, 0);
+    test_int(ecs_os_task_pool_count(), 1);
+
+    ecs_progress(world, 0);
+    test_int(ecs_os_task_pool_count(), 1);
+
+    /* Idle threads above the new maximum exit */
+    ecs_os_set_task_pool_max_idle(0);
+    while (ecs_os_task_pool_count()) {
+        ecs_os_sleep(0, 1000 * 1000);
+    }
+
+    ecs_fini(world);
+}
+
+static int32_t task_submit_count = 0;
+
+static void* TaskSubmit(void *arg) {
+    ecs_os_ainc(arg);
+    return NULL;
+}
+
+void MultiThread_task_submit(void) {
+    ecs_world_t *world = ecs_init();
+
+    task_submit_count = 0;
+
+    /* Keep idle threads around so they can be counted after the tasks ran */
+    ecs_os_set_task_pool_max_idle(10);
+
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        ecs_os_task_submit(TaskSubmit, &task_submit_count);
+    }
+
+    test_assert(ecs_os_task_pool_count() >= 1);
+    test_assert(ecs_os_task_pool_count() <= 10);
+
+    /* Submitted tasks are finished before the pool stops */
+    ecs_fini(world);
+
+    test_int(task_submit_count, 10);
+    test_int(ecs_os_task_pool_count(), 0);
+
+    ecs_os_set_task_pool_max_idle(0);
+}
+
+static void TaskSubmitSystem(ecs_iter_t *it) {
+    ecs_os_task_submit(TaskSubmit, &task_submit_count);
+    Progress(it);
+}
+
+void MultiThread_task_submit_from_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    task_submit_count = 0;
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = TaskSubmitSystem,
+        .multi_threaded = true
+    });
+
+    int32_t i;
+    for (i = 0; i < 4; i ++) {
+        ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    ecs_set_task_threads(world, 2);
+
+    for (i = 0; i < 5; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    ecs_fini(world);
+
+    /* System runs on both workers each frame */
+    test_int(task_submit_count, 10);
+    test_int(ecs_os_task_pool_count(), 0);
+}
+
+void MultiThread_row_changes_w_multi_threaded_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position), .inout = EcsOut }},
+        .callback = Increment,
+        .multi_threaded = true
+    });
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    ecs_set_threads(world, 8);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    ecs_progress(world, 0);
+
+    {
+        int32_t changed = 0;
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            int32_t row = 0, count = 0;
+            while (ecs_iter_changed_rows(&it, &row, &count)) {
+                changed += count;
+                row += count;
+            }
+        }
+        test_int(changed, 1000);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
@@ -3607,3 +3607,328 @@ void Pipeline_update_pipeline_replaces_existing(void) {
 
     ecs_fini(world);
 }
+
+static int patch_invoked[5];
+
+static void PatchSys(ecs_iter_t *it) {
+    int *index = it->ctx;
+    ecs_os_ainc(&patch_invoked[*index]);
+}
+
+static ecs_entity_t patch_system(
+    ecs_world_t *world,
+    int *index,
+    ecs_entity_t phase,
+    const char *expr,
+    bool multi_threaded)
+{
+    return ecs_system(world, {
+        .phase = phase,
+        .query.expr = expr,
+        .callback = PatchSys,
+        .ctx = index,
+        .multi_threaded = multi_threaded
+    });
+}
+
+/* Systems in schedule, 0 indicates a merge */
+static void test_pipeline_schedule(
+    ecs_world_t *world,
+    const ecs_entity_t *expect,
+    int32_t expect_count)
+{
+    ecs_pipeline_stats_t stats = {0};
+    test_bool(ecs_pipeline_stats_get(
+        world, ecs_get_pipeline(world), &stats), true);
+    test_int(ecs_vec_count(&stats.systems), expect_count);
+    ecs_entity_t *systems = ecs_vec_first_t(&stats.systems, ecs_entity_t);
+    int32_t i;
+    for (i = 0; i < expect_count; i ++) {
+        test_uint(systems[i], expect[i]);
+    }
+    ecs_pipeline_stats_fini(&stats);
+}
+
+static void test_pipeline_build_counts(
+    ecs_world_t *world,
+    int32_t rebuild_count,
+    int32_t patch_count)
+{
+    ecs_pipeline_stats_t stats = {0};
+    test_bool(ecs_pipeline_stats_get(
+        world, ecs_get_pipeline(world), &stats), true);
+    test_int(stats.rebuild_count, rebuild_count);
+    test_int(stats.patch_count, patch_count);
+    ecs_pipeline_stats_fini(&stats);
+}
+
+static void patch_systems_init(
+    ecs_world_t *world,
+    ecs_entity_t *s,
+    bool multi_threaded)
+{
+    static int index[5] = {0, 1, 2, 3, 4};
+    ecs_os_zeromem(&patch_invoked);
+
+    s[0] = patch_system(world, &index[0], EcsPreUpdate, 
+        "Position", multi_threaded);
+    s[1] = patch_system(world, &index[1], EcsOnUpdate, 
+        "[out] Position()", false);
+    s[2] = patch_system(world, &index[2], EcsOnUpdate, 
+        "[in] Position", multi_threaded);
+    s[3] = patch_system(world, &index[3], EcsPostUpdate, 
+        "[out] Velocity()", false);
+    s[4] = patch_system(world, &index[4], EcsPostUpdate, 
+        "[in] Velocity", multi_threaded);
+}
+
+void Pipeline_patch_disable_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_entity_t s[5];
+    patch_systems_init(world, s, false);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0, s[4], 0 }, 8);
+
+    ecs_enable(world, s[1], false);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[2], s[3], 0, s[4], 0 }, 6);
+    test_int(patch_invoked[0], 2);
+    test_int(patch_invoked[1], 1);
+    test_int(patch_invoked[2], 2);
+    test_int(patch_invoked[3], 2);
+    test_int(patch_invoked[4], 2);
+
+    ecs_enable(world, s[1], true);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 2);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0, s[4], 0 }, 8);
+    test_int(patch_invoked[0], 3);
+    test_int(patch_invoked[1], 2);
+    test_int(patch_invoked[2], 3);
+    test_int(patch_invoked[3], 3);
+    test_int(patch_invoked[4], 3);
+
+    test_int(ecs_get_world_info(world)->pipeline_build_count_total, 3);
+
+    ecs_fini(world);
+}
+
+void Pipeline_patch_activate_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_entity_t s[5];
+    patch_systems_init(world, s, false);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0 }, 6);
+    test_int(patch_invoked[4], 0);
+
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0, s[4], 0 }, 8);
+    test_int(patch_invoked[0], 2);
+    test_int(patch_invoked[3], 2);
+    test_int(patch_invoked[4], 1);
+
+    ecs_remove(world, e, Velocity);
+    ecs_run_aperiodic(world, EcsAperiodicEmptyQueries);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 2);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0 }, 6);
+    test_int(patch_invoked[4], 1);
+
+    ecs_fini(world);
+}
+
+void Pipeline_patch_add_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_entity_t s[5];
+    patch_systems_init(world, s, false);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+
+    static int index = 0;
+    ecs_entity_t added = patch_system(world, &index, EcsPostUpdate, 
+        "[in] Position", false);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0, s[4], added, 0 }, 9);
+    test_int(patch_invoked[0], 3);
+    test_int(patch_invoked[4], 2);
+
+    ecs_delete(world, added);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 2);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], 0, s[2], s[3], 0, s[4], 0 }, 8);
+
+    ecs_fini(world);
+}
+
+void Pipeline_patch_disable_first_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_entity_t s[5];
+    patch_systems_init(world, s, false);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+
+    ecs_enable(world, s[0], false);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[1], 0, s[2], s[3], 0, s[4], 0 }, 7);
+
+    /* Disabling all systems of the first op can't reuse any ops */
+    ecs_enable(world, s[1], false);
+    ecs_enable(world, s[2], false);
+    ecs_enable(world, s[3], false);
+    ecs_enable(world, s[4], false);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 2, 1);
+
+    ecs_enable(world, s[4], true);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 3, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){ s[4], 0 }, 2);
+    test_int(patch_invoked[4], 3);
+
+    ecs_fini(world);
+}
+
+void Pipeline_patch_multithreaded(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, Position, {10, 20});
+        ecs_set(world, e, Velocity, {1, 2});
+    }
+
+    ecs_entity_t s[5];
+    patch_systems_init(world, s, true);
+    ecs_set_threads(world, 2);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+
+    ecs_enable(world, s[1], false);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[2], 0, s[3], 0, s[4], 0 }, 7);
+
+    ecs_enable(world, s[1], true);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 2);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], 0, s[1], 0, s[2], 0, s[3], 0, s[4], 0 }, 10);
+
+    /* Both workers run multithreaded systems for one result each */
+    test_int(patch_invoked[0], 6);
+    test_int(patch_invoked[1], 2);
+    test_int(patch_invoked[2], 6);
+    test_int(patch_invoked[3], 3);
+    test_int(patch_invoked[4], 6);
+
+    ecs_fini(world);
+}
+
+void Pipeline_patch_dag_scheduling(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, Position, {10, 20});
+        ecs_set(world, e, Velocity, {1, 2});
+    }
+
+    static int index[4] = {0, 1, 2, 3};
+    ecs_os_zeromem(&patch_invoked);
+    ecs_entity_t s[4];
+    s[0] = patch_system(world, &index[0], EcsOnUpdate, "Position", true);
+    s[1] = patch_system(world, &index[1], EcsOnUpdate, "Velocity", true);
+    s[2] = patch_system(world, &index[2], EcsOnUpdate, 
+        "[in] Position", true);
+    s[3] = patch_system(world, &index[3], EcsOnUpdate, 
+        "[out] Velocity()", false);
+
+    ecs_set_threads(world, 2);
+    ecs_set_dag_scheduling(world, true);
+
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 0);
+    for (i = 0; i < 4; i ++) {
+        test_int(patch_invoked[i], 1);
+    }
+
+    ecs_enable(world, s[1], false);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 1);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[2], 0, s[3], 0 }, 5);
+
+    ecs_os_zeromem(&patch_invoked);
+    ecs_enable(world, s[1], true);
+    ecs_progress(world, 0);
+    test_pipeline_build_counts(world, 1, 2);
+    test_pipeline_schedule(world, (ecs_entity_t[]){
+        s[0], s[1], s[2], 0, s[3], 0 }, 6);
+    for (i = 0; i < 4; i ++) {
+        test_int(patch_invoked[i], 1);
+    }
+
+    ecs_fini(world);
+}
@@ -267,3 +267,109 @@ void Stats_progress_stats_systems(void) {
 
     ecs_fini(world);
 }
+
+static void MtSys(ecs_iter_t *it) { }
+
+void Stats_get_pipeline_stats_sync_wait_histogram(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = MtSys,
+        .multi_threaded = true
+    });
+
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_set_threads(world, 2);
+    ecs_measure_system_time(world, true);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    ecs_entity_t pipeline = ecs_get_pipeline(world);
+    ecs_pipeline_stats_t stats = {0};
+    test_bool(ecs_pipeline_stats_get(world, pipeline, &stats), true);
+    test_int(ecs_vec_count(&stats.sync_points), 1);
+
+    ecs_sync_stats_t *sync = ecs_vec_first_t(
+        &stats.sync_points, ecs_sync_stats_t);
+    test_bool(sync->multi_threaded, true);
+
+    int64_t count = 0;
+    int32_t i;
+    for (i = 0; i < FLECS_SYNC_WAIT_BUCKETS; i ++) {
+        count += sync->wait_histogram[i];
+    }
+    test_int(count, 3);
+
+    ecs_pipeline_stats_fini(&stats);
+
+    ecs_fini(world);
+}
+
+static void AddVelocity(ecs_iter_t *it) {
+    ecs_entity_t ecs_id(Velocity) = ecs_field_id(it, 1);
+    for (int i = 0; i < it->count; i ++) {
+        ecs_add(it->world, it->entities[i], Velocity);
+    }
+}
+
+static void DeleteAndAdd(ecs_iter_t *it) {
+    ecs_entity_t ecs_id(Velocity) = ecs_field_id(it, 1);
+    for (int i = 0; i < it->count; i ++) {
+        ecs_delete(it->world, it->entities[i]);
+        ecs_add(it->world, it->entities[i], Velocity);
+    }
+}
+
+void Stats_get_system_stats_commands(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t add_sys = ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .oper = EcsNot }},
+        .callback = AddVelocity
+    });
+
+    ecs_entity_t del_sys = ecs_system(world, {
+        .phase = EcsOnUpdate,
+        .query.terms = {{ Foo }, { ecs_id(Velocity), .oper = EcsNot }},
+        .callback = DeleteAndAdd
+    });
+
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_new_w(world, Foo);
+
+    ecs_measure_system_time(world, true);
+    ecs_progress(world, 0);
+
+    const ecs_system_t *s = ecs_system_get(world, add_sys);
+    test_assert(s != NULL);
+    test_int(s->commands_enqueued, 3);
+    test_int(s->commands_discarded, 0);
+    test_int(s->commands_coalesced, 3);
+
+    s = ecs_system_get(world, del_sys);
+    test_assert(s != NULL);
+    test_int(s->commands_enqueued, 2);
+    test_int(s->commands_discarded, 1);
+    test_int(s->commands_coalesced, 0);
+
+    ecs_system_stats_t stats = {0};
+    test_bool(ecs_system_stats_get(world, add_sys, &stats), true);
+    test_int(stats.commands_enqueued.counter.value[stats.query.t], 3);
+    test_int(stats.commands_coalesced.counter.value[stats.query.t], 3);
+
+    ecs_fini(world);
+}
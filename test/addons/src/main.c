@@ -117,6 +117,12 @@ void Pipeline_set_time_scale_w_stage(void);
 void Pipeline_set_time_scale_w_readonly(void);
 void Pipeline_init_failure_preserves_user_entity(void);
 void Pipeline_update_pipeline_replaces_existing(void);
+void Pipeline_patch_disable_system(void);
+void Pipeline_patch_activate_system(void);
+void Pipeline_patch_add_system(void);
+void Pipeline_patch_disable_first_system(void);
+void Pipeline_patch_multithreaded(void);
+void Pipeline_patch_dag_scheduling(void);
 
 // Testsuite 'SystemMisc'
 void SystemMisc_invalid_not_without_id(void);
@@ -340,6 +346,8 @@ void Stats_get_entity_count(void);
 void Stats_get_pipeline_stats_w_task_system(void);
 void Stats_get_not_alive_entity_count(void);
 void Stats_progress_stats_systems(void);
+void Stats_get_pipeline_stats_sync_wait_histogram(void);
+void Stats_get_system_stats_commands(void);
 
 // Testsuite 'Memory'
 void Memory_query_memory_no_cache(void);
@@ -352,6 +360,8 @@ void Memory_commands_memory(void);
 void Memory_table_memory_histogram(void);
 void Memory_sparse_component_memory(void);
 void Memory_sparse_tag_memory(void);
+void Memory_cold_component_memory(void);
+void Memory_table_memory_reclaimed(void);
 
 // Testsuite 'Run'
 void Run_setup(void);
@@ -413,6 +423,52 @@ void MultiThread_bulk_new_in_no_readonly_w_multithread(void);
 void MultiThread_bulk_new_in_no_readonly_w_multithread_2(void);
 void MultiThread_run_first_worker_on_main(void);
 void MultiThread_run_single_thread_on_main(void);
+void MultiThread_work_stealing_1000_entity(void);
+void MultiThread_work_stealing_many_small_tables(void);
+void MultiThread_work_stealing_steal_from_slow_worker(void);
+void MultiThread_work_stealing_w_run(void);
+void MultiThread_work_stealing_disable(void);
+void MultiThread_dag_independent_systems(void);
+void MultiThread_dag_dependent_systems(void);
+void MultiThread_dag_chain_of_systems(void);
+void MultiThread_dag_disable(void);
+void MultiThread_work_stealing_dependent_systems(void);
+void MultiThread_worker_spin_count(void);
+void MultiThread_sync_w_spin(void);
+void MultiThread_sync_w_spin_after_disable(void);
+void MultiThread_parallel_merge_set(void);
+void MultiThread_parallel_merge_observer_order(void);
+void MultiThread_parallel_merge_w_add(void);
+void MultiThread_parallel_merge_disable(void);
+void MultiThread_worker_affinity(void);
+void MultiThread_worker_affinity_run(void);
+void MultiThread_worker_affinity_running_threads(void);
+void MultiThread_worker_affinity_small_tables(void);
+void MultiThread_chunking_min_count(void);
+void MultiThread_chunking_chunk_size(void);
+void MultiThread_chunking_w_work_stealing(void);
+void MultiThread_chunking_update(void);
+void MultiThread_pipelined_frames(void);
+void MultiThread_pipelined_frames_run(void);
+void MultiThread_pipelined_frames_multithreaded(void);
+void MultiThread_pipelined_frames_disable(void);
+void MultiThread_pipelined_frames_new_entities(void);
+void MultiThread_pipelined_frames_not_double_buffered(void);
+void MultiThread_worker_min_cost(void);
+void MultiThread_worker_min_cost_all_threads(void);
+void MultiThread_worker_min_cost_single_thread(void);
+void MultiThread_worker_min_cost_dag(void);
+void MultiThread_worker_min_cost_disable(void);
+void MultiThread_task_threads_reuse_pool(void);
+void MultiThread_task_submit(void);
+void MultiThread_task_submit_from_system(void);
+void MultiThread_worker_cost_weight(void);
+void MultiThread_parallel_merge_w_delete(void);
+void MultiThread_task_pool_disabled(void);
+void MultiThread_task_pool_max_idle(void);
+void MultiThread_pipelined_frames_disable_w_custom_pipeline(void);
+void MultiThread_row_changes_w_multi_threaded_system(void);
+void MultiThread_worker_min_cost_surplus_workers_wait(void);
 
 // Testsuite 'MultiThreadStaging'
 void MultiThreadStaging_setup(void);
@@ -1021,6 +1077,30 @@ bake_test_case Pipeline_testcases[] = {
     {
         "update_pipeline_replaces_existing",
         Pipeline_update_pipeline_replaces_existing
+    },
+    {
+        "patch_disable_system",
+        Pipeline_patch_disable_system
+    },
+    {
+        "patch_activate_system",
+        Pipeline_patch_activate_system
+    },
+    {
+        "patch_add_system",
+        Pipeline_patch_add_system
+    },
+    {
+        "patch_disable_first_system",
+        Pipeline_patch_disable_first_system
+    },
+    {
+        "patch_multithreaded",
+        Pipeline_patch_multithreaded
+    },
+    {
+        "patch_dag_scheduling",
+        Pipeline_patch_dag_scheduling
     }
 };
 
@@ -1850,6 +1930,14 @@ bake_test_case Stats_testcases[] = {
     {
         "progress_stats_systems",
         Stats_progress_stats_systems
+    },
+    {
+        "get_pipeline_stats_sync_wait_histogram",
+        Stats_get_pipeline_stats_sync_wait_histogram
+    },
+    {
+        "get_system_stats_commands",
+        Stats_get_system_stats_commands
     }
 };
 
@@ -1893,6 +1981,14 @@ bake_test_case Memory_testcases[] = {
     {
         "sparse_tag_memory",
         Memory_sparse_tag_memory
+    },
+    {
+        "cold_component_memory",
+        Memory_cold_component_memory
+    },
+    {
+        "table_memory_reclaimed",
+        Memory_table_memory_reclaimed
     }
 };
 
@@ -2119,6 +2215,190 @@ bake_test_case MultiThread_testcases[] = {
     {
         "run_single_thread_on_main",
         MultiThread_run_single_thread_on_main
+    },
+    {
+        "work_stealing_1000_entity",
+        MultiThread_work_stealing_1000_entity
+    },
+    {
+        "work_stealing_many_small_tables",
+        MultiThread_work_stealing_many_small_tables
+    },
+    {
+        "work_stealing_steal_from_slow_worker",
+        MultiThread_work_stealing_steal_from_slow_worker
+    },
+    {
+        "work_stealing_w_run",
+        MultiThread_work_stealing_w_run
+    },
+    {
+        "work_stealing_disable",
+        MultiThread_work_stealing_disable
+    },
+    {
+        "dag_independent_systems",
+        MultiThread_dag_independent_systems
+    },
+    {
+        "dag_dependent_systems",
+        MultiThread_dag_dependent_systems
+    },
+    {
+        "dag_chain_of_systems",
+        MultiThread_dag_chain_of_systems
+    },
+    {
+        "dag_disable",
+        MultiThread_dag_disable
+    },
+    {
+        "work_stealing_dependent_systems",
+        MultiThread_work_stealing_dependent_systems
+    },
+    {
+        "worker_spin_count",
+        MultiThread_worker_spin_count
+    },
+    {
+        "sync_w_spin",
+        MultiThread_sync_w_spin
+    },
+    {
+        "sync_w_spin_after_disable",
+        MultiThread_sync_w_spin_after_disable
+    },
+    {
+        "parallel_merge_set",
+        MultiThread_parallel_merge_set
+    },
+    {
+        "parallel_merge_observer_order",
+        MultiThread_parallel_merge_observer_order
+    },
+    {
+        "parallel_merge_w_add",
+        MultiThread_parallel_merge_w_add
+    },
+    {
+        "parallel_merge_disable",
+        MultiThread_parallel_merge_disable
+    },
+    {
+        "worker_affinity",
+        MultiThread_worker_affinity
+    },
+    {
+        "worker_affinity_run",
+        MultiThread_worker_affinity_run
+    },
+    {
+        "worker_affinity_running_threads",
+        MultiThread_worker_affinity_running_threads
+    },
+    {
+        "worker_affinity_small_tables",
+        MultiThread_worker_affinity_small_tables
+    },
+    {
+        "chunking_min_count",
+        MultiThread_chunking_min_count
+    },
+    {
+        "chunking_chunk_size",
+        MultiThread_chunking_chunk_size
+    },
+    {
+        "chunking_w_work_stealing",
+        MultiThread_chunking_w_work_stealing
+    },
+    {
+        "chunking_update",
+        MultiThread_chunking_update
+    },
+    {
+        "pipelined_frames",
+        MultiThread_pipelined_frames
+    },
+    {
+        "pipelined_frames_run",
+        MultiThread_pipelined_frames_run
+    },
+    {
+        "pipelined_frames_multithreaded",
+        MultiThread_pipelined_frames_multithreaded
+    },
+    {
+        "pipelined_frames_disable",
+        MultiThread_pipelined_frames_disable
+    },
+    {
+        "pipelined_frames_new_entities",
+        MultiThread_pipelined_frames_new_entities
+    },
+    {
+        "pipelined_frames_not_double_buffered",
+        MultiThread_pipelined_frames_not_double_buffered
+    },
+    {
+        "worker_min_cost",
+        MultiThread_worker_min_cost
+    },
+    {
+        "worker_min_cost_all_threads",
+        MultiThread_worker_min_cost_all_threads
+    },
+    {
+        "worker_min_cost_single_thread",
+        MultiThread_worker_min_cost_single_thread
+    },
+    {
+        "worker_min_cost_dag",
+        MultiThread_worker_min_cost_dag
+    },
+    {
+        "worker_min_cost_disable",
+        MultiThread_worker_min_cost_disable
+    },
+    {
+        "task_threads_reuse_pool",
+        MultiThread_task_threads_reuse_pool
+    },
+    {
+        "task_submit",
+        MultiThread_task_submit
+    },
+    {
+        "task_submit_from_system",
+        MultiThread_task_submit_from_system
+    },
+    {
+        "worker_cost_weight",
+        MultiThread_worker_cost_weight
+    },
+    {
+        "parallel_merge_w_delete",
+        MultiThread_parallel_merge_w_delete
+    },
+    {
+        "task_pool_disabled",
+        MultiThread_task_pool_disabled
+    },
+    {
+        "task_pool_max_idle",
+        MultiThread_task_pool_max_idle
+    },
+    {
+        "pipelined_frames_disable_w_custom_pipeline",
+        MultiThread_pipelined_frames_disable_w_custom_pipeline
+    },
+    {
+        "row_changes_w_multi_threaded_system",
+        MultiThread_row_changes_w_multi_threaded_system
+    },
+    {
+        "worker_min_cost_surplus_workers_wait",
+        MultiThread_worker_min_cost_surplus_workers_wait
     }
 };
 
@@ -2821,7 +3101,7 @@ static bake_test_suite suites[] = {
         "Pipeline",
         NULL,
         NULL,
-        94,
+        100,
         Pipeline_testcases
     },
     {
@@ -2898,14 +3178,14 @@ static bake_test_suite suites[] = {
         "Stats",
         NULL,
         NULL,
-        12,
+        14,
         Stats_testcases
     },
     {
         "Memory",
         NULL,
         NULL,
-        10,
+        12,
         Memory_testcases
     },
     {
@@ -2919,7 +3199,7 @@ static bake_test_suite suites[] = {
         "MultiThread",
         MultiThread_setup,
         NULL,
-        50,
+        96,
         MultiThread_testcases,
         1,
         MultiThread_params
@@ -0,0 +1,152 @@
+/**
+ * @file bench/src/main.c
+ * @brief Query iteration benchmarks.
+ *
+ * Usage: bench [table_count] [entities_per_table] [iterations]
+ */
+
+#include <flecs.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define COMPONENT_COUNT (6)
+#define COMPONENT_SIZE (64)
+#define TAG_COUNT (10)
+
+typedef struct {
+    float value[COMPONENT_SIZE / sizeof(float)];
+} Payload;
+
+static ecs_entity_t components[COMPONENT_COUNT];
+
+static void populate(
+    ecs_world_t *world,
+    int32_t table_count,
+    int32_t entity_count)
+{
+    ecs_entity_t tags[TAG_COUNT];
+    int32_t i, t, e;
+
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        components[i] = ecs_component_init(world, &(ecs_component_desc_t){
+            .type.size = ECS_SIZEOF(Payload),
+            .type.alignment = ECS_ALIGNOF(Payload)
+        });
+    }
+
+    for (i = 0; i < TAG_COUNT; i ++) {
+        tags[i] = ecs_new(world);
+    }
+
+    /* Use combinations of tags to spread entities out over many tables */
+    for (t = 0; t < table_count; t ++) {
+        for (e = 0; e < entity_count; e ++) {
+            ecs_entity_t entity = ecs_new(world);
+            for (i = 0; i < TAG_COUNT; i ++) {
+                if (t & (1 << i)) {
+                    ecs_add_id(world, entity, tags[i]);
+                }
+            }
+
+            for (i = 0; i < COMPONENT_COUNT; i ++) {
+                Payload *p = ecs_ensure_id(
+                    world, entity, components[i], sizeof(Payload));
+                p->value[0] = (float)e;
+            }
+        }
+    }
+}
+
+static double run(
+    ecs_world_t *world,
+    ecs_flags32_t flags,
+    int32_t iterations,
+    int32_t *entity_count,
+    float *sum_out)
+{
+    ecs_query_desc_t desc = {
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = flags
+    };
+
+    int32_t i;
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        desc.terms[i].id = components[i];
+        desc.terms[i].inout = EcsIn;
+    }
+
+    ecs_query_t *q = ecs_query_init(world, &desc);
+    float sum = 0;
+    int32_t count = 0;
+
+    /* Warm up */
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        count += it.count;
+    }
+
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+
+    int32_t n;
+    for (n = 0; n < iterations; n ++) {
+        it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            const Payload *p[COMPONENT_COUNT];
+            for (i = 0; i < COMPONENT_COUNT; i ++) {
+                p[i] = ecs_field_w_size(&it, sizeof(Payload), (int8_t)i);
+            }
+
+            int32_t e;
+            for (e = 0; e < it.count; e ++) {
+                for (i = 0; i < COMPONENT_COUNT; i ++) {
+                    sum += p[i][e].value[0];
+                }
+            }
+        }
+    }
+
+    double elapsed = ecs_time_measure(&t);
+
+    ecs_query_fini(q);
+
+    *entity_count = count;
+    *sum_out = sum;
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    int32_t table_count = argc > 1 ? atoi(argv[1]) : 1024;
+    int32_t entity_count = argc > 2 ? atoi(argv[2]) : 64;
+    int32_t iterations = argc > 3 ? atoi(argv[3]) : 100;
+
+    if (table_count > (1 << TAG_COUNT)) {
+        table_count = 1 << TAG_COUNT;
+    }
+
+    ecs_world_t *world = ecs_mini();
+
+    populate(world, table_count, entity_count);
+
+    printf("%d tables, %d entities per table, %d components of %d bytes\n",
+        table_count, entity_count, COMPONENT_COUNT, COMPONENT_SIZE);
+
+    int32_t count;
+    float sum_default, sum_prefetch;
+    double t_default = run(world, 0, iterations, &count, &sum_default);
+    double t_prefetch = run(
+        world, EcsQueryPrefetch, iterations, &count, &sum_prefetch);
+
+    if (sum_default != sum_prefetch) {
+        printf("error: results don't match\n");
+        return -1;
+    }
+
+    double per_entity = 1000.0 * 1000.0 * 1000.0 / 
+        ((double)count * (double)iterations);
+
+    printf("  default:  %.3f ns/entity\n", t_default * per_entity);
+    printf("  prefetch: %.3f ns/entity\n", t_prefetch * per_entity);
+
+    return ecs_fini(world);
+}
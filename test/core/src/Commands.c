@@ -5713,3 +5713,1048 @@ void Commands_defer_remove_dont_fragment_on_cascade_deleted_child(void) {
 
     ecs_fini(world);
 }
+
+void Commands_defer_add_batched_for_query(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e[8];
+    for (int i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i * 2}));
+    }
+
+    ecs_query_t *q = ecs_query(world, { .terms = {{ ecs_id(Position) }} });
+
+    int64_t batched = ecs_get_world_info(world)->cmd.batched_entity_count;
+
+    ecs_defer_begin(world);
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            ecs_add(world, it.entities[i], TagA);
+        }
+    }
+    ecs_defer_end(world);
+
+    test_int(ecs_get_world_info(world)->cmd.batched_entity_count - batched, 8);
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+    test_int(ecs_table_count(table), 8);
+
+    for (int i = 0; i < 8; i ++) {
+        test_assert(ecs_get_table(world, e[i]) == table);
+        test_assert(ecs_has(world, e[i], TagA));
+        test_assert(ecs_table_entities(table)[i] == e[i]);
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Commands_defer_remove_batched_for_query(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e[8];
+    for (int i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, 
+            ecs_value(Position, {i, i * 2}), ecs_value(Velocity, {i, 1}));
+    }
+
+    ecs_query_t *q = ecs_query(world, { .terms = {{ ecs_id(Velocity) }} });
+
+    ecs_defer_begin(world);
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            ecs_remove(world, it.entities[i], Velocity);
+        }
+    }
+    ecs_defer_end(world);
+
+    for (int i = 0; i < 8; i ++) {
+        test_assert(!ecs_has(world, e[i], Velocity));
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Commands_defer_add_batched_partial_range(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e[8];
+    for (int i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i * 2}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_defer_begin(world);
+    for (int i = 2; i < 5; i ++) {
+        ecs_add(world, e[i], TagA);
+    }
+    ecs_defer_end(world);
+
+    /* Same order as deleting rows from the table one by one */
+    test_int(ecs_table_count(table), 5);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    test_assert(entities[0] == e[0]);
+    test_assert(entities[1] == e[1]);
+    test_assert(entities[2] == e[7]);
+    test_assert(entities[3] == e[6]);
+    test_assert(entities[4] == e[5]);
+
+    for (int i = 0; i < 8; i ++) {
+        test_bool(ecs_has(world, e[i], TagA), i >= 2 && i < 5);
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_defer_add_batched_w_hooks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, VectorComponent);
+    ECS_TAG(world, TagA);
+
+    ecs_set_hooks(world, VectorComponent, {
+        .ctor = ecs_ctor(VectorComponent),
+        .dtor = ecs_dtor(VectorComponent),
+        .move = ecs_move(VectorComponent),
+        .copy = ecs_copy(VectorComponent)
+    });
+
+    ecs_entity_t e[6];
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_new(world);
+        VectorComponent *v = ecs_ensure(world, e[i], VectorComponent);
+        ecs_vec_append_t(NULL, &v->values, int32_t)[0] = i;
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 1; i < 4; i ++) {
+        ecs_add(world, e[i], TagA);
+    }
+    ecs_defer_end(world);
+
+    for (int i = 0; i < 6; i ++) {
+        test_bool(ecs_has(world, e[i], TagA), i >= 1 && i < 4);
+        const VectorComponent *v = ecs_get(world, e[i], VectorComponent);
+        test_assert(v != NULL);
+        test_int(ecs_vec_count(&v->values), 1);
+        test_int(ecs_vec_first_t(&v->values, int32_t)[0], i);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_defer_add_batched_w_toggle(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+    ecs_add_id(world, ecs_id(Position), EcsCanToggle);
+
+    ecs_entity_t e[6];
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+        ecs_enable_component(world, e[i], Position, i % 2);
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 3; i ++) {
+        ecs_add(world, e[i], TagA);
+    }
+    ecs_defer_end(world);
+
+    for (int i = 0; i < 6; i ++) {
+        test_bool(ecs_has(world, e[i], TagA), i < 3);
+        test_bool(ecs_is_enabled(world, e[i], Position), i % 2);
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+    }
+
+    ecs_fini(world);
+}
+
+static int batched_on_add_count = 0;
+
+static void BatchedOnAdd(ecs_iter_t *it) {
+    for (int i = 0; i < it->count; i ++) {
+        test_assert(ecs_has_id(it->world, it->entities[i], it->event_id));
+    }
+    batched_on_add_count += it->count;
+}
+
+void Commands_defer_add_batched_w_observer(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Velocity) }},
+        .events = { EcsOnAdd },
+        .callback = BatchedOnAdd
+    });
+
+    ecs_entity_t e[5];
+    for (int i = 0; i < 5; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 5; i ++) {
+        ecs_add(world, e[i], Velocity);
+    }
+    ecs_defer_end(world);
+
+    test_int(batched_on_add_count, 5);
+
+    for (int i = 0; i < 5; i ++) {
+        test_assert(ecs_has(world, e[i], Velocity));
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_defer_set_many_inline(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e[1000];
+    for (int i = 0; i < 1000; i ++) {
+        e[i] = ecs_new(world);
+    }
+
+    /* Grow the command queue while it contains inline values */
+    ecs_defer_begin(world);
+    for (int i = 0; i < 1000; i ++) {
+        ecs_set(world, e[i], Position, {i, i * 2});
+        if (i % 2) {
+            ecs_set(world, e[i], Velocity, {i * 3, i * 4});
+        }
+    }
+    ecs_defer_end(world);
+
+    for (int i = 0; i < 1000; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+
+        const Velocity *v = ecs_get(world, e[i], Velocity);
+        if (i % 2) {
+            test_assert(v != NULL);
+            test_int(v->x, i * 3);
+            test_int(v->y, i * 4);
+        } else {
+            test_assert(v == NULL);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_defer_set_inline_w_ensure(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e, Position, {10, 20});
+    Position *p = ecs_ensure(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    /* Pointer returned by ensure must remain valid while queue grows */
+    for (int i = 0; i < 1000; i ++) {
+        ecs_add(world, ecs_new(world), Tag);
+    }
+
+    p->x = 30;
+    p->y = 40;
+    ecs_defer_end(world);
+
+    const Position *ptr = ecs_get(world, e, Position);
+    test_assert(ptr != NULL);
+    test_int(ptr->x, 30);
+    test_int(ptr->y, 40);
+
+    ecs_fini(world);
+}
+
+typedef struct LargeValue {
+    int32_t values[32];
+} LargeValue;
+
+void Commands_defer_set_large_value(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, LargeValue);
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world);
+
+    LargeValue v;
+    for (int i = 0; i < 32; i ++) {
+        v.values[i] = i;
+    }
+
+    ecs_defer_begin(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set_ptr(world, e, LargeValue, &v);
+    ecs_defer_end(world);
+
+    const LargeValue *ptr = ecs_get(world, e, LargeValue);
+    test_assert(ptr != NULL);
+    for (int i = 0; i < 32; i ++) {
+        test_int(ptr->values[i], i);
+    }
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
+
+void Commands_defer_set_inline_w_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e1 = ecs_new(world);
+    ecs_entity_t e2 = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e1, Position, {10, 20});
+    ecs_delete(world, e1);
+    ecs_set(world, e2, Position, {30, 40});
+    ecs_defer_end(world);
+
+    test_assert(!ecs_is_alive(world, e1));
+
+    const Position *p = ecs_get(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void Commands_defer_set_inline_w_observer(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = System,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e[10];
+    for (int i = 0; i < 10; i ++) {
+        e[i] = ecs_new(world);
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 10; i ++) {
+        ecs_set(world, e[i], Position, {i, i});
+    }
+    ecs_defer_end(world);
+
+    test_int(ctx.count, 10);
+
+    for (int i = 0; i < 10; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_coalesce_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_coalesced_merge(world, true);
+    test_bool(ecs_using_coalesced_merge(world), true);
+
+    Probe on_add = {0};
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd },
+        .callback = System,
+        .ctx = &on_add
+    });
+
+    Probe on_set = {0};
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }},
+        .events = { EcsOnSet },
+        .callback = System,
+        .ctx = &on_set
+    });
+
+    ecs_entity_t e[10];
+    for (int i = 0; i < 10; i ++) {
+        e[i] = ecs_new(world);
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 10; i ++) {
+        ecs_set(world, e[i], Position, {i, i * 2});
+        ecs_set(world, e[i], Velocity, {i * 3, i * 4});
+    }
+    ecs_defer_end(world);
+
+    /* OnAdd observer is invoked once for the entire group */
+    test_int(on_add.invoked, 1);
+    test_int(on_add.count, 10);
+    test_int(on_set.count, 20);
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+    test_int(ecs_table_count(table), 10);
+
+    for (int i = 0; i < 10; i ++) {
+        test_assert(ecs_get_table(world, e[i]) == table);
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+        const Velocity *v = ecs_get(world, e[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, i * 3);
+        test_int(v->y, i * 4);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_coalesce_non_contiguous(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_set_coalesced_merge(world, true);
+
+    ecs_entity_t e[10];
+    for (int i = 0; i < 10; i ++) {
+        e[i] = ecs_new_w(world, TagA);
+        ecs_set(world, e[i], Position, {i, i});
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 10; i += 2) {
+        ecs_remove(world, e[i], TagA);
+        ecs_add(world, e[i], TagB);
+    }
+    ecs_defer_end(world);
+
+    for (int i = 0; i < 10; i ++) {
+        if (i % 2) {
+            test_assert(ecs_has(world, e[i], TagA));
+            test_assert(!ecs_has(world, e[i], TagB));
+        } else {
+            test_assert(!ecs_has(world, e[i], TagA));
+            test_assert(ecs_has(world, e[i], TagB));
+        }
+
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i);
+    }
+
+    test_int(ecs_table_count(ecs_get_table(world, e[0])), 5);
+    test_int(ecs_table_count(ecs_get_table(world, e[1])), 5);
+
+    ecs_fini(world);
+}
+
+void Commands_coalesce_multiple_groups(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+
+    ecs_set_coalesced_merge(world, true);
+
+    Probe ctx = {0};
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd },
+        .callback = System,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e[12];
+    for (int i = 0; i < 12; i ++) {
+        e[i] = ecs_new(world);
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 12; i ++) {
+        ecs_set(world, e[i], Position, {i, i});
+        if (i % 3 == 1) {
+            ecs_set(world, e[i], Velocity, {i, i});
+        } else if (i % 3 == 2) {
+            ecs_add(world, e[i], Tag);
+        }
+    }
+    ecs_defer_end(world);
+
+    test_int(ctx.invoked, 3);
+    test_int(ctx.count, 12);
+
+    for (int i = 0; i < 12; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i);
+        test_bool(ecs_has(world, e[i], Velocity), i % 3 == 1);
+        test_bool(ecs_has(world, e[i], Tag), i % 3 == 2);
+        if (i % 3 == 1) {
+            const Velocity *v = ecs_get(world, e[i], Velocity);
+            test_int(v->x, i);
+            test_int(v->y, i);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_coalesce_w_stable_order(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+    ecs_set_coalesced_merge(world, true);
+
+    ecs_entity_t e[10];
+    for (int i = 0; i < 10; i ++) {
+        e[i] = ecs_new_w(world, TagA);
+        ecs_set(world, e[i], Position, {i, i});
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 10; i += 3) {
+        ecs_remove(world, e[i], TagA);
+        ecs_add(world, e[i], TagB);
+    }
+    ecs_defer_end(world);
+
+    ecs_table_t *table = ecs_get_table(world, e[1]);
+    test_int(ecs_table_count(table), 6);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    test_uint(entities[0], e[1]);
+    test_uint(entities[1], e[2]);
+    test_uint(entities[2], e[4]);
+    test_uint(entities[3], e[5]);
+    test_uint(entities[4], e[7]);
+    test_uint(entities[5], e[8]);
+
+    for (int i = 0; i < 10; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_coalesce_w_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_coalesced_merge(world, true);
+
+    ecs_entity_t e[10];
+    for (int i = 0; i < 10; i ++) {
+        e[i] = ecs_new(world);
+    }
+
+    ecs_defer_begin(world);
+    for (int i = 0; i < 10; i ++) {
+        ecs_set(world, e[i], Position, {i, i});
+    }
+    ecs_delete(world, e[3]);
+    ecs_set(world, e[5], Position, {50, 50});
+    ecs_defer_end(world);
+
+    test_assert(!ecs_is_alive(world, e[3]));
+
+    for (int i = 0; i < 10; i ++) {
+        if (i == 3) {
+            continue;
+        }
+
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        if (i == 5) {
+            test_int(p->x, 50);
+            test_int(p->y, 50);
+        } else {
+            test_int(p->x, i);
+            test_int(p->y, i);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_async_add(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_async_add(world, e, Position);
+    ecs_async_add(world, e, Tag);
+    test_assert(!ecs_has(world, e, Position));
+    test_assert(!ecs_has(world, e, Tag));
+
+    ecs_readonly_begin(world, false);
+    ecs_readonly_end(world);
+
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Tag));
+
+    ecs_fini(world);
+}
+
+void Commands_async_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e = ecs_new_w(world, Tag);
+    ecs_add(world, e, Position);
+
+    ecs_async_remove(world, e, Position);
+    test_assert(ecs_has(world, e, Position));
+
+    ecs_frame_begin(world, 1);
+    ecs_frame_end(world);
+
+    test_assert(!ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Tag));
+
+    ecs_fini(world);
+}
+
+void Commands_async_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, LargeValue);
+
+    ecs_entity_t e = ecs_new(world);
+
+    LargeValue v;
+    for (int i = 0; i < 32; i ++) {
+        v.values[i] = i;
+    }
+
+    ecs_async_set(world, e, Position, {10, 20});
+    ecs_async_set_id(world, e, ecs_id(LargeValue), sizeof(LargeValue), &v);
+    test_assert(!ecs_has(world, e, Position));
+
+    ecs_frame_begin(world, 1);
+    ecs_frame_end(world);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    const LargeValue *lv = ecs_get(world, e, LargeValue);
+    test_assert(lv != NULL);
+    for (int i = 0; i < 32; i ++) {
+        test_int(lv->values[i], i);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_async_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e1 = ecs_new(world);
+    ecs_entity_t e2 = ecs_new(world);
+
+    ecs_async_delete(world, e1);
+    ecs_async_set(world, e1, Position, {10, 20});
+    ecs_async_set(world, e2, Position, {30, 40});
+
+    ecs_frame_begin(world, 1);
+    ecs_frame_end(world);
+
+    test_assert(!ecs_is_alive(world, e1));
+
+    const Position *p = ecs_get(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void Commands_async_enqueue(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Evt);
+
+    Probe ctx = {0};
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { Evt },
+        .callback = System,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_async_enqueue(world, &(ecs_event_desc_t){
+        .event = Evt,
+        .ids = &(ecs_type_t){ (ecs_id_t[]){ ecs_id(Position) }, 1 },
+        .entity = e
+    });
+
+    test_int(ctx.invoked, 0);
+
+    ecs_frame_begin(world, 1);
+    ecs_frame_end(world);
+
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e);
+
+    ecs_fini(world);
+}
+
+#define ASYNC_THREAD_COUNT (4)
+#define ASYNC_ENTITY_COUNT (1000)
+
+typedef struct async_thread_ctx_t {
+    ecs_world_t *world;
+    ecs_entity_t *entities;
+    ecs_entity_t component;
+    int32_t index;
+} async_thread_ctx_t;
+
+static void* async_set_thread(void *arg) {
+    async_thread_ctx_t *ctx = arg;
+    for (int i = 0; i < ASYNC_ENTITY_COUNT; i ++) {
+        Position p = { ctx->index, i };
+        ecs_async_set_id(ctx->world, ctx->entities[i], ctx->component, 
+            sizeof(Position), &p);
+    }
+    return NULL;
+}
+
+void Commands_async_multi_thread(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t *entities[ASYNC_THREAD_COUNT];
+    async_thread_ctx_t ctx[ASYNC_THREAD_COUNT];
+    ecs_os_thread_t threads[ASYNC_THREAD_COUNT];
+
+    for (int t = 0; t < ASYNC_THREAD_COUNT; t ++) {
+        entities[t] = ecs_os_malloc_n(ecs_entity_t, ASYNC_ENTITY_COUNT);
+        for (int i = 0; i < ASYNC_ENTITY_COUNT; i ++) {
+            entities[t][i] = ecs_new(world);
+        }
+        ctx[t] = (async_thread_ctx_t){ 
+            world, entities[t], ecs_id(Position), t };
+    }
+
+    for (int t = 0; t < ASYNC_THREAD_COUNT; t ++) {
+        threads[t] = ecs_os_thread_new(async_set_thread, &ctx[t]);
+    }
+
+    /* Merge while threads are still enqueueing */
+    for (int i = 0; i < 10; i ++) {
+        ecs_frame_begin(world, 1);
+        ecs_frame_end(world);
+    }
+
+    for (int t = 0; t < ASYNC_THREAD_COUNT; t ++) {
+        ecs_os_thread_join(threads[t]);
+    }
+
+    ecs_frame_begin(world, 1);
+    ecs_frame_end(world);
+
+    for (int t = 0; t < ASYNC_THREAD_COUNT; t ++) {
+        for (int i = 0; i < ASYNC_ENTITY_COUNT; i ++) {
+            const Position *p = ecs_get(world, entities[t][i], Position);
+            test_assert(p != NULL);
+            test_int(p->x, t);
+            test_int(p->y, i);
+        }
+        ecs_os_free(entities[t]);
+    }
+
+    ecs_fini(world);
+}
+
+void Commands_async_fini_w_pending(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, LargeValue);
+
+    ecs_entity_t e = ecs_new(world);
+
+    LargeValue v = {0};
+    for (int i = 0; i < 1000; i ++) {
+        ecs_async_set_id(world, e, ecs_id(LargeValue), sizeof(LargeValue), &v);
+    }
+
+    /* Pending commands are discarded */
+    ecs_fini(world);
+
+    test_assert(true);
+}
+
+static int set_hook_ctor_invoked = 0;
+static int set_hook_move_invoked = 0;
+static int set_hook_move_ctor_invoked = 0;
+static int set_hook_dtor_invoked = 0;
+
+static void set_hook_ctor(void *ptr, int32_t count, const ecs_type_info_t *ti) {
+    set_hook_ctor_invoked += count;
+    ecs_os_memset(ptr, 0, count * ti->size);
+}
+
+static void set_hook_dtor(void *ptr, int32_t count, const ecs_type_info_t *ti) {
+    set_hook_dtor_invoked += count;
+}
+
+static void set_hook_move(void *dst, void *src, int32_t count, const ecs_type_info_t *ti) {
+    set_hook_move_invoked += count;
+    ecs_os_memcpy(dst, src, count * ti->size);
+}
+
+static void set_hook_move_ctor(void *dst, void *src, int32_t count, const ecs_type_info_t *ti) {
+    set_hook_move_ctor_invoked += count;
+    ecs_os_memcpy(dst, src, count * ti->size);
+}
+
+void Commands_defer_set_move_into_storage(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_set_hooks(world, Position, {
+        .ctor = set_hook_ctor,
+        .dtor = set_hook_dtor,
+        .move = set_hook_move,
+        .move_ctor = set_hook_move_ctor
+    });
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_add(world, e, Foo);
+    ecs_set(world, e, Position, {10, 20});
+    test_assert(!ecs_has(world, e, Position));
+    ecs_defer_end(world);
+
+    test_assert(ecs_has(world, e, Foo));
+    test_assert(ecs_has(world, e, Position));
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    /* Value is moved from the command into the component storage, which isn't
+     * constructed first. */
+    test_int(set_hook_ctor_invoked, 0);
+    test_int(set_hook_move_invoked, 0);
+    test_int(set_hook_move_ctor_invoked, 1);
+    test_int(set_hook_dtor_invoked, 1);
+
+    ecs_fini(world);
+}
+
+void Commands_defer_set_move_into_storage_w_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_hooks(world, Position, {
+        .ctor = set_hook_ctor,
+        .dtor = set_hook_dtor,
+        .move = set_hook_move,
+        .move_ctor = set_hook_move_ctor
+    });
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_remove(world, e, Position);
+    ecs_set(world, e, Position, {30, 40});
+    ecs_defer_end(world);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    test_int(set_hook_ctor_invoked, 1);
+    test_int(set_hook_dtor_invoked, 2);
+
+    ecs_fini(world);
+}
+
+static int set_hook_on_add_value = -1;
+
+static void set_hook_ctor_42(void *ptr, int32_t count, const ecs_type_info_t *ti) {
+    Position *p = ptr;
+    set_hook_ctor_invoked += count;
+    for (int i = 0; i < count; i ++) {
+        p[i].x = 42;
+        p[i].y = 42;
+    }
+}
+
+static void set_hook_on_add(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    set_hook_on_add_value = (int)p[0].x;
+}
+
+void Commands_defer_set_move_into_storage_w_on_add(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_set_hooks(world, Position, {
+        .ctor = set_hook_ctor_42,
+        .move = set_hook_move,
+        .on_add = set_hook_on_add
+    });
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e, Position, {7, 8});
+    ecs_add(world, e, Foo);
+    ecs_defer_end(world);
+
+    /* The on_add hook must see a constructed value */
+    test_int(set_hook_on_add_value, 42);
+    test_int(set_hook_ctor_invoked, 1);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 7);
+    test_int(p->y, 8);
+
+    ecs_fini(world);
+}
+
+static int other_on_add_value = -1;
+static ecs_entity_t other_on_add_position = 0;
+
+static void other_on_add_read_position(ecs_iter_t *it) {
+    const Position *p = ecs_table_get_id(
+        it->world, it->table, other_on_add_position, it->offset);
+    test_assert(p != NULL);
+    other_on_add_value = (int)p[0].x;
+}
+
+void Commands_defer_set_move_into_storage_w_other_on_add(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_hooks(world, Position, {
+        .ctor = set_hook_ctor_42,
+        .move = set_hook_move
+    });
+
+    other_on_add_position = ecs_id(Position);
+    ecs_set_hooks(world, Velocity, {
+        .on_add = other_on_add_read_position
+    });
+
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_add(world, e, Velocity);
+    ecs_defer_end(world);
+
+    /* The on_add hook of Velocity must see a constructed Position */
+    test_int(other_on_add_value, 42);
+    test_int(set_hook_ctor_invoked, 1);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
@@ -1741,7 +1741,7 @@ void ComponentLifecycle_set_and_emplace_defer(void) {
 
     test_assert(ecs_has(world, e, Position));
     test_assert(ecs_has(world, e, Velocity));
-    test_int(ctor_position, 1);
+    test_int(ctor_position, 0); /* Set value is moved into storage */
     test_int(ctor_velocity, 0);
 
     const Position *pp = ecs_get(world, e, Position);
@@ -1835,7 +1835,7 @@ void ComponentLifecycle_set_and_emplace_w_with_defer(void) {
 
     test_assert(ecs_has(world, e, Position));
     test_assert(ecs_has(world, e, Velocity));
-    test_int(ctor_position, 1);
+    test_int(ctor_position, 0); /* Set value is moved into storage */
     test_int(ctor_velocity, 0);
 
     const Position *pp = ecs_get(world, e, Position);
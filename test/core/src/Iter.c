@@ -3157,3 +3157,312 @@ void Iter_rule_worker_iter_w_fini(void) {
 
     ecs_fini(world);
 }
+
+static int32_t worker_chunking_collect(
+    ecs_world_t *world,
+    ecs_query_t *q,
+    int32_t index,
+    int32_t count,
+    const ecs_worker_chunking_t *chunking,
+    ecs_entity_t *entities,
+    int32_t *result_count)
+{
+    int32_t entity_count = 0;
+    *result_count = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    ecs_iter_t wit = ecs_worker_iter_w_chunking(&it, index, count, chunking);
+    while (ecs_worker_next(&wit)) {
+        Self *ptr = ecs_field(&wit, Self, 0);
+        int i;
+        for (i = 0; i < wit.count; i ++) {
+            test_uint(ptr[i].value, wit.entities[i]);
+            entities[entity_count ++] = wit.entities[i];
+        }
+        (*result_count) ++;
+    }
+
+    return entity_count;
+}
+
+void Iter_worker_iter_w_chunking_min_count(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new(world); ecs_set(world, e3, Self, {e3});
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    /* Table has fewer entities than min_count, so one worker gets all */
+    ecs_worker_chunking_t chunking = { .min_count = 4 };
+    ecs_entity_t entities[2][3];
+    int32_t results[2];
+    int32_t count_0 = worker_chunking_collect(
+        world, q, 0, 2, &chunking, entities[0], &results[0]);
+    int32_t count_1 = worker_chunking_collect(
+        world, q, 1, 2, &chunking, entities[1], &results[1]);
+
+    test_int(count_0 + count_1, 3);
+    test_assert(count_0 == 0 || count_1 == 0);
+    test_int(results[0] + results[1], 1);
+
+    ecs_entity_t *all = count_0 ? entities[0] : entities[1];
+    test_uint(all[0], e1);
+    test_uint(all[1], e2);
+    test_uint(all[2], e3);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_w_chunking_chunk_size(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+
+    ecs_entity_t e[10];
+    int i;
+    for (i = 0; i < 10; i ++) {
+        e[i] = ecs_new(world); ecs_set(world, e[i], Self, {e[i]});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    /* Chunks of 3: [0..3), [3..6), [6..9), [9..10) */
+    ecs_worker_chunking_t chunking = { .chunk_size = 3 };
+    ecs_entity_t entities[2][10];
+    int32_t results[2];
+    int32_t count_0 = worker_chunking_collect(
+        world, q, 0, 2, &chunking, entities[0], &results[0]);
+    int32_t count_1 = worker_chunking_collect(
+        world, q, 1, 2, &chunking, entities[1], &results[1]);
+
+    test_int(count_0 + count_1, 10);
+    test_int(results[0], 2);
+    test_int(results[1], 2);
+
+    bool found[10] = {0};
+    int w;
+    for (w = 0; w < 2; w ++) {
+        int32_t count = w ? count_1 : count_0;
+        for (i = 0; i < count; i ++) {
+            int j;
+            for (j = 0; j < 10; j ++) {
+                if (entities[w][i] == e[j]) {
+                    test_bool(found[j], false);
+                    found[j] = true;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < 10; i ++) {
+        test_bool(found[i], true);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_w_chunking_stable(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_entity_t e = ecs_new(world); ecs_set(world, e, Self, {e});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    ecs_worker_chunking_t chunking = { .min_count = 8, .chunk_size = 16 };
+    ecs_entity_t first[100], second[100];
+    int32_t results_first, results_second;
+    int32_t count_first = worker_chunking_collect(
+        world, q, 1, 4, &chunking, first, &results_first);
+    int32_t count_second = worker_chunking_collect(
+        world, q, 1, 4, &chunking, second, &results_second);
+
+    test_int(count_first, count_second);
+    test_int(results_first, results_second);
+    test_assert(results_first != 0);
+    for (i = 0; i < count_first; i ++) {
+        test_uint(first[i], second[i]);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_field_alignment(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 64);
+
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(ecs_query_next(&it), true);
+    test_int(it.count, 10);
+    test_int(ecs_field_alignment(&it, 0), 64);
+    test_bool(ecs_query_next(&it), false);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_aligned(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 64);
+
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    /* Each worker slice must start at a multiple of 8 rows (64 / 8 bytes) */
+    int32_t total = 0, expect_offset = 0;
+    for (i = 0; i < 3; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        ecs_iter_t wit = ecs_worker_iter(&it, i, 3);
+        while (ecs_worker_next(&wit)) {
+            test_int(wit.offset, expect_offset);
+            test_int(wit.offset % 8, 0);
+            test_int(ecs_field_alignment(&wit, 0), 64);
+
+            Position *p = ecs_field(&wit, Position, 0);
+            int32_t j;
+            for (j = 0; j < wit.count; j ++) {
+                test_int(p[j].x, wit.offset + j);
+            }
+
+            expect_offset += wit.count;
+            total += wit.count;
+        }
+    }
+
+    test_int(total, 100);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_aligned_w_chunking(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 64);
+
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    /* Chunk size is rounded up to a multiple of 8 rows */
+    ecs_worker_chunking_t chunking = { .chunk_size = 5 };
+    int32_t total = 0;
+    for (i = 0; i < 2; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        ecs_iter_t wit = ecs_worker_iter_w_chunking(&it, i, 2, &chunking);
+        while (ecs_worker_next(&wit)) {
+            test_int(wit.offset % 8, 0);
+            test_int(ecs_field_alignment(&wit, 0), 64);
+            total += wit.count;
+        }
+    }
+
+    test_int(total, 100);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_w_chunking_cache_size(void) {
+    ecs_world_t *world = ecs_mini();
+
+    typedef struct Large {
+        char value[4096];
+    } Large;
+
+    ECS_COMPONENT(world, Self);
+    ECS_COMPONENT(world, Large);
+
+    ecs_entity_t e[64];
+    int i;
+    for (i = 0; i < 64; i ++) {
+        e[i] = ecs_new(world); ecs_set(world, e[i], Self, {e[i]});
+        ecs_add(world, e[i], Large);
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }, { ecs_id(Large) }}
+    });
+
+    /* Rows are 4104 bytes, so chunks of 7 rows fit in 32KB */
+    ecs_worker_chunking_t chunking = { .min_count = 1 };
+    ecs_entity_t entities[2][64];
+    int32_t results[2];
+    int32_t count_0 = worker_chunking_collect(
+        world, q, 0, 2, &chunking, entities[0], &results[0]);
+    int32_t count_1 = worker_chunking_collect(
+        world, q, 1, 2, &chunking, entities[1], &results[1]);
+
+    test_int(count_0 + count_1, 64);
+    test_int(results[0] + results[1], 10);
+    test_int(results[0], 5);
+    test_int(results[1], 5);
+
+    /* A disabled policy divides the table equally across workers */
+    chunking.disable = true;
+    count_0 = worker_chunking_collect(
+        world, q, 0, 2, &chunking, entities[0], &results[0]);
+    count_1 = worker_chunking_collect(
+        world, q, 1, 2, &chunking, entities[1], &results[1]);
+
+    test_int(count_0, 32);
+    test_int(count_1, 32);
+    test_int(results[0], 1);
+    test_int(results[1], 1);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
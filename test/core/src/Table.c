@@ -1062,3 +1062,1131 @@ void Table_empty_flag_on_delete_delete_children(void) {
 
     ecs_fini(world);
 }
+
+void Table_column_page_size(void) {
+    ecs_world_t *world = ecs_mini();
+
+    test_int(ecs_get_column_page_size(world), 0);
+    ecs_set_column_page_size(world, 4096);
+    test_int(ecs_get_column_page_size(world), 4096);
+    ecs_set_column_page_size(world, 0);
+    test_int(ecs_get_column_page_size(world), 0);
+
+    ecs_fini(world);
+}
+
+void Table_paged_column_grow(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_page_size(world, 4096);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+    ecs_table_t *table = ecs_get_table(world, e);
+    test_assert(table != NULL);
+
+    int32_t i;
+    for (i = 1; i < 1000; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    /* Column is larger than page size, address no longer changes */
+    Position *p = ecs_table_get_column(table, 0, 0);
+    test_assert(p != NULL);
+
+    for (i = 1000; i < 100000; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    test_int(ecs_table_count(table), 100000);
+    test_assert(p == ecs_table_get_column(table, 0, 0));
+
+    for (i = 0; i < 100000; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_paged_column_bulk_grow(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_page_size(world, 4096);
+
+    const ecs_entity_t *ids = ecs_bulk_new(world, Position, 1000);
+    test_assert(ids != NULL);
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    test_assert(table != NULL);
+
+    Position *p = ecs_table_get_column(table, 0, 0);
+    test_assert(p != NULL);
+
+    int32_t i;
+    for (i = 0; i < 1000; i ++) {
+        p[i].x = (float)i;
+        p[i].y = (float)i * 2;
+    }
+
+    ecs_bulk_new(world, Position, 100000);
+    test_int(ecs_table_count(table), 101000);
+    test_assert(p == ecs_table_get_column(table, 0, 0));
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+static int32_t paged_move_invoked = 0;
+
+static void paged_ctor_move_dtor(
+    void *dst,
+    void *src,
+    int32_t count,
+    const ecs_type_info_t *ti)
+{
+    paged_move_invoked += count;
+    ecs_os_memcpy(dst, src, ti->size * count);
+}
+
+void Table_paged_column_grow_w_move_hook(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_hooks(world, Position, {
+        .ctor = flecs_default_ctor,
+        .ctor_move_dtor = paged_ctor_move_dtor
+    });
+
+    ecs_set_column_page_size(world, 4096);
+
+    int32_t i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    /* Moving to paged storage moves the column once */
+    test_assert(paged_move_invoked != 0);
+    paged_move_invoked = 0;
+
+    for (i = 1000; i < 100000; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    test_int(paged_move_invoked, 0);
+
+    ecs_fini(world);
+}
+
+void Table_paged_column_shrink(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_page_size(world, 4096);
+
+    ecs_entity_t *ids = ecs_os_malloc_n(ecs_entity_t, 10000);
+    int32_t i;
+    for (i = 0; i < 10000; i ++) {
+        ids[i] = ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    test_assert(table != NULL);
+    Position *p = ecs_table_get_column(table, 0, 0);
+    test_assert(p != NULL);
+
+    for (i = 1000; i < 10000; i ++) {
+        ecs_delete(world, ids[i]);
+    }
+
+    ecs_shrink(world);
+    test_int(ecs_table_count(table), 1000);
+    test_int(ecs_table_size(table), 1000);
+
+    /* Shrinking a paged column releases memory without moving data */
+    test_assert(p == ecs_table_get_column(table, 0, 0));
+    for (i = 0; i < 1000; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    for (i = 0; i < 1000; i ++) {
+        ecs_delete(world, ids[i]);
+    }
+
+    ecs_shrink(world);
+
+    ecs_os_free(ids);
+
+    ecs_fini(world);
+}
+
+void Table_paged_column_merge(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_set_column_page_size(world, 4096);
+
+    ecs_entity_t *ids = ecs_os_malloc_n(ecs_entity_t, 10000);
+    int32_t i;
+    for (i = 0; i < 10000; i ++) {
+        ids[i] = ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+        if (i < 5000) {
+            ecs_add(world, ids[i], Foo);
+        }
+    }
+
+    ecs_table_t *table = ecs_get_table(world, ids[5000]);
+    test_assert(table != NULL);
+    test_int(ecs_table_count(table), 5000);
+
+    ecs_remove_all(world, Foo);
+
+    test_int(ecs_table_count(table), 10000);
+    for (i = 0; i < 10000; i ++) {
+        test_assert(ecs_get_table(world, ids[i]) == table);
+        const Position *p = ecs_get(world, ids[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_os_free(ids);
+
+    ecs_fini(world);
+}
+
+void Table_column_alignment(void) {
+    ecs_world_t *world = ecs_mini();
+
+    test_int(ecs_get_column_alignment(world), 0);
+    ecs_set_column_alignment(world, 64);
+    test_int(ecs_get_column_alignment(world), 64);
+    ecs_set_column_alignment(world, 0);
+    test_int(ecs_get_column_alignment(world), 0);
+
+    ecs_fini(world);
+}
+
+void Table_aligned_column_grow(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 64);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+    ecs_table_t *table = ecs_get_table(world, e);
+    test_assert(table != NULL);
+
+    int32_t i;
+    for (i = 1; i < 1000; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+
+        Position *p = ecs_table_get_column(table, 0, 0);
+        test_assert(p != NULL);
+        test_int((uintptr_t)p % 64, 0);
+    }
+
+    Position *p = ecs_table_get_column(table, 0, 0);
+    for (i = 0; i < 1000; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_aligned_column_shrink(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 128);
+
+    ecs_entity_t *ids = ecs_os_malloc_n(ecs_entity_t, 100);
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        ids[i] = ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    test_assert(table != NULL);
+
+    for (i = 10; i < 100; i ++) {
+        ecs_delete(world, ids[i]);
+    }
+
+    ecs_shrink(world);
+    test_int(ecs_table_size(table), 10);
+
+    Position *p = ecs_table_get_column(table, 0, 0);
+    test_assert(p != NULL);
+    test_int((uintptr_t)p % 128, 0);
+    for (i = 0; i < 10; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    ecs_os_free(ids);
+
+    ecs_fini(world);
+}
+
+void Table_aligned_column_component_alignment(void) {
+    ecs_world_t *world = ecs_mini();
+
+    /* Component alignment larger than what malloc guarantees */
+    ecs_entity_t c = ecs_component_init(world, &(ecs_component_desc_t){
+        .entity = ecs_entity(world, { .name = "Vec8" }),
+        .type.size = 32,
+        .type.alignment = 32
+    });
+    test_assert(c != 0);
+
+    ecs_entity_t e = 0;
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        e = ecs_new_w_id(world, c);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e);
+    test_assert(table != NULL);
+    void *ptr = ecs_table_get_column(table, 0, 0);
+    test_assert(ptr != NULL);
+    test_int((uintptr_t)ptr % 32, 0);
+
+    ecs_fini(world);
+}
+
+void Table_aligned_paged_column(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_alignment(world, 256);
+    ecs_set_column_page_size(world, 4096);
+
+    int32_t i;
+    ecs_entity_t e = 0;
+    for (i = 0; i < 10000; i ++) {
+        e = ecs_insert(world, ecs_value(Position, {(float)i, (float)i * 2}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e);
+    test_assert(table != NULL);
+    Position *p = ecs_table_get_column(table, 0, 0);
+    test_assert(p != NULL);
+    test_int((uintptr_t)p % 256, 0);
+
+    for (i = 0; i < 10000; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_cold_column(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+
+    ecs_entity_t e[100];
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        e[i] = ecs_insert(world, 
+            ecs_value(Position, {(float)i, (float)i * 2}),
+            ecs_value(Velocity, {(float)i * 3, (float)i * 4}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+    test_assert(table != NULL);
+    test_int(ecs_table_count(table), 100);
+
+    Velocity *v = ecs_table_get_id(world, table, ecs_id(Velocity), 0);
+    test_assert(v != NULL);
+    test_int((uintptr_t)v % ECS_ALIGNOF(Velocity), 0);
+
+    for (i = 0; i < 100; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+        test_int(v[i].x, i * 3);
+        test_int(v[i].y, i * 4);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_cold_column_move(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+
+    ecs_entity_t e[10];
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        e[i] = ecs_insert(world, 
+            ecs_value(Position, {(float)i, (float)i * 2}),
+            ecs_value(Velocity, {(float)i * 3, (float)i * 4}));
+    }
+
+    for (i = 0; i < 10; i += 2) {
+        ecs_add(world, e[i], Foo);
+    }
+
+    ecs_delete(world, e[3]);
+    ecs_remove(world, e[5], Velocity);
+
+    for (i = 0; i < 10; i ++) {
+        if (i == 3) {
+            test_assert(!ecs_is_alive(world, e[i]));
+            continue;
+        }
+
+        test_bool(ecs_has(world, e[i], Foo), !(i % 2));
+
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+
+        const Velocity *v = ecs_get(world, e[i], Velocity);
+        if (i == 5) {
+            test_assert(v == NULL);
+            continue;
+        }
+
+        test_assert(v != NULL);
+        test_int(v->x, i * 3);
+        test_int(v->y, i * 4);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_cold_column_merge(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+
+    ecs_entity_t e[10];
+    int32_t i;
+    for (i = 0; i < 10; i ++) {
+        e[i] = ecs_insert(world, 
+            ecs_value(Velocity, {(float)i * 3, (float)i * 4}));
+        ecs_add(world, e[i], Foo);
+    }
+
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Velocity, {1, 2}));
+
+    /* Merges table with Foo into table without Foo */
+    ecs_remove_all(world, Foo);
+
+    for (i = 0; i < 10; i ++) {
+        test_assert(!ecs_has(world, e[i], Foo));
+        const Velocity *v = ecs_get(world, e[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, i * 3);
+        test_int(v->y, i * 4);
+    }
+
+    const Velocity *v = ecs_get(world, e2, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_fini(world);
+}
+
+void Table_cold_column_page_size_alignment(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+    ecs_set_column_alignment(world, 256);
+    ecs_set_column_page_size(world, 4096);
+
+    int32_t i;
+    ecs_entity_t e = 0;
+    for (i = 0; i < 10000; i ++) {
+        e = ecs_insert(world, 
+            ecs_value(Position, {(float)i, (float)i * 2}),
+            ecs_value(Velocity, {(float)i * 3, (float)i * 4}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e);
+    Position *p = ecs_table_get_id(world, table, ecs_id(Position), 0);
+    Velocity *v = ecs_table_get_id(world, table, ecs_id(Velocity), 0);
+    test_assert(p != NULL);
+    test_assert(v != NULL);
+    test_int((uintptr_t)p % 256, 0);
+
+    for (i = 0; i < 10000; i ++) {
+        test_int(p[i].x, i);
+        test_int(v[i].x, i * 3);
+        test_int(v[i].y, i * 4);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_cold_column_compact(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+
+    /* Large cold column that is stored before the column of the next table */
+    ecs_entity_t e[20000];
+    int32_t i;
+    for (i = 0; i < 20000; i ++) {
+        e[i] = ecs_insert(world, 
+            ecs_value(Position, {(float)i, (float)i * 2}),
+            ecs_value(Velocity, {(float)i * 3, (float)i * 4}));
+    }
+
+    ecs_entity_t f[10];
+    for (i = 0; i < 10; i ++) {
+        f[i] = ecs_insert(world, ecs_value(Velocity, {(float)i, (float)i * 2}));
+        ecs_add(world, f[i], Foo);
+    }
+
+    ecs_ref_t ref = ecs_ref_init(world, f[0], Velocity);
+    const Velocity *v = ecs_ref_get(world, &ref, Velocity);
+    test_assert(v != NULL);
+    test_assert(v == ecs_get(world, f[0], Velocity));
+
+    for (i = 10; i < 20000; i ++) {
+        ecs_delete(world, e[i]);
+    }
+
+    /* Shrinks the large column, after which the column of the second table is
+     * moved to the space that was freed up. */
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .shrink_ratio = 0.5f
+    });
+
+    const Velocity *v_moved = ecs_ref_get(world, &ref, Velocity);
+    test_assert(v_moved != NULL);
+    test_assert(v_moved != v);
+    test_assert(v_moved == ecs_get(world, f[0], Velocity));
+
+    for (i = 0; i < 10; i ++) {
+        const Velocity *fv = ecs_get(world, f[i], Velocity);
+        test_assert(fv != NULL);
+        test_int(fv->x, i);
+        test_int(fv->y, i * 2);
+
+        const Position *p = ecs_get(world, e[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+
+        const Velocity *ev = ecs_get(world, e[i], Velocity);
+        test_assert(ev != NULL);
+        test_int(ev->x, i * 3);
+        test_int(ev->y, i * 4);
+    }
+
+    /* Columns keep growing after they have been moved */
+    for (i = 0; i < 1000; i ++) {
+        ecs_entity_t g = ecs_insert(world, 
+            ecs_value(Velocity, {(float)i, (float)i}));
+        ecs_add(world, g, Foo);
+    }
+
+    for (i = 0; i < 10; i ++) {
+        const Velocity *fv = ecs_get(world, f[i], Velocity);
+        test_assert(fv != NULL);
+        test_int(fv->x, i);
+        test_int(fv->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_cold_after_use(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_new_w(world, Velocity);
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(Velocity), EcsCold);
+}
+
+static void stable_order_test_positions(
+    ecs_world_t *world,
+    ecs_entity_t ecs_id(Position),
+    ecs_table_t *table,
+    const float *expect,
+    int32_t count)
+{
+    test_int(ecs_table_count(table), count);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    Position *p = ecs_table_get_id(world, table, ecs_id(Position), 0);
+    for (int32_t i = 0; i < count; i ++) {
+        test_int(p[i].x, expect[i]);
+        const Position *ptr = ecs_get(world, entities[i], Position);
+        test_assert(ptr == &p[i]);
+    }
+}
+
+void Table_stable_order_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+
+    ecs_entity_t e[6];
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_delete(world, e[1]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 2, 3, 4, 5}, 5);
+
+    ecs_delete(world, e[0]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){2, 3, 4, 5}, 4);
+
+    ecs_delete(world, e[5]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){2, 3, 4}, 3);
+
+    ecs_delete(world, e[3]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){2, 4}, 2);
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+
+    ecs_entity_t e[5];
+    for (int i = 0; i < 5; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+        ecs_add(world, e[i], Foo);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_remove(world, e[1], Foo);
+    ecs_remove(world, e[3], Foo);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 2, 4}, 3);
+
+    test_assert(ecs_get(world, e[1], Position)->x == 1);
+    test_assert(ecs_get(world, e[3], Position)->x == 3);
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_tag(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Sorted);
+
+    ecs_add_id(world, Sorted, EcsStableOrder);
+
+    ecs_entity_t e[5];
+    for (int i = 0; i < 5; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+        ecs_add(world, e[i], Sorted);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_delete(world, e[0]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){1, 2, 3, 4}, 4);
+
+    /* Table without the tag uses default storage */
+    ecs_table_t *unsorted = ecs_get_table(world, 
+        ecs_insert(world, ecs_value(Position, {10, 0})));
+    ecs_insert(world, ecs_value(Position, {11, 0}));
+    ecs_entity_t last = ecs_insert(world, ecs_value(Position, {12, 0}));
+    ecs_delete(world, ecs_table_entities(unsorted)[0]);
+    test_assert(ecs_table_entities(unsorted)[0] == last);
+
+    ecs_fini(world);
+}
+
+static int stable_order_live = 0;
+
+typedef struct {
+    int32_t *value;
+} StableOrderBox;
+
+static ECS_CTOR(StableOrderBox, ptr, {
+    ptr->value = NULL;
+})
+
+static ECS_DTOR(StableOrderBox, ptr, {
+    if (ptr->value) {
+        stable_order_live --;
+        ecs_os_free(ptr->value);
+    }
+})
+
+static ECS_MOVE(StableOrderBox, dst, src, {
+    if (dst->value) {
+        stable_order_live --;
+        ecs_os_free(dst->value);
+    }
+    dst->value = src->value;
+    src->value = NULL;
+})
+
+static ECS_COPY(StableOrderBox, dst, src, {
+    if (dst->value) {
+        stable_order_live --;
+        ecs_os_free(dst->value);
+    }
+    dst->value = NULL;
+    if (src->value) {
+        stable_order_live ++;
+        dst->value = ecs_os_malloc_t(int32_t);
+        *dst->value = *src->value;
+    }
+})
+
+static void stable_order_set_box(
+    ecs_world_t *world,
+    ecs_entity_t ecs_id(StableOrderBox),
+    ecs_entity_t e,
+    int32_t value)
+{
+    StableOrderBox *box = ecs_ensure(world, e, StableOrderBox);
+    box->value = ecs_os_malloc_t(int32_t);
+    *box->value = value;
+    stable_order_live ++;
+    ecs_modified(world, e, StableOrderBox);
+}
+
+void Table_stable_order_w_hooks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, StableOrderBox);
+    ECS_TAG(world, Foo);
+
+    ecs_set_hooks(world, StableOrderBox, {
+        .ctor = ecs_ctor(StableOrderBox),
+        .dtor = ecs_dtor(StableOrderBox),
+        .move = ecs_move(StableOrderBox),
+        .copy = ecs_copy(StableOrderBox)
+    });
+
+    ecs_add_id(world, ecs_id(StableOrderBox), EcsStableOrder);
+
+    ecs_entity_t e[6];
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_new(world);
+        stable_order_set_box(world, ecs_id(StableOrderBox), e[i], i);
+        ecs_add(world, e[i], Foo);
+    }
+
+    test_int(stable_order_live, 6);
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_delete(world, e[2]);
+    test_int(stable_order_live, 5);
+
+    ecs_remove(world, e[0], Foo);
+    test_int(stable_order_live, 5);
+
+    test_int(ecs_table_count(table), 4);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    test_uint(entities[0], e[1]);
+    test_uint(entities[1], e[3]);
+    test_uint(entities[2], e[4]);
+    test_uint(entities[3], e[5]);
+
+    StableOrderBox *boxes = ecs_table_get_id(
+        world, table, ecs_id(StableOrderBox), 0);
+    test_int(*boxes[0].value, 1);
+    test_int(*boxes[1].value, 3);
+    test_int(*boxes[2].value, 4);
+    test_int(*boxes[3].value, 5);
+
+    test_int(*ecs_get(world, e[0], StableOrderBox)->value, 0);
+
+    ecs_fini(world);
+
+    test_int(stable_order_live, 0);
+}
+
+void Table_stable_order_w_toggle(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+    ecs_add_id(world, Foo, EcsCanToggle);
+
+    ecs_entity_t e[5];
+    for (int i = 0; i < 5; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+        ecs_add(world, e[i], Foo);
+        ecs_enable_component(world, e[i], Foo, i % 2);
+    }
+
+    ecs_delete(world, e[1]);
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 2, 3, 4}, 4);
+
+    test_bool(ecs_is_enabled(world, e[0], Foo), false);
+    test_bool(ecs_is_enabled(world, e[2], Foo), false);
+    test_bool(ecs_is_enabled(world, e[3], Foo), true);
+    test_bool(ecs_is_enabled(world, e[4], Foo), false);
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_w_toggle_n_words(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+    ECS_TAG(world, Bar);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+    ecs_add_id(world, Foo, EcsCanToggle);
+
+    ecs_entity_t e[200];
+    for (int i = 0; i < 200; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+        ecs_add(world, e[i], Foo);
+        ecs_add(world, e[i], Bar);
+        ecs_enable_component(world, e[i], Foo, (i % 3) == 0);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_delete(world, e[5]);
+    ecs_delete(world, e[63]);
+    ecs_delete(world, e[64]);
+    ecs_delete(world, e[130]);
+
+    /* Batched remove moves a range of rows out of the table */
+    ecs_defer_begin(world);
+    for (int i = 70; i < 140; i ++) {
+        if (i != 130) {
+            ecs_remove(world, e[i], Bar);
+        }
+    }
+    ecs_defer_end(world);
+
+    test_int(ecs_table_count(table), 200 - 4 - 69);
+
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    int32_t row = 0;
+    for (int i = 0; i < 200; i ++) {
+        if (i == 5 || i == 63 || i == 64 || (i >= 70 && i < 140)) {
+            continue;
+        }
+        test_uint(entities[row], e[i]);
+        test_bool(ecs_is_enabled(world, e[i], Foo), (i % 3) == 0);
+        row ++;
+    }
+
+    for (int i = 70; i < 140; i ++) {
+        if (i != 130) {
+            test_bool(ecs_is_enabled(world, e[i], Foo), (i % 3) == 0);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_batched_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+
+    ecs_entity_t e[8];
+    for (int i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+        ecs_add(world, e[i], Foo);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_defer_begin(world);
+    ecs_remove(world, e[2], Foo);
+    ecs_remove(world, e[3], Foo);
+    ecs_remove(world, e[4], Foo);
+    ecs_defer_end(world);
+
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 1, 5, 6, 7}, 5);
+
+    ecs_table_t *dst = ecs_get_table(world, e[2]);
+    stable_order_test_positions(world, ecs_id(Position), dst, 
+        (float[]){2, 3, 4}, 3);
+
+    ecs_fini(world);
+}
+
+static int stable_order_compare(
+    ecs_entity_t e1,
+    const void *ptr1,
+    ecs_entity_t e2,
+    const void *ptr2)
+{
+    (void)e1; (void)e2;
+    const Position *p1 = ptr1, *p2 = ptr2;
+    return (p1->x > p2->x) - (p1->x < p2->x);
+}
+
+void Table_stable_order_w_order_by(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+
+    ecs_entity_t e[6];
+    float values[] = {5, 3, 1, 4, 0, 2};
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {values[i], 0}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }},
+        .order_by = ecs_id(Position),
+        .order_by_callback = stable_order_compare,
+        .cache_kind = EcsQueryCacheAuto
+    });
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) { }
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 1, 2, 3, 4, 5}, 6);
+
+    ecs_delete(world, e[2]); /* 1 */
+    ecs_delete(world, e[3]); /* 4 */
+
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){0, 2, 3, 5}, 4);
+
+    it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 4);
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p[0].x, 0);
+    test_int(p[1].x, 2);
+    test_int(p[2].x, 3);
+    test_int(p[3].x, 5);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_after_use(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_new_w(world, Position);
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+}
+
+void Table_stable_order_deferred_delete_w_append(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsStableOrder);
+
+    ecs_entity_t e[8];
+    for (int i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_defer_begin(world);
+    ecs_delete(world, e[1]);
+    ecs_delete(world, e[5]);
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 0}));
+    ecs_delete(world, e[0]);
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {11, 0}));
+    ecs_delete(world, e1);
+    ecs_defer_end(world);
+
+    test_assert(ecs_get_table(world, e2) == table);
+    stable_order_test_positions(world, ecs_id(Position), table, 
+        (float[]){2, 3, 4, 6, 7, 11}, 6);
+
+    ecs_fini(world);
+}
+
+void Table_stable_order_deferred_w_hooks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, StableOrderBox);
+    ECS_TAG(world, Foo);
+
+    ecs_set_hooks(world, StableOrderBox, {
+        .ctor = ecs_ctor(StableOrderBox),
+        .dtor = ecs_dtor(StableOrderBox),
+        .move = ecs_move(StableOrderBox),
+        .copy = ecs_copy(StableOrderBox)
+    });
+
+    ecs_add_id(world, ecs_id(StableOrderBox), EcsStableOrder);
+    ecs_add_id(world, Foo, EcsCanToggle);
+
+    ecs_entity_t e[6];
+    for (int i = 0; i < 6; i ++) {
+        e[i] = ecs_new(world);
+        stable_order_set_box(world, ecs_id(StableOrderBox), e[i], i);
+        ecs_add(world, e[i], Foo);
+        ecs_enable_component(world, e[i], Foo, i % 2);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_defer_begin(world);
+    ecs_delete(world, e[0]);
+    ecs_remove(world, e[2], Foo);
+    ecs_delete(world, e[3]);
+    ecs_defer_end(world);
+
+    test_int(stable_order_live, 4);
+
+    test_int(ecs_table_count(table), 3);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    test_uint(entities[0], e[1]);
+    test_uint(entities[1], e[4]);
+    test_uint(entities[2], e[5]);
+
+    StableOrderBox *boxes = ecs_table_get_id(
+        world, table, ecs_id(StableOrderBox), 0);
+    test_int(*boxes[0].value, 1);
+    test_int(*boxes[1].value, 4);
+    test_int(*boxes[2].value, 5);
+
+    test_bool(ecs_is_enabled(world, e[1], Foo), true);
+    test_bool(ecs_is_enabled(world, e[4], Foo), false);
+    test_bool(ecs_is_enabled(world, e[5], Foo), true);
+
+    test_int(*ecs_get(world, e[2], StableOrderBox)->value, 2);
+
+    ecs_fini(world);
+
+    test_int(stable_order_live, 0);
+}
+
+void Table_stable_order_illegal_ctor_move_dtor(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, StableOrderBox);
+
+    ecs_set_hooks(world, StableOrderBox, {
+        .ctor = ecs_ctor(StableOrderBox),
+        .dtor = ecs_dtor(StableOrderBox),
+        .move = ecs_move(StableOrderBox),
+        .copy = ecs_copy(StableOrderBox),
+        .flags = ECS_TYPE_HOOK_CTOR_MOVE_DTOR_ILLEGAL
+    });
+
+    ecs_add_id(world, ecs_id(StableOrderBox), EcsStableOrder);
+
+    /* Create all entities at once, as the table can't grow with values that
+     * can't be moved to new storage */
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = 5,
+        .ids = {ecs_id(StableOrderBox)}
+    });
+
+    ecs_entity_t e[5];
+    for (int i = 0; i < 5; i ++) {
+        e[i] = ids[i];
+        stable_order_set_box(world, ecs_id(StableOrderBox), e[i], i);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, e[0]);
+
+    ecs_delete(world, e[1]);
+    test_int(stable_order_live, 4);
+
+    ecs_defer_begin(world);
+    ecs_delete(world, e[0]);
+    ecs_delete(world, e[3]);
+    ecs_defer_end(world);
+    test_int(stable_order_live, 2);
+
+    test_int(ecs_table_count(table), 2);
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    test_uint(entities[0], e[2]);
+    test_uint(entities[1], e[4]);
+
+    StableOrderBox *boxes = ecs_table_get_id(
+        world, table, ecs_id(StableOrderBox), 0);
+    test_int(*boxes[0].value, 2);
+    test_int(*boxes[1].value, 4);
+
+    ecs_fini(world);
+
+    test_int(stable_order_live, 0);
+}
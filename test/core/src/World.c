@@ -4410,3 +4410,207 @@ void World_delete_empty_tables_return_value(void) {
 
     ecs_fini(world);
 }
+
+void World_delete_empty_tables_w_shrink_ratio(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[64];
+    for (int i = 0; i < 64; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    test_assert(table != NULL);
+    test_int(ecs_table_count(table), 64);
+    test_assert(ecs_table_size(table) >= 64);
+
+    for (int i = 4; i < 64; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    test_int(ecs_table_count(table), 4);
+    test_assert(ecs_table_size(table) >= 64);
+
+    /* Without a shrink ratio non-empty tables are left alone */
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    test_assert(ecs_table_size(table) >= 64);
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1,
+        .shrink_ratio = 0.25f
+    });
+    test_int(ecs_table_count(table), 4);
+    test_int(ecs_table_size(table), 4);
+
+    for (int i = 0; i < 4; i ++) {
+        test_assert(ecs_has(world, entities[i], Position));
+    }
+
+    ecs_fini(world);
+}
+
+void World_delete_empty_tables_w_shrink_ratio_above_count(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[64];
+    for (int i = 0; i < 64; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    int32_t size = ecs_table_size(table);
+
+    for (int i = 48; i < 64; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .shrink_ratio = 0.25f
+    });
+    test_int(ecs_table_count(table), 48);
+    test_int(ecs_table_size(table), size);
+
+    ecs_fini(world);
+}
+
+void World_delete_empty_tables_clear_prunes_edges(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_add(world, e, TagA);
+    ecs_table_t *table = ecs_get_table(world, e);
+    ecs_delete(world, e);
+    test_int(ecs_table_count(table), 0);
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .clear_generation = 1
+    });
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .clear_generation = 1
+    });
+    test_int(ecs_table_size(table), 0);
+
+    /* Table is reused after its edges were pruned */
+    e = ecs_new_w(world, Position);
+    ecs_add(world, e, TagA);
+    test_assert(ecs_get_table(world, e) == table);
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, TagA));
+
+    ecs_remove(world, e, TagA);
+    test_assert(ecs_get_table(world, e) != table);
+    test_assert(!ecs_has(world, e, TagA));
+    ecs_add(world, e, TagA);
+    test_assert(ecs_get_table(world, e) == table);
+
+    ecs_fini(world);
+}
+
+void World_table_compaction(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    ecs_entity_t e = ecs_new_w(world, TagA);
+    ecs_add(world, e, TagB);
+    ecs_delete(world, e);
+
+    int32_t table_count = info->table_count;
+
+    ecs_set_table_compaction(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+
+    ecs_frame_begin(world, 0);
+    ecs_frame_end(world);
+    test_int(info->table_count, table_count);
+
+    ecs_frame_begin(world, 0);
+    ecs_frame_end(world);
+    test_assert(info->table_count < table_count);
+
+    /* Tables are recreated when used again */
+    e = ecs_new_w(world, TagA);
+    ecs_add(world, e, TagB);
+    test_assert(ecs_has(world, e, TagA));
+    test_assert(ecs_has(world, e, TagB));
+
+    ecs_fini(world);
+}
+
+void World_table_compaction_w_time_budget(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, TagA);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    for (int i = 0; i < 200; i ++) {
+        ecs_entity_t e = ecs_new_w(world, TagA);
+        ecs_add_id(world, e, ecs_new(world));
+        ecs_delete(world, e);
+    }
+
+    int32_t table_count = info->table_count;
+
+    /* Budget is exceeded on each measurement, so each frame only does a small
+     * amount of work and resumes where the previous frame stopped. */
+    ecs_set_table_compaction(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1,
+        .time_budget_seconds = 0.000000001
+    });
+
+    ecs_frame_begin(world, 0);
+    ecs_frame_end(world);
+    test_assert(info->table_count > (table_count - 200));
+
+    for (int i = 0; i < 1000; i ++) {
+        ecs_frame_begin(world, 0);
+        ecs_frame_end(world);
+    }
+
+    test_assert(info->table_count <= (table_count - 200));
+
+    ecs_fini(world);
+}
+
+void World_table_compaction_disable(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    ecs_entity_t e = ecs_new_w(world, TagA);
+    ecs_add(world, e, TagB);
+    ecs_delete(world, e);
+
+    int32_t table_count = info->table_count;
+
+    ecs_set_table_compaction(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    ecs_set_table_compaction(world, NULL);
+
+    for (int i = 0; i < 3; i ++) {
+        ecs_frame_begin(world, 0);
+        ecs_frame_end(world);
+    }
+
+    test_int(info->table_count, table_count);
+
+    ecs_fini(world);
+}
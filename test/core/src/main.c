@@ -277,6 +277,13 @@ void Iter_page_iter_w_fini(void);
 void Iter_worker_iter_w_fini(void);
 void Iter_rule_page_iter_w_fini(void);
 void Iter_rule_worker_iter_w_fini(void);
+void Iter_worker_iter_w_chunking_min_count(void);
+void Iter_worker_iter_w_chunking_chunk_size(void);
+void Iter_worker_iter_w_chunking_stable(void);
+void Iter_field_alignment(void);
+void Iter_worker_iter_aligned(void);
+void Iter_worker_iter_aligned_w_chunking(void);
+void Iter_worker_iter_w_chunking_cache_size(void);
 
 // Testsuite 'Search'
 void Search_search(void);
@@ -2837,6 +2844,12 @@ void World_delete_empty_tables_w_offset(void);
 void World_delete_empty_tables_w_offset_out_of_range(void);
 void World_delete_empty_tables_w_offset_wrap_around(void);
 void World_delete_empty_tables_return_value(void);
+void World_delete_empty_tables_w_shrink_ratio(void);
+void World_delete_empty_tables_w_shrink_ratio_above_count(void);
+void World_delete_empty_tables_clear_prunes_edges(void);
+void World_table_compaction(void);
+void World_table_compaction_w_time_budget(void);
+void World_table_compaction_disable(void);
 
 // Testsuite 'ExclusiveAccess'
 void ExclusiveAccess_self(void);
@@ -3171,6 +3184,33 @@ void Commands_on_replace_w_set_batched_grow_table_in_hook(void);
 void Commands_defer_batched_add_after_delete(void);
 void Commands_defer_add_remove_childof_w_dont_fragment(void);
 void Commands_defer_remove_dont_fragment_on_cascade_deleted_child(void);
+void Commands_defer_add_batched_for_query(void);
+void Commands_defer_remove_batched_for_query(void);
+void Commands_defer_add_batched_partial_range(void);
+void Commands_defer_add_batched_w_hooks(void);
+void Commands_defer_add_batched_w_toggle(void);
+void Commands_defer_add_batched_w_observer(void);
+void Commands_defer_set_many_inline(void);
+void Commands_defer_set_inline_w_ensure(void);
+void Commands_defer_set_large_value(void);
+void Commands_defer_set_inline_w_delete(void);
+void Commands_defer_set_inline_w_observer(void);
+void Commands_coalesce_set(void);
+void Commands_coalesce_non_contiguous(void);
+void Commands_coalesce_multiple_groups(void);
+void Commands_coalesce_w_delete(void);
+void Commands_async_add(void);
+void Commands_async_remove(void);
+void Commands_async_set(void);
+void Commands_async_delete(void);
+void Commands_async_enqueue(void);
+void Commands_async_multi_thread(void);
+void Commands_async_fini_w_pending(void);
+void Commands_defer_set_move_into_storage(void);
+void Commands_defer_set_move_into_storage_w_remove(void);
+void Commands_defer_set_move_into_storage_w_on_add(void);
+void Commands_defer_set_move_into_storage_w_other_on_add(void);
+void Commands_coalesce_w_stable_order(void);
 
 // Testsuite 'SingleThreadStaging'
 void SingleThreadStaging_setup(void);
@@ -3300,6 +3340,35 @@ void Table_empty_flag_clear(void);
 void Table_empty_flag_bulk_init(void);
 void Table_empty_flag_table_clear(void);
 void Table_empty_flag_on_delete_delete_children(void);
+void Table_column_page_size(void);
+void Table_paged_column_grow(void);
+void Table_paged_column_bulk_grow(void);
+void Table_paged_column_grow_w_move_hook(void);
+void Table_paged_column_shrink(void);
+void Table_paged_column_merge(void);
+void Table_column_alignment(void);
+void Table_aligned_column_grow(void);
+void Table_aligned_column_shrink(void);
+void Table_aligned_column_component_alignment(void);
+void Table_aligned_paged_column(void);
+void Table_cold_column(void);
+void Table_cold_column_move(void);
+void Table_cold_column_merge(void);
+void Table_cold_column_page_size_alignment(void);
+void Table_cold_after_use(void);
+void Table_stable_order_delete(void);
+void Table_stable_order_remove(void);
+void Table_stable_order_tag(void);
+void Table_stable_order_w_hooks(void);
+void Table_stable_order_w_toggle(void);
+void Table_stable_order_batched_remove(void);
+void Table_stable_order_w_order_by(void);
+void Table_stable_order_after_use(void);
+void Table_stable_order_w_toggle_n_words(void);
+void Table_cold_column_compact(void);
+void Table_stable_order_deferred_delete_w_append(void);
+void Table_stable_order_deferred_w_hooks(void);
+void Table_stable_order_illegal_ctor_move_dtor(void);
 
 // Testsuite 'Poly'
 void Poly_on_set_poly_observer(void);
@@ -4431,6 +4500,34 @@ bake_test_case Iter_testcases[] = {
     {
         "rule_worker_iter_w_fini",
         Iter_rule_worker_iter_w_fini
+    },
+    {
+        "worker_iter_w_chunking_min_count",
+        Iter_worker_iter_w_chunking_min_count
+    },
+    {
+        "worker_iter_w_chunking_chunk_size",
+        Iter_worker_iter_w_chunking_chunk_size
+    },
+    {
+        "worker_iter_w_chunking_stable",
+        Iter_worker_iter_w_chunking_stable
+    },
+    {
+        "field_alignment",
+        Iter_field_alignment
+    },
+    {
+        "worker_iter_aligned",
+        Iter_worker_iter_aligned
+    },
+    {
+        "worker_iter_aligned_w_chunking",
+        Iter_worker_iter_aligned_w_chunking
+    },
+    {
+        "worker_iter_w_chunking_cache_size",
+        Iter_worker_iter_w_chunking_cache_size
     }
 };
 
@@ -14467,6 +14564,30 @@ bake_test_case World_testcases[] = {
     {
         "delete_empty_tables_return_value",
         World_delete_empty_tables_return_value
+    },
+    {
+        "delete_empty_tables_w_shrink_ratio",
+        World_delete_empty_tables_w_shrink_ratio
+    },
+    {
+        "delete_empty_tables_w_shrink_ratio_above_count",
+        World_delete_empty_tables_w_shrink_ratio_above_count
+    },
+    {
+        "delete_empty_tables_clear_prunes_edges",
+        World_delete_empty_tables_clear_prunes_edges
+    },
+    {
+        "table_compaction",
+        World_table_compaction
+    },
+    {
+        "table_compaction_w_time_budget",
+        World_table_compaction_w_time_budget
+    },
+    {
+        "table_compaction_disable",
+        World_table_compaction_disable
     }
 };
 
@@ -15779,6 +15900,114 @@ bake_test_case Commands_testcases[] = {
     {
         "defer_remove_dont_fragment_on_cascade_deleted_child",
         Commands_defer_remove_dont_fragment_on_cascade_deleted_child
+    },
+    {
+        "defer_add_batched_for_query",
+        Commands_defer_add_batched_for_query
+    },
+    {
+        "defer_remove_batched_for_query",
+        Commands_defer_remove_batched_for_query
+    },
+    {
+        "defer_add_batched_partial_range",
+        Commands_defer_add_batched_partial_range
+    },
+    {
+        "defer_add_batched_w_hooks",
+        Commands_defer_add_batched_w_hooks
+    },
+    {
+        "defer_add_batched_w_toggle",
+        Commands_defer_add_batched_w_toggle
+    },
+    {
+        "defer_add_batched_w_observer",
+        Commands_defer_add_batched_w_observer
+    },
+    {
+        "defer_set_many_inline",
+        Commands_defer_set_many_inline
+    },
+    {
+        "defer_set_inline_w_ensure",
+        Commands_defer_set_inline_w_ensure
+    },
+    {
+        "defer_set_large_value",
+        Commands_defer_set_large_value
+    },
+    {
+        "defer_set_inline_w_delete",
+        Commands_defer_set_inline_w_delete
+    },
+    {
+        "defer_set_inline_w_observer",
+        Commands_defer_set_inline_w_observer
+    },
+    {
+        "coalesce_set",
+        Commands_coalesce_set
+    },
+    {
+        "coalesce_non_contiguous",
+        Commands_coalesce_non_contiguous
+    },
+    {
+        "coalesce_multiple_groups",
+        Commands_coalesce_multiple_groups
+    },
+    {
+        "coalesce_w_delete",
+        Commands_coalesce_w_delete
+    },
+    {
+        "async_add",
+        Commands_async_add
+    },
+    {
+        "async_remove",
+        Commands_async_remove
+    },
+    {
+        "async_set",
+        Commands_async_set
+    },
+    {
+        "async_delete",
+        Commands_async_delete
+    },
+    {
+        "async_enqueue",
+        Commands_async_enqueue
+    },
+    {
+        "async_multi_thread",
+        Commands_async_multi_thread
+    },
+    {
+        "async_fini_w_pending",
+        Commands_async_fini_w_pending
+    },
+    {
+        "defer_set_move_into_storage",
+        Commands_defer_set_move_into_storage
+    },
+    {
+        "defer_set_move_into_storage_w_remove",
+        Commands_defer_set_move_into_storage_w_remove
+    },
+    {
+        "defer_set_move_into_storage_w_on_add",
+        Commands_defer_set_move_into_storage_w_on_add
+    },
+    {
+        "defer_set_move_into_storage_w_other_on_add",
+        Commands_defer_set_move_into_storage_w_other_on_add
+    },
+    {
+        "coalesce_w_stable_order",
+        Commands_coalesce_w_stable_order
     }
 };
 
@@ -16272,6 +16501,122 @@ bake_test_case Table_testcases[] = {
     {
         "empty_flag_on_delete_delete_children",
         Table_empty_flag_on_delete_delete_children
+    },
+    {
+        "column_page_size",
+        Table_column_page_size
+    },
+    {
+        "paged_column_grow",
+        Table_paged_column_grow
+    },
+    {
+        "paged_column_bulk_grow",
+        Table_paged_column_bulk_grow
+    },
+    {
+        "paged_column_grow_w_move_hook",
+        Table_paged_column_grow_w_move_hook
+    },
+    {
+        "paged_column_shrink",
+        Table_paged_column_shrink
+    },
+    {
+        "paged_column_merge",
+        Table_paged_column_merge
+    },
+    {
+        "column_alignment",
+        Table_column_alignment
+    },
+    {
+        "aligned_column_grow",
+        Table_aligned_column_grow
+    },
+    {
+        "aligned_column_shrink",
+        Table_aligned_column_shrink
+    },
+    {
+        "aligned_column_component_alignment",
+        Table_aligned_column_component_alignment
+    },
+    {
+        "aligned_paged_column",
+        Table_aligned_paged_column
+    },
+    {
+        "cold_column",
+        Table_cold_column
+    },
+    {
+        "cold_column_move",
+        Table_cold_column_move
+    },
+    {
+        "cold_column_merge",
+        Table_cold_column_merge
+    },
+    {
+        "cold_column_page_size_alignment",
+        Table_cold_column_page_size_alignment
+    },
+    {
+        "cold_after_use",
+        Table_cold_after_use
+    },
+    {
+        "stable_order_delete",
+        Table_stable_order_delete
+    },
+    {
+        "stable_order_remove",
+        Table_stable_order_remove
+    },
+    {
+        "stable_order_tag",
+        Table_stable_order_tag
+    },
+    {
+        "stable_order_w_hooks",
+        Table_stable_order_w_hooks
+    },
+    {
+        "stable_order_w_toggle",
+        Table_stable_order_w_toggle
+    },
+    {
+        "stable_order_batched_remove",
+        Table_stable_order_batched_remove
+    },
+    {
+        "stable_order_w_order_by",
+        Table_stable_order_w_order_by
+    },
+    {
+        "stable_order_after_use",
+        Table_stable_order_after_use
+    },
+    {
+        "stable_order_w_toggle_n_words",
+        Table_stable_order_w_toggle_n_words
+    },
+    {
+        "cold_column_compact",
+        Table_cold_column_compact
+    },
+    {
+        "stable_order_deferred_delete_w_append",
+        Table_stable_order_deferred_delete_w_append
+    },
+    {
+        "stable_order_deferred_w_hooks",
+        Table_stable_order_deferred_w_hooks
+    },
+    {
+        "stable_order_illegal_ctor_move_dtor",
+        Table_stable_order_illegal_ctor_move_dtor
     }
 };
 
@@ -16570,7 +16915,7 @@ static bake_test_suite suites[] = {
         "Iter",
         NULL,
         NULL,
-        60,
+        67,
         Iter_testcases
     },
     {
@@ -16796,7 +17141,7 @@ static bake_test_suite suites[] = {
         "World",
         World_setup,
         NULL,
-        176,
+        182,
         World_testcases
     },
     {
@@ -16824,7 +17169,7 @@ static bake_test_suite suites[] = {
         "Commands",
         NULL,
         NULL,
-        185,
+        212,
         Commands_testcases
     },
     {
@@ -16845,7 +17190,7 @@ static bake_test_suite suites[] = {
         "Table",
         NULL,
         NULL,
-        41,
+        70,
         Table_testcases
     },
     {
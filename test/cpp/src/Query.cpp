@@ -4646,3 +4646,65 @@ void Query_sparse_query_dynamic_dont_inherit(void) {
     test_int(count, 2);
     test_int(q.count(), 2);
 }
+
+void Query_change_tracking_rows(void) {
+    flecs::world w;
+
+    auto qr = w.query_builder<const Position>()
+        .detect_row_changes()
+        .build();
+
+    flecs::entity entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = w.entity().set<Position>({10, 20});
+    }
+
+    test_bool(qr.changed(), true);
+    qr.run([](flecs::iter &it) { while (it.next()) {} });
+    test_bool(qr.changed(), false);
+
+    entities[70].set<Position>({10, 20});
+
+    int32_t count = 0;
+    qr.run([&](flecs::iter& it) {
+        while (it.next()) {
+            int32_t row = 0, changed_count = 0;
+            while (it.changed_rows(row, changed_count)) {
+                test_int(row, 64);
+                test_int(changed_count, 36);
+                row += changed_count;
+                count ++;
+            }
+        }
+    });
+
+    test_int(count, 1);
+}
+
+void Query_prefetch(void) {
+    flecs::world w;
+
+    auto e1 = w.entity().set<Position>({10, 20}).set<Velocity>({1, 2});
+    auto e2 = w.entity().add<Tag>().set<Position>({20, 30}).set<Velocity>({2, 3});
+
+    auto q = w.query_builder<Position, const Velocity>()
+        .prefetch()
+        .build();
+
+    test_assert(q.c_ptr()->flags & EcsQueryPrefetch);
+
+    int32_t count = 0;
+    q.each([&](flecs::entity e, Position& p, const Velocity& v) {
+        if (count == 0) {
+            test_assert(e == e1);
+        } else {
+            test_assert(e == e2);
+        }
+        p.x += v.x;
+        count ++;
+    });
+
+    test_int(count, 2);
+    test_int(e1.get<Position>().x, 11);
+    test_int(e2.get<Position>().x, 22);
+}
@@ -2527,3 +2527,247 @@ void System_run_w_0_src_query(void) {
     world.progress();
     test_int(count, 1);
 }
+
+void System_multithread_system_w_work_stealing(void) {
+    flecs::world world;
+
+    world.set_threads(2);
+    world.set_work_stealing();
+    test_bool(world.using_work_stealing(), true);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({10, 20});
+    }
+
+    world.system<Position>()
+        .multi_threaded()
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    world.progress();
+
+    int32_t count = 0;
+    world.each([&](const Position& p) {
+        test_int(p.x, 11);
+        count ++;
+    });
+    test_int(count, 1000);
+
+    world.set_work_stealing(false);
+    test_bool(world.using_work_stealing(), false);
+}
+
+void System_multithread_system_w_dag_scheduling(void) {
+    flecs::world world;
+
+    world.set_threads(2);
+    world.set_dag_scheduling();
+    test_bool(world.using_dag_scheduling(), true);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity()
+            .set<Position>({10, 20})
+            .set<Velocity>({1, 2});
+    }
+
+    world.system<Position>()
+        .multi_threaded()
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    world.system<const Position, Velocity>()
+        .multi_threaded()
+        .each([](const Position& p, Velocity& v) {
+            v.x = p.x;
+        });
+
+    world.progress();
+
+    int32_t count = 0;
+    world.each([&](const Position& p, const Velocity& v) {
+        test_int(p.x, 11);
+        test_int(v.x, 11);
+        count ++;
+    });
+    test_int(count, 1000);
+
+    world.set_dag_scheduling(false);
+    test_bool(world.using_dag_scheduling(), false);
+}
+
+void System_multithread_system_w_parallel_merge(void) {
+    flecs::world world;
+
+    world.set_threads(2);
+    world.set_parallel_merge();
+    test_bool(world.using_parallel_merge(), true);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({10, 20});
+    }
+
+    int32_t on_set = 0;
+    world.observer<Position>()
+        .event(flecs::OnSet)
+        .each([&](Position&) {
+            on_set ++;
+        });
+
+    world.system<const Position>()
+        .multi_threaded()
+        .each([](flecs::entity e, const Position& p) {
+            e.set<Position>({p.x + 1, p.y});
+        });
+
+    world.progress();
+
+    test_int(on_set, 1000);
+
+    int32_t count = 0;
+    world.each([&](const Position& p) {
+        test_int(p.x, 11);
+        test_int(p.y, 20);
+        count ++;
+    });
+    test_int(count, 1000);
+
+    world.set_parallel_merge(false);
+    test_bool(world.using_parallel_merge(), false);
+}
+
+void System_multithread_system_w_worker_affinity(void) {
+    flecs::world world;
+
+    int32_t cpus[] = {-1, 0};
+    world.set_worker_affinity(cpus, 2);
+    test_int(world.get_worker_affinity(0), -1);
+    test_int(world.get_worker_affinity(1), 0);
+
+    world.set_threads(2);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({10, 20});
+    }
+
+    world.system<Position>()
+        .multi_threaded()
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    world.progress();
+
+    int32_t count = 0;
+    world.each([&](const Position& p) {
+        test_int(p.x, 11);
+        count ++;
+    });
+    test_int(count, 1000);
+
+    world.set_worker_affinity(nullptr, 0);
+    test_int(world.get_worker_affinity(1), -1);
+}
+
+void System_multithread_system_w_chunking(void) {
+    flecs::world world;
+
+    world.set_threads(4);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({10, 20});
+    }
+
+    flecs::system s = world.system<Position>()
+        .multi_threaded()
+        .chunking(16, 128)
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    const ecs_system_t *sys = ecs_system_get(world, s);
+    test_int(sys->chunking.min_count, 16);
+    test_int(sys->chunking.chunk_size, 128);
+
+    world.progress();
+
+    int32_t count = 0;
+    world.each([&](const Position& p) {
+        test_int(p.x, 11);
+        count ++;
+    });
+    test_int(count, 1000);
+}
+
+void System_multithread_system_w_pipelined(void) {
+    flecs::world world;
+
+    world.set_threads(4);
+    world.set_pipelined_frames();
+    world.set_double_buffered<Position>();
+    test_bool(world.using_pipelined_frames(), true);
+    test_bool(world.is_double_buffered<Position>(), true);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({0, 0});
+    }
+
+    world.system<Position>()
+        .multi_threaded()
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    int32_t count = 0, sum = 0;
+
+    flecs::system s = world.system<const Position>()
+        .kind(flecs::OnStore)
+        .pipelined()
+        .each([&](const Position& p) {
+            count ++;
+            sum += static_cast<int32_t>(p.x);
+        });
+
+    const ecs_system_t *sys = ecs_system_get(world, s);
+    test_bool(sys->pipelined, true);
+
+    world.progress();
+    test_int(count, 0);
+
+    world.progress();
+    test_int(count, 1000);
+    test_int(sum, 1000);
+}
+
+void System_multithread_system_w_worker_min_cost(void) {
+    flecs::world world;
+
+    world.set_threads(4);
+    world.set_worker_min_cost(1000);
+    test_assert(world.get_worker_min_cost() == 1000);
+
+    for (int i = 0; i < 1000; i ++) {
+        world.entity().set<Position>({10, 20});
+    }
+
+    flecs::system s = world.system<Position>()
+        .multi_threaded()
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    world.progress();
+    world.progress();
+
+    int32_t count = 0;
+    world.each([&](const Position& p) {
+        test_int(p.x, 12);
+        count ++;
+    });
+    test_int(count, 1000);
+
+    const ecs_system_t *sys = ecs_system_get(world, s);
+    test_int(sys->matched_count, 1000);
+    test_assert(sys->cost_per_entity > 0);
+}
@@ -2081,3 +2081,62 @@ void World_get_type_info_R_T_tag(void) {
     const flecs::type_info_t *ti = world.type_info<Tag, Tgt>();
     test_assert(ti == nullptr);
 }
+
+void World_column_alignment(void) {
+    flecs::world world;
+
+    world.set_column_alignment(64);
+    test_int(world.get_column_alignment(), 64);
+
+    for (int i = 0; i < 10; i ++) {
+        world.entity().set<Position>({(float)i, (float)i});
+    }
+
+    int32_t count = 0;
+    world.query<Position>().run([&](flecs::iter& it) {
+        while (it.next()) {
+            test_int(it.alignment(0), 64);
+            auto p = it.field<Position>(0);
+            test_int((uintptr_t)&p[0] % 64, 0);
+            count += static_cast<int32_t>(it.count());
+        }
+    });
+
+    test_int(count, 10);
+}
+
+void World_async_set(void) {
+    flecs::world world;
+
+    world.component<Position>();
+    world.component<Tag>();
+
+    flecs::entity e = world.entity();
+
+    world.async_set<Position>(e, {10, 20});
+    world.async_add<Tag>(e);
+    test_assert(!e.has<Position>());
+    test_assert(!e.has<Tag>());
+
+    world.progress();
+
+    test_assert(e.has<Tag>());
+    const Position *p = e.try_get<Position>();
+    test_assert(p != nullptr);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    world.async_remove<Tag>(e);
+    world.progress();
+    test_assert(!e.has<Tag>());
+}
+
+void World_async_set_unregistered(void) {
+    install_test_abort();
+    flecs::world world;
+
+    flecs::entity e = world.entity();
+
+    test_expect_abort();
+    world.async_set<Position>(e, {10, 20});
+}
@@ -659,6 +659,13 @@ void System_lookup_and_update_run(void);
 void System_lookup_and_update_ctx(void);
 void System_set_group(void);
 void System_run_w_0_src_query(void);
+void System_multithread_system_w_work_stealing(void);
+void System_multithread_system_w_dag_scheduling(void);
+void System_multithread_system_w_parallel_merge(void);
+void System_multithread_system_w_worker_affinity(void);
+void System_multithread_system_w_chunking(void);
+void System_multithread_system_w_pipelined(void);
+void System_multithread_system_w_worker_min_cost(void);
 
 // Testsuite 'Event'
 void Event_evt_1_id_entity(void);
@@ -865,6 +872,8 @@ void Query_sparse_query_convert_to_query_1_term(void);
 void Query_sparse_query_convert_to_query_3_terms(void);
 void Query_world_each_sparse(void);
 void Query_world_each_sparse_w_entity(void);
+void Query_change_tracking_rows(void);
+void Query_prefetch(void);
 
 // Testsuite 'QueryBuilder'
 void QueryBuilder_setup(void);
@@ -1500,6 +1509,9 @@ void World_get_type_info_T_tag(void);
 void World_get_type_info_r_t_tag(void);
 void World_get_type_info_R_t_tag(void);
 void World_get_type_info_R_T_tag(void);
+void World_column_alignment(void);
+void World_async_set(void);
+void World_async_set_unregistered(void);
 
 // Testsuite 'Singleton'
 void Singleton_set_get_singleton(void);
@@ -4277,6 +4289,34 @@ bake_test_case System_testcases[] = {
     {
         "run_w_0_src_query",
         System_run_w_0_src_query
+    },
+    {
+        "multithread_system_w_work_stealing",
+        System_multithread_system_w_work_stealing
+    },
+    {
+        "multithread_system_w_dag_scheduling",
+        System_multithread_system_w_dag_scheduling
+    },
+    {
+        "multithread_system_w_parallel_merge",
+        System_multithread_system_w_parallel_merge
+    },
+    {
+        "multithread_system_w_worker_affinity",
+        System_multithread_system_w_worker_affinity
+    },
+    {
+        "multithread_system_w_chunking",
+        System_multithread_system_w_chunking
+    },
+    {
+        "multithread_system_w_pipelined",
+        System_multithread_system_w_pipelined
+    },
+    {
+        "multithread_system_w_worker_min_cost",
+        System_multithread_system_w_worker_min_cost
     }
 };
 
@@ -5086,6 +5126,14 @@ bake_test_case Query_testcases[] = {
     {
         "world_each_sparse_w_entity",
         Query_world_each_sparse_w_entity
+    },
+    {
+        "change_tracking_rows",
+        Query_change_tracking_rows
+    },
+    {
+        "prefetch",
+        Query_prefetch
     }
 };
 
@@ -7577,6 +7625,18 @@ bake_test_case World_testcases[] = {
     {
         "get_type_info_R_T_tag",
         World_get_type_info_R_T_tag
+    },
+    {
+        "column_alignment",
+        World_column_alignment
+    },
+    {
+        "async_set",
+        World_async_set
+    },
+    {
+        "async_set_unregistered",
+        World_async_set_unregistered
     }
 };
 
@@ -8463,7 +8523,7 @@ static bake_test_suite suites[] = {
         "System",
         NULL,
         NULL,
-        79,
+        86,
         System_testcases
     },
     {
@@ -8484,7 +8544,7 @@ static bake_test_suite suites[] = {
         "Query",
         NULL,
         NULL,
-        165,
+        167,
         Query_testcases
     },
     {
@@ -8549,7 +8609,7 @@ static bake_test_suite suites[] = {
         "World",
         NULL,
         NULL,
-        122,
+        125,
         World_testcases
     },
     {
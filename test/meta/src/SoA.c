@@ -0,0 +1,545 @@
+#include <meta.h>
+
+ECS_STRUCT(SoAPosition, {
+    float x;
+    float y;
+});
+
+ECS_STRUCT(SoAMixed, {
+    int8_t a;
+    double b;
+    int16_t c;
+});
+
+typedef struct {
+    float x;
+    float y;
+} SoANoReflection;
+
+static
+ecs_entity_t soa_new_position(
+    ecs_world_t *world,
+    float x,
+    float y)
+{
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, SoAPosition, {x, y});
+    return e;
+}
+
+static
+void soa_test_position(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    float x,
+    float y)
+{
+    ecs_iter_t it = ecs_each(world, SoAPosition);
+    while (ecs_each_next(&it)) {
+        float *xs = ecs_field_member(&it, float, 0, 0);
+        float *ys = ecs_field_member(&it, float, 0, 1);
+        test_assert(xs != NULL);
+        test_assert(ys != NULL);
+        int32_t i;
+        for (i = 0; i < it.count; i ++) {
+            if (it.entities[i] == e) {
+                test_flt(xs[i], x);
+                test_flt(ys[i], y);
+                ecs_iter_fini(&it);
+                return;
+            }
+        }
+    }
+
+    test_assert(false); /* entity not found */
+}
+
+void SoA_add_trait(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    const ecs_type_info_t *ti = ecs_get_type_info(world, ecs_id(SoAPosition));
+    test_assert(ti != NULL);
+    test_assert(ti->soa != NULL);
+
+    ecs_fini(world);
+}
+
+void SoA_set_field_member(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = soa_new_position(world, 30, 40);
+    ecs_entity_t e3 = soa_new_position(world, 50, 60);
+
+    ecs_iter_t it = ecs_each(world, SoAPosition);
+    test_bool(true, ecs_each_next(&it));
+    test_int(it.count, 3);
+    test_uint(it.entities[0], e1);
+    test_uint(it.entities[1], e2);
+    test_uint(it.entities[2], e3);
+
+    float *x = ecs_field_member(&it, float, 0, 0);
+    float *y = ecs_field_member(&it, float, 0, 1);
+    test_flt(x[0], 10); test_flt(y[0], 20);
+    test_flt(x[1], 30); test_flt(y[1], 40);
+    test_flt(x[2], 50); test_flt(y[2], 60);
+
+    /* Members are stored in separate arrays */
+    test_assert(y != &x[1]);
+
+    test_bool(false, ecs_each_next(&it));
+
+    ecs_fini(world);
+}
+
+void SoA_get_returns_null(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e = soa_new_position(world, 10, 20);
+    test_assert(ecs_has(world, e, SoAPosition));
+    test_assert(ecs_get(world, e, SoAPosition) == NULL);
+
+    ecs_fini(world);
+}
+
+void SoA_set_existing(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = soa_new_position(world, 30, 40);
+
+    ecs_set(world, e1, SoAPosition, {11, 21});
+
+    soa_test_position(world, e1, 11, 21);
+    soa_test_position(world, e2, 30, 40);
+
+    ecs_fini(world);
+}
+
+void SoA_mixed_member_sizes(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAMixed);
+    ecs_add_id(world, ecs_id(SoAMixed), EcsSoA);
+
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, SoAMixed,
+            {(int8_t)i, (double)i * 2, (int16_t)(i * 3)});
+    }
+
+    ecs_iter_t it = ecs_each(world, SoAMixed);
+    test_bool(true, ecs_each_next(&it));
+    test_int(it.count, 100);
+
+    int8_t *a = ecs_field_member(&it, int8_t, 0, 0);
+    double *b = ecs_field_member(&it, double, 0, 1);
+    int16_t *c = ecs_field_member(&it, int16_t, 0, 2);
+    test_assert(((uintptr_t)b % ECS_ALIGNOF(double)) == 0);
+    test_assert(((uintptr_t)c % ECS_ALIGNOF(int16_t)) == 0);
+
+    for (i = 0; i < 100; i ++) {
+        test_int(a[i], i);
+        test_flt(b[i], i * 2);
+        test_int(c[i], i * 3);
+    }
+
+    test_bool(false, ecs_each_next(&it));
+
+    ecs_fini(world);
+}
+
+void SoA_grow_table(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e[1000];
+    int32_t i;
+    for (i = 0; i < 1000; i ++) {
+        e[i] = soa_new_position(world, (float)i, (float)-i);
+    }
+
+    ecs_iter_t it = ecs_each(world, SoAPosition);
+    test_bool(true, ecs_each_next(&it));
+    test_int(it.count, 1000);
+
+    float *x = ecs_field_member(&it, float, 0, 0);
+    float *y = ecs_field_member(&it, float, 0, 1);
+    for (i = 0; i < 1000; i ++) {
+        test_uint(it.entities[i], e[i]);
+        test_flt(x[i], i);
+        test_flt(y[i], -i);
+    }
+
+    test_bool(false, ecs_each_next(&it));
+
+    ecs_fini(world);
+}
+
+void SoA_shrink_table(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e[100];
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        e[i] = soa_new_position(world, (float)i, (float)-i);
+    }
+
+    for (i = 0; i < 100; i += 2) {
+        ecs_delete(world, e[i]);
+    }
+
+    ecs_shrink(world);
+
+    for (i = 1; i < 100; i += 2) {
+        soa_test_position(world, e[i], (float)i, (float)-i);
+    }
+
+    ecs_fini(world);
+}
+
+void SoA_delete(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = soa_new_position(world, 30, 40);
+    ecs_entity_t e3 = soa_new_position(world, 50, 60);
+
+    ecs_delete(world, e2);
+
+    ecs_iter_t it = ecs_each(world, SoAPosition);
+    test_bool(true, ecs_each_next(&it));
+    test_int(it.count, 2);
+    test_uint(it.entities[0], e1);
+    test_uint(it.entities[1], e3);
+
+    float *x = ecs_field_member(&it, float, 0, 0);
+    float *y = ecs_field_member(&it, float, 0, 1);
+    test_flt(x[0], 10); test_flt(y[0], 20);
+    test_flt(x[1], 50); test_flt(y[1], 60);
+
+    test_bool(false, ecs_each_next(&it));
+
+    ecs_fini(world);
+}
+
+void SoA_move_table(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ECS_TAG(world, Tag);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = soa_new_position(world, 30, 40);
+    ecs_entity_t e3 = soa_new_position(world, 50, 60);
+
+    ecs_add(world, e2, Tag);
+    test_assert(ecs_has(world, e2, Tag));
+
+    soa_test_position(world, e1, 10, 20);
+    soa_test_position(world, e2, 30, 40);
+    soa_test_position(world, e3, 50, 60);
+
+    ecs_remove(world, e2, Tag);
+    test_assert(!ecs_has(world, e2, Tag));
+
+    soa_test_position(world, e1, 10, 20);
+    soa_test_position(world, e2, 30, 40);
+    soa_test_position(world, e3, 50, 60);
+
+    ecs_fini(world);
+}
+
+void SoA_merge_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ECS_TAG(world, Tag);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = soa_new_position(world, 30, 40);
+    ecs_entity_t e3 = soa_new_position(world, 50, 60);
+    ecs_entity_t e4 = soa_new_position(world, 70, 80);
+    ecs_add(world, e3, Tag);
+    ecs_add(world, e4, Tag);
+
+    /* Merges table with Tag into table without Tag */
+    ecs_remove_all(world, Tag);
+    test_assert(!ecs_has(world, e3, Tag));
+    test_assert(!ecs_has(world, e4, Tag));
+
+    soa_test_position(world, e1, 10, 20);
+    soa_test_position(world, e2, 30, 40);
+    soa_test_position(world, e3, 50, 60);
+    soa_test_position(world, e4, 70, 80);
+
+    ecs_fini(world);
+}
+
+void SoA_deferred_set(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e1 = soa_new_position(world, 10, 20);
+    ecs_entity_t e2 = ecs_new(world);
+
+    ecs_defer_begin(world);
+    ecs_set(world, e1, SoAPosition, {11, 21});
+    ecs_set(world, e2, SoAPosition, {30, 40});
+    ecs_defer_end(world);
+
+    soa_test_position(world, e1, 11, 21);
+    soa_test_position(world, e2, 30, 40);
+
+    ecs_fini(world);
+}
+
+void SoA_bulk_init(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    SoAPosition values[] = {{10, 20}, {30, 40}, {50, 60}};
+
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = 3,
+        .ids = {ecs_id(SoAPosition)},
+        .data = (void*[]){ values }
+    });
+    test_assert(ids != NULL);
+
+    ecs_entity_t e1 = ids[0], e2 = ids[1], e3 = ids[2];
+    soa_test_position(world, e1, 10, 20);
+    soa_test_position(world, e2, 30, 40);
+    soa_test_position(world, e3, 50, 60);
+
+    ecs_fini(world);
+}
+
+void SoA_instantiate_override(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, SoAPosition, {10, 20});
+
+    ecs_entity_t inst_1 = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_entity_t inst_2 = ecs_new_w_pair(world, EcsIsA, base);
+    test_assert(ecs_owns(world, inst_1, SoAPosition));
+    test_assert(ecs_owns(world, inst_2, SoAPosition));
+
+    ecs_set(world, inst_1, SoAPosition, {11, 21});
+
+    soa_test_position(world, inst_1, 11, 21);
+    soa_test_position(world, inst_2, 10, 20);
+
+    ecs_fini(world);
+}
+
+void SoA_instantiate_child(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_entity_t base_child = ecs_new_w_pair(world, EcsChildOf, base);
+    ecs_set(world, base_child, SoAPosition, {10, 20});
+
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_entity_t child = 0;
+    ecs_iter_t it = ecs_children(world, inst);
+    while (ecs_children_next(&it)) {
+        test_int(it.count, 1);
+        child = it.entities[0];
+    }
+    test_assert(child != 0);
+
+    soa_test_position(world, child, 10, 20);
+
+    ecs_fini(world);
+}
+
+void SoA_clone(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_entity_t e = soa_new_position(world, 10, 20);
+    ecs_entity_t c = ecs_clone(world, 0, e, true);
+
+    soa_test_position(world, e, 10, 20);
+    soa_test_position(world, c, 10, 20);
+
+    ecs_fini(world);
+}
+
+static int on_set_invoked = 0;
+static float on_set_x = 0;
+
+static
+void SoA_on_set(ecs_iter_t *it) {
+    float *x = ecs_field_member(it, float, 0, 0);
+    test_assert(x != NULL);
+    test_int(it->count, 1);
+    on_set_x = x[0];
+    on_set_invoked ++;
+}
+
+void SoA_on_set_observer(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(SoAPosition), .inout = EcsInOutNone }},
+        .events = { EcsOnSet },
+        .callback = SoA_on_set
+    });
+
+    ecs_entity_t e = soa_new_position(world, 10, 20);
+    test_int(on_set_invoked, 1);
+    test_flt(on_set_x, 10);
+
+    ecs_set(world, e, SoAPosition, {30, 40});
+    test_int(on_set_invoked, 2);
+    test_flt(on_set_x, 30);
+
+    ecs_fini(world);
+}
+
+void SoA_on_set_observer_w_field(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    test_expect_abort();
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(SoAPosition) }},
+        .events = { EcsOnSet },
+        .callback = SoA_on_set
+    });
+}
+
+void SoA_on_set_hook(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    test_expect_abort();
+    ecs_set_hooks(world, SoAPosition, {
+        .on_set = SoA_on_set
+    });
+}
+
+void SoA_add_trait_w_on_add_hook(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_set_hooks(world, SoAPosition, {
+        .on_add = SoA_on_set
+    });
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+}
+
+void SoA_serialize_json(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    soa_new_position(world, 10, 20);
+    soa_new_position(world, 30, 40);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(SoAPosition) }} });
+    ecs_iter_t it = ecs_query_iter(world, q);
+    char *json = ecs_iter_to_json(&it, NULL);
+    test_assert(json != NULL);
+    test_assert(strstr(json, "{\"x\":10, \"y\":20}") != NULL);
+    test_assert(strstr(json, "{\"x\":30, \"y\":40}") != NULL);
+    ecs_os_free(json);
+
+    ecs_query_fini(q);
+    ecs_fini(world);
+}
+
+void SoA_no_reflection(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, SoANoReflection);
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(SoANoReflection), EcsSoA);
+}
+
+void SoA_component_in_use(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    soa_new_position(world, 10, 20);
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+}
+
+void SoA_field_asserts(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_META_COMPONENT(world, SoAPosition);
+    ecs_add_id(world, ecs_id(SoAPosition), EcsSoA);
+
+    soa_new_position(world, 10, 20);
+
+    ecs_iter_t it = ecs_each(world, SoAPosition);
+    test_bool(true, ecs_each_next(&it));
+
+    test_expect_abort();
+    ecs_field(&it, SoAPosition, 0);
+}
@@ -1451,6 +1451,31 @@ void SetRttHooks_value_compare(void);
 void SetRttHooks_value_equals(void);
 void SetRttHooks_value_different_types(void);
 
+// Testsuite 'SoA'
+void SoA_add_trait(void);
+void SoA_set_field_member(void);
+void SoA_get_returns_null(void);
+void SoA_set_existing(void);
+void SoA_mixed_member_sizes(void);
+void SoA_grow_table(void);
+void SoA_shrink_table(void);
+void SoA_delete(void);
+void SoA_move_table(void);
+void SoA_merge_tables(void);
+void SoA_deferred_set(void);
+void SoA_bulk_init(void);
+void SoA_instantiate_override(void);
+void SoA_instantiate_child(void);
+void SoA_clone(void);
+void SoA_on_set_hook(void);
+void SoA_serialize_json(void);
+void SoA_no_reflection(void);
+void SoA_component_in_use(void);
+void SoA_field_asserts(void);
+void SoA_on_set_observer(void);
+void SoA_on_set_observer_w_field(void);
+void SoA_add_trait_w_on_add_hook(void);
+
 bake_test_case PrimitiveTypes_testcases[] = {
     {
         "bool",
@@ -7098,6 +7123,101 @@ bake_test_case SetRttHooks_testcases[] = {
     }
 };
 
+bake_test_case SoA_testcases[] = {
+    {
+        "add_trait",
+        SoA_add_trait
+    },
+    {
+        "set_field_member",
+        SoA_set_field_member
+    },
+    {
+        "get_returns_null",
+        SoA_get_returns_null
+    },
+    {
+        "set_existing",
+        SoA_set_existing
+    },
+    {
+        "mixed_member_sizes",
+        SoA_mixed_member_sizes
+    },
+    {
+        "grow_table",
+        SoA_grow_table
+    },
+    {
+        "shrink_table",
+        SoA_shrink_table
+    },
+    {
+        "delete",
+        SoA_delete
+    },
+    {
+        "move_table",
+        SoA_move_table
+    },
+    {
+        "merge_tables",
+        SoA_merge_tables
+    },
+    {
+        "deferred_set",
+        SoA_deferred_set
+    },
+    {
+        "bulk_init",
+        SoA_bulk_init
+    },
+    {
+        "instantiate_override",
+        SoA_instantiate_override
+    },
+    {
+        "instantiate_child",
+        SoA_instantiate_child
+    },
+    {
+        "clone",
+        SoA_clone
+    },
+    {
+        "on_set_hook",
+        SoA_on_set_hook
+    },
+    {
+        "serialize_json",
+        SoA_serialize_json
+    },
+    {
+        "no_reflection",
+        SoA_no_reflection
+    },
+    {
+        "component_in_use",
+        SoA_component_in_use
+    },
+    {
+        "field_asserts",
+        SoA_field_asserts
+    },
+    {
+        "on_set_observer",
+        SoA_on_set_observer
+    },
+    {
+        "on_set_observer_w_field",
+        SoA_on_set_observer_w_field
+    },
+    {
+        "add_trait_w_on_add_hook",
+        SoA_add_trait_w_on_add_hook
+    }
+};
+
 static bake_test_suite suites[] = {
     {
         "PrimitiveTypes",
@@ -7273,9 +7393,16 @@ static bake_test_suite suites[] = {
         NULL,
         15,
         SetRttHooks_testcases
+    },
+    {
+        "SoA",
+        NULL,
+        NULL,
+        23,
+        SoA_testcases
     }
 };
 
 int main(int argc, char *argv[]) {
-    return bake_test_run("meta", argc, argv, suites, 25);
+    return bake_test_run("meta", argc, argv, suites, 26);
 }
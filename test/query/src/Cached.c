@@ -8300,3 +8300,103 @@ void Cached_unmatch_after_delete_traversable_target_parent(void) {
 
     ecs_fini(world);
 }
+
+void Cached_prefetch_iter(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+    ECS_TAG(world, TagC);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+    ecs_set(world, e2, Velocity, {2, 3});
+    ecs_add(world, e2, TagA);
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_set(world, e3, Velocity, {3, 4});
+    ecs_add(world, e3, TagB);
+    ecs_entity_t e4 = ecs_insert(world, ecs_value(Position, {40, 50}));
+    ecs_add(world, e4, TagC);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Velocity",
+        .flags = EcsQueryPrefetch
+    });
+    test_assert(q != NULL);
+    test_assert(ecs_query_get_cache_query(q) != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    test_int(10, ecs_field(&it, Position, 0)->x);
+    test_int(1, ecs_field(&it, Velocity, 1)->x);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e2, it.entities[0]);
+    test_int(20, ecs_field(&it, Position, 0)->x);
+    test_int(2, ecs_field(&it, Velocity, 1)->x);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e3, it.entities[0]);
+    test_int(30, ecs_field(&it, Position, 0)->x);
+    test_int(3, ecs_field(&it, Velocity, 1)->x);
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Cached_prefetch_iter_w_wildcard(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, TgtA);
+    ECS_TAG(world, TgtB);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_add_pair(world, e1, Rel, TgtA);
+    ecs_add_pair(world, e1, Rel, TgtB);
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+    ecs_add_pair(world, e2, Rel, TgtA);
+    ecs_add(world, e2, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, (Rel, *)",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryPrefetch
+    });
+    test_assert(q != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    test_uint(ecs_pair(Rel, TgtA), ecs_field_id(&it, 1));
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    test_uint(ecs_pair(Rel, TgtB), ecs_field_id(&it, 1));
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e2, it.entities[0]);
+    test_uint(ecs_pair(Rel, TgtA), ecs_field_id(&it, 1));
+    test_int(20, ecs_field(&it, Position, 0)->x);
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
@@ -4032,3 +4032,316 @@ void ChangeDetection_detect_changes_w_order_by(void) {
 
     ecs_fini(world);
 }
+
+void ChangeDetection_detect_row_changes_w_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[200];
+    for (int i = 0; i < 200; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[in] Position",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+    test_assert(q != NULL);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        test_int(it.count, 200);
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 0);
+        test_int(count, 200);
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(false, ecs_iter_changed(&it));
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_set(world, entities[10], Position, {20, 30});
+    ecs_set(world, entities[150], Position, {20, 30});
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        test_bool(true, ecs_iter_changed(&it));
+
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 0);
+        test_int(count, 64);
+        row += count;
+
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 128);
+        test_int(count, 64);
+        row += count;
+
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void ChangeDetection_detect_row_changes_w_adjacent_chunks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[200];
+    for (int i = 0; i < 200; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[in] Position",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+    test_assert(q != NULL);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    ecs_modified(world, entities[100], Position);
+    ecs_modified(world, entities[130], Position);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 64);
+        test_int(count, 128);
+        row += count;
+
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void ChangeDetection_detect_row_changes_w_out_query(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    for (int i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[in] Position",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+    test_assert(q != NULL);
+
+    ecs_query_t *q_write = ecs_query(world, {
+        .expr = "[out] Position",
+        .cache_kind = EcsQueryCacheAuto
+    });
+    test_assert(q_write != NULL);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q_write);
+        while (ecs_query_next(&it)) { }
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 0);
+        test_int(count, 100);
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+    ecs_query_fini(q_write);
+
+    ecs_fini(world);
+}
+
+void ChangeDetection_detect_row_changes_after_new(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    for (int i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[in] Position",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+    test_assert(q != NULL);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    ecs_insert(world, ecs_value(Position, {100, 100}));
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        test_int(it.count, 101);
+        int32_t row = 10, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 10);
+        test_int(count, 91);
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void ChangeDetection_detect_row_changes_wo_row_tracking(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[in] Position",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectChanges
+    });
+    test_assert(q != NULL);
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    ecs_set(world, entities[80], Position, {20, 30});
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 0);
+        test_int(count, 100);
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void ChangeDetection_detect_row_changes_w_fixed_src(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t src = ecs_insert(world, ecs_value(Velocity, {1, 2}));
+
+    for (int i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {
+            { .id = ecs_id(Position), .inout = EcsIn },
+            { .id = ecs_id(Velocity), .src.id = src, .inout = EcsIn }
+        },
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectRowChanges
+    });
+    test_assert(q != NULL);
+
+    for (int i = 0; i < 2; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            ecs_iter_changed(&it);
+        }
+    }
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(false, ecs_iter_changed_rows(&it, &row, &count));
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_set(world, src, Velocity, {3, 4});
+
+    {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        test_bool(true, ecs_query_next(&it));
+        int32_t row = 0, count = 0;
+        test_bool(true, ecs_iter_changed_rows(&it, &row, &count));
+        test_int(row, 0);
+        test_int(count, 100);
+        test_bool(false, ecs_query_next(&it));
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
@@ -6235,3 +6235,167 @@ void Toggle_this_toggle_after_or_chain(void) {
 
     ecs_fini(world);
 }
+
+void Toggle_this_toggle_span_across_blocks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsCanToggle);
+
+    ecs_entity_t entities[256];
+    int32_t i;
+    for (i = 0; i < 256; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+        ecs_set(world, entities[i], Position, {i, i});
+        ecs_enable_component(world, entities[i], Position, true);
+    }
+
+    ecs_enable_component(world, entities[10], Position, false);
+    ecs_enable_component(world, entities[211], Position, false);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 10);
+    test_uint(it.entities[0], entities[0]);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 200);
+    test_uint(it.entities[0], entities[11]);
+    test_uint(it.entities[199], entities[210]);
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p[0].x, 11);
+    test_int(p[199].x, 210);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 44);
+    test_uint(it.entities[0], entities[212]);
+    test_uint(it.entities[43], entities[255]);
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_this_toggle_span_w_disabled_block(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsCanToggle);
+
+    ecs_entity_t entities[192];
+    int32_t i;
+    for (i = 0; i < 192; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+        ecs_set(world, entities[i], Position, {i, i});
+        ecs_enable_component(world, entities[i], Position, true);
+        if (i >= 60 && i < 130) {
+            ecs_enable_component(world, entities[i], Position, false);
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 60);
+    test_uint(it.entities[0], entities[0]);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 62);
+    test_uint(it.entities[0], entities[130]);
+    test_uint(it.entities[61], entities[191]);
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_this_enabled_mask(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsCanToggle);
+
+    ecs_entity_t entities[100];
+    int32_t i;
+    for (i = 0; i < 100; i ++) {
+        entities[i] = ecs_new_w(world, Position);
+        ecs_set(world, entities[i], Position, {i, i});
+        ecs_enable_component(world, entities[i], Position, (i % 3) != 0);
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind,
+        .flags = EcsQueryTableOnly
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 100);
+
+    const uint64_t *mask = ecs_field_enabled_mask(&it, 0);
+    test_assert(mask != NULL);
+
+    for (i = 0; i < it.count; i ++) {
+        int32_t row = it.offset + i;
+        bool enabled = (mask[row >> 6] >> (row & 63)) & 1;
+        test_bool(enabled, ecs_is_enabled(world, it.entities[i], Position));
+        test_bool(enabled, (i % 3) != 0);
+    }
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_this_enabled_mask_no_toggle(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Position), EcsCanToggle);
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_add(world, e, Velocity);
+    ecs_enable_component(world, e, Position, true);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Velocity",
+        .cache_kind = cache_kind,
+        .flags = EcsQueryTableOnly
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_assert(ecs_field_enabled_mask(&it, 0) != NULL);
+    test_assert(ecs_field_enabled_mask(&it, 1) == NULL);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
@@ -1889,6 +1889,8 @@ void Cached_match_after_defer_add_to_parent(void);
 void Cached_unmatch_after_defer_remove_from_parent(void);
 void Cached_unmatch_after_delete_traversable_target(void);
 void Cached_unmatch_after_delete_traversable_target_parent(void);
+void Cached_prefetch_iter(void);
+void Cached_prefetch_iter_w_wildcard(void);
 
 // Testsuite 'ChangeDetection'
 void ChangeDetection_query_changed_after_new(void);
@@ -1969,6 +1971,12 @@ void ChangeDetection_mark_fixed_fields_dirty_w_tag_before(void);
 void ChangeDetection_query_changed_after_wildcard_matched_table_emptied(void);
 void ChangeDetection_detect_w_not_cached_fixed_src_term(void);
 void ChangeDetection_detect_changes_w_order_by(void);
+void ChangeDetection_detect_row_changes_w_set(void);
+void ChangeDetection_detect_row_changes_w_adjacent_chunks(void);
+void ChangeDetection_detect_row_changes_w_out_query(void);
+void ChangeDetection_detect_row_changes_after_new(void);
+void ChangeDetection_detect_row_changes_wo_row_tracking(void);
+void ChangeDetection_detect_row_changes_w_fixed_src(void);
 
 // Testsuite 'GroupBy'
 void GroupBy_group_by(void);
@@ -2240,6 +2248,10 @@ void Toggle_toggle_0_src_only_term(void);
 void Toggle_toggle_0_src(void);
 void Toggle_remove_toggle_from_table_w_other_toggle_and_entity(void);
 void Toggle_this_toggle_after_or_chain(void);
+void Toggle_this_toggle_span_across_blocks(void);
+void Toggle_this_toggle_span_w_disabled_block(void);
+void Toggle_this_enabled_mask(void);
+void Toggle_this_enabled_mask_no_toggle(void);
 
 // Testsuite 'Sparse'
 void Sparse_setup(void);
@@ -10313,6 +10325,14 @@ bake_test_case Cached_testcases[] = {
     {
         "unmatch_after_delete_traversable_target_parent",
         Cached_unmatch_after_delete_traversable_target_parent
+    },
+    {
+        "prefetch_iter",
+        Cached_prefetch_iter
+    },
+    {
+        "prefetch_iter_w_wildcard",
+        Cached_prefetch_iter_w_wildcard
     }
 };
 
@@ -10628,6 +10648,30 @@ bake_test_case ChangeDetection_testcases[] = {
     {
         "detect_changes_w_order_by",
         ChangeDetection_detect_changes_w_order_by
+    },
+    {
+        "detect_row_changes_w_set",
+        ChangeDetection_detect_row_changes_w_set
+    },
+    {
+        "detect_row_changes_w_adjacent_chunks",
+        ChangeDetection_detect_row_changes_w_adjacent_chunks
+    },
+    {
+        "detect_row_changes_w_out_query",
+        ChangeDetection_detect_row_changes_w_out_query
+    },
+    {
+        "detect_row_changes_after_new",
+        ChangeDetection_detect_row_changes_after_new
+    },
+    {
+        "detect_row_changes_wo_row_tracking",
+        ChangeDetection_detect_row_changes_wo_row_tracking
+    },
+    {
+        "detect_row_changes_w_fixed_src",
+        ChangeDetection_detect_row_changes_w_fixed_src
     }
 };
 
@@ -11689,6 +11733,22 @@ bake_test_case Toggle_testcases[] = {
     {
         "this_toggle_after_or_chain",
         Toggle_this_toggle_after_or_chain
+    },
+    {
+        "this_toggle_span_across_blocks",
+        Toggle_this_toggle_span_across_blocks
+    },
+    {
+        "this_toggle_span_w_disabled_block",
+        Toggle_this_toggle_span_w_disabled_block
+    },
+    {
+        "this_enabled_mask",
+        Toggle_this_enabled_mask
+    },
+    {
+        "this_enabled_mask_no_toggle",
+        Toggle_this_enabled_mask_no_toggle
     }
 };
 
@@ -14449,14 +14509,14 @@ static bake_test_suite suites[] = {
         "Cached",
         NULL,
         NULL,
-        161,
+        163,
         Cached_testcases
     },
     {
         "ChangeDetection",
         NULL,
         NULL,
-        78,
+        84,
         ChangeDetection_testcases
     },
     {
@@ -14479,7 +14539,7 @@ static bake_test_suite suites[] = {
         "Toggle",
         Toggle_setup,
         NULL,
-        165,
+        169,
         Toggle_testcases,
         1,
         Toggle_params